@@ -5,163 +5,205 @@
 #include "config.h"
 #include "sdfgen_unified.h"  // Unified API with CPU/GPU backend selection
 #include "sdf_io.h"          // Shared SDF file I/O functions
+#include "compressed_sdf.h"  // Chunked compressed SDF output (.csdf)
 #include "mesh_io.h"         // Mesh file loading (OBJ, STL)
 #include "mesh_repair.h"     // Mesh watertightness check and repair
+#include "triangle_table.h"  // Precomputed triangle geometry (memory report)
+#include "vti_io.h"          // VTK image data output (.vti)
+#include "log.h"             // Library progress messages (--quiet)
+#include "phase_trace.h"     // Chrome trace of the generation phases (--trace)
 #include <CLI/CLI.hpp>
 #include <cmath>
 
-#ifdef HAVE_VTK
-  #include <vtkImageData.h>
-  #include <vtkFloatArray.h>
-  #include <vtkXMLImageDataWriter.h>
-  #include <vtkPointData.h>
-  #include <vtkSmartPointer.h>
-#endif
-
-
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string>
 #include <limits>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 
-int main(int argc, char* argv[]) {
-
-  CLI::App app{"SDFGen - Generate signed distance fields from triangle meshes"};
+namespace {
 
-  // Positional arguments
-  std::string filename;
-  std::vector<float> dimensions;  // Can be: [dx, padding] for OBJ, or [Nx], [Nx,pad], [Nx,Ny,Nz], [Nx,Ny,Nz,pad] for STL
+// Batch pipeline constants
+const size_t BATCH_QUEUE_DEPTH = 2;        // Meshes waiting between two stages
+const size_t BATCH_BYTES_PER_CELL = 12;    // phi + nearest triangle + crossing count while generating
 
-  app.add_option("input", filename, "Input mesh file (.obj or .stl)")
-      ->required()
-      ->check(CLI::ExistingFile);
-  app.add_option("dimensions", dimensions, "Grid dimensions:\n"
-      "  OBJ: <dx> <padding>           - cell size and padding\n"
-      "  STL: <Nx> [Ny Nz] [padding]   - grid size (proportional or manual)")
-      ->expected(1, 4);
-
-  // Optional flags
+/**
+ * @brief Command-line settings shared by every mesh of a run
+ */
+struct CliSettings {
   bool force_cpu = false;
   bool fix_mesh = false;
+  bool exact_distances = false;
+  bool winding_signs = false;
+  bool ray_vote = false;
+  bool triangle_table = false;
+  bool spatial_reorder = false;
+  bool bricked = false;
+  bool gpu_fim = false;
+  bool gpu_binned = false;
+  bool gpu_streamed = false;
+  std::string gpu_devices;
+  int sparse_band = 0;
+  int octree_band = 0;
+  int fp16_band = 0;
+  int int16_band = 0;
+  std::vector<float> roi;
+  int pyramid_levels = 0;
   int num_threads = 0;
   int padding = 1;
+  bool dedup_vertices = false;
+  bool native_layout = false;
+  bool compress = false;
+  int quantize_bits = 0;
+  int truncate_band = 0;
+  bool batch = false;
+  int batch_memory_mb = 4096;
+  long long batch_gpu_cells = 1 << 21;
+  std::string vti_compress;
+  sdfgen::VtiCompression vti_compression = sdfgen::VtiCompression::None;
+  bool stats = false;
+  std::string trace_file;
+  bool quiet = false;
+  std::string cost_model_file;
+};
 
-  app.add_flag("--cpu", force_cpu, "Force CPU backend (skip GPU)");
-  app.add_flag("--fix", fix_mesh, "Repair non-watertight meshes (fill holes)");
-  app.add_option("-t,--threads", num_threads, "CPU thread count (0=auto)")
-      ->default_val(0);
-  app.add_option("-p,--padding", padding, "Padding cells around mesh")
-      ->default_val(1);
-
-  // Show full help on error (e.g., missing required arguments)
-  app.failure_message(CLI::FailureMessage::help);
-
-  CLI11_PARSE(app, argc, argv);
-
-  // Detect file type
-  std::string ext = filename.substr(filename.find_last_of(".") + 1);
-  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-  bool is_stl = (ext == "stl");
-  bool mode_precise = is_stl;  // STL uses grid dimensions, OBJ uses dx
-
-  // Validate dimensions
-  if (dimensions.empty()) {
-    std::cerr << "Error: Grid dimensions required.\n";
-    std::cerr << "  OBJ: SDFGen mesh.obj <dx> <padding>\n";
-    std::cerr << "  STL: SDFGen mesh.stl <Nx> [Ny Nz] [padding]\n";
-    return 1;
-  }
-
-  // Common variables
+/**
+ * @brief One mesh on its way from the input file to the written field
+ */
+struct MeshJob {
+  std::string filename;
+  bool mode_precise = false;  // STL uses grid dimensions, OBJ uses dx
+  int padding = 1;
   std::vector<Vec3f> vertList;
   std::vector<Vec3ui> faceList;
   Vec3f min_box, max_box;
   int target_nx = 0, target_ny = 0, target_nz = 0;
   float dx = 0.0f;
+  Vec3ui sizes;
+  Array3f phi_grid;
+  std::string suffix;  // appended to the output name (--roi, --pyramid levels)
 
-  std::cout << "========================================\n";
-  std::cout << "SDFGen - SDF Generation Tool\n";
-  std::cout << "========================================\n\n";
+  // Batch bookkeeping
+  size_t index = 0;
+  size_t reserved_bytes = 0;
+  std::string error;
+  sdfgen::GenerationStats stats;
+  double load_seconds = 0.0, compute_seconds = 0.0;
+
+  long long cells() const { return (long long)sizes[0] * sizes[1] * sizes[2]; }
+};
 
-  if(mode_precise) {
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Load, weld, check and optionally repair a mesh, then size its grid
+ *
+ * Grid dimensions are read per file: dx and padding for OBJ, Nx (or Nx Ny Nz) for STL.
+ *
+ * @param log Receives the progress report
+ * @param report_analysis Print the full watertightness report (else one line in log)
+ * @return false if the mesh could not be loaded or the dimensions are invalid
+ */
+bool load_mesh(MeshJob& job, const std::vector<float>& dimensions, const CliSettings& settings,
+               std::ostream& log, bool report_analysis) {
+  std::string ext = job.filename.substr(job.filename.find_last_of(".") + 1);
+  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+  job.mode_precise = (ext == "stl");
+  job.padding = settings.padding;
+  const int num_threads = settings.num_threads;
+  int& padding = job.padding;
+  float& dx = job.dx;
+
+  if(job.mode_precise) {
     // === MODE 2: STL with grid dimensions ===
-    std::cout << "Mode: Grid dimensions (STL)\n";
-    std::cout << "Input: " << filename << "\n\n";
+    log << "Mode: Grid dimensions (STL)\n";
+    log << "Input: " << job.filename << "\n\n";
 
     // Load STL file first to get mesh dimensions
-    if(!meshio::load_stl(filename.c_str(), vertList, faceList, min_box, max_box)) {
+    if(!meshio::load_stl(job.filename.c_str(), job.vertList, job.faceList, job.min_box, job.max_box,
+                         settings.dedup_vertices)) {
       std::cerr << "Failed to load STL file.\n";
-      return 1;
+      return false;
     }
 
-    Vec3f mesh_size = max_box - min_box;
+    Vec3f mesh_size = job.max_box - job.min_box;
 
     // Parse dimensions: [Nx] or [Nx, Ny, Nz]
     if (dimensions.size() == 1 || dimensions.size() == 2) {
       // Proportional mode: Nx only (optional padding in dimensions[1] for backwards compat)
-      target_nx = (int)dimensions[0];
+      job.target_nx = (int)dimensions[0];
       if (dimensions.size() == 2 && dimensions[1] < 20) {
         padding = (int)dimensions[1];  // Backwards compat: SDFGen mesh.stl 256 2
       }
 
-      if(target_nx <= 0) {
+      if(job.target_nx <= 0) {
         std::cerr << "Error: Grid dimension must be a positive integer.\n";
-        return 1;
+        return false;
       }
       if(padding < 1) padding = 1;
 
       // Calculate dx based on X dimension
-      dx = mesh_size[0] / (target_nx - 2 * padding);
+      dx = mesh_size[0] / (job.target_nx - 2 * padding);
 
       // Calculate Ny and Nz proportionally to maintain aspect ratio
-      target_ny = (int)((mesh_size[1] / dx) + 0.5f) + 2 * padding;
-      target_nz = (int)((mesh_size[2] / dx) + 0.5f) + 2 * padding;
+      job.target_ny = (int)((mesh_size[1] / dx) + 0.5f) + 2 * padding;
+      job.target_nz = (int)((mesh_size[2] / dx) + 0.5f) + 2 * padding;
 
-      std::cout << "Mode: Proportional dimensions\n";
-      std::cout << "Input Nx: " << target_nx << "\n";
-      std::cout << "Calculated grid: " << target_nx << " x " << target_ny << " x " << target_nz << "\n";
+      log << "Mode: Proportional dimensions\n";
+      log << "Input Nx: " << job.target_nx << "\n";
+      log << "Calculated grid: " << job.target_nx << " x " << job.target_ny << " x " << job.target_nz << "\n";
 
     } else if (dimensions.size() >= 3) {
       // Manual mode: Nx, Ny, Nz
-      target_nx = (int)dimensions[0];
-      target_ny = (int)dimensions[1];
-      target_nz = (int)dimensions[2];
+      job.target_nx = (int)dimensions[0];
+      job.target_ny = (int)dimensions[1];
+      job.target_nz = (int)dimensions[2];
 
-      if(target_nx <= 0 || target_ny <= 0 || target_nz <= 0) {
+      if(job.target_nx <= 0 || job.target_ny <= 0 || job.target_nz <= 0) {
         std::cerr << "Error: Grid dimensions must be positive integers.\n";
-        return 1;
+        return false;
       }
       if(padding < 1) padding = 1;
 
       // Calculate dx to fit the mesh into target grid
-      float dx_x = mesh_size[0] / (target_nx - 2 * padding);
-      float dx_y = mesh_size[1] / (target_ny - 2 * padding);
-      float dx_z = mesh_size[2] / (target_nz - 2 * padding);
+      float dx_x = mesh_size[0] / (job.target_nx - 2 * padding);
+      float dx_y = mesh_size[1] / (job.target_ny - 2 * padding);
+      float dx_z = mesh_size[2] / (job.target_nz - 2 * padding);
       dx = std::max(dx_x, std::max(dx_y, dx_z));
 
-      std::cout << "Mode: Manual dimensions\n";
-      std::cout << "Target grid: " << target_nx << " x " << target_ny << " x " << target_nz << "\n";
+      log << "Mode: Manual dimensions\n";
+      log << "Target grid: " << job.target_nx << " x " << job.target_ny << " x " << job.target_nz << "\n";
     }
 
-    std::cout << "Padding: " << padding << " cells\n";
-    std::cout << "Threads: " << (num_threads == 0 ? "auto" : std::to_string(num_threads)) << "\n\n";
-    std::cout << "Mesh size: " << mesh_size[0] << " x " << mesh_size[1] << " x " << mesh_size[2] << " m\n";
-    std::cout << "Cell size (dx): " << dx << " m\n\n";
+    log << "Padding: " << padding << " cells\n";
+    log << "Threads: " << (num_threads == 0 ? "auto" : std::to_string(num_threads)) << "\n\n";
+    log << "Mesh size: " << mesh_size[0] << " x " << mesh_size[1] << " x " << mesh_size[2] << " m\n";
+    log << "Cell size (dx): " << dx << " m\n\n";
 
   } else {
     // === MODE 1: OBJ with dx spacing ===
-    std::cout << "Mode: Cell size spacing (OBJ)\n";
-    std::cout << "Input: " << filename << "\n\n";
+    log << "Mode: Cell size spacing (OBJ)\n";
+    log << "Input: " << job.filename << "\n\n";
 
     // OBJ requires: dx [padding]
     if (dimensions.empty()) {
       std::cerr << "Error: OBJ mode requires cell size (dx).\n";
       std::cerr << "Usage: SDFGen mesh.obj <dx> [-p padding]\n";
-      return 1;
+      return false;
     }
 
     dx = dimensions[0];
@@ -170,178 +212,944 @@ int main(int argc, char* argv[]) {
     }
     if(padding < 1) padding = 1;
 
-    std::cout << "Cell size (dx): " << dx << "\n";
-    std::cout << "Padding: " << padding << " cells\n";
-    std::cout << "Threads: " << (num_threads == 0 ? "auto" : std::to_string(num_threads)) << "\n\n";
+    log << "Cell size (dx): " << dx << "\n";
+    log << "Padding: " << padding << " cells\n";
+    log << "Threads: " << (num_threads == 0 ? "auto" : std::to_string(num_threads)) << "\n\n";
 
     // Load OBJ file
-    if(!meshio::load_obj(filename.c_str(), vertList, faceList, min_box, max_box)) {
+    if(!meshio::load_obj(job.filename.c_str(), job.vertList, job.faceList, job.min_box, job.max_box)) {
       std::cerr << "Failed to load OBJ file.\n";
-      return 1;
+      return false;
     }
   }
 
   // Weld duplicate vertices (STL files have separate vertices per triangle)
-  int welded = meshio::weld_vertices(vertList, faceList, 1e-5f);
+  int welded = meshio::weld_vertices(job.vertList, job.faceList, 1e-5f, num_threads);
   if (welded > 0) {
-    std::cout << "Welded " << welded << " duplicate vertices\n";
-    std::cout << "Mesh now has " << vertList.size() << " vertices, " << faceList.size() << " triangles\n";
+    log << "Welded " << welded << " duplicate vertices\n";
+    log << "Mesh now has " << job.vertList.size() << " vertices, " << job.faceList.size() << " triangles\n";
   }
 
   // Analyze mesh watertightness (always)
-  meshio::MeshAnalysis mesh_analysis = meshio::analyze_mesh(vertList, faceList);
-  meshio::print_mesh_analysis(mesh_analysis, false);
+  meshio::MeshTopology mesh_topology = meshio::analyze_mesh_topology(job.vertList, job.faceList, num_threads);
+  if (report_analysis) {
+    meshio::print_mesh_analysis(mesh_topology.summary, false);
+  } else {
+    log << "Watertight: " << (mesh_topology.summary.is_watertight ? "yes" : "NO")
+        << " (" << mesh_topology.summary.num_holes << " holes)\n";
+  }
 
   // Optionally repair mesh if --fix flag was provided
-  if (fix_mesh && !mesh_analysis.is_watertight) {
-    std::cout << "\nAttempting mesh repair (--fix)...\n";
-    int holes_filled = meshio::repair_mesh(vertList, faceList, 0.0f);  // No re-welding needed
+  if (settings.fix_mesh && !mesh_topology.summary.is_watertight) {
+    log << "\nAttempting mesh repair (--fix)...\n";
+    int holes_filled = meshio::repair_mesh(job.vertList, job.faceList, mesh_topology);  // Reuses the analysis above
     if (holes_filled > 0) {
       // Recalculate bounding box after repair
-      min_box = Vec3f(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
-      max_box = Vec3f(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
-      for (const auto& v : vertList) {
-        meshio::update_minmax(v, min_box, max_box);
+      job.min_box = Vec3f(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+      job.max_box = Vec3f(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+      for (const auto& v : job.vertList) {
+        meshio::update_minmax(v, job.min_box, job.max_box);
       }
     }
-    std::cout << "\n";
+    log << "\n";
   }
 
   // Add padding around the box and compute final grid dimensions
-  Vec3ui sizes;
-  if(mode_precise) {
+  if(job.mode_precise) {
     // Use exact target dimensions
-    sizes = Vec3ui(target_nx, target_ny, target_nz);
+    job.sizes = Vec3ui(job.target_nx, job.target_ny, job.target_nz);
 
     // Recalculate bounds to exactly fit the target grid with calculated dx
     // Center the mesh in the grid with padding on all sides
-    Vec3f mesh_size = max_box - min_box;
-    Vec3f grid_size = Vec3f(sizes[0] * dx, sizes[1] * dx, sizes[2] * dx);
-    Vec3f mesh_center = (min_box + max_box) * 0.5f;
+    Vec3f grid_size = Vec3f(job.sizes[0] * dx, job.sizes[1] * dx, job.sizes[2] * dx);
+    Vec3f mesh_center = (job.min_box + job.max_box) * 0.5f;
 
-    min_box = mesh_center - grid_size * 0.5f;
-    max_box = mesh_center + grid_size * 0.5f;
+    job.min_box = mesh_center - grid_size * 0.5f;
+    job.max_box = mesh_center + grid_size * 0.5f;
   } else {
     // Legacy mode: add padding, then calculate sizes
     Vec3f unit(1,1,1);
-    min_box -= padding*dx*unit;
-    max_box += padding*dx*unit;
-    sizes = Vec3ui((max_box - min_box)/dx);
+    job.min_box -= padding*dx*unit;
+    job.max_box += padding*dx*unit;
+    job.sizes = Vec3ui((job.max_box - job.min_box)/dx);
   }
+  return true;
+}
+
+/**
+ * @brief Output file name: mesh name, plus _sdf_NxNyNz in grid dimension mode, plus suffix and extension
+ */
+std::string output_name(const MeshJob& job, const char* extension) {
+  std::string outname = job.filename.substr(0, job.filename.find_last_of("."));
+  if(job.mode_precise) {
+    char dims[128];
+    // Proportional or manual mode: hill_sdf_615x615x113.sdf
+    sprintf(dims, "_sdf_%dx%dx%d", (int)job.sizes[0], (int)job.sizes[1], (int)job.sizes[2]);
+    outname += std::string(dims);
+  }
+  return outname + job.suffix + extension;
+}
+
+/**
+ * @brief Dense-field generation options for the command-line settings
+ *
+ * Phases are always marked as NVTX ranges (CUDA builds) and also recorded into trace when given.
+ */
+sdfgen::GenerationOptions generation_options(const CliSettings& settings, const std::vector<int>& device_list,
+                                             sdfgen::PhaseTrace* trace) {
+  sdfgen::GenerationOptions gen_options;
+  gen_options.backend = settings.force_cpu ? sdfgen::HardwareBackend::CPU : sdfgen::HardwareBackend::Auto;
+  gen_options.num_threads = settings.num_threads;
+  gen_options.distance_mode = settings.exact_distances ? sdfgen::DistanceMode::Exact : sdfgen::DistanceMode::Sweep;
+  gen_options.sign_mode = settings.winding_signs ? sdfgen::SignMode::WindingNumber
+                        : settings.ray_vote ? sdfgen::SignMode::RayVote : sdfgen::SignMode::Parity;
+  gen_options.triangle_table = settings.triangle_table;
+  gen_options.spatial_reorder = settings.spatial_reorder;
+  gen_options.grid_layout = settings.bricked ? sdfgen::GridLayout::Bricked : sdfgen::GridLayout::Linear;
+  gen_options.gpu_sweep_mode = settings.gpu_fim ? sdfgen::GpuSweepMode::ActiveTiles : sdfgen::GpuSweepMode::Jacobi;
+  gen_options.gpu_near_band = settings.gpu_binned ? sdfgen::GpuNearBandMode::Binned : sdfgen::GpuNearBandMode::PerTriangle;
+  if(settings.gpu_streamed) gen_options.gpu_memory = sdfgen::GpuMemoryMode::Streamed;
+  gen_options.gpu_devices = device_list;
+  gen_options.diagnostics = settings.stats;
+  sdfgen::PhaseHook nvtx = sdfgen::nvtx_phase_hook();
+  if (trace) {
+    sdfgen::PhaseHook record = trace->hook();
+    gen_options.phase_hook = [nvtx, record](sdfgen::GenerationPhase phase, bool begin) {
+      if (nvtx) nvtx(phase, begin);
+      record(phase, begin);
+    };
+  } else {
+    gen_options.phase_hook = nvtx;
+  }
+  return gen_options;
+}
+
+/**
+ * @brief Print the statistics of one dense generation (--stats)
+ */
+void print_stats(const sdfgen::GenerationStats& stats, std::ostream& out) {
+  const double mb = 1024.0 * 1024.0;
+  const bool gpu = stats.backend_used == sdfgen::HardwareBackend::GPU;
+  out << "Generation stats (" << (gpu ? "GPU" : "CPU") << "):\n";
+  if (stats.backend_auto) {
+    out << "  Backend choice: estimated CPU " << stats.estimated_cpu_ms << " ms, GPU ";
+    if (stats.estimated_gpu_ms > 0.0) out << stats.estimated_gpu_ms << " ms\n";
+    else out << "n/a\n";
+  }
+  out << "  Phases: setup " << stats.setup_ms << " ms, near band " << stats.near_band_ms << " ms, sweep "
+      << stats.sweep_ms << " ms, sign " << stats.sign_ms << " ms";
+  if (gpu) out << ", copy " << stats.copy_ms << " ms";
+  out << "\n";
+  if (stats.diagnostics_valid) {
+    out << "  Near band: " << stats.near_band_cells << " cells, distances [" << stats.near_band_min << ", "
+        << stats.near_band_max << "], " << stats.intersections << " crossings\n";
+  }
+  out << "  Distance evaluations: " << stats.distance_evaluations;
+  if (gpu) out << " (" << stats.gpu_cas_retries << " CAS retries)";
+  out << "\n";
+  out << "  Sweep iterations: " << stats.sweep_iterations << "\n";
+  if (stats.winding_evaluations > 0) out << "  Winding evaluations: " << stats.winding_evaluations << "\n";
+  out << "  Host memory: " << stats.host_bytes / mb << " MB\n";
+  if (gpu) {
+    out << "  Device memory: " << stats.device_bytes / mb << " MB, transfers " << stats.bytes_to_device / mb
+        << " MB to device, " << stats.bytes_to_host / mb << " MB to host\n";
+  }
+}
+
+/**
+ * @brief Write a dense field (.vti with VTK, else .sdf or .csdf) and report it
+ *
+ * @param log Receives the progress report and output summary
+ * @param outname Receives the written file name
+ * @return false if the file could not be written
+ */
+bool write_field(const MeshJob& job, const CliSettings& settings, std::ostream& log, std::string& outname) {
+  const Array3f& phi_grid = job.phi_grid;
+  const float dx = job.dx;
+
+  #ifdef HAVE_VTK
+    // VTK output mode: written straight from the grid, blocks compressed in parallel
+    outname = output_name(job, ".vti");
+    log << "Writing VTK output to: " << outname << "\n";
+    sdfgen::VtiOptions vti_options;
+    vti_options.compression = settings.vti_compression;
+    vti_options.num_threads = settings.num_threads;
+    return write_vti(outname, phi_grid, Vec3f(phi_grid.ni*dx/2, phi_grid.nj*dx/2, phi_grid.nk*dx/2), dx, vti_options);
+
+  #else
+    // Binary SDF output (no VTK)
+    outname = output_name(job, settings.compress ? ".csdf" : ".sdf");
+
+    // Use shared SDF file writing function
+    int inside_count = 0;
+    int total_count = phi_grid.ni * phi_grid.nj * phi_grid.nk;
+    long long file_size_bytes = 36 + (long long)total_count * sizeof(float);
+
+    if (settings.compress) {
+      log << "Writing compressed SDF to: " << outname << "\n";
+      sdfgen::SdfCompression compression;
+      compression.quantize_bits = settings.quantize_bits;
+      compression.band = settings.truncate_band * dx;
+      compression.num_threads = settings.num_threads;
+      if (!write_compressed_sdf(outname, phi_grid, job.min_box, dx, compression)) {
+        std::cerr << "ERROR: Failed to write compressed SDF file.\n";
+        return false;
+      }
+      for (size_t n = 0; n < phi_grid.a.size(); ++n) {
+        if (phi_grid.a[n] < 0) inside_count++;
+      }
+      std::ifstream written(outname.c_str(), std::ios::binary | std::ios::ate);
+      file_size_bytes = (long long)written.tellg();
+    } else {
+      log << "Writing binary SDF to: " << outname << "\n";
+      sdfgen::SdfLayout layout = settings.native_layout ? sdfgen::SdfLayout::Native : sdfgen::SdfLayout::COrder;
+      if (!write_sdf_binary(outname, phi_grid, job.min_box, dx, &inside_count, layout, settings.num_threads)) {
+        std::cerr << "ERROR: Failed to write SDF file.\n";
+        return false;
+      }
+    }
+
+    // Print validation statistics
+    log << "\n========================================\n";
+    log << "Output Summary\n";
+    log << "========================================\n";
+    log << "File: " << outname << "\n";
+    log << "Dimensions: " << phi_grid.ni << " x " << phi_grid.nj << " x " << phi_grid.nk << "\n";
+
+    if(job.mode_precise) {
+      bool exact_match = (phi_grid.ni == job.target_nx && phi_grid.nj == job.target_ny && phi_grid.nk == job.target_nz);
+      log << "Target dimensions: " << job.target_nx << " x " << job.target_ny << " x " << job.target_nz << "\n";
+      log << "Match: " << (exact_match ? "OK" : "FAIL") << "\n";
+    }
+
+    log << "Grid spacing (dx): " << dx << "\n";
+    log << "Bounds: (" << job.min_box << ") to (" << job.max_box << ")\n";
+    log << "Inside cells: " << inside_count << " / " << total_count;
+    log << " (" << (100.0f * inside_count / total_count) << "%)\n";
+
+    float file_size_mb = file_size_bytes / (1024.0f * 1024.0f);
+    log << "File size: " << file_size_mb << " MB\n";
+    log << "========================================\n";
+    return true;
+  #endif
+}
+
+// ============================================================================
+// Batch pipeline (--batch)
+// ============================================================================
+
+/**
+ * @brief Blocking FIFO of bounded capacity between two pipeline stages
+ *
+ * push() waits while the queue is full. pop() waits for an item, and returns false once
+ * close() has been called and nothing it may take is left.
+ */
+template<class T>
+class BoundedQueue {
+public:
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity), closed_(false) {}
+
+  void push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this]() { return items_.size() < capacity_; });
+    items_.push_back(std::move(item));
+    not_empty_.notify_all();
+  }
+
+  bool pop(T& item) {
+    return pop(item, [](const std::deque<T>&) { return 0; });
+  }
+
+  /**
+   * @brief Take the item chosen by select(items): its index, or -1 if none of them suits the caller
+   */
+  template<class Select>
+  bool pop(T& item, Select select) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    int chosen = -1;
+    not_empty_.wait(lock, [&]() {
+      chosen = items_.empty() ? -1 : select(items_);
+      return chosen >= 0 || closed_;
+    });
+    if (chosen < 0) return false;
+    item = std::move(items_[chosen]);
+    items_.erase(items_.begin() + chosen);
+    not_full_.notify_all();
+    return true;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+private:
+  size_t capacity_;
+  bool closed_;
+  std::deque<T> items_;
+  std::mutex mutex_;
+  std::condition_variable not_full_, not_empty_;
+};
+
+/**
+ * @brief Bytes that the meshes in flight may hold together
+ *
+ * acquire() waits until the request fits; a request larger than the whole budget is let
+ * through when nothing else is held, so one oversized mesh runs alone instead of never.
+ */
+class MemoryBudget {
+public:
+  explicit MemoryBudget(size_t limit) : limit_(limit), used_(0) {}
+
+  void acquire(size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    released_.wait(lock, [&]() { return used_ == 0 || used_ + bytes <= limit_; });
+    used_ += bytes;
+  }
+
+  void release(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    used_ -= bytes;
+    released_.notify_all();
+  }
+
+private:
+  size_t limit_;
+  size_t used_;
+  std::mutex mutex_;
+  std::condition_variable released_;
+};
+
+/**
+ * @brief Mesh paths listed in a batch file: one per line, blank lines and # comments skipped
+ */
+bool read_batch_list(const std::string& list_file, std::vector<std::string>& files) {
+  std::ifstream list(list_file.c_str());
+  if (!list) {
+    std::cerr << "Error: Cannot open batch list " << list_file << "\n";
+    return false;
+  }
+  std::string line;
+  while (std::getline(list, line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') continue;
+    size_t last = line.find_last_not_of(" \t\r");
+    files.push_back(line.substr(first, last - first + 1));
+  }
+  return true;
+}
+
+/**
+ * @brief Generate a dense field for every mesh in a list, with the stages overlapped
+ *
+ * Three stages run concurrently: one thread loads, welds, checks and repairs the meshes in
+ * list order; compute workers generate the fields; one thread writes them. Bounded queues
+ * sit between the stages, and a memory budget caps the meshes and grids in flight (a mesh
+ * reserves its bytes after loading and returns them once written). With a GPU, a GPU worker
+ * takes the largest waiting grid while the CPU worker takes grids below the GPU threshold,
+ * so large meshes go to the device and small ones to the CPU cores at the same time.
+ *
+ * @return Process exit code: 0 if every mesh was written, 1 otherwise
+ */
+int run_batch(const std::string& list_file, const std::vector<float>& dimensions, const CliSettings& settings,
+              const std::vector<int>& device_list, sdfgen::PhaseTrace* trace) {
+  std::vector<std::string> files;
+  if (!read_batch_list(list_file, files)) return 1;
+  if (files.empty()) {
+    std::cerr << "Error: Batch list " << list_file << " names no meshes.\n";
+    return 1;
+  }
+
+  const bool gpu_worker = !settings.force_cpu && !settings.exact_distances && sdfgen::is_gpu_available();
+  const size_t budget_bytes = (size_t)settings.batch_memory_mb << 20;
+
+  std::cout << "========================================\n";
+  std::cout << "SDFGen - Batch SDF Generation\n";
+  std::cout << "========================================\n\n";
+  std::cout << "List: " << list_file << " (" << files.size() << " meshes)\n";
+  std::cout << "Compute workers: CPU" << (gpu_worker ? " + GPU" : "") << "\n";
+  if (gpu_worker) {
+    std::cout << "GPU threshold: " << settings.batch_gpu_cells << " cells (smaller grids run on the CPU)\n";
+  }
+  std::cout << "Memory budget: " << settings.batch_memory_mb << " MB\n\n";
+
+  typedef std::unique_ptr<MeshJob> JobPtr;
+  BoundedQueue<JobPtr> compute_queue(BATCH_QUEUE_DEPTH);
+  BoundedQueue<JobPtr> write_queue(BATCH_QUEUE_DEPTH);
+  MemoryBudget memory(budget_bytes);
+  std::mutex console;
+  std::atomic<int> failed(0);
+  std::atomic<int> compute_workers(gpu_worker ? 2 : 1);
+  const auto start = std::chrono::steady_clock::now();
+
+  // Stage 1: load and repair, in list order
+  std::thread loader([&]() {
+    for (size_t n = 0; n < files.size(); ++n) {
+      JobPtr job(new MeshJob());
+      job->index = n;
+      job->filename = files[n];
+      std::ostringstream log;
+      auto load_start = std::chrono::steady_clock::now();
+      bool loaded = false;
+      try {
+        loaded = load_mesh(*job, dimensions, settings, log, false);
+      } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+      }
+      job->load_seconds = seconds_since(load_start);
+      {
+        std::lock_guard<std::mutex> lock(console);
+        std::cout << log.str();
+        if (!loaded) {
+          std::cout << "[" << n + 1 << "/" << files.size() << "] " << files[n] << ": FAILED to load, skipped\n\n";
+        }
+      }
+      if (!loaded) {
+        ++failed;
+        continue;
+      }
+
+      job->reserved_bytes = job->vertList.size() * sizeof(Vec3f) + job->faceList.size() * sizeof(Vec3ui) +
+                            (size_t)job->cells() * BATCH_BYTES_PER_CELL;
+      memory.acquire(job->reserved_bytes);
+      compute_queue.push(std::move(job));
+    }
+    compute_queue.close();
+  });
+
+  // Stage 2: generate; the GPU worker takes the largest grid, the CPU worker the smallest
+  // one below the GPU threshold (any grid when there is no GPU worker)
+  auto compute = [&](bool gpu) {
+    sdfgen::GenerationOptions gen_options = generation_options(settings, device_list, trace);
+    if (!gpu) gen_options.backend = sdfgen::HardwareBackend::CPU;
+    auto select = [&](const std::deque<JobPtr>& jobs) {
+      int chosen = -1;
+      for (size_t n = 0; n < jobs.size(); ++n) {
+        long long cells = jobs[n]->cells();
+        if (gpu) {
+          if (chosen < 0 || cells > jobs[chosen]->cells()) chosen = (int)n;
+        } else if (!gpu_worker || cells < settings.batch_gpu_cells) {
+          if (chosen < 0 || cells < jobs[chosen]->cells()) chosen = (int)n;
+        }
+      }
+      return chosen;
+    };
+
+    JobPtr job;
+    while (compute_queue.pop(job, select)) {
+      auto compute_start = std::chrono::steady_clock::now();
+      try {
+        sdfgen::make_level_set3(job->faceList, job->vertList, job->min_box, job->dx,
+                                job->sizes[0], job->sizes[1], job->sizes[2], job->phi_grid, gen_options, &job->stats);
+      } catch (const std::exception& e) {
+        job->error = e.what();
+      }
+      job->compute_seconds = seconds_since(compute_start);
+
+      // Only the field goes on to the writer
+      size_t field_bytes = (size_t)job->cells() * sizeof(float);
+      std::vector<Vec3f>().swap(job->vertList);
+      std::vector<Vec3ui>().swap(job->faceList);
+      memory.release(job->reserved_bytes - field_bytes);
+      job->reserved_bytes = field_bytes;
+      write_queue.push(std::move(job));
+    }
+    if (--compute_workers == 0) write_queue.close();
+  };
+  std::thread cpu_thread(compute, false);
+  std::thread gpu_thread;
+  if (gpu_worker) gpu_thread = std::thread(compute, true);
+
+  // Stage 3: write, in completion order
+  size_t written = 0;
+  JobPtr job;
+  while (write_queue.pop(job)) {
+    std::ostringstream log;
+    std::string outname;
+    auto write_start = std::chrono::steady_clock::now();
+    bool ok = job->error.empty() && write_field(*job, settings, log, outname);
+    double write_seconds = seconds_since(write_start);
+    memory.release(job->reserved_bytes);
+
+    std::lock_guard<std::mutex> lock(console);
+    std::cout << log.str();
+    std::cout << "[" << job->index + 1 << "/" << files.size() << "] " << job->filename << ": ";
+    if (ok) {
+      ++written;
+      std::cout << job->sizes[0] << " x " << job->sizes[1] << " x " << job->sizes[2] << " on "
+                << (job->stats.backend_used == sdfgen::HardwareBackend::GPU ? "GPU" : "CPU")
+                << " (load " << job->load_seconds << " s, compute " << job->compute_seconds
+                << " s, write " << write_seconds << " s)\n";
+      if (settings.stats) print_stats(job->stats, std::cout);
+      std::cout << "\n";
+    } else {
+      ++failed;
+      std::cout << "FAILED" << (job->error.empty() ? "" : ": " + job->error) << "\n\n";
+    }
+    job.reset();
+  }
+
+  loader.join();
+  cpu_thread.join();
+  if (gpu_thread.joinable()) gpu_thread.join();
+
+  std::cout << "========================================\n";
+  std::cout << "Batch Summary\n";
+  std::cout << "========================================\n";
+  std::cout << "Written: " << written << " / " << files.size() << "\n";
+  std::cout << "Failed: " << failed.load() << "\n";
+  std::cout << "Wall time: " << seconds_since(start) << " s\n";
+  std::cout << "========================================\n";
+  if (trace && !trace->write_json(settings.trace_file)) return 1;
+  return failed.load() == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+
+  CLI::App app{"SDFGen - Generate signed distance fields from triangle meshes"};
+
+  // Positional arguments
+  std::string filename;
+  std::vector<float> dimensions;  // Can be: [dx, padding] for OBJ, or [Nx], [Nx,pad], [Nx,Ny,Nz], [Nx,Ny,Nz,pad] for STL
+
+  app.add_option("input", filename, "Input mesh file (.obj or .stl), or with --batch a list of mesh files")
+      ->required()
+      ->check(CLI::ExistingFile);
+  app.add_option("dimensions", dimensions, "Grid dimensions:\n"
+      "  OBJ: <dx> <padding>           - cell size and padding\n"
+      "  STL: <Nx> [Ny Nz] [padding]   - grid size (proportional or manual)")
+      ->expected(1, 4);
+
+  // Optional flags
+  CliSettings settings;
+
+  app.add_flag("--cpu", settings.force_cpu, "Force CPU backend (skip GPU)");
+  app.add_flag("--fix", settings.fix_mesh, "Repair non-watertight meshes (fill holes)");
+  app.add_flag("--dedup", settings.dedup_vertices, "Merge bit-identical STL vertices while loading (indexed mesh, ~6x fewer vertices)");
+  app.add_flag("--exact", settings.exact_distances, "Exact distances in every cell (BVH query, CPU only)");
+  app.add_flag("--winding", settings.winding_signs, "Inside/outside from the generalized winding number (tolerates holes, no --fix needed)");
+  app.add_flag("--ray-vote", settings.ray_vote, "Inside/outside by majority of x, y and z ray parities (no streaks on axis-aligned CAD)");
+  app.add_flag("--tri-table", settings.triangle_table, "Precompute per-triangle geometry (faster sweeps, 128 bytes/triangle)");
+  app.add_flag("--reorder", settings.spatial_reorder, "Sort triangles along a Morton curve before the near band (same output, better cache use)");
+  app.add_flag("--bricked", settings.bricked, "CPU sweeps on 8^3 Morton bricks (same output; for 1000^3+ grids, +1 grid of memory)");
+  app.add_flag("--gpu-fim", settings.gpu_fim, "GPU far field via active-tile fast iterative method (best on sparse grids)");
+  app.add_flag("--gpu-binned", settings.gpu_binned, "GPU near band binned into 8^3 bricks (meshes mixing large and tiny faces)");
+  app.add_flag("--gpu-streamed", settings.gpu_streamed, "GPU in z-slabs streamed from host memory (automatic when the grid does not fit)");
+  app.add_option("--gpu-devices", settings.gpu_devices, "Split the GPU grid along z across devices: 'all' or a list such as 0,1");
+  app.add_option("--sparse", settings.sparse_band, "Narrow band only: 8^3 bricks within N cells of the surface, written as .ssdf (CPU)");
+  app.add_option("--octree", settings.octree_band, "Adaptive octree refined to dx within N cells of the surface, written as .osdf (CPU)");
+  app.add_option("--fp16", settings.fp16_band, "Dense grid in 16-bit floats, |phi| clamped to N cells, written as .qsdf (CPU, ~1/6 the memory)");
+  app.add_option("--int16", settings.int16_band, "Dense grid in 16-bit fixed point over a band of N cells, written as .qsdf (CPU, ~1/6 the memory)");
+  app.add_option("--roi", settings.roi, "Only the grid nodes in the box x0 y0 z0 x1 y1 z1, on the full grid's lattice (mesh culled to the box)")
+      ->expected(6);
+  app.add_option("--pyramid", settings.pyramid_levels, "Also write L-1 coarser levels (2dx, 4dx, ...); finer levels seeded from coarser (CPU)");
+  app.add_flag("--native-layout", settings.native_layout, "Write .sdf values x-fastest as stored in memory (one write; flagged by a negated Nx)");
+  app.add_flag("--compress", settings.compress, "Write 32^3 compressed chunks with a random-access index, as .csdf");
+  app.add_option("--quantize", settings.quantize_bits, "Store .csdf values as 8- or 16-bit fixed point over the band (implies --compress)");
+  app.add_option("--truncate", settings.truncate_band, "Clamp |phi| to N cells before compressing (implies --compress)");
+  app.add_option("--vti-compress", settings.vti_compress, "Compress .vti output blocks in parallel: zlib or lz4 (VTK builds)");
+  app.add_flag("--batch", settings.batch, "Input is a list of mesh files, one per line: load, compute and write overlap across files");
+  app.add_option("--batch-memory", settings.batch_memory_mb, "Memory budget in MB for the meshes and grids in flight in --batch")
+      ->default_val(4096);
+  app.add_option("--batch-gpu-cells", settings.batch_gpu_cells, "In --batch with a GPU, grids below this many cells run on the CPU")
+      ->default_val(1 << 21);
+  app.add_flag("--stats", settings.stats, "Print phase times, work counters and memory of the dense generation");
+  app.add_option("--trace", settings.trace_file, "Write the generation phases as a Chrome trace (chrome://tracing, Perfetto)");
+  app.add_flag("--quiet", settings.quiet, "Suppress the mesh loading and repair progress messages");
+  app.add_option("--cost-model", settings.cost_model_file, "Backend cost model for the CPU/GPU choice (benchmark_performance --calibrate)");
+  app.add_option("-t,--threads", settings.num_threads, "CPU thread count (0=auto)")
+      ->default_val(0);
+  app.add_option("-p,--padding", settings.padding, "Padding cells around mesh")
+      ->default_val(1);
+
+  // Show full help on error (e.g., missing required arguments)
+  app.failure_message(CLI::FailureMessage::help);
+
+  CLI11_PARSE(app, argc, argv);
+
+  // Validate dimensions
+  if (dimensions.empty()) {
+    std::cerr << "Error: Grid dimensions required.\n";
+    std::cerr << "  OBJ: SDFGen mesh.obj <dx> <padding>\n";
+    std::cerr << "  STL: SDFGen mesh.stl <Nx> [Ny Nz] [padding]\n";
+    return 1;
+  }
+
+  if (settings.winding_signs && settings.ray_vote) {
+    std::cerr << "Error: --winding and --ray-vote select different sign tests; give only one.\n";
+    return 1;
+  }
+
+  if (settings.quantize_bits != 0 && settings.quantize_bits != 8 && settings.quantize_bits != 16) {
+    std::cerr << "Error: --quantize takes 8 or 16 bits.\n";
+    return 1;
+  }
+  if (settings.truncate_band < 0) {
+    std::cerr << "Error: --truncate takes a positive number of cells.\n";
+    return 1;
+  }
+  settings.compress = settings.compress || settings.quantize_bits != 0 || settings.truncate_band > 0;
+  if (settings.compress && settings.native_layout) {
+    std::cerr << "Error: --native-layout applies to .sdf output; .csdf chunks have their own layout.\n";
+    return 1;
+  }
+  if (settings.vti_compress == "zlib") {
+    settings.vti_compression = sdfgen::VtiCompression::ZLib;
+  } else if (settings.vti_compress == "lz4") {
+    settings.vti_compression = sdfgen::VtiCompression::LZ4;
+  } else if (!settings.vti_compress.empty() && settings.vti_compress != "none") {
+    std::cerr << "Error: --vti-compress takes zlib, lz4 or none.\n";
+    return 1;
+  }
+#ifdef HAVE_VTK
+  if (!sdfgen::vti_compression_available(settings.vti_compression)) {
+    std::cerr << "Error: --vti-compress " << settings.vti_compress << " needs a newer VTK (LZ4 since VTK 8.2).\n";
+    return 1;
+  }
+#else
+  if (settings.vti_compression != sdfgen::VtiCompression::None) {
+    std::cerr << "Error: --vti-compress applies to .vti output, which needs a VTK build.\n";
+    return 1;
+  }
+#endif
+  const int compact_band = std::max(settings.fp16_band, settings.int16_band);
+  if ((settings.sparse_band > 0) + (settings.octree_band > 0) + (settings.fp16_band > 0) + (settings.int16_band > 0) > 1) {
+    std::cerr << "Error: --sparse, --octree, --fp16 and --int16 each choose the output layout; pick one.\n";
+    return 1;
+  }
+  if ((settings.winding_signs || settings.ray_vote) &&
+      (settings.sparse_band > 0 || settings.octree_band > 0 || compact_band > 0)) {
+    std::cerr << "Error: --winding and --ray-vote sign dense float output only; --sparse, --octree, --fp16 and --int16 use crossing-parity signs.\n";
+    return 1;
+  }
+  if ((settings.stats || !settings.trace_file.empty()) &&
+      (settings.sparse_band > 0 || settings.octree_band > 0 || compact_band > 0)) {
+    std::cerr << "Error: --stats and --trace report dense generation; drop --sparse, --octree, --fp16 and --int16.\n";
+    return 1;
+  }
+  if (!settings.cost_model_file.empty()) {
+    sdfgen::BackendCostModel cost_model = sdfgen::backend_cost_model();
+    if (!sdfgen::load_cost_model(settings.cost_model_file, cost_model)) return 1;
+    sdfgen::set_backend_cost_model(cost_model);
+  }
+  sdfgen::set_log_enabled(!settings.quiet);
+  sdfgen::PhaseTrace phase_trace;
+  sdfgen::PhaseTrace* trace = settings.trace_file.empty() ? nullptr : &phase_trace;
+  if (settings.batch && (settings.sparse_band > 0 || settings.octree_band > 0 || compact_band > 0)) {
+    std::cerr << "Error: --batch writes dense fields; run --sparse, --octree, --fp16 and --int16 per file.\n";
+    return 1;
+  }
+  const bool region = !settings.roi.empty();
+  if (region && (settings.roi[0] >= settings.roi[3] || settings.roi[1] >= settings.roi[4] ||
+                 settings.roi[2] >= settings.roi[5])) {
+    std::cerr << "Error: --roi takes the lower corner x0 y0 z0, then the upper corner x1 y1 z1.\n";
+    return 1;
+  }
+  if (settings.pyramid_levels < 0) {
+    std::cerr << "Error: --pyramid takes a positive number of levels.\n";
+    return 1;
+  }
+  if ((region || settings.pyramid_levels > 0) &&
+      (settings.batch || settings.sparse_band > 0 || settings.octree_band > 0 || compact_band > 0)) {
+    std::cerr << "Error: --roi and --pyramid write dense fields of one mesh; drop --batch, --sparse, --octree, --fp16 and --int16.\n";
+    return 1;
+  }
+  if (settings.batch && settings.batch_memory_mb <= 0) {
+    std::cerr << "Error: --batch-memory takes a positive number of MB.\n";
+    return 1;
+  }
+
+  // GPU device list
+  std::vector<int> device_list;
+  if(settings.gpu_devices == "all") {
+    for(int d = 0; d < sdfgen::gpu_device_count(); ++d) device_list.push_back(d);
+  } else if(!settings.gpu_devices.empty()) {
+    std::stringstream list(settings.gpu_devices);
+    std::string item;
+    while(std::getline(list, item, ',')) {
+      char* end = nullptr;
+      long d = std::strtol(item.c_str(), &end, 10);
+      if(item.empty() || *end != '\0' || d < 0) {
+        std::cerr << "Error: Invalid --gpu-devices entry '" << item << "' (expected 'all' or a list such as 0,1)\n";
+        return 1;
+      }
+      device_list.push_back((int)d);
+    }
+  }
+
+  if (settings.batch) {
+    return run_batch(filename, dimensions, settings, device_list, trace);
+  }
+
+  std::cout << "========================================\n";
+  std::cout << "SDFGen - SDF Generation Tool\n";
+  std::cout << "========================================\n\n";
+
+  MeshJob job;
+  job.filename = filename;
+  if (!load_mesh(job, dimensions, settings, std::cout, true)) {
+    return 1;
+  }
+  if (region) {
+    // Snap the box to the nodes of the full grid and generate only those
+    Vec3f origin;
+    int nx, ny, nz;
+    sdfgen::roi_grid(job.min_box, job.dx, Vec3f(settings.roi[0], settings.roi[1], settings.roi[2]),
+                     Vec3f(settings.roi[3], settings.roi[4], settings.roi[5]), origin, nx, ny, nz);
+    std::cout << "Region of interest: (" << settings.roi[0] << " " << settings.roi[1] << " " << settings.roi[2]
+              << ") to (" << settings.roi[3] << " " << settings.roi[4] << " " << settings.roi[5] << ")\n\n";
+    job.sizes = Vec3ui(nx, ny, nz);
+    job.target_nx = nx;
+    job.target_ny = ny;
+    job.target_nz = nz;
+    job.min_box = origin;
+    job.max_box = origin + Vec3f(nx * job.dx, ny * job.dx, nz * job.dx);
+    job.suffix = "_roi";
+  }
+  const std::vector<Vec3f>& vertList = job.vertList;
+  const std::vector<Vec3ui>& faceList = job.faceList;
+  const Vec3f& min_box = job.min_box;
+  const Vec3f& max_box = job.max_box;
+  const Vec3ui& sizes = job.sizes;
+  const float dx = job.dx;
+  const int sparse_band = settings.sparse_band;
+  const int octree_band = settings.octree_band;
+  const bool dense_float = octree_band == 0 && sparse_band == 0 && compact_band == 0;
 
   std::cout << "Computing signed distance field...\n";
   std::cout << "  Padded bounds: (" << min_box << ") to (" << max_box << ")\n";
   std::cout << "  Grid dimensions: " << sizes[0] << " x " << sizes[1] << " x " << sizes[2] << "\n";
   std::cout << "  Total cells: " << (sizes[0] * sizes[1] * sizes[2]) << "\n";
-
-  // Runtime dispatch between CPU and GPU implementations using unified API
-  Array3f phi_grid;
-  sdfgen::HardwareBackend backend = force_cpu ? sdfgen::HardwareBackend::CPU : sdfgen::HardwareBackend::Auto;
+  if(settings.winding_signs && dense_float) {
+    std::cout << "  Signs: generalized winding number (--winding)\n";
+  }
+  if(settings.ray_vote && dense_float) {
+    std::cout << "  Signs: majority of x, y and z ray parities (--ray-vote)\n";
+  }
 
   // Report which backend will be/was used
   std::cout << "  Hardware: ";
-  if(force_cpu) {
+  if(settings.pyramid_levels > 0) {
+    std::cout << "CPU (coarse-to-fine pyramid, --pyramid)\n";
+    std::cout << "  Implementation: CPU (up to " << settings.pyramid_levels
+              << " levels, finer near bands seeded from the coarser level)\n\n";
+  } else if(octree_band > 0) {
+    std::cout << "CPU (adaptive octree, --octree)\n";
+    std::cout << "  Implementation: CPU (BVH corner queries, refined within " << octree_band << " cells)\n\n";
+  } else if(sparse_band > 0) {
+    std::cout << "CPU (sparse narrow band, --sparse)\n";
+    std::cout << "  Implementation: CPU (8^3 bricks within " << sparse_band << " cells)\n\n";
+  } else if(compact_band > 0) {
+    std::cout << "CPU (16-bit dense grid, " << (settings.fp16_band > 0 ? "--fp16" : "--int16") << ")\n";
+    std::cout << "  Implementation: CPU (near band over " << compact_band << " cells, packed parity signs)\n\n";
+  } else if(settings.exact_distances) {
+    std::cout << "CPU (exact distance mode, --exact)\n";
+    std::cout << "  Implementation: CPU (BVH nearest-triangle query)\n\n";
+  } else if(settings.force_cpu) {
     std::cout << "CPU mode forced (--cpu flag)\n";
     std::cout << "  Implementation: CPU (multi-threaded)\n\n";
   } else if(sdfgen::is_gpu_available()) {
-    std::cout << "GPU acceleration available\n";
-    std::cout << "  Implementation: GPU (CUDA)\n\n";
+    // Auto picks by the cost model: small grids do not pay for CUDA initialization
+    sdfgen::BackendEstimate estimate = sdfgen::estimate_backend(generation_options(settings, device_list, nullptr),
+                                                                sizes[0], sizes[1], sizes[2], faceList.size());
+    if(estimate.backend == sdfgen::HardwareBackend::GPU) {
+      std::cout << "GPU acceleration available\n";
+      std::cout << "  Implementation: GPU (CUDA)\n";
+      if(estimate.gpu_streamed) std::cout << "  Memory: streamed z-slabs (grid exceeds free device memory)\n";
+      if(device_list.size() > 1) {
+        std::cout << "  Devices: " << device_list.size() << " (z-split, --gpu-devices)\n";
+      }
+    } else {
+      std::cout << "GPU available, CPU predicted faster"
+                << (estimate.gpu_ms > 0.0 ? "" : " (grid does not fit the device memory)") << "\n";
+      std::cout << "  Implementation: CPU (multi-threaded)\n";
+    }
+    std::cout << "  Estimate: CPU " << estimate.cpu_ms << " ms, GPU ";
+    if(estimate.gpu_ms > 0.0) std::cout << estimate.gpu_ms << " ms";
+    else std::cout << "n/a";
+    std::cout << "\n\n";
   } else {
     std::cout << "No CUDA GPU detected\n";
     std::cout << "  Implementation: CPU (multi-threaded)\n\n";
   }
 
-  sdfgen::make_level_set3(faceList, vertList, min_box, dx, sizes[0], sizes[1], sizes[2], phi_grid, 1, backend, num_threads);
+  if(settings.triangle_table) {
+    std::cout << "  Triangle table: " << faceList.size() << " triangles, "
+              << (sdfgen::TriangleTable::bytes_for(faceList.size()) + 1023) / 1024 << " KB (--tri-table)\n\n";
+  }
 
-  std::cout << "SDF computation complete.\n\n";
+  if(octree_band > 0) {
+    // Adaptive output: fine cells near the surface, coarse cells elsewhere
+    sdfgen::GenerationOptions octree_options;
+    octree_options.backend = sdfgen::HardwareBackend::CPU;
+    octree_options.exact_band = octree_band;
+    octree_options.num_threads = settings.num_threads;
+    sdfgen::OctreeLevelSet tree;
+    sdfgen::make_octree_level_set3(faceList, vertList, min_box, dx, sizes[0], sizes[1], sizes[2], tree, octree_options);
+    std::cout << "Octree SDF computation complete (--octree " << octree_band << ").\n\n";
 
-  // Generate output filename
-  std::string outname;
-  std::string base_filename = filename.substr(0, filename.find_last_of("."));
+    std::string outname = output_name(job, ".osdf");
 
-  #ifdef HAVE_VTK
-    // VTK output mode
-    if(mode_precise) {
-      char dims[64];
-      sprintf(dims, "_sdf_%dx%dx%d", phi_grid.ni, phi_grid.nj, phi_grid.nk);
-      outname = base_filename + std::string(dims) + ".vti";
-    } else {
-      outname = base_filename + ".vti";
-    }
-    std::cout << "Writing VTK output to: " << outname << "\n";
-    vtkSmartPointer<vtkImageData> output_volume = vtkSmartPointer<vtkImageData>::New();
-
-    output_volume->SetDimensions(phi_grid.ni ,phi_grid.nj ,phi_grid.nk);
-    output_volume->SetOrigin( phi_grid.ni*dx/2, phi_grid.nj*dx/2,phi_grid.nk*dx/2);
-    output_volume->SetSpacing(dx,dx,dx);
-
-    vtkSmartPointer<vtkFloatArray> distance = vtkSmartPointer<vtkFloatArray>::New();
-    
-    distance->SetNumberOfTuples(phi_grid.a.size());
-    
-    output_volume->GetPointData()->AddArray(distance);
-    distance->SetName("Distance");
-
-    for(unsigned int i = 0; i < phi_grid.a.size(); ++i) {
-      distance->SetValue(i, phi_grid.a[i]);
+    std::cout << "Writing octree SDF to: " << outname << "\n";
+    if (!write_octree_sdf(outname, tree)) {
+      std::cerr << "ERROR: Failed to write octree SDF file.\n";
+      exit(-1);
     }
 
-    vtkSmartPointer<vtkXMLImageDataWriter> writer =
-    vtkSmartPointer<vtkXMLImageDataWriter>::New();
-    writer->SetFileName(outname.c_str());
+    std::cout << "\n========================================\n";
+    std::cout << "Output Summary\n";
+    std::cout << "========================================\n";
+    std::cout << "File: " << outname << "\n";
+    std::cout << "Dimensions: " << tree.ni << " x " << tree.nj << " x " << tree.nk << " (finest level " << tree.levels << ")\n";
+    std::cout << "Finest cell size (dx): " << dx << "\n";
+    std::cout << "Nodes: " << tree.nodes.size() << " (" << tree.leaf_count() << " leaves)\n";
+    std::cout << "Memory: " << tree.memory_bytes() / (1024.0f * 1024.0f) << " MB (dense: "
+              << (float)tree.ni * tree.nj * tree.nk * sizeof(float) / (1024.0f * 1024.0f) << " MB)\n";
+    std::cout << "========================================\n";
+    std::cout << "Processing complete.\n";
+    return 0;
+  }
+
+  if(sparse_band > 0) {
+    // Narrow-band output: bricks near the surface, one sign per tile elsewhere
+    sdfgen::GenerationOptions sparse_options;
+    sparse_options.backend = sdfgen::HardwareBackend::CPU;
+    sparse_options.exact_band = sparse_band;
+    sparse_options.num_threads = settings.num_threads;
+    sdfgen::SparseLevelSet sparse_grid;
+    sdfgen::make_sparse_level_set3(faceList, vertList, min_box, dx, sizes[0], sizes[1], sizes[2], sparse_grid, sparse_options);
+    std::cout << "Sparse SDF computation complete (--sparse " << sparse_band << ").\n\n";
 
-    #if VTK_MAJOR_VERSION <= 5
-      writer->SetInput(output_volume);
-    #else
-      writer->SetInputData(output_volume);
-    #endif
-    writer->Write();
+    std::string outname = output_name(job, ".ssdf");
 
-  #else
-    // Binary SDF output (no VTK)
-    if(mode_precise) {
-      char dims[128];
-      // Proportional or manual mode: hill_sdf_615x615x113.sdf
-      sprintf(dims, "_sdf_%dx%dx%d", phi_grid.ni, phi_grid.nj, phi_grid.nk);
-      outname = base_filename + std::string(dims) + ".sdf";
-    } else {
-      outname = base_filename + ".sdf";
+    std::cout << "Writing sparse SDF to: " << outname << "\n";
+    if (!write_sparse_sdf(outname, sparse_grid)) {
+      std::cerr << "ERROR: Failed to write sparse SDF file.\n";
+      exit(-1);
     }
 
-    std::cout << "Writing binary SDF to: " << outname << "\n";
+    size_t num_tiles = (size_t)sparse_grid.tiles_i() * sparse_grid.tiles_j() * sparse_grid.tiles_k();
+    std::cout << "\n========================================\n";
+    std::cout << "Output Summary\n";
+    std::cout << "========================================\n";
+    std::cout << "File: " << outname << "\n";
+    std::cout << "Dimensions: " << sparse_grid.ni << " x " << sparse_grid.nj << " x " << sparse_grid.nk << "\n";
+    std::cout << "Grid spacing (dx): " << dx << "\n";
+    std::cout << "Band: " << sparse_band << " cells (|phi| clamped to " << sparse_grid.background << ")\n";
+    std::cout << "Active bricks: " << sparse_grid.brick_count() << " / " << num_tiles << " tiles ("
+              << (100.0f * sparse_grid.brick_count() / num_tiles) << "%)\n";
+    std::cout << "Memory: " << sparse_grid.memory_bytes() / (1024.0f * 1024.0f) << " MB (dense: "
+              << (float)sparse_grid.ni * sparse_grid.nj * sparse_grid.nk * sizeof(float) / (1024.0f * 1024.0f) << " MB)\n";
+    std::cout << "========================================\n";
+    std::cout << "Processing complete.\n";
+    return 0;
+  }
 
-    // Use shared SDF file writing function
-    int inside_count = 0;
-    int total_count = phi_grid.ni * phi_grid.nj * phi_grid.nk;
+  if(compact_band > 0) {
+    // 16-bit output: the whole grid, clamped to the band
+    sdfgen::GenerationOptions compact_options;
+    compact_options.backend = sdfgen::HardwareBackend::CPU;
+    compact_options.exact_band = compact_band;
+    compact_options.num_threads = settings.num_threads;
+    sdfgen::CompactFormat format = settings.fp16_band > 0 ? sdfgen::CompactFormat::Half : sdfgen::CompactFormat::Int16;
+    const char* flag = settings.fp16_band > 0 ? "--fp16" : "--int16";
+    sdfgen::CompactLevelSet compact_grid;
+    sdfgen::make_compact_level_set3(faceList, vertList, min_box, dx, sizes[0], sizes[1], sizes[2], format,
+                                    compact_grid, compact_options);
+    std::cout << "Compact SDF computation complete (" << flag << " " << compact_band << ").\n\n";
 
-    if (!write_sdf_binary(outname, phi_grid, min_box, dx, &inside_count)) {
-      std::cerr << "ERROR: Failed to write SDF file.\n";
+    std::string outname = output_name(job, ".qsdf");
+
+    std::cout << "Writing compact SDF to: " << outname << "\n";
+    if (!write_compact_sdf(outname, compact_grid)) {
+      std::cerr << "ERROR: Failed to write compact SDF file.\n";
       exit(-1);
     }
 
-    // Print validation statistics
     std::cout << "\n========================================\n";
     std::cout << "Output Summary\n";
     std::cout << "========================================\n";
     std::cout << "File: " << outname << "\n";
-    std::cout << "Dimensions: " << phi_grid.ni << " x " << phi_grid.nj << " x " << phi_grid.nk << "\n";
+    std::cout << "Dimensions: " << compact_grid.ni << " x " << compact_grid.nj << " x " << compact_grid.nk << "\n";
+    std::cout << "Grid spacing (dx): " << dx << "\n";
+    std::cout << "Band: " << compact_band << " cells (|phi| clamped to " << compact_grid.band << ")\n";
+    if (format == sdfgen::CompactFormat::Half) {
+      std::cout << "Encoding: fp16 (relative precision 2^-11)\n";
+    } else {
+      std::cout << "Encoding: int16 (step " << compact_grid.band / 32767.0f << ")\n";
+    }
+    std::cout << "Memory: " << compact_grid.memory_bytes() / (1024.0f * 1024.0f) << " MB (dense: "
+              << (float)compact_grid.ni * compact_grid.nj * compact_grid.nk * sizeof(float) / (1024.0f * 1024.0f) << " MB)\n";
+    std::cout << "========================================\n";
+    std::cout << "Processing complete.\n";
+    return 0;
+  }
 
-    if(mode_precise) {
-      bool exact_match = (phi_grid.ni == target_nx && phi_grid.nj == target_ny && phi_grid.nk == target_nz);
-      std::cout << "Target dimensions: " << target_nx << " x " << target_ny << " x " << target_nz << "\n";
-      std::cout << "Match: " << (exact_match ? "OK" : "FAIL") << "\n";
+  // Runtime dispatch between CPU and GPU implementations using unified API
+  sdfgen::GenerationOptions gen_options = generation_options(settings, device_list, trace);
+  std::vector<Array3f> pyramid;
+  if(region || settings.pyramid_levels > 0) {
+    // The context culls the mesh to the grid through a BVH; it takes the mesh over
+    const size_t num_triangles = faceList.size();
+    sdfgen::GenerationContext context(std::move(job.faceList), std::move(job.vertList));
+    if(settings.pyramid_levels > 0) {
+      sdfgen::make_level_set_pyramid3(context, min_box, dx, sizes[0], sizes[1], sizes[2], settings.pyramid_levels,
+                                      pyramid, gen_options, &job.stats);
+      job.phi_grid.ni = pyramid[0].ni;
+      job.phi_grid.nj = pyramid[0].nj;
+      job.phi_grid.nk = pyramid[0].nk;
+      job.phi_grid.a.swap(pyramid[0].a);
+    } else {
+      size_t kept = 0;
+      sdfgen::make_roi_level_set3(context, min_box, dx, sizes[0], sizes[1], sizes[2], job.phi_grid, gen_options,
+                                  &job.stats, &kept);
+      std::cout << "Region triangles: " << kept << " of " << num_triangles << "\n";
     }
+  } else {
+    sdfgen::make_level_set3(faceList, vertList, min_box, dx, sizes[0], sizes[1], sizes[2], job.phi_grid, gen_options,
+                            &job.stats);
+  }
 
-    std::cout << "Grid spacing (dx): " << dx << "\n";
-    std::cout << "Bounds: (" << min_box << ") to (" << max_box << ")\n";
-    std::cout << "Inside cells: " << inside_count << " / " << total_count;
-    std::cout << " (" << (100.0f * inside_count / total_count) << "%)\n";
+  std::cout << "SDF computation complete.\n\n";
+  if (settings.stats) {
+    print_stats(job.stats, std::cout);
+    std::cout << "\n";
+  }
+  if (trace) {
+    if (!trace->write_json(settings.trace_file)) exit(-1);
+    std::cout << "Phase trace written to: " << settings.trace_file << "\n\n";
+  }
 
-    long long file_size_bytes = 36 + (long long)total_count * sizeof(float);
-    float file_size_mb = file_size_bytes / (1024.0f * 1024.0f);
-    std::cout << "File size: " << file_size_mb << " MB\n";
-    std::cout << "========================================\n";
-  #endif
+  std::string outname;
+  if (!write_field(job, settings, std::cout, outname)) {
+    exit(-1);
+  }
+
+  // Coarser pyramid levels: same origin, spacing dx*2^s
+  for (size_t s = 1; s < pyramid.size(); ++s) {
+    MeshJob level;
+    level.filename = job.filename;
+    level.mode_precise = job.mode_precise;
+    level.dx = dx * (float)(1 << s);
+    level.sizes = Vec3ui(pyramid[s].ni, pyramid[s].nj, pyramid[s].nk);
+    level.target_nx = pyramid[s].ni;
+    level.target_ny = pyramid[s].nj;
+    level.target_nz = pyramid[s].nk;
+    level.min_box = min_box;
+    level.max_box = min_box + Vec3f(level.sizes[0] * level.dx, level.sizes[1] * level.dx, level.sizes[2] * level.dx);
+    level.suffix = job.suffix + "_level" + std::to_string(s);
+    level.phi_grid.ni = pyramid[s].ni;
+    level.phi_grid.nj = pyramid[s].nj;
+    level.phi_grid.nk = pyramid[s].nk;
+    level.phi_grid.a.swap(pyramid[s].a);
+    std::cout << "\n";
+    if (!write_field(level, settings, std::cout, outname)) {
+      exit(-1);
+    }
+  }
 
   std::cout << "Processing complete.\n";
 
@@ -0,0 +1,127 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#include "backend_cost.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace sdfgen {
+
+namespace {
+
+// Device bytes per cell of the in-core GPU path (GpuMemoryMode::InCore)
+const double gpu_cell_bytes = 20.0;
+
+// Fields as (name, member) for load and save
+struct CostField {
+    const char* name;
+    double BackendCostModel::*value;
+};
+
+const CostField cost_fields[] = {
+    {"cpu_ns_per_cell", &BackendCostModel::cpu_ns_per_cell},
+    {"cpu_ns_per_distance", &BackendCostModel::cpu_ns_per_distance},
+    {"gpu_call_ms", &BackendCostModel::gpu_call_ms},
+    {"gpu_init_ms", &BackendCostModel::gpu_init_ms},
+    {"gpu_ns_per_cell_iteration", &BackendCostModel::gpu_ns_per_cell_iteration},
+    {"gpu_ns_per_distance", &BackendCostModel::gpu_ns_per_distance},
+    {"gpu_transfer_gb_s", &BackendCostModel::gpu_transfer_gb_s},
+    {"gpu_streamed_factor", &BackendCostModel::gpu_streamed_factor},
+};
+
+} // namespace
+
+double near_band_work(size_t num_triangles, int nx, int ny, int nz, int exact_band) {
+    const double box = 2.0 * std::max(exact_band, 1) + 2.0;
+    const double faces = 2.0 * ((double)nx * ny + (double)ny * nz + (double)nx * nz);
+    return (double)num_triangles * box * box * box + faces * box;
+}
+
+BackendEstimate estimate_backend_cost(const BackendCostModel& model, const GenerationOptions& options,
+                                      int nx, int ny, int nz, size_t num_triangles, const GpuCostInputs& gpu) {
+    BackendEstimate estimate;
+    const double cells = (double)nx * ny * nz;
+    const double distances = near_band_work(num_triangles, nx, ny, nz, options.exact_band);
+    const double threads = resolve_thread_count(options.num_threads);
+    estimate.cpu_ms = (cells * model.cpu_ns_per_cell + distances * model.cpu_ns_per_distance) / threads * 1e-6;
+    if (!gpu.available || options.distance_mode == DistanceMode::Exact) return estimate;
+
+    // Memory: in-core needs the whole grid, streamed a few planes per slab
+    double budget = (double)gpu.free_bytes;
+    if (options.gpu_memory_limit > 0) budget = std::min(budget, (double)options.gpu_memory_limit);
+    budget *= 0.9;
+    const double mesh_bytes = (double)num_triangles * (options.triangle_table ? 140.0 : 12.0) +
+                              (double)num_triangles * 6.0;
+    const double plane_bytes = (double)nx * ny * gpu_cell_bytes;
+    if (mesh_bytes + 4.0 * plane_bytes > budget) return estimate;
+    const double devices = std::max<double>(1.0, (double)options.gpu_devices.size());
+    const bool fits = mesh_bytes + cells / devices * gpu_cell_bytes <= budget;
+    if (options.gpu_memory == GpuMemoryMode::InCore && !fits) return estimate;
+    estimate.gpu_streamed = options.gpu_memory == GpuMemoryMode::Streamed || !fits;
+
+    const double iterations = 2.0 * std::max(nx, std::max(ny, nz));
+    double work_ms = (cells * iterations * model.gpu_ns_per_cell_iteration +
+                      distances * model.gpu_ns_per_distance) * 1e-6 / devices;
+    if (estimate.gpu_streamed) work_ms *= model.gpu_streamed_factor;
+    const double transfer_ms = (cells * sizeof(float) + mesh_bytes) / (model.gpu_transfer_gb_s * 1e6);
+    estimate.gpu_ms = model.gpu_call_ms + (gpu.initialized ? 0.0 : model.gpu_init_ms) + work_ms + transfer_ms;
+
+    if (estimate.gpu_ms < estimate.cpu_ms) estimate.backend = HardwareBackend::GPU;
+    return estimate;
+}
+
+bool load_cost_model(const std::string& filename, BackendCostModel& model) {
+    std::ifstream infile(filename.c_str());
+    if (!infile) {
+        std::cerr << "ERROR: Failed to open cost model: " << filename << std::endl;
+        return false;
+    }
+    BackendCostModel loaded = model;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(infile, line)) {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name)) continue;
+        double value = 0.0;
+        const CostField* field = nullptr;
+        for (const CostField& candidate : cost_fields) {
+            if (name == candidate.name) field = &candidate;
+        }
+        if (!field || !(fields >> value) || value < 0.0) {
+            std::cerr << "ERROR: Invalid cost model entry on line " << line_number << " of " << filename
+                      << ": " << line << std::endl;
+            return false;
+        }
+        loaded.*(field->value) = value;
+    }
+    model = loaded;
+    return true;
+}
+
+bool save_cost_model(const std::string& filename, const BackendCostModel& model) {
+    std::ofstream outfile(filename.c_str());
+    if (!outfile) {
+        std::cerr << "ERROR: Failed to open file for writing: " << filename << std::endl;
+        return false;
+    }
+    outfile << "# SDFGen backend cost model (benchmark_performance --calibrate)\n";
+    outfile.precision(6);
+    for (const CostField& field : cost_fields) {
+        outfile << field.name << " " << model.*(field.value) << "\n";
+    }
+    outfile.close();
+    if (outfile.fail()) {
+        std::cerr << "ERROR: Failed to write cost model: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace sdfgen
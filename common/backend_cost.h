@@ -0,0 +1,86 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "sdfgen_options.h"
+#include <cstddef>
+#include <string>
+
+namespace sdfgen {
+
+/**
+ * @brief Throughput figures HardwareBackend::Auto uses to predict CPU and GPU run times
+ *
+ * The defaults describe a recent desktop CPU core and a mid-range GPU. benchmark_performance
+ * --calibrate measures them on the machine at hand and writes them with save_cost_model();
+ * load them with load_cost_model() and set_backend_cost_model(), through the
+ * SDFGEN_COST_MODEL environment variable, or with SDFGen --cost-model.
+ */
+struct BackendCostModel {
+    double cpu_ns_per_cell = 2500.0;        ///< Setup, sweeps and signs per grid cell, one thread
+    double cpu_ns_per_distance = 10.0;      ///< One near-band point-triangle distance, one thread
+    double gpu_call_ms = 2.0;               ///< Per-call allocation, launches and synchronization
+    double gpu_init_ms = 150.0;             ///< CUDA context creation, paid by the first GPU call of a process
+    double gpu_ns_per_cell_iteration = 0.05; ///< One Jacobi iteration over one cell
+    double gpu_ns_per_distance = 0.1;       ///< One near-band distance
+    double gpu_transfer_gb_s = 12.0;        ///< Host-device copy bandwidth
+    double gpu_streamed_factor = 3.0;       ///< Slowdown of the streamed (out-of-core) mode
+};
+
+/**
+ * @brief Device facts the estimate needs, gathered by the unified API
+ */
+struct GpuCostInputs {
+    bool available = false;     ///< A CUDA device can run the call
+    bool initialized = false;   ///< A GPU call already ran in this process
+    size_t free_bytes = 0;      ///< Device memory free for the call (smallest device when split)
+};
+
+/**
+ * @brief Predicted run times of one dense generation and the backend Auto picks from them
+ */
+struct BackendEstimate {
+    HardwareBackend backend = HardwareBackend::CPU; ///< Faster backend that can run the call
+    double cpu_ms = 0.0;        ///< Predicted CPU time
+    double gpu_ms = 0.0;        ///< Predicted GPU time, 0 when no GPU can run the call
+    bool gpu_streamed = false;  ///< The GPU estimate is for the streamed mode (grid does not fit in-core)
+};
+
+/**
+ * @brief Near-band distance evaluations expected for a mesh on an nx x ny x nz grid
+ *
+ * A box of (2 * exact_band + 2)^3 cells per triangle plus a band of that width over a
+ * surface the size of the grid's bounding faces.
+ */
+double near_band_work(size_t num_triangles, int nx, int ny, int nz, int exact_band);
+
+/**
+ * @brief Predict CPU and GPU times of a dense generation and choose the faster backend
+ *
+ * The CPU time divides per-cell and per-distance costs over the resolved thread count.
+ * The GPU time adds the per-call overhead (and context creation before the first GPU call),
+ * Jacobi iterations up to twice the longest grid side, the near band and the field copy;
+ * grids that do not fit the free device memory (or options.gpu_memory_limit) in-core are
+ * costed as streamed, and grids whose planes do not fit even then are left to the CPU.
+ * DistanceMode::Exact always picks the CPU.
+ */
+BackendEstimate estimate_backend_cost(const BackendCostModel& model, const GenerationOptions& options,
+                                      int nx, int ny, int nz, size_t num_triangles, const GpuCostInputs& gpu);
+
+/**
+ * @brief Read a cost model written by save_cost_model()
+ *
+ * One "name value" pair per line, '#' starts a comment; fields not listed keep their values.
+ * @return true on success, false (with an error printed) on I/O errors or unknown fields
+ */
+bool load_cost_model(const std::string& filename, BackendCostModel& model);
+
+/**
+ * @brief Write a cost model as "name value" lines
+ * @return true on success, false on error
+ */
+bool save_cost_model(const std::string& filename, const BackendCostModel& model);
+
+} // namespace sdfgen
@@ -0,0 +1,113 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "array3.h"
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 3D array stored as 8^3 bricks, Morton-ordered inside each brick
+ *
+ * Same interface as Array3 for element access (ni, nj, nk, operator()(i,j,k)), so code
+ * templated on the grid type runs on either layout. Bricks are stored i-fastest by brick
+ * coordinate, and node (a,b,c) of a brick sits at the interleaved bits of a, b and c. All
+ * 26 neighbours of a node are then within the same brick or an adjacent one, so the +/-j
+ * and +/-k accesses of the sweeps hit pages already in the TLB instead of striding ni*nj
+ * elements. Dimensions are padded up to whole bricks; the padding is never read.
+ *
+ * Conversion from and to the linear Array3 is by brick slab (import_slab()/export_slab()),
+ * so callers can spread it over threads.
+ *
+ * @tparam T Element type
+ */
+template<class T>
+struct BrickedArray3
+{
+   static const int brick_size=8;                          /**< Nodes per brick edge */
+   static const int brick_cells=brick_size*brick_size*brick_size;
+
+   int ni, nj, nk; /**< Grid dimensions (i, j, k) */
+
+   BrickedArray3(void) : ni(0), nj(0), nk(0), bi(0), bj(0), bk(0) {}
+
+   /** @brief Resize to the given dimensions, every node set to value */
+   void assign(int ni_, int nj_, int nk_, const T& value)
+   {
+      assert(ni_>=0 && nj_>=0 && nk_>=0);
+      ni=ni_; nj=nj_; nk=nk_;
+      bi=(ni+brick_size-1)/brick_size; bj=(nj+brick_size-1)/brick_size; bk=(nk+brick_size-1)/brick_size;
+      data.assign((size_t)bi*bj*bk*brick_cells, value);
+   }
+
+   /** @brief Free the storage */
+   void clear(void)
+   {
+      ni=nj=nk=bi=bj=bk=0;
+      std::vector<T>().swap(data);
+   }
+
+   const T& operator()(int i, int j, int k) const
+   {
+      assert(i>=0 && i<ni && j>=0 && j<nj && k>=0 && k<nk);
+      return data[index(i,j,k)];
+   }
+
+   T& operator()(int i, int j, int k)
+   {
+      assert(i>=0 && i<ni && j>=0 && j<nj && k>=0 && k<nk);
+      return data[index(i,j,k)];
+   }
+
+   /** @brief Number of brick slabs along k (the unit of import_slab()/export_slab()) */
+   int slabs(void) const { return bk; }
+
+   /** @brief Copy brick slab s (nodes k in [8s, 8s+8)) in from a linear array of the same size */
+   template<class ArrayT>
+   void import_slab(const Array3<T,ArrayT>& src, int s)
+   {
+      assert(src.ni==ni && src.nj==nj && src.nk==nk);
+      for(int k=s*brick_size; k<nk && k<(s+1)*brick_size; ++k)
+         for(int j=0; j<nj; ++j)
+            for(int i=0; i<ni; ++i) data[index(i,j,k)]=src(i,j,k);
+   }
+
+   /** @brief Copy brick slab s out to a linear array of the same size */
+   template<class ArrayT>
+   void export_slab(Array3<T,ArrayT>& dst, int s) const
+   {
+      assert(dst.ni==ni && dst.nj==nj && dst.nk==nk);
+      for(int k=s*brick_size; k<nk && k<(s+1)*brick_size; ++k)
+         for(int j=0; j<nj; ++j)
+            for(int i=0; i<ni; ++i) dst(i,j,k)=data[index(i,j,k)];
+   }
+
+   /** @brief Bytes held, including the padding to whole bricks */
+   size_t memory_bytes(void) const { return data.size()*sizeof(T); }
+
+   /** @brief Bytes a grid of the given dimensions would hold */
+   static size_t bytes_for(int ni_, int nj_, int nk_)
+   {
+      return (size_t)((ni_+brick_size-1)/brick_size)*((nj_+brick_size-1)/brick_size)*
+             ((nk_+brick_size-1)/brick_size)*brick_cells*sizeof(T);
+   }
+
+private:
+   int bi, bj, bk;      /**< Bricks along each axis */
+   std::vector<T> data; /**< Bricks, brick (i/8, j/8, k/8) i-fastest, Morton order inside */
+
+   // bits 0..2 of v moved to bits 0, 3 and 6
+   static size_t spread(int v) { return (size_t)((v&1) | ((v&2)<<2) | ((v&4)<<4)); }
+
+   size_t index(int i, int j, int k) const
+   {
+      size_t b=(size_t)(i>>3)+(size_t)bi*((size_t)(j>>3)+(size_t)bj*(size_t)(k>>3));
+      return b*brick_cells+(spread(i&7) | (spread(j&7)<<1) | (spread(k&7)<<2));
+   }
+};
+
+typedef BrickedArray3<float> BrickedArray3f;
+typedef BrickedArray3<int> BrickedArray3i;
@@ -0,0 +1,139 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "array3.h"
+#include "vec.h"
+
+namespace sdfgen {
+
+/**
+ * @brief 16-bit value encoding of a CompactLevelSet
+ */
+enum class CompactFormat {
+   Half,  /**< IEEE fp16: relative precision 2^-11, finest near the surface */
+   Int16  /**< Normalized int16: phi/band*32767 rounded, uniform step band/32767 */
+};
+
+/**
+ * @brief float to IEEE binary16, round to nearest even (overflow gives infinity)
+ */
+inline uint16_t float_to_half(float value)
+{
+   uint32_t f;
+   std::memcpy(&f, &value, sizeof(f));
+   uint32_t sign=(f>>16)&0x8000u, mag=f&0x7fffffffu;
+   if(mag>=0x7f800000u) return (uint16_t)(sign|0x7c00u|(mag>0x7f800000u ? 0x200u : 0u)); // inf, nan
+   if(mag>=0x477ff000u) return (uint16_t)(sign|0x7c00u);                                 // rounds past 65504
+   if(mag<0x38800000u){
+      // subnormal half: value = h * 2^-24
+      if(mag<0x33000000u) return (uint16_t)sign;
+      uint32_t e=mag>>23, m=(mag&0x7fffffu)|0x800000u;
+      uint32_t shift=126-e, h=m>>shift, rem=m&((1u<<shift)-1), halfway=1u<<(shift-1);
+      if(rem>halfway || (rem==halfway && (h&1))) ++h;
+      return (uint16_t)(sign|h);
+   }
+   uint32_t h=(mag>>13)-(112u<<10), rem=mag&0x1fffu;
+   if(rem>0x1000u || (rem==0x1000u && (h&1))) ++h; // a carry moves into the exponent correctly
+   return (uint16_t)(sign|h);
+}
+
+/**
+ * @brief IEEE binary16 to float (exact)
+ */
+inline float half_to_float(uint16_t h)
+{
+   uint32_t sign=(uint32_t)(h&0x8000u)<<16, e=(h>>10)&0x1fu, m=h&0x3ffu;
+   if(e==0){
+      float v=std::ldexp((float)m, -24);
+      return sign ? -v : v;
+   }
+   uint32_t f=sign|(e==31 ? 0x7f800000u|(m<<13) : ((e+112)<<23)|(m<<13));
+   float value;
+   std::memcpy(&value, &f, sizeof(value));
+   return value;
+}
+
+/**
+ * @brief Dense signed distance field stored in 16 bits per node over a clamped band
+ *
+ * Values are clamped to [-band, band] and kept as fp16 or normalized int16 (CompactFormat),
+ * half the size of a dense Array3f. Both encodings are monotone, so for non-negative values
+ * the raw words order like the distances they encode: generation keeps the minimum raw word
+ * per node and flips signs last. Raw words are stored i-fastest, like Array3.
+ */
+class CompactLevelSet {
+public:
+   int ni, nj, nk;        /**< Grid dimensions in nodes */
+   Vec3f origin;          /**< World position of node (0,0,0) */
+   float dx;              /**< Node spacing */
+   float band;            /**< Clamp on |phi| */
+   CompactFormat format;  /**< Encoding of the raw words */
+
+   CompactLevelSet() : ni(0), nj(0), nk(0), dx(0), band(0), format(CompactFormat::Int16) {}
+
+   /**
+    * @brief Set the geometry and fill every node with +band
+    */
+   void reset(int ni_, int nj_, int nk_, const Vec3f &origin_, float dx_, float band_, CompactFormat format_)
+   {
+      ni=ni_; nj=nj_; nk=nk_; origin=origin_; dx=dx_; band=band_; format=format_;
+      values_.assign((size_t)ni*nj*nk, encode(band));
+   }
+
+   /** @brief Raw word of a value (clamped to the band) */
+   uint16_t encode(float phi) const
+   {
+      phi=phi<-band ? -band : (phi>band ? band : phi);
+      if(format==CompactFormat::Half) return float_to_half(phi);
+      return (uint16_t)(int16_t)std::lrint(phi/band*32767.0f);
+   }
+
+   /** @brief Value of a raw word */
+   float decode(uint16_t word) const
+   {
+      if(format==CompactFormat::Half) return half_to_float(word);
+      return (float)(int16_t)word*(band/32767.0f);
+   }
+
+   /** @brief Raw word with the sign of the value flipped */
+   uint16_t negate(uint16_t word) const
+   {
+      return format==CompactFormat::Half ? (uint16_t)(word^0x8000u) : (uint16_t)(-(int16_t)word);
+   }
+
+   /** @brief Signed distance at node (i,j,k) */
+   float operator() (int i, int j, int k) const { return decode(values_[index(i,j,k)]); }
+
+   /** @brief Raw word of node (i,j,k) */
+   uint16_t &raw(int i, int j, int k) { return values_[index(i,j,k)]; }
+   uint16_t raw(int i, int j, int k) const { return values_[index(i,j,k)]; }
+
+   /** @brief All raw words, i fastest */
+   const std::vector<uint16_t> &words() const { return values_; }
+   std::vector<uint16_t> &words() { return values_; }
+
+   /** @brief Expand to a dense float grid */
+   void to_dense(Array3f &phi) const
+   {
+      phi.resize(ni, nj, nk);
+      for(size_t n=0; n<values_.size(); ++n) phi.a[n]=decode(values_[n]);
+   }
+
+   /** @brief Bytes held by the raw words */
+   size_t memory_bytes() const { return values_.size()*sizeof(uint16_t); }
+
+private:
+   size_t index(int i, int j, int k) const { return (size_t)i+(size_t)ni*((size_t)j+(size_t)nj*k); }
+
+   std::vector<uint16_t> values_;
+};
+
+} // namespace sdfgen
@@ -0,0 +1,402 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#include "compressed_sdf.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace sdfgen {
+
+namespace {
+
+const int format_version = 1;
+const size_t header_bytes = 56;
+
+// Chunks compressed or decoded per batch by read/write_compressed_sdf()
+const size_t chunks_per_batch = 512;
+
+// Chunk encodings (first byte)
+const unsigned char chunk_constant = 0; // One word: every value equal
+const unsigned char chunk_coded = 1;    // Run-length coded residual byte planes
+
+int word_bytes(int quantize_bits) { return quantize_bits == 0 ? 4 : quantize_bits / 8; }
+
+// Value to stored word: float bits, or a level in [0, 2^bits-1] over [-band, band]
+uint32_t to_word(float v, int quantize_bits, float band) {
+    if (band > 0.0f) v = std::max(-band, std::min(band, v));
+    if (quantize_bits == 0) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(float));
+        return bits;
+    }
+    uint32_t top = (1u << quantize_bits) - 1;
+    float q = std::floor((v + band) * ((float)top / (2.0f * band)) + 0.5f);
+    uint32_t level = (uint32_t)std::max(0.0f, std::min((float)top, q));
+    // Levels top/2 and below decode negative, the rest positive: keep the sign of v
+    if (v < 0.0f) return std::min(level, top / 2);
+    return std::max(level, top / 2 + 1);
+}
+
+float from_word(uint32_t word, int quantize_bits, float band) {
+    if (quantize_bits == 0) {
+        float v;
+        std::memcpy(&v, &word, sizeof(float));
+        return v;
+    }
+    float levels = (float)((1u << quantize_bits) - 1);
+    return (float)word * (2.0f * band / levels) - band;
+}
+
+// Residual of a word given its predecessor: XOR for float bits, zigzagged difference for levels
+uint32_t residual(uint32_t word, uint32_t prev, int quantize_bits) {
+    if (quantize_bits == 0) return word ^ prev;
+    uint32_t mask = (1u << quantize_bits) - 1;
+    uint32_t d = (word - prev) & mask;
+    int32_t s = (d & (1u << (quantize_bits - 1))) ? (int32_t)d - (int32_t)(mask + 1) : (int32_t)d;
+    return (((uint32_t)s << 1) ^ (uint32_t)(s >> 31)) & mask;
+}
+
+uint32_t unresidual(uint32_t r, uint32_t prev, int quantize_bits) {
+    if (quantize_bits == 0) return r ^ prev;
+    uint32_t mask = (1u << quantize_bits) - 1;
+    int32_t s = (int32_t)(r >> 1) ^ -(int32_t)(r & 1);
+    return (prev + (uint32_t)s) & mask;
+}
+
+// PackBits: control c < 128 copies c+1 literal bytes, c >= 128 repeats the next byte c-125 times
+void rle_encode(const unsigned char* in, size_t n, std::vector<unsigned char>& out) {
+    size_t i = 0;
+    while (i < n) {
+        size_t run = 1;
+        while (i + run < n && run < 130 && in[i + run] == in[i]) ++run;
+        if (run >= 3) {
+            out.push_back((unsigned char)(run + 125));
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+        // Literals up to the next run of 3 or more
+        size_t start = i;
+        while (i < n && i - start < 128) {
+            if (i + 2 < n && in[i] == in[i + 1] && in[i] == in[i + 2]) break;
+            ++i;
+        }
+        out.push_back((unsigned char)(i - start - 1));
+        out.insert(out.end(), in + start, in + i);
+    }
+}
+
+bool rle_decode(const unsigned char* in, size_t size, unsigned char* out, size_t n) {
+    size_t i = 0, o = 0;
+    while (o < n) {
+        if (i >= size) return false;
+        unsigned char c = in[i++];
+        size_t count;
+        if (c < 128) {
+            count = (size_t)c + 1;
+            if (i + count > size || o + count > n) return false;
+            std::memcpy(out + o, in + i, count);
+            i += count;
+        } else {
+            count = (size_t)c - 125;
+            if (i >= size || o + count > n) return false;
+            std::memset(out + o, in[i++], count);
+        }
+        o += count;
+    }
+    return i == size;
+}
+
+} // namespace
+
+void encode_sdf_chunk(const float* values, int quantize_bits, float band, std::vector<unsigned char>& out) {
+    const int n = CompressedSDF::chunk_cells;
+    const int width = word_bytes(quantize_bits);
+    out.clear();
+
+    std::vector<uint32_t> words(n);
+    bool constant = true;
+    for (int c = 0; c < n; ++c) {
+        words[c] = to_word(values[c], quantize_bits, band);
+        constant &= words[c] == words[0];
+    }
+    if (constant) {
+        out.push_back(chunk_constant);
+        for (int b = 0; b < width; ++b) out.push_back((unsigned char)(words[0] >> (8 * b)));
+        return;
+    }
+
+    // Residual bytes grouped by significance: plane b holds byte b of every residual
+    std::vector<unsigned char> planes((size_t)n * width);
+    uint32_t prev = 0;
+    for (int c = 0; c < n; ++c) {
+        uint32_t r = residual(words[c], prev, quantize_bits);
+        prev = words[c];
+        for (int b = 0; b < width; ++b) planes[(size_t)b * n + c] = (unsigned char)(r >> (8 * b));
+    }
+    out.push_back(chunk_coded);
+    rle_encode(planes.data(), planes.size(), out);
+}
+
+bool decode_sdf_chunk(const unsigned char* data, size_t size, int quantize_bits, float band, float* values) {
+    const int n = CompressedSDF::chunk_cells;
+    const int width = word_bytes(quantize_bits);
+    if (size < 1) return false;
+
+    if (data[0] == chunk_constant) {
+        if (size != 1 + (size_t)width) return false;
+        uint32_t word = 0;
+        for (int b = 0; b < width; ++b) word |= (uint32_t)data[1 + b] << (8 * b);
+        std::fill(values, values + n, from_word(word, quantize_bits, band));
+        return true;
+    }
+    if (data[0] != chunk_coded) return false;
+
+    std::vector<unsigned char> planes((size_t)n * width);
+    if (!rle_decode(data + 1, size - 1, planes.data(), planes.size())) return false;
+    uint32_t prev = 0;
+    for (int c = 0; c < n; ++c) {
+        uint32_t r = 0;
+        for (int b = 0; b < width; ++b) r |= (uint32_t)planes[(size_t)b * n + c] << (8 * b);
+        prev = unresidual(r, prev, quantize_bits);
+        values[c] = from_word(prev, quantize_bits, band);
+    }
+    return true;
+}
+
+bool CompressedSDF::open(const std::string& filename) {
+    file_.close();
+    file_.clear();
+    offsets_.clear();
+    cached_chunk_ = -1;
+
+    file_.open(filename.c_str(), std::ios::binary);
+    if (!file_) {
+        std::cerr << "ERROR: Failed to open file for reading: " << filename << std::endl;
+        return false;
+    }
+
+    // Header
+    char magic[4];
+    int version = 0;
+    int dims[4];
+    float geometry[5];
+    int quantize_bits = 0;
+    long long chunk_count = 0;
+    file_.read(magic, 4);
+    file_.read(reinterpret_cast<char*>(&version), sizeof(int));
+    file_.read(reinterpret_cast<char*>(dims), sizeof(dims));
+    file_.read(reinterpret_cast<char*>(geometry), sizeof(geometry));
+    file_.read(reinterpret_cast<char*>(&quantize_bits), sizeof(int));
+    file_.read(reinterpret_cast<char*>(&chunk_count), sizeof(long long));
+    if (file_.fail() || std::string(magic, 4) != "SDFC") {
+        std::cerr << "ERROR: Not a compressed SDF file: " << filename << std::endl;
+        file_.close();
+        return false;
+    }
+    if (version != format_version || dims[3] != chunk_size ||
+        (quantize_bits != 0 && quantize_bits != 8 && quantize_bits != 16)) {
+        std::cerr << "ERROR: Unsupported compressed SDF version " << version << " (chunk size "
+                  << dims[3] << ", " << quantize_bits << " bits): " << filename << std::endl;
+        file_.close();
+        return false;
+    }
+    ni_ = dims[0];
+    nj_ = dims[1];
+    nk_ = dims[2];
+    if (ni_ <= 0 || nj_ <= 0 || nk_ <= 0 ||
+        chunk_count != (long long)chunks_i() * chunks_j() * chunks_k() ||
+        (quantize_bits != 0 && !(geometry[4] > 0.0f))) {
+        std::cerr << "ERROR: Invalid dimensions in compressed SDF file: "
+                  << ni_ << "x" << nj_ << "x" << nk_ << std::endl;
+        file_.close();
+        return false;
+    }
+    origin_ = Vec3f(geometry[0], geometry[1], geometry[2]);
+    dx_ = geometry[3];
+    band_ = geometry[4];
+    quantize_bits_ = quantize_bits;
+
+    // Chunk index: offsets must increase and stay inside the file
+    offsets_.resize((size_t)chunk_count + 1);
+    file_.read(reinterpret_cast<char*>(offsets_.data()), offsets_.size() * sizeof(uint64_t));
+    file_.seekg(0, std::ios::end);
+    uint64_t file_size = (uint64_t)file_.tellg();
+    bool valid = !file_.fail() && offsets_[0] == header_bytes + offsets_.size() * sizeof(uint64_t) &&
+                 offsets_.back() == file_size;
+    for (size_t n = 0; valid && n + 1 < offsets_.size(); ++n) valid = offsets_[n] < offsets_[n + 1];
+    if (!valid) {
+        std::cerr << "ERROR: Invalid chunk index in compressed SDF file: " << filename << std::endl;
+        file_.close();
+        offsets_.clear();
+        return false;
+    }
+    return true;
+}
+
+bool CompressedSDF::read_chunk(int ci, int cj, int ck, float* values) {
+    size_t chunk = (size_t)ci + (size_t)chunks_i() * ((size_t)cj + (size_t)chunks_j() * ck);
+    std::vector<unsigned char> data(chunk_bytes(chunk));
+    file_.clear();
+    file_.seekg((std::streamoff)offsets_[chunk]);
+    file_.read(reinterpret_cast<char*>(data.data()), data.size());
+    return !file_.fail() && decode_sdf_chunk(data.data(), data.size(), quantize_bits_, band_, values);
+}
+
+float CompressedSDF::value(int i, int j, int k) {
+    int ci = i / chunk_size, cj = j / chunk_size, ck = k / chunk_size;
+    long long chunk = ci + (long long)chunks_i() * (cj + (long long)chunks_j() * ck);
+    if (chunk != cached_chunk_) {
+        cache_.resize(chunk_cells);
+        cached_chunk_ = read_chunk(ci, cj, ck, cache_.data()) ? chunk : -1;
+        if (cached_chunk_ < 0) std::fill(cache_.begin(), cache_.end(), 0.0f);
+    }
+    return cache_[(i % chunk_size) + chunk_size * ((j % chunk_size) + chunk_size * (k % chunk_size))];
+}
+
+} // namespace sdfgen
+
+bool write_compressed_sdf(const std::string& filename,
+                          const Array3f& phi_grid,
+                          const Vec3f& origin,
+                          float dx,
+                          const sdfgen::SdfCompression& options) {
+    using sdfgen::CompressedSDF;
+    const int quantize_bits = options.quantize_bits;
+    if (quantize_bits != 0 && quantize_bits != 8 && quantize_bits != 16) {
+        std::cerr << "ERROR: Quantization must be 0, 8 or 16 bits (got " << quantize_bits << ")" << std::endl;
+        return false;
+    }
+
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    if (!outfile) {
+        std::cerr << "ERROR: Failed to open file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+    unsigned int threads = sdfgen::resolve_thread_count(options.num_threads);
+    const int ni = phi_grid.ni, nj = phi_grid.nj, nk = phi_grid.nk;
+    const int size = CompressedSDF::chunk_size;
+    const int chunks_i = (ni + size - 1) / size, chunks_j = (nj + size - 1) / size, chunks_k = (nk + size - 1) / size;
+    const size_t chunk_count = (size_t)chunks_i * chunks_j * chunks_k;
+
+    // Quantization needs a range; without a band, use the largest magnitude in the grid
+    float band = options.band > 0.0f ? options.band : 0.0f;
+    if (quantize_bits != 0 && band == 0.0f) {
+        for (size_t n = 0; n < phi_grid.a.size(); ++n) band = std::max(band, std::fabs(phi_grid.a[n]));
+        if (!(band > 0.0f)) band = 1.0f;
+    }
+
+    // Header
+    int version = sdfgen::format_version;
+    int dims[4] = {ni, nj, nk, size};
+    float geometry[5] = {origin[0], origin[1], origin[2], dx, band};
+    long long count = (long long)chunk_count;
+    outfile.write("SDFC", 4);
+    outfile.write(reinterpret_cast<const char*>(&version), sizeof(int));
+    outfile.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    outfile.write(reinterpret_cast<const char*>(geometry), sizeof(geometry));
+    outfile.write(reinterpret_cast<const char*>(&quantize_bits), sizeof(int));
+    outfile.write(reinterpret_cast<const char*>(&count), sizeof(long long));
+
+    // Index placeholder, filled in once the chunk sizes are known
+    std::vector<uint64_t> offsets(chunk_count + 1, 0);
+    outfile.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    offsets[0] = sdfgen::header_bytes + offsets.size() * sizeof(uint64_t);
+
+    // Chunks, compressed in parallel one batch at a time
+    std::vector<std::vector<unsigned char>> encoded(std::min(chunk_count, sdfgen::chunks_per_batch));
+    for (size_t first = 0; first < chunk_count; first += encoded.size()) {
+        size_t batch = std::min(encoded.size(), chunk_count - first);
+        pool.parallel_for((int)batch, threads, [&](int b) {
+            size_t chunk = first + b;
+            int ci = (int)(chunk % chunks_i), cj = (int)(chunk / chunks_i % chunks_j), ck = (int)(chunk / chunks_i / chunks_j);
+            std::vector<float> values(CompressedSDF::chunk_cells);
+            for (int c = 0; c < size; ++c) {
+                int k = std::min(nk - 1, ck * size + c);
+                for (int bj = 0; bj < size; ++bj) {
+                    int j = std::min(nj - 1, cj * size + bj);
+                    for (int a = 0; a < size; ++a) {
+                        int i = std::min(ni - 1, ci * size + a);
+                        values[a + size * (bj + size * c)] = phi_grid(i, j, k);
+                    }
+                }
+            }
+            sdfgen::encode_sdf_chunk(values.data(), quantize_bits, band, encoded[b]);
+        });
+        for (size_t b = 0; b < batch; ++b) {
+            outfile.write(reinterpret_cast<const char*>(encoded[b].data()), encoded[b].size());
+            offsets[first + b + 1] = offsets[first + b] + encoded[b].size();
+        }
+    }
+
+    outfile.seekp((std::streamoff)sdfgen::header_bytes);
+    outfile.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    if (outfile.fail()) {
+        std::cerr << "ERROR: Failed to write compressed SDF data to file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool read_compressed_sdf(const std::string& filename,
+                         Array3f& phi_grid,
+                         Vec3f& origin,
+                         float& dx,
+                         int num_threads) {
+    using sdfgen::CompressedSDF;
+    CompressedSDF reader;
+    if (!reader.open(filename)) return false;
+
+    std::ifstream infile(filename.c_str(), std::ios::binary);
+    sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+    unsigned int threads = sdfgen::resolve_thread_count(num_threads);
+    const int ni = reader.ni(), nj = reader.nj(), nk = reader.nk();
+    const int size = CompressedSDF::chunk_size;
+    const int chunks_i = reader.chunks_i(), chunks_j = reader.chunks_j();
+    const size_t chunk_count = reader.chunk_count();
+    phi_grid.resize(ni, nj, nk);
+
+    // Read a batch of consecutive chunks in one call, then decode them in parallel
+    std::vector<unsigned char> data;
+    for (size_t first = 0; first < chunk_count; first += sdfgen::chunks_per_batch) {
+        size_t last = std::min(chunk_count, first + sdfgen::chunks_per_batch);
+        uint64_t begin = reader.chunk_offset(first);
+        data.resize((size_t)(reader.chunk_offset(last) - begin));
+        infile.seekg((std::streamoff)begin);
+        infile.read(reinterpret_cast<char*>(data.data()), data.size());
+        if (infile.fail()) {
+            std::cerr << "ERROR: Failed to read compressed SDF chunks: " << filename << std::endl;
+            return false;
+        }
+        std::atomic<bool> valid(true);
+        pool.parallel_for((int)(last - first), threads, [&](int b) {
+            size_t chunk = first + b;
+            std::vector<float> values(CompressedSDF::chunk_cells);
+            if (!sdfgen::decode_sdf_chunk(data.data() + (reader.chunk_offset(chunk) - begin), reader.chunk_bytes(chunk),
+                                          reader.quantize_bits(), reader.band(), values.data())) {
+                valid = false;
+                return;
+            }
+            int ci = (int)(chunk % chunks_i), cj = (int)(chunk / chunks_i % chunks_j), ck = (int)(chunk / chunks_i / chunks_j);
+            for (int c = 0; c < size && ck * size + c < nk; ++c)
+                for (int bj = 0; bj < size && cj * size + bj < nj; ++bj)
+                    for (int a = 0; a < size && ci * size + a < ni; ++a)
+                        phi_grid(ci * size + a, cj * size + bj, ck * size + c) = values[a + size * (bj + size * c)];
+        });
+        if (!valid) {
+            std::cerr << "ERROR: Corrupt chunk in compressed SDF file: " << filename << std::endl;
+            return false;
+        }
+    }
+
+    origin = reader.origin();
+    dx = reader.dx();
+    return true;
+}
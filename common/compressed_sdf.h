@@ -0,0 +1,161 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "array3.h"
+#include "vec.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace sdfgen {
+
+/**
+ * @brief Settings for write_compressed_sdf()
+ *
+ * With quantize_bits 0 the values are stored as float32 and the codec is lossless (after
+ * the optional clamp to the band). With 8 or 16 bits each value is rounded to one of
+ * 2^bits evenly spaced levels over [-band, band]; the step is 2*band/(2^bits-1) and signs
+ * are preserved, so the inside/outside classification survives.
+ */
+struct SdfCompression {
+    int quantize_bits = 0;  ///< 0 = float32, 8 or 16 = fixed point over [-band, band]
+    float band = 0.0f;      ///< Clamp |phi| to this (0 = no clamp; when quantizing, max |phi| is used)
+    int num_threads = 0;    ///< Threads compressing chunks, 0 = auto-detect
+};
+
+/**
+ * @brief Random access to a chunked compressed SDF file (.csdf)
+ *
+ * open() reads only the header and the chunk index; read_chunk() seeks to one chunk and
+ * decodes it, so a query touches about one compressed chunk. value() keeps the last
+ * decoded chunk. Not safe for concurrent use; open one reader per thread.
+ */
+class CompressedSDF {
+public:
+    static const int chunk_size = 32;                                  ///< Chunk edge in nodes
+    static const int chunk_cells = chunk_size * chunk_size * chunk_size; ///< Values per chunk
+
+    /**
+     * @brief Open a file written by write_compressed_sdf()
+     * @return true on success, false on error (bad magic, version, index or truncated file)
+     */
+    bool open(const std::string& filename);
+
+    /** @brief True while a file is open */
+    bool is_open() const { return file_.is_open(); }
+
+    int ni() const { return ni_; }
+    int nj() const { return nj_; }
+    int nk() const { return nk_; }
+    const Vec3f& origin() const { return origin_; }
+    float dx() const { return dx_; }
+    float band() const { return band_; }                 ///< Clamp applied when writing (0 = none)
+    int quantize_bits() const { return quantize_bits_; } ///< 0 for float32 chunks
+    int chunks_i() const { return (ni_ + chunk_size - 1) / chunk_size; }
+    int chunks_j() const { return (nj_ + chunk_size - 1) / chunk_size; }
+    int chunks_k() const { return (nk_ + chunk_size - 1) / chunk_size; }
+    size_t chunk_count() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+    /** @brief File offset of a chunk's data (chunk_count() gives the end of the last chunk) */
+    uint64_t chunk_offset(size_t chunk) const { return offsets_[chunk]; }
+
+    /** @brief Compressed size of a chunk in bytes */
+    size_t chunk_bytes(size_t chunk) const { return (size_t)(offsets_[chunk + 1] - offsets_[chunk]); }
+
+    /**
+     * @brief Decode one chunk
+     *
+     * @param ci Chunk index in X (0 <= ci < chunks_i())
+     * @param cj Chunk index in Y
+     * @param ck Chunk index in Z
+     * @param values Receives chunk_cells values, i fastest: node (ci*32+a, cj*32+b, ck*32+c)
+     *        at a + 32*(b + 32*c); nodes past the grid edge repeat the last node
+     * @return false on a read or decode error
+     */
+    bool read_chunk(int ci, int cj, int ck, float* values);
+
+    /** @brief Value at node (i, j, k), decoding its chunk if it is not the cached one */
+    float value(int i, int j, int k);
+
+private:
+    std::ifstream file_;
+    std::vector<uint64_t> offsets_;      // Chunk n occupies [offsets_[n], offsets_[n+1])
+    int ni_ = 0, nj_ = 0, nk_ = 0;
+    Vec3f origin_;
+    float dx_ = 0.0f;
+    float band_ = 0.0f;
+    int quantize_bits_ = 0;
+    long long cached_chunk_ = -1;
+    std::vector<float> cache_;
+};
+
+/**
+ * @brief Compress one chunk of chunk_cells values (i fastest)
+ *
+ * Values are clamped to the band and quantized as described for SdfCompression. Each value
+ * is then predicted from the previous one (integer difference, or XOR of the float bits),
+ * the residual bytes are grouped by significance and run-length coded. A chunk whose values
+ * are all equal, as in the truncated far field, costs a few bytes.
+ */
+void encode_sdf_chunk(const float* values, int quantize_bits, float band, std::vector<unsigned char>& out);
+
+/**
+ * @brief Decode a chunk produced by encode_sdf_chunk()
+ * @return false if the data is malformed
+ */
+bool decode_sdf_chunk(const unsigned char* data, size_t size, int quantize_bits, float band, float* values);
+
+} // namespace sdfgen
+
+/**
+ * @brief Write a signed distance field as compressed 32^3 chunks
+ *
+ * Compressed format (little-endian):
+ * - Header (56 bytes):
+ *   - 4 bytes: Magic "SDFC"
+ *   - int32: Format version (1)
+ *   - 3 x int32: Grid dimensions (Nx, Ny, Nz)
+ *   - int32: Chunk size (32)
+ *   - 3 x float32: Grid origin (x, y, z)
+ *   - float32: Cell spacing dx
+ *   - float32: Band (values clamped to [-band, band]; 0 = not clamped)
+ *   - int32: Quantization bits (0 = float32, 8 or 16)
+ *   - int64: Number of chunks
+ * - Chunk index: (chunks + 1) x uint64 file offsets; chunk n spans [offset n, offset n+1)
+ * - Chunks, ci fastest then cj then ck, each encoded by encode_sdf_chunk()
+ *
+ * Chunks are compressed in parallel, a batch at a time, so memory stays bounded for any
+ * grid size.
+ *
+ * @param filename Output file path (conventionally .csdf)
+ * @param phi_grid SDF grid data
+ * @param origin Grid origin (node (0,0,0))
+ * @param dx Grid cell spacing
+ * @param options Quantization, band and threads
+ * @return true on success, false on error
+ */
+bool write_compressed_sdf(const std::string& filename,
+                          const Array3f& phi_grid,
+                          const Vec3f& origin,
+                          float dx,
+                          const sdfgen::SdfCompression& options = sdfgen::SdfCompression());
+
+/**
+ * @brief Read a whole compressed SDF file written by write_compressed_sdf()
+ *
+ * @param filename Input file path
+ * @param phi_grid Output SDF grid data (resized)
+ * @param origin Output grid origin
+ * @param dx Output cell spacing
+ * @param num_threads Threads decoding chunks, 0 = auto-detect
+ * @return true on success, false on error
+ */
+bool read_compressed_sdf(const std::string& filename,
+                         Array3f& phi_grid,
+                         Vec3f& origin,
+                         float& dx,
+                         int num_threads = 0);
@@ -0,0 +1,38 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <vector>
+#include "array3.h"
+#include "sdfgen_options.h"
+#include "vec.h"
+
+namespace sdfgen {
+
+/**
+ * @brief Dense signed distance field plus the generation data needed to update it in place
+ *
+ * Filled by the make_level_set3() overload that takes a LevelSetState and consumed by
+ * update_level_set3(). Besides the field it retains, per node, the triangle its distance was
+ * measured to and the per-interval ray crossing counts of the sign pass, plus a copy of the
+ * mesh the field currently describes (so the old geometry of edited triangles is known).
+ * That is about 12 bytes per node on top of phi.
+ */
+class LevelSetState {
+public:
+   Array3f phi;                  /**< Signed distance field */
+   Array3i closest_tri;          /**< Triangle phi(i,j,k) was measured to, -1 if none */
+   Array3i intersection_count;   /**< +x ray crossings of row (j,k) in (i-1,i] */
+   std::vector<Vec3ui> tri;      /**< Mesh the field describes */
+   std::vector<Vec3f> x;
+   Vec3f origin;                 /**< World position of node (0,0,0) */
+   float dx;                     /**< Node spacing */
+   int exact_band;               /**< Exact-distance band in cells */
+   SignMode sign_mode;           /**< Sign rule of phi; updates re-sign rows by parity only */
+
+   LevelSetState() : dx(0), exact_band(1), sign_mode(SignMode::Parity) {}
+};
+
+} // namespace sdfgen
@@ -0,0 +1,30 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#include "log.h"
+#include <atomic>
+#include <iostream>
+
+namespace sdfgen {
+
+namespace {
+std::atomic<bool> enabled(true);
+}
+
+void set_log_enabled(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+bool log_enabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+std::ostream& log_stream() {
+    if (log_enabled()) return std::cout;
+    // No buffer: every write just sets badbit. One per thread so the flags are not shared.
+    static thread_local std::ostream discard(nullptr);
+    return discard;
+}
+
+} // namespace sdfgen
@@ -0,0 +1,27 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <ostream>
+
+namespace sdfgen {
+
+/**
+ * @brief Turn the library's progress messages (mesh loading, repair) on or off
+ *
+ * On by default. Errors still go to std::cerr. Process-wide; safe to call from any thread.
+ */
+void set_log_enabled(bool enabled);
+
+/** @brief True unless set_log_enabled(false) was called */
+bool log_enabled();
+
+/**
+ * @brief Stream for progress messages: std::cout, or a stream that drops everything when
+ *        logging is off
+ */
+std::ostream& log_stream();
+
+} // namespace sdfgen
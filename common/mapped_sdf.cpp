@@ -0,0 +1,211 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#include "mapped_sdf.h"
+#include "util.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sdfgen {
+
+namespace {
+
+const size_t header_bytes = 3 * sizeof(int) + 6 * sizeof(float);
+
+} // namespace
+
+MappedSDF::MappedSDF() { reset(); }
+
+MappedSDF::~MappedSDF() { close(); }
+
+MappedSDF::MappedSDF(MappedSDF&& other) noexcept
+{
+    reset();
+    *this = std::move(other);
+}
+
+MappedSDF& MappedSDF::operator=(MappedSDF&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        values_ = other.values_;
+        mapping_ = other.mapping_;
+        mapped_size_ = other.mapped_size_;
+        handle_ = other.handle_;
+        ni_ = other.ni_;
+        nj_ = other.nj_;
+        nk_ = other.nk_;
+        min_box_ = other.min_box_;
+        max_box_ = other.max_box_;
+        dx_ = other.dx_;
+        layout_ = other.layout_;
+        other.reset();
+    }
+    return *this;
+}
+
+void MappedSDF::reset()
+{
+    values_ = nullptr;
+    mapping_ = nullptr;
+    mapped_size_ = 0;
+    handle_ = nullptr;
+    ni_ = nj_ = nk_ = 0;
+    min_box_ = max_box_ = Vec3f(0, 0, 0);
+    dx_ = 0;
+    layout_ = SdfLayout::COrder;
+}
+
+void MappedSDF::close()
+{
+    if (mapping_) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping_);
+        CloseHandle(static_cast<HANDLE>(handle_));
+#else
+        munmap(mapping_, mapped_size_);
+#endif
+    }
+    reset();
+}
+
+bool MappedSDF::open(const std::string& filename)
+{
+    close();
+
+    // Map the whole file read-only
+    unsigned long long file_size = 0;
+    void* base = nullptr;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "ERROR: Failed to open file for reading: " << filename << std::endl;
+        return false;
+    }
+    LARGE_INTEGER size;
+    HANDLE view = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart >= (LONGLONG)header_bytes) {
+        file_size = (unsigned long long)size.QuadPart;
+        view = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (view) base = MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+        if (view && !base) CloseHandle(view);
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "ERROR: Failed to open file for reading: " << filename << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && (unsigned long long)info.st_size >= header_bytes) {
+        file_size = (unsigned long long)info.st_size;
+        base = mmap(nullptr, (size_t)file_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) base = nullptr;
+    }
+    ::close(fd);
+#endif
+    if (!base) {
+        std::cerr << "ERROR: Failed to map SDF file (missing header?): " << filename << std::endl;
+        return false;
+    }
+
+    // Header: dimensions (Nx negated for native layout), bounds_min, bounds_max
+    int dims[3];
+    float bounds[6];
+    std::memcpy(dims, base, sizeof(dims));
+    std::memcpy(bounds, static_cast<const char*>(base) + sizeof(dims), sizeof(bounds));
+    bool native = dims[0] < 0 && dims[0] != INT_MIN;
+    int ni = native ? -dims[0] : dims[0];
+    unsigned long long expected = header_bytes +
+        (unsigned long long)std::max(ni, 0) * std::max(dims[1], 0) * std::max(dims[2], 0) * sizeof(float);
+
+    mapping_ = base;
+    mapped_size_ = (size_t)file_size;
+#ifdef _WIN32
+    handle_ = view;
+#endif
+    if (ni <= 0 || dims[1] <= 0 || dims[2] <= 0) {
+        std::cerr << "ERROR: Invalid dimensions in SDF file: "
+                  << dims[0] << "x" << dims[1] << "x" << dims[2] << std::endl;
+        close();
+        return false;
+    }
+    if (file_size != expected) {
+        std::cerr << "ERROR: SDF file size " << file_size << " does not match its "
+                  << ni << "x" << dims[1] << "x" << dims[2] << " header: " << filename << std::endl;
+        close();
+        return false;
+    }
+
+    values_ = reinterpret_cast<const float*>(static_cast<const char*>(base) + header_bytes);
+    ni_ = ni;
+    nj_ = dims[1];
+    nk_ = dims[2];
+    min_box_ = Vec3f(bounds[0], bounds[1], bounds[2]);
+    max_box_ = Vec3f(bounds[3], bounds[4], bounds[5]);
+    dx_ = (max_box_[0] - min_box_[0]) / ni_;
+    layout_ = native ? SdfLayout::Native : SdfLayout::COrder;
+    return true;
+}
+
+void MappedSDF::locate(const Vec3f& p, int lo[3], int hi[3], float f[3]) const
+{
+    const int n[3] = {ni_, nj_, nk_};
+    for (int a = 0; a < 3; ++a) {
+        if (n[a] < 2) {
+            lo[a] = hi[a] = 0;
+            f[a] = 0;
+        } else {
+            get_barycentric((p[a] - min_box_[a]) / dx_, lo[a], f[a], 0, n[a]);
+            hi[a] = lo[a] + 1;
+        }
+    }
+}
+
+float MappedSDF::sample(const Vec3f& p) const
+{
+    int lo[3], hi[3];
+    float f[3];
+    locate(p, lo, hi, f);
+    return trilerp(value(lo[0], lo[1], lo[2]), value(hi[0], lo[1], lo[2]),
+                   value(lo[0], hi[1], lo[2]), value(hi[0], hi[1], lo[2]),
+                   value(lo[0], lo[1], hi[2]), value(hi[0], lo[1], hi[2]),
+                   value(lo[0], hi[1], hi[2]), value(hi[0], hi[1], hi[2]),
+                   f[0], f[1], f[2]);
+}
+
+Vec3f MappedSDF::gradient(const Vec3f& p) const
+{
+    int lo[3], hi[3];
+    float f[3];
+    locate(p, lo, hi, f);
+    float v000 = value(lo[0], lo[1], lo[2]), v100 = value(hi[0], lo[1], lo[2]);
+    float v010 = value(lo[0], hi[1], lo[2]), v110 = value(hi[0], hi[1], lo[2]);
+    float v001 = value(lo[0], lo[1], hi[2]), v101 = value(hi[0], lo[1], hi[2]);
+    float v011 = value(lo[0], hi[1], hi[2]), v111 = value(hi[0], hi[1], hi[2]);
+    // An axis with a single node has no slope
+    float gx = ni_ < 2 ? 0.0f : bilerp(v100 - v000, v110 - v010, v101 - v001, v111 - v011, f[1], f[2]);
+    float gy = nj_ < 2 ? 0.0f : bilerp(v010 - v000, v110 - v100, v011 - v001, v111 - v101, f[0], f[2]);
+    float gz = nk_ < 2 ? 0.0f : bilerp(v001 - v000, v101 - v100, v011 - v010, v111 - v110, f[0], f[1]);
+    return Vec3f(gx, gy, gz) / dx_;
+}
+
+} // namespace sdfgen
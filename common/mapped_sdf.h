@@ -0,0 +1,106 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "sdf_io.h"
+#include "vec.h"
+#include <cassert>
+#include <cstddef>
+#include <string>
+
+namespace sdfgen {
+
+/**
+ * @brief Read-only view of a dense .sdf file mapped into memory
+ *
+ * open() maps the file written by write_sdf_binary() (either layout) and validates its
+ * 36-byte header and size; nothing is read up front, so opening an 8 GB field is
+ * immediate and only the pages that queries touch are ever loaded. Node (i, j, k) sits at
+ * min_box() + dx() * (i, j, k), as in make_level_set3(). Move-only; the mapping is
+ * released by close() or the destructor.
+ */
+class MappedSDF {
+public:
+    MappedSDF();
+    ~MappedSDF();
+    MappedSDF(MappedSDF&& other) noexcept;
+    MappedSDF& operator=(MappedSDF&& other) noexcept;
+    MappedSDF(const MappedSDF&) = delete;
+    MappedSDF& operator=(const MappedSDF&) = delete;
+
+    /**
+     * @brief Map a dense binary SDF file
+     *
+     * @param filename Input file path
+     * @return true on success, false on error (unreadable file, invalid dimensions, or a
+     *         size that does not match the header)
+     */
+    bool open(const std::string& filename);
+
+    /** @brief Release the mapping (no-op if nothing is open) */
+    void close();
+
+    /** @brief True while a file is mapped */
+    bool is_open() const { return values_ != nullptr; }
+
+    int ni() const { return ni_; }
+    int nj() const { return nj_; }
+    int nk() const { return nk_; }
+    const Vec3f& min_box() const { return min_box_; }
+    const Vec3f& max_box() const { return max_box_; }
+    /** @brief Node spacing, (max_box - min_box) / ni as for read_sdf_binary() callers */
+    float dx() const { return dx_; }
+    SdfLayout layout() const { return layout_; }
+
+    /** @brief The mapped values in file order (see layout()) */
+    const float* data() const { return values_; }
+
+    /** @brief Distance at node (i, j, k); the indices must lie in the grid */
+    float value(int i, int j, int k) const
+    {
+        assert(i >= 0 && i < ni_ && j >= 0 && j < nj_ && k >= 0 && k < nk_);
+        return values_[index(i, j, k)];
+    }
+
+    /**
+     * @brief Trilinearly interpolated distance at a world-space point
+     *
+     * Points outside the node box are clamped onto it.
+     */
+    float sample(const Vec3f& p) const;
+
+    /**
+     * @brief Gradient of the trilinear interpolant at a world-space point
+     *
+     * Exact derivative within the cell containing p (8 reads, no finite-difference step);
+     * points outside the node box use the gradient of the nearest boundary cell. Not
+     * normalized.
+     */
+    Vec3f gradient(const Vec3f& p) const;
+
+private:
+    size_t index(int i, int j, int k) const
+    {
+        if (layout_ == SdfLayout::Native)
+            return (size_t)i + (size_t)ni_ * ((size_t)j + (size_t)nj_ * (size_t)k);
+        return (size_t)k + (size_t)nk_ * ((size_t)j + (size_t)nj_ * (size_t)i);
+    }
+
+    // Cell corners and fractions of p along each axis, clamped onto the grid
+    void locate(const Vec3f& p, int lo[3], int hi[3], float f[3]) const;
+
+    void reset();
+
+    const float* values_;
+    void* mapping_;      // Base of the mapped view
+    size_t mapped_size_;
+    void* handle_;       // Windows file-mapping object (unused on POSIX)
+    int ni_, nj_, nk_;
+    Vec3f min_box_, max_box_;
+    float dx_;
+    SdfLayout layout_;
+};
+
+} // namespace sdfgen
@@ -0,0 +1,196 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#include "marching_cubes.h"
+#include "marching_cubes_tables.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+namespace sdfgen {
+
+namespace {
+
+using namespace marching_cubes_tables;
+
+const unsigned int no_vertex = 0xffffffffu;
+const unsigned int next_slab = 0x80000000u; // Flags an x/y edge id on the next slab's bottom layer
+
+// Triangles of one slab. Indices are local to the slab, except those flagged next_slab,
+// which name an edge on the slab's top node layer; the next slab owns those vertices.
+struct Slab {
+    std::vector<Vec3f> vertices;
+    std::vector<Vec3ui> triangles;
+    std::vector<unsigned int> bottom; // Edge id of local vertices 0, 1, ... on the bottom layer (ascending)
+};
+
+// Vertex on the edge from a (value va) to b (value vb)
+inline Vec3f interpolate(const Vec3f& a, const Vec3f& b, float va, float vb, float isolevel)
+{
+    if (std::fabs(isolevel - va) < 1e-6f) return a;
+    if (std::fabs(isolevel - vb) < 1e-6f) return b;
+    if (std::fabs(va - vb) < 1e-6f) return a;
+    float t = (isolevel - va) / (vb - va);
+    return a + (b - a) * t;
+}
+
+class SlabExtractor {
+public:
+    SlabExtractor(const Array3f& phi, const Vec3f& origin, const Vec3f& spacing, float isolevel)
+        : phi_(phi), origin_(origin), spacing_(spacing), isolevel_(isolevel), ni_(phi.ni), nj_(phi.nj) {}
+
+    void run(int k0, int k1, bool last, Slab& slab)
+    {
+        const size_t layer = (size_t)ni_ * nj_;
+        std::vector<unsigned int> lo(2 * layer), hi(2 * layer), z(layer);
+        std::vector<unsigned char> in_lo(layer), in_hi(layer);
+
+        classify(k0, in_lo);
+        fill_layer(k0, in_lo, lo, slab, &slab.bottom);
+        for (int k = k0; k < k1; ++k) {
+            classify(k + 1, in_hi);
+            fill_z(k, in_lo, in_hi, z, slab);
+            // The top layer of all but the last slab belongs to the next slab
+            bool top_shared = (k + 1 == k1) && !last;
+            if (!top_shared) fill_layer(k + 1, in_hi, hi, slab, nullptr);
+
+            for (int j = 0; j + 1 < nj_; ++j) {
+                const unsigned char* b0 = &in_lo[(size_t)ni_ * j];
+                const unsigned char* b1 = b0 + ni_;
+                const unsigned char* t0 = &in_hi[(size_t)ni_ * j];
+                const unsigned char* t1 = t0 + ni_;
+                for (int i = 0; i + 1 < ni_; ++i) {
+                    int cube = b0[i] | b0[i + 1] << 1 | t0[i + 1] << 2 | t0[i] << 3 |
+                               b1[i] << 4 | b1[i + 1] << 5 | t1[i + 1] << 6 | t1[i] << 7;
+                    if (cube == 0 || cube == 255) continue;
+
+                    const int* row = tri_table[cube];
+                    for (int t = 0; row[t] != -1; t += 3) {
+                        Vec3ui tri;
+                        for (int v = 0; v < 3; ++v) {
+                            const int* e = cell_edges[row[t + v]];
+                            size_t node = (size_t)(i + e[0]) + (size_t)ni_ * (j + e[1]);
+                            if (e[3] == 2) tri[v] = z[node];
+                            else if (e[2] == 0) tri[v] = lo[2 * node + e[3]];
+                            else if (top_shared) tri[v] = next_slab | (unsigned int)(2 * node + e[3]);
+                            else tri[v] = hi[2 * node + e[3]];
+                        }
+                        slab.triangles.push_back(tri);
+                    }
+                }
+            }
+            lo.swap(hi);
+            in_lo.swap(in_hi);
+        }
+    }
+
+private:
+    Vec3f position(int i, int j, int k) const
+    {
+        return origin_ + Vec3f(i * spacing_[0], j * spacing_[1], k * spacing_[2]);
+    }
+
+    // Inside flags of node layer k, one byte per node
+    void classify(int k, std::vector<unsigned char>& inside) const
+    {
+        const float* values = &phi_.a[(size_t)ni_ * nj_ * k];
+        for (size_t n = 0; n < inside.size(); ++n) inside[n] = values[n] < isolevel_;
+    }
+
+    unsigned int add_vertex(int i, int j, int k, int axis, Slab& slab) const
+    {
+        int i1 = i + (axis == 0), j1 = j + (axis == 1), k1 = k + (axis == 2);
+        float va = phi_(i, j, k), vb = phi_(i1, j1, k1);
+        slab.vertices.push_back(interpolate(position(i, j, k), position(i1, j1, k1), va, vb, isolevel_));
+        return (unsigned int)(slab.vertices.size() - 1);
+    }
+
+    // Vertices on the crossed x and y edges of node layer k, map[2*node + axis]
+    void fill_layer(int k, const std::vector<unsigned char>& inside, std::vector<unsigned int>& map,
+                    Slab& slab, std::vector<unsigned int>* ids) const
+    {
+        for (int j = 0; j < nj_; ++j) {
+            for (int i = 0; i < ni_; ++i) {
+                size_t node = (size_t)i + (size_t)ni_ * j;
+                for (int axis = 0; axis < 2; ++axis) {
+                    bool crossed = axis == 0 ? i + 1 < ni_ && inside[node] != inside[node + 1]
+                                             : j + 1 < nj_ && inside[node] != inside[node + ni_];
+                    unsigned int v = crossed ? add_vertex(i, j, k, axis, slab) : no_vertex;
+                    map[2 * node + axis] = v;
+                    if (ids && crossed) ids->push_back((unsigned int)(2 * node + axis));
+                }
+            }
+        }
+    }
+
+    // Vertices on the crossed z edges from node layer k to k+1, map[node]
+    void fill_z(int k, const std::vector<unsigned char>& below, const std::vector<unsigned char>& above,
+                std::vector<unsigned int>& map, Slab& slab) const
+    {
+        for (int j = 0; j < nj_; ++j) {
+            for (int i = 0; i < ni_; ++i) {
+                size_t node = (size_t)i + (size_t)ni_ * j;
+                map[node] = below[node] != above[node] ? add_vertex(i, j, k, 2, slab) : no_vertex;
+            }
+        }
+    }
+
+    const Array3f& phi_;
+    Vec3f origin_, spacing_;
+    float isolevel_;
+    int ni_, nj_;
+};
+
+} // namespace
+
+void marching_cubes(const Array3f& phi, const Vec3f& origin, const Vec3f& spacing, float isolevel,
+                    std::vector<Vec3f>& vertices, std::vector<Vec3ui>& triangles, int num_threads)
+{
+    vertices.clear();
+    triangles.clear();
+    if (phi.ni < 2 || phi.nj < 2 || phi.nk < 2) return;
+
+    const int cell_layers = phi.nk - 1;
+    const int slab_count = (cell_layers + marching_cubes_slab - 1) / marching_cubes_slab;
+    std::vector<Slab> slabs(slab_count);
+    ThreadPool& pool = ThreadPool::global();
+    unsigned int threads = resolve_thread_count(num_threads);
+
+    pool.parallel_for(slab_count, threads, [&](int s) {
+        int k0 = s * marching_cubes_slab;
+        int k1 = std::min(k0 + marching_cubes_slab, cell_layers);
+        SlabExtractor(phi, origin, spacing, isolevel).run(k0, k1, s + 1 == slab_count, slabs[s]);
+    });
+
+    // Concatenate the slabs and resolve references into the next slab's bottom layer
+    std::vector<size_t> vertex_start(slab_count + 1, 0), triangle_start(slab_count + 1, 0);
+    for (int s = 0; s < slab_count; ++s) {
+        vertex_start[s + 1] = vertex_start[s] + slabs[s].vertices.size();
+        triangle_start[s + 1] = triangle_start[s] + slabs[s].triangles.size();
+    }
+    vertices.resize(vertex_start[slab_count]);
+    triangles.resize(triangle_start[slab_count]);
+
+    pool.parallel_for(slab_count, threads, [&](int s) {
+        Slab& slab = slabs[s];
+        std::copy(slab.vertices.begin(), slab.vertices.end(), vertices.begin() + vertex_start[s]);
+        for (size_t t = 0; t < slab.triangles.size(); ++t) {
+            Vec3ui tri = slab.triangles[t];
+            for (int v = 0; v < 3; ++v) {
+                if (tri[v] & next_slab) {
+                    const std::vector<unsigned int>& ids = slabs[s + 1].bottom;
+                    size_t local = std::lower_bound(ids.begin(), ids.end(), tri[v] & ~next_slab) - ids.begin();
+                    tri[v] = (unsigned int)(vertex_start[s + 1] + local);
+                } else {
+                    tri[v] = (unsigned int)(vertex_start[s] + tri[v]);
+                }
+            }
+            triangles[triangle_start[s] + t] = tri;
+        }
+    });
+}
+
+} // namespace sdfgen
@@ -0,0 +1,40 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "array3.h"
+#include "vec.h"
+#include <vector>
+
+namespace sdfgen {
+
+/**
+ * @brief Extract the isosurface phi = isolevel as an indexed triangle mesh (marching cubes)
+ *
+ * Cells are processed in slabs of marching_cubes_slab cell layers along z, in parallel.
+ * Every grid edge the surface crosses gets one vertex, computed once and shared by the up
+ * to four cells around it, including across slab boundaries, so the mesh comes out welded.
+ * Cells whose corners are all on one side are skipped after the sign test. The slabs do not
+ * depend on the thread count, so the output is identical for any num_threads.
+ *
+ * Node (i, j, k) sits at origin + (i*spacing[0], j*spacing[1], k*spacing[2]); a node is
+ * inside when its value is below isolevel.
+ *
+ * @param phi Field sampled at the grid nodes
+ * @param origin Position of node (0, 0, 0)
+ * @param spacing Node spacing along x, y and z
+ * @param isolevel Value of the extracted surface
+ * @param vertices Output vertex positions (replaced)
+ * @param triangles Output triangles, indices into vertices (replaced)
+ * @param num_threads Number of threads, 0 = auto-detect
+ */
+void marching_cubes(const Array3f& phi, const Vec3f& origin, const Vec3f& spacing, float isolevel,
+                    std::vector<Vec3f>& vertices, std::vector<Vec3ui>& triangles,
+                    int num_threads = 0);
+
+/// Cell layers per slab in marching_cubes()
+const int marching_cubes_slab = 8;
+
+} // namespace sdfgen
@@ -5,8 +5,11 @@
 // Mesh I/O utility functions
 
 #include "mesh_io.h"
+#include "log.h"
+#include "thread_pool.h"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <iostream>
 
 namespace meshio {
@@ -26,19 +29,188 @@ std::string get_extension(const std::string& filename) {
     return ext;
 }
 
+namespace {
+
+const uint32_t NO_VERTEX = 0xffffffffu;
+const size_t DEDUP_BUCKET_VERTICES = 1 << 18;     // Few enough buckets for a streaming scatter
+const size_t DEDUP_MIN_RANGE = 1 << 16;
+
+size_t table_size_for(size_t count) {
+    size_t size = 16;
+    while (size < 2 * count) size <<= 1;
+    return size;
+}
+
+// Table slot from the record bits (bucket selection used the high bits of position_hash)
+uint64_t slot_hash(const uint32_t bits[3]) {
+    uint64_t h = (bits[0] * 0x9E3779B97F4A7C15ull) ^ (bits[1] * 0xBF58476D1CE4E5B9ull) ^
+                 (bits[2] * 0x94D049BB133111EBull);
+    return h ^ (h >> 29);
+}
+
+size_t range_count(size_t n, unsigned int threads) {
+    return std::max<size_t>(1, std::min<size_t>(threads, n / DEDUP_MIN_RANGE));
+}
+
+} // namespace
+
+std::vector<uint32_t> find_exact_duplicates(const std::vector<Vec3f>& vertices,
+                                            int num_threads,
+                                            const std::vector<uint64_t>* hashes) {
+    const size_t n = vertices.size();
+    sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+    const unsigned int threads = sdfgen::resolve_thread_count(num_threads);
+    const size_t num_ranges = range_count(n, threads);
+    const size_t num_buckets = std::max<size_t>(n / DEDUP_BUCKET_VERTICES,
+                                                std::min<size_t>(4 * threads, n / DEDUP_MIN_RANGE + 1));
+
+    std::vector<uint64_t> computed;
+    if (!hashes) {
+        computed.resize(n);
+        pool.parallel_for((int)num_ranges, threads, [&](int r) {
+            for (size_t i = n * r / num_ranges; i < n * (r + 1) / num_ranges; ++i) {
+                computed[i] = position_hash(vertices[i]);
+            }
+        });
+        hashes = &computed;
+    }
+    const std::vector<uint64_t>& hash = *hashes;
+
+    // Stable scatter of (bit pattern, index) records into buckets, bucket-major offsets per
+    // input range, so that each bucket is then processed from contiguous memory
+    struct Record {
+        uint32_t bits[3];
+        uint32_t index;
+    };
+    std::vector<size_t> offsets(num_ranges * num_buckets, 0);
+    pool.parallel_for((int)num_ranges, threads, [&](int r) {
+        size_t* counts = &offsets[r * num_buckets];
+        for (size_t i = n * r / num_ranges; i < n * (r + 1) / num_ranges; ++i) {
+            ++counts[(hash[i] >> 40) % num_buckets];
+        }
+    });
+    std::vector<size_t> bucket_begin(num_buckets + 1, 0);
+    size_t offset = 0;
+    for (size_t b = 0; b < num_buckets; ++b) {
+        bucket_begin[b] = offset;
+        for (size_t r = 0; r < num_ranges; ++r) {
+            size_t count = offsets[r * num_buckets + b];
+            offsets[r * num_buckets + b] = offset;
+            offset += count;
+        }
+    }
+    bucket_begin[num_buckets] = offset;
+
+    std::vector<Record> records(n);
+    pool.parallel_for((int)num_ranges, threads, [&](int r) {
+        size_t* next = &offsets[r * num_buckets];
+        for (size_t i = n * r / num_ranges; i < n * (r + 1) / num_ranges; ++i) {
+            Record& record = records[next[(hash[i] >> 40) % num_buckets]++];
+            std::memcpy(record.bits, &vertices[i][0], sizeof(record.bits));
+            record.index = (uint32_t)i;
+        }
+    });
+
+    // Each bucket in ascending vertex order against its own open-addressing table
+    std::vector<uint32_t> first(n);
+    pool.parallel_for((int)num_buckets, threads, [&](int b) {
+        const Record* bucket = &records[bucket_begin[b]];
+        const size_t count = bucket_begin[b + 1] - bucket_begin[b];
+        std::vector<uint32_t> table(table_size_for(count), NO_VERTEX);
+        const size_t mask = table.size() - 1;
+        for (size_t k = 0; k < count; ++k) {
+            const Record& record = bucket[k];
+            first[record.index] = record.index;
+            // NaN: all exponent bits set and a nonzero mantissa
+            if ((record.bits[0] & 0x7fffffffu) > 0x7f800000u || (record.bits[1] & 0x7fffffffu) > 0x7f800000u ||
+                (record.bits[2] & 0x7fffffffu) > 0x7f800000u) continue;
+            for (size_t slot = slot_hash(record.bits) & mask; ; slot = (slot + 1) & mask) {
+                if (table[slot] == NO_VERTEX) {
+                    table[slot] = (uint32_t)k;
+                    break;
+                }
+                const Record& other = bucket[table[slot]];
+                if (other.bits[0] == record.bits[0] && other.bits[1] == record.bits[1] &&
+                    other.bits[2] == record.bits[2]) {
+                    first[record.index] = other.index;
+                    break;
+                }
+            }
+        }
+    });
+    return first;
+}
+
+size_t merge_exact_duplicates(std::vector<Vec3f>& vertList,
+                              std::vector<Vec3ui>& faceList,
+                              int num_threads,
+                              const std::vector<uint64_t>* hashes) {
+    const size_t n = vertList.size();
+    std::vector<uint32_t> index = find_exact_duplicates(vertList, num_threads, hashes);
+
+    // Kept vertices are numbered by ranges: count, prefix, then copy and number in parallel
+    sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+    const unsigned int threads = sdfgen::resolve_thread_count(num_threads);
+    const size_t ranges = range_count(n, threads);
+    std::vector<size_t> range_begin(ranges + 1, 0);
+    pool.parallel_for((int)ranges, threads, [&](int r) {
+        size_t kept = 0;
+        for (size_t i = n * r / ranges; i < n * (r + 1) / ranges; ++i) kept += index[i] == i;
+        range_begin[r + 1] = kept;
+    });
+    for (size_t r = 0; r < ranges; ++r) range_begin[r + 1] += range_begin[r];
+    const size_t kept = range_begin[ranges];
+    if (kept == n) return 0;
+
+    std::vector<Vec3f> unique(kept);
+    std::vector<uint32_t> remap(n);
+    pool.parallel_for((int)ranges, threads, [&](int r) {
+        size_t next = range_begin[r];
+        for (size_t i = n * r / ranges; i < n * (r + 1) / ranges; ++i) {
+            if (index[i] != i) continue;
+            unique[next] = vertList[i];
+            remap[i] = (uint32_t)next++;
+        }
+    });
+    pool.parallel_for((int)ranges, threads, [&](int r) {
+        for (size_t i = n * r / ranges; i < n * (r + 1) / ranges; ++i) {
+            if (index[i] != i) remap[i] = remap[index[i]];
+        }
+    });
+
+    const size_t num_faces = faceList.size();
+    const size_t face_ranges = range_count(num_faces, threads);
+    pool.parallel_for((int)face_ranges, threads, [&](int r) {
+        for (size_t f = num_faces * r / face_ranges; f < num_faces * (r + 1) / face_ranges; ++f) {
+            for (int c = 0; c < 3; ++c) {
+                if (faceList[f][c] < n) faceList[f][c] = remap[faceList[f][c]];
+            }
+        }
+    });
+
+    vertList = std::move(unique);
+    return n - kept;
+}
+
 bool load_mesh(const char* filename,
                std::vector<Vec3f>& vertList,
                std::vector<Vec3ui>& faceList,
                Vec3f& min_box,
-               Vec3f& max_box) {
+               Vec3f& max_box,
+               bool dedup) {
 
     std::string ext = get_extension(filename);
 
     if (ext == ".obj") {
-        return load_obj(filename, vertList, faceList, min_box, max_box);
+        if (!load_obj(filename, vertList, faceList, min_box, max_box)) return false;
+        if (dedup) {
+            size_t merged = merge_exact_duplicates(vertList, faceList);
+            sdfgen::log_stream() << "  Merged " << merged << " duplicate vertices (" << vertList.size() << " remain)" << std::endl;
+        }
+        return true;
     }
     else if (ext == ".stl") {
-        return load_stl(filename, vertList, faceList, min_box, max_box);
+        return load_stl(filename, vertList, faceList, min_box, max_box, dedup);
     }
     else {
         std::cerr << "ERROR: Unsupported file format: " << ext << std::endl;
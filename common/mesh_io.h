@@ -5,11 +5,13 @@
 #pragma once
 
 #include "vec.h"
+#include <cstdint>
+#include <cstring>
 #include <vector>
 #include <string>
 
 // Mesh I/O library for SDFGen
-// Supports OBJ and STL (both binary and ASCII) formats
+// Supports OBJ and STL (both binary and ASCII) formats; writes OBJ, binary PLY and binary STL
 
 namespace meshio {
 
@@ -46,21 +48,26 @@ bool load_obj(const char* filename,
  * detects whether the file is in binary or ASCII format by examining the file header.
  * Binary STL files have a fixed 80-byte header followed by triangle count and triangle
  * data. ASCII STL files begin with "solid" keyword. The function handles both formats
- * transparently and computes the mesh bounding box. Note that STL files may contain
- * duplicate vertices (no vertex sharing), which are preserved in the output.
+ * transparently and computes the mesh bounding box. Note that STL files store three
+ * vertices per triangle (no vertex sharing); these duplicates are preserved in the output
+ * unless dedup is set, in which case vertices with identical bit patterns are merged into
+ * an indexed mesh (see merge_exact_duplicates()). For binary files the vertex hashes are
+ * computed during the parallel parse.
  *
  * @param filename Path to STL file to load
- * @param vertList Output vector of vertex positions (may contain duplicates)
+ * @param vertList Output vector of vertex positions (contains duplicates unless dedup)
  * @param faceList Output vector of triangle indices (3 vertex indices per triangle)
  * @param min_box Output minimum corner of axis-aligned bounding box
  * @param max_box Output maximum corner of axis-aligned bounding box
+ * @param dedup Merge bit-identical vertices (about 6x fewer vertices for closed meshes)
  * @return true on successful load, false on file error or parse failure
  */
 bool load_stl(const char* filename,
               std::vector<Vec3f>& vertList,
               std::vector<Vec3ui>& faceList,
               Vec3f& min_box,
-              Vec3f& max_box);
+              Vec3f& max_box,
+              bool dedup = false);
 
 /**
  * @brief Load triangle mesh with automatic format detection from file extension
@@ -76,13 +83,93 @@ bool load_stl(const char* filename,
  * @param faceList Output vector of triangle indices (3 vertex indices per triangle)
  * @param min_box Output minimum corner of axis-aligned bounding box
  * @param max_box Output maximum corner of axis-aligned bounding box
+ * @param dedup Merge bit-identical vertices (STL during the parse, OBJ afterwards)
  * @return true on successful load, false if format unsupported or load failed
  */
 bool load_mesh(const char* filename,
                std::vector<Vec3f>& vertList,
                std::vector<Vec3ui>& faceList,
                Vec3f& min_box,
-               Vec3f& max_box);
+               Vec3f& max_box,
+               bool dedup = false);
+
+// ============================================================================
+// Writers
+// ============================================================================
+
+/**
+ * @brief Save an indexed triangle mesh as Wavefront OBJ text
+ *
+ * Lines are formatted in parallel, chunk by chunk, into memory and written in blocks of
+ * about 16 MB while the next block is formatted. Coordinates use the shortest decimal form
+ * that reads back to the same float, so load_obj() recovers the vertices bit for bit. The
+ * file does not depend on num_threads.
+ *
+ * @param filename Output path
+ * @param vertList Vertex positions
+ * @param faceList Triangles, 0-based indices into vertList (written 1-based)
+ * @param comment Optional text written as leading "# " lines
+ * @param num_threads Number of formatting threads, 0 = auto-detect
+ * @return true on success, false if the file could not be written
+ */
+bool save_obj(const char* filename,
+              const std::vector<Vec3f>& vertList,
+              const std::vector<Vec3ui>& faceList,
+              const std::string& comment = std::string(),
+              int num_threads = 0);
+
+/**
+ * @brief Save an indexed triangle mesh as binary little-endian PLY
+ *
+ * Vertices are float x, y, z (written straight from vertList); faces are
+ * "list uchar uint vertex_indices", 13 bytes each, packed in parallel in blocks.
+ *
+ * @param filename Output path
+ * @param vertList Vertex positions
+ * @param faceList Triangles, 0-based indices into vertList
+ * @param comment Optional text written as PLY comment lines
+ * @param num_threads Number of packing threads, 0 = auto-detect
+ * @return true on success, false if the file could not be written
+ */
+bool save_ply(const char* filename,
+              const std::vector<Vec3f>& vertList,
+              const std::vector<Vec3ui>& faceList,
+              const std::string& comment = std::string(),
+              int num_threads = 0);
+
+/**
+ * @brief Save a triangle mesh as binary STL
+ *
+ * Each triangle is stored with its three corners and unit normal (zero for degenerate
+ * triangles); records are built in parallel in blocks. STL has no vertex sharing, so the
+ * file holds 50 bytes per triangle.
+ *
+ * @param filename Output path
+ * @param vertList Vertex positions
+ * @param faceList Triangles, 0-based indices into vertList
+ * @param comment Optional text for the 80-byte header (truncated)
+ * @param num_threads Number of packing threads, 0 = auto-detect
+ * @return true on success, false if the file could not be written, an index is out of
+ *         range or there are more than 2^32 - 1 triangles
+ */
+bool save_stl(const char* filename,
+              const std::vector<Vec3f>& vertList,
+              const std::vector<Vec3ui>& faceList,
+              const std::string& comment = std::string(),
+              int num_threads = 0);
+
+/**
+ * @brief Save a triangle mesh in the format given by the file extension
+ *
+ * .obj, .ply and .stl (case-insensitive) select save_obj(), save_ply() and save_stl().
+ *
+ * @return true on success, false if the extension is unsupported or the write failed
+ */
+bool save_mesh(const char* filename,
+               const std::vector<Vec3f>& vertList,
+               const std::vector<Vec3ui>& faceList,
+               const std::string& comment = std::string(),
+               int num_threads = 0);
 
 // ============================================================================
 // Utility Functions
@@ -107,6 +194,51 @@ inline void update_minmax(const Vec3f& point, Vec3f& min_box, Vec3f& max_box) {
     max_box[2] = std::max(max_box[2], point[2]);
 }
 
+/**
+ * @brief Hash of the bit pattern of a vertex position, used to find exact duplicates
+ */
+inline uint64_t position_hash(const Vec3f& point) {
+    uint32_t bits[3];
+    std::memcpy(bits, &point[0], sizeof(bits));
+    uint64_t h = bits[0] * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 29) ^ bits[1]) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 31) ^ bits[2]) * 0x94D049BB133111EBull;
+    return h ^ (h >> 32);
+}
+
+/**
+ * @brief For every vertex, the index of the first vertex with the same bit pattern
+ *
+ * Vertices are scattered stably into hash buckets, and each bucket is deduplicated with its
+ * own open-addressing table in parallel, so the result does not depend on the thread count.
+ * Positions with a NaN coordinate are never merged.
+ *
+ * @param vertices Vertex positions
+ * @param num_threads Number of threads, 0 = auto-detect
+ * @param hashes Optional precomputed position_hash() of every vertex
+ * @return first[i] <= i, equal to i for the first occurrence of each position
+ */
+std::vector<uint32_t> find_exact_duplicates(const std::vector<Vec3f>& vertices,
+                                            int num_threads = 0,
+                                            const std::vector<uint64_t>* hashes = nullptr);
+
+/**
+ * @brief Merge vertices with identical bit patterns into an indexed mesh
+ *
+ * Kept vertices stay in order of first occurrence and faces are remapped to them; no face
+ * is removed (exact copies only make triangles degenerate if they already were).
+ *
+ * @param vertList Vertex positions (duplicates removed in place)
+ * @param faceList Triangle indices (remapped)
+ * @param num_threads Number of threads, 0 = auto-detect
+ * @param hashes Optional precomputed position_hash() of every vertex
+ * @return Number of vertices removed
+ */
+size_t merge_exact_duplicates(std::vector<Vec3f>& vertList,
+                              std::vector<Vec3ui>& faceList,
+                              int num_threads = 0,
+                              const std::vector<uint64_t>* hashes = nullptr);
+
 /**
  * @brief Extract file extension from filename and convert to lowercase
  *
@@ -3,20 +3,230 @@
 // Licensed under the MIT License - see LICENSE file
 
 // OBJ file loader for SDFGen
-// Supports Wavefront OBJ format with triangular faces only
+// Supports Wavefront OBJ vertices and polygonal faces (fan-triangulated)
 
 #include "mesh_io.h"
+#include "log.h"
+#include "thread_pool.h"
 #include <fstream>
-#include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <charconv>
 #include <cctype>
 #include <cstdint>
+#include <cstring>
+#include <string>
 
 namespace meshio {
 
 // Constants
-constexpr size_t LINE_BUFFER_SIZE = 256;  // Typical OBJ line length
+constexpr size_t OBJ_MIN_CHUNK_BYTES = 1 << 20;  // Smallest parse chunk worth a thread
+
+// ============================================================================
+// Internal helpers
+// ============================================================================
+
+namespace {
+
+/** @brief Vertices, faces and messages parsed from one newline-aligned chunk of the file */
+struct ObjChunk {
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    std::vector<size_t> relative;       // Face corners (3*face+corner) given as negative indices
+    std::vector<std::string> warnings;  // In line order
+    Vec3f min_box, max_box;
+    int32_t ignored_lines = 0;
+};
+
+inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline const char* skip_blanks(const char* p, const char* end) {
+    while (p < end && is_blank(*p)) ++p;
+    return p;
+}
+
+/**
+ * @brief Parse a decimal float, correctly rounded like the stream extraction it replaces
+ *
+ * Most OBJ coordinates have at most 7 significant digits and a small exponent, so mantissa
+ * and power of ten are both exact floats and one multiplication or division rounds
+ * correctly. Anything else goes through std::from_chars.
+ */
+bool parse_float(const char*& p, const char* end, float& value) {
+    static const float pow10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    const char* s = p;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) negative = *s++ == '-';
+    const char* digits = s;
+
+    uint64_t mantissa = 0;
+    int exponent = 0, significant = 0;
+    bool any_digit = false;
+    for (; s < end && *s >= '0' && *s <= '9'; ++s) {
+        any_digit = true;
+        if (mantissa != 0 || *s != '0') ++significant;
+        if (significant <= 19) mantissa = mantissa * 10 + (*s - '0');
+        else ++exponent;
+    }
+    if (s < end && *s == '.') {
+        for (++s; s < end && *s >= '0' && *s <= '9'; ++s) {
+            any_digit = true;
+            if (mantissa != 0 || *s != '0') ++significant;
+            if (significant <= 19) {
+                mantissa = mantissa * 10 + (*s - '0');
+                --exponent;
+            }
+        }
+    }
+    if (!any_digit) return false;
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        const char* e = s + 1;
+        bool negative_exponent = false;
+        if (e < end && (*e == '-' || *e == '+')) negative_exponent = *e++ == '-';
+        if (e < end && *e >= '0' && *e <= '9') {
+            int exp_value = 0;
+            for (; e < end && *e >= '0' && *e <= '9'; ++e) {
+                if (exp_value < 100000) exp_value = exp_value * 10 + (*e - '0');
+            }
+            exponent += negative_exponent ? -exp_value : exp_value;
+            s = e;
+        }
+    }
+
+    if (mantissa <= (1u << 24) && exponent >= -10 && exponent <= 10) {
+        float f = (float)mantissa;
+        f = exponent < 0 ? f / pow10[-exponent] : f * pow10[exponent];
+        value = negative ? -f : f;
+        p = s;
+        return true;
+    }
+
+    float f;
+    std::from_chars_result result = std::from_chars(digits, end, f);
+    if (result.ec != std::errc()) return false; // out of range fails like the stream did
+    value = negative ? -f : f;
+    p = result.ptr;
+    return true;
+}
+
+/** @brief Parse an optionally signed decimal vertex index */
+bool parse_index(const char*& p, const char* end, int64_t& value) {
+    if (p < end && *p == '+') ++p;
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+/**
+ * @brief Parse the lines of [begin, end), which starts at a line start and ends after a newline
+ *
+ * Same line rules as the former getline loop: "v " lines are positions, "vn"/"vt" and
+ * anything unrecognized are counted as ignored, "f " lines take the index before the first
+ * '/' of each corner and are fan-triangulated. Positive indices are 1-based; negative ones
+ * count back from the last vertex so far and are resolved relative to the chunk here and
+ * shifted by the vertices of earlier chunks when they are stitched.
+ */
+void parse_obj_chunk(const char* begin, const char* end, ObjChunk& chunk) {
+    chunk.min_box = Vec3f(std::numeric_limits<float>::max(),
+                          std::numeric_limits<float>::max(),
+                          std::numeric_limits<float>::max());
+    chunk.max_box = Vec3f(std::numeric_limits<float>::lowest(),
+                          std::numeric_limits<float>::lowest(),
+                          std::numeric_limits<float>::lowest());
+    std::vector<int64_t> corners;
+    std::vector<char> corner_relative;
+
+    for (const char* line = begin; line < end; ) {
+        const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+        const char* next = eol < end ? eol + 1 : end;
+        const size_t length = eol - line;
+        const char second = length >= 2 ? line[1] : '\0';
+
+        // Skip empty lines
+        if (length == 0) {
+            line = next;
+            continue;
+        }
+
+        if (line[0] == 'v') {
+            if (second == 'n' || second == 't') {
+                // Vertex normal or texture coordinate - skip (not needed for SDF generation)
+                ++chunk.ignored_lines;
+            }
+            else if (second == ' ' || second == '\t') {
+                // Vertex position
+                const char* p = line + 1;
+                Vec3f point;
+                bool ok = true;
+                for (int c = 0; c < 3 && ok; ++c) {
+                    p = skip_blanks(p, eol);
+                    ok = parse_float(p, eol, point[c]);
+                }
+                if (!ok) {
+                    chunk.warnings.push_back("WARNING: Failed to parse vertex: " + std::string(line, length));
+                }
+                else {
+                    chunk.verts.push_back(point);
+                    for (int c = 0; c < 3; ++c) {
+                        chunk.min_box[c] = std::min(chunk.min_box[c], point[c]);
+                        chunk.max_box[c] = std::max(chunk.max_box[c], point[c]);
+                    }
+                }
+            }
+        }
+        else if (line[0] == 'f' && (second == ' ' || second == '\t')) {
+            // Face - can be v, v/vt, v/vt/vn, or v//vn format, with any number of corners
+            corners.clear();
+            corner_relative.clear();
+            bool ok = true;
+            for (const char* p = skip_blanks(line + 1, eol); p < eol && ok; p = skip_blanks(p, eol)) {
+                int64_t index;
+                ok = parse_index(p, eol, index);
+                while (p < eol && !is_blank(*p)) ++p; // rest of the corner: /vt/vn
+                if (!ok) break;
+                // 0-based: positive indices count from the first vertex, negative ones back
+                // from the last vertex read so far in this chunk
+                corners.push_back(index < 0 ? (int64_t)chunk.verts.size() + index : index - 1);
+                corner_relative.push_back(index < 0);
+            }
+            if (!ok) {
+                chunk.warnings.push_back("WARNING: Failed to parse face: " + std::string(line, length));
+            }
+            else if (corners.size() < 3) {
+                chunk.warnings.push_back("WARNING: Face has < 3 vertices: " + std::string(line, length));
+            }
+            else {
+                // Triangulate quads and larger polygons (simple fan triangulation)
+                for (size_t i = 1; i + 1 < corners.size(); ++i) {
+                    const size_t fan[3] = {0, i, i + 1};
+                    Vec3ui f;
+                    for (int c = 0; c < 3; ++c) {
+                        // A relative index reaching into an earlier chunk wraps here and is
+                        // brought back into range by the stitch offset
+                        f[c] = static_cast<uint32_t>(corners[fan[c]]);
+                        if (corner_relative[fan[c]]) chunk.relative.push_back(3 * chunk.faces.size() + c);
+                    }
+                    chunk.faces.push_back(f);
+                }
+            }
+        }
+        else {
+            // Comments, materials, groups, etc. - ignore
+            ++chunk.ignored_lines;
+        }
+        line = next;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Public API
+// ============================================================================
 
 bool load_obj(const char* filename,
               std::vector<Vec3f>& vertList,
@@ -25,17 +235,57 @@ bool load_obj(const char* filename,
               Vec3f& max_box) {
 
     // RAII: ifstream automatically closes file on scope exit
-    std::ifstream infile(filename);
+    std::ifstream infile(filename, std::ios::binary);
     if (!infile) {
         std::cerr << "ERROR: Failed to open OBJ file: " << filename << std::endl;
         return false;
     }
 
-    std::cout << "Reading OBJ file: " << filename << std::endl;
+    sdfgen::log_stream() << "Reading OBJ file: " << filename << std::endl;
+
+    // Whole file in one read; lines are parsed straight out of the buffer
+    infile.seekg(0, std::ios::end);
+    const std::streamoff file_size = infile.tellg();
+    infile.seekg(0, std::ios::beg);
+    std::vector<char> buffer(static_cast<size_t>(std::max<std::streamoff>(file_size, 0)));
+    infile.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!infile) {
+        std::cerr << "ERROR: Failed to read OBJ file: " << filename << std::endl;
+        return false;
+    }
+    const char* data = buffer.data();
+    const char* data_end = data + buffer.size();
+
+    // Chunks of at least OBJ_MIN_CHUNK_BYTES, each extended to the end of its last line so
+    // every line belongs to exactly one chunk
+    sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+    const unsigned int threads = sdfgen::resolve_thread_count(0);
+    size_t num_chunks = std::max<size_t>(1, std::min<size_t>(threads * 4, buffer.size() / OBJ_MIN_CHUNK_BYTES));
+    std::vector<const char*> bounds(1, data);
+    for (size_t c = 1; c < num_chunks; ++c) {
+        const char* cut = std::max(bounds.back(), data + buffer.size() * c / num_chunks);
+        const char* eol = static_cast<const char*>(std::memchr(cut, '\n', data_end - cut));
+        if (!eol) break;
+        bounds.push_back(eol + 1);
+    }
+    bounds.push_back(data_end);
+    num_chunks = bounds.size() - 1;
+
+    std::vector<ObjChunk> chunks(num_chunks);
+    pool.parallel_for(static_cast<int>(num_chunks), threads, [&](int c) {
+        parse_obj_chunk(bounds[c], bounds[c + 1], chunks[c]);
+    });
 
-    // Clear output containers
+    // Stitch: concatenate in file order and shift the chunk-relative indices
+    size_t total_verts = 0, total_faces = 0;
+    for (const ObjChunk& chunk : chunks) {
+        total_verts += chunk.verts.size();
+        total_faces += chunk.faces.size();
+    }
     vertList.clear();
     faceList.clear();
+    vertList.reserve(total_verts);
+    faceList.reserve(total_faces);
 
     // Initialize bounding box
     min_box = Vec3f(std::numeric_limits<float>::max(),
@@ -46,92 +296,22 @@ bool load_obj(const char* filename,
                     std::numeric_limits<float>::lowest());
 
     int32_t ignored_lines = 0;
-    std::string line;
-    line.reserve(LINE_BUFFER_SIZE);
-
-    while (std::getline(infile, line)) {
-        // Skip empty lines
-        if (line.empty()) {
-            continue;
-        }
-
-        // Parse line based on first character(s)
-        if (line[0] == 'v') {
-            if (line.size() >= 2 && line[1] == 'n') {
-                // Vertex normal - skip (not needed for SDF generation)
-                ++ignored_lines;
-                continue;
-            }
-            else if (line.size() >= 2 && line[1] == 't') {
-                // Texture coordinate - skip
-                ++ignored_lines;
-                continue;
-            }
-            else if (line[1] == ' ' || line[1] == '\t') {
-                // Vertex position
-                std::istringstream data(line);
-                char c;
-                Vec3f point;
-                data >> c >> point[0] >> point[1] >> point[2];
-
-                if (data.fail()) {
-                    std::cerr << "WARNING: Failed to parse vertex: " << line << std::endl;
-                    continue;
-                }
-
-                vertList.push_back(point);
-                update_minmax(point, min_box, max_box);
-            }
-        }
-        else if (line[0] == 'f' && (line[1] == ' ' || line[1] == '\t')) {
-            // Face - can be v, v/vt, v/vt/vn, or v//vn format
-            // Can be triangles or quads
-            std::istringstream data(line);
-            char c;
-            data >> c; // Skip 'f'
-
-            std::vector<int32_t> vertices;
-            std::string vertex_str;
-
-            // Read all vertex entries
-            while (data >> vertex_str) {
-                // Parse v/vt/vn format - extract only vertex index
-                size_t first_slash = vertex_str.find('/');
-                std::string v_str = (first_slash != std::string::npos)
-                                   ? vertex_str.substr(0, first_slash)
-                                   : vertex_str;
-
-                int32_t v_idx = std::stoi(v_str);
-                vertices.push_back(v_idx);
-            }
-
-            if (vertices.size() < 3) {
-                std::cerr << "WARNING: Face has < 3 vertices: " << line << std::endl;
-                continue;
-            }
-
-            // Convert to 0-based indexing and create triangles
-            // Triangulate quads if needed (simple fan triangulation)
-            for (size_t i = 1; i + 1 < vertices.size(); ++i) {
-                faceList.push_back(Vec3ui(
-                    static_cast<uint32_t>(vertices[0] - 1),
-                    static_cast<uint32_t>(vertices[i] - 1),
-                    static_cast<uint32_t>(vertices[i + 1] - 1)
-                ));
-            }
-        }
-        else if (line[0] == '#') {
-            // Comment - ignore
-            ++ignored_lines;
-        }
-        else {
-            // Other lines (materials, groups, etc.) - ignore
-            ++ignored_lines;
+    for (ObjChunk& chunk : chunks) {
+        for (const std::string& warning : chunk.warnings) std::cerr << warning << std::endl;
+        const uint32_t offset = static_cast<uint32_t>(vertList.size());
+        const size_t first_face = faceList.size();
+        vertList.insert(vertList.end(), chunk.verts.begin(), chunk.verts.end());
+        faceList.insert(faceList.end(), chunk.faces.begin(), chunk.faces.end());
+        for (size_t corner : chunk.relative) faceList[first_face + corner / 3][corner % 3] += offset;
+        for (int c = 0; c < 3; ++c) {
+            min_box[c] = std::min(min_box[c], chunk.min_box[c]);
+            max_box[c] = std::max(max_box[c], chunk.max_box[c]);
         }
+        ignored_lines += chunk.ignored_lines;
+        std::vector<Vec3f>().swap(chunk.verts);
+        std::vector<Vec3ui>().swap(chunk.faces);
     }
 
-    // RAII: infile automatically closed here
-
     // Validate results
     if (vertList.empty()) {
         std::cerr << "ERROR: No vertices found in OBJ file" << std::endl;
@@ -143,15 +323,25 @@ bool load_obj(const char* filename,
         return false;
     }
 
+    for (size_t f = 0; f < faceList.size(); ++f) {
+        for (int c = 0; c < 3; ++c) {
+            if (faceList[f][c] >= vertList.size()) {
+                std::cerr << "ERROR: Face " << f << " references a vertex outside the "
+                          << vertList.size() << " defined" << std::endl;
+                return false;
+            }
+        }
+    }
+
     // Print summary
     if (ignored_lines > 0) {
-        std::cout << "  Note: " << ignored_lines
+        sdfgen::log_stream() << "  Note: " << ignored_lines
                   << " lines ignored (comments, materials, etc.)" << std::endl;
     }
 
-    std::cout << "  Loaded " << vertList.size() << " vertices and "
+    sdfgen::log_stream() << "  Loaded " << vertList.size() << " vertices and "
               << faceList.size() << " faces" << std::endl;
-    std::cout << "  Bounds: (" << min_box << ") to (" << max_box << ")" << std::endl;
+    sdfgen::log_stream() << "  Bounds: (" << min_box << ") to (" << max_box << ")" << std::endl;
 
     return true;
 }
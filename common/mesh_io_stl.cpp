@@ -6,7 +6,10 @@
 // Supports both binary and ASCII STL formats with automatic detection
 
 #include "mesh_io.h"
+#include "log.h"
+#include "thread_pool.h"
 #include <fstream>
+#include <future>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
@@ -27,6 +30,8 @@ constexpr size_t STL_ATTRIBUTE_SIZE = 2;            // Size of attribute bytes
 constexpr size_t LINE_BUFFER_SIZE = 256;            // Typical ASCII STL line length
 constexpr int32_t VERTICES_PER_TRIANGLE = 3;        // Number of vertices in a triangle
 constexpr size_t MIN_HEADER_BYTES_TO_READ = 5;      // Minimum bytes needed to detect "solid"
+constexpr size_t STL_BLOCK_TRIANGLES = 1 << 18;     // Triangles per buffered binary read (12.5 MB)
+constexpr size_t STL_PARSE_CHUNK = 8192;            // Triangles per parallel parse task
 
 // ============================================================================
 // Internal helpers
@@ -99,7 +104,8 @@ static bool load_binary_stl(const char* filename,
                             std::vector<Vec3f>& vertList,
                             std::vector<Vec3ui>& faceList,
                             Vec3f& min_box,
-                            Vec3f& max_box) {
+                            Vec3f& max_box,
+                            bool dedup) {
 
     // RAII: file automatically closed on scope exit
     std::ifstream file(filename, std::ios::binary);
@@ -120,13 +126,23 @@ static bool load_binary_stl(const char* filename,
         return false;
     }
 
-    std::cout << "Reading binary STL with " << num_triangles << " triangles..." << std::endl;
+    sdfgen::log_stream() << "Reading binary STL with " << num_triangles << " triangles..." << std::endl;
 
-    // Clear and reserve space
-    vertList.clear();
-    faceList.clear();
-    vertList.reserve(num_triangles * 3);
-    faceList.reserve(num_triangles);
+    // A truncated file is reported before the outputs are allocated for the claimed count
+    const std::streamoff data_begin = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff available = (file.tellg() - data_begin) / static_cast<std::streamoff>(STL_TRIANGLE_SIZE);
+    file.seekg(data_begin, std::ios::beg);
+    if (available < static_cast<std::streamoff>(num_triangles)) {
+        std::cerr << "ERROR: Failed to read triangle " << available << std::endl;
+        return false;
+    }
+
+    // Preallocated outputs: every triangle writes its own three vertices and face
+    vertList.assign(static_cast<size_t>(num_triangles) * 3, Vec3f());
+    faceList.assign(num_triangles, Vec3ui());
+    // With dedup the vertex hashes are computed while each record is in cache
+    std::vector<uint64_t> hashes(dedup ? vertList.size() : 0);
 
     // Initialize bounding box
     min_box = Vec3f(std::numeric_limits<float>::max(),
@@ -136,38 +152,76 @@ static bool load_binary_stl(const char* filename,
                     std::numeric_limits<float>::lowest(),
                     std::numeric_limits<float>::lowest());
 
-    // Read triangles
-    for (uint32_t i = 0; i < num_triangles; ++i) {
-        // Skip normal (STL_NORMAL_SIZE bytes = 3 floats)
-        file.seekg(STL_NORMAL_SIZE, std::ios::cur);
-
-        // Read 3 vertices (9 floats = STL_VERTEX_DATA_SIZE bytes)
-        float v[9];
-        file.read(reinterpret_cast<char*>(v), STL_VERTEX_DATA_SIZE);
-
-        if (file.fail()) {
-            std::cerr << "ERROR: Failed to read triangle " << i << std::endl;
+    // Records are read in large blocks, double-buffered so the next block is read while the
+    // thread pool parses the current one in chunks
+    auto read_block = [&file](std::vector<char>& buffer, size_t count) {
+        buffer.resize(count * STL_TRIANGLE_SIZE);
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        return static_cast<size_t>(file.gcount()) / STL_TRIANGLE_SIZE;
+    };
+    sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+    std::vector<char> buffers[2];
+    std::vector<Vec3f> chunk_min, chunk_max;
+    size_t first = 0;
+    size_t block = std::min<size_t>(STL_BLOCK_TRIANGLES, num_triangles);
+    std::future<size_t> pending;
+    if (block > 0) pending = std::async(std::launch::async, read_block, std::ref(buffers[0]), block);
+
+    for (int current = 0; first < num_triangles; current = 1 - current) {
+        size_t read = pending.get();
+        if (read < block) {
+            // Same report as a per-triangle read: the first record that is missing or cut short
+            std::cerr << "ERROR: Failed to read triangle " << first + read << std::endl;
             return false;
         }
+        size_t next = first + block;
+        size_t next_block = std::min<size_t>(STL_BLOCK_TRIANGLES, num_triangles - next);
+        if (next_block > 0) {
+            pending = std::async(std::launch::async, read_block, std::ref(buffers[1 - current]), next_block);
+        }
 
-        // Skip attribute bytes (STL_ATTRIBUTE_SIZE bytes)
-        file.seekg(STL_ATTRIBUTE_SIZE, std::ios::cur);
-
-        // Store vertices and update bounds
-        uint32_t idx_base = static_cast<uint32_t>(vertList.size());
-        for (int32_t j = 0; j < VERTICES_PER_TRIANGLE; ++j) {
-            Vec3f vertex(v[j*VERTICES_PER_TRIANGLE], v[j*VERTICES_PER_TRIANGLE+1], v[j*VERTICES_PER_TRIANGLE+2]);
-            vertList.push_back(vertex);
-            update_minmax(vertex, min_box, max_box);
+        const char* records = buffers[current].data();
+        int num_chunks = static_cast<int>((block + STL_PARSE_CHUNK - 1) / STL_PARSE_CHUNK);
+        chunk_min.assign(num_chunks, min_box);
+        chunk_max.assign(num_chunks, max_box);
+        pool.parallel_for(num_chunks, 0, [&](int c) {
+            size_t end = std::min(block, (c + 1) * STL_PARSE_CHUNK);
+            for (size_t t = c * STL_PARSE_CHUNK; t < end; ++t) {
+                // Skip normal (STL_NORMAL_SIZE bytes) and attribute bytes; copy the 9 vertex floats
+                float v[9];
+                std::memcpy(v, records + t * STL_TRIANGLE_SIZE + STL_NORMAL_SIZE, STL_VERTEX_DATA_SIZE);
+                uint32_t idx_base = static_cast<uint32_t>((first + t) * VERTICES_PER_TRIANGLE);
+                for (int32_t j = 0; j < VERTICES_PER_TRIANGLE; ++j) {
+                    Vec3f vertex(v[j*VERTICES_PER_TRIANGLE], v[j*VERTICES_PER_TRIANGLE+1], v[j*VERTICES_PER_TRIANGLE+2]);
+                    vertList[idx_base + j] = vertex;
+                    if (dedup) hashes[idx_base + j] = position_hash(vertex);
+                    for (int a = 0; a < 3; ++a) {
+                        chunk_min[c][a] = std::min(chunk_min[c][a], vertex[a]);
+                        chunk_max[c][a] = std::max(chunk_max[c][a], vertex[a]);
+                    }
+                }
+                faceList[first + t] = Vec3ui(idx_base, idx_base + 1, idx_base + 2);
+            }
+        });
+        for (int c = 0; c < num_chunks; ++c) {
+            for (int a = 0; a < 3; ++a) {
+                min_box[a] = std::min(min_box[a], chunk_min[c][a]);
+                max_box[a] = std::max(max_box[a], chunk_max[c][a]);
+            }
         }
 
-        // Add face (3 sequential vertices)
-        faceList.push_back(Vec3ui(idx_base, idx_base + 1, idx_base + 2));
+        first = next;
+        block = next_block;
+    }
+
+    if (dedup) {
+        size_t merged = merge_exact_duplicates(vertList, faceList, 0, &hashes);
+        sdfgen::log_stream() << "  Merged " << merged << " duplicate vertices" << std::endl;
     }
 
-    std::cout << "  Loaded " << vertList.size() << " vertices and "
+    sdfgen::log_stream() << "  Loaded " << vertList.size() << " vertices and "
               << faceList.size() << " faces" << std::endl;
-    std::cout << "  Bounds: (" << min_box << ") to (" << max_box << ")" << std::endl;
+    sdfgen::log_stream() << "  Bounds: (" << min_box << ") to (" << max_box << ")" << std::endl;
 
     return true;
 }
@@ -189,7 +243,7 @@ static bool load_ascii_stl(const char* filename,
         return false;
     }
 
-    std::cout << "Reading ASCII STL..." << std::endl;
+    sdfgen::log_stream() << "Reading ASCII STL..." << std::endl;
 
     // Clear output containers
     vertList.clear();
@@ -294,10 +348,10 @@ static bool load_ascii_stl(const char* filename,
         return false;
     }
 
-    std::cout << "  Loaded " << triangle_count << " triangles ("
+    sdfgen::log_stream() << "  Loaded " << triangle_count << " triangles ("
               << vertList.size() << " vertices, "
               << faceList.size() << " faces)" << std::endl;
-    std::cout << "  Bounds: (" << min_box << ") to (" << max_box << ")" << std::endl;
+    sdfgen::log_stream() << "  Bounds: (" << min_box << ") to (" << max_box << ")" << std::endl;
 
     return true;
 }
@@ -310,7 +364,8 @@ bool load_stl(const char* filename,
               std::vector<Vec3f>& vertList,
               std::vector<Vec3ui>& faceList,
               Vec3f& min_box,
-              Vec3f& max_box) {
+              Vec3f& max_box,
+              bool dedup) {
 
     // Detect format
     STLFormat format = detect_stl_format(filename);
@@ -322,12 +377,17 @@ bool load_stl(const char* filename,
 
     // Dispatch to appropriate loader
     if (format == STLFormat::Binary) {
-        std::cout << "Detected: Binary STL" << std::endl;
-        return load_binary_stl(filename, vertList, faceList, min_box, max_box);
+        sdfgen::log_stream() << "Detected: Binary STL" << std::endl;
+        return load_binary_stl(filename, vertList, faceList, min_box, max_box, dedup);
     }
     else {
-        std::cout << "Detected: ASCII STL" << std::endl;
-        return load_ascii_stl(filename, vertList, faceList, min_box, max_box);
+        sdfgen::log_stream() << "Detected: ASCII STL" << std::endl;
+        if (!load_ascii_stl(filename, vertList, faceList, min_box, max_box)) return false;
+        if (dedup) {
+            size_t merged = merge_exact_duplicates(vertList, faceList);
+            sdfgen::log_stream() << "  Merged " << merged << " duplicate vertices (" << vertList.size() << " remain)" << std::endl;
+        }
+        return true;
     }
 }
 
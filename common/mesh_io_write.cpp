@@ -0,0 +1,300 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Mesh writers for SDFGen
+// OBJ text formatted in parallel, binary PLY and binary STL packed in parallel, all written
+// in large blocks while the next block is prepared
+
+#include "mesh_io.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace meshio {
+
+// Constants
+constexpr size_t MESH_BLOCK_BYTES = size_t(16) << 20;  // Bytes prepared per buffered write
+constexpr size_t MESH_CHUNK_RECORDS = 1 << 14;           // Lines or records packed per parallel task
+constexpr size_t OBJ_MAX_LINE = 64;                      // "v" + 3 x (" " + up to 15 chars) + "\n"
+constexpr size_t PLY_FACE_SIZE = 13;                     // uchar count + 3 x uint32
+constexpr size_t STL_RECORD_SIZE = 50;                   // normal + 3 corners + attribute
+constexpr size_t STL_HEADER_BYTES = 80;
+
+static_assert(sizeof(Vec3f) == 3 * sizeof(float), "Vec3f must be three packed floats");
+static_assert(sizeof(Vec3ui) == 3 * sizeof(unsigned int), "Vec3ui must be three packed indices");
+
+// ============================================================================
+// Internal helpers
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Open a file for a mesh writer, reporting failure
+ */
+bool open_output(std::ofstream& file, const char* filename) {
+    file.open(filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "ERROR: Failed to open file for writing: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Close and check a mesh writer's file
+ */
+bool finish_output(std::ofstream& file, const char* filename) {
+    file.close();
+    if (file.fail()) {
+        std::cerr << "ERROR: Failed to write mesh file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Write num_items records in blocks: block b is filled (in parallel) while block b-1 is written
+ *
+ * @param items_per_block Records per block
+ * @param fill fill(first, last, buffer) appends the records [first, last) to buffer (a
+ *        std::vector<std::string> of pieces written in order)
+ */
+template <class Fill>
+void write_blocks(std::ofstream& file, size_t num_items, size_t items_per_block, Fill fill) {
+    std::vector<std::string> buffers[2];
+    std::future<void> pending;
+    for (size_t first = 0, n = 0; first < num_items; first += items_per_block, n ^= 1) {
+        size_t last = std::min(num_items, first + items_per_block);
+        std::vector<std::string>& buffer = buffers[n];
+        fill(first, last, buffer);
+        if (pending.valid()) pending.get();
+        pending = std::async(std::launch::async, [&file, &buffer]() {
+            for (const std::string& piece : buffer) {
+                file.write(piece.data(), static_cast<std::streamsize>(piece.size()));
+            }
+        });
+    }
+    if (pending.valid()) pending.get();
+}
+
+/**
+ * @brief Split [first, last) into pieces of at most chunk records and pack each in parallel
+ *
+ * @param pack pack(begin, end, piece) writes records [begin, end) into piece, which is already
+ *        sized (end - begin) * record_size when record_size is nonzero
+ */
+template <class Pack>
+void pack_parallel(size_t first, size_t last, size_t chunk, size_t record_size, std::vector<std::string>& pieces,
+                   unsigned int threads, Pack pack) {
+    const size_t num_pieces = (last - first + chunk - 1) / chunk;
+    pieces.resize(num_pieces);
+    sdfgen::ThreadPool::global().parallel_for((int)num_pieces, threads, [&](int p) {
+        size_t begin = first + p * chunk;
+        size_t end = std::min(last, begin + chunk);
+        std::string& piece = pieces[p];
+        if (record_size) piece.resize((end - begin) * record_size);
+        pack(begin, end, piece);
+    });
+}
+
+/**
+ * @brief Append "x y z\n" with the shortest round-trip form of each coordinate
+ */
+inline char* format_vertex(char* out, char* end, const Vec3f& v) {
+    *out++ = 'v';
+    for (int c = 0; c < 3; ++c) {
+        *out++ = ' ';
+        out = std::to_chars(out, end, v[c]).ptr;
+    }
+    *out++ = '\n';
+    return out;
+}
+
+inline char* format_face(char* out, char* end, const Vec3ui& f) {
+    *out++ = 'f';
+    for (int c = 0; c < 3; ++c) {
+        *out++ = ' ';
+        out = std::to_chars(out, end, static_cast<unsigned long long>(f[c]) + 1).ptr;
+    }
+    *out++ = '\n';
+    return out;
+}
+
+/**
+ * @brief Comment text split into lines, each with the given prefix
+ */
+std::string comment_lines(const std::string& comment, const char* prefix) {
+    std::string out;
+    std::istringstream lines(comment);
+    std::string line;
+    while (std::getline(lines, line)) {
+        out += prefix;
+        out += line;
+        out += '\n';
+    }
+    return out;
+}
+
+} // namespace
+
+// ============================================================================
+// OBJ
+// ============================================================================
+
+bool save_obj(const char* filename,
+              const std::vector<Vec3f>& vertList,
+              const std::vector<Vec3ui>& faceList,
+              const std::string& comment,
+              int num_threads) {
+    std::ofstream file;
+    if (!open_output(file, filename)) return false;
+
+    std::string header = comment_lines(comment, "# ");
+    header += "# Vertices: " + std::to_string(vertList.size()) + "\n";
+    header += "# Triangles: " + std::to_string(faceList.size()) + "\n\n";
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    // Lines 0 .. V-1 are vertices, V .. V+F-1 faces; a block is about MESH_BLOCK_BYTES at typical
+    // line lengths, and at least one chunk per thread
+    const unsigned int threads = sdfgen::resolve_thread_count(num_threads);
+    const size_t num_vertices = vertList.size();
+    const size_t num_lines = num_vertices + faceList.size();
+    const size_t block_lines = std::max(MESH_BLOCK_BYTES / 32, threads * MESH_CHUNK_RECORDS);
+    write_blocks(file, num_lines, block_lines, [&](size_t first, size_t last, std::vector<std::string>& pieces) {
+        pack_parallel(first, last, MESH_CHUNK_RECORDS, 0, pieces, threads, [&](size_t begin, size_t end, std::string& piece) {
+            piece.resize((end - begin) * OBJ_MAX_LINE);
+            char* out = &piece[0];
+            char* limit = out + piece.size();
+            for (size_t n = begin; n < end; ++n) {
+                out = n < num_vertices ? format_vertex(out, limit, vertList[n])
+                                       : format_face(out, limit, faceList[n - num_vertices]);
+            }
+            piece.resize(out - piece.data());
+        });
+    });
+
+    return finish_output(file, filename);
+}
+
+// ============================================================================
+// PLY
+// ============================================================================
+
+bool save_ply(const char* filename,
+              const std::vector<Vec3f>& vertList,
+              const std::vector<Vec3ui>& faceList,
+              const std::string& comment,
+              int num_threads) {
+    std::ofstream file;
+    if (!open_output(file, filename)) return false;
+
+    std::string header = "ply\nformat binary_little_endian 1.0\n";
+    header += comment_lines(comment, "comment ");
+    header += "element vertex " + std::to_string(vertList.size()) + "\n";
+    header += "property float x\nproperty float y\nproperty float z\n";
+    header += "element face " + std::to_string(faceList.size()) + "\n";
+    header += "property list uchar uint vertex_indices\nend_header\n";
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    // Vertices: the array as is, in one write
+    file.write(reinterpret_cast<const char*>(vertList.data()),
+               static_cast<std::streamsize>(vertList.size() * sizeof(Vec3f)));
+
+    // Faces: count byte plus three indices, packed in blocks
+    const unsigned int threads = sdfgen::resolve_thread_count(num_threads);
+    write_blocks(file, faceList.size(), MESH_BLOCK_BYTES / PLY_FACE_SIZE,
+                 [&](size_t first, size_t last, std::vector<std::string>& pieces) {
+        pack_parallel(first, last, MESH_CHUNK_RECORDS, PLY_FACE_SIZE, pieces, threads,
+                      [&](size_t begin, size_t end, std::string& piece) {
+            char* out = &piece[0];
+            for (size_t n = begin; n < end; ++n, out += PLY_FACE_SIZE) {
+                out[0] = 3;
+                std::memcpy(out + 1, &faceList[n][0], 3 * sizeof(unsigned int));
+            }
+        });
+    });
+
+    return finish_output(file, filename);
+}
+
+// ============================================================================
+// STL
+// ============================================================================
+
+bool save_stl(const char* filename,
+              const std::vector<Vec3f>& vertList,
+              const std::vector<Vec3ui>& faceList,
+              const std::string& comment,
+              int num_threads) {
+    if (faceList.size() > 0xffffffffull) {
+        std::cerr << "ERROR: Binary STL holds at most 2^32 - 1 triangles" << std::endl;
+        return false;
+    }
+    const size_t num_vertices = vertList.size();
+    for (const Vec3ui& f : faceList) {
+        if (f[0] >= num_vertices || f[1] >= num_vertices || f[2] >= num_vertices) {
+            std::cerr << "ERROR: Triangle vertex index out of range in " << filename << std::endl;
+            return false;
+        }
+    }
+
+    std::ofstream file;
+    if (!open_output(file, filename)) return false;
+
+    // Header: comment text padded with zeros (must not start with "solid"), then the count
+    char header[STL_HEADER_BYTES + sizeof(uint32_t)] = {};
+    std::string text = comment.compare(0, 5, "solid") == 0 ? "mesh " + comment : comment;
+    std::memcpy(header, text.data(), std::min(text.size(), STL_HEADER_BYTES));
+    uint32_t count = static_cast<uint32_t>(faceList.size());
+    std::memcpy(header + STL_HEADER_BYTES, &count, sizeof(count));
+    file.write(header, sizeof(header));
+
+    const unsigned int threads = sdfgen::resolve_thread_count(num_threads);
+    write_blocks(file, faceList.size(), MESH_BLOCK_BYTES / STL_RECORD_SIZE,
+                 [&](size_t first, size_t last, std::vector<std::string>& pieces) {
+        pack_parallel(first, last, MESH_CHUNK_RECORDS, STL_RECORD_SIZE, pieces, threads,
+                      [&](size_t begin, size_t end, std::string& piece) {
+            char* out = &piece[0];
+            for (size_t n = begin; n < end; ++n, out += STL_RECORD_SIZE) {
+                const Vec3f& a = vertList[faceList[n][0]];
+                const Vec3f& b = vertList[faceList[n][1]];
+                const Vec3f& c = vertList[faceList[n][2]];
+                Vec3f normal = cross(b - a, c - a);
+                float length = mag(normal);
+                normal = length > 0.0f ? normal / length : Vec3f(0.0f, 0.0f, 0.0f);
+                std::memcpy(out, &normal[0], sizeof(Vec3f));
+                std::memcpy(out + 12, &a[0], sizeof(Vec3f));
+                std::memcpy(out + 24, &b[0], sizeof(Vec3f));
+                std::memcpy(out + 36, &c[0], sizeof(Vec3f));
+                out[48] = out[49] = 0;
+            }
+        });
+    });
+
+    return finish_output(file, filename);
+}
+
+bool save_mesh(const char* filename,
+               const std::vector<Vec3f>& vertList,
+               const std::vector<Vec3ui>& faceList,
+               const std::string& comment,
+               int num_threads) {
+    std::string ext = get_extension(filename);
+    if (ext == ".obj") return save_obj(filename, vertList, faceList, comment, num_threads);
+    if (ext == ".ply") return save_ply(filename, vertList, faceList, comment, num_threads);
+    if (ext == ".stl") return save_stl(filename, vertList, faceList, comment, num_threads);
+    std::cerr << "ERROR: Unsupported mesh output format: " << filename << " (use .obj, .ply or .stl)" << std::endl;
+    return false;
+}
+
+} // namespace meshio
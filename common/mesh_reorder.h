@@ -0,0 +1,104 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "radix_sort.h"
+#include "thread_pool.h"
+#include "vec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace sdfgen {
+
+/**
+ * @brief A copy of a mesh with triangles in spatial order and vertices renumbered to match
+ */
+struct SpatialOrder {
+    std::vector<Vec3ui> tri;            ///< Triangles sorted by the Morton code of their centroid cell
+    std::vector<Vec3f> x;               ///< Referenced vertices in order of first use by tri
+    std::vector<unsigned int> original; ///< Index in the input mesh of each reordered triangle
+};
+
+/** @brief Spread the low 21 bits of v so that bit b lands on bit 3b */
+inline uint64_t morton_spread(uint64_t v)
+{
+    v &= 0x1fffff;
+    v = (v | (v << 32)) & 0x1f00000000ffffULL;
+    v = (v | (v << 16)) & 0x1f0000ff0000ffULL;
+    v = (v | (v << 8)) & 0x100f00f00f00f00fULL;
+    v = (v | (v << 4)) & 0x10c30c30c30c30c3ULL;
+    v = (v | (v << 2)) & 0x1249249249249249ULL;
+    return v;
+}
+
+/**
+ * @brief Sort triangles along a Morton curve through the grid and renumber their vertices
+ *
+ * Each triangle is keyed by the grid cell of its centroid (clamped to the grid), so
+ * triangles that touch the same cells end up next to each other and a near-band pass over
+ * the result writes the grid in a cache-friendly order. The sort is stable: triangles in
+ * the same cell keep their input order. Corner order within a triangle is kept, so every
+ * distance and crossing computed from the copy is bit-identical to the input's.
+ *
+ * @param tri Input triangles
+ * @param x Input vertices
+ * @param origin Grid origin
+ * @param dx Grid cell spacing
+ * @param ni Grid cells in X
+ * @param nj Grid cells in Y
+ * @param nk Grid cells in Z
+ * @param out Reordered mesh (replaced)
+ * @param num_threads Number of threads, 0 = auto-detect
+ */
+inline void spatial_reorder(const std::vector<Vec3ui>& tri, const std::vector<Vec3f>& x,
+                            const Vec3f& origin, float dx, int ni, int nj, int nk,
+                            SpatialOrder& out, int num_threads = 0)
+{
+    const size_t num_tri = tri.size();
+    ThreadPool& pool = ThreadPool::global();
+    const unsigned int threads = resolve_thread_count(num_threads);
+    const int axis_bits = std::min(21, bits_for((uint64_t)std::max(std::max(ni, nj), std::max(nk, 1)) - 1));
+    const int64_t axis_max = (int64_t(1) << axis_bits) - 1;
+
+    std::vector<uint64_t> keys(num_tri);
+    out.original.resize(num_tri);
+    const size_t chunk = 1 << 14;
+    pool.parallel_for((int)((num_tri + chunk - 1) / chunk), threads, [&](int c) {
+        size_t end = std::min(num_tri, (c + 1) * chunk);
+        for (size_t t = c * chunk; t < end; ++t) {
+            Vec3f centroid = (x[tri[t][0]] + x[tri[t][1]] + x[tri[t][2]]) / 3.0f;
+            uint64_t code = 0;
+            for (int a = 0; a < 3; ++a) {
+                float f = std::floor((centroid[a] - origin[a]) / dx);
+                int64_t cell = f > 0 ? (int64_t)std::min(f, (float)axis_max) : 0; // NaN lands on 0
+                code |= morton_spread((uint64_t)cell) << a;
+            }
+            keys[t] = code;
+            out.original[t] = (unsigned int)t;
+        }
+    });
+    radix_sort(keys, &out.original, 3 * axis_bits, num_threads);
+
+    // Renumber vertices in order of first use so consecutive triangles read nearby vertices
+    const unsigned int unused = ~0u;
+    std::vector<unsigned int> remap(x.size(), unused);
+    out.tri.resize(num_tri);
+    out.x.clear();
+    for (size_t n = 0; n < num_tri; ++n) {
+        const Vec3ui& face = tri[out.original[n]];
+        for (int c = 0; c < 3; ++c) {
+            unsigned int& v = remap[face[c]];
+            if (v == unused) {
+                v = (unsigned int)out.x.size();
+                out.x.push_back(x[face[c]]);
+            }
+            out.tri[n][c] = v;
+        }
+    }
+}
+
+} // namespace sdfgen
@@ -4,30 +4,18 @@
 // Licensed under the MIT License - see LICENSE file
 
 #include "mesh_repair.h"
+#include "mesh_io.h"
+#include "log.h"
+#include "thread_pool.h"
+#include "radix_sort.h"
 #include <iostream>
 #include <algorithm>
+#include <climits>
 #include <cmath>
-#include <tuple>
+#include <cstdint>
 
 namespace meshio {
 
-// Edge represented by sorted vertex indices
-struct Edge {
-    unsigned int v1, v2;
-    Edge(unsigned int a, unsigned int b) : v1(std::min(a,b)), v2(std::max(a,b)) {}
-    bool operator<(const Edge& o) const {
-        if (v1 != o.v1) return v1 < o.v1;
-        return v2 < o.v2;
-    }
-};
-
-// Internal structure for detailed analysis
-struct DetailedAnalysis {
-    MeshAnalysis summary;
-    std::map<Edge, std::vector<int>> edge_triangles;
-    std::vector<std::vector<unsigned int>> boundary_loops;
-};
-
 static Vec3f cross(const Vec3f& a, const Vec3f& b) {
     return Vec3f(a[1]*b[2] - a[2]*b[1],
                  a[2]*b[0] - a[0]*b[2],
@@ -38,45 +26,88 @@ static float length(const Vec3f& v) {
     return std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 }
 
-static DetailedAnalysis analyze_mesh_detailed(const std::vector<Vec3f>& vertices,
-                                               const std::vector<Vec3ui>& faces) {
-    DetailedAnalysis result;
-    int numTriangles = faces.size();
-
-    // Count triangles per edge
-    for (int t = 0; t < numTriangles; t++) {
-        unsigned int i0 = faces[t][0];
-        unsigned int i1 = faces[t][1];
-        unsigned int i2 = faces[t][2];
-
-        result.edge_triangles[Edge(i0, i1)].push_back(t);
-        result.edge_triangles[Edge(i1, i2)].push_back(t);
-        result.edge_triangles[Edge(i2, i0)].push_back(t);
-    }
+namespace {
+
+const unsigned int NO_SLOT = UINT_MAX;
+const size_t TOPOLOGY_MIN_RANGE = 1 << 16;
+
+/**
+ * @brief Sorted packed edge keys of all triangle sides, (lower << index_bits) | higher
+ *
+ * One key per triangle side, so an edge appears once per adjacent triangle and run lengths
+ * of the sorted array are the triangle counts per edge.
+ */
+std::vector<uint64_t> sorted_edge_keys(const std::vector<Vec3ui>& faces, int index_bits, int num_threads) {
+    sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+    const unsigned int threads = sdfgen::resolve_thread_count(num_threads);
+    const size_t num_faces = faces.size();
+    const size_t num_ranges = std::max<size_t>(1, std::min<size_t>(threads, num_faces / TOPOLOGY_MIN_RANGE));
+    std::vector<uint64_t> keys(3 * num_faces);
+    pool.parallel_for((int)num_ranges, threads, [&](int r) {
+        for (size_t t = num_faces * r / num_ranges; t < num_faces * (r + 1) / num_ranges; ++t) {
+            for (int c = 0; c < 3; ++c) {
+                uint64_t a = faces[t][c], b = faces[t][(c + 1) % 3];
+                keys[3 * t + c] = (std::min(a, b) << index_bits) | std::max(a, b);
+            }
+        }
+    });
+    sdfgen::radix_sort(keys, 2 * index_bits, num_threads);
+    return keys;
+}
 
-    result.summary.total_edges = result.edge_triangles.size();
+} // namespace
 
-    // Classify edges and build boundary adjacency
-    std::set<unsigned int> boundary_vertices;
-    std::map<unsigned int, std::vector<unsigned int>> boundary_adj;
+MeshTopology analyze_mesh_topology(const std::vector<Vec3f>& vertices,
+                                   const std::vector<Vec3ui>& faces,
+                                   int num_threads) {
+    MeshTopology result;
 
-    for (auto& kv : result.edge_triangles) {
-        int count = kv.second.size();
-        if (count == 1) {
+    // Vertex index range; faces may reference indices past the vertex list
+    unsigned int max_index = vertices.empty() ? 0 : (unsigned int)(vertices.size() - 1);
+    for (const Vec3ui& face : faces) {
+        max_index = std::max(max_index, std::max(face[0], std::max(face[1], face[2])));
+    }
+    const int index_bits = std::max(1, sdfgen::bits_for(max_index));
+    const uint64_t index_mask = (uint64_t(1) << index_bits) - 1;
+
+    // Classify edges by their run length in the sorted side list
+    std::vector<uint64_t> keys = sorted_edge_keys(faces, index_bits, num_threads);
+    std::vector<uint64_t> boundary_links;
+    for (size_t i = 0; i < keys.size(); ) {
+        size_t run = i + 1;
+        while (run < keys.size() && keys[run] == keys[i]) ++run;
+        result.summary.total_edges++;
+        if (run - i == 1) {
             result.summary.boundary_edges++;
-            boundary_vertices.insert(kv.first.v1);
-            boundary_vertices.insert(kv.first.v2);
-            boundary_adj[kv.first.v1].push_back(kv.first.v2);
-            boundary_adj[kv.first.v2].push_back(kv.first.v1);
-        } else if (count > 2) {
+            uint64_t v1 = keys[i] >> index_bits, v2 = keys[i] & index_mask;
+            boundary_links.push_back((v1 << index_bits) | v2);
+            boundary_links.push_back((v2 << index_bits) | v1);
+        } else if (run - i > 2) {
             result.summary.non_manifold_edges++;
         }
+        i = run;
+    }
+    std::vector<uint64_t>().swap(keys);
+
+    // Boundary adjacency: links grouped by source vertex, neighbours in ascending order
+    sdfgen::radix_sort(boundary_links, 2 * index_bits, num_threads);
+    std::vector<unsigned int> boundary_vertices;
+    std::vector<size_t> adjacency_begin;
+    std::vector<unsigned int> slot(boundary_links.empty() ? 0 : (size_t)max_index + 1, NO_SLOT);
+    for (size_t i = 0; i < boundary_links.size(); ++i) {
+        unsigned int v = (unsigned int)(boundary_links[i] >> index_bits);
+        if (boundary_vertices.empty() || boundary_vertices.back() != v) {
+            slot[v] = (unsigned int)boundary_vertices.size();
+            boundary_vertices.push_back(v);
+            adjacency_begin.push_back(i);
+        }
     }
+    adjacency_begin.push_back(boundary_links.size());
 
     // Find boundary loops (holes)
-    std::set<unsigned int> visited;
+    std::vector<char> visited(slot.size(), 0);
     for (unsigned int startV : boundary_vertices) {
-        if (visited.count(startV)) continue;
+        if (visited[startV]) continue;
 
         std::vector<unsigned int> loop;
         unsigned int current = startV;
@@ -84,12 +115,13 @@ static DetailedAnalysis analyze_mesh_detailed(const std::vector<Vec3f>& vertices
 
         while (true) {
             loop.push_back(current);
-            visited.insert(current);
+            visited[current] = 1;
 
             // Find next unvisited boundary neighbor
             unsigned int next = UINT_MAX;
-            for (unsigned int adj : boundary_adj[current]) {
-                if (adj != prev && (visited.count(adj) == 0 || adj == startV)) {
+            for (size_t a = adjacency_begin[slot[current]]; a < adjacency_begin[slot[current] + 1]; ++a) {
+                unsigned int adj = (unsigned int)(boundary_links[a] & index_mask);
+                if (adj != prev && (!visited[adj] || adj == startV)) {
                     next = adj;
                     break;
                 }
@@ -114,7 +146,7 @@ static DetailedAnalysis analyze_mesh_detailed(const std::vector<Vec3f>& vertices
 
 MeshAnalysis analyze_mesh(const std::vector<Vec3f>& vertices,
                           const std::vector<Vec3ui>& faces) {
-    return analyze_mesh_detailed(vertices, faces).summary;
+    return analyze_mesh_topology(vertices, faces).summary;
 }
 
 void print_mesh_analysis(const MeshAnalysis& analysis, bool verbose) {
@@ -133,7 +165,8 @@ void print_mesh_analysis(const MeshAnalysis& analysis, bool verbose) {
 
     if (!analysis.is_watertight) {
         std::cout << "\n  WARNING: Mesh is not watertight. SDF sign determination may be incorrect.\n";
-        std::cout << "           Use --fix flag to attempt automatic hole filling.\n";
+        std::cout << "           Use --fix flag to attempt automatic hole filling,\n";
+        std::cout << "           or --winding for hole-tolerant winding-number signs.\n";
     }
 }
 
@@ -185,79 +218,132 @@ static std::vector<Vec3ui> triangulate_hole(const std::vector<unsigned int>& loo
     return result;
 }
 
+namespace {
+
+const uint32_t NO_VERTEX = 0xffffffffu;
+const size_t WELD_MIN_RANGE = 1 << 16;
+
+size_t table_size_for(size_t count) {
+    size_t size = 16;
+    while (size < 2 * count) size <<= 1;
+    return size;
+}
+
+int cell_coordinate(float value, float inv_cell) {
+    double c = std::floor((double)value * inv_cell);
+    return (int)std::max(-2147483647.0, std::min(2147483647.0, c));
+}
+
+// Open-addressing table entry for one weld cell: its representatives form a list in index order
+struct WeldCell {
+    int x, y, z;
+    uint32_t head = NO_VERTEX;
+    uint32_t tail = NO_VERTEX;
+};
+
+uint64_t cell_hash(int x, int y, int z) {
+    uint64_t h = (uint32_t)x * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 29) ^ (uint32_t)y) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 31) ^ (uint32_t)z) * 0x94D049BB133111EBull;
+    return h ^ (h >> 32);
+}
+
+WeldCell* find_cell(std::vector<WeldCell>& table, int x, int y, int z, bool insert) {
+    const size_t mask = table.size() - 1;
+    for (size_t slot = cell_hash(x, y, z) & mask; ; slot = (slot + 1) & mask) {
+        WeldCell& cell = table[slot];
+        if (cell.head == NO_VERTEX) {
+            if (!insert) return nullptr;
+            cell.x = x;
+            cell.y = y;
+            cell.z = z;
+            return &cell;
+        }
+        if (cell.x == x && cell.y == y && cell.z == z) return &cell;
+    }
+}
+
+} // namespace
+
 int weld_vertices(std::vector<Vec3f>& vertices,
                   std::vector<Vec3ui>& faces,
-                  float tolerance) {
+                  float tolerance,
+                  int num_threads) {
     if (tolerance <= 0) return 0;
 
+    const size_t n = vertices.size();
+    std::vector<uint32_t> first = find_exact_duplicates(vertices, num_threads);
+    size_t unique = 0;
+    for (size_t i = 0; i < n; ++i) unique += first[i] == i;
+
+    // Greedy pass over the distinct positions in index order: each one joins the lowest-index
+    // representative within tolerance or becomes a representative itself. With cells of twice
+    // the tolerance, such a representative lies in the vertex's cell or in the neighbour
+    // towards the nearer half on each axis, so 8 cells are probed. Exact copies of a position
+    // always make the same choice as its first occurrence, which is why they can be skipped.
+    const float inv_cell = 0.5f / tolerance;
+    std::vector<WeldCell> cells(table_size_for(unique));
+    std::vector<uint32_t> next_in_cell(n, NO_VERTEX);
+    std::vector<uint32_t> vertex_map(n);
     std::vector<Vec3f> new_vertices;
-    std::vector<int> vertex_map(vertices.size(), -1);
-
-    // Spatial hash grid for fast lookup
-    float inv_tol = 1.0f / tolerance;
-    std::map<std::tuple<int,int,int>, std::vector<int>> grid;
-
-    int welded = 0;
+    new_vertices.reserve(unique);
 
-    for (size_t i = 0; i < vertices.size(); i++) {
+    for (size_t i = 0; i < n; ++i) {
+        if (first[i] != i) {
+            vertex_map[i] = vertex_map[first[i]];
+            continue;
+        }
         const Vec3f& v = vertices[i];
-        int gx = (int)std::floor(v[0] * inv_tol);
-        int gy = (int)std::floor(v[1] * inv_tol);
-        int gz = (int)std::floor(v[2] * inv_tol);
-
-        // Check neighboring cells for existing vertex
-        int found_idx = -1;
-        for (int dx = -1; dx <= 1 && found_idx < 0; dx++) {
-            for (int dy = -1; dy <= 1 && found_idx < 0; dy++) {
-                for (int dz = -1; dz <= 1 && found_idx < 0; dz++) {
-                    auto key = std::make_tuple(gx+dx, gy+dy, gz+dz);
-                    auto it = grid.find(key);
-                    if (it != grid.end()) {
-                        for (int idx : it->second) {
-                            Vec3f diff(new_vertices[idx][0] - v[0],
-                                       new_vertices[idx][1] - v[1],
-                                       new_vertices[idx][2] - v[2]);
-                            if (length(diff) < tolerance) {
-                                found_idx = idx;
-                                break;
-                            }
-                        }
-                    }
+        int cell[3], side[3];
+        for (int a = 0; a < 3; ++a) {
+            cell[a] = cell_coordinate(v[a], inv_cell);
+            side[a] = (double)v[a] * inv_cell - cell[a] < 0.5 ? -1 : 1;
+        }
+
+        uint32_t found = NO_VERTEX;
+        for (int corner = 0; corner < 8; ++corner) {
+            const WeldCell* probe = find_cell(cells,
+                                              cell[0] + ((corner & 1) ? side[0] : 0),
+                                              cell[1] + ((corner & 2) ? side[1] : 0),
+                                              cell[2] + ((corner & 4) ? side[2] : 0), false);
+            if (!probe) continue;
+            for (uint32_t r = probe->head; r != NO_VERTEX && r < found; r = next_in_cell[r]) {
+                if (dist(vertices[r], v) < tolerance) {
+                    found = r;
+                    break;
                 }
             }
         }
 
-        if (found_idx >= 0) {
-            vertex_map[i] = found_idx;
-            welded++;
+        if (found != NO_VERTEX) {
+            vertex_map[i] = vertex_map[found];
         } else {
-            int new_idx = new_vertices.size();
+            vertex_map[i] = (uint32_t)new_vertices.size();
             new_vertices.push_back(v);
-            vertex_map[i] = new_idx;
-            auto key = std::make_tuple(gx, gy, gz);
-            grid[key].push_back(new_idx);
+            WeldCell* home = find_cell(cells, cell[0], cell[1], cell[2], true);
+            if (home->head == NO_VERTEX) home->head = (uint32_t)i;
+            else next_in_cell[home->tail] = (uint32_t)i;
+            home->tail = (uint32_t)i;
         }
     }
 
     // Update face indices
-    for (auto& face : faces) {
-        face[0] = vertex_map[face[0]];
-        face[1] = vertex_map[face[1]];
-        face[2] = vertex_map[face[2]];
-    }
+    sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+    const unsigned int threads = sdfgen::resolve_thread_count(num_threads);
+    const size_t num_ranges = std::max<size_t>(1, std::min<size_t>(threads, faces.size() / WELD_MIN_RANGE));
+    pool.parallel_for((int)num_ranges, threads, [&](int r) {
+        for (size_t f = faces.size() * r / num_ranges; f < faces.size() * (r + 1) / num_ranges; ++f) {
+            for (int c = 0; c < 3; ++c) faces[f][c] = vertex_map[faces[f][c]];
+        }
+    });
 
     // Remove degenerate triangles
-    std::vector<Vec3ui> valid_faces;
-    for (const auto& face : faces) {
-        if (face[0] != face[1] && face[1] != face[2] && face[0] != face[2]) {
-            valid_faces.push_back(face);
-        }
-    }
+    faces.erase(std::remove_if(faces.begin(), faces.end(), [](const Vec3ui& face) {
+                    return face[0] == face[1] || face[1] == face[2] || face[0] == face[2];
+                }), faces.end());
 
     vertices = std::move(new_vertices);
-    faces = std::move(valid_faces);
-
-    return welded;
+    return (int)(n - vertices.size());
 }
 
 int repair_mesh(std::vector<Vec3f>& vertices,
@@ -267,25 +353,29 @@ int repair_mesh(std::vector<Vec3f>& vertices,
     if (weld_tolerance > 0) {
         int welded = weld_vertices(vertices, faces, weld_tolerance);
         if (welded > 0) {
-            std::cout << "  Welded " << welded << " duplicate vertices\n";
+            sdfgen::log_stream() << "  Welded " << welded << " duplicate vertices\n";
         }
     }
 
     // Analyze to find holes
-    DetailedAnalysis analysis = analyze_mesh_detailed(vertices, faces);
+    return repair_mesh(vertices, faces, analyze_mesh_topology(vertices, faces));
+}
 
-    if (analysis.summary.is_watertight) {
-        std::cout << "  Mesh is already watertight, no repair needed\n";
+int repair_mesh(std::vector<Vec3f>& vertices,
+                std::vector<Vec3ui>& faces,
+                const MeshTopology& topology) {
+    if (topology.summary.is_watertight) {
+        sdfgen::log_stream() << "  Mesh is already watertight, no repair needed\n";
         return 0;
     }
 
-    if (analysis.summary.non_manifold_edges > 0) {
+    if (topology.summary.non_manifold_edges > 0) {
         std::cerr << "  WARNING: Mesh has non-manifold edges, repair may not succeed\n";
     }
 
     // Fill holes
     int holes_filled = 0;
-    for (const auto& loop : analysis.boundary_loops) {
+    for (const auto& loop : topology.boundary_loops) {
         std::vector<Vec3ui> new_tris = triangulate_hole(loop, vertices);
         for (const auto& tri : new_tris) {
             faces.push_back(tri);
@@ -293,14 +383,14 @@ int repair_mesh(std::vector<Vec3f>& vertices,
         holes_filled++;
     }
 
-    std::cout << "  Filled " << holes_filled << " holes\n";
+    sdfgen::log_stream() << "  Filled " << holes_filled << " holes\n";
 
     // Verify fix
     MeshAnalysis after = analyze_mesh(vertices, faces);
     if (after.is_watertight) {
-        std::cout << "  Mesh is now watertight\n";
+        sdfgen::log_stream() << "  Mesh is now watertight\n";
     } else {
-        std::cout << "  WARNING: Mesh still has " << after.num_holes << " holes after repair\n";
+        sdfgen::log_stream() << "  WARNING: Mesh still has " << after.num_holes << " holes after repair\n";
     }
 
     return holes_filled;
@@ -24,6 +24,31 @@ struct MeshAnalysis {
     bool is_watertight = false;
 };
 
+/**
+ * @brief Edge topology of a mesh: analysis summary plus the boundary loops repair fills
+ */
+struct MeshTopology {
+    MeshAnalysis summary;
+    std::vector<std::vector<unsigned int>> boundary_loops;  ///< Vertex chains of the holes (>= 3 vertices)
+};
+
+/**
+ * @brief Build the edge topology of a mesh
+ *
+ * Every triangle side becomes a packed 64-bit edge key; the keys are radix-sorted in
+ * parallel and the run lengths give the triangles per edge. Boundary edges are sorted once
+ * more into an adjacency list that the loop walk scans linearly. The result does not depend
+ * on num_threads, and can be passed to repair_mesh() to avoid analyzing the mesh twice.
+ *
+ * @param vertices Vertex positions
+ * @param faces Triangle indices (3 indices per triangle)
+ * @param num_threads Number of threads for the key sort, 0 = auto-detect
+ * @return Summary and boundary loops
+ */
+MeshTopology analyze_mesh_topology(const std::vector<Vec3f>& vertices,
+                                   const std::vector<Vec3ui>& faces,
+                                   int num_threads = 0);
+
 /**
  * @brief Analyze mesh for watertightness
  *
@@ -63,19 +88,42 @@ int repair_mesh(std::vector<Vec3f>& vertices,
                 std::vector<Vec3ui>& faces,
                 float weld_tolerance = 1e-5f);
 
+/**
+ * @brief Fill the holes of a mesh whose topology is already known
+ *
+ * Same as repair_mesh() without welding, but reuses the boundary loops of a previous
+ * analyze_mesh_topology() call on the same vertices and faces.
+ *
+ * @param vertices Vertex positions
+ * @param faces Triangle indices (new triangles appended)
+ * @param topology Topology of vertices and faces as passed in
+ * @return Number of holes filled
+ */
+int repair_mesh(std::vector<Vec3f>& vertices,
+                std::vector<Vec3ui>& faces,
+                const MeshTopology& topology);
+
 /**
  * @brief Weld duplicate vertices within tolerance
  *
  * Merges vertices that are within tolerance distance of each other.
  * Updates face indices to reference merged vertices.
  *
+ * Runs in linear time: bit-identical copies (3 per vertex in STL input) are collapsed first
+ * by a parallel hash pass, then the distinct positions are visited in index order against
+ * a flat spatial hash with cells of twice the tolerance. Each position joins the
+ * lowest-index kept vertex closer than tolerance, or is kept. Kept vertices stay in their
+ * original order and the result is independent of num_threads.
+ *
  * @param vertices Vertex positions (modified in-place, duplicates removed)
- * @param faces Triangle indices (updated to reference merged vertices)
+ * @param faces Triangle indices (updated to reference merged vertices, degenerate ones removed)
  * @param tolerance Maximum distance between vertices to merge
+ * @param num_threads Number of threads for the parallel passes, 0 = auto-detect
  * @return Number of vertices removed by welding
  */
 int weld_vertices(std::vector<Vec3f>& vertices,
                   std::vector<Vec3ui>& faces,
-                  float tolerance = 1e-5f);
+                  float tolerance = 1e-5f,
+                  int num_threads = 0);
 
 } // namespace meshio
@@ -0,0 +1,117 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "array3.h"
+#include "vec.h"
+
+namespace sdfgen {
+
+/**
+ * @brief Node of an OctreeLevelSet
+ *
+ * Children are stored as a block of 8 starting at child (-1 for leaves), ordered by
+ * octant: bit 0 selects +x, bit 1 +y, bit 2 +z. Corner values use the same numbering.
+ */
+struct OctreeNode {
+   int child;        /**< Index of the first child, or -1 for a leaf */
+   float value[8];   /**< Signed distance at the 8 corners */
+};
+
+/**
+ * @brief Adaptive signed distance field on an octree with corner samples per cell
+ *
+ * The root is a cube of 2^levels finest cells starting at origin; a cell at depth d has edge
+ * dx*2^(levels-d). Cells are refined down to dx only where the surface band can reach them,
+ * so far-field regions stay a few large cells. Every node, interior ones included, keeps its
+ * corner distances, so sample() can stop at any depth for a coarser level of detail.
+ * Neighbouring leaves of different sizes are not forced to agree on shared faces; the field
+ * is continuous within a leaf and exact at every corner.
+ */
+class OctreeLevelSet {
+public:
+   Vec3f origin;   /**< Lower corner of the root cube */
+   float dx;       /**< Edge of the finest cells */
+   int levels;     /**< Depth of the finest cells (root edge is dx*2^levels) */
+   int ni, nj, nk; /**< Extent of the requested grid in finest nodes (the root may be larger) */
+   std::vector<OctreeNode> nodes; /**< Node 0 is the root */
+
+   OctreeLevelSet() : dx(0), levels(0), ni(0), nj(0), nk(0) {}
+
+   /** @brief Edge length of the root cube */
+   float root_size() const { return dx*(float)(1<<levels); }
+
+   /** @brief Number of leaves */
+   size_t leaf_count() const
+   {
+      size_t leaves=0;
+      for(size_t n=0; n<nodes.size(); ++n) if(nodes[n].child<0) ++leaves;
+      return leaves;
+   }
+
+   /** @brief Deepest level that holds a leaf */
+   int depth() const
+   {
+      if(nodes.empty()) return 0;
+      std::vector<int> node_depth(nodes.size(), 0);
+      int deepest=0;
+      for(size_t n=0; n<nodes.size(); ++n){
+         if(nodes[n].child<0){ deepest=max(deepest, node_depth[n]); continue; }
+         for(int c=0; c<8; ++c) node_depth[nodes[n].child+c]=node_depth[n]+1;
+      }
+      return deepest;
+   }
+
+   /** @brief Bytes held by the node array */
+   size_t memory_bytes() const { return nodes.size()*sizeof(OctreeNode); }
+
+   /**
+    * @brief Trilinear signed distance at a world-space point
+    *
+    * Descends to the leaf containing p (points outside the root are clamped onto it) and
+    * interpolates its corners.
+    *
+    * @param p Query point
+    * @param max_depth Stop at this depth for a coarser answer (-1 = leaves)
+    * @return Interpolated signed distance
+    */
+   float sample(const Vec3f &p, int max_depth=-1) const
+   {
+      if(nodes.empty()) return 0;
+      float size=root_size();
+      float fx=clamp((p[0]-origin[0])/size, 0.f, 1.f);
+      float fy=clamp((p[1]-origin[1])/size, 0.f, 1.f);
+      float fz=clamp((p[2]-origin[2])/size, 0.f, 1.f);
+      int n=0, d=0;
+      while(nodes[n].child>=0 && d!=max_depth){
+         int octant=(fx>=0.5f ? 1 : 0) | (fy>=0.5f ? 2 : 0) | (fz>=0.5f ? 4 : 0);
+         fx=(fx>=0.5f) ? 2*fx-1 : 2*fx;
+         fy=(fy>=0.5f) ? 2*fy-1 : 2*fy;
+         fz=(fz>=0.5f) ? 2*fz-1 : 2*fz;
+         n=nodes[n].child+octant;
+         ++d;
+      }
+      const float *v=nodes[n].value;
+      return trilerp(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], fx, fy, fz);
+   }
+
+   /**
+    * @brief Sample onto a regular grid (export to the dense pipeline)
+    * @param phi Output grid (resized to nx*ny*nz)
+    * @param grid_origin World position of node (0,0,0)
+    * @param grid_dx Node spacing
+    * @param max_depth Level of detail passed to sample()
+    */
+   void resample(Array3f &phi, const Vec3f &grid_origin, float grid_dx, int nx, int ny, int nz, int max_depth=-1) const
+   {
+      phi.resize(nx, ny, nz);
+      for(int k=0; k<nz; ++k) for(int j=0; j<ny; ++j) for(int i=0; i<nx; ++i)
+         phi(i,j,k)=sample(grid_origin+grid_dx*Vec3f((float)i, (float)j, (float)k), max_depth);
+   }
+};
+
+} // namespace sdfgen
@@ -0,0 +1,65 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#include "phase_trace.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace sdfgen {
+
+PhaseTrace::PhaseTrace() : start_(std::chrono::steady_clock::now()) {}
+
+PhaseHook PhaseTrace::hook() {
+    return [this](GenerationPhase phase, bool begin) { record(phase, begin); };
+}
+
+void PhaseTrace::record(GenerationPhase phase, bool begin) {
+    Event event;
+    event.phase = phase;
+    event.begin = begin;
+    event.us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_).count();
+    event.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back(event);
+}
+
+size_t PhaseTrace::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.size();
+}
+
+bool PhaseTrace::write_json(const std::string& filename) const {
+    std::ofstream outfile(filename.c_str());
+    if (!outfile) {
+        std::cerr << "ERROR: Failed to open file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    // Thread ids as small integers in order of first appearance
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<size_t> threads;
+    outfile << "{\"traceEvents\": [";
+    outfile.precision(3);
+    outfile << std::fixed;
+    for (size_t n = 0; n < events_.size(); ++n) {
+        const Event& event = events_[n];
+        size_t tid = std::find(threads.begin(), threads.end(), event.thread) - threads.begin();
+        if (tid == threads.size()) threads.push_back(event.thread);
+        outfile << (n ? ",\n  " : "\n  ") << "{\"name\": \"" << phase_name(event.phase)
+                << "\", \"cat\": \"sdfgen\", \"ph\": \"" << (event.begin ? 'B' : 'E') << "\", \"ts\": " << event.us
+                << ", \"pid\": 1, \"tid\": " << tid + 1 << "}";
+    }
+    outfile << "\n]}\n";
+    outfile.close();
+    if (outfile.fail()) {
+        std::cerr << "ERROR: Failed to write trace file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace sdfgen
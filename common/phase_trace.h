@@ -0,0 +1,54 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "sdfgen_options.h"
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sdfgen {
+
+/**
+ * @brief Records generation phases as Chrome trace events
+ *
+ * Pass hook() as GenerationOptions::phase_hook (one trace can serve several calls and
+ * threads), then write_json() a file that chrome://tracing and Perfetto open. Each event
+ * carries the calling thread, so concurrent generations appear on separate rows.
+ */
+class PhaseTrace {
+public:
+    PhaseTrace();
+
+    /** @brief Hook recording into this trace; the trace must outlive every call using it */
+    PhaseHook hook();
+
+    /** @brief Number of begin and end events recorded so far */
+    size_t size() const;
+
+    /**
+     * @brief Write the events as {"traceEvents": [...]} with microsecond timestamps
+     * @return true on success, false on error
+     */
+    bool write_json(const std::string& filename) const;
+
+private:
+    struct Event {
+        GenerationPhase phase;
+        bool begin;
+        double us;       // Since construction
+        size_t thread;   // Hash of the recording thread's id
+    };
+
+    void record(GenerationPhase phase, bool begin);
+
+    std::chrono::steady_clock::time_point start_;
+    mutable std::mutex mutex_;
+    std::vector<Event> events_;
+};
+
+} // namespace sdfgen
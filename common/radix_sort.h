@@ -0,0 +1,87 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sdfgen {
+
+/**
+ * @brief Stable parallel LSD radix sort of unsigned 64-bit keys, optionally carrying a payload
+ *
+ * Sorts on the low key_bits bits only (higher bits must be zero), 11 bits per pass. Each pass
+ * splits the input into one contiguous range per thread, counts digits per range and scatters
+ * with bucket-major offsets, so equal keys keep their input order and the result is
+ * independent of num_threads.
+ *
+ * @param keys Keys to sort in place
+ * @param values Optional payload permuted with the keys (nullptr or the same size as keys)
+ * @param key_bits Number of significant low bits in every key (0..64)
+ * @param num_threads Number of threads, 0 = auto-detect
+ */
+template<class Value>
+void radix_sort(std::vector<uint64_t>& keys, std::vector<Value>* values, int key_bits, int num_threads = 0)
+{
+    const int DIGIT_BITS = 11;
+    const size_t DIGITS = size_t(1) << DIGIT_BITS;
+    const size_t MIN_RANGE = 1 << 16;
+
+    const size_t n = keys.size();
+    if (n < 2 || key_bits <= 0) return;
+    ThreadPool& pool = ThreadPool::global();
+    const unsigned int threads = resolve_thread_count(num_threads);
+    const size_t num_ranges = std::max<size_t>(1, std::min<size_t>(threads, n / MIN_RANGE));
+
+    std::vector<uint64_t> key_scratch(n);
+    std::vector<Value> value_scratch(values ? n : 0);
+    std::vector<size_t> offsets(num_ranges * DIGITS);
+    for (int shift = 0; shift < key_bits; shift += DIGIT_BITS) {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        pool.parallel_for((int)num_ranges, threads, [&](int r) {
+            size_t* counts = &offsets[r * DIGITS];
+            for (size_t i = n * r / num_ranges; i < n * (r + 1) / num_ranges; ++i) {
+                ++counts[(keys[i] >> shift) & (DIGITS - 1)];
+            }
+        });
+        size_t offset = 0;
+        for (size_t d = 0; d < DIGITS; ++d) {
+            for (size_t r = 0; r < num_ranges; ++r) {
+                size_t count = offsets[r * DIGITS + d];
+                offsets[r * DIGITS + d] = offset;
+                offset += count;
+            }
+        }
+        pool.parallel_for((int)num_ranges, threads, [&](int r) {
+            size_t* next = &offsets[r * DIGITS];
+            for (size_t i = n * r / num_ranges; i < n * (r + 1) / num_ranges; ++i) {
+                size_t slot = next[(keys[i] >> shift) & (DIGITS - 1)]++;
+                key_scratch[slot] = keys[i];
+                if (values) value_scratch[slot] = (*values)[i];
+            }
+        });
+        keys.swap(key_scratch);
+        if (values) values->swap(value_scratch);
+    }
+}
+
+/** @brief Key-only overload of radix_sort() */
+inline void radix_sort(std::vector<uint64_t>& keys, int key_bits, int num_threads = 0)
+{
+    radix_sort<char>(keys, nullptr, key_bits, num_threads);
+}
+
+/** @brief Number of bits needed to represent every value in [0, max_value] */
+inline int bits_for(uint64_t max_value)
+{
+    int bits = 0;
+    while (bits < 64 && (max_value >> bits) != 0) ++bits;
+    return bits;
+}
+
+} // namespace sdfgen
@@ -3,15 +3,61 @@
 // Licensed under the MIT License - see LICENSE file
 
 #include "sdf_io.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <climits>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <vector>
 
+namespace {
+
+// Buffered writes and reads move at least this much per call
+constexpr size_t SDF_BLOCK_BYTES = size_t(16) << 20;
+
+/**
+ * Copy i-planes [i0, i1) between the grid (i fastest) and a C-order buffer (k fastest).
+ * Work is split by j; within a row the copy runs over 32x32 (i, k) tiles so the strided
+ * side of the transpose stays in cache.
+ */
+void transpose_planes(float* grid, int ni, int nj, int nk, int i0, int i1, float* planes,
+                      bool to_grid, sdfgen::ThreadPool& pool, unsigned int threads) {
+    const int tile = 32;
+    const size_t plane = static_cast<size_t>(nj) * nk;
+    pool.parallel_for(nj, threads, [&](int j) {
+        for (int k0 = 0; k0 < nk; k0 += tile) {
+            int k1 = std::min(nk, k0 + tile);
+            for (int ib = i0; ib < i1; ib += tile) {
+                int ie = std::min(i1, ib + tile);
+                for (int k = k0; k < k1; ++k) {
+                    float* row = grid + static_cast<size_t>(ni) * (j + static_cast<size_t>(nj) * k);
+                    float* out = planes + static_cast<size_t>(j) * nk + k;
+                    for (int i = ib; i < ie; ++i) {
+                        if (to_grid) row[i] = out[(i - i0) * plane];
+                        else out[(i - i0) * plane] = row[i];
+                    }
+                }
+            }
+        }
+    });
+}
+
+// Planes per buffered block (at least one)
+int planes_per_block(int nj, int nk) {
+    size_t plane_bytes = static_cast<size_t>(nj) * nk * sizeof(float);
+    return static_cast<int>(std::max<size_t>(1, SDF_BLOCK_BYTES / plane_bytes));
+}
+
+} // namespace
+
 bool write_sdf_binary(const std::string& filename,
                       const Array3f& phi_grid,
                       const Vec3f& min_box,
                       float dx,
-                      int* out_inside_count) {
+                      int* out_inside_count,
+                      sdfgen::SdfLayout layout,
+                      int num_threads) {
     // Open file for binary writing
     std::ofstream outfile(filename.c_str(), std::ios::binary);
     if (!outfile) {
@@ -19,41 +65,44 @@ bool write_sdf_binary(const std::string& filename,
         return false;
     }
 
-    // Header: dimensions (3 x int32)
+    // Header: dimensions (3 x int32, Nx negated for native layout), bounds_min and bounds_max (3 x float32 each)
     int ni = phi_grid.ni;
     int nj = phi_grid.nj;
     int nk = phi_grid.nk;
-    outfile.write(reinterpret_cast<char*>(&ni), sizeof(int));
-    outfile.write(reinterpret_cast<char*>(&nj), sizeof(int));
-    outfile.write(reinterpret_cast<char*>(&nk), sizeof(int));
-
-    // Header: bounds_min (3 x float32)
-    float bounds_min_x = min_box[0];
-    float bounds_min_y = min_box[1];
-    float bounds_min_z = min_box[2];
-    outfile.write(reinterpret_cast<char*>(&bounds_min_x), sizeof(float));
-    outfile.write(reinterpret_cast<char*>(&bounds_min_y), sizeof(float));
-    outfile.write(reinterpret_cast<char*>(&bounds_min_z), sizeof(float));
-
-    // Header: bounds_max (3 x float32)
-    float bounds_max_x = min_box[0] + phi_grid.ni * dx;
-    float bounds_max_y = min_box[1] + phi_grid.nj * dx;
-    float bounds_max_z = min_box[2] + phi_grid.nk * dx;
-    outfile.write(reinterpret_cast<char*>(&bounds_max_x), sizeof(float));
-    outfile.write(reinterpret_cast<char*>(&bounds_max_y), sizeof(float));
-    outfile.write(reinterpret_cast<char*>(&bounds_max_z), sizeof(float));
+    int dims[3] = {layout == sdfgen::SdfLayout::Native ? -ni : ni, nj, nk};
+    float bounds[6] = {min_box[0], min_box[1], min_box[2],
+                       min_box[0] + ni * dx, min_box[1] + nj * dx, min_box[2] + nk * dx};
+    outfile.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    outfile.write(reinterpret_cast<const char*>(bounds), sizeof(bounds));
+
+    sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+    unsigned int threads = sdfgen::resolve_thread_count(num_threads);
+    const size_t total = phi_grid.a.size();
+    const float* data = phi_grid.a.data;
 
     // Data: SDF values as float32
-    // Write in C-order (last dimension varies fastest): for(i) for(j) for(k)
-    int inside_count = 0;
-    for (int i = 0; i < phi_grid.ni; ++i) {
-        for (int j = 0; j < phi_grid.nj; ++j) {
-            for (int k = 0; k < phi_grid.nk; ++k) {
-                float val = static_cast<float>(phi_grid(i, j, k));
-                if (val < 0.0f) inside_count++;
-                outfile.write(reinterpret_cast<char*>(&val), sizeof(float));
-            }
+    if (layout == sdfgen::SdfLayout::Native) {
+        // Native: the grid's memory as is, in one write
+        outfile.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(total * sizeof(float)));
+    } else if (total > 0) {
+        // C-order (last dimension varies fastest): transpose a block of i-planes while the
+        // previous block is being written
+        const int block = planes_per_block(nj, nk);
+        const size_t plane = static_cast<size_t>(nj) * nk;
+        std::vector<float> buffers[2];
+        std::future<void> pending;
+        for (int i0 = 0, n = 0; i0 < ni; i0 += block, n ^= 1) {
+            int i1 = std::min(ni, i0 + block);
+            std::vector<float>& buffer = buffers[n];
+            buffer.resize((i1 - i0) * plane);
+            transpose_planes(const_cast<float*>(data), ni, nj, nk, i0, i1, buffer.data(), false, pool, threads);
+            if (pending.valid()) pending.get();
+            pending = std::async(std::launch::async, [&outfile, &buffer]() {
+                outfile.write(reinterpret_cast<const char*>(buffer.data()),
+                              static_cast<std::streamsize>(buffer.size() * sizeof(float)));
+            });
         }
+        pending.get();
     }
 
     // Check for write errors
@@ -67,12 +116,39 @@ bool write_sdf_binary(const std::string& filename,
 
     // Return inside count if requested
     if (out_inside_count != nullptr) {
-        *out_inside_count = inside_count;
+        const size_t chunk = size_t(1) << 20;
+        int num_chunks = static_cast<int>((total + chunk - 1) / chunk);
+        std::vector<long long> counts(num_chunks, 0);
+        pool.parallel_for(num_chunks, threads, [&](int c) {
+            size_t end = std::min(total, (c + 1) * chunk);
+            long long count = 0;
+            for (size_t n = c * chunk; n < end; ++n) count += data[n] < 0.0f;
+            counts[c] = count;
+        });
+        long long inside_count = 0;
+        for (long long count : counts) inside_count += count;
+        *out_inside_count = static_cast<int>(inside_count);
     }
 
     return true;
 }
 
+std::future<bool> write_sdf_binary_async(const std::string& filename,
+                                         Array3f& phi_grid,
+                                         const Vec3f& min_box,
+                                         float dx,
+                                         sdfgen::SdfLayout layout,
+                                         int num_threads) {
+    std::shared_ptr<Array3f> grid = std::make_shared<Array3f>();
+    grid->a.swap(phi_grid.a);
+    std::swap(grid->ni, phi_grid.ni);
+    std::swap(grid->nj, phi_grid.nj);
+    std::swap(grid->nk, phi_grid.nk);
+    return std::async(std::launch::async, [filename, grid, min_box, dx, layout, num_threads]() {
+        return write_sdf_binary(filename, *grid, min_box, dx, nullptr, layout, num_threads);
+    });
+}
+
 bool read_sdf_binary(const std::string& filename,
                      Array3f& phi_grid,
                      Vec3f& min_box,
@@ -84,64 +160,344 @@ bool read_sdf_binary(const std::string& filename,
         return false;
     }
 
-    // Read header: dimensions (3 x int32)
-    int ni, nj, nk;
-    infile.read(reinterpret_cast<char*>(&ni), sizeof(int));
-    infile.read(reinterpret_cast<char*>(&nj), sizeof(int));
-    infile.read(reinterpret_cast<char*>(&nk), sizeof(int));
+    // Read header: dimensions (3 x int32), bounds_min and bounds_max (3 x float32 each)
+    int dims[3] = {0, 0, 0};
+    float bounds[6];
+    infile.read(reinterpret_cast<char*>(dims), sizeof(dims));
+    infile.read(reinterpret_cast<char*>(bounds), sizeof(bounds));
+
+    // Check if header reading was successful
+    if (infile.fail()) {
+        std::cerr << "ERROR: Failed to read SDF file header: " << filename << std::endl;
+        infile.close();
+        return false;
+    }
+
+    // A negated Nx marks native (i-fastest) data
+    bool native = dims[0] < 0 && dims[0] != INT_MIN;
+    int ni = native ? -dims[0] : dims[0];
+    int nj = dims[1];
+    int nk = dims[2];
 
     // Validate dimensions
     if (ni <= 0 || nj <= 0 || nk <= 0) {
         std::cerr << "ERROR: Invalid dimensions in SDF file: "
-                  << ni << "x" << nj << "x" << nk << std::endl;
+                  << dims[0] << "x" << nj << "x" << nk << std::endl;
         infile.close();
         return false;
     }
 
-    // Read header: bounds_min (3 x float32)
-    float bounds_min_x, bounds_min_y, bounds_min_z;
-    infile.read(reinterpret_cast<char*>(&bounds_min_x), sizeof(float));
-    infile.read(reinterpret_cast<char*>(&bounds_min_y), sizeof(float));
-    infile.read(reinterpret_cast<char*>(&bounds_min_z), sizeof(float));
+    // Store bounding box
+    min_box = Vec3f(bounds[0], bounds[1], bounds[2]);
+    max_box = Vec3f(bounds[3], bounds[4], bounds[5]);
 
-    // Read header: bounds_max (3 x float32)
-    float bounds_max_x, bounds_max_y, bounds_max_z;
-    infile.read(reinterpret_cast<char*>(&bounds_max_x), sizeof(float));
-    infile.read(reinterpret_cast<char*>(&bounds_max_y), sizeof(float));
-    infile.read(reinterpret_cast<char*>(&bounds_max_z), sizeof(float));
+    // Resize phi_grid to match dimensions
+    phi_grid.resize(ni, nj, nk);
 
-    // Check if header reading was successful
+    // Read data: SDF values as float32, straight into the grid or in blocks of C-order planes
+    if (native) {
+        infile.read(reinterpret_cast<char*>(phi_grid.a.data),
+                    static_cast<std::streamsize>(phi_grid.a.size() * sizeof(float)));
+    } else {
+        sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+        unsigned int threads = sdfgen::resolve_thread_count(0);
+        const int block = planes_per_block(nj, nk);
+        const size_t plane = static_cast<size_t>(nj) * nk;
+        std::vector<float> buffer;
+        for (int i0 = 0; i0 < ni && !infile.fail(); i0 += block) {
+            int i1 = std::min(ni, i0 + block);
+            buffer.resize((i1 - i0) * plane);
+            infile.read(reinterpret_cast<char*>(buffer.data()),
+                        static_cast<std::streamsize>(buffer.size() * sizeof(float)));
+            if (!infile.fail())
+                transpose_planes(phi_grid.a.data, ni, nj, nk, i0, i1, buffer.data(), true, pool, threads);
+        }
+    }
     if (infile.fail()) {
-        std::cerr << "ERROR: Failed to read SDF file header: " << filename << std::endl;
+        std::cerr << "ERROR: Failed to read SDF data (file truncated): " << filename << std::endl;
         infile.close();
         return false;
     }
 
-    // Store bounding box
-    min_box = Vec3f(bounds_min_x, bounds_min_y, bounds_min_z);
-    max_box = Vec3f(bounds_max_x, bounds_max_y, bounds_max_z);
+    infile.close();
+    return true;
+}
 
-    // Resize phi_grid to match dimensions
-    phi_grid.resize(ni, nj, nk);
+bool write_sparse_sdf(const std::string& filename, const sdfgen::SparseLevelSet& phi) {
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    if (!outfile) {
+        std::cerr << "ERROR: Failed to open file for writing: " << filename << std::endl;
+        return false;
+    }
 
-    // Read data: SDF values as float32
-    // Read in C-order (same order as written): for(i) for(j) for(k)
-    for (int i = 0; i < ni; ++i) {
-        for (int j = 0; j < nj; ++j) {
-            for (int k = 0; k < nk; ++k) {
-                float val;
-                infile.read(reinterpret_cast<char*>(&val), sizeof(float));
-                if (infile.fail()) {
-                    std::cerr << "ERROR: Failed to read SDF data at ("
-                              << i << "," << j << "," << k << ")" << std::endl;
-                    infile.close();
-                    return false;
+    // Header
+    int version = 1;
+    int dims[4] = {phi.ni, phi.nj, phi.nk, sdfgen::SparseLevelSet::brick_size};
+    float geometry[5] = {phi.origin[0], phi.origin[1], phi.origin[2], phi.dx, phi.background};
+    long long brick_count = static_cast<long long>(phi.brick_count());
+    outfile.write("SDFS", 4);
+    outfile.write(reinterpret_cast<const char*>(&version), sizeof(int));
+    outfile.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    outfile.write(reinterpret_cast<const char*>(geometry), sizeof(geometry));
+    outfile.write(reinterpret_cast<const char*>(&brick_count), sizeof(long long));
+
+    // Tile flags, packed 8 per byte
+    size_t num_tiles = static_cast<size_t>(phi.tiles_i()) * phi.tiles_j() * phi.tiles_k();
+    std::vector<unsigned char> flags((num_tiles + 7) / 8, 0);
+    for (int tk = 0; tk < phi.tiles_k(); ++tk) {
+        for (int tj = 0; tj < phi.tiles_j(); ++tj) {
+            for (int ti = 0; ti < phi.tiles_i(); ++ti) {
+                if (phi.tile_inside(ti, tj, tk)) {
+                    size_t n = static_cast<size_t>(phi.tile_index(ti, tj, tk));
+                    flags[n / 8] |= static_cast<unsigned char>(1u << (n % 8));
                 }
-                phi_grid(i, j, k) = val;
             }
         }
     }
+    outfile.write(reinterpret_cast<const char*>(flags.data()), flags.size());
 
-    infile.close();
+    // Bricks
+    for (size_t n = 0; n < phi.brick_count(); ++n) {
+        const Vec3i& tile = phi.brick_coord(n);
+        int coord[3] = {tile[0], tile[1], tile[2]};
+        outfile.write(reinterpret_cast<const char*>(coord), sizeof(coord));
+        outfile.write(reinterpret_cast<const char*>(phi.brick_data(n)),
+                      sdfgen::SparseLevelSet::brick_cells * sizeof(float));
+    }
+
+    if (outfile.fail()) {
+        std::cerr << "ERROR: Failed to write sparse SDF data to file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool read_sparse_sdf(const std::string& filename, sdfgen::SparseLevelSet& phi) {
+    std::ifstream infile(filename.c_str(), std::ios::binary);
+    if (!infile) {
+        std::cerr << "ERROR: Failed to open file for reading: " << filename << std::endl;
+        return false;
+    }
+
+    // Header
+    char magic[4];
+    int version = 0;
+    int dims[4];
+    float geometry[5];
+    long long brick_count = 0;
+    infile.read(magic, 4);
+    infile.read(reinterpret_cast<char*>(&version), sizeof(int));
+    infile.read(reinterpret_cast<char*>(dims), sizeof(dims));
+    infile.read(reinterpret_cast<char*>(geometry), sizeof(geometry));
+    infile.read(reinterpret_cast<char*>(&brick_count), sizeof(long long));
+    if (infile.fail() || std::string(magic, 4) != "SDFS") {
+        std::cerr << "ERROR: Not a sparse SDF file: " << filename << std::endl;
+        return false;
+    }
+    if (version != 1 || dims[3] != sdfgen::SparseLevelSet::brick_size) {
+        std::cerr << "ERROR: Unsupported sparse SDF version " << version
+                  << " (brick size " << dims[3] << "): " << filename << std::endl;
+        return false;
+    }
+    if (dims[0] <= 0 || dims[1] <= 0 || dims[2] <= 0 || brick_count < 0) {
+        std::cerr << "ERROR: Invalid dimensions in sparse SDF file: "
+                  << dims[0] << "x" << dims[1] << "x" << dims[2] << std::endl;
+        return false;
+    }
+
+    phi.reset(dims[0], dims[1], dims[2], Vec3f(geometry[0], geometry[1], geometry[2]), geometry[3], geometry[4]);
+    size_t num_tiles = static_cast<size_t>(phi.tiles_i()) * phi.tiles_j() * phi.tiles_k();
+    if (static_cast<unsigned long long>(brick_count) > num_tiles) {
+        std::cerr << "ERROR: Invalid brick count in sparse SDF file: " << brick_count << std::endl;
+        return false;
+    }
+
+    // Tile flags
+    std::vector<unsigned char> flags((num_tiles + 7) / 8);
+    infile.read(reinterpret_cast<char*>(flags.data()), flags.size());
+    if (infile.fail()) {
+        std::cerr << "ERROR: Failed to read sparse SDF tile flags: " << filename << std::endl;
+        return false;
+    }
+    for (int tk = 0; tk < phi.tiles_k(); ++tk) {
+        for (int tj = 0; tj < phi.tiles_j(); ++tj) {
+            for (int ti = 0; ti < phi.tiles_i(); ++ti) {
+                size_t n = static_cast<size_t>(phi.tile_index(ti, tj, tk));
+                phi.set_tile_inside(ti, tj, tk, (flags[n / 8] >> (n % 8)) & 1);
+            }
+        }
+    }
+
+    // Bricks
+    for (long long n = 0; n < brick_count; ++n) {
+        int coord[3];
+        infile.read(reinterpret_cast<char*>(coord), sizeof(coord));
+        if (infile.fail() || coord[0] < 0 || coord[0] >= phi.tiles_i() ||
+            coord[1] < 0 || coord[1] >= phi.tiles_j() || coord[2] < 0 || coord[2] >= phi.tiles_k()) {
+            std::cerr << "ERROR: Invalid brick " << n << " in sparse SDF file: " << filename << std::endl;
+            return false;
+        }
+        int slot = phi.add_brick(coord[0], coord[1], coord[2]);
+        infile.read(reinterpret_cast<char*>(phi.brick_data(slot)),
+                    sdfgen::SparseLevelSet::brick_cells * sizeof(float));
+        if (infile.fail()) {
+            std::cerr << "ERROR: Failed to read sparse SDF brick " << n << ": " << filename << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool write_octree_sdf(const std::string& filename, const sdfgen::OctreeLevelSet& tree) {
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    if (!outfile) {
+        std::cerr << "ERROR: Failed to open file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    // Header
+    int header[5] = {1, tree.levels, tree.ni, tree.nj, tree.nk};
+    float geometry[4] = {tree.origin[0], tree.origin[1], tree.origin[2], tree.dx};
+    long long node_count = static_cast<long long>(tree.nodes.size());
+    outfile.write("SDFO", 4);
+    outfile.write(reinterpret_cast<const char*>(header), sizeof(header));
+    outfile.write(reinterpret_cast<const char*>(geometry), sizeof(geometry));
+    outfile.write(reinterpret_cast<const char*>(&node_count), sizeof(long long));
+
+    // Nodes
+    for (const sdfgen::OctreeNode& node : tree.nodes) {
+        outfile.write(reinterpret_cast<const char*>(&node.child), sizeof(int));
+        outfile.write(reinterpret_cast<const char*>(node.value), sizeof(node.value));
+    }
+
+    if (outfile.fail()) {
+        std::cerr << "ERROR: Failed to write octree SDF data to file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool read_octree_sdf(const std::string& filename, sdfgen::OctreeLevelSet& tree) {
+    std::ifstream infile(filename.c_str(), std::ios::binary);
+    if (!infile) {
+        std::cerr << "ERROR: Failed to open file for reading: " << filename << std::endl;
+        return false;
+    }
+
+    // Header
+    char magic[4];
+    int header[5];
+    float geometry[4];
+    long long node_count = 0;
+    infile.read(magic, 4);
+    infile.read(reinterpret_cast<char*>(header), sizeof(header));
+    infile.read(reinterpret_cast<char*>(geometry), sizeof(geometry));
+    infile.read(reinterpret_cast<char*>(&node_count), sizeof(long long));
+    if (infile.fail() || std::string(magic, 4) != "SDFO") {
+        std::cerr << "ERROR: Not an octree SDF file: " << filename << std::endl;
+        return false;
+    }
+    if (header[0] != 1) {
+        std::cerr << "ERROR: Unsupported octree SDF version " << header[0] << ": " << filename << std::endl;
+        return false;
+    }
+    if (header[1] < 0 || header[1] > 21 || node_count < 1 || (node_count - 1) % 8 != 0) {
+        std::cerr << "ERROR: Invalid octree in SDF file: " << header[1] << " levels, "
+                  << node_count << " nodes" << std::endl;
+        return false;
+    }
+
+    tree.levels = header[1];
+    tree.ni = header[2];
+    tree.nj = header[3];
+    tree.nk = header[4];
+    tree.origin = Vec3f(geometry[0], geometry[1], geometry[2]);
+    tree.dx = geometry[3];
+    tree.nodes.resize(static_cast<size_t>(node_count));
+
+    // Nodes; a child block must lie after its parent so the tree cannot loop
+    for (long long n = 0; n < node_count; ++n) {
+        sdfgen::OctreeNode& node = tree.nodes[n];
+        infile.read(reinterpret_cast<char*>(&node.child), sizeof(int));
+        infile.read(reinterpret_cast<char*>(node.value), sizeof(node.value));
+        if (infile.fail()) {
+            std::cerr << "ERROR: Failed to read octree SDF node " << n << ": " << filename << std::endl;
+            tree.nodes.clear();
+            return false;
+        }
+        if (node.child != -1 && (node.child <= n || node.child + 8 > node_count)) {
+            std::cerr << "ERROR: Invalid child link at octree SDF node " << n << ": " << filename << std::endl;
+            tree.nodes.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool write_compact_sdf(const std::string& filename, const sdfgen::CompactLevelSet& phi) {
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    if (!outfile) {
+        std::cerr << "ERROR: Failed to open file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    // Header
+    int header[5] = {1, phi.ni, phi.nj, phi.nk, phi.format == sdfgen::CompactFormat::Half ? 0 : 1};
+    float geometry[5] = {phi.origin[0], phi.origin[1], phi.origin[2], phi.dx, phi.band};
+    outfile.write("SDFQ", 4);
+    outfile.write(reinterpret_cast<const char*>(header), sizeof(header));
+    outfile.write(reinterpret_cast<const char*>(geometry), sizeof(geometry));
+
+    // Words, already in file order
+    const std::vector<uint16_t>& words = phi.words();
+    outfile.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint16_t));
+
+    if (outfile.fail()) {
+        std::cerr << "ERROR: Failed to write compact SDF data to file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool read_compact_sdf(const std::string& filename, sdfgen::CompactLevelSet& phi) {
+    std::ifstream infile(filename.c_str(), std::ios::binary);
+    if (!infile) {
+        std::cerr << "ERROR: Failed to open file for reading: " << filename << std::endl;
+        return false;
+    }
+
+    // Header
+    char magic[4];
+    int header[5];
+    float geometry[5];
+    infile.read(magic, 4);
+    infile.read(reinterpret_cast<char*>(header), sizeof(header));
+    infile.read(reinterpret_cast<char*>(geometry), sizeof(geometry));
+    if (infile.fail() || std::string(magic, 4) != "SDFQ") {
+        std::cerr << "ERROR: Not a compact SDF file: " << filename << std::endl;
+        return false;
+    }
+    if (header[0] != 1 || (header[4] != 0 && header[4] != 1)) {
+        std::cerr << "ERROR: Unsupported compact SDF version " << header[0]
+                  << " (encoding " << header[4] << "): " << filename << std::endl;
+        return false;
+    }
+    if (header[1] <= 0 || header[2] <= 0 || header[3] <= 0 || !(geometry[4] > 0.0f)) {
+        std::cerr << "ERROR: Invalid grid in compact SDF file: " << header[1] << "x" << header[2] << "x"
+                  << header[3] << ", band " << geometry[4] << std::endl;
+        return false;
+    }
+
+    phi.reset(header[1], header[2], header[3], Vec3f(geometry[0], geometry[1], geometry[2]), geometry[3],
+              geometry[4], header[4] == 0 ? sdfgen::CompactFormat::Half : sdfgen::CompactFormat::Int16);
+    std::vector<uint16_t>& words = phi.words();
+    infile.read(reinterpret_cast<char*>(words.data()), words.size() * sizeof(uint16_t));
+    if (infile.fail()) {
+        std::cerr << "ERROR: Failed to read compact SDF data: " << filename << std::endl;
+        phi.words().clear();
+        return false;
+    }
     return true;
 }
@@ -6,45 +6,87 @@
 
 #include "array3.h"
 #include "vec.h"
+#include "compact_level_set.h"
+#include "octree_level_set.h"
+#include "sparse_level_set.h"
+#include <future>
 #include <string>
 
+namespace sdfgen {
+
+/**
+ * @brief Order of the values in a dense binary SDF file
+ */
+enum class SdfLayout {
+    COrder, ///< k fastest: for(i) for(j) for(k) (the original layout, read by every tool)
+    Native  ///< i fastest, as Array3f stores it; marked in the header by a negated Nx
+};
+
+} // namespace sdfgen
+
 /**
  * @brief Write a signed distance field to a binary file
  *
  * Binary format (little-endian):
  * - Header (36 bytes):
- *   - 3 x int32: Grid dimensions (Nx, Ny, Nz)
+ *   - 3 x int32: Grid dimensions (Nx, Ny, Nz); Nx is stored as -Nx for SdfLayout::Native
  *   - 3 x float32: Bounding box minimum (x, y, z)
  *   - 3 x float32: Bounding box maximum (x, y, z)
  * - Data (Nx*Ny*Nz x float32):
- *   - SDF values in C-order: for(i) for(j) for(k) write(value)
+ *   - SdfLayout::COrder: for(i) for(j) for(k) write(value)
+ *   - SdfLayout::Native: for(k) for(j) for(i) write(value)
  *   - Negative values = inside mesh
  *   - Positive values = outside mesh
  *   - Zero = surface
  *
+ * Native layout is the grid's own memory, written with a single call. C-order is transposed
+ * in cache-sized tiles by the thread pool into large buffers, and each buffer is written
+ * while the next one is being filled. Readers that predate the layout flag reject native
+ * files (non-positive Nx) instead of misreading them.
+ *
  * @param filename Output file path
  * @param phi_grid SDF grid data (Array3f from make_level_set3)
  * @param min_box Minimum corner of bounding box
  * @param dx Grid cell spacing
  * @param out_inside_count Optional output: number of cells with negative SDF (inside mesh)
+ * @param layout Order of the values in the file
+ * @param num_threads Threads for the transpose and the inside count, 0 = auto-detect
  * @return true on success, false on error
  */
 bool write_sdf_binary(const std::string& filename,
                       const Array3f& phi_grid,
                       const Vec3f& min_box,
                       float dx,
-                      int* out_inside_count = nullptr);
+                      int* out_inside_count = nullptr,
+                      sdfgen::SdfLayout layout = sdfgen::SdfLayout::COrder,
+                      int num_threads = 0);
+
+/**
+ * @brief Write a signed distance field to a binary file in the background
+ *
+ * Takes the grid's storage without copying it (phi_grid is left empty) and runs
+ * write_sdf_binary() on its own thread, so the caller can start on the next grid while the
+ * file is written. The grid is released when the write finishes.
+ *
+ * @return Future holding write_sdf_binary()'s result
+ */
+std::future<bool> write_sdf_binary_async(const std::string& filename,
+                                         Array3f& phi_grid,
+                                         const Vec3f& min_box,
+                                         float dx,
+                                         sdfgen::SdfLayout layout = sdfgen::SdfLayout::COrder,
+                                         int num_threads = 0);
 
 /**
  * @brief Read a signed distance field from a binary file
  *
- * Binary format (little-endian) - same as write_sdf_binary():
+ * Binary format (little-endian) - same as write_sdf_binary(); both layouts are accepted:
  * - Header (36 bytes):
- *   - 3 x int32: Grid dimensions (Nx, Ny, Nz)
+ *   - 3 x int32: Grid dimensions (Nx, Ny, Nz); a negated Nx marks native (i-fastest) data
  *   - 3 x float32: Bounding box minimum (x, y, z)
  *   - 3 x float32: Bounding box maximum (x, y, z)
  * - Data (Nx*Ny*Nz x float32):
- *   - SDF values in C-order: for(i) for(j) for(k) read(value)
+ *   - SDF values in C-order: for(i) for(j) for(k) read(value), or native order
  *
  * @param filename Input file path
  * @param phi_grid Output SDF grid data (will be resized)
@@ -57,3 +99,96 @@ bool read_sdf_binary(const std::string& filename,
                      Vec3f& min_box,
                      Vec3f& max_box);
 
+/**
+ * @brief Write a narrow-band signed distance field to a sparse binary file
+ *
+ * Sparse format (little-endian):
+ * - Header (52 bytes):
+ *   - 4 bytes: Magic "SDFS"
+ *   - int32: Format version (1)
+ *   - 3 x int32: Grid dimensions (Nx, Ny, Nz)
+ *   - int32: Brick size (8)
+ *   - 3 x float32: Grid origin (x, y, z)
+ *   - float32: Cell spacing dx
+ *   - float32: Background magnitude (value outside the active bricks)
+ *   - int64: Number of active bricks
+ * - Tile flags: one bit per tile (bit n of byte n/8 for tile index n = ti + Ti*(tj + Tj*tk),
+ *   with Ti, Tj tiles along x and y), set for inside tiles
+ * - Bricks, in SparseLevelSet order:
+ *   - 3 x int32: Tile coordinates (ti, tj, tk)
+ *   - 512 x float32: Values, i fastest: node (ti*8+a, tj*8+b, tk*8+c) at a + 8*(b + 8*c)
+ *
+ * @param filename Output file path (conventionally .ssdf)
+ * @param phi Narrow-band field (from make_sparse_level_set3)
+ * @return true on success, false on error
+ */
+bool write_sparse_sdf(const std::string& filename, const sdfgen::SparseLevelSet& phi);
+
+/**
+ * @brief Read a narrow-band signed distance field written by write_sparse_sdf()
+ *
+ * @param filename Input file path
+ * @param phi Output field (reset to the file's geometry)
+ * @return true on success, false on error (bad magic, version or truncated data)
+ */
+bool read_sparse_sdf(const std::string& filename, sdfgen::SparseLevelSet& phi);
+
+/**
+ * @brief Write an adaptive octree signed distance field to a binary file
+ *
+ * Octree format (little-endian):
+ * - Header (48 bytes):
+ *   - 4 bytes: Magic "SDFO"
+ *   - int32: Format version (1)
+ *   - int32: Levels (root edge is dx * 2^levels)
+ *   - 3 x int32: Requested grid dimensions (Nx, Ny, Nz)
+ *   - 3 x float32: Root origin (x, y, z)
+ *   - float32: Finest cell spacing dx
+ *   - int64: Number of nodes
+ * - Nodes (36 bytes each), root first:
+ *   - int32: Index of the first of 8 children, or -1 for a leaf
+ *   - 8 x float32: Corner distances, corner c at (+x if c&1, +y if c&2, +z if c&4)
+ *
+ * @param filename Output file path (conventionally .osdf)
+ * @param tree Octree field (from make_octree_level_set3)
+ * @return true on success, false on error
+ */
+bool write_octree_sdf(const std::string& filename, const sdfgen::OctreeLevelSet& tree);
+
+/**
+ * @brief Read an adaptive octree signed distance field written by write_octree_sdf()
+ *
+ * @param filename Input file path
+ * @param tree Output octree
+ * @return true on success, false on error (bad magic, version, child links or truncated data)
+ */
+bool read_octree_sdf(const std::string& filename, sdfgen::OctreeLevelSet& tree);
+
+/**
+ * @brief Write a 16-bit clamped signed distance field to a binary file
+ *
+ * Compact format (little-endian):
+ * - Header (44 bytes):
+ *   - 4 bytes: Magic "SDFQ"
+ *   - int32: Format version (1)
+ *   - 3 x int32: Grid dimensions (Nx, Ny, Nz)
+ *   - int32: Encoding (0 = fp16, 1 = normalized int16: value = word * band / 32767)
+ *   - 3 x float32: Grid origin (x, y, z)
+ *   - float32: Cell spacing dx
+ *   - float32: Band (clamp on |phi|, in world units)
+ * - Data (Nx*Ny*Nz x uint16): for(k) for(j) for(i) write(word)
+ *
+ * @param filename Output file path (conventionally .qsdf)
+ * @param phi Compact field (from make_compact_level_set3)
+ * @return true on success, false on error
+ */
+bool write_compact_sdf(const std::string& filename, const sdfgen::CompactLevelSet& phi);
+
+/**
+ * @brief Read a 16-bit clamped signed distance field written by write_compact_sdf()
+ *
+ * @param filename Input file path
+ * @param phi Output field (reset to the file's geometry)
+ * @return true on success, false on error (bad magic, version, encoding or truncated data)
+ */
+bool read_compact_sdf(const std::string& filename, sdfgen::CompactLevelSet& phi);
@@ -0,0 +1,254 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "vec.h"
+
+namespace sdfgen {
+
+/**
+ * @brief Hardware backend selection for SDF generation
+ */
+enum class HardwareBackend {
+    Auto,  /**< Backend the cost model predicts to finish first (see estimate_backend()), CPU without a GPU */
+    CPU,   /**< Force CPU implementation */
+    GPU    /**< Force GPU implementation (fails if CUDA not available) */
+};
+
+/**
+ * @brief Parallelization strategy for the CPU fast-sweeping phase
+ */
+enum class SweepMode {
+    Wavefront, /**< Block wavefront over (j,k) rows; exact sequential Gauss-Seidel order, deterministic */
+    Slab       /**< Legacy contiguous k-slab per thread; results can vary with thread count */
+};
+
+/**
+ * @brief Memory layout of the grids during the CPU sweeps
+ */
+enum class GridLayout {
+    Linear,  /**< Array3 order, i fastest: a +/-k neighbour is ni*nj elements away */
+    Bricked  /**< 8^3 bricks, Morton order inside (BrickedArray3); converted in and out around the sweeps */
+};
+
+/**
+ * @brief How distances outside the near band are obtained
+ */
+enum class DistanceMode {
+    Sweep, /**< Exact near band, fast sweeping elsewhere (distances approximate far from the surface) */
+    Exact  /**< Exact nearest-triangle distance in every cell via a BVH query (CPU only, no sweeping) */
+};
+
+/**
+ * @brief How inside/outside is decided
+ */
+enum class SignMode {
+    Parity,        /**< Even-odd count of +x ray crossings; exact for closed meshes, a hole flips whole rays */
+    WindingNumber, /**< Fast generalized winding number >= 0.5; tolerates holes, gaps and self-intersections */
+    RayVote        /**< Majority of the x, y and z crossing parities; removes streaks from rays grazing edges */
+};
+
+/**
+ * @brief Far-field propagation engine on the GPU
+ */
+enum class GpuSweepMode {
+    Jacobi,      /**< Full-grid Jacobi iterations with periodic convergence checks */
+    ActiveTiles  /**< Block fast iterative method: only 8^3 tiles on the propagating front are updated */
+};
+
+/**
+ * @brief Work decomposition of the GPU near-band pass
+ */
+enum class GpuNearBandMode {
+    PerTriangle, /**< One thread per triangle over its bounding box, 64-bit CAS per cell */
+    Binned       /**< Triangles binned into 8^3 bricks, one block per brick, no global atomics */
+};
+
+/**
+ * @brief Device memory strategy of the GPU backend
+ */
+enum class GpuMemoryMode {
+    Auto,     /**< In-core when the grid fits the device memory budget, streamed otherwise */
+    InCore,   /**< Whole grid resident on the device (about 20 bytes per cell) */
+    Streamed  /**< Z-slabs with halo planes streamed through the device; the grid lives on the host */
+};
+
+/**
+ * @brief Timed phases of dense generation, in the order they run
+ */
+enum class GenerationPhase {
+    Setup,     /**< Grid allocation and initialization (GPU: plus mesh upload) */
+    NearBand,  /**< Exact near-band distances and crossing counts */
+    Sweep,     /**< Far field: fast sweeping, or the BVH pass with DistanceMode::Exact */
+    Sign,      /**< Inside/outside signs */
+    Copy       /**< GPU: device to host copy of the field */
+};
+
+/**
+ * @brief Lower-case name of a phase ("setup", "near_band", "sweep", "sign", "copy")
+ */
+inline const char* phase_name(GenerationPhase phase)
+{
+    switch (phase) {
+    case GenerationPhase::Setup:    return "setup";
+    case GenerationPhase::NearBand: return "near_band";
+    case GenerationPhase::Sweep:    return "sweep";
+    case GenerationPhase::Sign:     return "sign";
+    default:                        return "copy";
+    }
+}
+
+/**
+ * @brief Called at the start (begin = true) and end of every generation phase
+ *
+ * Runs on the thread that called make_level_set3(); see nvtx_phase_hook() and PhaseTrace.
+ */
+typedef std::function<void(GenerationPhase phase, bool begin)> PhaseHook;
+
+/**
+ * @brief Options controlling SDF generation, shared by the unified API and the backends
+ *
+ * Plain aggregate so it can be passed unchanged to the CPU and CUDA implementations.
+ * Backends ignore fields that do not apply to them.
+ */
+struct GenerationOptions {
+    HardwareBackend backend = HardwareBackend::Auto; ///< Hardware selection
+    int exact_band = 1;                              ///< Exact-distance band in grid cells
+    int num_threads = 0;                             ///< CPU thread count, 0 = auto-detect
+    SweepMode sweep_mode = SweepMode::Wavefront;     ///< CPU fast-sweeping strategy
+    GridLayout grid_layout = GridLayout::Linear;     ///< CPU sweep grid layout (same results; bricks help TLB reach on 1000^3+ grids)
+    DistanceMode distance_mode = DistanceMode::Sweep; ///< Sweep-propagated or exact far field
+    SignMode sign_mode = SignMode::Parity;           ///< Inside/outside test (dense CPU and GPU generation)
+    bool triangle_table = false;                     ///< Precompute per-triangle geometry (TriangleTable::bytes_for) for faster queries
+    bool spatial_reorder = false;                    ///< Run the near band on a Morton-sorted copy of the mesh (same results, better locality)
+    bool diagnostics = false;                        ///< Gather field statistics into GenerationStats (GPU: device-side reductions)
+    int sweep_check_interval = 16;                   ///< GPU Jacobi: test for convergence every N iterations, 0 = always run the fixed count
+    float sweep_tolerance = 0.0f;                    ///< GPU: converged when no cell (tile) decreases by more than this (0 = exact fixed point)
+    GpuSweepMode gpu_sweep_mode = GpuSweepMode::Jacobi; ///< GPU far-field engine
+    GpuNearBandMode gpu_near_band = GpuNearBandMode::PerTriangle; ///< GPU near-band decomposition
+    GpuMemoryMode gpu_memory = GpuMemoryMode::Auto;  ///< GPU in-core or slab-streamed generation
+    size_t gpu_memory_limit = 0;                     ///< GPU memory budget in bytes, 0 = all free device memory
+    std::vector<int> gpu_devices;                    ///< CUDA devices to split the grid across along z, empty = current device
+    const std::atomic<bool>* cancel = nullptr;       ///< Polled between phases and sweep iterations; generation stops early once true
+    PhaseHook phase_hook;                            ///< Optional: told when each dense-generation phase begins and ends
+};
+
+/**
+ * @brief True once the caller has asked the generation to stop through options.cancel
+ *
+ * Backends return early, leaving phi unspecified; the unified API then throws
+ * GenerationCancelled.
+ */
+inline bool generation_cancelled(const GenerationOptions& options)
+{
+    return options.cancel && options.cancel->load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Information reported back by a generation call
+ *
+ * Filled by make_level_set3() when a stats pointer is passed. The diagnostics block is only
+ * computed when GenerationOptions::diagnostics is set, so the default path does no extra
+ * work (on the GPU: no extra device-to-host traffic beyond the result grid).
+ */
+struct GenerationStats {
+    HardwareBackend backend_used = HardwareBackend::Auto; ///< Backend that actually ran (CPU or GPU)
+    bool backend_auto = false;       ///< HardwareBackend::Auto chose the backend by the cost model (see estimate_backend())
+    double estimated_cpu_ms = 0.0;   ///< Auto: predicted CPU time
+    double estimated_gpu_ms = 0.0;   ///< Auto: predicted GPU time, 0 when the GPU could not run the call
+    int sweep_iterations = 0;        ///< Far-field iterations run: GPU Jacobi or active-tile iterations, CPU directional sweeps
+    bool sweep_converged = false;    ///< GPU: iteration stopped because updates fell below sweep_tolerance (or the front emptied)
+    int gpu_slabs = 0;               ///< GPU: z-slabs used by the streamed mode, 0 = in-core
+    int gpu_devices = 0;             ///< GPU: devices the grid was split across
+    long long cells_updated = 0;     ///< update_level_set3(): node values rewritten by the incremental update
+    long long winding_evaluations = 0; ///< SignMode::WindingNumber: winding-number queries the sign pass needed
+
+    bool diagnostics_valid = false;  ///< True when the fields below were computed
+    long long near_band_cells = 0;   ///< Cells that received an exact distance in the near band
+    float near_band_min = 0.0f;      ///< Smallest unsigned distance after the near band
+    float near_band_max = 0.0f;      ///< Largest unsigned distance among near-band cells
+    long long intersections = 0;     ///< Total ray/triangle crossings used for the sign pass
+
+    // Wall-clock phase times of dense generation (make_level_set3()), see GenerationPhase.
+    // Streamed and multi-device GPU runs overlap their phases and leave them at 0, as do the
+    // sparse and octree layouts.
+    double setup_ms = 0.0;           ///< Grid allocation and initialization (GPU: plus mesh upload)
+    double near_band_ms = 0.0;       ///< Exact near-band distances and crossing counts (with reordering)
+    double sweep_ms = 0.0;           ///< Far field: fast sweeping, or the BVH pass with DistanceMode::Exact
+    double sign_ms = 0.0;            ///< Inside/outside signs
+    double copy_ms = 0.0;            ///< GPU: device to host copy of the field
+
+    // Work and memory of dense generation. GPU figures cover the in-core path; the GPU
+    // counters need diagnostics.
+    long long distance_evaluations = 0; ///< Point-triangle distances computed (CPU: near band, sweeps, BVH; GPU: per-triangle near band)
+    long long gpu_cas_retries = 0;   ///< GPU per-triangle near band: 64-bit compare-and-swap attempts lost to another thread
+    size_t host_bytes = 0;           ///< Peak host memory the call allocated for grids and scratch
+    size_t device_bytes = 0;         ///< GPU: device memory held by the call's buffers
+    size_t bytes_to_device = 0;      ///< GPU: host to device transfers (mesh, triangle table)
+    size_t bytes_to_host = 0;        ///< GPU: device to host transfers (field)
+};
+
+/**
+ * @brief Times the phases of one generation call into GenerationStats and the phase hook
+ *
+ * begin() ends the running phase and starts the next; the destructor ends the last one,
+ * so early returns are covered. Does nothing without stats or a hook.
+ */
+class PhaseTimer {
+public:
+    PhaseTimer(const GenerationOptions& options, GenerationStats* stats)
+        : hook_(options.phase_hook ? &options.phase_hook : nullptr), stats_(stats), running_(false),
+          phase_(GenerationPhase::Setup) {}
+    ~PhaseTimer() { end(); }
+
+    void begin(GenerationPhase phase) {
+        end();
+        if (!hook_ && !stats_) return;
+        if (hook_) (*hook_)(phase, true);
+        phase_ = phase;
+        running_ = true;
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    void end() {
+        if (!running_) return;
+        running_ = false;
+        if (stats_) {
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+            double* fields[] = {&stats_->setup_ms, &stats_->near_band_ms, &stats_->sweep_ms, &stats_->sign_ms,
+                                &stats_->copy_ms};
+            *fields[(int)phase_] = ms;
+        }
+        if (hook_) (*hook_)(phase_, false);
+    }
+
+private:
+    PhaseTimer(const PhaseTimer&);
+    PhaseTimer& operator=(const PhaseTimer&);
+
+    const PhaseHook* hook_;
+    GenerationStats* stats_;
+    bool running_;
+    GenerationPhase phase_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @brief One grid of a batched generation (see make_level_set3_batch())
+ */
+struct BatchItem {
+    std::vector<Vec3ui> tri;          ///< Triangle vertex indices
+    std::vector<Vec3f> x;             ///< Vertex positions
+    Vec3f origin;                     ///< Grid origin (corner of the grid)
+    float dx = 0.0f;                  ///< Grid cell spacing
+    int nx = 0, ny = 0, nz = 0;       ///< Grid dimensions
+};
+
+} // namespace sdfgen
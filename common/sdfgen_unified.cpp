@@ -3,60 +3,235 @@
 // Licensed under the MIT License - see LICENSE file
 
 #include "sdfgen_unified.h"
+#include "backend_cost.h"
 #include "config.h"
+#include "marching_cubes.h"
+#include "thread_pool.h"
+#include "triangle_bvh.h"
+#include "winding_number.h"
 #include "../cpu_lib/makelevelset3.h"
 
 #ifdef HAVE_CUDA
 #include "../gpu_lib/makelevelset3_gpu.h"
+#include "../gpu_lib/marching_cubes_gpu.h"
 #include <cuda_runtime.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 
 namespace sdfgen {
 
-bool is_gpu_available() {
+namespace gpu {
+class GpuContext; // complete only with HAVE_CUDA; passed through as a pointer otherwise
+}
+
+struct GenerationContext::Impl {
 #ifdef HAVE_CUDA
-    // Check at runtime if a CUDA-capable GPU is actually present
-    int device_count = 0;
-    cudaError_t error = cudaGetDeviceCount(&device_count);
-    return (error == cudaSuccess && device_count > 0);
+    gpu::GpuContext gpu;
+#endif
+    std::unique_ptr<TriangleBVH> index; ///< Region culling and point queries; built on first use, dropped by set_mesh()
+    std::unique_ptr<WindingNumberTree> winding; ///< Point queries with winding-number signs; same lifetime
+};
+
+GenerationContext::GenerationContext() : impl_(new Impl) {}
+
+GenerationContext::GenerationContext(std::vector<Vec3ui> tri, std::vector<Vec3f> x)
+    : tri_(std::move(tri)), x_(std::move(x)), impl_(new Impl) {}
+
+GenerationContext::~GenerationContext() = default;
+
+void GenerationContext::set_mesh(std::vector<Vec3ui> tri, std::vector<Vec3f> x) {
+    tri_ = std::move(tri);
+    x_ = std::move(x);
+    impl_->index.reset();
+    impl_->winding.reset();
+#ifdef HAVE_CUDA
+    impl_->gpu.invalidate_mesh();
+#endif
+}
+
+void GenerationContext::release() {
+#ifdef HAVE_CUDA
+    impl_->gpu.release();
+#endif
+}
+
+size_t GenerationContext::device_bytes() const {
+#ifdef HAVE_CUDA
+    return impl_->gpu.device_bytes();
 #else
-    return false;
+    return 0;
 #endif
 }
 
-void make_level_set3(
+namespace {
+
+// Set once a GPU generation has run: later calls no longer pay for CUDA context creation
+std::atomic<bool> gpu_initialized(false);
+
+struct CostModelState {
+    std::mutex mutex;
+    bool loaded = false;
+    BackendCostModel model;
+};
+
+CostModelState& cost_model_state() {
+    static CostModelState state;
+    return state;
+}
+
+#ifdef HAVE_CUDA
+/**
+ * @brief Free memory of the smallest device a call with these options uses, 0 on error
+ */
+size_t gpu_free_bytes(const GenerationOptions& options) {
+    int current = 0;
+    if (cudaGetDevice(&current) != cudaSuccess) return 0;
+    std::vector<int> devices = options.gpu_devices;
+    if (devices.empty()) devices.push_back(current);
+    size_t smallest = SIZE_MAX;
+    for (int device : devices) {
+        size_t free_bytes = 0, total_bytes = 0;
+        if (cudaSetDevice(device) != cudaSuccess || cudaMemGetInfo(&free_bytes, &total_bytes) != cudaSuccess) {
+            smallest = 0;
+            break;
+        }
+        smallest = std::min(smallest, free_bytes);
+    }
+    cudaSetDevice(current);
+    return smallest;
+}
+#endif
+
+/**
+ * @brief Cost estimate of one call, with or without the GPU context creation
+ *
+ * Device memory is queried only when the GPU would win with unlimited memory, so a grid
+ * the CPU finishes first never creates a CUDA context.
+ */
+BackendEstimate estimate_call(const GenerationOptions& options, int nx, int ny, int nz, size_t num_triangles,
+                              bool first_gpu_call)
+{
+    const BackendCostModel model = backend_cost_model();
+    GpuCostInputs gpu;
+    gpu.available = is_gpu_available();
+    gpu.initialized = !first_gpu_call;
+    gpu.free_bytes = SIZE_MAX;
+    BackendEstimate estimate = estimate_backend_cost(model, options, nx, ny, nz, num_triangles, gpu);
+#ifdef HAVE_CUDA
+    if (estimate.backend == HardwareBackend::GPU) {
+        gpu.free_bytes = gpu_free_bytes(options);
+        estimate = estimate_backend_cost(model, options, nx, ny, nz, num_triangles, gpu);
+    }
+#endif
+    return estimate;
+}
+
+/**
+ * @brief Backend a call with these options runs on (Auto and Exact resolved)
+ * @param estimate Cost estimate of the call, evaluated only for HardwareBackend::Auto
+ * @param chosen Receives the estimate Auto chose by (untouched otherwise)
+ */
+HardwareBackend resolve_backend(const GenerationOptions& options,
+                                const std::function<BackendEstimate()>& estimate,
+                                BackendEstimate* chosen)
+{
+    HardwareBackend backend = options.backend;
+
+    // Exact distance mode is CPU-only (under Auto the cost model picks the CPU)
+    if (options.distance_mode == DistanceMode::Exact) {
+        if (backend == HardwareBackend::GPU) {
+            throw std::runtime_error(
+                "Exact distance mode is only implemented by the CPU backend. "
+                "Use HardwareBackend::CPU or HardwareBackend::Auto."
+            );
+        }
+    }
+
+    // Handle Auto mode: the backend the cost model predicts to finish first
+    if (backend == HardwareBackend::Auto) {
+        *chosen = estimate();
+        backend = chosen->backend;
+    }
+    return backend;
+}
+
+/**
+ * @brief Record the estimate HardwareBackend::Auto chose by
+ */
+void record_choice(GenerationStats& stats, const GenerationOptions& options, const BackendEstimate& chosen)
+{
+    if (options.backend != HardwareBackend::Auto) return;
+    stats.backend_auto = true;
+    stats.estimated_cpu_ms = chosen.cpu_ms;
+    stats.estimated_gpu_ms = chosen.gpu_ms;
+}
+
+/**
+ * @brief Fresh stats for a call, with the Auto choice when there was one
+ */
+void reset_stats(GenerationStats& stats, HardwareBackend used, const GenerationOptions& options,
+                 const BackendEstimate& chosen)
+{
+    stats = GenerationStats();
+    stats.backend_used = used;
+    record_choice(stats, options, chosen);
+}
+
+/**
+ * @brief Shared dispatch for the options and context overloads
+ * @param gpu_context Device-memory cache to use on the GPU, or null for per-call allocation
+ */
+void generate(
     const std::vector<Vec3ui>& tri,
     const std::vector<Vec3f>& x,
     const Vec3f& origin,
     float dx,
     int nx, int ny, int nz,
     Array3f& phi,
-    int exact_band,
-    HardwareBackend backend,
-    int num_threads)
+    const GenerationOptions& options,
+    GenerationStats* stats,
+    gpu::GpuContext* gpu_context)
 {
-    // Handle Auto mode: try GPU first (if available at runtime), fall back to CPU
-    if (backend == HardwareBackend::Auto) {
-        if (is_gpu_available()) {
-            backend = HardwareBackend::GPU;
-        } else {
-            backend = HardwareBackend::CPU;
-        }
-    }
+    BackendEstimate chosen;
+    HardwareBackend backend = resolve_backend(options, [&]() {
+        return estimate_call(options, nx, ny, nz, tri.size(), !gpu_initialized.load());
+    }, &chosen);
+
+    if (stats) reset_stats(*stats, backend, options, chosen);
 
     // Dispatch to appropriate implementation
     switch (backend) {
         case HardwareBackend::CPU:
-            cpu::make_level_set3(tri, x, origin, dx, nx, ny, nz, phi, exact_band, num_threads);
+            cpu::make_level_set3(tri, x, origin, dx, nx, ny, nz, phi, options, stats);
             break;
 
         case HardwareBackend::GPU:
 #ifdef HAVE_CUDA
-            gpu::make_level_set3(tri, x, origin, dx, nx, ny, nz, phi, exact_band);
+            try {
+                gpu_initialized = true;
+                gpu::make_level_set3(tri, x, origin, dx, nx, ny, nz, phi, options, stats, gpu_context);
+            } catch (const std::runtime_error& e) {
+                // Auto promises a result: a grid the device cannot hold even streamed runs on the CPU
+                if (options.backend != HardwareBackend::Auto) throw;
+                std::cerr << "WARNING: GPU generation failed (" << e.what() << "), using CPU\n";
+                if (stats) reset_stats(*stats, HardwareBackend::CPU, options, chosen);
+                cpu::make_level_set3(tri, x, origin, dx, nx, ny, nz, phi, options, stats);
+            }
 #else
+            (void)gpu_context;
             throw std::runtime_error(
                 "GPU backend requested but CUDA support is not available. "
                 "Rebuild with CUDA enabled or use HardwareBackend::CPU."
@@ -68,6 +243,709 @@ void make_level_set3(
             // Should never reach here due to Auto resolution above
             throw std::logic_error("Auto backend should have been resolved");
     }
+
+    // Backends return early on cancellation with phi unspecified
+    if (generation_cancelled(options)) {
+        throw GenerationCancelled();
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Sparse and Adaptive Generation
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Common setup of the CPU-only layouts: reject an explicit GPU backend, reset stats
+ */
+void begin_cpu_only(const char* what, const GenerationOptions& options, GenerationStats* stats,
+                    bool parity_signs_only)
+{
+    if (options.backend == HardwareBackend::GPU) {
+        throw std::runtime_error(
+            std::string(what) + " is only implemented by the CPU backend. "
+            "Use HardwareBackend::CPU or HardwareBackend::Auto."
+        );
+    }
+    // these paths sign from the +x crossing parity alone; any other rule would be dropped silently
+    if (parity_signs_only && options.sign_mode != SignMode::Parity) {
+        throw std::runtime_error(
+            std::string(what) + " only computes crossing-parity signs. "
+            "Use SignMode::Parity, or dense generation for the other sign modes."
+        );
+    }
+    if (stats) {
+        *stats = GenerationStats();
+        stats->backend_used = HardwareBackend::CPU;
+    }
+}
+
+} // namespace
+
+void make_sparse_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    SparseLevelSet& phi,
+    const GenerationOptions& options,
+    GenerationStats* stats)
+{
+    begin_cpu_only("Sparse narrow-band generation", options, stats, true);
+    cpu::make_sparse_level_set3(tri, x, origin, dx, nx, ny, nz, phi, options, stats);
+    if (generation_cancelled(options)) {
+        throw GenerationCancelled();
+    }
+}
+
+void make_compact_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    CompactFormat format,
+    CompactLevelSet& phi,
+    const GenerationOptions& options,
+    GenerationStats* stats)
+{
+    begin_cpu_only("Compact generation", options, stats, true);
+    cpu::make_compact_level_set3(tri, x, origin, dx, nx, ny, nz, format, phi, options, stats);
+    if (generation_cancelled(options)) {
+        throw GenerationCancelled();
+    }
+}
+
+void make_octree_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    OctreeLevelSet& tree,
+    const GenerationOptions& options,
+    GenerationStats* stats)
+{
+    begin_cpu_only("Octree generation", options, stats, true);
+    if (std::max(nx, std::max(ny, nz)) > (1 << 21)) {
+        throw std::runtime_error("Octree generation supports at most 2^21 cells per axis");
+    }
+    cpu::make_octree_level_set3(tri, x, origin, dx, nx, ny, nz, tree, options, stats);
+    if (generation_cancelled(options)) {
+        throw GenerationCancelled();
+    }
+}
+
+// ============================================================================
+// Incremental Updates
+// ============================================================================
+
+void make_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    LevelSetState& state,
+    const GenerationOptions& options,
+    GenerationStats* stats)
+{
+    begin_cpu_only("Generation with retained state", options, stats, false);
+    cpu::make_level_set3(tri, x, origin, dx, nx, ny, nz, state, options, stats);
+    if (generation_cancelled(options)) {
+        throw GenerationCancelled();
+    }
+}
+
+void update_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const std::vector<unsigned int>& changed,
+    LevelSetState& state,
+    const GenerationOptions& options,
+    GenerationStats* stats)
+{
+    begin_cpu_only("Incremental update", options, stats, true);
+    if (state.phi.a.size() == 0 || state.closest_tri.a.size() != state.phi.a.size() ||
+        state.intersection_count.a.size() != state.phi.a.size()) {
+        throw std::runtime_error("update_level_set3 needs a state filled by make_level_set3");
+    }
+    if (state.sign_mode != SignMode::Parity) {
+        throw std::runtime_error(
+            "update_level_set3 re-signs the edited rows by crossing parity; "
+            "generate the state with SignMode::Parity"
+        );
+    }
+    cpu::update_level_set3(tri, x, changed, state, options, stats);
+    if (generation_cancelled(options)) {
+        throw GenerationCancelled();
+    }
+}
+
+// ============================================================================
+// Batched Generation
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief CPU batch: items spread over the pool, each with an even share of the threads
+ */
+void cpu_batch(const std::vector<BatchItem>& items, std::vector<Array3f>& phis,
+               const GenerationOptions& options, std::vector<GenerationStats>* stats)
+{
+    unsigned int threads = resolve_thread_count(options.num_threads);
+    GenerationOptions item_options = options;
+    item_options.num_threads = (int)std::max<size_t>(1, threads / std::max<size_t>(items.size(), 1));
+
+    ThreadPool::global().parallel_for((int)items.size(), threads, [&](int n) {
+        if (generation_cancelled(options)) return;
+        const BatchItem& item = items[n];
+        cpu::make_level_set3(item.tri, item.x, item.origin, item.dx, item.nx, item.ny, item.nz,
+                             phis[n], item_options, stats ? &(*stats)[n] : nullptr);
+    });
+}
+
+} // namespace
+
+void make_level_set3_batch(
+    const std::vector<BatchItem>& items,
+    std::vector<Array3f>& phis,
+    const GenerationOptions& options,
+    std::vector<GenerationStats>* stats)
+{
+    // Auto: the items' estimates summed, context creation counted once; the CPU if any item does not fit the GPU
+    BackendEstimate chosen;
+    HardwareBackend backend = resolve_backend(options, [&]() {
+        BackendEstimate total;
+        bool gpu_feasible = !items.empty();
+        for (size_t n = 0; n < items.size(); ++n) {
+            const BatchItem& item = items[n];
+            BackendEstimate estimate = estimate_call(options, item.nx, item.ny, item.nz, item.tri.size(),
+                                                     n == 0 && !gpu_initialized.load());
+            total.cpu_ms += estimate.cpu_ms;
+            total.gpu_ms += estimate.gpu_ms;
+            total.gpu_streamed = total.gpu_streamed || estimate.gpu_streamed;
+            gpu_feasible = gpu_feasible && estimate.gpu_ms > 0.0;
+        }
+        if (!gpu_feasible) total.gpu_ms = 0.0;
+        total.backend = gpu_feasible && total.gpu_ms < total.cpu_ms ? HardwareBackend::GPU : HardwareBackend::CPU;
+        return total;
+    }, &chosen);
+    phis.resize(items.size());
+    auto reset_batch_stats = [&](HardwareBackend used) {
+        if (!stats) return;
+        stats->assign(items.size(), GenerationStats());
+        for (GenerationStats& item_stats : *stats) reset_stats(item_stats, used, options, chosen);
+    };
+    reset_batch_stats(backend);
+
+    if (backend == HardwareBackend::CPU) {
+        cpu_batch(items, phis, options, stats);
+    } else {
+#ifdef HAVE_CUDA
+        try {
+            gpu_initialized = true;
+            gpu::make_level_set3_batch(items, phis, options, stats);
+        } catch (const std::runtime_error& e) {
+            if (options.backend != HardwareBackend::Auto) throw;
+            std::cerr << "WARNING: GPU batch generation failed (" << e.what() << "), using CPU\n";
+            reset_batch_stats(HardwareBackend::CPU);
+            cpu_batch(items, phis, options, stats);
+        }
+#else
+        throw std::runtime_error(
+            "GPU backend requested but CUDA support is not available. "
+            "Rebuild with CUDA enabled or use HardwareBackend::CPU."
+        );
+#endif
+    }
+
+    if (generation_cancelled(options)) {
+        throw GenerationCancelled();
+    }
+}
+
+// ============================================================================
+// Isosurface Extraction
+// ============================================================================
+
+void extract_isosurface(
+    const Array3f& phi,
+    const Vec3f& origin,
+    const Vec3f& spacing,
+    float isolevel,
+    std::vector<Vec3f>& vertices,
+    std::vector<Vec3ui>& triangles,
+    HardwareBackend backend,
+    int num_threads)
+{
+    if (backend == HardwareBackend::Auto) {
+        backend = is_gpu_available() ? HardwareBackend::GPU : HardwareBackend::CPU;
+    }
+    if (backend == HardwareBackend::CPU) {
+        marching_cubes(phi, origin, spacing, isolevel, vertices, triangles, num_threads);
+        return;
+    }
+#ifdef HAVE_CUDA
+    gpu::marching_cubes(phi, origin, spacing, isolevel, vertices, triangles);
+#else
+    throw std::runtime_error(
+        "GPU backend requested but CUDA support is not available. "
+        "Rebuild with CUDA enabled or use HardwareBackend::CPU."
+    );
+#endif
+}
+
+void make_level_set3_mesh(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    float isolevel,
+    std::vector<Vec3f>& vertices,
+    std::vector<Vec3ui>& triangles,
+    const GenerationOptions& options,
+    Array3f* phi,
+    GenerationStats* stats)
+{
+    vertices.clear();
+    triangles.clear();
+    BackendEstimate chosen;
+    HardwareBackend backend = resolve_backend(options, [&]() {
+        return estimate_call(options, nx, ny, nz, tri.size(), !gpu_initialized.load());
+    }, &chosen);
+
+#ifdef HAVE_CUDA
+    if (backend == HardwareBackend::GPU) {
+        if (stats) reset_stats(*stats, backend, options, chosen);
+        try {
+            gpu_initialized = true;
+            gpu::make_level_set3_mesh(tri, x, origin, dx, nx, ny, nz, isolevel, vertices, triangles,
+                                      options, stats, nullptr, phi);
+            if (generation_cancelled(options)) {
+                throw GenerationCancelled();
+            }
+            return;
+        } catch (const GenerationCancelled&) {
+            throw;
+        } catch (const std::runtime_error& e) {
+            // Same fallback as make_level_set3(): Auto promises a result
+            if (options.backend != HardwareBackend::Auto) throw;
+            std::cerr << "WARNING: GPU generation failed (" << e.what() << "), using CPU\n";
+            backend = HardwareBackend::CPU;
+        }
+    }
+#endif
+
+    // The field on the host, then the CPU extractor (without CUDA a GPU request fails in generate())
+    GenerationOptions field_options = options;
+    field_options.backend = backend;
+    Array3f local_phi;
+    Array3f& field = phi ? *phi : local_phi;
+    generate(tri, x, origin, dx, nx, ny, nz, field, field_options, stats, nullptr);
+    if (stats) record_choice(*stats, options, chosen); // generate() saw an explicit backend
+    marching_cubes(field, origin, Vec3f(dx, dx, dx), isolevel, vertices, triangles, options.num_threads);
+}
+
+// ============================================================================
+// Asynchronous Generation
+// ============================================================================
+
+struct GenerationJob::State {
+    std::atomic<bool> cancel{false};
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+    std::exception_ptr error;
+    std::vector<Vec3ui> tri;  ///< Mesh owned by the job (empty for context jobs)
+    std::vector<Vec3f> x;
+    Array3f phi;
+    GenerationStats stats;
+};
+
+namespace {
+
+/**
+ * @brief Run body on the backend's executor and mark the job finished afterwards
+ *
+ * GPU jobs get a detached host thread (so device waits do not occupy pool workers); CPU jobs
+ * are submitted to the global pool, which is given at least one worker for them.
+ */
+std::shared_ptr<GenerationJob::State> start_job(
+    std::shared_ptr<GenerationJob::State> state,
+    const GenerationOptions& options,
+    std::function<void(GenerationJob::State&, const GenerationOptions&)> body)
+{
+    GenerationOptions job_options = options;
+    job_options.cancel = &state->cancel;
+
+    auto task = [state, job_options, body]() {
+        std::exception_ptr error;
+        try {
+            body(*state, job_options);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->error = error;
+        state->done = true;
+        state->finished.notify_all();
+    };
+
+    bool gpu = options.distance_mode != DistanceMode::Exact &&
+               (options.backend == HardwareBackend::GPU ||
+                (options.backend == HardwareBackend::Auto && is_gpu_available()));
+    if (gpu) {
+        std::thread(task).detach();
+    } else {
+        ThreadPool& pool = ThreadPool::global();
+        pool.reserve(1);
+        pool.submit(task);
+    }
+    return state;
+}
+
+} // namespace
+
+GenerationJob::GenerationJob() = default;
+
+GenerationJob::GenerationJob(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+GenerationJob::~GenerationJob() {
+    if (state_) {
+        cancel();
+        wait();
+    }
+}
+
+GenerationJob::GenerationJob(GenerationJob&& other) noexcept = default;
+
+GenerationJob& GenerationJob::operator=(GenerationJob&& other) noexcept {
+    if (this != &other) {
+        if (state_) {
+            cancel();
+            wait();
+        }
+        state_ = std::move(other.state_);
+    }
+    return *this;
+}
+
+bool GenerationJob::ready() const {
+    if (!state_) return false;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->done;
+}
+
+void GenerationJob::wait() const {
+    if (!state_) return;
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->finished.wait(lock, [this]() { return state_->done; });
+}
+
+void GenerationJob::cancel() {
+    if (state_) state_->cancel.store(true, std::memory_order_relaxed);
+}
+
+void GenerationJob::get(Array3f& phi, GenerationStats* stats) {
+    if (!state_) {
+        throw std::logic_error("GenerationJob::get() called on an invalid job");
+    }
+    wait();
+    std::shared_ptr<State> state = std::move(state_);
+    if (state->error) std::rethrow_exception(state->error);
+    // Array3::swap() is declared for the default storage type only, so swap the members
+    std::swap(phi.ni, state->phi.ni);
+    std::swap(phi.nj, state->phi.nj);
+    std::swap(phi.nk, state->phi.nk);
+    phi.a.swap(state->phi.a);
+    if (stats) *stats = state->stats;
+}
+
+GenerationJob make_level_set3_async(
+    std::vector<Vec3ui> tri,
+    std::vector<Vec3f> x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    const GenerationOptions& options)
+{
+    auto state = std::make_shared<GenerationJob::State>();
+    state->tri = std::move(tri);
+    state->x = std::move(x);
+    return GenerationJob(start_job(std::move(state), options,
+        [origin, dx, nx, ny, nz](GenerationJob::State& job, const GenerationOptions& job_options) {
+            generate(job.tri, job.x, origin, dx, nx, ny, nz, job.phi, job_options, &job.stats, nullptr);
+        }));
+}
+
+GenerationJob make_level_set3_async(
+    GenerationContext& context,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    const GenerationOptions& options)
+{
+    GenerationContext* session = &context;
+    return GenerationJob(start_job(std::make_shared<GenerationJob::State>(), options,
+        [session, origin, dx, nx, ny, nz](GenerationJob::State& job, const GenerationOptions& job_options) {
+            make_level_set3(*session, origin, dx, nx, ny, nz, job.phi, job_options, &job.stats);
+        }));
+}
+
+bool is_gpu_available() {
+#ifdef HAVE_CUDA
+    // Check at runtime if a CUDA-capable GPU is actually present
+    int device_count = 0;
+    cudaError_t error = cudaGetDeviceCount(&device_count);
+    return (error == cudaSuccess && device_count > 0);
+#else
+    return false;
+#endif
+}
+
+int gpu_device_count() {
+#ifdef HAVE_CUDA
+    int device_count = 0;
+    if (cudaGetDeviceCount(&device_count) != cudaSuccess) return 0;
+    return device_count;
+#else
+    return 0;
+#endif
+}
+
+BackendEstimate estimate_backend(const GenerationOptions& options, int nx, int ny, int nz, size_t num_triangles)
+{
+    return estimate_call(options, nx, ny, nz, num_triangles, !gpu_initialized.load());
+}
+
+BackendCostModel backend_cost_model() {
+    CostModelState& state = cost_model_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.loaded) {
+        state.loaded = true;
+        const char* path = std::getenv("SDFGEN_COST_MODEL");
+        if (path && *path) load_cost_model(path, state.model);
+    }
+    return state.model;
+}
+
+void set_backend_cost_model(const BackendCostModel& model) {
+    CostModelState& state = cost_model_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.loaded = true;
+    state.model = model;
+}
+
+PhaseHook nvtx_phase_hook() {
+#ifdef HAVE_CUDA
+    return gpu::nvtx_phase_hook();
+#else
+    return PhaseHook();
+#endif
+}
+
+void make_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    Array3f& phi,
+    int exact_band,
+    HardwareBackend backend,
+    int num_threads)
+{
+    GenerationOptions options;
+    options.backend = backend;
+    options.exact_band = exact_band;
+    options.num_threads = num_threads;
+    make_level_set3(tri, x, origin, dx, nx, ny, nz, phi, options);
+}
+
+void make_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    Array3f& phi,
+    const GenerationOptions& options,
+    GenerationStats* stats)
+{
+    generate(tri, x, origin, dx, nx, ny, nz, phi, options, stats, nullptr);
+}
+
+void make_level_set3(
+    GenerationContext& context,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    Array3f& phi,
+    const GenerationOptions& options,
+    GenerationStats* stats)
+{
+#ifdef HAVE_CUDA
+    gpu::GpuContext* gpu_context = &context.impl_->gpu;
+#else
+    gpu::GpuContext* gpu_context = nullptr;
+#endif
+    generate(context.tri_, context.x_, origin, dx, nx, ny, nz, phi, options, stats, gpu_context);
+}
+
+// ============================================================================
+// Regions of Interest and Pyramids
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief The context's triangles that can affect a grid, through its cached BVH
+ */
+void cull_to_grid(std::unique_ptr<TriangleBVH>& index, const std::vector<Vec3ui>& tri, const std::vector<Vec3f>& x,
+                  const Vec3f& origin, float dx, int nx, int ny, int nz, const GenerationOptions& options,
+                  std::vector<Vec3ui>& region)
+{
+    if (!index) index.reset(new TriangleBVH(tri, x));
+    cpu::region_triangles(*index, tri, origin, dx, nx, ny, nz, options, region);
+}
+
+} // namespace
+
+void roi_grid(const Vec3f& lattice_origin, float dx, const Vec3f& roi_min, const Vec3f& roi_max,
+              Vec3f& origin, int& nx, int& ny, int& nz)
+{
+    int* dims[3] = {&nx, &ny, &nz};
+    for (int a = 0; a < 3; ++a) {
+        int lo = (int)std::floor((roi_min[a] - lattice_origin[a]) / dx);
+        int hi = (int)std::ceil((roi_max[a] - lattice_origin[a]) / dx);
+        origin[a] = lattice_origin[a] + lo * dx;
+        *dims[a] = std::max(1, hi - lo + 1);
+    }
+}
+
+void make_roi_level_set3(
+    GenerationContext& context,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    Array3f& phi,
+    const GenerationOptions& options,
+    GenerationStats* stats,
+    size_t* region_triangles)
+{
+    std::vector<Vec3ui> region;
+    cull_to_grid(context.impl_->index, context.tri_, context.x_, origin, dx, nx, ny, nz, options, region);
+    if (region_triangles) *region_triangles = region.size();
+    // per-call device buffers: the resident mesh of the context is the whole mesh
+    generate(region, context.x_, origin, dx, nx, ny, nz, phi, options, stats, nullptr);
+}
+
+void make_level_set_pyramid3(
+    GenerationContext& context,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    int levels,
+    std::vector<Array3f>& pyramid,
+    const GenerationOptions& options,
+    GenerationStats* stats)
+{
+    begin_cpu_only("Pyramid generation", options, stats, false);
+    if (levels < 1) {
+        throw std::runtime_error("Pyramid generation needs at least one level");
+    }
+    // cull for the coarsest level, whose band reaches farthest; its grid covers the finest
+    int shift = 0;
+    while (shift + 1 < levels && ((nx - 1) >> (shift + 1)) >= 1 && ((ny - 1) >> (shift + 1)) >= 1 &&
+           ((nz - 1) >> (shift + 1)) >= 1) {
+        ++shift;
+    }
+    const int f = 1 << shift;
+    std::vector<Vec3ui> region;
+    cull_to_grid(context.impl_->index, context.tri_, context.x_, origin, dx * f, (nx + f - 2) / f + 1,
+                 (ny + f - 2) / f + 1, (nz + f - 2) / f + 1, options, region);
+    cpu::make_level_set_pyramid3(region, context.x_, origin, dx, nx, ny, nz, levels, pyramid, options, stats);
+    if (generation_cancelled(options)) {
+        throw GenerationCancelled();
+    }
+}
+
+// ============================================================================
+// Point Queries
+// ============================================================================
+
+namespace {
+
+// Auto sends batches of at least this many points to the GPU; below it the upload and launch
+// cost more than the CPU needs for the whole batch
+const size_t gpu_query_min_points = 65536;
+
+} // namespace
+
+void query_points(
+    GenerationContext& context,
+    const Vec3f* points,
+    size_t count,
+    float* distance,
+    const GenerationOptions& options,
+    GenerationStats* stats,
+    int* closest_tri,
+    Vec3f* barycentric)
+{
+    GenerationContext::Impl& impl = *context.impl_;
+    if (!impl.index) impl.index.reset(new TriangleBVH(context.tri_, context.x_));
+    if (options.sign_mode == SignMode::WindingNumber && !impl.winding) {
+        impl.winding.reset(new WindingNumberTree(context.tri_, context.x_));
+    }
+
+    HardwareBackend backend = options.backend;
+    if (backend == HardwareBackend::Auto) {
+        backend = count >= gpu_query_min_points && is_gpu_available() ? HardwareBackend::GPU : HardwareBackend::CPU;
+    }
+    auto reset_query_stats = [&](HardwareBackend used) {
+        if (!stats) return;
+        *stats = GenerationStats();
+        stats->backend_used = used;
+    };
+    reset_query_stats(backend);
+
+    if (backend == HardwareBackend::GPU) {
+#ifdef HAVE_CUDA
+        try {
+            gpu_initialized = true;
+            gpu::query_points(*impl.index, impl.winding.get(), points, count, distance, closest_tri, barycentric,
+                              options, stats, impl.gpu);
+            if (generation_cancelled(options)) {
+                throw GenerationCancelled();
+            }
+            return;
+        } catch (const GenerationCancelled&) {
+            throw;
+        } catch (const std::runtime_error& e) {
+            if (options.backend != HardwareBackend::Auto) throw;
+            std::cerr << "WARNING: GPU point query failed (" << e.what() << "), using CPU\n";
+            reset_query_stats(HardwareBackend::CPU);
+        }
+#else
+        throw std::runtime_error(
+            "GPU backend requested but CUDA support is not available. "
+            "Rebuild with CUDA enabled or use HardwareBackend::CPU."
+        );
+#endif
+    }
+
+    cpu::query_points(context.tri_, context.x_, *impl.index, impl.winding.get(), points, count, distance,
+                      closest_tri, barycentric, options, stats);
+    if (generation_cancelled(options)) {
+        throw GenerationCancelled();
+    }
 }
 
 } // namespace sdfgen
@@ -6,19 +6,19 @@
 
 #include "array3.h"
 #include "vec.h"
+#include "backend_cost.h"
+#include "sdfgen_options.h"
+#include "compact_level_set.h"
+#include "level_set_state.h"
+#include "octree_level_set.h"
+#include "sparse_level_set.h"
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace sdfgen {
 
-/**
- * @brief Hardware backend selection for SDF generation
- */
-enum class HardwareBackend {
-    Auto,  /**< Try GPU first, fall back to CPU if unavailable */
-    CPU,   /**< Force CPU implementation */
-    GPU    /**< Force GPU implementation (fails if CUDA not available) */
-};
-
 /**
  * @brief Generate a signed distance field from a triangle mesh
  *
@@ -39,7 +39,9 @@ enum class HardwareBackend {
  * @param phi Output SDF grid (will be resized to nx*ny*nz)
  * @param exact_band Distance band in cells for exact computation (default: 1)
  * @param backend Hardware selection: Auto, CPU, or GPU (default: Auto)
- * @param num_threads CPU thread count, 0 = auto-detect (only used for CPU backend)
+ * @param num_threads CPU thread count, 0 = auto-detect (only used for CPU backend). Work runs on a
+ *        persistent process-wide pool (sdfgen::ThreadPool::global()), so repeated calls do not
+ *        pay thread creation costs
  *
  * @note When backend is Auto, GPU is tried first and falls back to CPU if unavailable
  * @note The exact_band parameter controls accuracy vs performance tradeoff
@@ -56,6 +58,607 @@ void make_level_set3(
     int num_threads = 0
 );
 
+/**
+ * @brief Generate a signed distance field with full control over generation options
+ *
+ * Same as the positional overload, with all tuning knobs collected in a GenerationOptions
+ * struct so new settings can be added without growing the argument list.
+ *
+ * @param tri Triangle indices (mesh topology), each Vec3ui contains 3 vertex indices
+ * @param x Vertex positions (mesh geometry) in world coordinates
+ * @param origin Grid origin point in world space (corner of grid)
+ * @param dx Grid cell spacing (uniform in all dimensions)
+ * @param nx Grid dimension in X (number of cells)
+ * @param ny Grid dimension in Y (number of cells)
+ * @param nz Grid dimension in Z (number of cells)
+ * @param phi Output SDF grid (will be resized to nx*ny*nz)
+ * @param options Backend, exact band, thread count and algorithm selection
+ * @param stats Optional output: backend used and, with options.diagnostics, field statistics
+ */
+void make_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    Array3f& phi,
+    const GenerationOptions& options,
+    GenerationStats* stats = nullptr
+);
+
+/**
+ * @brief Generation session that keeps a mesh and GPU device memory between calls
+ *
+ * Holds a copy of the mesh plus, once the GPU backend has run, a pool of device buffers with
+ * the mesh resident on the device. Generating the same mesh at several resolutions, or many
+ * meshes at one grid size (via set_mesh()), then skips the per-call allocations and, for an
+ * unchanged mesh, the upload. CPU generation uses the stored mesh and the global thread pool.
+ * A context must not be used from several threads at once.
+ */
+class GenerationContext {
+public:
+    GenerationContext();
+
+    /**
+     * @brief Create a context holding a mesh
+     * @param tri Triangle indices (copied, or moved from when passed an rvalue)
+     * @param x Vertex positions (copied, or moved from when passed an rvalue)
+     */
+    GenerationContext(std::vector<Vec3ui> tri, std::vector<Vec3f> x);
+
+    ~GenerationContext();
+    GenerationContext(const GenerationContext&) = delete;
+    GenerationContext& operator=(const GenerationContext&) = delete;
+
+    /**
+     * @brief Replace the mesh; device buffers are kept and reused for the next upload
+     * @param tri Triangle indices
+     * @param x Vertex positions
+     */
+    void set_mesh(std::vector<Vec3ui> tri, std::vector<Vec3f> x);
+
+    const std::vector<Vec3ui>& triangles() const { return tri_; }
+    const std::vector<Vec3f>& vertices() const { return x_; }
+
+    /** @brief Free cached device memory; the mesh is kept and re-uploaded on demand */
+    void release();
+
+    /** @brief Device bytes currently cached (0 without CUDA or before a GPU run) */
+    size_t device_bytes() const;
+
+private:
+    friend void make_level_set3(GenerationContext&, const Vec3f&, float, int, int, int, Array3f&,
+                                const GenerationOptions&, GenerationStats*);
+    friend void make_roi_level_set3(GenerationContext&, const Vec3f&, float, int, int, int, Array3f&,
+                                    const GenerationOptions&, GenerationStats*, size_t*);
+    friend void make_level_set_pyramid3(GenerationContext&, const Vec3f&, float, int, int, int, int,
+                                        std::vector<Array3f>&, const GenerationOptions&, GenerationStats*);
+    friend void query_points(GenerationContext&, const Vec3f*, size_t, float*, const GenerationOptions&,
+                             GenerationStats*, int*, Vec3f*);
+
+    struct Impl;
+    std::vector<Vec3ui> tri_;
+    std::vector<Vec3f> x_;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Generate a signed distance field for the mesh held by a GenerationContext
+ *
+ * Equivalent to the options overload on context.triangles()/context.vertices(); on the GPU the
+ * context's device buffers and resident mesh are reused.
+ *
+ * @param context Session holding the mesh and cached device memory
+ * @param origin Grid origin point in world space (corner of grid)
+ * @param dx Grid cell spacing (uniform in all dimensions)
+ * @param nx Grid dimension in X (number of cells)
+ * @param ny Grid dimension in Y (number of cells)
+ * @param nz Grid dimension in Z (number of cells)
+ * @param phi Output SDF grid (will be resized to nx*ny*nz)
+ * @param options Backend, exact band, thread count and algorithm selection
+ * @param stats Optional output: backend used and, with options.diagnostics, field statistics
+ */
+void make_level_set3(
+    GenerationContext& context,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    Array3f& phi,
+    const GenerationOptions& options,
+    GenerationStats* stats = nullptr
+);
+
+/**
+ * @brief Snap a region of interest to the node lattice of a larger grid
+ *
+ * The region grid covers [roi_min, roi_max] with the nodes of the lattice origin + i*dx
+ * that enclose it, so its nodes coincide (up to float rounding) with those of the full grid.
+ *
+ * @param lattice_origin Origin of the full grid
+ * @param dx Grid cell spacing
+ * @param roi_min Lower corner of the region in world space
+ * @param roi_max Upper corner of the region in world space
+ * @param origin Output origin of the region grid
+ * @param nx Output nodes in X (at least 1)
+ * @param ny Output nodes in Y (at least 1)
+ * @param nz Output nodes in Z (at least 1)
+ */
+void roi_grid(const Vec3f& lattice_origin, float dx, const Vec3f& roi_min, const Vec3f& roi_max,
+              Vec3f& origin, int& nx, int& ny, int& nz);
+
+/**
+ * @brief Generate the field over a sub-box of space without generating the whole grid
+ *
+ * Culls the context's mesh to the triangles that can affect the grid (see
+ * cpu::region_triangles(); a BVH over the mesh is built on first use and kept until
+ * set_mesh()) and generates on those, so the cost follows the region volume and the
+ * triangles near it instead of the whole domain. Signs and the values within exact_band*dx
+ * of the surface are those of make_level_set3() on the whole mesh over the same grid, and
+ * match the corresponding part of a full-domain grid up to float rounding of the node
+ * positions; far-field nodes can see different nearest triangles because the sweeps start
+ * at the region boundary. Use roi_grid() to place the region on the lattice of a full grid.
+ *
+ * @param context Session holding the mesh
+ * @param origin Origin of the region grid
+ * @param dx Grid cell spacing
+ * @param nx Grid dimension in X
+ * @param ny Grid dimension in Y
+ * @param nz Grid dimension in Z
+ * @param phi Output SDF grid (will be resized to nx*ny*nz)
+ * @param options Backend, exact band, thread count and algorithm selection
+ * @param stats Optional statistics
+ * @param region_triangles Optional output: number of triangles kept by the culling
+ *
+ * @throws GenerationCancelled If options.cancel was raised
+ */
+void make_roi_level_set3(
+    GenerationContext& context,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    Array3f& phi,
+    const GenerationOptions& options,
+    GenerationStats* stats = nullptr,
+    size_t* region_triangles = nullptr
+);
+
+/**
+ * @brief Generate a coarse-to-fine pyramid of fields, each level seeded from the one above
+ *
+ * pyramid[0] is the grid (origin, dx, nx, ny, nz); pyramid[s] has spacing dx*2^s and
+ * ((n-1)>>s)+1 nodes per axis, sharing the nodes of the finer levels. Finer levels only
+ * compute their own near band and take the far field from the coarser level's nearest
+ * triangles, corrected by one sweep pass instead of two (see cpu::make_level_set_pyramid3()).
+ * The mesh is culled to the grid as in make_roi_level_set3(), so the grid may be a region.
+ *
+ * Runs on the CPU: Auto resolves to CPU and an explicit GPU backend is rejected.
+ *
+ * @param context Session holding the mesh
+ * @param origin Grid origin point in world space
+ * @param dx Spacing of the finest level
+ * @param nx Nodes in X of the finest level
+ * @param ny Nodes in Y of the finest level
+ * @param nz Nodes in Z of the finest level
+ * @param levels Levels requested; reduced until the coarsest has at least 2 nodes per axis
+ * @param pyramid Output fields, finest first
+ * @param options Generation options as for make_level_set3()
+ * @param stats Optional statistics summed over the levels
+ *
+ * @throws std::runtime_error If options.backend is GPU or levels < 1
+ * @throws GenerationCancelled If options.cancel was raised
+ */
+void make_level_set_pyramid3(
+    GenerationContext& context,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    int levels,
+    std::vector<Array3f>& pyramid,
+    const GenerationOptions& options,
+    GenerationStats* stats = nullptr
+);
+
+/**
+ * @brief Signed distance from the context's mesh at scattered points, without a grid
+ *
+ * For consumers that need the field at a set of samples (particle seeding, collision
+ * queries) rather than on a lattice. Each point gets the exact nearest-triangle distance,
+ * signed by options.sign_mode (Parity, RayVote or WindingNumber), and optionally its nearest
+ * triangle and the barycentric weights of the nearest point on it (see cpu::query_points()).
+ * The BVH, and the winding-number tree when that sign mode is used, are built on the first
+ * query and kept until set_mesh(); on the GPU they stay resident on the device with the mesh,
+ * so later batches only transfer the points and results.
+ *
+ * On the CPU, a point on a grid node gets exactly the distance make_level_set3() with
+ * DistanceMode::Exact gives that node, and the same sign unless it lies on the surface. The GPU runs one thread per
+ * point over the same tree and distance function; distances agree to float rounding, and
+ * signs can differ only for points on the surface or, with winding numbers, where the
+ * winding number is within rounding of 0.5. Auto uses the GPU when one is available and the
+ * batch has at least 65536 points, and falls back to the CPU if the GPU fails.
+ *
+ * @param context Session holding the mesh and the cached query structures
+ * @param points Query points in world coordinates
+ * @param count Number of points
+ * @param distance Output signed distances, count entries (negative inside); +infinity for an empty mesh
+ * @param options Backend, sign_mode, num_threads and cancel
+ * @param stats Optional statistics: backend used, distance_evaluations (CPU), winding_evaluations
+ *        and host_bytes / device_bytes of the query structures
+ * @param closest_tri Optional output: nearest triangle of each point (count entries, -1 for an empty mesh)
+ * @param barycentric Optional output: weights w of the nearest point w[0]*a+w[1]*b+w[2]*c on the
+ *        corners of that triangle (count entries)
+ *
+ * @throws std::runtime_error If the GPU backend is requested but unavailable
+ * @throws GenerationCancelled If options.cancel was raised
+ */
+void query_points(
+    GenerationContext& context,
+    const Vec3f* points,
+    size_t count,
+    float* distance,
+    const GenerationOptions& options = GenerationOptions(),
+    GenerationStats* stats = nullptr,
+    int* closest_tri = nullptr,
+    Vec3f* barycentric = nullptr
+);
+
+/**
+ * @brief Generate a narrow-band signed distance field stored as sparse 8^3 bricks
+ *
+ * For consumers that only need |phi| < exact_band*dx. Only tiles the surface band reaches
+ * hold values; the rest of the grid is one inside/outside flag per tile, so memory scales
+ * with the surface area instead of the volume (see cpu::make_sparse_level_set3()). Write the
+ * result with write_sparse_sdf() or expand it with SparseLevelSet::to_dense().
+ *
+ * Runs on the CPU: Auto resolves to CPU and an explicit GPU backend is rejected.
+ *
+ * @param tri Triangle indices (mesh topology), each Vec3ui contains 3 vertex indices
+ * @param x Vertex positions (mesh geometry) in world coordinates
+ * @param origin Grid origin point in world space (corner of grid)
+ * @param dx Grid cell spacing (uniform in all dimensions)
+ * @param nx Grid dimension in X (number of cells)
+ * @param ny Grid dimension in Y (number of cells)
+ * @param nz Grid dimension in Z (number of cells)
+ * @param phi Output narrow-band field
+ * @param options exact_band is the band half-width in cells (at least 1); num_threads applies
+ * @param stats Optional statistics
+ *
+ * @throws std::runtime_error If options.backend is GPU or options.sign_mode is not Parity
+ * @throws GenerationCancelled If options.cancel was raised
+ */
+void make_sparse_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    SparseLevelSet& phi,
+    const GenerationOptions& options = GenerationOptions(),
+    GenerationStats* stats = nullptr
+);
+
+/**
+ * @brief Generate a dense signed distance field in 16 bits per node, clamped to a band
+ *
+ * For grids too large for make_level_set3(): values beyond exact_band*dx are clamped and
+ * each node is one fp16 or normalized int16 word, with no float grid or nearest-triangle
+ * array held during generation, so peak memory is about 2 bytes per node instead of 12
+ * (see cpu::make_compact_level_set3()). Write the result with write_compact_sdf() or expand
+ * it with CompactLevelSet::to_dense().
+ *
+ * Runs on the CPU: Auto resolves to CPU and an explicit GPU backend is rejected.
+ *
+ * @param tri Triangle indices (mesh topology), each Vec3ui contains 3 vertex indices
+ * @param x Vertex positions (mesh geometry) in world coordinates
+ * @param origin Grid origin point in world space (corner of grid)
+ * @param dx Grid cell spacing (uniform in all dimensions)
+ * @param nx Grid dimension in X (number of cells)
+ * @param ny Grid dimension in Y (number of cells)
+ * @param nz Grid dimension in Z (number of cells)
+ * @param format fp16 or normalized int16 storage
+ * @param phi Output field
+ * @param options exact_band is the clamp band in cells (at least 1); num_threads applies
+ * @param stats Optional statistics
+ *
+ * @throws std::runtime_error If options.backend is GPU or options.sign_mode is not Parity
+ * @throws GenerationCancelled If options.cancel was raised
+ */
+void make_compact_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    CompactFormat format,
+    CompactLevelSet& phi,
+    const GenerationOptions& options = GenerationOptions(),
+    GenerationStats* stats = nullptr
+);
+
+/**
+ * @brief Generate an adaptive signed distance field on an octree
+ *
+ * Refines down to dx only within exact_band cells of the surface and keeps large cells
+ * elsewhere, so fine resolutions fit where a dense grid would not (see
+ * cpu::make_octree_level_set3()). Every corner holds an exact signed distance; query with
+ * OctreeLevelSet::sample() (trilinear, optional level of detail), export with resample() or
+ * write_octree_sdf().
+ *
+ * Runs on the CPU: Auto resolves to CPU and an explicit GPU backend is rejected.
+ *
+ * @param tri Triangle indices (mesh topology), each Vec3ui contains 3 vertex indices
+ * @param x Vertex positions (mesh geometry) in world coordinates
+ * @param origin Grid origin point in world space (corner of grid)
+ * @param dx Finest cell spacing
+ * @param nx Grid dimension in X (number of cells)
+ * @param ny Grid dimension in Y (number of cells)
+ * @param nz Grid dimension in Z (number of cells)
+ * @param tree Output octree
+ * @param options exact_band is the refinement band in finest cells (at least 1); num_threads applies
+ * @param stats Optional statistics
+ *
+ * @throws std::runtime_error If options.backend is GPU, options.sign_mode is not Parity or a
+ *         dimension exceeds 2^21
+ * @throws GenerationCancelled If options.cancel was raised
+ */
+void make_octree_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    OctreeLevelSet& tree,
+    const GenerationOptions& options = GenerationOptions(),
+    GenerationStats* stats = nullptr
+);
+
+/**
+ * @brief Generate a signed distance field that can later be updated incrementally
+ *
+ * Same field as make_level_set3() on the CPU, returned in state.phi together with the nearest
+ * triangle of every node, the sign-pass crossing counts and a copy of the mesh (about 12 extra
+ * bytes per node). Pass the state to update_level_set3() after editing the mesh.
+ *
+ * Runs on the CPU: Auto resolves to CPU and an explicit GPU backend is rejected.
+ *
+ * @param tri Triangle indices (mesh topology), each Vec3ui contains 3 vertex indices
+ * @param x Vertex positions (mesh geometry) in world coordinates
+ * @param origin Grid origin point in world space (corner of grid)
+ * @param dx Grid cell spacing (uniform in all dimensions)
+ * @param nx Grid dimension in X (number of cells)
+ * @param ny Grid dimension in Y (number of cells)
+ * @param nz Grid dimension in Z (number of cells)
+ * @param state Output field and retained generation data
+ * @param options Generation options (exact band, threads, sweep, distance and sign mode); only a
+ *        state generated with SignMode::Parity can be passed to update_level_set3()
+ * @param stats Optional statistics
+ *
+ * @throws std::runtime_error If options.backend is GPU
+ * @throws GenerationCancelled If options.cancel was raised
+ */
+void make_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    LevelSetState& state,
+    const GenerationOptions& options = GenerationOptions(),
+    GenerationStats* stats = nullptr
+);
+
+/**
+ * @brief Update a field after a subset of its mesh's triangles moved, was removed or was added
+ *
+ * Only the nodes that were measured to the edited triangles, the new near band of those
+ * triangles and the front re-propagated from them are recomputed, plus the signs of the (j,k)
+ * rows the old and new triangles cross, so the latency scales with the edit rather than the
+ * grid (see cpu::update_level_set3() for the index conventions and accuracy). The near band
+ * and the signs match a full regeneration; the far field is propagated in a different order
+ * than the sweeps and can differ within the usual far-field approximation.
+ *
+ * @param tri Triangle indices of the edited mesh
+ * @param x Vertex positions of the edited mesh
+ * @param changed Indices of every changed triangle, including removed (index >= tri.size())
+ *        and added (index >= previous triangle count) ones
+ * @param state Field and retained data, updated in place
+ * @param options Only the backend (CPU or Auto) and cancel are used; sign_mode must be Parity
+ * @param stats Optional statistics; cells_updated counts the node writes
+ *
+ * @throws std::runtime_error If options.backend is GPU, the state holds no field, or the state
+ *         or options.sign_mode is not Parity (updates re-sign rows by crossing parity)
+ * @throws GenerationCancelled If options.cancel was raised (the state is then unspecified)
+ */
+void update_level_set3(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const std::vector<unsigned int>& changed,
+    LevelSetState& state,
+    const GenerationOptions& options = GenerationOptions(),
+    GenerationStats* stats = nullptr
+);
+
+/**
+ * @brief Generate signed distance fields for many meshes in one call
+ *
+ * Meant for large numbers of small parts, where per-call overhead dominates. On the CPU the
+ * items are spread over the thread pool (each item gets threads / items.size() threads, at
+ * least one). On the GPU they are packed into shared device arrays and each phase runs as a
+ * single launch for the whole group (see gpu::make_level_set3_batch()). With the default
+ * sweep settings each grid is bit-identical to the single-mesh call on the same backend.
+ *
+ * @param items Meshes and grid geometry, one per output grid
+ * @param phis Output grids in item order (resized to items.size())
+ * @param options Options shared by all items
+ * @param stats Optional per-item statistics (resized to items.size())
+ */
+void make_level_set3_batch(
+    const std::vector<BatchItem>& items,
+    std::vector<Array3f>& phis,
+    const GenerationOptions& options,
+    std::vector<GenerationStats>* stats = nullptr
+);
+
+/**
+ * @brief Extract the isosurface phi = isolevel of a grid as an indexed triangle mesh
+ *
+ * Marching cubes with one shared vertex per crossed grid edge (see sdfgen::marching_cubes()).
+ * The GPU path (gpu::marching_cubes()) uploads the grid, compacts the active cells and writes
+ * the mesh at prefix-scanned offsets; it gives the same vertex positions and triangles in the
+ * same order as the CPU, numbered differently. Auto uses the GPU when one is available.
+ *
+ * @param phi Field sampled at the grid nodes
+ * @param origin Position of node (0, 0, 0)
+ * @param spacing Node spacing along x, y and z
+ * @param isolevel Value of the extracted surface
+ * @param vertices Output vertex positions (replaced)
+ * @param triangles Output triangles, indices into vertices (replaced)
+ * @param backend Hardware selection: Auto, CPU, or GPU
+ * @param num_threads CPU thread count, 0 = auto-detect (CPU backend only)
+ */
+void extract_isosurface(
+    const Array3f& phi,
+    const Vec3f& origin,
+    const Vec3f& spacing,
+    float isolevel,
+    std::vector<Vec3f>& vertices,
+    std::vector<Vec3ui>& triangles,
+    HardwareBackend backend = HardwareBackend::Auto,
+    int num_threads = 0
+);
+
+/**
+ * @brief Generate a signed distance field and extract its isosurface in one call
+ *
+ * For round-trip checks (mesh to field to mesh). On the GPU the surface is extracted from the
+ * device-resident field (see gpu::make_level_set3_mesh()), so unless phi is requested the
+ * volume never crosses to the host. On the CPU this is make_level_set3() followed by
+ * marching_cubes(). Nodes sit at origin + dx*(i, j, k).
+ *
+ * @param isolevel Value of the extracted surface
+ * @param vertices Output vertex positions (replaced)
+ * @param triangles Output triangles, indices into vertices (replaced)
+ * @param options Generation options, as make_level_set3()
+ * @param phi Optional: also receives the field
+ * @param stats Optional statistics, as make_level_set3()
+ *
+ * @throws GenerationCancelled If options.cancel was raised
+ */
+void make_level_set3_mesh(
+    const std::vector<Vec3ui>& tri,
+    const std::vector<Vec3f>& x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    float isolevel,
+    std::vector<Vec3f>& vertices,
+    std::vector<Vec3ui>& triangles,
+    const GenerationOptions& options,
+    Array3f* phi = nullptr,
+    GenerationStats* stats = nullptr
+);
+
+/**
+ * @brief Thrown when a generation is stopped through GenerationOptions::cancel or GenerationJob::cancel()
+ */
+class GenerationCancelled : public std::runtime_error {
+public:
+    GenerationCancelled() : std::runtime_error("SDF generation cancelled") {}
+};
+
+/**
+ * @brief Handle to a generation running in the background (see make_level_set3_async())
+ *
+ * Move-only. Destroying a job that is still running cancels it and waits for it to stop, so an
+ * abandoned job releases the CPU pool and the device promptly.
+ */
+class GenerationJob {
+public:
+    GenerationJob();
+    ~GenerationJob();
+    GenerationJob(GenerationJob&&) noexcept;
+    GenerationJob& operator=(GenerationJob&&) noexcept;
+    GenerationJob(const GenerationJob&) = delete;
+    GenerationJob& operator=(const GenerationJob&) = delete;
+
+    /** @brief True while the handle refers to a job whose result has not been taken */
+    bool valid() const { return static_cast<bool>(state_); }
+
+    /** @brief True once the job has finished (successfully, with an error, or cancelled) */
+    bool ready() const;
+
+    /** @brief Block until the job has finished */
+    void wait() const;
+
+    /**
+     * @brief Ask the job to stop; it does so at the next phase or sweep-iteration boundary
+     *
+     * Does not wait. get() then throws GenerationCancelled unless the job had already finished.
+     */
+    void cancel();
+
+    /**
+     * @brief Wait for the job and take its result; the handle becomes invalid
+     * @param phi Receives the SDF grid
+     * @param stats Optional: receives the job's GenerationStats
+     * @throws GenerationCancelled if the job was cancelled, or the exception the generation threw
+     */
+    void get(Array3f& phi, GenerationStats* stats = nullptr);
+
+    struct State;
+
+private:
+    explicit GenerationJob(std::shared_ptr<State> state);
+    friend GenerationJob make_level_set3_async(std::vector<Vec3ui>, std::vector<Vec3f>, const Vec3f&, float,
+                                               int, int, int, const GenerationOptions&);
+    friend GenerationJob make_level_set3_async(GenerationContext&, const Vec3f&, float, int, int, int,
+                                               const GenerationOptions&);
+
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief Start generating a signed distance field in the background
+ *
+ * Returns immediately; the caller can load or write other meshes while the job runs. CPU jobs
+ * run as a task on the process-wide ThreadPool (their parallel phases share it with other
+ * work). GPU jobs run on their own host thread, which issues all device work to its per-thread
+ * default stream, so jobs overlap with each other and with the caller's CUDA work. With Auto
+ * the backend is chosen when the job starts, with the same CPU fallback as the blocking call.
+ *
+ * @param tri Triangle indices (copied, or moved from when passed an rvalue)
+ * @param x Vertex positions (copied, or moved from when passed an rvalue)
+ * @param origin Grid origin point in world space (corner of grid)
+ * @param dx Grid cell spacing (uniform in all dimensions)
+ * @param nx Grid dimension in X (number of cells)
+ * @param ny Grid dimension in Y (number of cells)
+ * @param nz Grid dimension in Z (number of cells)
+ * @param options Generation options; options.cancel is replaced by the job's own flag (use
+ *        GenerationJob::cancel())
+ * @return Handle to the running job
+ */
+GenerationJob make_level_set3_async(
+    std::vector<Vec3ui> tri,
+    std::vector<Vec3f> x,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    const GenerationOptions& options
+);
+
+/**
+ * @brief Start generating the field for the mesh held by a GenerationContext in the background
+ *
+ * The context must outlive the job and must not be used for anything else until the job has
+ * finished (its device buffers are in use).
+ */
+GenerationJob make_level_set3_async(
+    GenerationContext& context,
+    const Vec3f& origin,
+    float dx,
+    int nx, int ny, int nz,
+    const GenerationOptions& options
+);
+
 /**
  * @brief Query if GPU acceleration is available at runtime
  *
@@ -67,4 +670,51 @@ void make_level_set3(
  */
 bool is_gpu_available();
 
+/**
+ * @brief Number of CUDA devices visible at runtime
+ *
+ * Valid ordinals for GenerationOptions::gpu_devices are 0 to gpu_device_count() - 1.
+ *
+ * @return Device count, 0 without CUDA support or devices
+ */
+int gpu_device_count();
+
+/**
+ * @brief Predict CPU and GPU times of make_level_set3() and the backend Auto would pick
+ *
+ * HardwareBackend::Auto runs this before every dense generation (make_level_set3(),
+ * make_level_set3_batch() with the items' estimates summed, make_level_set3_mesh()) and
+ * records the result in GenerationStats. The GPU is chosen only when it is available, the
+ * distance mode supports it, the grid fits the free device memory (in-core or streamed,
+ * per GenerationOptions::gpu_memory) and it is predicted to finish first; CUDA context
+ * creation is charged to the first GPU call of the process. Device memory is queried only
+ * when the GPU could win, so small grids never create a CUDA context. A GPU run that fails
+ * anyway still falls back to the CPU.
+ *
+ * @param num_triangles Triangles in the mesh
+ * @return Estimate from the current backend_cost_model()
+ */
+BackendEstimate estimate_backend(const GenerationOptions& options, int nx, int ny, int nz, size_t num_triangles);
+
+/**
+ * @brief Cost model HardwareBackend::Auto uses
+ *
+ * Loaded on first use from the file named by the SDFGEN_COST_MODEL environment variable
+ * (see benchmark_performance --calibrate), the BackendCostModel defaults otherwise.
+ */
+BackendCostModel backend_cost_model();
+
+/**
+ * @brief Replace the cost model for the rest of the process (thread-safe)
+ */
+void set_backend_cost_model(const BackendCostModel& model);
+
+/**
+ * @brief Phase hook marking each generation phase as an NVTX range for Nsight Systems
+ *
+ * Set it as GenerationOptions::phase_hook (or call it from your own hook). Empty without
+ * CUDA support or when the toolkit has no NVTX headers.
+ */
+PhaseHook nvtx_phase_hook();
+
 } // namespace sdfgen
@@ -0,0 +1,156 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "array3.h"
+#include "hashtable.h"
+#include "vec.h"
+
+namespace sdfgen {
+
+/**
+ * @brief Hash for 64-bit tile indices (HashTable only provides one for unsigned int)
+ */
+struct TileIndexHash
+{
+   unsigned int operator() (unsigned long long k) const
+   { return hash((unsigned int)k ^ hash((unsigned int)(k>>32))); }
+};
+
+/**
+ * @brief Narrow-band signed distance field stored as 8^3 bricks
+ *
+ * The grid is cut into tiles of brick_size^3 nodes. Tiles within the band of the surface
+ * are active and store one float per node in a brick; every other tile stores a single
+ * inside/outside flag and reads as -background or +background. Active bricks are found
+ * through a hash from tile index to brick slot, so memory is proportional to the number of
+ * tiles the surface touches plus one byte per tile for the flags, instead of 4 bytes (plus
+ * 8 bytes of generation scratch) per node for a dense Array3f.
+ *
+ * Brick values are stored i-fastest, like Array3: node (i,j,k) of tile (ti,tj,tk) is entry
+ * (i-ti*8) + 8*((j-tj*8) + 8*(k-tk*8)). Nodes of edge bricks that fall outside the grid
+ * hold background and are never read.
+ */
+class SparseLevelSet {
+public:
+   static const int brick_size=8;                                   /**< Nodes per brick edge */
+   static const int brick_cells=brick_size*brick_size*brick_size;   /**< Nodes per brick */
+
+   int ni, nj, nk;      /**< Grid dimensions in nodes */
+   Vec3f origin;        /**< World position of node (0,0,0) */
+   float dx;            /**< Node spacing */
+   float background;    /**< Magnitude reported outside the active bricks */
+
+   SparseLevelSet() : ni(0), nj(0), nk(0), dx(0), background(0), ti_(0), tj_(0), tk_(0) {}
+
+   /**
+    * @brief Clear the field and set its geometry; every tile starts inactive and outside
+    */
+   void reset(int ni_, int nj_, int nk_, const Vec3f &origin_, float dx_, float background_)
+   {
+      ni=ni_; nj=nj_; nk=nk_; origin=origin_; dx=dx_; background=background_;
+      ti_=(ni+brick_size-1)/brick_size;
+      tj_=(nj+brick_size-1)/brick_size;
+      tk_=(nk+brick_size-1)/brick_size;
+      coords_.clear();
+      values_.clear();
+      index_.clear();
+      inside_.assign((size_t)ti_*tj_*tk_, 0);
+   }
+
+   /** @brief Number of tiles along each axis */
+   int tiles_i() const { return ti_; }
+   int tiles_j() const { return tj_; }
+   int tiles_k() const { return tk_; }
+
+   /** @brief Linear index of tile (ti,tj,tk) */
+   unsigned long long tile_index(int ti, int tj, int tk) const
+   { return (unsigned long long)ti+(unsigned long long)ti_*((unsigned long long)tj+(unsigned long long)tj_*tk); }
+
+   /** @brief Number of active bricks */
+   size_t brick_count() const { return coords_.size(); }
+
+   /** @brief Tile coordinates of brick n */
+   const Vec3i &brick_coord(size_t n) const { return coords_[n]; }
+
+   /** @brief Values of brick n (brick_cells floats) */
+   float *brick_data(size_t n) { return &values_[n*brick_cells]; }
+   const float *brick_data(size_t n) const { return &values_[n*brick_cells]; }
+
+   /**
+    * @brief Brick slot of tile (ti,tj,tk), or -1 when the tile is inactive
+    */
+   int find_brick(int ti, int tj, int tk) const
+   {
+      int n;
+      return index_.get_entry(tile_index(ti,tj,tk), n) ? n : -1;
+   }
+
+   /**
+    * @brief Activate tile (ti,tj,tk) and return its brick slot
+    *
+    * A new brick is filled with +background. Not thread-safe; activate bricks first and fill
+    * them through brick_data() in parallel afterwards.
+    */
+   int add_brick(int ti, int tj, int tk)
+   {
+      int n=find_brick(ti,tj,tk);
+      if(n>=0) return n;
+      n=(int)coords_.size();
+      coords_.push_back(Vec3i(ti,tj,tk));
+      values_.resize(values_.size()+brick_cells, background);
+      index_.add(tile_index(ti,tj,tk), n);
+      return n;
+   }
+
+   /** @brief Inside flag of tile (ti,tj,tk), used for nodes of inactive tiles */
+   bool tile_inside(int ti, int tj, int tk) const { return inside_[tile_index(ti,tj,tk)]!=0; }
+   void set_tile_inside(int ti, int tj, int tk, bool inside) { inside_[tile_index(ti,tj,tk)]=inside ? 1 : 0; }
+
+   /**
+    * @brief Signed distance at node (i,j,k): the brick value, or +/-background
+    */
+   float operator() (int i, int j, int k) const
+   {
+      int ti=i/brick_size, tj=j/brick_size, tk=k/brick_size;
+      int n=find_brick(ti,tj,tk);
+      if(n<0) return tile_inside(ti,tj,tk) ? -background : background;
+      return values_[n*brick_cells+(i-ti*brick_size)+brick_size*((j-tj*brick_size)+brick_size*(k-tk*brick_size))];
+   }
+
+   /**
+    * @brief Expand to a dense grid (inactive tiles become +/-background)
+    */
+   void to_dense(Array3f &phi) const
+   {
+      phi.resize(ni, nj, nk);
+      for(int tk=0; tk<tk_; ++tk) for(int tj=0; tj<tj_; ++tj) for(int ti=0; ti<ti_; ++ti){
+         int n=find_brick(ti,tj,tk);
+         float fill=tile_inside(ti,tj,tk) ? -background : background;
+         int i1=min(ni, (ti+1)*brick_size), j1=min(nj, (tj+1)*brick_size), k1=min(nk, (tk+1)*brick_size);
+         for(int k=tk*brick_size; k<k1; ++k) for(int j=tj*brick_size; j<j1; ++j) for(int i=ti*brick_size; i<i1; ++i)
+            phi(i,j,k)=(n<0) ? fill : values_[n*brick_cells+(i-ti*brick_size)+brick_size*((j-tj*brick_size)+brick_size*(k-tk*brick_size))];
+      }
+   }
+
+   /** @brief Bytes held by bricks, brick index and tile flags */
+   size_t memory_bytes() const
+   {
+      return values_.size()*sizeof(float)+coords_.size()*sizeof(Vec3i)
+            +index_.pool.size()*sizeof(HashEntry<unsigned long long,int>)+index_.table.size()*sizeof(int)
+            +inside_.size();
+   }
+
+private:
+   int ti_, tj_, tk_;
+   std::vector<Vec3i> coords_;
+   std::vector<float> values_;
+   HashTable<unsigned long long,int,TileIndexHash> index_;
+   std::vector<unsigned char> inside_;
+};
+
+} // namespace sdfgen
@@ -0,0 +1,205 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sdfgen {
+
+/**
+ * @brief Resolve a user-facing thread count to the number of threads to run
+ *
+ * @param num_threads Requested thread count, 0 or negative = auto-detect
+ * @return std::thread::hardware_concurrency() for auto-detect (4 if unknown), else num_threads
+ */
+inline unsigned int resolve_thread_count(int num_threads)
+{
+    if (num_threads > 0) return (unsigned int)num_threads;
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 4 : threads; // fallback
+}
+
+/**
+ * @brief Persistent worker thread pool shared by all CPU phases
+ *
+ * Workers are created once and reused across sweeps and across calls, so small grids no
+ * longer pay thread creation costs 16 times per call. The pool grows on demand when a
+ * caller asks for more concurrency than it currently has, and never shrinks.
+ *
+ * parallel_for() lets the calling thread take part in the work, so it is safe to call
+ * from inside a pool task (nested calls cannot deadlock, they just get less help).
+ * Work items are identified by index; results that depend only on the index are
+ * therefore independent of how many threads ran them.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Create a pool with the given number of worker threads
+     * @param num_workers Worker threads to start (the caller of parallel_for is an extra executor)
+     */
+    explicit ThreadPool(unsigned int num_workers = 0)
+        : stopping_(false)
+    {
+        grow(num_workers);
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Process-wide pool used by the CPU backend (created on first use)
+     */
+    static ThreadPool& global()
+    {
+        static ThreadPool pool(resolve_thread_count(0) - 1);
+        return pool;
+    }
+
+    /** @brief Number of worker threads currently running */
+    unsigned int size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return (unsigned int)workers_.size();
+    }
+
+    /**
+     * @brief Ensure at least num_workers worker threads exist
+     */
+    void reserve(unsigned int num_workers)
+    {
+        grow(num_workers);
+    }
+
+    /**
+     * @brief Queue a task for asynchronous execution on a worker thread
+     */
+    void submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    /**
+     * @brief Run fn(index) for every index in [0, count) using up to max_threads executors
+     *
+     * Blocks until every index has completed. The calling thread counts as one executor.
+     * The first exception thrown by fn is rethrown here after all indices have finished.
+     *
+     * @param count Number of work items
+     * @param max_threads Maximum concurrency (0 = auto-detect)
+     * @param fn Callable taking the work item index
+     */
+    template<class Fn>
+    void parallel_for(int count, unsigned int max_threads, Fn fn)
+    {
+        if (count <= 0) return;
+        if (max_threads == 0) max_threads = resolve_thread_count(0);
+        unsigned int executors = std::min(max_threads, (unsigned int)count);
+        if (executors <= 1) {
+            for (int index = 0; index < count; ++index) fn(index);
+            return;
+        }
+        grow(executors - 1);
+
+        // Shared state outlives this call if a helper task is only dequeued after we return
+        struct Job {
+            std::function<void(int)> body;
+            int count;
+            std::atomic<int> next;
+            std::atomic<int> remaining;
+            std::mutex mutex;
+            std::condition_variable done;
+            std::exception_ptr error;
+        };
+        std::shared_ptr<Job> job = std::make_shared<Job>();
+        job->body = fn;
+        job->count = count;
+        job->next = 0;
+        job->remaining = count;
+
+        auto run = [](Job& j) {
+            for (int index = j.next++; index < j.count; index = j.next++) {
+                try {
+                    j.body(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(j.mutex);
+                    if (!j.error) j.error = std::current_exception();
+                }
+                if (--j.remaining == 0) {
+                    std::lock_guard<std::mutex> lock(j.mutex);
+                    j.done.notify_all();
+                }
+            }
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (unsigned int h = 0; h + 1 < executors; ++h) {
+                tasks_.push_back([job, run]() { run(*job); });
+            }
+        }
+        cv_.notify_all();
+
+        run(*job);
+
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->done.wait(lock, [&job]() { return job->remaining.load() == 0; });
+        if (job->error) std::rethrow_exception(job->error);
+    }
+
+private:
+    void grow(unsigned int num_workers)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (workers_.size() < num_workers) {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    void worker_loop()
+    {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) return; // stopping and drained
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> workers_;
+    bool stopping_;
+};
+
+} // namespace sdfgen
@@ -0,0 +1,272 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "triangle_distance.h"
+#include "vec.h"
+
+namespace sdfgen {
+
+/**
+ * @brief Node of a TriangleBVH
+ *
+ * Interior nodes have count==0 and their two children stored at first and first+1.
+ * Leaves have count>0 and reference triangles [first, first+count) of the BVH order.
+ */
+struct BVHNode {
+   Vec3f bmin, bmax; /**< Axis-aligned bounds of everything below this node */
+   int first;        /**< Left child index (interior) or first triangle slot (leaf) */
+   int count;        /**< Number of triangles in a leaf, 0 for interior nodes */
+};
+
+/**
+ * @brief Bounding volume hierarchy over a triangle mesh for nearest-triangle queries
+ *
+ * Median-split BVH over triangle centroids. The triangle corners are copied into BVH order
+ * so queries touch contiguous memory and the structure does not reference the input mesh
+ * after build(). Distances are computed with point_triangle_distance(), the same function
+ * the grid generators use, so query results are bit-identical to a brute-force minimum.
+ */
+class TriangleBVH {
+public:
+   TriangleBVH() {}
+
+   TriangleBVH(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x, int leaf_size=4)
+   { build(tri, x, leaf_size); }
+
+   /**
+    * @brief (Re)build the hierarchy for a mesh
+    * @param tri Triangle vertex indices
+    * @param x Vertex positions
+    * @param leaf_size Maximum triangles per leaf
+    */
+   void build(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x, int leaf_size=4)
+   {
+      nodes_.clear();
+      order_.resize(tri.size());
+      corners_.clear();
+      if(tri.empty()) return;
+
+      // centroids and per-triangle bounds drive the splits
+      std::vector<Vec3f> centroid(tri.size()), tmin(tri.size()), tmax(tri.size());
+      for(size_t t=0; t<tri.size(); ++t){
+         const Vec3f &a=x[tri[t][0]], &b=x[tri[t][1]], &c=x[tri[t][2]];
+         for(int axis=0; axis<3; ++axis){
+            tmin[t][axis]=min(a[axis], b[axis], c[axis]);
+            tmax[t][axis]=max(a[axis], b[axis], c[axis]);
+         }
+         centroid[t]=(a+b+c)/3.f;
+         order_[t]=(int)t;
+      }
+
+      struct Range { int node, begin, end; };
+      std::vector<Range> stack;
+      nodes_.reserve(2*tri.size()/std::max(1, leaf_size)+1);
+      nodes_.push_back(BVHNode());
+      stack.push_back(Range{0, 0, (int)tri.size()});
+      while(!stack.empty()){
+         Range r=stack.back(); stack.pop_back();
+         BVHNode node;
+         node.bmin=tmin[order_[r.begin]]; node.bmax=tmax[order_[r.begin]];
+         Vec3f cmin=centroid[order_[r.begin]], cmax=cmin;
+         for(int n=r.begin+1; n<r.end; ++n){
+            int t=order_[n];
+            for(int axis=0; axis<3; ++axis){
+               node.bmin[axis]=std::min(node.bmin[axis], tmin[t][axis]);
+               node.bmax[axis]=std::max(node.bmax[axis], tmax[t][axis]);
+               cmin[axis]=std::min(cmin[axis], centroid[t][axis]);
+               cmax[axis]=std::max(cmax[axis], centroid[t][axis]);
+            }
+         }
+         if(r.end-r.begin<=leaf_size){
+            node.first=r.begin;
+            node.count=r.end-r.begin;
+            nodes_[r.node]=node;
+            continue;
+         }
+         // split at the centroid median of the longest axis
+         Vec3f extent=cmax-cmin;
+         int axis=(extent[0]>=extent[1] && extent[0]>=extent[2]) ? 0 : (extent[1]>=extent[2] ? 1 : 2);
+         int mid=(r.begin+r.end)/2;
+         std::nth_element(order_.begin()+r.begin, order_.begin()+mid, order_.begin()+r.end,
+                          [&](int p, int q){ return centroid[p][axis]<centroid[q][axis] ||
+                                                    (centroid[p][axis]==centroid[q][axis] && p<q); });
+         node.first=(int)nodes_.size();
+         node.count=0;
+         nodes_[r.node]=node;
+         nodes_.push_back(BVHNode());
+         nodes_.push_back(BVHNode());
+         stack.push_back(Range{node.first+1, mid, r.end});
+         stack.push_back(Range{node.first, r.begin, mid});
+      }
+
+      corners_.resize(3*tri.size());
+      for(size_t n=0; n<order_.size(); ++n){
+         const Vec3ui &t=tri[order_[n]];
+         corners_[3*n]=x[t[0]]; corners_[3*n+1]=x[t[1]]; corners_[3*n+2]=x[t[2]];
+      }
+   }
+
+   /**
+    * @brief Find the triangle nearest to a point, within an upper bound
+    *
+    * Only triangles strictly closer than the incoming best_dist are accepted; among equally
+    * close triangles the lowest index wins, matching a brute-force loop with a strict "<".
+    * Seeding best_dist/best_tri with a nearby cell's answer prunes most of the tree.
+    *
+    * @param p Query point
+    * @param best_dist In: upper bound (and distance of best_tri if >=0). Out: nearest distance
+    * @param best_tri In: triangle achieving best_dist or -1. Out: nearest triangle index or -1
+    * @return Number of point-triangle distances evaluated
+    */
+   int nearest(const Vec3f &p, float &best_dist, int &best_tri) const
+   {
+      if(nodes_.empty()) return 0;
+      int evaluations=0;
+      struct Entry { int node; float d2; };
+      Entry stack[64];
+      int top=0;
+      stack[top++]=Entry{0, box_dist2(p, nodes_[0])};
+      while(top>0){
+         Entry e=stack[--top];
+         if(pruned(e.d2, best_dist)) continue;
+         const BVHNode &node=nodes_[e.node];
+         if(node.count>0){
+            evaluations+=node.count;
+            for(int n=node.first; n<node.first+node.count; ++n){
+               float d=point_triangle_distance(p, corners_[3*n], corners_[3*n+1], corners_[3*n+2]);
+               if(d<best_dist || (d==best_dist && best_tri>=0 && order_[n]<best_tri)){
+                  best_dist=d;
+                  best_tri=order_[n];
+               }
+            }
+            continue;
+         }
+         // visit the nearer child first
+         float d_left=box_dist2(p, nodes_[node.first]), d_right=box_dist2(p, nodes_[node.first+1]);
+         if(d_left<=d_right){
+            if(!pruned(d_right, best_dist)) stack[top++]=Entry{node.first+1, d_right};
+            if(!pruned(d_left, best_dist)) stack[top++]=Entry{node.first, d_left};
+         }else{
+            if(!pruned(d_left, best_dist)) stack[top++]=Entry{node.first, d_left};
+            if(!pruned(d_right, best_dist)) stack[top++]=Entry{node.first+1, d_right};
+         }
+      }
+      return evaluations;
+   }
+
+   /**
+    * @brief Number of triangles the line through p along an axis crosses at or below p[axis]
+    *
+    * Odd for points inside a closed mesh. Uses the same point_in_triangle_2d() test in the
+    * plane of the other two axes, (axis+1)%3 then (axis+2)%3, as the grid sign passes, where
+    * node i of a row counts the crossings at positions <= i, so a point on a grid node gets
+    * the same parity as that node.
+    *
+    * @param p Query point
+    * @param axis Ray direction: 0 (x, the parity sign), 1 (y) or 2 (z)
+    * @return Crossing count
+    */
+   int crossings_below(const Vec3f &p, int axis=0) const
+   {
+      if(nodes_.empty()) return 0;
+      const int u=(axis+1)%3, v=(axis+2)%3;
+      int count=0;
+      int stack[64];
+      int top=0;
+      stack[top++]=0;
+      while(top>0){
+         const BVHNode &node=nodes_[stack[--top]];
+         if(node.bmin[axis]>p[axis] || node.bmin[u]>p[u] || node.bmax[u]<p[u] || node.bmin[v]>p[v] || node.bmax[v]<p[v])
+            continue;
+         if(node.count==0){
+            stack[top++]=node.first;
+            stack[top++]=node.first+1;
+            continue;
+         }
+         for(int n=node.first; n<node.first+node.count; ++n){
+            const Vec3f &a=corners_[3*n], &b=corners_[3*n+1], &c=corners_[3*n+2];
+            double wa, wb, wc;
+            if(point_in_triangle_2d(p[u], p[v], a[u], a[v], b[u], b[v], c[u], c[v], wa, wb, wc)
+               && wa*a[axis]+wb*b[axis]+wc*c[axis]<=p[axis])
+               ++count;
+         }
+      }
+      return count;
+   }
+
+   /**
+    * @brief Original indices of the triangles whose bounds overlap the box [lo,hi]
+    *
+    * Appended to out in BVH order (sort them for input order). Pass -inf/+inf bounds for an
+    * open side.
+    */
+   void overlapping(const Vec3f &lo, const Vec3f &hi, std::vector<unsigned int> &out) const
+   {
+      if(nodes_.empty()) return;
+      int stack[64];
+      int top=0;
+      stack[top++]=0;
+      while(top>0){
+         const BVHNode &node=nodes_[stack[--top]];
+         if(!boxes_overlap(node.bmin, node.bmax, lo, hi)) continue;
+         if(node.count==0){
+            stack[top++]=node.first;
+            stack[top++]=node.first+1;
+            continue;
+         }
+         for(int n=node.first; n<node.first+node.count; ++n){
+            const Vec3f &a=corners_[3*n], &b=corners_[3*n+1], &c=corners_[3*n+2];
+            Vec3f tmin(min(a[0], b[0], c[0]), min(a[1], b[1], c[1]), min(a[2], b[2], c[2]));
+            Vec3f tmax(max(a[0], b[0], c[0]), max(a[1], b[1], c[1]), max(a[2], b[2], c[2]));
+            if(boxes_overlap(tmin, tmax, lo, hi)) out.push_back((unsigned int)order_[n]);
+         }
+      }
+   }
+
+   bool empty() const { return nodes_.empty(); }
+   const std::vector<BVHNode> &nodes() const { return nodes_; }
+   /** @brief Original triangle index of each BVH triangle slot */
+   const std::vector<int> &triangle_order() const { return order_; }
+   /** @brief Triangle corners in BVH slot order (3 per slot) */
+   const std::vector<Vec3f> &corners() const { return corners_; }
+
+   /** @brief Heap memory held by the hierarchy in bytes */
+   size_t memory_bytes() const
+   {
+      return nodes_.capacity()*sizeof(BVHNode)+order_.capacity()*sizeof(int)+corners_.capacity()*sizeof(Vec3f);
+   }
+
+private:
+   static float box_dist2(const Vec3f &p, const BVHNode &node)
+   {
+      float d2=0;
+      for(int axis=0; axis<3; ++axis){
+         float below=node.bmin[axis]-p[axis], above=p[axis]-node.bmax[axis];
+         if(below>0) d2+=below*below;
+         else if(above>0) d2+=above*above;
+      }
+      return d2;
+   }
+
+   static bool boxes_overlap(const Vec3f &amin, const Vec3f &amax, const Vec3f &bmin, const Vec3f &bmax)
+   {
+      return amin[0]<=bmax[0] && amax[0]>=bmin[0] && amin[1]<=bmax[1] && amax[1]>=bmin[1] &&
+             amin[2]<=bmax[2] && amax[2]>=bmin[2];
+   }
+
+   // Conservative: a little slack so float rounding in the box test never drops a triangle
+   // whose computed distance would tie or beat the current best
+   static bool pruned(float box_d2, float best_dist)
+   { return box_d2>best_dist*best_dist*(1+1e-5f)+1e-30f; }
+
+   std::vector<BVHNode> nodes_;
+   std::vector<int> order_;
+   std::vector<Vec3f> corners_;
+};
+
+} // namespace sdfgen
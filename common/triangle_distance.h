@@ -0,0 +1,165 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <cassert>
+#include "vec.h"
+
+// Geometric primitives shared by the grid generators and the BVH queries. Keeping a single
+// definition guarantees that every code path computes bit-identical distances.
+
+/**
+ * @brief Compute minimum distance from point to line segment
+ *
+ * Finds the closest point on segment x1-x2 to point x0 and returns the distance.
+ * Uses parametric representation and clamps parameter to [0,1] to handle segment endpoints.
+ *
+ * @param x0 Query point
+ * @param x1 First endpoint of line segment
+ * @param x2 Second endpoint of line segment
+ * @return Minimum Euclidean distance from x0 to segment
+ */
+inline float point_segment_distance(const Vec3f &x0, const Vec3f &x1, const Vec3f &x2)
+{
+   Vec3f dx(x2-x1);
+   double m2=mag2(dx);
+   // find parameter value of closest point on segment
+   float s12=(float)(dot(x2-x0, dx)/m2);
+   if(s12<0){
+      s12=0;
+   }else if(s12>1){
+      s12=1;
+   }
+   // and find the distance
+   return dist(x0, s12*x1+(1-s12)*x2);
+}
+
+/**
+ * @brief Compute minimum distance from point to triangle
+ *
+ * Calculates shortest distance from query point x0 to triangle with vertices x1, x2, x3.
+ * Uses barycentric coordinates to check if projection lies inside triangle. If outside,
+ * falls back to checking distances to the three edges.
+ *
+ * @param x0 Query point
+ * @param x1 First vertex of triangle
+ * @param x2 Second vertex of triangle
+ * @param x3 Third vertex of triangle
+ * @return Minimum Euclidean distance from x0 to triangle
+ */
+inline float point_triangle_distance(const Vec3f &x0, const Vec3f &x1, const Vec3f &x2, const Vec3f &x3)
+{
+   // first find barycentric coordinates of closest point on infinite plane
+   Vec3f x13(x1-x3), x23(x2-x3), x03(x0-x3);
+   float m13=mag2(x13), m23=mag2(x23), d=dot(x13,x23);
+   float invdet=1.f/max(m13*m23-d*d,1e-30f);
+   float a=dot(x13,x03), b=dot(x23,x03);
+   // the barycentric coordinates themselves
+   float w23=invdet*(m23*a-d*b);
+   float w31=invdet*(m13*b-d*a);
+   float w12=1-w23-w31;
+   if(w23>=0 && w31>=0 && w12>=0){ // if we're inside the triangle
+      return dist(x0, w23*x1+w31*x2+w12*x3); 
+   }else{ // we have to clamp to one of the edges
+      if(w23>0) // this rules out edge 2-3 for us
+         return min(point_segment_distance(x0,x1,x2), point_segment_distance(x0,x1,x3));
+      else if(w31>0) // this rules out edge 1-3
+         return min(point_segment_distance(x0,x1,x2), point_segment_distance(x0,x2,x3));
+      else // w12 must be >0, ruling out edge 1-2
+         return min(point_segment_distance(x0,x1,x3), point_segment_distance(x0,x2,x3));
+   }
+}
+
+/**
+ * @brief point_segment_distance() that also returns the segment parameter of the nearest point
+ * @param s12 Output: the nearest point is s12*x1+(1-s12)*x2, s12 in [0,1]
+ */
+inline float point_segment_distance(const Vec3f &x0, const Vec3f &x1, const Vec3f &x2, float &s12)
+{
+   Vec3f dx(x2-x1);
+   double m2=mag2(dx);
+   s12=(float)(dot(x2-x0, dx)/m2);
+   if(s12<0){
+      s12=0;
+   }else if(s12>1){
+      s12=1;
+   }
+   return dist(x0, s12*x1+(1-s12)*x2);
+}
+
+/**
+ * @brief point_triangle_distance() that also returns where on the triangle the nearest point is
+ *
+ * Same operations as the plain version, so the distance is bit-identical to it.
+ *
+ * @param w Output barycentric weights of the nearest point w[0]*x1+w[1]*x2+w[2]*x3 (each in
+ *        [0,1], summing to one up to rounding); on an edge the opposite corner's weight is 0
+ */
+inline float point_triangle_distance(const Vec3f &x0, const Vec3f &x1, const Vec3f &x2, const Vec3f &x3, Vec3f &w)
+{
+   Vec3f x13(x1-x3), x23(x2-x3), x03(x0-x3);
+   float m13=mag2(x13), m23=mag2(x23), d=dot(x13,x23);
+   float invdet=1.f/max(m13*m23-d*d,1e-30f);
+   float a=dot(x13,x03), b=dot(x23,x03);
+   float w23=invdet*(m23*a-d*b);
+   float w31=invdet*(m13*b-d*a);
+   float w12=1-w23-w31;
+   if(w23>=0 && w31>=0 && w12>=0){
+      w=Vec3f(w23, w31, w12);
+      return dist(x0, w23*x1+w31*x2+w12*x3);
+   }
+   // the two candidate edges, as corner pairs (p,q); ties keep the first like min()
+   int p0, q0, p1, q1;
+   if(w23>0){ p0=0; q0=1; p1=0; q1=2; }
+   else if(w31>0){ p0=0; q0=1; p1=1; q1=2; }
+   else{ p0=0; q0=2; p1=1; q1=2; }
+   const Vec3f *corner[3]={&x1, &x2, &x3};
+   float s0, s1;
+   float d0=point_segment_distance(x0, *corner[p0], *corner[q0], s0);
+   float d1=point_segment_distance(x0, *corner[p1], *corner[q1], s1);
+   w=Vec3f(0, 0, 0);
+   if(d1<d0){
+      w[p1]=s1; w[q1]=1-s1;
+      return d1;
+   }
+   w[p0]=s0; w[q0]=1-s0;
+   return d0;
+}
+
+// calculate twice signed area of triangle (0,0)-(x1,y1)-(x2,y2)
+// return an SOS-determined sign (-1, +1, or 0 only if it's a truly degenerate triangle)
+inline int orientation(double x1, double y1, double x2, double y2, double &twice_signed_area)
+{
+   twice_signed_area=y1*x2-x1*y2;
+   if(twice_signed_area>0) return 1;
+   else if(twice_signed_area<0) return -1;
+   else if(y2>y1) return 1;
+   else if(y2<y1) return -1;
+   else if(x1>x2) return 1;
+   else if(x1<x2) return -1;
+   else return 0; // only true when x1==x2 and y1==y2
+}
+
+// robust test of (x0,y0) in the triangle (x1,y1)-(x2,y2)-(x3,y3)
+// if true is returned, the barycentric coordinates are set in a,b,c.
+inline bool point_in_triangle_2d(double x0, double y0, 
+                                 double x1, double y1, double x2, double y2, double x3, double y3,
+                                 double& a, double& b, double& c)
+{
+   x1-=x0; x2-=x0; x3-=x0;
+   y1-=y0; y2-=y0; y3-=y0;
+   int signa=orientation(x2, y2, x3, y3, a);
+   if(signa==0) return false;
+   int signb=orientation(x3, y3, x1, y1, b);
+   if(signb!=signa) return false;
+   int signc=orientation(x1, y1, x2, y2, c);
+   if(signc!=signa) return false;
+   double sum=a+b+c;
+   assert(sum!=0); // if the SOS signs match and are nonkero, there's no way all of a, b, and c are zero.
+   a/=sum;
+   b/=sum;
+   c/=sum;
+   return true;
+}
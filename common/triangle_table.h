@@ -0,0 +1,130 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "vec.h"
+
+namespace sdfgen {
+
+/**
+ * @brief Precomputed per-triangle terms of point_triangle_distance()
+ *
+ * Everything in the distance computation that does not depend on the query point: the
+ * corners, the barycentric frame (x13, x23, m13, m23, d, invdet) and the three edge
+ * directions used by the segment fallbacks. The record is a flat block of 32 floats
+ * (128 bytes, two cache lines); x1, x2, x3 are read as 9 contiguous floats by the SIMD
+ * gathers and the GPU upload reads the first 29 floats in field order, so do not reorder.
+ */
+struct TriangleGeometry {
+   Vec3f x1, x2, x3;    /**< Corners */
+   Vec3f x13, x23;      /**< x1-x3 and x2-x3 */
+   Vec3f e12, e13, e23; /**< Edge directions x2-x1, x3-x1, x3-x2 */
+   float m13, m23, m12; /**< Squared lengths of x13, x23 and e12 */
+   float d;             /**< dot(x13, x23) */
+   float invdet;        /**< 1/max(m13*m23-d*d, 1e-30) */
+   float pad[3];
+};
+
+static_assert(sizeof(TriangleGeometry)==32*sizeof(float), "TriangleGeometry must be a flat block of 32 floats");
+
+/**
+ * @brief point_segment_distance() with the segment direction x2-x1 and its squared length given
+ */
+inline float point_segment_distance(const Vec3f &x0, const Vec3f &x1, const Vec3f &x2,
+                                    const Vec3f &dx, float m2f)
+{
+   double m2=m2f;
+   float s12=(float)(dot(x2-x0, dx)/m2);
+   if(s12<0){
+      s12=0;
+   }else if(s12>1){
+      s12=1;
+   }
+   return dist(x0, s12*x1+(1-s12)*x2);
+}
+
+/**
+ * @brief point_triangle_distance() from precomputed triangle terms
+ *
+ * Performs the same operations in the same order as the four-argument version minus the
+ * ones hoisted into the record, so the result is bit-identical.
+ *
+ * @param x0 Query point
+ * @param g Precomputed triangle
+ * @return Minimum Euclidean distance from x0 to the triangle
+ */
+inline float point_triangle_distance(const Vec3f &x0, const TriangleGeometry &g)
+{
+   Vec3f x03(x0-g.x3);
+   float a=dot(g.x13,x03), b=dot(g.x23,x03);
+   float w23=g.invdet*(g.m23*a-g.d*b);
+   float w31=g.invdet*(g.m13*b-g.d*a);
+   float w12=1-w23-w31;
+   if(w23>=0 && w31>=0 && w12>=0){
+      return dist(x0, w23*g.x1+w31*g.x2+w12*g.x3);
+   }else{
+      // mag2(x3-x1)==m13 and mag2(x3-x2)==m23 exactly: the components only differ in sign
+      if(w23>0)
+         return min(point_segment_distance(x0,g.x1,g.x2,g.e12,g.m12), point_segment_distance(x0,g.x1,g.x3,g.e13,g.m13));
+      else if(w31>0)
+         return min(point_segment_distance(x0,g.x1,g.x2,g.e12,g.m12), point_segment_distance(x0,g.x2,g.x3,g.e23,g.m23));
+      else
+         return min(point_segment_distance(x0,g.x1,g.x3,g.e13,g.m13), point_segment_distance(x0,g.x2,g.x3,g.e23,g.m23));
+   }
+}
+
+/**
+ * @brief Table of TriangleGeometry records indexed like the input triangle array
+ *
+ * Trades 128 bytes per triangle for skipping the tri[]/x[] indirection in the sweeps, where
+ * the same few triangles are queried from millions of cells, and the per-query frame setup
+ * (including a division) in the scalar queries. Records are stored contiguously per triangle
+ * because the sweeps look triangles up in arbitrary order.
+ */
+class TriangleTable {
+public:
+   TriangleTable() {}
+
+   TriangleTable(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x)
+   { build(tri, x); }
+
+   /**
+    * @brief (Re)build the table for a mesh
+    * @param tri Triangle vertex indices
+    * @param x Vertex positions
+    */
+   void build(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x)
+   {
+      records_.resize(tri.size());
+      for(size_t t=0; t<tri.size(); ++t){
+         TriangleGeometry &g=records_[t];
+         g.x1=x[tri[t][0]]; g.x2=x[tri[t][1]]; g.x3=x[tri[t][2]];
+         g.x13=g.x1-g.x3; g.x23=g.x2-g.x3;
+         g.e12=g.x2-g.x1; g.e13=g.x3-g.x1; g.e23=g.x3-g.x2;
+         g.m13=mag2(g.x13); g.m23=mag2(g.x23); g.m12=mag2(g.e12);
+         g.d=dot(g.x13,g.x23);
+         g.invdet=1.f/max(g.m13*g.m23-g.d*g.d,1e-30f);
+         g.pad[0]=g.pad[1]=g.pad[2]=0;
+      }
+   }
+
+   const TriangleGeometry &operator[](size_t t) const { return records_[t]; }
+   const TriangleGeometry *data() const { return records_.empty() ? 0 : &records_[0]; }
+   size_t size() const { return records_.size(); }
+   bool empty() const { return records_.empty(); }
+
+   /** @brief Bytes held by the table */
+   size_t memory_bytes() const { return bytes_for(records_.size()); }
+
+   /** @brief Bytes a table for num_triangles triangles needs (for reporting before building) */
+   static size_t bytes_for(size_t num_triangles) { return num_triangles*sizeof(TriangleGeometry); }
+
+private:
+   std::vector<TriangleGeometry> records_;
+};
+
+} // namespace sdfgen
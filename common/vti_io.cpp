@@ -0,0 +1,171 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// VTK XML image data (.vti) writer
+// The XML is written directly; VTK is needed only for the block compressors
+
+#include "config.h"
+#include "vti_io.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifdef HAVE_VTK
+  #include <vtkDataCompressor.h>
+  #include <vtkSmartPointer.h>
+  #include <vtkVersionMacros.h>
+  #include <vtkZLibDataCompressor.h>
+  #if VTK_MAJOR_VERSION > 8 || (VTK_MAJOR_VERSION == 8 && VTK_MINOR_VERSION >= 2)
+    #include <vtkLZ4DataCompressor.h>
+    #define SDFGEN_VTK_LZ4
+  #endif
+#endif
+
+namespace sdfgen {
+
+namespace {
+
+// Blocks compressed per batch for each thread
+const size_t blocks_per_thread = 4;
+
+const char* compressor_name(VtiCompression compression) {
+    switch (compression) {
+    case VtiCompression::ZLib: return "vtkZLibDataCompressor";
+    case VtiCompression::LZ4:  return "vtkLZ4DataCompressor";
+    default:                   return "";
+    }
+}
+
+#ifdef HAVE_VTK
+vtkSmartPointer<vtkDataCompressor> make_compressor(VtiCompression compression) {
+    if (compression == VtiCompression::ZLib) return vtkSmartPointer<vtkZLibDataCompressor>::New();
+#ifdef SDFGEN_VTK_LZ4
+    if (compression == VtiCompression::LZ4) return vtkSmartPointer<vtkLZ4DataCompressor>::New();
+#endif
+    return nullptr;
+}
+#endif
+
+} // namespace
+
+bool vti_compression_available(VtiCompression compression) {
+    if (compression == VtiCompression::None) return true;
+#ifdef HAVE_VTK
+    return make_compressor(compression) != nullptr;
+#else
+    return false;
+#endif
+}
+
+} // namespace sdfgen
+
+bool write_vti(const std::string& filename,
+               const Array3f& phi_grid,
+               const Vec3f& origin,
+               float dx,
+               const sdfgen::VtiOptions& options) {
+    using sdfgen::VtiCompression;
+    const VtiCompression compression = options.compression;
+    if (!sdfgen::vti_compression_available(compression)) {
+        std::cerr << "ERROR: " << sdfgen::compressor_name(compression)
+                  << " is not available in this build (needs VTK)" << std::endl;
+        return false;
+    }
+
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    if (!outfile) {
+        std::cerr << "ERROR: Failed to open file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    // XML part: one point array whose data starts at offset 0 of the appended section
+    std::ostringstream extent;
+    extent << "0 " << phi_grid.ni - 1 << " 0 " << phi_grid.nj - 1 << " 0 " << phi_grid.nk - 1;
+    std::ostringstream xml;
+    xml.precision(9);
+    xml << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\"";
+    if (compression != VtiCompression::None) xml << " compressor=\"" << sdfgen::compressor_name(compression) << "\"";
+    xml << ">\n"
+        << "  <ImageData WholeExtent=\"" << extent.str() << "\" Origin=\"" << origin[0] << " " << origin[1] << " "
+        << origin[2] << "\" Spacing=\"" << dx << " " << dx << " " << dx << "\">\n"
+        << "    <Piece Extent=\"" << extent.str() << "\">\n"
+        << "      <PointData Scalars=\"Distance\">\n"
+        << "        <DataArray type=\"Float32\" Name=\"Distance\" format=\"appended\" offset=\"0\"/>\n"
+        << "      </PointData>\n"
+        << "      <CellData>\n"
+        << "      </CellData>\n"
+        << "    </Piece>\n"
+        << "  </ImageData>\n"
+        << "  <AppendedData encoding=\"raw\">\n"
+        << "   _";
+    const std::string header = xml.str();
+    outfile.write(header.data(), header.size());
+
+    const unsigned char* values = reinterpret_cast<const unsigned char*>(phi_grid.a.data);
+    const uint64_t total_bytes = (uint64_t)phi_grid.a.size() * sizeof(float);
+
+    if (compression == VtiCompression::None) {
+        // Byte count, then the grid as it is
+        outfile.write(reinterpret_cast<const char*>(&total_bytes), sizeof(uint64_t));
+        outfile.write(reinterpret_cast<const char*>(values), (std::streamsize)total_bytes);
+    }
+#ifdef HAVE_VTK
+    else {
+        // Block table: count, block size, size of a partial last block (0 if full), compressed sizes
+        const uint64_t block_bytes = std::max<uint64_t>(sizeof(float), options.block_bytes);
+        const uint64_t block_count = (total_bytes + block_bytes - 1) / block_bytes;
+        std::vector<uint64_t> table(3 + block_count, 0);
+        table[0] = block_count;
+        table[1] = block_bytes;
+        table[2] = total_bytes % block_bytes;
+        const std::streamoff table_offset = (std::streamoff)header.size();
+        outfile.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(uint64_t));
+
+        // Blocks, compressed in parallel one batch at a time
+        sdfgen::ThreadPool& pool = sdfgen::ThreadPool::global();
+        const unsigned int threads = sdfgen::resolve_thread_count(options.num_threads);
+        std::vector<std::vector<unsigned char>> compressed(
+            (size_t)std::min<uint64_t>(block_count, threads * sdfgen::blocks_per_thread));
+        bool ok = true;
+        for (uint64_t first = 0; first < block_count && ok; first += compressed.size()) {
+            size_t batch = (size_t)std::min<uint64_t>(compressed.size(), block_count - first);
+            pool.parallel_for((int)batch, threads, [&](int b) {
+                uint64_t begin = (first + b) * block_bytes;
+                size_t size = (size_t)std::min(block_bytes, total_bytes - begin);
+                vtkSmartPointer<vtkDataCompressor> compressor = sdfgen::make_compressor(compression);
+                std::vector<unsigned char>& out = compressed[b];
+                out.resize(compressor->GetMaximumCompressionSpace(size));
+                out.resize(compressor->Compress(values + begin, size, out.data(), out.size()));
+            });
+            for (size_t b = 0; b < batch; ++b) {
+                ok &= !compressed[b].empty();
+                outfile.write(reinterpret_cast<const char*>(compressed[b].data()), compressed[b].size());
+                table[3 + first + b] = compressed[b].size();
+            }
+        }
+        if (!ok) {
+            std::cerr << "ERROR: Failed to compress VTK data for file: " << filename << std::endl;
+            return false;
+        }
+
+        std::streamoff end = outfile.tellp();
+        outfile.seekp(table_offset);
+        outfile.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(uint64_t));
+        outfile.seekp(end);
+    }
+#endif
+
+    outfile << "\n  </AppendedData>\n</VTKFile>\n";
+    outfile.close();
+    if (outfile.fail()) {
+        std::cerr << "ERROR: Failed to write VTK data to file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
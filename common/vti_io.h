@@ -0,0 +1,60 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "array3.h"
+#include "vec.h"
+#include <cstddef>
+#include <string>
+
+namespace sdfgen {
+
+/**
+ * @brief Block compression of the .vti appended data
+ */
+enum class VtiCompression {
+    None, ///< Raw float32 values, written straight from the grid
+    ZLib, ///< vtkZLibDataCompressor blocks (VTK builds)
+    LZ4   ///< vtkLZ4DataCompressor blocks (VTK 8.2 or later), faster than ZLib
+};
+
+/**
+ * @brief Settings for write_vti()
+ */
+struct VtiOptions {
+    VtiCompression compression = VtiCompression::None;
+    size_t block_bytes = size_t(1) << 20;  ///< Uncompressed bytes per compressed block
+    int num_threads = 0;                   ///< Threads compressing blocks, 0 = auto-detect
+};
+
+/**
+ * @brief True if write_vti() can use the given compression in this build
+ */
+bool vti_compression_available(VtiCompression compression);
+
+} // namespace sdfgen
+
+/**
+ * @brief Write a signed distance field as VTK XML image data (.vti)
+ *
+ * One point array "Distance" in appended raw binary (UInt64 headers, little-endian), which
+ * ParaView and vtkXMLImageDataReader load directly. Nothing is copied: uncompressed values
+ * go to the file straight from the grid in one write. Compressed output is cut into blocks
+ * that the thread pool compresses a batch at a time, each task with its own VTK
+ * compressor; the block size table is filled in once the sizes are known, so memory beyond
+ * the grid stays at one batch of blocks.
+ *
+ * @param filename Output file path (conventionally .vti)
+ * @param phi_grid SDF grid data
+ * @param origin Position of node (0,0,0)
+ * @param dx Grid cell spacing
+ * @param options Compression, block size and threads
+ * @return true on success, false on error (including a compression this build lacks)
+ */
+bool write_vti(const std::string& filename,
+               const Array3f& phi_grid,
+               const Vec3f& origin,
+               float dx,
+               const sdfgen::VtiOptions& options = sdfgen::VtiOptions());
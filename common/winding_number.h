@@ -0,0 +1,153 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include "triangle_bvh.h"
+#include "vec.h"
+
+namespace sdfgen {
+
+/**
+ * @brief Node of a WindingNumberTree: the BVH topology plus a first-order dipole
+ *
+ * Plain floats so the array can be copied to the device unchanged.
+ */
+struct WindingNode {
+   float center[3];  /**< Area-weighted centroid of the triangles below */
+   float normal[3];  /**< Sum of area-weighted normals (half the corner cross products) */
+   float radius;     /**< Distance from center bounding every corner below */
+   int first;        /**< Left child (interior, children at first and first+1) or first triangle slot (leaf) */
+   int count;        /**< Number of triangles in a leaf, 0 for interior nodes */
+};
+
+/**
+ * @brief Fast generalized winding number of a triangle mesh (Barill et al. 2018)
+ *
+ * The winding number at q is the signed solid angle of the mesh seen from q over 4*pi: 1
+ * inside and 0 outside a closed, outward-oriented mesh, and a smooth value in between near
+ * holes and gaps, so thresholding it at 0.5 gives a sign that tolerates non-watertight input.
+ * Nodes farther than beta*radius from q contribute their dipole term; nearer leaves sum the
+ * exact triangle solid angles. Built on the TriangleBVH split, whose children always follow
+ * their parent in the node array.
+ */
+class WindingNumberTree {
+public:
+   WindingNumberTree() {}
+
+   WindingNumberTree(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x, int leaf_size=4)
+   { build(tri, x, leaf_size); }
+
+   /**
+    * @brief (Re)build the tree for a mesh
+    * @param tri Triangle vertex indices
+    * @param x Vertex positions
+    * @param leaf_size Maximum triangles per leaf
+    */
+   void build(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x, int leaf_size=4)
+   {
+      TriangleBVH bvh(tri, x, leaf_size);
+      const std::vector<BVHNode> &bvh_nodes=bvh.nodes();
+      corners_=bvh.corners();
+      nodes_.assign(bvh_nodes.size(), WindingNode());
+      std::vector<double> area(bvh_nodes.size(), 0);
+      std::vector<Vec3d> center(bvh_nodes.size()), normal(bvh_nodes.size());
+
+      // children follow their parent, so a reverse pass has them ready
+      for(int n=(int)bvh_nodes.size()-1; n>=0; --n){
+         const BVHNode &b=bvh_nodes[n];
+         Vec3d c(0,0,0), nrm(0,0,0);
+         double a=0, radius=0;
+         if(b.count>0){
+            for(int s=b.first; s<b.first+b.count; ++s){
+               Vec3d p0(corners_[3*s]), p1(corners_[3*s+1]), p2(corners_[3*s+2]);
+               Vec3d half_cross=0.5*cross(p1-p0, p2-p0);
+               double ta=mag(half_cross);
+               nrm+=half_cross;
+               c+=ta*(p0+p1+p2)/3.0;
+               a+=ta;
+            }
+         }else{
+            for(int s=0; s<2; ++s){
+               a+=area[b.first+s];
+               nrm+=normal[b.first+s];
+               c+=area[b.first+s]*center[b.first+s];
+            }
+         }
+         if(a>0) c/=a;
+         else c=0.5*(Vec3d(b.bmin)+Vec3d(b.bmax));
+         if(b.count>0){
+            for(int s=3*b.first; s<3*(b.first+b.count); ++s) radius=std::max(radius, mag(Vec3d(corners_[s])-c));
+         }else{
+            for(int s=0; s<2; ++s)
+               radius=std::max(radius, mag(center[b.first+s]-c)+nodes_[b.first+s].radius);
+         }
+         area[n]=a; center[n]=c; normal[n]=nrm;
+         WindingNode &w=nodes_[n];
+         for(int axis=0; axis<3; ++axis){ w.center[axis]=(float)c[axis]; w.normal[axis]=(float)nrm[axis]; }
+         w.radius=(float)radius*(1+1e-5f); // float rounding of the center must not shrink the bound
+         w.first=b.first;
+         w.count=b.count;
+      }
+   }
+
+   /**
+    * @brief Generalized winding number at a point
+    * @param q Query point
+    * @param beta Accuracy: nodes farther than beta*radius use their dipole (2 is the usual choice)
+    * @return About 1 inside and 0 outside; 0.5 on the surface
+    */
+   float winding_number(const Vec3f &q, float beta=2.f) const
+   {
+      if(nodes_.empty()) return 0;
+      double sum=0; // solid angle
+      int stack[64];
+      int top=0;
+      stack[top++]=0;
+      while(top>0){
+         const WindingNode &node=nodes_[stack[--top]];
+         Vec3d d(node.center[0]-(double)q[0], node.center[1]-(double)q[1], node.center[2]-(double)q[2]);
+         double dist=mag(d);
+         if(dist>beta*node.radius){
+            sum+=(node.normal[0]*d[0]+node.normal[1]*d[1]+node.normal[2]*d[2])/(dist*dist*dist);
+            continue;
+         }
+         if(node.count==0){
+            stack[top++]=node.first;
+            stack[top++]=node.first+1;
+            continue;
+         }
+         for(int s=node.first; s<node.first+node.count; ++s)
+            sum+=solid_angle(q, corners_[3*s], corners_[3*s+1], corners_[3*s+2]);
+      }
+      return (float)(sum/(4*M_PI));
+   }
+
+   bool empty() const { return nodes_.empty(); }
+   const std::vector<WindingNode> &nodes() const { return nodes_; }
+   /** @brief Triangle corners in slot order (3 per slot) */
+   const std::vector<Vec3f> &corners() const { return corners_; }
+
+   /**
+    * @brief Signed solid angle of triangle (a,b,c) seen from q (Van Oosterom and Strackee)
+    *
+    * Positive when q is behind the triangle, i.e. on the side opposite its normal.
+    */
+   static double solid_angle(const Vec3f &q, const Vec3f &a, const Vec3f &b, const Vec3f &c)
+   {
+      Vec3d qa=Vec3d(a)-Vec3d(q), qb=Vec3d(b)-Vec3d(q), qc=Vec3d(c)-Vec3d(q);
+      double la=mag(qa), lb=mag(qb), lc=mag(qc);
+      double det=dot(qa, cross(qb, qc));
+      double den=la*lb*lc+dot(qa, qb)*lc+dot(qb, qc)*la+dot(qc, qa)*lb;
+      return 2*std::atan2(det, den);
+   }
+
+private:
+   std::vector<WindingNode> nodes_;
+   std::vector<Vec3f> corners_;
+};
+
+} // namespace sdfgen
@@ -0,0 +1,207 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#include "distance_simd.h"
+#include "triangle_distance.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace sdfgen {
+namespace cpu {
+
+namespace detail {
+#if defined(SDFGEN_HAVE_SSE_KERNELS)
+int distances_one_triangle_sse(const float *tri9, const float *px, float py, float pz, int count, float *out);
+int distances_per_lane_sse(const float *soa, int stride, const float *px, float py, float pz, int count, float *out);
+int parity_signs_sse(const int *count, float *phi, int n, uint32_t &inside);
+#endif
+#if defined(SDFGEN_HAVE_AVX2_KERNELS)
+int distances_one_triangle_avx2(const float *tri9, const float *px, float py, float pz, int count, float *out);
+int distances_per_lane_avx2(const float *soa, int stride, const float *px, float py, float pz, int count, float *out);
+#endif
+#if defined(SDFGEN_HAVE_AVX512_KERNELS)
+int distances_one_triangle_avx512(const float *tri9, const float *px, float py, float pz, int count, float *out);
+int distances_per_lane_avx512(const float *soa, int stride, const float *px, float py, float pz, int count, float *out);
+#endif
+} // namespace detail
+
+namespace {
+
+bool cpu_has_avx2()
+{
+#if defined(SDFGEN_HAVE_AVX2_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("avx2");
+#elif defined(SDFGEN_HAVE_AVX2_KERNELS) && defined(_MSC_VER)
+   int info[4];
+   __cpuid(info, 1);
+   bool osxsave=(info[2]&(1<<27))!=0;
+   if(!osxsave || (_xgetbv(0)&0x6)!=0x6) return false;
+   __cpuidex(info, 7, 0);
+   return (info[1]&(1<<5))!=0;
+#else
+   return false;
+#endif
+}
+
+bool cpu_has_avx512f()
+{
+#if defined(SDFGEN_HAVE_AVX512_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("avx512f");
+#elif defined(SDFGEN_HAVE_AVX512_KERNELS) && defined(_MSC_VER)
+   int info[4];
+   __cpuid(info, 1);
+   bool osxsave=(info[2]&(1<<27))!=0;
+   if(!osxsave || (_xgetbv(0)&0xE6)!=0xE6) return false;
+   __cpuidex(info, 7, 0);
+   return (info[1]&(1<<16))!=0;
+#else
+   return false;
+#endif
+}
+
+SimdLevel detect()
+{
+   if(cpu_has_avx512f()) return SimdLevel::AVX512;
+   if(cpu_has_avx2()) return SimdLevel::AVX2;
+#if defined(SDFGEN_HAVE_SSE_KERNELS)
+   return SimdLevel::SSE;
+#else
+   return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel initial_level()
+{
+   SimdLevel level=detected_simd_level();
+   const char *env=std::getenv("SDFGEN_SIMD");
+   if(env){
+      SimdLevel requested=level;
+      if(std::strcmp(env, "scalar")==0) requested=SimdLevel::Scalar;
+      else if(std::strcmp(env, "sse")==0) requested=SimdLevel::SSE;
+      else if(std::strcmp(env, "avx2")==0) requested=SimdLevel::AVX2;
+      else if(std::strcmp(env, "avx512")==0) requested=SimdLevel::AVX512;
+      if((int)requested<(int)level) level=requested;
+   }
+   return level;
+}
+
+std::atomic<int> &level_storage()
+{
+   static std::atomic<int> level((int)initial_level());
+   return level;
+}
+
+int one_triangle_vector(SimdLevel level, const float *tri9, const float *px, float py, float pz,
+                        int count, float *out)
+{
+   switch(level){
+#if defined(SDFGEN_HAVE_AVX512_KERNELS)
+      case SimdLevel::AVX512: return detail::distances_one_triangle_avx512(tri9, px, py, pz, count, out);
+#endif
+#if defined(SDFGEN_HAVE_AVX2_KERNELS)
+      case SimdLevel::AVX2: return detail::distances_one_triangle_avx2(tri9, px, py, pz, count, out);
+#endif
+#if defined(SDFGEN_HAVE_SSE_KERNELS)
+      case SimdLevel::SSE: return detail::distances_one_triangle_sse(tri9, px, py, pz, count, out);
+#endif
+      default: return 0;
+   }
+}
+
+int per_lane_vector(SimdLevel level, const float *soa, int stride, const float *px, float py, float pz,
+                    int count, float *out)
+{
+   switch(level){
+#if defined(SDFGEN_HAVE_AVX512_KERNELS)
+      case SimdLevel::AVX512: return detail::distances_per_lane_avx512(soa, stride, px, py, pz, count, out);
+#endif
+#if defined(SDFGEN_HAVE_AVX2_KERNELS)
+      case SimdLevel::AVX2: return detail::distances_per_lane_avx2(soa, stride, px, py, pz, count, out);
+#endif
+#if defined(SDFGEN_HAVE_SSE_KERNELS)
+      case SimdLevel::SSE: return detail::distances_per_lane_sse(soa, stride, px, py, pz, count, out);
+#endif
+      default: return 0;
+   }
+}
+
+} // namespace
+
+SimdLevel detected_simd_level()
+{
+   static const SimdLevel level=detect();
+   return level;
+}
+
+SimdLevel active_simd_level()
+{
+   return (SimdLevel)level_storage().load(std::memory_order_relaxed);
+}
+
+SimdLevel set_simd_level(SimdLevel level)
+{
+   if((int)level>(int)detected_simd_level()) level=detected_simd_level();
+   level_storage().store((int)level, std::memory_order_relaxed);
+   return level;
+}
+
+const char *simd_level_name(SimdLevel level)
+{
+   switch(level){
+      case SimdLevel::SSE: return "sse";
+      case SimdLevel::AVX2: return "avx2";
+      case SimdLevel::AVX512: return "avx512";
+      default: return "scalar";
+   }
+}
+
+void point_triangle_distances(const Vec3f &x1, const Vec3f &x2, const Vec3f &x3,
+                              const float *px, float py, float pz, int count, float *out)
+{
+   const float tri9[9]={x1[0], x1[1], x1[2], x2[0], x2[1], x2[2], x3[0], x3[1], x3[2]};
+   int done=one_triangle_vector(active_simd_level(), tri9, px, py, pz, count, out);
+   for(int n=done; n<count; ++n)
+      out[n]=point_triangle_distance(Vec3f(px[n], py, pz), x1, x2, x3);
+}
+
+void parity_signs(const int *count, float *phi, int n)
+{
+   uint32_t inside=0; // sign bit of the running parity
+   int done=0;
+#if defined(SDFGEN_HAVE_SSE_KERNELS)
+   if(active_simd_level()!=SimdLevel::Scalar) done=detail::parity_signs_sse(count, phi, n, inside);
+#endif
+   for(int i=done; i<n; ++i){
+      inside^=(uint32_t)(count[i]&1)<<31;
+      uint32_t bits;
+      std::memcpy(&bits, &phi[i], sizeof(bits));
+      bits=(bits&0x7fffffffu)|inside;
+      std::memcpy(&phi[i], &bits, sizeof(bits));
+   }
+}
+
+void point_triangle_distances_lanes(const float *soa, int stride,
+                                    const float *px, float py, float pz, int count, float *out)
+{
+   int done=per_lane_vector(active_simd_level(), soa, stride, px, py, pz, count, out);
+   for(int n=done; n<count; ++n){
+      const float *c=soa+n;
+      out[n]=point_triangle_distance(Vec3f(px[n], py, pz),
+                                     Vec3f(c[0], c[stride], c[2*stride]),
+                                     Vec3f(c[3*stride], c[4*stride], c[5*stride]),
+                                     Vec3f(c[6*stride], c[7*stride], c[8*stride]));
+   }
+}
+
+} // namespace cpu
+} // namespace sdfgen
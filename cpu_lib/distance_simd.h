@@ -0,0 +1,93 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "vec.h"
+
+namespace sdfgen {
+namespace cpu {
+
+/**
+ * @brief Instruction set used by the batched distance kernels
+ */
+enum class SimdLevel {
+   Scalar, /**< Portable scalar loop (point_triangle_distance per cell) */
+   SSE,    /**< 4 cells per instruction (SSE2, always present on x86-64) */
+   AVX2,   /**< 8 cells per instruction */
+   AVX512  /**< 16 cells per instruction (AVX-512F) */
+};
+
+/** @brief Best instruction set supported by this CPU and build */
+SimdLevel detected_simd_level();
+
+/** @brief Instruction set currently used by the kernels */
+SimdLevel active_simd_level();
+
+/**
+ * @brief Select the instruction set used by the kernels
+ *
+ * Requests above detected_simd_level() are clamped. The initial level is the detected one,
+ * unless the SDFGEN_SIMD environment variable (scalar, sse, avx2, avx512) asks for less.
+ *
+ * @param level Requested instruction set
+ * @return The level actually applied
+ */
+SimdLevel set_simd_level(SimdLevel level);
+
+/** @brief Lower-case name of an instruction set ("scalar", "sse", "avx2", "avx512") */
+const char *simd_level_name(SimdLevel level);
+
+/**
+ * @brief Distances from a run of points on one grid row to a single triangle
+ *
+ * out[n] = point_triangle_distance(Vec3f(px[n],py,pz), x1, x2, x3) for n in [0,count),
+ * bit-identical to the scalar function for every instruction set.
+ *
+ * @param x1 First triangle vertex
+ * @param x2 Second triangle vertex
+ * @param x3 Third triangle vertex
+ * @param px X coordinates of the query points
+ * @param py Shared Y coordinate of the query points
+ * @param pz Shared Z coordinate of the query points
+ * @param count Number of query points
+ * @param out Output distances (count entries)
+ */
+void point_triangle_distances(const Vec3f &x1, const Vec3f &x2, const Vec3f &x3,
+                              const float *px, float py, float pz, int count, float *out);
+
+/**
+ * @brief Distances from a run of points on one grid row to one triangle per point
+ *
+ * Triangle n's corners are read from a structure-of-arrays block: component c (0..8 for
+ * x1.x, x1.y, x1.z, x2.x, ..., x3.z) of point n is soa[c*stride+n]. Results are
+ * bit-identical to point_triangle_distance().
+ *
+ * @param soa Triangle corner components, 9 rows of stride floats
+ * @param stride Distance between component rows in soa (>= count)
+ * @param px X coordinates of the query points
+ * @param py Shared Y coordinate of the query points
+ * @param pz Shared Z coordinate of the query points
+ * @param count Number of query points
+ * @param out Output distances (count entries)
+ */
+void point_triangle_distances_lanes(const float *soa, int stride,
+                                    const float *px, float py, float pz, int count, float *out);
+
+/**
+ * @brief Parity signs of one grid row
+ *
+ * Gives phi[i] the magnitude |phi[i]| and a negative sign when count[0]+...+count[i] is
+ * odd (inside), for i in [0,n). The running parity is a prefix XOR of the count bits,
+ * formed a vector at a time and written straight into the float sign bits, so the row has
+ * no branches. Every instruction set gives the same bits as negating in a scalar loop; the
+ * wider levels use the SSE kernel, as the loop is bound by memory rather than lane count.
+ * @param count Crossing counts of the row
+ * @param phi Distances of the row, updated in place
+ * @param n Nodes in the row
+ */
+void parity_signs(const int *count, float *phi, int n);
+
+} // namespace cpu
+} // namespace sdfgen
@@ -0,0 +1,28 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// AVX2 instantiation of the batched distance kernels (compiled with AVX2 enabled, only
+// called after runtime detection)
+
+#if defined(SDFGEN_HAVE_AVX2_KERNELS)
+
+#include <immintrin.h>
+#define SDFGEN_SIMD_AVX2
+#include "distance_simd_impl.h"
+
+namespace sdfgen {
+namespace cpu {
+namespace detail {
+
+int distances_one_triangle_avx2(const float *tri9, const float *px, float py, float pz, int count, float *out)
+{ return distances_one_triangle_impl(tri9, px, py, pz, count, out); }
+
+int distances_per_lane_avx2(const float *soa, int stride, const float *px, float py, float pz, int count, float *out)
+{ return distances_per_lane_impl(soa, stride, px, py, pz, count, out); }
+
+} // namespace detail
+} // namespace cpu
+} // namespace sdfgen
+
+#endif
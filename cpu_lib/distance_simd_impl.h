@@ -0,0 +1,212 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Vectorized point/triangle distance core shared by the per-ISA translation units.
+//
+// Each distance_simd_*.cpp includes this file after <immintrin.h> with its own compiler
+// flags and instantiates the kernels with one of the traits below. Everything here has
+// internal linkage and nothing else is included, so wide instructions can never end up
+// in inline functions that other translation units share.
+//
+// The operation sequence mirrors point_triangle_distance()/point_segment_distance() in
+// common/triangle_distance.h exactly (same association order, IEEE division and sqrt,
+// std::min/std::max operand order, NaN behaviour of the comparisons), which is what makes
+// the vector results bit-identical to the scalar ones. The segment parameter is computed
+// in double there; for float operands a double division rounded to float equals the
+// correctly rounded float division, so float lanes are used here.
+
+#pragma once
+
+namespace {
+
+#if defined(SDFGEN_SIMD_SSE)
+struct Isa {
+   typedef __m128 V;
+   typedef __m128 M;
+   static const int W=4;
+   static V loadu(const float *p) { return _mm_loadu_ps(p); }
+   static void storeu(float *p, V a) { _mm_storeu_ps(p, a); }
+   static V set1(float a) { return _mm_set1_ps(a); }
+   static V add(V a, V b) { return _mm_add_ps(a, b); }
+   static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+   static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+   static V div(V a, V b) { return _mm_div_ps(a, b); }
+   static V sqrt(V a) { return _mm_sqrt_ps(a); }
+   static V vmin(V a, V b) { return _mm_min_ps(a, b); } // (a<b) ? a : b
+   static V vmax(V a, V b) { return _mm_max_ps(a, b); } // (a>b) ? a : b
+   static M lt(V a, V b) { return _mm_cmplt_ps(a, b); }
+   static M gt(V a, V b) { return _mm_cmpgt_ps(a, b); }
+   static M ge(V a, V b) { return _mm_cmpge_ps(a, b); }
+   static M mand(M a, M b) { return _mm_and_ps(a, b); }
+   static V select(V a, V b, M m) { return _mm_or_ps(_mm_and_ps(m, b), _mm_andnot_ps(m, a)); } // m ? b : a
+};
+#elif defined(SDFGEN_SIMD_AVX2)
+struct Isa {
+   typedef __m256 V;
+   typedef __m256 M;
+   static const int W=8;
+   static V loadu(const float *p) { return _mm256_loadu_ps(p); }
+   static void storeu(float *p, V a) { _mm256_storeu_ps(p, a); }
+   static V set1(float a) { return _mm256_set1_ps(a); }
+   static V add(V a, V b) { return _mm256_add_ps(a, b); }
+   static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+   static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+   static V div(V a, V b) { return _mm256_div_ps(a, b); }
+   static V sqrt(V a) { return _mm256_sqrt_ps(a); }
+   static V vmin(V a, V b) { return _mm256_min_ps(a, b); }
+   static V vmax(V a, V b) { return _mm256_max_ps(a, b); }
+   static M lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+   static M gt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+   static M ge(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+   static M mand(M a, M b) { return _mm256_and_ps(a, b); }
+   static V select(V a, V b, M m) { return _mm256_blendv_ps(a, b, m); }
+};
+#elif defined(SDFGEN_SIMD_AVX512)
+struct Isa {
+   typedef __m512 V;
+   typedef __mmask16 M;
+   static const int W=16;
+   static V loadu(const float *p) { return _mm512_loadu_ps(p); }
+   static void storeu(float *p, V a) { _mm512_storeu_ps(p, a); }
+   static V set1(float a) { return _mm512_set1_ps(a); }
+   static V add(V a, V b) { return _mm512_add_ps(a, b); }
+   static V sub(V a, V b) { return _mm512_sub_ps(a, b); }
+   static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+   static V div(V a, V b) { return _mm512_div_ps(a, b); }
+   static V sqrt(V a) { return _mm512_sqrt_ps(a); }
+   // _mm512_min_ps/_mm512_max_ps do not specify which operand a NaN returns, so spell out
+   // the (a<b) ? a : b form used by the SSE/AVX instructions
+   static V vmin(V a, V b) { return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), b, a); }
+   static V vmax(V a, V b) { return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_GT_OQ), b, a); }
+   static M lt(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+   static M gt(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+   static M ge(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+   static M mand(M a, M b) { return (M)(a & b); }
+   static V select(V a, V b, M m) { return _mm512_mask_blend_ps(m, a, b); }
+};
+#else
+#error "distance_simd_impl.h needs one of SDFGEN_SIMD_SSE, SDFGEN_SIMD_AVX2, SDFGEN_SIMD_AVX512"
+#endif
+
+typedef Isa::V V;
+typedef Isa::M M;
+
+struct Vec3V { V x, y, z; };
+
+// dist(p, q) = sqrt((p.x-q.x)^2 + (p.y-q.y)^2 + (p.z-q.z)^2), summed left to right
+inline V dist_v(const Vec3V &p, V qx, V qy, V qz)
+{
+   V ex=Isa::sub(p.x, qx), ey=Isa::sub(p.y, qy), ez=Isa::sub(p.z, qz);
+   return Isa::sqrt(Isa::add(Isa::add(Isa::mul(ex, ex), Isa::mul(ey, ey)), Isa::mul(ez, ez)));
+}
+
+// point_segment_distance(x0, a, b) with the direction e=b-a and m2=mag2(e) given
+inline V segment_distance_v(const Vec3V &x0, const Vec3V &a, const Vec3V &b, const Vec3V &e, V m2)
+{
+   const V zero=Isa::set1(0.f), one=Isa::set1(1.f);
+   V fx=Isa::sub(b.x, x0.x), fy=Isa::sub(b.y, x0.y), fz=Isa::sub(b.z, x0.z);
+   V s=Isa::div(Isa::add(Isa::add(Isa::mul(fx, e.x), Isa::mul(fy, e.y)), Isa::mul(fz, e.z)), m2);
+   s=Isa::select(s, zero, Isa::lt(s, zero));
+   s=Isa::select(s, one, Isa::gt(s, one));
+   V t=Isa::sub(one, s);
+   return dist_v(x0, Isa::add(Isa::mul(a.x, s), Isa::mul(b.x, t)),
+                     Isa::add(Isa::mul(a.y, s), Isa::mul(b.y, t)),
+                     Isa::add(Isa::mul(a.z, s), Isa::mul(b.z, t)));
+}
+
+inline Vec3V sub_v(const Vec3V &a, const Vec3V &b)
+{
+   Vec3V r={Isa::sub(a.x, b.x), Isa::sub(a.y, b.y), Isa::sub(a.z, b.z)};
+   return r;
+}
+
+inline V dot_v(const Vec3V &a, const Vec3V &b)
+{
+   return Isa::add(Isa::add(Isa::mul(a.x, b.x), Isa::mul(a.y, b.y)), Isa::mul(a.z, b.z));
+}
+
+// Point-independent terms of point_triangle_distance(), the TriangleGeometry fields
+struct TriangleV {
+   Vec3V x1, x2, x3, x13, x23, e12, e13, e23;
+   V m13, m23, m12, d, invdet;
+};
+
+inline TriangleV setup_triangle_v(const Vec3V &x1, const Vec3V &x2, const Vec3V &x3)
+{
+   TriangleV g;
+   g.x1=x1; g.x2=x2; g.x3=x3;
+   g.x13=sub_v(x1, x3); g.x23=sub_v(x2, x3);
+   g.e12=sub_v(x2, x1); g.e13=sub_v(x3, x1); g.e23=sub_v(x3, x2);
+   g.m13=dot_v(g.x13, g.x13); g.m23=dot_v(g.x23, g.x23); g.m12=dot_v(g.e12, g.e12);
+   g.d=dot_v(g.x13, g.x23);
+   // std::max(det, 1e-30f) == (1e-30f > det) ? 1e-30f : det
+   g.invdet=Isa::div(Isa::set1(1.f), Isa::vmax(Isa::set1(1e-30f), Isa::sub(Isa::mul(g.m13, g.m23), Isa::mul(g.d, g.d))));
+   return g;
+}
+
+// point_triangle_distance(x0, g)
+inline V triangle_distance_v(const Vec3V &x0, const TriangleV &g)
+{
+   const V zero=Isa::set1(0.f), one=Isa::set1(1.f);
+   Vec3V x03=sub_v(x0, g.x3);
+   V a=dot_v(g.x13, x03), b=dot_v(g.x23, x03);
+   V w23=Isa::mul(g.invdet, Isa::sub(Isa::mul(g.m23, a), Isa::mul(g.d, b)));
+   V w31=Isa::mul(g.invdet, Isa::sub(Isa::mul(g.m13, b), Isa::mul(g.d, a)));
+   V w12=Isa::sub(Isa::sub(one, w23), w31);
+
+   V inside_d=dist_v(x0, Isa::add(Isa::add(Isa::mul(g.x1.x, w23), Isa::mul(g.x2.x, w31)), Isa::mul(g.x3.x, w12)),
+                         Isa::add(Isa::add(Isa::mul(g.x1.y, w23), Isa::mul(g.x2.y, w31)), Isa::mul(g.x3.y, w12)),
+                         Isa::add(Isa::add(Isa::mul(g.x1.z, w23), Isa::mul(g.x2.z, w31)), Isa::mul(g.x3.z, w12)));
+   // mag2(x3-x1)==m13 and mag2(x3-x2)==m23 exactly
+   V s12=segment_distance_v(x0, g.x1, g.x2, g.e12, g.m12);
+   V s13=segment_distance_v(x0, g.x1, g.x3, g.e13, g.m13);
+   V s23=segment_distance_v(x0, g.x2, g.x3, g.e23, g.m23);
+   // std::min(p, q) == (q < p) ? q : p
+   V r=Isa::vmin(s23, s13);                                   // w12 >0: edges 1-3 and 2-3
+   r=Isa::select(r, Isa::vmin(s23, s12), Isa::gt(w31, zero)); // w31 >0: edges 1-2 and 2-3
+   r=Isa::select(r, Isa::vmin(s13, s12), Isa::gt(w23, zero)); // w23 >0: edges 1-2 and 1-3
+   M inside=Isa::mand(Isa::mand(Isa::ge(w23, zero), Isa::ge(w31, zero)), Isa::ge(w12, zero));
+   return Isa::select(r, inside_d, inside);
+}
+
+// point_triangle_distance(x0, x1, x2, x3)
+inline V triangle_distance_v(const Vec3V &x0, const Vec3V &x1, const Vec3V &x2, const Vec3V &x3)
+{
+   return triangle_distance_v(x0, setup_triangle_v(x1, x2, x3));
+}
+
+// Full vectors only; returns the number of points processed
+inline int distances_one_triangle_impl(const float *tri9, const float *px, float py, float pz,
+                                       int count, float *out)
+{
+   Vec3V x1={Isa::set1(tri9[0]), Isa::set1(tri9[1]), Isa::set1(tri9[2])};
+   Vec3V x2={Isa::set1(tri9[3]), Isa::set1(tri9[4]), Isa::set1(tri9[5])};
+   Vec3V x3={Isa::set1(tri9[6]), Isa::set1(tri9[7]), Isa::set1(tri9[8])};
+   TriangleV g=setup_triangle_v(x1, x2, x3);
+   V vy=Isa::set1(py), vz=Isa::set1(pz);
+   int n=0;
+   for(; n+Isa::W<=count; n+=Isa::W){
+      Vec3V x0={Isa::loadu(px+n), vy, vz};
+      Isa::storeu(out+n, triangle_distance_v(x0, g));
+   }
+   return n;
+}
+
+inline int distances_per_lane_impl(const float *soa, int stride, const float *px, float py, float pz,
+                                   int count, float *out)
+{
+   V vy=Isa::set1(py), vz=Isa::set1(pz);
+   int n=0;
+   for(; n+Isa::W<=count; n+=Isa::W){
+      const float *c=soa+n;
+      Vec3V x0={Isa::loadu(px+n), vy, vz};
+      Vec3V x1={Isa::loadu(c), Isa::loadu(c+stride), Isa::loadu(c+2*stride)};
+      Vec3V x2={Isa::loadu(c+3*stride), Isa::loadu(c+4*stride), Isa::loadu(c+5*stride)};
+      Vec3V x3={Isa::loadu(c+6*stride), Isa::loadu(c+7*stride), Isa::loadu(c+8*stride)};
+      Isa::storeu(out+n, triangle_distance_v(x0, x1, x2, x3));
+   }
+   return n;
+}
+
+} // namespace
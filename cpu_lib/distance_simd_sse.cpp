@@ -0,0 +1,49 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// SSE instantiation of the batched distance kernels, and the parity sign kernel (SSE2 is
+// baseline on x86-64, no extra compiler flags needed)
+
+#if defined(SDFGEN_HAVE_SSE_KERNELS)
+
+#include <immintrin.h>
+#include <cstdint>
+#define SDFGEN_SIMD_SSE
+#include "distance_simd_impl.h"
+
+namespace sdfgen {
+namespace cpu {
+namespace detail {
+
+int distances_one_triangle_sse(const float *tri9, const float *px, float py, float pz, int count, float *out)
+{ return distances_one_triangle_impl(tri9, px, py, pz, count, out); }
+
+int distances_per_lane_sse(const float *soa, int stride, const float *px, float py, float pz, int count, float *out)
+{ return distances_per_lane_impl(soa, stride, px, py, pz, count, out); }
+
+// Prefix XOR of the count bits within a vector by two shifted XORs, plus the parity carried
+// in from the previous vector. Returns the nodes done; inside receives the running parity.
+int parity_signs_sse(const int *count, float *phi, int n, uint32_t &inside)
+{
+   const __m128i one=_mm_set1_epi32(1), magnitude=_mm_set1_epi32(0x7fffffff);
+   __m128i carry=_mm_setzero_si128();
+   int i=0;
+   for(; i+4<=n; i+=4){
+      __m128i m=_mm_slli_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i*)(count+i)), one), 31);
+      m=_mm_xor_si128(m, _mm_slli_si128(m, 4));
+      m=_mm_xor_si128(m, _mm_slli_si128(m, 8));
+      m=_mm_xor_si128(m, carry);
+      carry=_mm_shuffle_epi32(m, 0xff);
+      __m128i p=_mm_loadu_si128((const __m128i*)(phi+i));
+      _mm_storeu_si128((__m128i*)(phi+i), _mm_or_si128(_mm_and_si128(p, magnitude), m));
+   }
+   inside=(uint32_t)_mm_cvtsi128_si32(carry);
+   return i;
+}
+
+} // namespace detail
+} // namespace cpu
+} // namespace sdfgen
+
+#endif
@@ -3,72 +3,24 @@
 // Licensed under the MIT License - see LICENSE file
 
 #include "makelevelset3.h"
+#include "bricked_array3.h"
+#include "distance_simd.h"
+#include "mesh_reorder.h"
+#include "thread_pool.h"
+#include "triangle_bvh.h"
+#include "triangle_distance.h"
+#include "triangle_table.h"
+#include "winding_number.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <thread>
 #include <vector>
 
-/**
- * @brief Compute minimum distance from point to line segment
- *
- * Finds the closest point on segment x1-x2 to point x0 and returns the distance.
- * Uses parametric representation and clamps parameter to [0,1] to handle segment endpoints.
- *
- * @param x0 Query point
- * @param x1 First endpoint of line segment
- * @param x2 Second endpoint of line segment
- * @return Minimum Euclidean distance from x0 to segment
- */
-static float point_segment_distance(const Vec3f &x0, const Vec3f &x1, const Vec3f &x2)
-{
-   Vec3f dx(x2-x1);
-   double m2=mag2(dx);
-   // find parameter value of closest point on segment
-   float s12=(float)(dot(x2-x0, dx)/m2);
-   if(s12<0){
-      s12=0;
-   }else if(s12>1){
-      s12=1;
-   }
-   // and find the distance
-   return dist(x0, s12*x1+(1-s12)*x2);
-}
-
-/**
- * @brief Compute minimum distance from point to triangle
- *
- * Calculates shortest distance from query point x0 to triangle with vertices x1, x2, x3.
- * Uses barycentric coordinates to check if projection lies inside triangle. If outside,
- * falls back to checking distances to the three edges.
- *
- * @param x0 Query point
- * @param x1 First vertex of triangle
- * @param x2 Second vertex of triangle
- * @param x3 Third vertex of triangle
- * @return Minimum Euclidean distance from x0 to triangle
- */
-static float point_triangle_distance(const Vec3f &x0, const Vec3f &x1, const Vec3f &x2, const Vec3f &x3)
-{
-   // first find barycentric coordinates of closest point on infinite plane
-   Vec3f x13(x1-x3), x23(x2-x3), x03(x0-x3);
-   float m13=mag2(x13), m23=mag2(x23), d=dot(x13,x23);
-   float invdet=1.f/max(m13*m23-d*d,1e-30f);
-   float a=dot(x13,x03), b=dot(x23,x03);
-   // the barycentric coordinates themselves
-   float w23=invdet*(m23*a-d*b);
-   float w31=invdet*(m13*b-d*a);
-   float w12=1-w23-w31;
-   if(w23>=0 && w31>=0 && w12>=0){ // if we're inside the triangle
-      return dist(x0, w23*x1+w31*x2+w12*x3); 
-   }else{ // we have to clamp to one of the edges
-      if(w23>0) // this rules out edge 2-3 for us
-         return min(point_segment_distance(x0,x1,x2), point_segment_distance(x0,x1,x3));
-      else if(w31>0) // this rules out edge 1-3
-         return min(point_segment_distance(x0,x1,x2), point_segment_distance(x0,x2,x3));
-      else // w12 must be >0, ruling out edge 1-2
-         return min(point_segment_distance(x0,x1,x3), point_segment_distance(x0,x2,x3));
-   }
-}
-
 /**
  * @brief Update distance field cell by checking neighboring cell's triangle
  *
@@ -86,14 +38,22 @@ static float point_triangle_distance(const Vec3f &x0, const Vec3f &x1, const Vec
  * @param i1 Neighbor cell i-index
  * @param j1 Neighbor cell j-index
  * @param k1 Neighbor cell k-index
+ * @param table Precomputed triangle geometry, or null to evaluate from tri/x
  */
+template<class PhiGrid, class TriGrid>
 static void check_neighbour(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
-                            Array3f &phi, Array3i &closest_tri,
-                            const Vec3f &gx, int i0, int j0, int k0, int i1, int j1, int k1)
+                            PhiGrid &phi, TriGrid &closest_tri,
+                            const Vec3f &gx, int i0, int j0, int k0, int i1, int j1, int k1,
+                            const sdfgen::TriangleTable *table)
 {
    if(closest_tri(i1,j1,k1)>=0){
-      unsigned int p, q, r; assign(tri[closest_tri(i1,j1,k1)], p, q, r);
-      float d=point_triangle_distance(gx, x[p], x[q], x[r]);
+      float d;
+      if(table){
+         d=point_triangle_distance(gx, (*table)[closest_tri(i1,j1,k1)]);
+      }else{
+         unsigned int p, q, r; assign(tri[closest_tri(i1,j1,k1)], p, q, r);
+         d=point_triangle_distance(gx, x[p], x[q], x[r]);
+      }
       if(d<phi(i0,j0,k0)){
          phi(i0,j0,k0)=d;
          closest_tri(i0,j0,k0)=closest_tri(i1,j1,k1);
@@ -101,146 +61,777 @@ static void check_neighbour(const std::vector<Vec3ui> &tri, const std::vector<Ve
    }
 }
 
-static void sweep(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
-                  Array3f &phi, Array3i &closest_tri, const Vec3f &origin, float dx,
-                  int di, int dj, int dk)
+// Per-thread buffers for the batched distance kernels, reused across rows and triangles
+struct DistanceScratch {
+   std::vector<float> px, soa, dist;
+   std::vector<int> tris;
+   long long evaluations; // distances computed by this thread in the current task
+
+   DistanceScratch() : evaluations(0) {}
+};
+
+static DistanceScratch &distance_scratch()
+{
+   static thread_local DistanceScratch scratch;
+   return scratch;
+}
+
+/**
+ * @brief Adds the distances one task evaluates on this thread to a per-call total
+ *
+ * Declared at the top of each task, so the hot loops only bump a thread-local counter and
+ * the shared atomic is touched once per task.
+ */
+struct EvaluationTally {
+   std::atomic<long long> *total;
+
+   explicit EvaluationTally(std::atomic<long long> *total) : total(total) { distance_scratch().evaluations=0; }
+   ~EvaluationTally() { if(total) total->fetch_add(distance_scratch().evaluations, std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Gauss-Seidel update of one i-row (j,k) for sweep direction (di,dj,dk)
+ *
+ * Reads the rows (j-dj,k), (j,k-dk) and (j-dj,k-dk) and writes only row (j,k), which is
+ * what lets whole rows be scheduled as units by the parallel sweep strategies.
+ *
+ * Six of the seven neighbours of each cell lie in those rows, so their candidate triangles
+ * are fixed before the row starts and their distances are evaluated for the whole row at
+ * once with the SIMD kernels. Only the (i-di) neighbour depends on the cell just updated
+ * and stays scalar. The candidates are then applied per cell in the original order, so the
+ * row sees exactly the same sequence of updates as the scalar loop. With a triangle table the
+ * candidates are read from their precomputed records instead of being gathered from tri/x.
+ */
+template<class PhiGrid, class TriGrid>
+static void sweep_row(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                      PhiGrid &phi, TriGrid &closest_tri, const Vec3f &origin, float dx,
+                      int di, int dj, int dk, int j, int k, const sdfgen::TriangleTable *table)
+{
+   // (i,j,k) offsets, in units of (di,dj,dk), of the neighbours in already-swept rows
+   static const int offsets[6][3]={{0,1,0}, {1,1,0}, {0,0,1}, {1,0,1}, {0,1,1}, {1,1,1}};
+   int count=phi.ni-1;
+   if(count<=0) return;
+   int i0=(di>0) ? 1 : phi.ni-2;
+
+   DistanceScratch &s=distance_scratch();
+   s.px.resize(count);
+   s.soa.resize(9*count);
+   s.dist.resize(6*count);
+   s.tris.resize(6*count);
+   for(int n=0; n<count; ++n) s.px[n]=(i0+n*di)*dx+origin[0];
+   float py=j*dx+origin[1], pz=k*dx+origin[2];
+
+   for(int m=0; m<6; ++m){
+      int *nt=&s.tris[m*count];
+      float *out=&s.dist[m*count];
+      int jn=j-offsets[m][1]*dj, kn=k-offsets[m][2]*dk, ioff=offsets[m][0]*di;
+      bool uniform=true, any=false;
+      for(int n=0; n<count; ++n){
+         nt[n]=closest_tri(i0+n*di-ioff, jn, kn);
+         uniform=uniform && nt[n]==nt[0];
+         any=any || nt[n]>=0;
+      }
+      if(!any) continue;
+      s.evaluations+=count;
+      if(uniform){
+         if(table){
+            const sdfgen::TriangleGeometry &g=(*table)[nt[0]];
+            sdfgen::cpu::point_triangle_distances(g.x1, g.x2, g.x3, &s.px[0], py, pz, count, out);
+         }else{
+            unsigned int p, q, r; assign(tri[nt[0]], p, q, r);
+            sdfgen::cpu::point_triangle_distances(x[p], x[q], x[r], &s.px[0], py, pz, count, out);
+         }
+      }else{
+         for(int n=0; n<count; ++n){
+            if(nt[n]<0){
+               for(int c=0; c<9; ++c) s.soa[c*count+n]=0;
+            }else if(table){
+               const float *corners=&(*table)[nt[n]].x1[0];
+               for(int c=0; c<9; ++c) s.soa[c*count+n]=corners[c];
+            }else{
+               unsigned int v[3]; assign(tri[nt[n]], v[0], v[1], v[2]);
+               for(int c=0; c<9; ++c) s.soa[c*count+n]=x[v[c/3]][c%3];
+            }
+         }
+         sdfgen::cpu::point_triangle_distances_lanes(&s.soa[0], count, &s.px[0], py, pz, count, out);
+      }
+   }
+
+   for(int n=0; n<count; ++n){
+      int i=i0+n*di;
+      Vec3f gx(s.px[n], py, pz);
+      s.evaluations+=closest_tri(i-di,j,k)>=0;
+      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i-di, j, k, table);
+      float &phi_cell=phi(i,j,k);
+      int &tri_cell=closest_tri(i,j,k);
+      for(int m=0; m<6; ++m){
+         int t=s.tris[m*count+n];
+         if(t>=0 && s.dist[m*count+n]<phi_cell){
+            phi_cell=s.dist[m*count+n];
+            tri_cell=t;
+         }
+      }
+   }
+}
+
+// Threaded sweep - process a range of k slices
+template<class PhiGrid, class TriGrid>
+static void sweep_range(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                        PhiGrid &phi, TriGrid &closest_tri, const Vec3f &origin, float dx,
+                        int di, int dj, int dk, int k_start, int k_end, const sdfgen::TriangleTable *table)
 {
-   int i0, i1;
-   if(di>0){ i0=1; i1=phi.ni; }
-   else{ i0=phi.ni-2; i1=-1; }
    int j0, j1;
    if(dj>0){ j0=1; j1=phi.nj; }
    else{ j0=phi.nj-2; j1=-1; }
+
+   for(int k=k_start; k!=k_end; k+=dk) for(int j=j0; j!=j1; j+=dj)
+      sweep_row(tri, x, phi, closest_tri, origin, dx, di, dj, dk, j, k, table);
+}
+
+// Single-threaded sweep over the whole grid - the reference Gauss-Seidel order
+template<class PhiGrid, class TriGrid>
+static void sweep(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                  PhiGrid &phi, TriGrid &closest_tri, const Vec3f &origin, float dx,
+                  int di, int dj, int dk, const sdfgen::TriangleTable *table)
+{
    int k0, k1;
    if(dk>0){ k0=1; k1=phi.nk; }
    else{ k0=phi.nk-2; k1=-1; }
-   for(int k=k0; k!=k1; k+=dk) for(int j=j0; j!=j1; j+=dj) for(int i=i0; i!=i1; i+=di){
-      Vec3f gx(i*dx+origin[0], j*dx+origin[1], k*dx+origin[2]);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i-di, j,    k);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i,    j-dj, k);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i-di, j-dj, k);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i,    j,    k-dk);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i-di, j,    k-dk);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i,    j-dj, k-dk);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i-di, j-dj, k-dk);
+   sweep_range(tri, x, phi, closest_tri, origin, dx, di, dj, dk, k0, k1, table);
+}
+
+/**
+ * @brief Parallel sweep with exact sequential semantics (block wavefront)
+ *
+ * The (j,k) plane of i-rows is cut into square blocks. A row only depends on rows that are
+ * earlier in both j and k (in sweep order), so a block only depends on its three lower
+ * neighbours and all blocks on one anti-diagonal can run concurrently. Inside a block the
+ * rows are visited in the sequential order. Every row therefore sees exactly the values it
+ * would see in the single-threaded sweep, and the result is bit-identical for any thread
+ * count. The number of barriers per sweep is the number of block anti-diagonals.
+ */
+template<class PhiGrid, class TriGrid>
+static void sweep_wavefront(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                            PhiGrid &phi, TriGrid &closest_tri, const Vec3f &origin, float dx,
+                            int di, int dj, int dk, const sdfgen::TriangleTable *table,
+                            sdfgen::ThreadPool &pool, unsigned int threads, std::atomic<long long> *evaluations)
+{
+   int rows_j=phi.nj-1, rows_k=phi.nk-1;
+   if(rows_j<=0 || rows_k<=0) return;
+   if(threads<=1){
+      EvaluationTally tally(evaluations);
+      sweep(tri, x, phi, closest_tri, origin, dx, di, dj, dk, table);
+      return;
+   }
+
+   // Small enough blocks that the anti-diagonals keep every thread busy
+   int block=clamp(std::min(rows_j, rows_k)/(2*(int)threads), 1, 16);
+   int blocks_j=(rows_j+block-1)/block, blocks_k=(rows_k+block-1)/block;
+   int j_start=(dj>0) ? 1 : phi.nj-2;
+   int k_start=(dk>0) ? 1 : phi.nk-2;
+
+   for(int diag=0; diag<blocks_j+blocks_k-1; ++diag){
+      int bk_lo=std::max(0, diag-blocks_j+1), bk_hi=std::min(blocks_k-1, diag);
+      pool.parallel_for(bk_hi-bk_lo+1, threads, [&](int n){
+         EvaluationTally tally(evaluations);
+         int bk=bk_lo+n, bj=diag-bk;
+         int kk_end=std::min(rows_k, (bk+1)*block), jj_end=std::min(rows_j, (bj+1)*block);
+         for(int kk=bk*block; kk<kk_end; ++kk) for(int jj=bj*block; jj<jj_end; ++jj)
+            sweep_row(tri, x, phi, closest_tri, origin, dx, di, dj, dk, j_start+jj*dj, k_start+kk*dk, table);
+      });
    }
 }
 
-// Threaded sweep - process a range of k slices
-static void sweep_range(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
-                        Array3f &phi, Array3i &closest_tri, const Vec3f &origin, float dx,
-                        int di, int dj, int dk, int k_start, int k_end)
+/**
+ * @brief Grid-space k extent touched by one triangle during the near-band pass
+ *
+ * Covers both the exact-distance box (expanded by exact_band) and the rows used for
+ * intersection counting, so a tile can cheaply reject triangles that cannot reach it.
+ */
+static void triangle_k_extent(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                              unsigned int t, const Vec3f &origin, float dx, int nk,
+                              int exact_band, int &k0, int &k1)
 {
-   int i0, i1;
-   if(di>0){ i0=1; i1=phi.ni; }
-   else{ i0=phi.ni-2; i1=-1; }
-   int j0, j1;
-   if(dj>0){ j0=1; j1=phi.nj; }
-   else{ j0=phi.nj-2; j1=-1; }
+   unsigned int p, q, r; assign(tri[t], p, q, r);
+   double fkp=((double)x[p][2]-origin[2])/dx, fkq=((double)x[q][2]-origin[2])/dx, fkr=((double)x[r][2]-origin[2])/dx;
+   k0=min(clamp(int(min(fkp,fkq,fkr))-exact_band, 0, nk-1), clamp((int)std::ceil(min(fkp,fkq,fkr)), 0, nk-1));
+   k1=max(clamp(int(max(fkp,fkq,fkr))+exact_band+1, 0, nk-1), clamp((int)std::floor(max(fkp,fkq,fkr)), 0, nk-1));
+}
 
-   for(int k=k_start; k!=k_end; k+=dk) for(int j=j0; j!=j1; j+=dj) for(int i=i0; i!=i1; i+=di){
-      Vec3f gx(i*dx+origin[0], j*dx+origin[1], k*dx+origin[2]);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i-di, j,    k);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i,    j-dj, k);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i-di, j-dj, k);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i,    j,    k-dk);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i-di, j,    k-dk);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i,    j-dj, k-dk);
-      check_neighbour(tri, x, phi, closest_tri, gx, i, j, k, i-di, j-dj, k-dk);
-   }
-}
-
-// calculate twice signed area of triangle (0,0)-(x1,y1)-(x2,y2)
-// return an SOS-determined sign (-1, +1, or 0 only if it's a truly degenerate triangle)
-static int orientation(double x1, double y1, double x2, double y2, double &twice_signed_area)
-{
-   twice_signed_area=y1*x2-x1*y2;
-   if(twice_signed_area>0) return 1;
-   else if(twice_signed_area<0) return -1;
-   else if(y2>y1) return 1;
-   else if(y2<y1) return -1;
-   else if(x1>x2) return 1;
-   else if(x1<x2) return -1;
-   else return 0; // only true when x1==x2 and y1==y2
-}
-
-// robust test of (x0,y0) in the triangle (x1,y1)-(x2,y2)-(x3,y3)
-// if true is returned, the barycentric coordinates are set in a,b,c.
-static bool point_in_triangle_2d(double x0, double y0, 
-                                 double x1, double y1, double x2, double y2, double x3, double y3,
-                                 double& a, double& b, double& c)
-{
-   x1-=x0; x2-=x0; x3-=x0;
-   y1-=y0; y2-=y0; y3-=y0;
-   int signa=orientation(x2, y2, x3, y3, a);
-   if(signa==0) return false;
-   int signb=orientation(x3, y3, x1, y1, b);
-   if(signb!=signa) return false;
-   int signc=orientation(x1, y1, x2, y2, c);
-   if(signc!=signa) return false;
-   double sum=a+b+c;
-   assert(sum!=0); // if the SOS signs match and are nonkero, there's no way all of a, b, and c are zero.
-   a/=sum;
-   b/=sum;
-   c/=sum;
-   return true;
+/**
+ * @brief Visit the +x ray crossings of one triangle, restricted to k in [kmin,kmax]
+ *
+ * Calls visit(i,j,k) for each row (j,k) the triangle crosses, where the crossing lies in
+ * (i-1,i]. Crossings on the -x side of the grid are moved into the first interval and
+ * crossings beyond the +x side are dropped.
+ */
+template<class Visit>
+static void for_each_crossing(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                              unsigned int t, const Vec3f &origin, float dx, int ni, int nj, int nk,
+                              int kmin, int kmax, Visit visit)
+{
+   unsigned int p, q, r; assign(tri[t], p, q, r);
+   double fip=((double)x[p][0]-origin[0])/dx, fjp=((double)x[p][1]-origin[1])/dx, fkp=((double)x[p][2]-origin[2])/dx;
+   double fiq=((double)x[q][0]-origin[0])/dx, fjq=((double)x[q][1]-origin[1])/dx, fkq=((double)x[q][2]-origin[2])/dx;
+   double fir=((double)x[r][0]-origin[0])/dx, fjr=((double)x[r][1]-origin[1])/dx, fkr=((double)x[r][2]-origin[2])/dx;
+   int j0=clamp((int)std::ceil(min(fjp,fjq,fjr)), 0, nj-1);
+   int j1=clamp((int)std::floor(max(fjp,fjq,fjr)), 0, nj-1);
+   int k0=clamp((int)std::ceil(min(fkp,fkq,fkr)), 0, nk-1);
+   int k1=clamp((int)std::floor(max(fkp,fkq,fkr)), 0, nk-1);
+   k0=max(k0, kmin); k1=min(k1, kmax);
+   for(int k=k0; k<=k1; ++k) for(int j=j0; j<=j1; ++j){
+      double a, b, c;
+      if(point_in_triangle_2d(j, k, fjp, fkp, fjq, fkq, fjr, fkr, a, b, c)){
+         double fi=a*fip+b*fiq+c*fir; // intersection i coordinate
+         int i_interval=int(std::ceil(fi)); // intersection is in (i_interval-1,i_interval]
+         if(i_interval<0) visit(0, j, k); // we enlarge the first interval to include everything to the -x direction
+         else if(i_interval<ni) visit(i_interval, j, k);
+         // we ignore intersections that are beyond the +x side of the grid
+      }
+   }
 }
 
-namespace sdfgen {
-namespace cpu {
+/**
+ * @brief Visit the ray crossings of one triangle along any grid axis
+ *
+ * The same test as for_each_crossing() with the axes permuted cyclically: rays run along
+ * axis through the nodes of the (axis+1, axis+2) plane, so axis 0 gives exactly the +x
+ * crossings. Calls visit(i,j,k) with the node whose interval (n-1,n] along axis holds the
+ * crossing; crossings before the grid move into the first interval, crossings beyond it are
+ * dropped.
+ */
+template<class Visit>
+static void for_each_axis_crossing(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                                   unsigned int t, const Vec3f &origin, float dx, const int n[3],
+                                   int axis, Visit visit)
+{
+   const int u=(axis+1)%3, v=(axis+2)%3;
+   unsigned int p, q, r; assign(tri[t], p, q, r);
+   double fp[3], fq[3], fr[3];
+   for(int c=0; c<3; ++c){
+      fp[c]=((double)x[p][c]-origin[c])/dx;
+      fq[c]=((double)x[q][c]-origin[c])/dx;
+      fr[c]=((double)x[r][c]-origin[c])/dx;
+   }
+   int u0=clamp((int)std::ceil(min(fp[u],fq[u],fr[u])), 0, n[u]-1);
+   int u1=clamp((int)std::floor(max(fp[u],fq[u],fr[u])), 0, n[u]-1);
+   int v0=clamp((int)std::ceil(min(fp[v],fq[v],fr[v])), 0, n[v]-1);
+   int v1=clamp((int)std::floor(max(fp[v],fq[v],fr[v])), 0, n[v]-1);
+   int node[3];
+   for(int b=v0; b<=v1; ++b) for(int a=u0; a<=u1; ++a){
+      double wa, wb, wc;
+      if(point_in_triangle_2d(a, b, fp[u], fp[v], fq[u], fq[v], fr[u], fr[v], wa, wb, wc)){
+         int interval=int(std::ceil(wa*fp[axis]+wb*fq[axis]+wc*fr[axis]));
+         if(interval>=n[axis]) continue;
+         node[axis]=std::max(interval, 0);
+         node[u]=a;
+         node[v]=b;
+         visit(node[0], node[1], node[2]);
+      }
+   }
+}
 
-void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
-                     const Vec3f &origin, float dx, int ni, int nj, int nk,
-                     Array3f &phi, const int exact_band, int num_threads)
+/**
+ * @brief Near-band distances and +x crossings of one triangle, restricted to k in [kmin,kmax]
+ *
+ * This is the body of the original serial near-band loop with the k ranges clipped to a
+ * tile: distance(i0, j, k, dist, count) receives the distances of the nodes (i0..i0+count-1,
+ * j, k) of the band box, cross(i,j,k) each crossing. Cells outside the tile are never
+ * passed, so tiles can be processed concurrently.
+ */
+template<class Distance, class Cross>
+static void rasterize_triangle_band(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                                    unsigned int t, const Vec3f &origin, float dx, int exact_band,
+                                    int ni, int nj, int nk, int kmin, int kmax, bool near_distances,
+                                    Distance distance, Cross cross)
 {
-   phi.resize(ni, nj, nk);
-   phi.assign((ni+nj+nk)*dx); // upper bound on distance
-   Array3i closest_tri(ni, nj, nk, -1);
-   Array3i intersection_count(ni, nj, nk, 0); // intersection_count(i,j,k) is # of tri intersections in (i-1,i]x{j}x{k}
-
-   // we begin by initializing distances near the mesh, and figuring out intersection counts
-   Vec3f ijkmin, ijkmax;
-   for(unsigned int t=0; t<tri.size(); ++t){
-     unsigned int p, q, r; assign(tri[t], p, q, r);
-     // coordinates in grid to high precision
-      double fip=((double)x[p][0]-origin[0])/dx, fjp=((double)x[p][1]-origin[1])/dx, fkp=((double)x[p][2]-origin[2])/dx;
-      double fiq=((double)x[q][0]-origin[0])/dx, fjq=((double)x[q][1]-origin[1])/dx, fkq=((double)x[q][2]-origin[2])/dx;
-      double fir=((double)x[r][0]-origin[0])/dx, fjr=((double)x[r][1]-origin[1])/dx, fkr=((double)x[r][2]-origin[2])/dx;
-      // do distances nearby
-      int i0=clamp(int(min(fip,fiq,fir))-exact_band, 0, ni-1), i1=clamp(int(max(fip,fiq,fir))+exact_band+1, 0, ni-1);
-      int j0=clamp(int(min(fjp,fjq,fjr))-exact_band, 0, nj-1), j1=clamp(int(max(fjp,fjq,fjr))+exact_band+1, 0, nj-1);
-      int k0=clamp(int(min(fkp,fkq,fkr))-exact_band, 0, nk-1), k1=clamp(int(max(fkp,fkq,fkr))+exact_band+1, 0, nk-1);
-      for(int k=k0; k<=k1; ++k) for(int j=j0; j<=j1; ++j) for(int i=i0; i<=i1; ++i){
+   unsigned int p, q, r; assign(tri[t], p, q, r);
+   // coordinates in grid to high precision
+   double fip=((double)x[p][0]-origin[0])/dx, fjp=((double)x[p][1]-origin[1])/dx, fkp=((double)x[p][2]-origin[2])/dx;
+   double fiq=((double)x[q][0]-origin[0])/dx, fjq=((double)x[q][1]-origin[1])/dx, fkq=((double)x[q][2]-origin[2])/dx;
+   double fir=((double)x[r][0]-origin[0])/dx, fjr=((double)x[r][1]-origin[1])/dx, fkr=((double)x[r][2]-origin[2])/dx;
+   // do distances nearby
+   int i0=clamp(int(min(fip,fiq,fir))-exact_band, 0, ni-1), i1=clamp(int(max(fip,fiq,fir))+exact_band+1, 0, ni-1);
+   int j0=clamp(int(min(fjp,fjq,fjr))-exact_band, 0, nj-1), j1=clamp(int(max(fjp,fjq,fjr))+exact_band+1, 0, nj-1);
+   int k0=clamp(int(min(fkp,fkq,fkr))-exact_band, 0, nk-1), k1=clamp(int(max(fkp,fkq,fkr))+exact_band+1, 0, nk-1);
+   k0=max(k0, kmin); k1=min(k1, kmax);
+   if(!near_distances) k1=k0-1; // intersection counts only
+   if(k0<=k1 && i0<=i1){
+      // one SIMD batch per i-row of the band box
+      int count=i1-i0+1;
+      DistanceScratch &s=distance_scratch();
+      s.px.resize(count);
+      s.dist.resize(count);
+      for(int n=0; n<count; ++n) s.px[n]=(i0+n)*dx+origin[0];
+      s.evaluations+=(long long)count*(j1-j0+1)*(k1-k0+1);
+      for(int k=k0; k<=k1; ++k) for(int j=j0; j<=j1; ++j){
+         sdfgen::cpu::point_triangle_distances(x[p], x[q], x[r], &s.px[0], j*dx+origin[1], k*dx+origin[2],
+                                               count, &s.dist[0]);
+         distance(i0, j, k, &s.dist[0], count);
+      }
+   }
+   // and do intersection counts
+   for_each_crossing(tri, x, t, origin, dx, ni, nj, nk, kmin, kmax, cross);
+}
+
+/**
+ * @brief Exact distances and intersection counts for one triangle, restricted to k in [kmin,kmax]
+ *
+ * closest_tri receives original[t] (t without a map), and equal distances go to the lower
+ * stored index, so each cell ends up with the minimum over (distance, index) whatever order
+ * the triangles are visited in.
+ */
+static void rasterize_triangle(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                               unsigned int t, const unsigned int *original,
+                               const Vec3f &origin, float dx, int exact_band,
+                               int kmin, int kmax, bool near_distances,
+                               Array3f &phi, Array3i &closest_tri, Array3i &intersection_count)
+{
+   int id=original ? (int)original[t] : (int)t;
+   rasterize_triangle_band(tri, x, t, origin, dx, exact_band, phi.ni, phi.nj, phi.nk, kmin, kmax, near_distances,
+      [&](int i0, int j, int k, const float *dist, int count){
+         for(int n=0; n<count; ++n){
+            float d=dist[n];
+            float &v=phi(i0+n,j,k);
+            if(d<v || (d==v && id<closest_tri(i0+n,j,k))){
+               v=d;
+               closest_tri(i0+n,j,k)=id;
+            }
+         }
+      },
+      [&](int i, int j, int k){ ++intersection_count(i,j,k); });
+}
+
+/**
+ * @brief Run rasterize(t, kmin, kmax) for every triangle over k-slab tiles of the grid
+ *
+ * The grid is cut into k-slab tiles, each owned by exactly one thread. A tile walks the
+ * triangles whose k extent overlaps it in increasing index order and only touches its own
+ * slices, so every cell sees the same sequence of updates as the serial loop.
+ */
+template<class Rasterize>
+static void for_each_band_tile(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                               const Vec3f &origin, float dx, int nk, int exact_band,
+                               sdfgen::ThreadPool &pool, unsigned int threads,
+                               std::atomic<long long> *evaluations, Rasterize rasterize)
+{
+   unsigned int num_tri=(unsigned int)tri.size();
+   if(threads<=1 || nk<2 || num_tri==0){
+      EvaluationTally tally(evaluations);
+      for(unsigned int t=0; t<num_tri; ++t) rasterize(t, 0, nk-1);
+      return;
+   }
+
+   // per-triangle k extents, computed once so tiles can reject triangles cheaply
+   std::vector<int> tri_k0(num_tri), tri_k1(num_tri);
+   const unsigned int chunk=4096;
+   pool.parallel_for((int)((num_tri+chunk-1)/chunk), threads, [&](int c){
+      unsigned int t_end=std::min(num_tri, (c+1)*chunk);
+      for(unsigned int t=c*chunk; t<t_end; ++t)
+         triangle_k_extent(tri, x, t, origin, dx, nk, exact_band, tri_k0[t], tri_k1[t]);
+   });
+
+   // Several tiles per thread so uneven triangle density still balances
+   int num_tiles=std::min(nk, (int)threads*4);
+   int tile_size=(nk+num_tiles-1)/num_tiles;
+   num_tiles=(nk+tile_size-1)/tile_size;
+
+   // bin triangles into the tiles they overlap (counting sort keeps increasing index order per bin)
+   std::vector<size_t> bin_start(num_tiles+1, 0);
+   for(unsigned int t=0; t<num_tri; ++t)
+      for(int tile=tri_k0[t]/tile_size; tile<=tri_k1[t]/tile_size; ++tile) ++bin_start[tile+1];
+   for(int tile=0; tile<num_tiles; ++tile) bin_start[tile+1]+=bin_start[tile];
+   std::vector<unsigned int> bin_tris(bin_start[num_tiles]);
+   {
+      std::vector<size_t> fill(bin_start.begin(), bin_start.end()-1);
+      for(unsigned int t=0; t<num_tri; ++t)
+         for(int tile=tri_k0[t]/tile_size; tile<=tri_k1[t]/tile_size; ++tile) bin_tris[fill[tile]++]=t;
+   }
+
+   pool.parallel_for(num_tiles, threads, [&](int tile){
+      EvaluationTally tally(evaluations);
+      int kmin=tile*tile_size, kmax=std::min(nk-1, kmin+tile_size-1);
+      for(size_t n=bin_start[tile]; n<bin_start[tile+1]; ++n) rasterize(bin_tris[n], kmin, kmax);
+   });
+}
+
+/** @brief Nodes per task of the parity sign pass (whole rows, at least one) */
+static const int parity_task_nodes=16384;
+
+/**
+ * @brief Multi-threaded near-band initialization and intersection counting
+ *
+ * Tiles as in for_each_band_tile(): every cell sees the same sequence of strict "d<phi"
+ * updates as the serial loop and the output is bit-identical for any thread count.
+ * Intersection counts are integer increments on rows owned by the tile, so they are
+ * order-independent. With near_distances false only the intersection counts are produced.
+ * With an original map, tri is a reordered copy of the mesh and closest_tri holds input
+ * indices; the index tie-break makes the result equal to that of the input mesh.
+ */
+static void near_band_pass(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                           const unsigned int *original, const Vec3f &origin, float dx,
+                           Array3f &phi, Array3i &closest_tri, Array3i &intersection_count,
+                           int exact_band, bool near_distances, sdfgen::ThreadPool &pool, unsigned int threads,
+                           std::atomic<long long> *evaluations)
+{
+   for_each_band_tile(tri, x, origin, dx, phi.nk, exact_band, pool, threads, evaluations,
+      [&](unsigned int t, int kmin, int kmax){
+         rasterize_triangle(tri, x, t, original, origin, dx, exact_band, kmin, kmax, near_distances,
+                            phi, closest_tri, intersection_count);
+      });
+}
+
+/**
+ * @brief Exact nearest-triangle distance for every cell using a BVH
+ *
+ * Rows are independent and are distributed over the pool. Each cell's query is seeded with
+ * the distance to the previous cell's nearest triangle, which is a tight upper bound that
+ * lets the traversal skip almost every node. The result equals a brute-force minimum over
+ * all triangles (same distance function, same lowest-index tie-break), bounded above by the
+ * initial value already stored in phi.
+ */
+static void exact_distance_pass(const sdfgen::TriangleBVH &bvh, const Vec3f &origin, float dx,
+                                Array3f &phi, Array3i &closest_tri,
+                                sdfgen::ThreadPool &pool, unsigned int threads, std::atomic<long long> *evaluations)
+{
+   int ni=phi.ni, nj=phi.nj, nk=phi.nk;
+   const std::vector<Vec3f> &corners=bvh.corners();
+   // triangle slot for an original index, to evaluate the seed triangle from BVH storage
+   std::vector<int> slot(bvh.triangle_order().size());
+   for(size_t n=0; n<slot.size(); ++n) slot[bvh.triangle_order()[n]]=(int)n;
+
+   pool.parallel_for(nj*nk, threads, [&](int row){
+      EvaluationTally tally(evaluations);
+      long long &count=distance_scratch().evaluations;
+      int j=row%nj, k=row/nj;
+      int prev=-1;
+      for(int i=0; i<ni; ++i){
          Vec3f gx(i*dx+origin[0], j*dx+origin[1], k*dx+origin[2]);
-         float d=point_triangle_distance(gx, x[p], x[q], x[r]);
-         if(d<phi(i,j,k)){
-            phi(i,j,k)=d;
-            closest_tri(i,j,k)=t;
+         float best=phi(i,j,k);
+         int best_tri=-1;
+         if(prev>=0){
+            int n=slot[prev];
+            float d=point_triangle_distance(gx, corners[3*n], corners[3*n+1], corners[3*n+2]);
+            ++count;
+            if(d<best){ best=d; best_tri=prev; }
          }
+         count+=bvh.nearest(gx, best, best_tri);
+         phi(i,j,k)=best;
+         closest_tri(i,j,k)=best_tri;
+         prev=best_tri;
       }
-      // and do intersection counts
-      j0=clamp((int)std::ceil(min(fjp,fjq,fjr)), 0, nj-1);
-      j1=clamp((int)std::floor(max(fjp,fjq,fjr)), 0, nj-1);
-      k0=clamp((int)std::ceil(min(fkp,fkq,fkr)), 0, nk-1);
-      k1=clamp((int)std::floor(max(fkp,fkq,fkr)), 0, nk-1);
-      for(int k=k0; k<=k1; ++k) for(int j=j0; j<=j1; ++j){
-         double a, b, c;
-         if(point_in_triangle_2d(j, k, fjp, fkp, fjq, fkq, fjr, fkr, a, b, c)){
-            double fi=a*fip+b*fiq+c*fir; // intersection i coordinate
-            int i_interval=int(std::ceil(fi)); // intersection is in (i_interval-1,i_interval]
-            if(i_interval<0) ++intersection_count(0, j, k); // we enlarge the first interval to include everything to the -x direction
-            else if(i_interval<ni) ++intersection_count(i_interval,j,k);
-            // we ignore intersections that are beyond the +x side of the grid
+   });
+}
+
+/**
+ * @brief Signs from the generalized winding number instead of the crossing parity
+ *
+ * phi holds unsigned distances. Along each (j,k) row, nodes with phi <= dx can sit next to
+ * the surface and are evaluated one by one. Between them lie runs of nodes farther than dx
+ * from every triangle (phi never underestimates, and every node that close was reached by
+ * the exact band), so no surface passes between neighbours of a run and its side can only
+ * change across the smooth winding-number field of a hole: the run's two ends are
+ * evaluated and only a run whose ends disagree is bisected. Far-field nodes therefore cost
+ * about two queries per run instead of one each.
+ *
+ * @return Number of winding-number queries
+ */
+static long long winding_sign_pass(const sdfgen::WindingNumberTree &tree, const Vec3f &origin, float dx,
+                                   Array3f &phi, sdfgen::ThreadPool &pool, unsigned int threads)
+{
+   int ni=phi.ni, nj=phi.nj, nk=phi.nk;
+   std::atomic<long long> queries(0);
+   pool.parallel_for(nj*nk, threads, [&](int row){
+      int j=row%nj, k=row/nj;
+      static thread_local std::vector<unsigned char> inside;
+      inside.resize(ni);
+      long long row_queries=0;
+      auto side=[&](int i){
+         ++row_queries;
+         return (unsigned char)(tree.winding_number(Vec3f(i*dx+origin[0], j*dx+origin[1], k*dx+origin[2]))>=0.5f);
+      };
+      struct Run { int a, b; unsigned char sa, sb; };
+      Run stack[128];
+      for(int i=0; i<ni; ){
+         if(phi(i,j,k)<=dx){ inside[i]=side(i); ++i; continue; }
+         int b=i;
+         while(b+1<ni && phi(b+1,j,k)>dx) ++b;
+         int top=0;
+         unsigned char sa=side(i);
+         stack[top++]=Run{i, b, sa, b==i ? sa : side(b)};
+         while(top>0){
+            Run r=stack[--top];
+            if(r.sa==r.sb){ for(int n=r.a; n<=r.b; ++n) inside[n]=r.sa; continue; }
+            if(r.b-r.a==1){ inside[r.a]=r.sa; inside[r.b]=r.sb; continue; }
+            int m=(r.a+r.b)/2;
+            unsigned char sm=side(m);
+            stack[top++]=Run{r.a, m, r.sa, sm};
+            stack[top++]=Run{m, r.b, sm, r.sb};
          }
+         i=b+1;
+      }
+      for(int i=0; i<ni; ++i) if(inside[i]) phi(i,j,k)=-phi(i,j,k);
+      queries+=row_queries;
+   });
+   return queries;
+}
+
+/**
+ * @brief Diagnostics after the near-band pass: band size, distance range and crossings
+ *
+ * Per-slice partial results are combined in slice order, so the result does not depend on
+ * the thread count.
+ */
+static void near_band_statistics(const Array3f &phi, const Array3i &closest_tri, const Array3i &intersection_count,
+                                 sdfgen::ThreadPool &pool, unsigned int threads, sdfgen::GenerationStats &stats)
+{
+   int nk=phi.nk;
+   std::vector<long long> cells(nk, 0), crossings(nk, 0);
+   std::vector<float> lo(nk, 0), hi(nk, 0);
+   pool.parallel_for(nk, threads, [&](int k){
+      for(int j=0; j<phi.nj; ++j) for(int i=0; i<phi.ni; ++i){
+         crossings[k]+=intersection_count(i,j,k);
+         if(closest_tri(i,j,k)<0) continue;
+         float d=phi(i,j,k);
+         if(cells[k]==0 || d<lo[k]) lo[k]=d;
+         if(cells[k]==0 || d>hi[k]) hi[k]=d;
+         ++cells[k];
+      }
+   });
+   stats.near_band_cells=0;
+   stats.intersections=0;
+   for(int k=0; k<nk; ++k){
+      stats.intersections+=crossings[k];
+      if(cells[k]==0) continue;
+      if(stats.near_band_cells==0 || lo[k]<stats.near_band_min) stats.near_band_min=lo[k];
+      if(stats.near_band_cells==0 || hi[k]>stats.near_band_max) stats.near_band_max=hi[k];
+      stats.near_band_cells+=cells[k];
+   }
+   stats.diagnostics_valid=true;
+}
+
+/**
+ * @brief Index box of the near band of one triangle (the box rasterize_triangle() fills)
+ */
+static void triangle_band_box(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                              unsigned int t, const Vec3f &origin, float dx, int ni, int nj, int nk,
+                              int exact_band, Vec3i &lo, Vec3i &hi)
+{
+   unsigned int p, q, r; assign(tri[t], p, q, r);
+   for(int a=0; a<3; ++a){
+      int n=(a==0) ? ni : (a==1) ? nj : nk;
+      double fp=((double)x[p][a]-origin[a])/dx, fq=((double)x[q][a]-origin[a])/dx, fr=((double)x[r][a]-origin[a])/dx;
+      lo[a]=clamp(int(min(fp,fq,fr))-exact_band, 0, n-1);
+      hi[a]=clamp(int(max(fp,fq,fr))+exact_band+1, 0, n-1);
+   }
+}
+
+/**
+ * @brief Unsigned distance update of a signed field that keeps the node's current sign
+ *
+ * Used by the incremental update, which only recomputes signs on the rows whose crossings
+ * changed; every other node keeps the side of the surface it was on.
+ */
+static inline bool lower_distance(Array3f &phi, Array3i &closest_tri, int i, int j, int k, float d, int t)
+{
+   float &v=phi(i,j,k);
+   if(!(d<std::fabs(v))) return false;
+   v=(v<0) ? -d : d;
+   closest_tri(i,j,k)=t;
+   return true;
+}
+
+/** @brief One +x ray crossing of a (j,k) row, row=j+nj*k, in the interval (i-1,i] */
+struct RowCrossing {
+   unsigned long long row;
+   int i;
+   bool operator<(const RowCrossing &o) const { return row<o.row || (row==o.row && i<o.i); }
+};
+
+/** @brief A triangle binned into a sparse tile; t=-1 marks a tile only activated for a crossing */
+struct TileTriangle {
+   unsigned long long tile;
+   int t;
+   bool operator<(const TileTriangle &o) const { return tile<o.tile || (tile==o.tile && t<o.t); }
+};
+
+/**
+ * @brief Tiles a triangle's near band can reach
+ *
+ * Starts from the same index box as the dense near band (so every node within band*dx of
+ * the triangle is covered) and drops tiles whose bounding sphere lies farther than band*dx
+ * from the triangle's plane, which keeps large slanted triangles from activating their whole
+ * bounding box.
+ */
+static void bin_triangle_tiles(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                               unsigned int t, const Vec3f &origin, float dx, int band,
+                               const sdfgen::SparseLevelSet &phi, std::vector<TileTriangle> &out)
+{
+   const int B=sdfgen::SparseLevelSet::brick_size;
+   unsigned int p, q, r; assign(tri[t], p, q, r);
+   double fip=((double)x[p][0]-origin[0])/dx, fjp=((double)x[p][1]-origin[1])/dx, fkp=((double)x[p][2]-origin[2])/dx;
+   double fiq=((double)x[q][0]-origin[0])/dx, fjq=((double)x[q][1]-origin[1])/dx, fkq=((double)x[q][2]-origin[2])/dx;
+   double fir=((double)x[r][0]-origin[0])/dx, fjr=((double)x[r][1]-origin[1])/dx, fkr=((double)x[r][2]-origin[2])/dx;
+   int i0=clamp(int(min(fip,fiq,fir))-band, 0, phi.ni-1), i1=clamp(int(max(fip,fiq,fir))+band+1, 0, phi.ni-1);
+   int j0=clamp(int(min(fjp,fjq,fjr))-band, 0, phi.nj-1), j1=clamp(int(max(fjp,fjq,fjr))+band+1, 0, phi.nj-1);
+   int k0=clamp(int(min(fkp,fkq,fkr))-band, 0, phi.nk-1), k1=clamp(int(max(fkp,fkq,fkr))+band+1, 0, phi.nk-1);
+
+   // plane of the triangle in grid units; degenerate triangles keep the whole box
+   Vec3d n=cross(Vec3d(fiq-fip, fjq-fjp, fkq-fkp), Vec3d(fir-fip, fjr-fjp, fkr-fkp));
+   double len=mag(n);
+   if(len>0) n/=len;
+   double reach=0.5*(B-1)*std::sqrt(3.0)+band+1e-3;
+
+   for(int tk=k0/B; tk<=k1/B; ++tk) for(int tj=j0/B; tj<=j1/B; ++tj) for(int ti=i0/B; ti<=i1/B; ++ti){
+      if(len>0){
+         Vec3d c(ti*B+0.5*(B-1)-fip, tj*B+0.5*(B-1)-fjp, tk*B+0.5*(B-1)-fkp);
+         if(std::fabs(dot(n, c))>reach) continue;
       }
+      TileTriangle e={phi.tile_index(ti,tj,tk), (int)t};
+      out.push_back(e);
+   }
+}
+
+/**
+ * @brief Per-chunk lists of triangles, filled in parallel and concatenated in chunk order
+ */
+template<class Item, class Fill>
+static void gather_chunks(unsigned int num_tri, sdfgen::ThreadPool &pool, unsigned int threads,
+                          std::vector<Item> &out, Fill fill)
+{
+   const unsigned int chunk=4096;
+   int num_chunks=(int)((num_tri+chunk-1)/chunk);
+   std::vector<std::vector<Item> > parts(num_chunks);
+   pool.parallel_for(num_chunks, threads, [&](int c){
+      unsigned int t_end=std::min(num_tri, (c+1)*chunk);
+      for(unsigned int t=c*chunk; t<t_end; ++t) fill(t, parts[c]);
+   });
+   size_t total=0;
+   for(size_t c=0; c<parts.size(); ++c) total+=parts[c].size();
+   out.clear();
+   out.reserve(total);
+   for(size_t c=0; c<parts.size(); ++c){
+      out.insert(out.end(), parts[c].begin(), parts[c].end());
+      std::vector<Item>().swap(parts[c]);
    }
+}
+
+/** @brief A y or z ray crossing, grouped by the plane it sweeps: node (l, step) of that plane */
+struct PlaneCrossing {
+   int plane, step, l;
+   bool operator<(const PlaneCrossing &o) const { return step<o.step || (step==o.step && l<o.l); }
+};
+
+/**
+ * @brief Crossings of all triangles along axis 1 (y, bucketed by k) or 2 (z, bucketed by j)
+ *
+ * Bucket h holds sorted[start[h]..start[h+1]) in (step, l) order, step being the node index
+ * along the ray and l the i index.
+ */
+static void gather_plane_crossings(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                                   const Vec3f &origin, float dx, const int n[3], int axis,
+                                   sdfgen::ThreadPool &pool, unsigned int threads,
+                                   std::vector<PlaneCrossing> &sorted, std::vector<size_t> &start)
+{
+   const int planes=axis==1 ? n[2] : n[1];
+   std::vector<PlaneCrossing> crossings;
+   gather_chunks((unsigned int)tri.size(), pool, threads, crossings, [&](unsigned int t, std::vector<PlaneCrossing> &out){
+      for_each_axis_crossing(tri, x, t, origin, dx, n, axis, [&](int i, int j, int k){
+         PlaneCrossing c={axis==1 ? k : j, axis==1 ? j : k, i};
+         out.push_back(c);
+      });
+   });
+   start.assign(planes+1, 0);
+   for(size_t c=0; c<crossings.size(); ++c) ++start[crossings[c].plane+1];
+   for(int h=0; h<planes; ++h) start[h+1]+=start[h];
+   sorted.resize(crossings.size());
+   std::vector<size_t> fill(start.begin(), start.end()-1);
+   for(size_t c=0; c<crossings.size(); ++c) sorted[fill[crossings[c].plane]++]=crossings[c];
+   pool.parallel_for(planes, threads, [&](int h){
+      std::sort(sorted.begin()+start[h], sorted.begin()+start[h+1]);
+   });
+}
 
-   // Multi-threaded fast sweeping (FluidX3D approach - simple and fast)
-   // Determine number of threads (0 = auto-detect)
-   unsigned int threads = (num_threads <= 0) ? std::thread::hardware_concurrency() : (unsigned int)num_threads;
-   if(threads == 0) threads = 4; // fallback
+/**
+ * @brief Signs by majority vote of the crossing parities along x, y and z
+ *
+ * The x parity comes from the near band's intersection counts; the y and z crossings are
+ * gathered per triangle and bucketed by the plane their rays sweep. Two column passes follow:
+ * each k plane walks its x rows and y columns together and stores the two votes, then each j
+ * plane walks its z columns and flips phi where at least two axes say inside. Both passes
+ * keep one parity bit per i and read contiguous i rows. A ray grazing an edge or vertex of
+ * axis-aligned geometry corrupts its own axis only, and the other two outvote it.
+ * phi holds unsigned distances on entry.
+ */
+static void ray_vote_sign_pass(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                               const Vec3f &origin, float dx, const Array3i &intersection_count,
+                               Array3f &phi, sdfgen::ThreadPool &pool, unsigned int threads)
+{
+   int ni=phi.ni, nj=phi.nj, nk=phi.nk;
+   const int n[3]={ni, nj, nk};
+   std::vector<PlaneCrossing> y_crossings, z_crossings;
+   std::vector<size_t> y_start, z_start;
+   gather_plane_crossings(tri, x, origin, dx, n, 1, pool, threads, y_crossings, y_start);
+   gather_plane_crossings(tri, x, origin, dx, n, 2, pool, threads, z_crossings, z_start);
+
+   Array3uc votes(ni, nj, nk);
+   pool.parallel_for(nk, threads, [&](int k){
+      static thread_local std::vector<unsigned char> parity;
+      parity.assign(ni, 0);
+      size_t c=y_start[k];
+      for(int j=0; j<nj; ++j){
+         for(; c<y_start[k+1] && y_crossings[c].step==j; ++c) parity[y_crossings[c].l]^=1;
+         int total_count=0;
+         for(int i=0; i<ni; ++i){
+            total_count+=intersection_count(i,j,k);
+            votes(i,j,k)=(unsigned char)((total_count&1)+parity[i]);
+         }
+      }
+   });
+   pool.parallel_for(nj, threads, [&](int j){
+      static thread_local std::vector<unsigned char> parity;
+      parity.assign(ni, 0);
+      size_t c=z_start[j];
+      for(int k=0; k<nk; ++k){
+         for(; c<z_start[j+1] && z_crossings[c].step==k; ++c) parity[z_crossings[c].l]^=1;
+         float *row=&phi(0,j,k);
+         for(int i=0; i<ni; ++i){
+            uint32_t bits;
+            std::memcpy(&bits, &row[i], sizeof(bits));
+            bits|=(uint32_t)(votes(i,j,k)+parity[i]>=2)<<31; // phi is unsigned here
+            std::memcpy(&row[i], &bits, sizeof(bits));
+         }
+      }
+   });
+}
+
+namespace sdfgen {
+namespace cpu {
 
-   for(unsigned int pass=0; pass<2; ++pass){
+void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                     const Vec3f &origin, float dx, int ni, int nj, int nk,
+                     Array3f &phi, const int exact_band, int num_threads)
+{
+   GenerationOptions options;
+   options.exact_band=exact_band;
+   options.num_threads=num_threads;
+   make_level_set3(tri, x, origin, dx, ni, nj, nk, phi, options);
+}
+
+/**
+ * @brief Fast-sweeping passes (8 directions each, 2 for dense generation) over phi and closest_tri
+ *
+ * Templated on the grid types so the same code sweeps the linear Array3 grids and their
+ * bricked copies (GridLayout::Bricked); the update order, and so the result, is the same.
+ * @return false if generation was cancelled
+ */
+template<class PhiGrid, class TriGrid>
+static bool fast_sweep(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                       const Vec3f &origin, float dx, PhiGrid &phi, TriGrid &closest_tri,
+                       const sdfgen::TriangleTable *table, const GenerationOptions &options,
+                       ThreadPool &pool, unsigned int threads, std::atomic<long long> *tally, int passes=2)
+{
+   for(int pass=0; pass<passes; ++pass){
       // For each of the 8 sweep directions
       int sweep_dirs[8][3] = {
          {+1, +1, +1}, {-1, -1, -1}, {+1, +1, -1}, {-1, -1, +1},
@@ -248,17 +839,23 @@ void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x
       };
 
       for(int s=0; s<8; ++s){
+         if(generation_cancelled(options)) return false;
          int di = sweep_dirs[s][0];
          int dj = sweep_dirs[s][1];
          int dk = sweep_dirs[s][2];
 
+         if(options.sweep_mode == SweepMode::Wavefront){
+            sweep_wavefront(tri, x, phi, closest_tri, origin, dx, di, dj, dk, table, pool, threads, tally);
+            continue;
+         }
+
+         // Legacy slab mode (FluidX3D approach): contiguous k-slabs per thread
          // Determine k range
          int k0, k1;
-         if(dk>0){ k0=1; k1=nk; }
-         else{ k0=nk-2; k1=-1; }
+         if(dk>0){ k0=1; k1=phi.nk; }
+         else{ k0=phi.nk-2; k1=-1; }
 
          // Split work among threads
-         std::vector<std::thread> thread_pool;
          int k_range = (dk>0) ? (k1-k0) : (k0-k1);
 
          // CRITICAL: Don't use more threads than we have slices
@@ -267,39 +864,766 @@ void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x
 
          int slices_per_thread = std::max(1, k_range / (int)effective_threads);
 
-         for(unsigned int t=0; t<effective_threads; ++t){
+         pool.parallel_for((int)effective_threads, effective_threads, [&](int t){
+            EvaluationTally count(tally);
             int thread_k_start, thread_k_end;
             if(dk>0){
                thread_k_start = k0 + t * slices_per_thread;
-               thread_k_end = (t == effective_threads-1) ? k1 : (k0 + (t+1) * slices_per_thread);
+               thread_k_end = (t == (int)effective_threads-1) ? k1 : (k0 + (t+1) * slices_per_thread);
             } else {
                thread_k_start = k0 - t * slices_per_thread;
-               thread_k_end = (t == effective_threads-1) ? k1 : (k0 - (t+1) * slices_per_thread);
+               thread_k_end = (t == (int)effective_threads-1) ? k1 : (k0 - (t+1) * slices_per_thread);
             }
 
             if((dk>0 && thread_k_start < thread_k_end) || (dk<0 && thread_k_start > thread_k_end)){
-               thread_pool.emplace_back(sweep_range, std::ref(tri), std::ref(x),
-                                   std::ref(phi), std::ref(closest_tri),
-                                   origin, dx, di, dj, dk, thread_k_start, thread_k_end);
+               sweep_range(tri, x, phi, closest_tri, origin, dx, di, dj, dk, thread_k_start, thread_k_end, table);
+            }
+         });
+      }
+   }
+   return true;
+}
+
+/**
+ * @brief Move a linear grid into bricks, freeing the linear storage
+ */
+template<class T, class ArrayT>
+static void to_bricked(Array3<T,ArrayT> &grid, BrickedArray3<T> &bricked, ThreadPool &pool, unsigned int threads)
+{
+   bricked.assign(grid.ni, grid.nj, grid.nk, T());
+   pool.parallel_for(bricked.slabs(), threads, [&](int s){ bricked.import_slab(grid, s); });
+   grid.clear();
+}
+
+/**
+ * @brief Move a bricked grid back into linear storage, freeing the bricks
+ */
+template<class T, class ArrayT>
+static void from_bricked(BrickedArray3<T> &bricked, Array3<T,ArrayT> &grid, ThreadPool &pool, unsigned int threads)
+{
+   grid.resize(bricked.ni, bricked.nj, bricked.nk);
+   pool.parallel_for(bricked.slabs(), threads, [&](int s){ bricked.export_slab(grid, s); });
+   bricked.clear();
+}
+
+/**
+ * @brief Inside/outside signs for the unsigned distances in phi, by options.sign_mode
+ */
+static void sign_pass(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x, const Vec3f &origin, float dx,
+                      Array3f &phi, const Array3i &intersection_count, const GenerationOptions &options,
+                      ThreadPool &pool, unsigned int threads, GenerationStats *stats)
+{
+   if(options.sign_mode == SignMode::WindingNumber){
+      WindingNumberTree tree(tri, x);
+      long long queries=winding_sign_pass(tree, origin, dx, phi, pool, threads);
+      if(stats) stats->winding_evaluations=queries;
+      return;
+   }
+   if(options.sign_mode == SignMode::RayVote){
+      ray_vote_sign_pass(tri, x, origin, dx, intersection_count, phi, pool, threads);
+      return;
+   }
+
+   // then figure out signs (inside/outside) from intersection counts; (j,k) rows are
+   // independent, so tasks take blocks of whole rows (not k planes, which a thin grid has few of)
+   const int ni=phi.ni, rows=phi.nj*phi.nk;
+   const int rows_per_task=std::max(1, parity_task_nodes/std::max(1, ni));
+   pool.parallel_for((rows+rows_per_task-1)/rows_per_task, threads, [&](int task){
+      for(int row=task*rows_per_task; row<rows && row<(task+1)*rows_per_task; ++row)
+         sdfgen::cpu::parity_signs(&intersection_count.a[(size_t)row*ni], &phi.a[(size_t)row*ni], ni);
+   });
+}
+
+/**
+ * @brief Dense generation, leaving the nearest triangles and crossing counts in the caller's arrays
+ * @param keep_closest false to free closest_tri once the sweeps are done, before the sign pass allocates
+ */
+static void generate_dense(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                           const Vec3f &origin, float dx, int ni, int nj, int nk,
+                           Array3f &phi, Array3i &closest_tri, Array3i &intersection_count,
+                           const GenerationOptions &options, GenerationStats *stats, bool keep_closest)
+{
+   const int exact_band=options.exact_band;
+   PhaseTimer timer(options, stats);
+   timer.begin(GenerationPhase::Setup);
+   phi.resize(ni, nj, nk);
+   phi.assign((ni+nj+nk)*dx); // upper bound on distance
+   closest_tri.assign(ni, nj, nk, -1);
+   intersection_count.assign(ni, nj, nk, 0); // intersection_count(i,j,k) is # of tri intersections in (i-1,i]x{j}x{k}
+
+   // Determine number of threads (0 = auto-detect); all phases share the process-wide pool
+   unsigned int threads = resolve_thread_count(options.num_threads);
+
+   ThreadPool &pool=ThreadPool::global();
+   bool exact=(options.distance_mode == DistanceMode::Exact);
+   std::atomic<long long> evaluations(0);
+   std::atomic<long long> *tally=stats ? &evaluations : 0;
+   size_t host_bytes=phi.a.size()*(sizeof(float)+2*sizeof(int));
+   timer.begin(GenerationPhase::NearBand);
+
+   // we begin by initializing distances near the mesh, and figuring out intersection counts;
+   // optionally on a spatially sorted copy, with closest_tri still indexing the input mesh
+   if(options.spatial_reorder && tri.size()>1){
+      SpatialOrder order;
+      spatial_reorder(tri, x, origin, dx, ni, nj, nk, order, (int)threads);
+      host_bytes+=order.tri.size()*(sizeof(Vec3ui)+sizeof(unsigned int))+order.x.size()*sizeof(Vec3f);
+      near_band_pass(order.tri, order.x, &order.original[0], origin, dx, phi, closest_tri, intersection_count,
+                     exact_band, !exact, pool, threads, tally);
+   }else{
+      near_band_pass(tri, x, 0, origin, dx, phi, closest_tri, intersection_count, exact_band, !exact, pool, threads,
+                     tally);
+   }
+   if(generation_cancelled(options)) return;
+
+   if(stats && options.diagnostics)
+      near_band_statistics(phi, closest_tri, intersection_count, pool, threads, *stats);
+   timer.begin(GenerationPhase::Sweep);
+
+   if(exact){
+      // exact distances everywhere from a BVH; no sweeping needed
+      TriangleBVH bvh(tri, x);
+      host_bytes+=bvh.memory_bytes();
+      exact_distance_pass(bvh, origin, dx, phi, closest_tri, pool, threads, tally);
+      if(generation_cancelled(options)) return;
+   }
+
+   // Optional precomputed triangle geometry for the sweep queries
+   TriangleTable triangle_table;
+   const TriangleTable *table=0;
+   if(options.triangle_table && !exact && !tri.empty()){
+      triangle_table.build(tri, x);
+      table=&triangle_table;
+      host_bytes+=triangle_table.memory_bytes();
+   }
+
+   // Multi-threaded fast sweeping
+   if(stats) stats->sweep_iterations=exact ? 0 : 16;
+   if(!exact && options.grid_layout == GridLayout::Bricked){
+      // bricked copies for the sweeps only, converted one grid at a time so at most one extra
+      // grid is held; closest_tri is only converted back when the caller keeps it
+      BrickedArray3f bricked_phi;
+      BrickedArray3i bricked_tri;
+      host_bytes+=BrickedArray3f::bytes_for(ni, nj, nk);
+      to_bricked(phi, bricked_phi, pool, threads);
+      to_bricked(closest_tri, bricked_tri, pool, threads);
+      if(!fast_sweep(tri, x, origin, dx, bricked_phi, bricked_tri, table, options, pool, threads, tally)) return;
+      from_bricked(bricked_phi, phi, pool, threads);
+      if(keep_closest) from_bricked(bricked_tri, closest_tri, pool, threads);
+   }else if(!exact){
+      if(!fast_sweep(tri, x, origin, dx, phi, closest_tri, table, options, pool, threads, tally)) return;
+   }
+
+   if(stats){
+      stats->distance_evaluations=evaluations.load();
+      stats->host_bytes=host_bytes;
+   }
+   if(!keep_closest) closest_tri.clear();
+   timer.begin(GenerationPhase::Sign);
+   sign_pass(tri, x, origin, dx, phi, intersection_count, options, pool, threads, stats);
+}
+
+/**
+ * @brief Far field of a pyramid level from the nearest triangles of the level above it
+ *
+ * The coarse level has twice the spacing and the same origin, so fine node i lies between
+ * coarse nodes i/2 and (i+1)/2 on each axis. Every node the near band left without a triangle
+ * takes the nearest of the (up to 8 distinct) triangles stored at those coarse nodes, which
+ * is the distance to an actual triangle and within about a coarse cell of the true nearest.
+ */
+static void seed_from_coarse(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                             const Vec3f &origin, float dx, Array3f &phi, Array3i &closest_tri,
+                             const Array3i &coarse, ThreadPool &pool, unsigned int threads,
+                             std::atomic<long long> *tally)
+{
+   const int ni=phi.ni, nj=phi.nj;
+   pool.parallel_for(phi.nk, threads, [&](int k){
+      EvaluationTally count(tally);
+      long long &evaluations=distance_scratch().evaluations;
+      const int ck[2]={std::min(k/2, coarse.nk-1), std::min((k+1)/2, coarse.nk-1)};
+      for(int j=0; j<nj; ++j){
+         const int cj[2]={std::min(j/2, coarse.nj-1), std::min((j+1)/2, coarse.nj-1)};
+         for(int i=0; i<ni; ++i){
+            if(closest_tri(i,j,k)>=0) continue;
+            const int ci[2]={std::min(i/2, coarse.ni-1), std::min((i+1)/2, coarse.ni-1)};
+            int candidates[8], found=0;
+            for(int c=0; c<8; ++c){
+               int t=coarse(ci[c&1], cj[(c>>1)&1], ck[c>>2]);
+               if(t>=0 && std::find(candidates, candidates+found, t)==candidates+found) candidates[found++]=t;
+            }
+            Vec3f gx(i*dx+origin[0], j*dx+origin[1], k*dx+origin[2]);
+            for(int c=0; c<found; ++c){
+               unsigned int p, q, r; assign(tri[candidates[c]], p, q, r);
+               float d=point_triangle_distance(gx, x[p], x[q], x[r]);
+               ++evaluations;
+               if(d<phi(i,j,k)){
+                  phi(i,j,k)=d;
+                  closest_tri(i,j,k)=candidates[c];
+               }
             }
          }
+      }
+   });
+}
 
-         // Wait for all threads to complete
-         for(auto& thread : thread_pool){
-            thread.join();
+/**
+ * @brief One finer pyramid level: near band, far field seeded from the coarser level, one sweep pass
+ * @param coarse Nearest triangles of the level with twice the spacing
+ */
+static void generate_seeded(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                            const Vec3f &origin, float dx, int ni, int nj, int nk,
+                            Array3f &phi, Array3i &closest_tri, const Array3i &coarse,
+                            const GenerationOptions &options, GenerationStats *stats)
+{
+   PhaseTimer timer(options, stats);
+   timer.begin(GenerationPhase::Setup);
+   phi.resize(ni, nj, nk);
+   phi.assign((ni+nj+nk)*dx);
+   closest_tri.assign(ni, nj, nk, -1);
+   Array3i intersection_count(ni, nj, nk, 0);
+   unsigned int threads=resolve_thread_count(options.num_threads);
+   ThreadPool &pool=ThreadPool::global();
+   std::atomic<long long> evaluations(0);
+   std::atomic<long long> *tally=stats ? &evaluations : 0;
+   timer.begin(GenerationPhase::NearBand);
+   near_band_pass(tri, x, 0, origin, dx, phi, closest_tri, intersection_count, options.exact_band, true, pool,
+                  threads, tally);
+   if(generation_cancelled(options)) return;
+   timer.begin(GenerationPhase::Sweep);
+   seed_from_coarse(tri, x, origin, dx, phi, closest_tri, coarse, pool, threads, tally);
+   // one pass of the 8 directions lets the fine near band correct the seeded values
+   if(!fast_sweep(tri, x, origin, dx, phi, closest_tri, 0, options, pool, threads, tally, 1)) return;
+   if(stats){
+      stats->distance_evaluations=evaluations.load();
+      stats->host_bytes=phi.a.size()*(sizeof(float)+2*sizeof(int))+coarse.a.size()*sizeof(int);
+      stats->sweep_iterations=8;
+   }
+   timer.begin(GenerationPhase::Sign);
+   sign_pass(tri, x, origin, dx, phi, intersection_count, options, pool, threads, stats);
+}
+
+void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                     const Vec3f &origin, float dx, int ni, int nj, int nk,
+                     Array3f &phi, const GenerationOptions &options, GenerationStats *stats)
+{
+   Array3i closest_tri, intersection_count;
+   generate_dense(tri, x, origin, dx, ni, nj, nk, phi, closest_tri, intersection_count, options, stats, false);
+}
+
+void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                     const Vec3f &origin, float dx, int ni, int nj, int nk,
+                     LevelSetState &state, const GenerationOptions &options, GenerationStats *stats)
+{
+   generate_dense(tri, x, origin, dx, ni, nj, nk, state.phi, state.closest_tri, state.intersection_count, options,
+                  stats, true);
+   state.tri=tri;
+   state.x=x;
+   state.origin=origin;
+   state.dx=dx;
+   state.exact_band=options.exact_band;
+   state.sign_mode=options.sign_mode;
+}
+
+void region_triangles(const TriangleBVH &index, const std::vector<Vec3ui> &tri, const Vec3f &origin, float dx, int ni, int nj, int nk, const GenerationOptions &options,
+                      std::vector<Vec3ui> &region)
+{
+   region.clear();
+   if(options.sign_mode == SignMode::WindingNumber || options.distance_mode == DistanceMode::Exact){
+      region=tri; // every triangle can reach every node
+      return;
+   }
+   // band reach plus the cell the band box rounds out to, and one more for float slack
+   const float margin=(options.exact_band+2)*dx;
+   const float open=std::numeric_limits<float>::infinity();
+   Vec3f lo(origin[0]-margin, origin[1]-margin, origin[2]-margin);
+   Vec3f hi(origin[0]+(ni-1)*dx+margin, origin[1]+(nj-1)*dx+margin, origin[2]+(nk-1)*dx+margin);
+   // crossings below the grid along the sign rays still count
+   lo[0]=-open;
+   if(options.sign_mode == SignMode::RayVote) lo[1]=lo[2]=-open;
+   std::vector<unsigned int> kept;
+   index.overlapping(lo, hi, kept);
+   std::sort(kept.begin(), kept.end());
+   region.reserve(kept.size());
+   for(size_t n=0; n<kept.size(); ++n) region.push_back(tri[kept[n]]);
+}
+
+void make_level_set_pyramid3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                             const Vec3f &origin, float dx, int ni, int nj, int nk, int levels,
+                             std::vector<Array3f> &pyramid, const GenerationOptions &options, GenerationStats *stats)
+{
+   int count=1;
+   while(count<levels && ((ni-1)>>count)>=1 && ((nj-1)>>count)>=1 && ((nk-1)>>count)>=1) ++count;
+   pyramid.assign(count, Array3f());
+   if(stats) *stats=GenerationStats();
+
+   const bool exact=(options.distance_mode == DistanceMode::Exact);
+   Array3i nearest[2], intersection_count; // nearest triangles of this level and the one above, alternating
+   size_t held=0; // coarser levels already finished
+   for(int s=count-1; s>=0; --s){
+      const float h=dx*(float)(1<<s);
+      const int li=((ni-1)>>s)+1, lj=((nj-1)>>s)+1, lk=((nk-1)>>s)+1;
+      GenerationStats level;
+      GenerationStats *level_stats=stats ? &level : 0;
+      Array3i &closest_tri=nearest[s&1], &coarse=nearest[(s+1)&1];
+      if(s==count-1 || exact){
+         generate_dense(tri, x, origin, h, li, lj, lk, pyramid[s], closest_tri, intersection_count, options,
+                        level_stats, s>0 && !exact);
+         intersection_count.clear();
+      }else{
+         generate_seeded(tri, x, origin, h, li, lj, lk, pyramid[s], closest_tri, coarse, options, level_stats);
+      }
+      if(generation_cancelled(options)) return;
+      coarse.clear();
+      if(stats){
+         stats->setup_ms+=level.setup_ms;
+         stats->near_band_ms+=level.near_band_ms;
+         stats->sweep_ms+=level.sweep_ms;
+         stats->sign_ms+=level.sign_ms;
+         stats->distance_evaluations+=level.distance_evaluations;
+         stats->winding_evaluations+=level.winding_evaluations;
+         stats->host_bytes=std::max(stats->host_bytes, held+level.host_bytes);
+         stats->sweep_iterations=level.sweep_iterations;
+      }
+      held+=pyramid[s].a.size()*sizeof(float);
+   }
+}
+
+void update_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                       const std::vector<unsigned int> &changed, LevelSetState &state,
+                       const GenerationOptions &options, GenerationStats *stats)
+{
+   Array3f &phi=state.phi;
+   Array3i &closest_tri=state.closest_tri;
+   Array3i &intersection_count=state.intersection_count;
+   const int ni=phi.ni, nj=phi.nj, nk=phi.nk;
+   const Vec3f origin=state.origin;
+   const float dx=state.dx;
+   const int exact_band=state.exact_band;
+   const float far=(ni+nj+nk)*dx; // same upper bound as a fresh generation
+   const unsigned int old_count=(unsigned int)state.tri.size(), new_count=(unsigned int)tri.size();
+   long long written=0;
+
+   std::vector<unsigned int> edited(changed);
+   std::sort(edited.begin(), edited.end());
+   edited.erase(std::unique(edited.begin(), edited.end()), edited.end());
+   // a value measured to an edited or removed triangle has to be recomputed
+   auto stale=[&](int t){
+      return t>=(int)new_count || (t>=0 && std::binary_search(edited.begin(), edited.end(), (unsigned int)t));
+   };
+
+   // crossing counts: take out the old geometry's crossings and add the new geometry's
+   std::vector<int> rows; // j+nj*k of every row whose counts changed
+   for(size_t n=0; n<edited.size(); ++n){
+      unsigned int t=edited[n];
+      if(t<old_count)
+         for_each_crossing(state.tri, state.x, t, origin, dx, ni, nj, nk, 0, nk-1,
+                           [&](int i, int j, int k){ --intersection_count(i,j,k); rows.push_back(j+nj*k); });
+      if(t<new_count)
+         for_each_crossing(tri, x, t, origin, dx, ni, nj, nk, 0, nk-1,
+                           [&](int i, int j, int k){ ++intersection_count(i,j,k); rows.push_back(j+nj*k); });
+   }
+
+   // invalidate the nodes measured to edited triangles: seeded from their old near bands and
+   // flooded through neighbours, since propagated values stay connected to the band they came from
+   std::vector<Vec3i> invalid;
+   auto invalidate=[&](int i, int j, int k){
+      float &v=phi(i,j,k);
+      v=(v<0) ? -far : far;
+      closest_tri(i,j,k)=-1;
+      invalid.push_back(Vec3i(i,j,k));
+      ++written;
+   };
+   Vec3i lo, hi;
+   for(size_t n=0; n<edited.size() && edited[n]<old_count; ++n){
+      triangle_band_box(state.tri, state.x, edited[n], origin, dx, ni, nj, nk, exact_band, lo, hi);
+      for(int k=lo[2]; k<=hi[2]; ++k) for(int j=lo[1]; j<=hi[1]; ++j) for(int i=lo[0]; i<=hi[0]; ++i)
+         if(stale(closest_tri(i,j,k))) invalidate(i,j,k);
+   }
+   for(size_t n=0; n<invalid.size(); ++n){
+      Vec3i c=invalid[n];
+      for(int k=max(0, c[2]-1); k<=min(nk-1, c[2]+1); ++k)
+         for(int j=max(0, c[1]-1); j<=min(nj-1, c[1]+1); ++j)
+            for(int i=max(0, c[0]-1); i<=min(ni-1, c[0]+1); ++i)
+               if(stale(closest_tri(i,j,k))) invalidate(i,j,k);
+   }
+
+   // exact near-band distances of the new geometry (same kernel as the full near-band pass);
+   // every node they lower, and every valid node bordering the invalidated region, starts the front
+   std::vector<Vec3i> front;
+   for(size_t n=0; n<edited.size() && edited[n]<new_count; ++n){
+      unsigned int t=edited[n];
+      unsigned int p, q, r; assign(tri[t], p, q, r);
+      triangle_band_box(tri, x, t, origin, dx, ni, nj, nk, exact_band, lo, hi);
+      int count=hi[0]-lo[0]+1;
+      DistanceScratch &s=distance_scratch();
+      s.px.resize(count);
+      s.dist.resize(count);
+      for(int m=0; m<count; ++m) s.px[m]=(lo[0]+m)*dx+origin[0];
+      for(int k=lo[2]; k<=hi[2]; ++k) for(int j=lo[1]; j<=hi[1]; ++j){
+         point_triangle_distances(x[p], x[q], x[r], &s.px[0], j*dx+origin[1], k*dx+origin[2], count, &s.dist[0]);
+         for(int m=0; m<count; ++m){
+            if(lower_distance(phi, closest_tri, lo[0]+m, j, k, s.dist[m], (int)t)){
+               front.push_back(Vec3i(lo[0]+m, j, k));
+               ++written;
+            }
          }
       }
    }
+   for(size_t n=0; n<invalid.size(); ++n){
+      Vec3i c=invalid[n];
+      for(int k=max(0, c[2]-1); k<=min(nk-1, c[2]+1); ++k)
+         for(int j=max(0, c[1]-1); j<=min(nj-1, c[1]+1); ++j)
+            for(int i=max(0, c[0]-1); i<=min(ni-1, c[0]+1); ++i)
+               if(closest_tri(i,j,k)>=0) front.push_back(Vec3i(i,j,k));
+   }
 
-   // then figure out signs (inside/outside) from intersection counts
-   for(int k=0; k<nk; ++k) for(int j=0; j<nj; ++j){
-      int total_count=0;
-      for(int i=0; i<ni; ++i){
-         total_count+=intersection_count(i,j,k);
-         if(total_count%2==1){ // if parity of intersections so far is odd,
-            phi(i,j,k)=-phi(i,j,k); // we are inside the mesh
+   // re-propagation: offer each front node's triangle to its 26 neighbours, the candidates the
+   // directional sweeps check, until nothing improves. Work is proportional to the nodes whose
+   // value changes rather than to the grid.
+   for(size_t n=0; n<front.size(); ++n){
+      if((n&0xffff)==0 && generation_cancelled(options)) return;
+      Vec3i c=front[n];
+      int t=closest_tri(c[0],c[1],c[2]);
+      if(t<0 || t>=(int)new_count) continue;
+      unsigned int p, q, r; assign(tri[t], p, q, r);
+      for(int k=max(0, c[2]-1); k<=min(nk-1, c[2]+1); ++k)
+         for(int j=max(0, c[1]-1); j<=min(nj-1, c[1]+1); ++j)
+            for(int i=max(0, c[0]-1); i<=min(ni-1, c[0]+1); ++i){
+               if(closest_tri(i,j,k)==t) continue;
+               Vec3f gx(i*dx+origin[0], j*dx+origin[1], k*dx+origin[2]);
+               if(lower_distance(phi, closest_tri, i, j, k, point_triangle_distance(gx, x[p], x[q], x[r]), t)){
+                  front.push_back(Vec3i(i,j,k));
+                  ++written;
+               }
+            }
+   }
+
+   // signs of the rows whose crossings changed; every other node kept its sign above
+   std::sort(rows.begin(), rows.end());
+   rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+   for(size_t n=0; n<rows.size(); ++n)
+      sdfgen::cpu::parity_signs(&intersection_count.a[(size_t)rows[n]*ni], &phi.a[(size_t)rows[n]*ni], ni);
+
+   state.tri=tri;
+   state.x=x;
+   if(stats) stats->cells_updated=written;
+}
+
+void make_sparse_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                            const Vec3f &origin, float dx, int ni, int nj, int nk,
+                            SparseLevelSet &phi, const GenerationOptions &options, GenerationStats *stats)
+{
+   const int B=SparseLevelSet::brick_size;
+   const int band=max(1, options.exact_band);
+   phi.reset(ni, nj, nk, origin, dx, band*dx);
+   unsigned int threads=resolve_thread_count(options.num_threads);
+   ThreadPool &pool=ThreadPool::global();
+   unsigned int num_tri=(unsigned int)tri.size();
+
+   // ray crossings per (j,k) row, sorted along each row
+   std::vector<RowCrossing> crossings;
+   gather_chunks(num_tri, pool, threads, crossings, [&](unsigned int t, std::vector<RowCrossing> &out){
+      for_each_crossing(tri, x, t, origin, dx, ni, nj, nk, 0, nk-1, [&](int i, int j, int k){
+         RowCrossing c={(unsigned long long)j+(unsigned long long)nj*k, i};
+         out.push_back(c);
+      });
+   });
+   std::sort(crossings.begin(), crossings.end());
+   if(generation_cancelled(options)) return;
+
+   // tiles within the band of each triangle, plus the tiles holding crossings so that every
+   // inactive tile has a uniform sign
+   std::vector<TileTriangle> bins;
+   gather_chunks(num_tri, pool, threads, bins, [&](unsigned int t, std::vector<TileTriangle> &out){
+      bin_triangle_tiles(tri, x, t, origin, dx, band, phi, out);
+   });
+   for(size_t n=0; n<crossings.size(); ++n){
+      int j=(int)(crossings[n].row%nj), k=(int)(crossings[n].row/nj);
+      TileTriangle e={phi.tile_index(crossings[n].i/B, j/B, k/B), -1};
+      bins.push_back(e);
+   }
+   std::sort(bins.begin(), bins.end());
+
+   // activate one brick per distinct tile; brick n owns bins [bin_start[n], bin_start[n+1])
+   std::vector<size_t> bin_start;
+   for(size_t n=0; n<bins.size(); ++n){
+      if(n>0 && bins[n].tile==bins[n-1].tile) continue;
+      unsigned long long tile=bins[n].tile;
+      int ti=(int)(tile%phi.tiles_i()), tj=(int)((tile/phi.tiles_i())%phi.tiles_j()), tk=(int)(tile/((unsigned long long)phi.tiles_i()*phi.tiles_j()));
+      phi.add_brick(ti, tj, tk);
+      bin_start.push_back(n);
+   }
+   bin_start.push_back(bins.size());
+   if(generation_cancelled(options)) return;
+
+   // first crossing of row (j,k)
+   auto row_begin=[&](int j, int k){
+      RowCrossing key={(unsigned long long)j+(unsigned long long)nj*k, -1};
+      return std::lower_bound(crossings.begin(), crossings.end(), key);
+   };
+
+   // exact distances (clamped to the band) and signs inside the active bricks
+   pool.parallel_for((int)phi.brick_count(), threads, [&](int n){
+      const Vec3i &tile=phi.brick_coord(n);
+      float *values=phi.brick_data(n);
+      int i_begin=tile[0]*B, count=min(ni, i_begin+B)-i_begin;
+      int j1=min(nj, tile[1]*B+B), k1=min(nk, tile[2]*B+B);
+      float px[B], dist[B];
+      for(int m=0; m<count; ++m) px[m]=(i_begin+m)*dx+origin[0];
+      for(size_t b=bin_start[n]; b<bin_start[n+1]; ++b){
+         if(bins[b].t<0) continue;
+         unsigned int p, q, r; assign(tri[bins[b].t], p, q, r);
+         for(int k=tile[2]*B; k<k1; ++k) for(int j=tile[1]*B; j<j1; ++j){
+            point_triangle_distances(x[p], x[q], x[r], px, j*dx+origin[1], k*dx+origin[2], count, dist);
+            float *row=values+B*((j-tile[1]*B)+B*(k-tile[2]*B));
+            for(int m=0; m<count; ++m) if(dist[m]<row[m]) row[m]=dist[m];
+         }
+      }
+      for(int k=tile[2]*B; k<k1; ++k) for(int j=tile[1]*B; j<j1; ++j){
+         float *row=values+B*((j-tile[1]*B)+B*(k-tile[2]*B));
+         unsigned long long key=(unsigned long long)j+(unsigned long long)nj*k;
+         std::vector<RowCrossing>::const_iterator c=row_begin(j, k);
+         bool inside=false;
+         for(int m=0; m<count; ++m){
+            for(; c!=crossings.end() && c->row==key && c->i<=i_begin+m; ++c) inside=!inside;
+            if(inside) row[m]=-row[m];
+         }
+      }
+   });
+   if(generation_cancelled(options)) return;
+
+   // one sign per tile from its first node; tiles of one (tj,tk) share a row
+   pool.parallel_for(phi.tiles_j()*phi.tiles_k(), threads, [&](int tile_row){
+      int tj=tile_row%phi.tiles_j(), tk=tile_row/phi.tiles_j();
+      unsigned long long key=(unsigned long long)tj*B+(unsigned long long)nj*(tk*B);
+      std::vector<RowCrossing>::const_iterator c=row_begin(tj*B, tk*B);
+      bool inside=false;
+      for(int ti=0; ti<phi.tiles_i(); ++ti){
+         for(; c!=crossings.end() && c->row==key && c->i<=ti*B; ++c) inside=!inside;
+         phi.set_tile_inside(ti, tj, tk, inside);
+      }
+   });
+
+   if(stats){
+      stats->sweep_iterations=0;
+      if(options.diagnostics){
+         stats->near_band_cells=0;
+         for(size_t n=0; n<phi.brick_count(); ++n){
+            const Vec3i &tile=phi.brick_coord(n);
+            const float *values=phi.brick_data(n);
+            for(int k=tile[2]*B; k<min(nk, tile[2]*B+B); ++k) for(int j=tile[1]*B; j<min(nj, tile[1]*B+B); ++j)
+               for(int i=tile[0]*B; i<min(ni, tile[0]*B+B); ++i){
+                  float d=std::fabs(values[(i-tile[0]*B)+B*((j-tile[1]*B)+B*(k-tile[2]*B))]);
+                  if(d>=phi.background) continue;
+                  if(stats->near_band_cells==0 || d<stats->near_band_min) stats->near_band_min=d;
+                  if(stats->near_band_cells==0 || d>stats->near_band_max) stats->near_band_max=d;
+                  ++stats->near_band_cells;
+               }
+         }
+         stats->intersections=(long long)crossings.size();
+         stats->diagnostics_valid=true;
+      }
+   }
+}
+
+void make_compact_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                             const Vec3f &origin, float dx, int ni, int nj, int nk, CompactFormat format,
+                             CompactLevelSet &phi, const GenerationOptions &options, GenerationStats *stats)
+{
+   const int band=max(1, options.exact_band);
+   PhaseTimer timer(options, stats);
+   timer.begin(GenerationPhase::Setup);
+   phi.reset(ni, nj, nk, origin, dx, band*dx, format);
+   // crossing parity, one bit per node packed 8 to a byte along each (j,k) row
+   const size_t row_bytes=(size_t)(ni+7)/8;
+   std::vector<unsigned char> parity(row_bytes*nj*nk, 0);
+   unsigned int threads=resolve_thread_count(options.num_threads);
+   ThreadPool &pool=ThreadPool::global();
+   std::atomic<long long> evaluations(0);
+   std::atomic<long long> *tally=stats ? &evaluations : 0;
+   timer.begin(GenerationPhase::NearBand);
+
+   // the near band over the whole band is exact below band*dx, so no sweeps (and no closest_tri);
+   // encoding is monotone, so keeping the smallest raw word keeps the smallest distance
+   uint16_t *words=&phi.words()[0];
+   for_each_band_tile(tri, x, origin, dx, nk, band, pool, threads, tally, [&](unsigned int t, int kmin, int kmax){
+      rasterize_triangle_band(tri, x, t, origin, dx, band, ni, nj, nk, kmin, kmax, true,
+         [&](int i0, int j, int k, const float *dist, int count){
+            uint16_t *row=words+(size_t)i0+(size_t)ni*((size_t)j+(size_t)nj*k);
+            for(int n=0; n<count; ++n){
+               uint16_t w=phi.encode(dist[n]);
+               if(w<row[n]) row[n]=w;
+            }
+         },
+         [&](int i, int j, int k){ parity[row_bytes*((size_t)j+(size_t)nj*k)+i/8]^=(unsigned char)(1u<<(i%8)); });
+   });
+   if(generation_cancelled(options)) return;
+   timer.begin(GenerationPhase::Sign);
+
+   // signs from the running parity along each row
+   pool.parallel_for(nk, threads, [&](int k){
+      for(int j=0; j<nj; ++j){
+         const unsigned char *bits=&parity[row_bytes*((size_t)j+(size_t)nj*k)];
+         uint16_t *row=words+(size_t)ni*((size_t)j+(size_t)nj*k);
+         unsigned int inside=0;
+         for(int i=0; i<ni; ++i){
+            inside^=(bits[i/8]>>(i%8))&1u;
+            if(inside) row[i]=phi.negate(row[i]);
+         }
+      }
+   });
+
+   if(stats){
+      stats->sweep_iterations=0;
+      stats->distance_evaluations=evaluations.load();
+      stats->host_bytes=phi.memory_bytes()+parity.size();
+   }
+}
+
+void make_octree_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                            const Vec3f &origin, float dx, int ni, int nj, int nk,
+                            OctreeLevelSet &tree, const GenerationOptions &options, GenerationStats *stats)
+{
+   const int band=max(1, options.exact_band);
+   tree.origin=origin;
+   tree.dx=dx;
+   tree.ni=ni; tree.nj=nj; tree.nk=nk;
+   tree.levels=0;
+   while((1<<tree.levels)<max(ni, nj, nk)-1) ++tree.levels;
+   OctreeNode root;
+   root.child=-1;
+   for(int c=0; c<8; ++c) root.value[c]=0;
+   tree.nodes.assign(1, root);
+   if(stats) stats->sweep_iterations=0;
+
+   unsigned int threads=resolve_thread_count(options.num_threads);
+   ThreadPool &pool=ThreadPool::global();
+   TriangleBVH bvh(tri, x);
+   const std::vector<Vec3f> &corners=bvh.corners();
+   std::vector<int> slot(bvh.triangle_order().size());
+   for(size_t n=0; n<slot.size(); ++n) slot[bvh.triangle_order()[n]]=(int)n;
+   const float far=(ni+nj+nk)*dx; // same upper bound as the dense grid
+
+   // a cell at lattice position (i,j,k), in units of finest cells
+   struct Cell { int node, i, j, k; };
+   auto key_of=[](int i, int j, int k){
+      return (unsigned long long)i | ((unsigned long long)j<<21) | ((unsigned long long)k<<42);
+   };
+   std::vector<Cell> level(1, Cell{0, 0, 0, 0});
+
+   for(int d=0; ; ++d){
+      int h=1<<(tree.levels-d);
+
+      // signed distance once per distinct corner of this level, in lattice order
+      std::vector<unsigned long long> keys;
+      keys.reserve(8*level.size());
+      for(size_t n=0; n<level.size(); ++n)
+         for(int c=0; c<8; ++c)
+            keys.push_back(key_of(level[n].i+(c&1)*h, level[n].j+((c>>1)&1)*h, level[n].k+((c>>2)&1)*h));
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+      std::vector<float> values(keys.size());
+      const size_t chunk=256;
+      pool.parallel_for((int)((keys.size()+chunk-1)/chunk), threads, [&](int c){
+         size_t end=std::min(keys.size(), (c+1)*chunk);
+         int prev=-1; // seed each query with the previous corner's triangle
+         for(size_t n=c*chunk; n<end; ++n){
+            int i=(int)(keys[n]&0x1fffff), j=(int)((keys[n]>>21)&0x1fffff), k=(int)(keys[n]>>42);
+            Vec3f gx(i*dx+origin[0], j*dx+origin[1], k*dx+origin[2]);
+            float best=far;
+            int best_tri=-1;
+            if(prev>=0){
+               int m=slot[prev];
+               float dist=point_triangle_distance(gx, corners[3*m], corners[3*m+1], corners[3*m+2]);
+               if(dist<best){ best=dist; best_tri=prev; }
+            }
+            bvh.nearest(gx, best, best_tri);
+            prev=best_tri;
+            values[n]=(bvh.crossings_below(gx)%2==1) ? -best : best;
+         }
+      });
+      pool.parallel_for((int)level.size(), threads, [&](int n){
+         const Cell &cell=level[n];
+         for(int c=0; c<8; ++c){
+            unsigned long long key=key_of(cell.i+(c&1)*h, cell.j+((c>>1)&1)*h, cell.k+((c>>2)&1)*h);
+            tree.nodes[cell.node].value[c]=values[std::lower_bound(keys.begin(), keys.end(), key)-keys.begin()];
          }
+      });
+      if(d==tree.levels || generation_cancelled(options)) break;
+
+      // refine cells inside the grid that the band can reach: distance is 1-Lipschitz, so a
+      // point of the cell within band*dx of the surface puts its nearest corner within
+      // band*dx plus half the cell diagonal
+      float reach=(0.5f*std::sqrt(3.f)*h+band)*dx;
+      std::vector<Cell> next;
+      for(size_t n=0; n<level.size(); ++n){
+         const Cell cell=level[n];
+         if(cell.i>ni-1 || cell.j>nj-1 || cell.k>nk-1) continue;
+         float nearest=std::fabs(tree.nodes[cell.node].value[0]);
+         for(int c=1; c<8; ++c) nearest=std::min(nearest, std::fabs(tree.nodes[cell.node].value[c]));
+         if(nearest>reach) continue;
+         int first=(int)tree.nodes.size();
+         tree.nodes[cell.node].child=first;
+         tree.nodes.resize(first+8, root);
+         int half=h/2;
+         for(int c=0; c<8; ++c)
+            next.push_back(Cell{first+c, cell.i+(c&1)*half, cell.j+((c>>1)&1)*half, cell.k+((c>>2)&1)*half});
       }
+      if(next.empty()) break;
+      level.swap(next);
+   }
+}
+
+void query_points(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x, const TriangleBVH &bvh,
+                  const WindingNumberTree *winding, const Vec3f *points, size_t count, float *distance,
+                  int *closest_tri, Vec3f *barycentric, const GenerationOptions &options, GenerationStats *stats)
+{
+   assert(options.sign_mode != SignMode::WindingNumber || winding);
+   unsigned int threads=resolve_thread_count(options.num_threads);
+   ThreadPool &pool=ThreadPool::global();
+   std::atomic<long long> evaluations(0);
+   const size_t chunk=256;
+   pool.parallel_for((int)((count+chunk-1)/chunk), threads, [&](int c){
+      if(generation_cancelled(options)) return;
+      size_t end=std::min(count, (c+1)*chunk);
+      long long chunk_evaluations=0;
+      int prev=-1; // seed each query with the previous point's triangle
+      for(size_t n=c*chunk; n<end; ++n){
+         const Vec3f &p=points[n];
+         float best=std::numeric_limits<float>::infinity();
+         int best_tri=-1;
+         if(prev>=0){
+            best=point_triangle_distance(p, x[tri[prev][0]], x[tri[prev][1]], x[tri[prev][2]]);
+            best_tri=prev;
+            ++chunk_evaluations;
+         }
+         chunk_evaluations+=bvh.nearest(p, best, best_tri);
+         prev=best_tri;
+
+         bool inside;
+         if(options.sign_mode == SignMode::WindingNumber){
+            inside=winding->winding_number(p)>=0.5f;
+         }else if(options.sign_mode == SignMode::RayVote){
+            inside=(bvh.crossings_below(p, 0)%2)+(bvh.crossings_below(p, 1)%2)+(bvh.crossings_below(p, 2)%2)>=2;
+         }else{
+            inside=bvh.crossings_below(p)%2==1;
+         }
+         distance[n]=inside ? -best : best;
+         if(closest_tri) closest_tri[n]=best_tri;
+         if(barycentric){
+            Vec3f w(0, 0, 0);
+            if(best_tri>=0) point_triangle_distance(p, x[tri[best_tri][0]], x[tri[best_tri][1]], x[tri[best_tri][2]], w);
+            barycentric[n]=w;
+         }
+      }
+      evaluations+=chunk_evaluations;
+   });
+
+   if(stats){
+      stats->distance_evaluations=evaluations.load();
+      stats->winding_evaluations=options.sign_mode == SignMode::WindingNumber ? (long long)count : 0;
+      stats->host_bytes=bvh.memory_bytes();
+      if(options.sign_mode == SignMode::WindingNumber)
+         stats->host_bytes+=winding->nodes().capacity()*sizeof(WindingNode)+winding->corners().capacity()*sizeof(Vec3f);
    }
 }
 
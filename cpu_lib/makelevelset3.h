@@ -6,8 +6,19 @@
 
 #include "array3.h"
 #include "vec.h"
+#include "sdfgen_options.h"
+#include "compact_level_set.h"
+#include "level_set_state.h"
+#include "octree_level_set.h"
+#include "sparse_level_set.h"
+#include "triangle_bvh.h"
+#include <cstddef>
+#include <vector>
 
 namespace sdfgen {
+
+class WindingNumberTree;
+
 namespace cpu {
 
 /**
@@ -35,10 +46,254 @@ namespace cpu {
  * @note Distances within exact_band cells of triangles are computed exactly
  * @note Distances beyond exact_band may not be to the closest triangle but to a nearby one
  * @note Thread count is automatically determined if num_threads=0, using std::thread::hardware_concurrency()
+ * @note The near-band phase is split into k-slab tiles with one owner thread each and is
+ *       bit-identical to the single-threaded result for any num_threads
  */
 void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
                      const Vec3f &origin, float dx, int nx, int ny, int nz,
                      Array3f &phi, const int exact_band=1, int num_threads=0);
 
+/**
+ * @brief Generate signed distance field on the CPU using a GenerationOptions struct
+ *
+ * Uses options.exact_band, options.num_threads and options.sweep_mode; the backend field is
+ * ignored. With SweepMode::Wavefront (the default) each directional sweep processes blocks
+ * of (j,k) rows along anti-diagonals, which reproduces the sequential Gauss-Seidel update
+ * order exactly, so the result is deterministic and independent of num_threads.
+ * With DistanceMode::Exact the sweeps are replaced by a BVH nearest-triangle query per cell,
+ * giving exact distances in every cell (identical to an exact_band covering the whole grid).
+ * With SignMode::WindingNumber the signs come from the fast generalized winding number
+ * (WindingNumberTree) instead of the ray parity, evaluated at the nodes next to the surface
+ * and at the ends of the far-field runs between them; distances are unchanged.
+ * SignMode::RayVote adds +y and +z ray parities and takes the majority of the three per node.
+ *
+ * @param tri Triangle indices defining mesh topology, each Vec3ui contains 3 vertex indices
+ * @param x Vertex positions in world coordinates
+ * @param origin Grid origin point (lower corner) in world space
+ * @param dx Grid cell spacing, uniform in all dimensions
+ * @param nx Number of grid cells in X dimension
+ * @param ny Number of grid cells in Y dimension
+ * @param nz Number of grid cells in Z dimension
+ * @param phi Output signed distance field array (will be resized to nx*ny*nz)
+ * @param options Generation options (exact band, threads, sweep mode, distance mode)
+ * @param stats Optional output; the diagnostics block is filled when options.diagnostics is set
+ */
+void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                     const Vec3f &origin, float dx, int nx, int ny, int nz,
+                     Array3f &phi, const GenerationOptions &options, GenerationStats *stats=0);
+
+/**
+ * @brief Generate a signed distance field and keep the data update_level_set3() needs
+ *
+ * Same field as the options overload, written to state.phi. The nearest-triangle and
+ * crossing-count arrays the generation builds anyway are kept in the state instead of being
+ * freed, together with a copy of the mesh and the grid geometry.
+ *
+ * @param state Output field and retained generation data (replaced)
+ */
+void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                     const Vec3f &origin, float dx, int nx, int ny, int nz,
+                     LevelSetState &state, const GenerationOptions &options, GenerationStats *stats=0);
+
+/**
+ * @brief Update a retained field after some triangles of its mesh changed
+ *
+ * Triangles are identified by index: changed lists every index whose vertices moved or whose
+ * connectivity changed, indices at or past the new triangle count are removals and indices at
+ * or past the old count are additions (to delete from the middle, move the last triangle into
+ * the hole and list both indices). Nodes measured to a changed triangle are invalidated, the
+ * new geometry's near band is rasterized, a front re-propagates distances from the valid
+ * nodes around the edit until nothing improves, and signs are recounted only on the (j,k)
+ * rows whose crossings changed. The cost follows the number of nodes whose value changes, not
+ * the grid size.
+ *
+ * Near-band nodes of the edited triangles and every sign match a full regeneration; nodes
+ * farther out are propagated like the sweeps but in a different order, so they can differ
+ * from a full regeneration by the usual far-field approximation. Uses the exact band and grid
+ * geometry stored in the state; options is only polled for cancellation, after which the
+ * state is unspecified.
+ *
+ * @param tri New triangle indices
+ * @param x New vertex positions; triangles not listed in changed must keep their old corners
+ * @param changed Indices of changed, removed and added triangles
+ * @param state Field and retained data from make_level_set3() or a previous update
+ * @param options Cancellation flag
+ * @param stats Optional output; cells_updated receives the number of node writes
+ */
+void update_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                       const std::vector<unsigned int> &changed, LevelSetState &state,
+                       const GenerationOptions &options, GenerationStats *stats=0);
+
+/**
+ * @brief Triangles that can affect a grid, for generating a region of interest
+ *
+ * Keeps the triangles whose bounds come within (exact_band+2)*dx of the grid, which are the
+ * only ones whose near band reaches a node unclamped, plus those below the grid along the
+ * sign rays: the -x side for the parity sign, -x, -y and -z for SignMode::RayVote.
+ * Generating on the result gives the same crossing counts, so the same signs, and the same
+ * values wherever |phi| < exact_band*dx as generating on the whole mesh over the same grid.
+ * Farther nodes can differ: the near band of a distant triangle is clamped onto the grid's
+ * boundary nodes, which then seed the sweeps. With SignMode::WindingNumber or
+ * DistanceMode::Exact every triangle matters and the whole mesh is returned.
+ *
+ * @param index BVH over tri and its vertices
+ * @param tri Triangle indices of the whole mesh
+ * @param origin Grid origin of the region
+ * @param dx Grid cell spacing
+ * @param ni Nodes in X
+ * @param nj Nodes in Y
+ * @param nk Nodes in Z
+ * @param options Uses exact_band, sign_mode and distance_mode
+ * @param region Output triangles, in input order; vertex indices are unchanged
+ */
+void region_triangles(const TriangleBVH &index, const std::vector<Vec3ui> &tri, const Vec3f &origin, float dx,
+                      int ni, int nj, int nk, const GenerationOptions &options, std::vector<Vec3ui> &region);
+
+/**
+ * @brief Generate a coarse-to-fine pyramid of signed distance fields
+ *
+ * pyramid[s] has spacing dx*2^s, the same origin and ((n-1)>>s)+1 nodes per axis; levels is
+ * reduced until the coarsest level has at least 2 nodes per axis. The coarsest level is a
+ * regular make_level_set3(). Every finer level runs its own near band, then seeds each node
+ * outside it from the nearest triangles the coarser level found at the 2x2x2 coarse nodes
+ * around it and corrects the seeds with one pass of the 8 sweep directions instead of two.
+ * Near-band nodes equal make_level_set3() at that spacing; the far field is the usual
+ * nearest-triangle approximation, so it can differ slightly from a full generation. Signs
+ * come from each level's own sign pass (options.sign_mode). With DistanceMode::Exact every
+ * level is a regular generation. The layout option only applies to the coarsest level.
+ *
+ * @param tri Triangle indices defining mesh topology, each Vec3ui contains 3 vertex indices
+ * @param x Vertex positions in world coordinates
+ * @param origin Grid origin point (lower corner) in world space
+ * @param dx Spacing of the finest level
+ * @param nx Nodes in X of the finest level
+ * @param ny Nodes in Y of the finest level
+ * @param nz Nodes in Z of the finest level
+ * @param levels Number of levels requested, at least 1
+ * @param pyramid Output fields, finest first (replaced)
+ * @param options Generation options as for make_level_set3()
+ * @param stats Optional output: phase times and distance_evaluations summed over the levels,
+ *              host_bytes the peak including the finished coarser levels
+ */
+void make_level_set_pyramid3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                             const Vec3f &origin, float dx, int nx, int ny, int nz, int levels,
+                             std::vector<Array3f> &pyramid, const GenerationOptions &options,
+                             GenerationStats *stats=0);
+
+/**
+ * @brief Generate a narrow-band signed distance field into 8^3 bricks (see SparseLevelSet)
+ *
+ * Never allocates per-node storage for the whole grid. Triangles are binned into the tiles
+ * their band can reach and the ray crossings used for the signs are kept as a sorted list per
+ * (j,k) row, so memory scales with the surface rather than the volume. Every active brick
+ * gets the minimum distance over its binned triangles, which is exact wherever the true
+ * distance is below band*dx; larger values are clamped to background = band*dx. Signs use
+ * the same crossing parity as the dense pass. Inactive tiles take the sign of their first
+ * node, which is exact for closed meshes because no surface passes through them.
+ *
+ * Nodes with |phi| < band*dx are bit-identical to make_level_set3() with the same
+ * exact_band; elsewhere the dense field clamped to +/-band*dx is reproduced for closed
+ * meshes. Sweep, distance-mode and GPU options are ignored.
+ *
+ * @param tri Triangle indices defining mesh topology, each Vec3ui contains 3 vertex indices
+ * @param x Vertex positions in world coordinates
+ * @param origin Grid origin point (lower corner) in world space
+ * @param dx Grid cell spacing, uniform in all dimensions
+ * @param nx Number of grid cells in X dimension
+ * @param ny Number of grid cells in Y dimension
+ * @param nz Number of grid cells in Z dimension
+ * @param phi Output narrow-band field (reset to the grid geometry)
+ * @param options Uses exact_band (the band half-width in cells, at least 1) and num_threads
+ * @param stats Optional output; the diagnostics block is filled when options.diagnostics is set
+ */
+void make_sparse_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                            const Vec3f &origin, float dx, int nx, int ny, int nz,
+                            SparseLevelSet &phi, const GenerationOptions &options, GenerationStats *stats=0);
+
+/**
+ * @brief Generate a dense signed distance field in 16 bits per node (see CompactLevelSet)
+ *
+ * Peak memory is the 2-byte output plus one crossing-parity bit per node, against 12 bytes
+ * per node for make_level_set3() (phi, closest_tri and intersection_count), so grids of
+ * about 1.7x the resolution fit in the same memory. The near band is run over the whole
+ * band, where it is exact, and writes encoded words directly: the nearest triangles and the
+ * sweeps are not needed because everything farther out is clamped. Signs use the same
+ * crossing parity as the dense pass, packed 8 nodes to a byte along each (j,k) row.
+ *
+ * Every node equals phi.encode() of make_level_set3() with the same exact_band and parity
+ * signs, i.e. the dense field clamped to +/-band*dx and rounded once. Sweep, sign-mode,
+ * distance-mode and GPU options are ignored.
+ *
+ * @param tri Triangle indices defining mesh topology, each Vec3ui contains 3 vertex indices
+ * @param x Vertex positions in world coordinates
+ * @param origin Grid origin point (lower corner) in world space
+ * @param dx Grid cell spacing, uniform in all dimensions
+ * @param nx Number of grid cells in X dimension
+ * @param ny Number of grid cells in Y dimension
+ * @param nz Number of grid cells in Z dimension
+ * @param format fp16 or normalized int16 words
+ * @param phi Output field (reset to the grid geometry)
+ * @param options Uses exact_band (the clamp band in cells, at least 1) and num_threads
+ * @param stats Optional output: phase times, distance_evaluations and host_bytes
+ */
+void make_compact_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                             const Vec3f &origin, float dx, int nx, int ny, int nz, CompactFormat format,
+                             CompactLevelSet &phi, const GenerationOptions &options, GenerationStats *stats=0);
+
+/**
+ * @brief Generate an adaptive signed distance field on an octree (see OctreeLevelSet)
+ *
+ * The root cube covers the grid with 2^levels cells of size dx. Level by level, every corner
+ * gets an exact distance from a BVH nearest-triangle query and its sign from the BVH
+ * crossing parity (the same rule as the grid sign pass). A cell is split while a point of it
+ * can lie within band*dx of the surface, so only the band reaches dx and the rest of the
+ * domain keeps coarse cells. Corners on the finest lattice equal make_level_set3() with
+ * DistanceMode::Exact at the same grid nodes; signs match it wherever the sign pass is not
+ * degenerate.
+ *
+ * @param tri Triangle indices defining mesh topology, each Vec3ui contains 3 vertex indices
+ * @param x Vertex positions in world coordinates
+ * @param origin Grid origin point (lower corner) in world space
+ * @param dx Finest cell spacing
+ * @param nx Number of grid cells in X dimension
+ * @param ny Number of grid cells in Y dimension
+ * @param nz Number of grid cells in Z dimension
+ * @param tree Output octree (replaced)
+ * @param options Uses exact_band (the refinement band in finest cells, at least 1) and num_threads
+ * @param stats Optional output
+ */
+void make_octree_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                            const Vec3f &origin, float dx, int nx, int ny, int nz,
+                            OctreeLevelSet &tree, const GenerationOptions &options, GenerationStats *stats=0);
+
+/**
+ * @brief Signed distance to a mesh at scattered points, without a grid
+ *
+ * Each point gets the exact nearest-triangle distance from a BVH query, seeded with the
+ * previous point's triangle so coherent batches prune most of the tree, and the sign of
+ * options.sign_mode: the +x crossing parity, the majority of the x, y and z parities, or the
+ * generalized winding number >= 0.5. A point on a grid node gets the distance
+ * make_level_set3() with DistanceMode::Exact gives that node bit for bit, and the same sign
+ * unless the node lies on the surface, where the grid's crossing bins and a crossing test at
+ * the point itself can round differently.
+ * Points are spread over the thread pool in chunks; the result does not depend on the thread
+ * count. With an empty mesh every distance is +infinity and every triangle -1.
+ *
+ * @param tri Triangle indices the BVH was built from
+ * @param x Vertex positions the BVH was built from
+ * @param bvh BVH over tri and x
+ * @param winding Winding-number tree of the same mesh; only read with SignMode::WindingNumber
+ * @param points Query points
+ * @param count Number of points
+ * @param distance Output signed distances, count entries (negative inside)
+ * @param closest_tri Optional output: nearest triangle per point (lowest index among ties), or null
+ * @param barycentric Optional output: weights of the nearest point on that triangle's corners, or null
+ * @param options Uses sign_mode, num_threads and cancel
+ * @param stats Optional output: distance_evaluations, winding_evaluations and host_bytes (the trees)
+ */
+void query_points(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x, const TriangleBVH &bvh,
+                  const WindingNumberTree *winding, const Vec3f *points, size_t count, float *distance,
+                  int *closest_tri, Vec3f *barycentric, const GenerationOptions &options, GenerationStats *stats=0);
+
 } // namespace cpu
 } // namespace sdfgen
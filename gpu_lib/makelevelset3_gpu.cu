@@ -3,12 +3,28 @@
 // Licensed under the MIT License - see LICENSE file
 
 #include "makelevelset3_gpu.h"
+#include "marching_cubes_gpu.h"
+#include "mesh_reorder.h"
+#include "triangle_table.h"
+#include "winding_number.h"
 #include <cuda_runtime.h>
 #include <iostream>
 #include <algorithm>
 #include <cmath>
 #include <cfloat>
+#include <climits>
 #include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+// NVTX 3 is header-only and ships with the CUDA toolkit from 10.0
+#if defined(__has_include)
+  #if __has_include(<nvtx3/nvToolsExt.h>)
+    #include <nvtx3/nvToolsExt.h>
+    #define SDFGEN_NVTX
+  #endif
+#endif
 
 // CUDA error checking macro
 #define CUDA_CHECK(err) { \
@@ -38,6 +54,16 @@ struct DistTriPair {
     int   tri_idx;   ///< Index of closest triangle (32 bits, -1 if none)
 };
 
+/**
+ * @brief Device accumulators for the optional near-band diagnostics
+ */
+struct NearBandStats {
+    unsigned long long cells;      ///< Cells with a near-band triangle
+    unsigned long long crossings;  ///< Sum of intersection counts
+    unsigned int min_bits;         ///< Bit pattern of the smallest near-band distance
+    unsigned int max_bits;         ///< Bit pattern of the largest near-band distance
+};
+
 // ============================================================================
 // Device Utility Functions
 // ============================================================================
@@ -239,11 +265,105 @@ __device__ float point_triangle_distance(const Vec3f& x0, const Vec3f& x1, const
     } else {
         // Clamp to edges
         if (w23 > 0.0f)
-            return fminf(point_segment_distance(x0, x1, x2), point_segment_distance(x0, x1, x3));
+            return fminf(gpu::point_segment_distance(x0, x1, x2), gpu::point_segment_distance(x0, x1, x3));
+        else if (w31 > 0.0f)
+            return fminf(gpu::point_segment_distance(x0, x1, x2), gpu::point_segment_distance(x0, x2, x3));
+        else
+            return fminf(gpu::point_segment_distance(x0, x1, x3), gpu::point_segment_distance(x0, x2, x3));
+    }
+}
+
+// TriangleGeometry fields uploaded per triangle (the record padding is dropped)
+#define GEOMETRY_FIELDS 29
+
+/**
+ * @brief point_segment_distance() with the segment direction and squared length given
+ * @param x0 Query point
+ * @param a Segment start point (3 floats)
+ * @param b Segment end point (3 floats)
+ * @param e Segment direction b-a (3 floats)
+ * @param m2f Squared length of e
+ * @return Minimum distance from x0 to segment [a, b]
+ */
+__device__ float point_segment_distance_table(const Vec3f& x0, const float* a, const float* b,
+                                              const float* e, float m2f) {
+    double m2 = m2f;
+
+    if (m2 < 1e-30) {
+        float d0 = x0.v[0] - a[0];
+        float d1 = x0.v[1] - a[1];
+        float d2 = x0.v[2] - a[2];
+        return sqrtf(d0*d0 + d1*d1 + d2*d2);
+    }
+
+    float temp0 = b[0] - x0.v[0];
+    float temp1 = b[1] - x0.v[1];
+    float temp2 = b[2] - x0.v[2];
+
+    float s12 = (float)((temp0*e[0] + temp1*e[1] + temp2*e[2]) / m2);
+    s12 = fmaxf(0.0f, fminf(1.0f, s12));
+
+    float r0 = s12 * a[0] + (1.0f - s12) * b[0];
+    float r1 = s12 * a[1] + (1.0f - s12) * b[1];
+    float r2 = s12 * a[2] + (1.0f - s12) * b[2];
+
+    float d0 = x0.v[0] - r0;
+    float d1 = x0.v[1] - r1;
+    float d2 = x0.v[2] - r2;
+    return sqrtf(d0*d0 + d1*d1 + d2*d2);
+}
+
+/**
+ * @brief point_triangle_distance() from precomputed TriangleGeometry fields
+ *
+ * Same operation sequence as point_triangle_distance() without the point-independent part.
+ *
+ * @param x0 Query point
+ * @param g GEOMETRY_FIELDS floats in TriangleGeometry order
+ * @return Minimum Euclidean distance from x0 to the triangle
+ */
+__device__ float point_triangle_distance_table(const Vec3f& x0, const float* g) {
+    const float* x1 = g;
+    const float* x2 = g + 3;
+    const float* x3 = g + 6;
+    const float* x13 = g + 9;
+    const float* x23 = g + 12;
+    const float* e12 = g + 15;
+    const float* e13 = g + 18;
+    const float* e23 = g + 21;
+    float m13 = g[24], m23 = g[25], m12 = g[26], d = g[27], invdet = g[28];
+
+    float x03_0 = x0.v[0] - x3[0];
+    float x03_1 = x0.v[1] - x3[1];
+    float x03_2 = x0.v[2] - x3[2];
+
+    float a = x13[0]*x03_0 + x13[1]*x03_1 + x13[2]*x03_2;
+    float b = x23[0]*x03_0 + x23[1]*x03_1 + x23[2]*x03_2;
+
+    float w23 = invdet * (m23 * a - d * b);
+    float w31 = invdet * (m13 * b - d * a);
+    float w12 = 1.0f - w23 - w31;
+
+    if (w23 >= 0.0f && w31 >= 0.0f && w12 >= 0.0f) {
+        float p0 = w23*x1[0] + w31*x2[0] + w12*x3[0];
+        float p1 = w23*x1[1] + w31*x2[1] + w12*x3[1];
+        float p2 = w23*x1[2] + w31*x2[2] + w12*x3[2];
+
+        float d0 = x0.v[0] - p0;
+        float d1 = x0.v[1] - p1;
+        float d2 = x0.v[2] - p2;
+        return sqrtf(d0*d0 + d1*d1 + d2*d2);
+    } else {
+        // mag2(x3-x1)==m13 and mag2(x3-x2)==m23 exactly
+        if (w23 > 0.0f)
+            return fminf(point_segment_distance_table(x0, x1, x2, e12, m12),
+                         point_segment_distance_table(x0, x1, x3, e13, m13));
         else if (w31 > 0.0f)
-            return fminf(point_segment_distance(x0, x1, x2), point_segment_distance(x0, x2, x3));
+            return fminf(point_segment_distance_table(x0, x1, x2, e12, m12),
+                         point_segment_distance_table(x0, x2, x3, e23, m23));
         else
-            return fminf(point_segment_distance(x0, x1, x3), point_segment_distance(x0, x2, x3));
+            return fminf(point_segment_distance_table(x0, x1, x3, e13, m13),
+                         point_segment_distance_table(x0, x2, x3, e23, m23));
     }
 }
 
@@ -349,6 +469,140 @@ __global__ void initialize_grids_kernel(DistTriPair* dist_tri, int* intersection
 // Kernel 2: Near-Band Distance with 64-bit Atomic Updates
 // ============================================================================
 
+/**
+ * @brief Cell range receiving exact distances from one triangle
+ *
+ * The triangle's grid-space bounding box expanded by exact_band cells and clamped to the
+ * grid. Shared by the per-triangle and binned near-band kernels so both cover the same cells.
+ *
+ * @param box Receives i0, i1, j0, j1, k0, k1 (inclusive)
+ */
+__device__ void near_band_box(const Vec3f& p, const Vec3f& q, const Vec3f& r,
+                              Vec3f origin, float dx, int ni, int nj, int nk, int exact_band,
+                              int box[6])
+{
+    double fip = ((double)p.v[0] - origin.v[0]) / dx;
+    double fjp = ((double)p.v[1] - origin.v[1]) / dx;
+    double fkp = ((double)p.v[2] - origin.v[2]) / dx;
+    double fiq = ((double)q.v[0] - origin.v[0]) / dx;
+    double fjq = ((double)q.v[1] - origin.v[1]) / dx;
+    double fkq = ((double)q.v[2] - origin.v[2]) / dx;
+    double fir = ((double)r.v[0] - origin.v[0]) / dx;
+    double fjr = ((double)r.v[1] - origin.v[1]) / dx;
+    double fkr = ((double)r.v[2] - origin.v[2]) / dx;
+
+    box[0] = clamp_int((int)(fmin3(fip, fiq, fir)) - exact_band, 0, ni - 1);
+    box[1] = clamp_int((int)(fmax3(fip, fiq, fir)) + exact_band + 1, 0, ni - 1);
+    box[2] = clamp_int((int)(fmin3(fjp, fjq, fjr)) - exact_band, 0, nj - 1);
+    box[3] = clamp_int((int)(fmax3(fjp, fjq, fjr)) + exact_band + 1, 0, nj - 1);
+    box[4] = clamp_int((int)(fmin3(fkp, fkq, fkr)) - exact_band, 0, nk - 1);
+    box[5] = clamp_int((int)(fmax3(fkp, fkq, fkr)) + exact_band + 1, 0, nk - 1);
+}
+
+/**
+ * @brief Accumulate the +X ray crossings of one triangle into intersection_count
+ *
+ * Only rows with k in [k_begin, k_begin + k_count) are counted; intersection_count holds
+ * those k_count planes (the whole grid for k_begin = 0, k_count = nk).
+ */
+__device__ void count_triangle_crossings(const Vec3f& p, const Vec3f& q, const Vec3f& r,
+                                         Vec3f origin, float dx, int ni, int nj, int nk,
+                                         int k_begin, int k_count, int* intersection_count)
+{
+    double fip = ((double)p.v[0] - origin.v[0]) / dx;
+    double fjp = ((double)p.v[1] - origin.v[1]) / dx;
+    double fkp = ((double)p.v[2] - origin.v[2]) / dx;
+    double fiq = ((double)q.v[0] - origin.v[0]) / dx;
+    double fjq = ((double)q.v[1] - origin.v[1]) / dx;
+    double fkq = ((double)q.v[2] - origin.v[2]) / dx;
+    double fir = ((double)r.v[0] - origin.v[0]) / dx;
+    double fjr = ((double)r.v[1] - origin.v[1]) / dx;
+    double fkr = ((double)r.v[2] - origin.v[2]) / dx;
+
+    int j0_int = clamp_int((int)ceil(fmin3(fjp, fjq, fjr)), 0, nj - 1);
+    int j1_int = clamp_int((int)floor(fmax3(fjp, fjq, fjr)), 0, nj - 1);
+    int k0_int = max(clamp_int((int)ceil(fmin3(fkp, fkq, fkr)), 0, nk - 1), k_begin);
+    int k1_int = min(clamp_int((int)floor(fmax3(fkp, fkq, fkr)), 0, nk - 1), k_begin + k_count - 1);
+
+    for (int k = k0_int; k <= k1_int; ++k) {
+        for (int j = j0_int; j <= j1_int; ++j) {
+            double a, b, c;
+
+            // Test at grid cell corner (j,k) to match CPU implementation
+            // This ensures consistent results across all mesh types and densities
+            if (point_in_triangle_2d(j, k, fjp, fkp, fjq, fkq, fjr, fkr, a, b, c)) {
+                double fi = a * fip + b * fiq + c * fir;
+                int i_interval = (int)ceil(fi);
+
+                // Replicate the CPU's logic for handling intersections
+                // that occur before the grid starts (i < 0).
+                if (i_interval < 0) {
+                    int idx = grid_index(0, j, k - k_begin, ni, nj); // Accumulate at the first cell
+                    atomicAdd(&intersection_count[idx], 1);
+                } else if (i_interval < ni) {
+                    int idx = grid_index(i_interval, j, k - k_begin, ni, nj);
+                    atomicAdd(&intersection_count[idx], 1);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Exact distances and ray crossings of one triangle (body of the near-band kernels)
+ *
+ * @param g Precomputed geometry of the triangle (GEOMETRY_FIELDS floats), or null for p, q, r
+ * @param t_idx Triangle index recorded with each distance
+ * @param counters Null, or {distances evaluated, lost compare-and-swaps} to add this triangle's to
+ */
+__device__ void near_band_triangle(const Vec3f& p, const Vec3f& q, const Vec3f& r, const float* g, int t_idx,
+                                   DistTriPair* dist_tri, int* intersection_count,
+                                   Vec3f origin, float dx, int ni, int nj, int nk, int exact_band,
+                                   int k_begin, int k_count, unsigned long long* counters)
+{
+    // Distance computation bounding box, limited to the planes held
+    int box[6];
+    near_band_box(p, q, r, origin, dx, ni, nj, nk, exact_band, box);
+    int k_lo = max(box[4], k_begin);
+    int k_hi = min(box[5], k_begin + k_count - 1);
+    unsigned long long retries = 0;
+
+    // Compute distances
+    for (int k = k_lo; k <= k_hi; ++k) {
+        for (int j = box[2]; j <= box[3]; ++j) {
+            for (int i = box[0]; i <= box[1]; ++i) {
+                // Create grid point without calling constructor
+                float gx_data[3] = {i * dx + origin.v[0], j * dx + origin.v[1], k * dx + origin.v[2]};
+                const Vec3f& gx = *reinterpret_cast<Vec3f*>(gx_data);
+
+                float d = g ? point_triangle_distance_table(gx, g) : gpu::point_triangle_distance(gx, p, q, r);
+                int idx = grid_index(i, j, k - k_begin, ni, nj);
+
+                // 64-bit atomic update
+                unsigned long long* addr = (unsigned long long*)&dist_tri[idx];
+                unsigned long long old_val = *addr;
+                DistTriPair old_dt = unpack_dist_tri(old_val);
+
+                while (d < old_dt.dist) {
+                    unsigned long long new_val = pack_dist_tri(d, t_idx);
+                    unsigned long long prev = atomicCAS(addr, old_val, new_val);
+                    if (prev == old_val) break;
+                    old_val = prev;
+                    old_dt = unpack_dist_tri(old_val);
+                    ++retries;
+                }
+            }
+        }
+    }
+    if (counters && k_lo <= k_hi && box[0] <= box[1] && box[2] <= box[3]) {
+        atomicAdd(&counters[0], (unsigned long long)(k_hi - k_lo + 1) * (box[3] - box[2] + 1) * (box[1] - box[0] + 1));
+        atomicAdd(&counters[1], retries);
+    }
+
+    // Intersection counting
+    count_triangle_crossings(p, q, r, origin, dx, ni, nj, nk, k_begin, k_count, intersection_count);
+}
+
 /**
  * @brief CUDA kernel for exact distance computation within narrow band around triangles
  *
@@ -357,10 +611,12 @@ __global__ void initialize_grids_kernel(DistTriPair* dist_tri, int* intersection
  * simultaneously. Also tracks ray-triangle intersections for sign determination.
  *
  * Each thread processes one triangle and updates all grid cells within its bounding box
- * expanded by exact_band cells.
+ * expanded by exact_band cells. Only planes k_begin..k_begin+k_count-1 are computed and the
+ * output arrays hold just those planes, which lets the streamed mode run one z-slab at a time.
  *
  * @param tri Triangle indices (num_triangles elements)
  * @param x Vertex positions
+ * @param geom Precomputed triangle geometry, GEOMETRY_FIELDS rows of num_triangles floats (or null)
  * @param dist_tri Distance-triangle pair array (updated atomically)
  * @param intersection_count Ray intersection count array (updated atomically)
  * @param num_triangles Number of triangles in mesh
@@ -370,11 +626,15 @@ __global__ void initialize_grids_kernel(DistTriPair* dist_tri, int* intersection
  * @param nj Grid dimension in Y
  * @param nk Grid dimension in Z
  * @param exact_band Distance band in cells for exact computation
+ * @param k_begin First plane held by dist_tri and intersection_count
+ * @param k_count Number of planes held (nk for the whole grid)
+ * @param counters Null, or {distances evaluated, lost compare-and-swaps} accumulated over all triangles
  */
 __global__ void near_band_distance_kernel(
-    const Vec3ui* tri, const Vec3f* x,
+    const Vec3ui* tri, const Vec3f* x, const float* geom,
     DistTriPair* dist_tri, int* intersection_count,
-    int num_triangles, Vec3f origin, float dx, int ni, int nj, int nk, int exact_band)
+    int num_triangles, Vec3f origin, float dx, int ni, int nj, int nk, int exact_band,
+    int k_begin, int k_count, unsigned long long* counters)
 {
     int t_idx = blockIdx.x * blockDim.x + threadIdx.x;
     if (t_idx >= num_triangles) return;
@@ -385,80 +645,159 @@ __global__ void near_band_distance_kernel(
     Vec3f q = x[pqr.v[1]];
     Vec3f r = x[pqr.v[2]];
 
-    // Compute grid coordinates
-    double fip = ((double)p.v[0] - origin.v[0]) / dx;
-    double fjp = ((double)p.v[1] - origin.v[1]) / dx;
-    double fkp = ((double)p.v[2] - origin.v[2]) / dx;
-    double fiq = ((double)q.v[0] - origin.v[0]) / dx;
-    double fjq = ((double)q.v[1] - origin.v[1]) / dx;
-    double fkq = ((double)q.v[2] - origin.v[2]) / dx;
-    double fir = ((double)r.v[0] - origin.v[0]) / dx;
-    double fjr = ((double)r.v[1] - origin.v[1]) / dx;
-    double fkr = ((double)r.v[2] - origin.v[2]) / dx;
+    // Structure-of-arrays rows: consecutive threads read consecutive addresses
+    float g[GEOMETRY_FIELDS];
+    if (geom) {
+        for (int c = 0; c < GEOMETRY_FIELDS; ++c) g[c] = geom[(size_t)c * num_triangles + t_idx];
+    }
 
-    // Distance computation bounding box
-    int i0 = clamp_int((int)(fmin3(fip, fiq, fir)) - exact_band, 0, ni - 1);
-    int i1 = clamp_int((int)(fmax3(fip, fiq, fir)) + exact_band + 1, 0, ni - 1);
-    int j0 = clamp_int((int)(fmin3(fjp, fjq, fjr)) - exact_band, 0, nj - 1);
-    int j1 = clamp_int((int)(fmax3(fjp, fjq, fjr)) + exact_band + 1, 0, nj - 1);
-    int k0 = clamp_int((int)(fmin3(fkp, fkq, fkr)) - exact_band, 0, nk - 1);
-    int k1 = clamp_int((int)(fmax3(fkp, fkq, fkr)) + exact_band + 1, 0, nk - 1);
+    near_band_triangle(p, q, r, geom ? g : nullptr, t_idx, dist_tri, intersection_count,
+                       origin, dx, ni, nj, nk, exact_band, k_begin, k_count, counters);
+}
 
-    // Compute distances
-    for (int k = k0; k <= k1; ++k) {
-        for (int j = j0; j <= j1; ++j) {
-            for (int i = i0; i <= i1; ++i) {
-                // Create grid point without calling constructor
-                float gx_data[3] = {i * dx + origin.v[0], j * dx + origin.v[1], k * dx + origin.v[2]};
-                const Vec3f& gx = *reinterpret_cast<Vec3f*>(gx_data);
+// ============================================================================
+// Kernel 2b: Brick-Binned Near-Band Distance
+// ============================================================================
 
-                float d = point_triangle_distance(gx, p, q, r);
-                int idx = grid_index(i, j, k, ni, nj);
+// Bricks are NEAR_BRICK^3 cells, one thread block (one thread per cell) per occupied brick
+#define NEAR_BRICK 8
+// Triangles staged in shared memory per round
+#define NEAR_CHUNK 128
 
-                // 64-bit atomic update
-                unsigned long long* addr = (unsigned long long*)&dist_tri[idx];
-                unsigned long long old_val = *addr;
-                DistTriPair old_dt = unpack_dist_tri(old_val);
+/**
+ * @brief Count, or with brick_offsets given, list the triangles touching each brick
+ *
+ * Run twice: first with brick_offsets null to count, then with the host-side exclusive scan
+ * of the counts to scatter triangle indices. List order within a brick is scheduling
+ * dependent; the brick kernel breaks distance ties by triangle index so it does not matter.
+ *
+ * @param brick_counts Per-brick counters (counts in the first pass, cursors in the second)
+ * @param brick_offsets Start of each brick's list in brick_tris (null in the counting pass)
+ * @param brick_tris Concatenated per-brick triangle lists (second pass only)
+ */
+__global__ void bin_triangles_kernel(
+    const Vec3ui* tri, const Vec3f* x, int num_triangles,
+    Vec3f origin, float dx, int ni, int nj, int nk, int exact_band,
+    int bricks_x, int bricks_y,
+    int* brick_counts, const int* brick_offsets, int* brick_tris)
+{
+    int t_idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (t_idx >= num_triangles) return;
 
-                while (d < old_dt.dist) {
-                    unsigned long long new_val = pack_dist_tri(d, t_idx);
-                    unsigned long long prev = atomicCAS(addr, old_val, new_val);
-                    if (prev == old_val) break;
-                    old_val = prev;
-                    old_dt = unpack_dist_tri(old_val);
+    Vec3ui pqr = tri[t_idx];
+    int box[6];
+    near_band_box(x[pqr.v[0]], x[pqr.v[1]], x[pqr.v[2]], origin, dx, ni, nj, nk, exact_band, box);
+
+    for (int bk = box[4] / NEAR_BRICK; bk <= box[5] / NEAR_BRICK; ++bk) {
+        for (int bj = box[2] / NEAR_BRICK; bj <= box[3] / NEAR_BRICK; ++bj) {
+            for (int bi = box[0] / NEAR_BRICK; bi <= box[1] / NEAR_BRICK; ++bi) {
+                int brick = (bk * bricks_y + bj) * bricks_x + bi;
+                int slot = atomicAdd(&brick_counts[brick], 1);
+                if (brick_offsets) {
+                    brick_tris[brick_offsets[brick] + slot] = t_idx;
                 }
             }
         }
     }
+}
 
-    // Intersection counting
-    int j0_int = clamp_int((int)ceil(fmin3(fjp, fjq, fjr)), 0, nj - 1);
-    int j1_int = clamp_int((int)floor(fmax3(fjp, fjq, fjr)), 0, nj - 1);
-    int k0_int = clamp_int((int)ceil(fmin3(fkp, fkq, fkr)), 0, nk - 1);
-    int k1_int = clamp_int((int)floor(fmax3(fkp, fkq, fkr)), 0, nk - 1);
-
-    for (int k = k0_int; k <= k1_int; ++k) {
-        for (int j = j0_int; j <= j1_int; ++j) {
-            double a, b, c;
+/**
+ * @brief Ray-crossing counts for the binned path (one thread per triangle)
+ */
+__global__ void triangle_crossings_kernel(const Vec3ui* tri, const Vec3f* x, int* intersection_count,
+                                          int num_triangles, Vec3f origin, float dx, int ni, int nj, int nk)
+{
+    int t_idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (t_idx >= num_triangles) return;
 
-            // Test at grid cell corner (j,k) to match CPU implementation
-            // This ensures consistent results across all mesh types and densities
-            if (point_in_triangle_2d(j, k, fjp, fkp, fjq, fkq, fjr, fkr, a, b, c)) {
-                double fi = a * fip + b * fiq + c * fir;
-                int i_interval = (int)ceil(fi);
+    Vec3ui pqr = tri[t_idx];
+    count_triangle_crossings(x[pqr.v[0]], x[pqr.v[1]], x[pqr.v[2]], origin, dx, ni, nj, nk, 0, nk, intersection_count);
+}
 
-                // Replicate the CPU's logic for handling intersections
-                // that occur before the grid starts (i < 0).
-                if (i_interval < 0) {
-                    int idx = grid_index(0, j, k, ni, nj); // Accumulate at the first cell
-                    atomicAdd(&intersection_count[idx], 1);
-                } else if (i_interval < ni) {
-                    int idx = grid_index(i_interval, j, k, ni, nj);
-                    atomicAdd(&intersection_count[idx], 1);
+/**
+ * @brief Exact near-band distances for one brick from its binned triangle list
+ *
+ * Each thread owns one cell and keeps its running minimum in registers while the block
+ * stages its brick's triangles through shared memory, so no global atomics are needed and
+ * the work per block is bounded by the brick size rather than by triangle extent. A
+ * triangle only contributes to the cells inside its near_band_box(), exactly as in
+ * near_band_distance_kernel; ties go to the lower triangle index.
+ *
+ * @param tri Triangle indices
+ * @param x Vertex positions
+ * @param geom Precomputed triangle geometry rows (or null)
+ * @param dist_tri Distance-triangle pairs, initialized; written once per cell, no atomics
+ * @param bricks Occupied bricks to process, one block each
+ * @param brick_offsets Exclusive scan of per-brick triangle counts (num_bricks + 1 entries)
+ * @param brick_tris Concatenated per-brick triangle lists
+ */
+__global__ void brick_near_band_kernel(
+    const Vec3ui* tri, const Vec3f* x, const float* geom, DistTriPair* dist_tri,
+    const int* bricks, const int* brick_offsets, const int* brick_tris,
+    int num_triangles, Vec3f origin, float dx, int ni, int nj, int nk, int exact_band,
+    int bricks_x, int bricks_y)
+{
+    __shared__ float s_geom[NEAR_CHUNK][GEOMETRY_FIELDS];
+    __shared__ int s_box[NEAR_CHUNK][6];
+    __shared__ int s_idx[NEAR_CHUNK];
+
+    int brick = bricks[blockIdx.x];
+    int i = (brick % bricks_x) * NEAR_BRICK + threadIdx.x;
+    int j = ((brick / bricks_x) % bricks_y) * NEAR_BRICK + threadIdx.y;
+    int k = (brick / (bricks_x * bricks_y)) * NEAR_BRICK + threadIdx.z;
+    bool inside = i < ni && j < nj && k < nk;
+    int tid = (threadIdx.z * NEAR_BRICK + threadIdx.y) * NEAR_BRICK + threadIdx.x;
+
+    int idx = inside ? grid_index(i, j, k, ni, nj) : 0;
+    DistTriPair best = inside ? dist_tri[idx] : DistTriPair{FLT_MAX, -1};
+
+    float gx_data[3] = {i * dx + origin.v[0], j * dx + origin.v[1], k * dx + origin.v[2]};
+    const Vec3f& gx = *reinterpret_cast<Vec3f*>(gx_data);
+
+    int begin = brick_offsets[brick], end = brick_offsets[brick + 1];
+    for (int base = begin; base < end; base += NEAR_CHUNK) {
+        int count = min(NEAR_CHUNK, end - base);
+        __syncthreads(); // previous chunk fully consumed
+        if (tid < count) {
+            int t = brick_tris[base + tid];
+            Vec3ui pqr = tri[t];
+            const Vec3f& p = x[pqr.v[0]];
+            const Vec3f& q = x[pqr.v[1]];
+            const Vec3f& r = x[pqr.v[2]];
+            near_band_box(p, q, r, origin, dx, ni, nj, nk, exact_band, s_box[tid]);
+            s_idx[tid] = t;
+            if (geom) {
+                for (int c = 0; c < GEOMETRY_FIELDS; ++c) s_geom[tid][c] = geom[(size_t)c * num_triangles + t];
+            } else {
+                for (int c = 0; c < 3; ++c) {
+                    s_geom[tid][c] = p.v[c];
+                    s_geom[tid][3 + c] = q.v[c];
+                    s_geom[tid][6 + c] = r.v[c];
+                }
+            }
+        }
+        __syncthreads();
+
+        if (inside) {
+            for (int n = 0; n < count; ++n) {
+                const int* b = s_box[n];
+                if (i < b[0] || i > b[1] || j < b[2] || j > b[3] || k < b[4] || k > b[5]) continue;
+                const float* g = s_geom[n];
+                float d = geom ? point_triangle_distance_table(gx, g)
+                               : gpu::point_triangle_distance(gx, *reinterpret_cast<const Vec3f*>(g),
+                                                         *reinterpret_cast<const Vec3f*>(g + 3),
+                                                         *reinterpret_cast<const Vec3f*>(g + 6));
+                if (d < best.dist || (d == best.dist && best.tri_idx >= 0 && s_idx[n] < best.tri_idx)) {
+                    best.dist = d;
+                    best.tri_idx = s_idx[n];
                 }
             }
         }
     }
+
+    if (inside) {
+        dist_tri[idx] = best;
+    }
 }
 
 // ============================================================================
@@ -466,53 +805,22 @@ __global__ void near_band_distance_kernel(
 // ============================================================================
 
 /**
- * @brief CUDA kernel for fast sweeping to propagate distances to far-field cells
- *
- * Implements a Jacobi-style parallel update for the Eikonal equation |∇φ| = 1,
- * which states that distance changes by dx per grid cell. This kernel propagates
- * distances from the narrow band computed in near_band_distance_kernel to all
- * remaining grid cells.
+ * @brief Godunov update of one cell from the smallest neighbour value along each axis
  *
- * Uses double-buffering (phi_read/phi_write) to avoid race conditions. Multiple
- * iterations of this kernel converge to the final distance field. Significantly
- * faster than propagating triangle indices in parallel.
+ * Shared by the full-grid Jacobi kernel and the active-tile kernel so both engines perform
+ * identical arithmetic. Missing neighbours are passed as FLT_MAX.
  *
- * @param phi_read Input distance values (previous iteration)
- * @param phi_write Output distance values (current iteration)
+ * @param current_phi Current value of the cell
+ * @param min_x Smaller of the two X neighbours
+ * @param min_y Smaller of the two Y neighbours
+ * @param min_z Smaller of the two Z neighbours
  * @param dx Grid cell spacing
- * @param ni Grid dimension in X
- * @param nj Grid dimension in Y
- * @param nk Grid dimension in Z
+ * @return Updated value, never larger than current_phi
  */
-__global__ void fast_sweep_eikonal_kernel(
-    const float* phi_read, float* phi_write,
-    float dx, int ni, int nj, int nk)
+__device__ float eikonal_update(float current_phi, float min_x, float min_y, float min_z, float dx)
 {
-    int i = blockIdx.x * blockDim.x + threadIdx.x;
-    int j = blockIdx.y * blockDim.y + threadIdx.y;
-    int k = blockIdx.z * blockDim.z + threadIdx.z;
-
-    if (i >= ni || j >= nj || k >= nk) return;
-
-    int idx = grid_index(i, j, k, ni, nj);
-    float current_phi = phi_read[idx];
     float new_phi = current_phi;
 
-    // --- Eikonal Update Step ---
-    // Find the minimum neighbor distance in each axis.
-    // Initialize with a large value to ensure only actual neighbor values are used.
-    float min_x = FLT_MAX;
-    if (i > 0)      min_x = fminf(min_x, phi_read[idx - 1]);
-    if (i < ni - 1) min_x = fminf(min_x, phi_read[idx + 1]);
-
-    float min_y = FLT_MAX;
-    if (j > 0)      min_y = fminf(min_y, phi_read[idx - ni]);
-    if (j < nj - 1) min_y = fminf(min_y, phi_read[idx + ni]);
-
-    float min_z = FLT_MAX;
-    if (k > 0)      min_z = fminf(min_z, phi_read[idx - ni*nj]);
-    if (k < nk - 1) min_z = fminf(min_z, phi_read[idx + ni*nj]);
-
     // Sort the three minimums so that min_x <= min_y <= min_z
     if (min_x > min_y) { float temp = min_x; min_x = min_y; min_y = temp; }
     if (min_y > min_z) { float temp = min_y; min_y = min_z; min_z = temp; }
@@ -547,233 +855,2506 @@ __global__ void fast_sweep_eikonal_kernel(
         }
     }
 
-    phi_write[idx] = new_phi;
+    return new_phi;
 }
 
-// ============================================================================
-// Kernel 4: Sign Correction
-// ============================================================================
-
 /**
- * @brief CUDA kernel to correct distance field signs based on ray-triangle intersections
- *
- * Determines inside/outside classification for each grid cell by counting ray-triangle
- * intersections. Uses the even-odd rule: odd intersection count means inside (negative
- * distance), even count means outside (positive distance).
- *
- * Processes one (j, k) column per thread, accumulating intersection counts along the i axis.
- * This matches the CPU implementation's sign determination logic.
+ * @brief Jacobi update of cell (i, j, k) of a full grid from its six neighbours in phi_read
  *
- * @param phi Distance field array (modified in-place to correct signs)
- * @param intersection_count Ray intersection counts from near_band_distance_kernel
- * @param ni Grid dimension in X
- * @param nj Grid dimension in Y
+ * Shared by the single-grid and batched sweep kernels.
+ */
+__device__ float jacobi_cell_update(const float* phi_read, size_t idx, int i, int j, int k,
+                                    int ni, int nj, int nk, float dx)
+{
+    // Find the minimum neighbor distance in each axis.
+    // Initialize with a large value to ensure only actual neighbor values are used.
+    float min_x = FLT_MAX;
+    if (i > 0)      min_x = fminf(min_x, phi_read[idx - 1]);
+    if (i < ni - 1) min_x = fminf(min_x, phi_read[idx + 1]);
+
+    float min_y = FLT_MAX;
+    if (j > 0)      min_y = fminf(min_y, phi_read[idx - ni]);
+    if (j < nj - 1) min_y = fminf(min_y, phi_read[idx + ni]);
+
+    float min_z = FLT_MAX;
+    if (k > 0)      min_z = fminf(min_z, phi_read[idx - (size_t)ni*nj]);
+    if (k < nk - 1) min_z = fminf(min_z, phi_read[idx + (size_t)ni*nj]);
+
+    return eikonal_update(phi_read[idx], min_x, min_y, min_z, dx);
+}
+
+/**
+ * @brief CUDA kernel for fast sweeping to propagate distances to far-field cells
+ *
+ * Implements a Jacobi-style parallel update for the Eikonal equation |∇φ| = 1,
+ * which states that distance changes by dx per grid cell. This kernel propagates
+ * distances from the narrow band computed in near_band_distance_kernel to all
+ * remaining grid cells.
+ *
+ * Uses double-buffering (phi_read/phi_write) to avoid race conditions. Multiple
+ * iterations of this kernel converge to the final distance field. Significantly
+ * faster than propagating triangle indices in parallel.
+ *
+ * @param phi_read Input distance values (previous iteration)
+ * @param phi_write Output distance values (current iteration)
+ * @param dx Grid cell spacing
+ * @param ni Grid dimension in X
+ * @param nj Grid dimension in Y
  * @param nk Grid dimension in Z
+ * @param changed Set to 1 if any cell decreased by more than tolerance (null: no check)
+ * @param tolerance Convergence tolerance in world units
+ */
+__global__ void fast_sweep_eikonal_kernel(
+    const float* phi_read, float* phi_write,
+    float dx, int ni, int nj, int nk, int* changed, float tolerance)
+{
+    int i = blockIdx.x * blockDim.x + threadIdx.x;
+    int j = blockIdx.y * blockDim.y + threadIdx.y;
+    int k = blockIdx.z * blockDim.z + threadIdx.z;
+
+    if (i >= ni || j >= nj || k >= nk) return;
+
+    int idx = grid_index(i, j, k, ni, nj);
+    float current_phi = phi_read[idx];
+    float new_phi = jacobi_cell_update(phi_read, idx, i, j, k, ni, nj, nk, dx);
+    phi_write[idx] = new_phi;
+
+    // Values only ever decrease; racing stores of the same flag value are benign
+    if (changed && current_phi - new_phi > tolerance) {
+        *changed = 1;
+    }
+}
+
+// ============================================================================
+// Kernel 3b: Active-Tile Fast Iterative Method
+// ============================================================================
+
+// Tiles are FIM_TILE^3 cells, one thread block (one thread per cell) per active tile
+#define FIM_TILE 8
+#define FIM_HALO (FIM_TILE + 2)
+
+/**
+ * @brief Mark a tile and its six face neighbours as active for the next iteration
+ */
+__device__ void activate_tile_and_neighbours(unsigned char* tile_flags, int tx, int ty, int tz,
+                                             int tiles_x, int tiles_y, int tiles_z)
+{
+    int tile = (tz * tiles_y + ty) * tiles_x + tx;
+    tile_flags[tile] = 1;
+    if (tx > 0)           tile_flags[tile - 1] = 1;
+    if (tx < tiles_x - 1) tile_flags[tile + 1] = 1;
+    if (ty > 0)           tile_flags[tile - tiles_x] = 1;
+    if (ty < tiles_y - 1) tile_flags[tile + tiles_x] = 1;
+    if (tz > 0)           tile_flags[tile - tiles_x * tiles_y] = 1;
+    if (tz < tiles_z - 1) tile_flags[tile + tiles_x * tiles_y] = 1;
+}
+
+/**
+ * @brief Seed the active set: every tile holding a near-band cell, plus its neighbours
+ *
+ * Launched with one FIM_TILE^3 block per tile. Neighbours are included because a tile whose
+ * cells are all exact never changes itself, yet must start the front in the tiles around it.
+ *
+ * @param dist_tri Distance-triangle pairs after the near-band kernel
+ * @param tile_flags Per-tile activity flags, zeroed by the host
+ */
+__global__ void seed_active_tiles_kernel(const DistTriPair* dist_tri, unsigned char* tile_flags,
+                                         int ni, int nj, int nk)
+{
+    int i = blockIdx.x * FIM_TILE + threadIdx.x;
+    int j = blockIdx.y * FIM_TILE + threadIdx.y;
+    int k = blockIdx.z * FIM_TILE + threadIdx.z;
+
+    int seeded = i < ni && j < nj && k < nk && dist_tri[grid_index(i, j, k, ni, nj)].tri_idx >= 0;
+    if (__syncthreads_or(seeded) && threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {
+        activate_tile_and_neighbours(tile_flags, blockIdx.x, blockIdx.y, blockIdx.z,
+                                     gridDim.x, gridDim.y, gridDim.z);
+    }
+}
+
+/**
+ * @brief Compact the flagged tiles into a list and clear the flags
+ *
+ * List order depends on scheduling, which is harmless: the tile kernel only reads the
+ * previous iteration's field.
+ */
+__global__ void compact_active_tiles_kernel(unsigned char* tile_flags, int num_tiles,
+                                            int* active_tiles, int* active_count)
+{
+    int tile = blockIdx.x * blockDim.x + threadIdx.x;
+    if (tile >= num_tiles || !tile_flags[tile]) return;
+    tile_flags[tile] = 0;
+    active_tiles[atomicAdd(active_count, 1)] = tile;
+}
+
+/**
+ * @brief Block fast iterative method update of one active tile
+ *
+ * Loads the tile and a one-cell halo from phi_read into shared memory, iterates the Jacobi
+ * update locally with the halo held fixed until the tile settles (at most inner_iterations
+ * times), and writes the tile to phi_write. A tile that changed by more than tolerance
+ * reactivates itself and its face neighbours, so work follows the propagating front instead
+ * of the whole grid. Reading only the previous field keeps the result independent of block
+ * scheduling.
+ *
+ * @param phi_read Field from the previous outer iteration (tiles and halos read)
+ * @param phi_write Receives the updated active tiles
+ * @param active_tiles Compacted list of tiles to process, one block each
+ * @param tile_flags Activity flags for the next outer iteration
+ * @param tiles_x Tiles along X
+ * @param tiles_y Tiles along Y
+ * @param tiles_z Tiles along Z
+ * @param dx Grid cell spacing
+ * @param ni Grid dimension in X
+ * @param nj Grid dimension in Y
+ * @param nk Grid dimension in Z
+ * @param tolerance A tile counts as changed when any cell decreased by more than this
+ * @param inner_iterations Upper bound on local iterations per visit
+ */
+__global__ void active_tile_sweep_kernel(const float* phi_read, float* phi_write,
+                                         const int* active_tiles, unsigned char* tile_flags,
+                                         int tiles_x, int tiles_y, int tiles_z,
+                                         float dx, int ni, int nj, int nk,
+                                         float tolerance, int inner_iterations)
+{
+    __shared__ float s_phi[2][FIM_HALO][FIM_HALO][FIM_HALO];
+
+    int tile = active_tiles[blockIdx.x];
+    int tx = tile % tiles_x;
+    int ty = (tile / tiles_x) % tiles_y;
+    int tz = tile / (tiles_x * tiles_y);
+
+    // Load tile and halo into both buffers; cells outside the grid act as missing neighbours
+    int tid = (threadIdx.z * FIM_TILE + threadIdx.y) * FIM_TILE + threadIdx.x;
+    for (int n = tid; n < FIM_HALO * FIM_HALO * FIM_HALO; n += FIM_TILE * FIM_TILE * FIM_TILE) {
+        int hi = n % FIM_HALO, hj = (n / FIM_HALO) % FIM_HALO, hk = n / (FIM_HALO * FIM_HALO);
+        int gi = tx * FIM_TILE + hi - 1, gj = ty * FIM_TILE + hj - 1, gk = tz * FIM_TILE + hk - 1;
+        float value = FLT_MAX;
+        if (gi >= 0 && gi < ni && gj >= 0 && gj < nj && gk >= 0 && gk < nk) {
+            value = phi_read[grid_index(gi, gj, gk, ni, nj)];
+        }
+        s_phi[0][hk][hj][hi] = value;
+        s_phi[1][hk][hj][hi] = value;
+    }
+    __syncthreads();
+
+    int li = threadIdx.x + 1, lj = threadIdx.y + 1, lk = threadIdx.z + 1;
+    int i = tx * FIM_TILE + threadIdx.x;
+    int j = ty * FIM_TILE + threadIdx.y;
+    int k = tz * FIM_TILE + threadIdx.z;
+    bool inside = i < ni && j < nj && k < nk;
+    float original = s_phi[0][lk][lj][li];
+
+    int src = 0;
+    for (int iter = 0; iter < inner_iterations; ++iter) {
+        float current_phi = s_phi[src][lk][lj][li];
+        float new_phi = current_phi;
+        if (inside) {
+            float min_x = fminf(s_phi[src][lk][lj][li - 1], s_phi[src][lk][lj][li + 1]);
+            float min_y = fminf(s_phi[src][lk][lj - 1][li], s_phi[src][lk][lj + 1][li]);
+            float min_z = fminf(s_phi[src][lk - 1][lj][li], s_phi[src][lk + 1][lj][li]);
+            new_phi = eikonal_update(current_phi, min_x, min_y, min_z, dx);
+        }
+        s_phi[1 - src][lk][lj][li] = new_phi;
+        src = 1 - src;
+        // Barrier and block-wide vote in one; stop once the tile is locally stationary
+        if (!__syncthreads_or(current_phi - new_phi > 0.0f)) break;
+    }
+
+    float final_phi = s_phi[src][lk][lj][li];
+    if (inside) {
+        phi_write[grid_index(i, j, k, ni, nj)] = final_phi;
+    }
+    if (__syncthreads_or(inside && original - final_phi > tolerance) &&
+        threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {
+        activate_tile_and_neighbours(tile_flags, tx, ty, tz, tiles_x, tiles_y, tiles_z);
+    }
+}
+
+/**
+ * @brief Copy the active tiles from phi_write back into phi_read
+ *
+ * Inactive tiles are identical in both buffers, so after this the next outer iteration
+ * reads a consistent field without a full-grid swap.
+ */
+__global__ void commit_active_tiles_kernel(const float* phi_write, float* phi_read,
+                                           const int* active_tiles, int tiles_x, int tiles_y,
+                                           int ni, int nj, int nk)
+{
+    int tile = active_tiles[blockIdx.x];
+    int i = (tile % tiles_x) * FIM_TILE + threadIdx.x;
+    int j = ((tile / tiles_x) % tiles_y) * FIM_TILE + threadIdx.y;
+    int k = (tile / (tiles_x * tiles_y)) * FIM_TILE + threadIdx.z;
+    if (i >= ni || j >= nj || k >= nk) return;
+    int idx = grid_index(i, j, k, ni, nj);
+    phi_read[idx] = phi_write[idx];
+}
+
+// ============================================================================
+// Kernel 4: Sign Correction
+// ============================================================================
+
+/**
+ * @brief CUDA kernel to correct distance field signs based on ray-triangle intersections
+ *
+ * Determines inside/outside classification for each grid cell by counting ray-triangle
+ * intersections. Uses the even-odd rule: odd intersection count means inside (negative
+ * distance), even count means outside (positive distance).
+ *
+ * Processes one (j, k) column per thread, accumulating intersection counts along the i axis.
+ * This matches the CPU implementation's sign determination logic.
+ *
+ * @param phi Distance field array (modified in-place to correct signs)
+ * @param intersection_count Ray intersection counts from near_band_distance_kernel
+ * @param ni Grid dimension in X
+ * @param nj Grid dimension in Y
+ * @param nk Grid dimension in Z
+ */
+__global__ void sign_correction_kernel(float* phi, const int* intersection_count,
+                                      int ni, int nj, int nk) {
+    int j = blockIdx.x * blockDim.x + threadIdx.x;
+    int k = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (j >= nj || k >= nk) return;
+
+    int total_count = 0;
+    for (int i = 0; i < ni; ++i) {
+        int idx = grid_index(i, j, k, ni, nj);
+        total_count += intersection_count[idx];
+
+        if (total_count % 2 == 1) {  // Inside mesh
+            phi[idx] = -phi[idx];
+        }
+    }
+}
+
+// ============================================================================
+// Kernel 4b: Winding-Number Signs
+// ============================================================================
+
+/**
+ * @brief Fast generalized winding number at q (device version of WindingNumberTree::winding_number)
+ */
+__device__ float winding_number(const WindingNode* nodes, int num_nodes, const Vec3f* corners,
+                                float qx, float qy, float qz) {
+    if (num_nodes == 0) return 0.0f;
+    const float beta = 2.0f;
+    float sum = 0.0f;
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const WindingNode& node = nodes[stack[--top]];
+        float dx = node.center[0] - qx, dy = node.center[1] - qy, dz = node.center[2] - qz;
+        float d = sqrtf(dx*dx + dy*dy + dz*dz);
+        if (d > beta * node.radius) {
+            sum += (node.normal[0]*dx + node.normal[1]*dy + node.normal[2]*dz) / (d*d*d);
+            continue;
+        }
+        if (node.count == 0) {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+            continue;
+        }
+        for (int s = node.first; s < node.first + node.count; ++s) {
+            const Vec3f& a = corners[3*s];
+            const Vec3f& b = corners[3*s + 1];
+            const Vec3f& c = corners[3*s + 2];
+            float ax = a.v[0] - qx, ay = a.v[1] - qy, az = a.v[2] - qz;
+            float bx = b.v[0] - qx, by = b.v[1] - qy, bz = b.v[2] - qz;
+            float cx = c.v[0] - qx, cy = c.v[1] - qy, cz = c.v[2] - qz;
+            float la = sqrtf(ax*ax + ay*ay + az*az);
+            float lb = sqrtf(bx*bx + by*by + bz*bz);
+            float lc = sqrtf(cx*cx + cy*cy + cz*cz);
+            float det = ax*(by*cz - bz*cy) + ay*(bz*cx - bx*cz) + az*(bx*cy - by*cx);
+            float den = la*lb*lc + (ax*bx + ay*by + az*bz)*lc + (bx*cx + by*cy + bz*cz)*la + (cx*ax + cy*ay + cz*az)*lb;
+            sum += 2.0f * atan2f(det, den);
+        }
+    }
+    return sum / (4.0f * 3.14159265358979f);
+}
+
+/**
+ * @brief Replace a slab's crossing counts with the transitions of the winding-number sign
+ *
+ * Same rule as the CPU winding sign pass: nodes whose near-band distance is at most dx are
+ * evaluated individually, runs of farther nodes only at their ends and bisected where the
+ * ends disagree. The inside flags are then written as parity toggles (node i holds
+ * inside(i) xor inside(i-1)), so sign_correction_kernel, inside_flags_kernel and the batched
+ * sign pass apply them unchanged.
+ *
+ * @param dist_tri Near-band distances of the slab (before the far-field sweep)
+ * @param intersection_count Overwritten with the toggles for the slab's rows
+ * @param k_begin Grid plane of the slab's first layer
+ * @param queries Incremented by the number of winding-number evaluations
+ */
+__global__ void winding_crossings_kernel(const DistTriPair* dist_tri, int* intersection_count,
+                                         const WindingNode* nodes, int num_nodes, const Vec3f* corners,
+                                         Vec3f origin, float dx, int ni, int nj, int layers, int k_begin,
+                                         unsigned long long* queries) {
+    int j = blockIdx.x * blockDim.x + threadIdx.x;
+    int k = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (j >= nj || k >= layers) return;
+
+    const float qy = j * dx + origin.v[1];
+    const float qz = (k + k_begin) * dx + origin.v[2];
+    int* side = intersection_count + grid_index(0, j, k, ni, nj);
+    const DistTriPair* row = dist_tri + grid_index(0, j, k, ni, nj);
+    unsigned long long row_queries = 0;
+
+    struct Run { int a, b, sa, sb; };
+    Run stack[64];
+    for (int i = 0; i < ni; ) {
+        if (row[i].dist <= dx) {
+            side[i] = winding_number(nodes, num_nodes, corners, i * dx + origin.v[0], qy, qz) >= 0.5f;
+            ++row_queries;
+            ++i;
+            continue;
+        }
+        int b = i;
+        while (b + 1 < ni && row[b + 1].dist > dx) ++b;
+        int sa = winding_number(nodes, num_nodes, corners, i * dx + origin.v[0], qy, qz) >= 0.5f;
+        int sb = sa;
+        ++row_queries;
+        if (b > i) {
+            sb = winding_number(nodes, num_nodes, corners, b * dx + origin.v[0], qy, qz) >= 0.5f;
+            ++row_queries;
+        }
+        int top = 0;
+        stack[top++] = Run{i, b, sa, sb};
+        while (top > 0) {
+            Run r = stack[--top];
+            if (r.sa == r.sb) {
+                for (int n = r.a; n <= r.b; ++n) side[n] = r.sa;
+                continue;
+            }
+            if (r.b - r.a == 1) {
+                side[r.a] = r.sa;
+                side[r.b] = r.sb;
+                continue;
+            }
+            int m = (r.a + r.b) / 2;
+            int sm = winding_number(nodes, num_nodes, corners, m * dx + origin.v[0], qy, qz) >= 0.5f;
+            ++row_queries;
+            stack[top++] = Run{r.a, m, r.sa, sm};
+            stack[top++] = Run{m, r.b, sm, r.sb};
+        }
+        i = b + 1;
+    }
+
+    // inside flags to parity toggles, right to left so each step still sees its left neighbour's flag
+    for (int i = ni - 1; i > 0; --i) side[i] ^= side[i - 1];
+    atomicAdd(queries, row_queries);
+}
+
+/**
+ * @brief A WindingNumberTree uploaded to the current device
+ */
+struct DeviceWindingTree {
+    WindingNode* nodes = nullptr;
+    Vec3f* corners = nullptr;
+    int num_nodes = 0;
+    unsigned long long* queries = nullptr;  ///< Evaluation counter of winding_crossings_kernel
+
+    void upload(const WindingNumberTree& tree) {
+        num_nodes = (int)tree.nodes().size();
+        CUDA_CHECK(cudaMalloc(&nodes, std::max(num_nodes, 1) * sizeof(WindingNode)));
+        CUDA_CHECK(cudaMalloc(&corners, std::max<size_t>(tree.corners().size(), 1) * sizeof(Vec3f)));
+        CUDA_CHECK(cudaMalloc(&queries, sizeof(unsigned long long)));
+        CUDA_CHECK(cudaMemcpy(nodes, tree.nodes().data(), num_nodes * sizeof(WindingNode), cudaMemcpyHostToDevice));
+        CUDA_CHECK(cudaMemcpy(corners, tree.corners().data(), tree.corners().size() * sizeof(Vec3f),
+                              cudaMemcpyHostToDevice));
+        CUDA_CHECK(cudaMemset(queries, 0, sizeof(unsigned long long)));
+    }
+
+    /** @brief Launch winding_crossings_kernel over a slab of layers planes starting at k_begin */
+    void crossings(const DistTriPair* dist_tri, int* intersection_count, Vec3f origin, float dx,
+                   int ni, int nj, int layers, int k_begin, cudaStream_t stream) const {
+        dim3 block(16, 16);
+        dim3 grid((nj + 15) / 16, (layers + 15) / 16);
+        winding_crossings_kernel<<<grid, block, 0, stream>>>(dist_tri, intersection_count, nodes, num_nodes, corners,
+                                                             origin, dx, ni, nj, layers, k_begin, queries);
+        CUDA_CHECK(cudaGetLastError());
+    }
+
+    /** @brief Evaluations so far (synchronizes the device) */
+    long long evaluations() const {
+        unsigned long long count = 0;
+        CUDA_CHECK(cudaMemcpy(&count, queries, sizeof(unsigned long long), cudaMemcpyDeviceToHost));
+        return (long long)count;
+    }
+
+    DeviceWindingTree() = default;
+    DeviceWindingTree(const DeviceWindingTree&) = delete;
+    DeviceWindingTree& operator=(const DeviceWindingTree&) = delete;
+
+    // Unchecked like DeviceBuffer::free(), since it also runs while an exception unwinds
+    ~DeviceWindingTree() {
+        if (nodes) cudaFree(nodes);
+        if (corners) cudaFree(corners);
+        if (queries) cudaFree(queries);
+    }
+
+    bool valid() const { return queries != nullptr; }
+};
+
+// ============================================================================
+// Kernel 4c: Ray-Vote Signs
+// ============================================================================
+
+/**
+ * @brief Crossings of one triangle along any grid axis (device version of for_each_axis_crossing)
+ *
+ * The axes are permuted cyclically, so axis 0 reproduces count_triangle_crossings. The output
+ * holds planes k_begin..k_begin+k_count-1. For z rays every crossing before the slab counts
+ * at its first plane, the way x crossings before the grid count at i = 0, so each slab gets
+ * the full parity of its columns without seeing the planes below.
+ */
+__device__ void count_axis_crossings(const Vec3f& p, const Vec3f& q, const Vec3f& r, int axis,
+                                     Vec3f origin, float dx, int ni, int nj, int nk,
+                                     int k_begin, int k_count, int* counts)
+{
+    const int n[3] = {ni, nj, nk};
+    const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+    double fp[3], fq[3], fr[3];
+    for (int c = 0; c < 3; ++c) {
+        fp[c] = ((double)p.v[c] - origin.v[c]) / dx;
+        fq[c] = ((double)q.v[c] - origin.v[c]) / dx;
+        fr[c] = ((double)r.v[c] - origin.v[c]) / dx;
+    }
+    int lo[3], hi[3];
+    lo[u] = clamp_int((int)ceil(fmin3(fp[u], fq[u], fr[u])), 0, n[u] - 1);
+    hi[u] = clamp_int((int)floor(fmax3(fp[u], fq[u], fr[u])), 0, n[u] - 1);
+    lo[v] = clamp_int((int)ceil(fmin3(fp[v], fq[v], fr[v])), 0, n[v] - 1);
+    hi[v] = clamp_int((int)floor(fmax3(fp[v], fq[v], fr[v])), 0, n[v] - 1);
+    lo[axis] = 0;
+    hi[axis] = n[axis] - 1;
+    lo[2] = max(lo[2], k_begin);
+    hi[2] = min(hi[2], k_begin + k_count - 1);
+
+    int node[3];
+    for (int b = lo[v]; b <= hi[v]; ++b) {
+        for (int a = lo[u]; a <= hi[u]; ++a) {
+            double wa, wb, wc;
+            if (!point_in_triangle_2d(a, b, fp[u], fp[v], fq[u], fq[v], fr[u], fr[v], wa, wb, wc)) continue;
+            int interval = (int)ceil(wa * fp[axis] + wb * fq[axis] + wc * fr[axis]);
+            if (interval > hi[axis]) continue;
+            node[axis] = max(interval, lo[axis]);
+            node[u] = a;
+            node[v] = b;
+            atomicAdd(&counts[grid_index(node[0], node[1], node[2] - k_begin, ni, nj)], 1);
+        }
+    }
+}
+
+/**
+ * @brief y or z ray crossings of every triangle (one thread per triangle)
+ */
+__global__ void axis_crossings_kernel(const Vec3ui* tri, const Vec3f* x, int* counts, int num_triangles, int axis,
+                                      Vec3f origin, float dx, int ni, int nj, int nk, int k_begin, int k_count)
+{
+    int t_idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (t_idx >= num_triangles) return;
+
+    Vec3ui pqr = tri[t_idx];
+    count_axis_crossings(x[pqr.v[0]], x[pqr.v[1]], x[pqr.v[2]], axis, origin, dx, ni, nj, nk, k_begin, k_count, counts);
+}
+
+/**
+ * @brief Add each node's crossing parity along axis to its vote (one thread per ray)
+ *
+ * Threads of a block take neighbouring rays, so y and z walks read contiguous i rows.
+ */
+__global__ void axis_vote_kernel(const int* counts, unsigned char* votes, int axis, int ni, int nj, int layers)
+{
+    const int n[3] = {ni, nj, layers};
+    const int u = axis == 0 ? 1 : 0, v = axis == 2 ? 1 : 2;
+    int node[3];
+    node[u] = blockIdx.x * blockDim.x + threadIdx.x;
+    node[v] = blockIdx.y * blockDim.y + threadIdx.y;
+    if (node[u] >= n[u] || node[v] >= n[v]) return;
+
+    int total_count = 0;
+    for (node[axis] = 0; node[axis] < n[axis]; ++node[axis]) {
+        int idx = grid_index(node[0], node[1], node[2], ni, nj);
+        total_count += counts[idx];
+        votes[idx] += total_count & 1;
+    }
+}
+
+/**
+ * @brief Replace a slab's crossing counts with the transitions of the majority vote
+ *
+ * Same encoding as winding_crossings_kernel, so the existing sign kernels apply the vote.
+ */
+__global__ void vote_crossings_kernel(const unsigned char* votes, int* intersection_count, int ni, int nj, int layers)
+{
+    int j = blockIdx.x * blockDim.x + threadIdx.x;
+    int k = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (j >= nj || k >= layers) return;
+
+    int previous = 0;
+    for (int i = 0; i < ni; ++i) {
+        int idx = grid_index(i, j, k, ni, nj);
+        int inside = votes[idx] >= 2;
+        intersection_count[idx] = inside ^ previous;
+        previous = inside;
+    }
+}
+
+/**
+ * @brief Majority of the x, y and z crossing parities for a slab, written as parity toggles
+ *
+ * intersection_count holds the slab's +x crossings on entry; it doubles as the y and z count
+ * buffer once the x vote is taken, and votes needs one byte per slab cell of scratch.
+ */
+static void ray_vote_crossings(const Vec3ui* d_tri, const Vec3f* d_x, int num_triangles, int* intersection_count,
+                               unsigned char* votes, Vec3f origin, float dx, int ni, int nj, int nk,
+                               int layers, int k_begin, cudaStream_t stream)
+{
+    const size_t cells = (size_t)ni * nj * layers;
+    const int n[3] = {ni, nj, layers};
+    CUDA_CHECK(cudaMemsetAsync(votes, 0, cells, stream));
+    for (int axis = 0; axis < 3; ++axis) {
+        if (axis > 0) {
+            CUDA_CHECK(cudaMemsetAsync(intersection_count, 0, cells * sizeof(int), stream));
+            if (num_triangles > 0) {
+                axis_crossings_kernel<<<(num_triangles + 255) / 256, 256, 0, stream>>>(
+                    d_tri, d_x, intersection_count, num_triangles, axis, origin, dx, ni, nj, nk, k_begin, layers);
+                CUDA_CHECK(cudaGetLastError());
+            }
+        }
+        const int u = axis == 0 ? 1 : 0, v = axis == 2 ? 1 : 2;
+        dim3 block(16, 16);
+        dim3 grid((n[u] + 15) / 16, (n[v] + 15) / 16);
+        axis_vote_kernel<<<grid, block, 0, stream>>>(intersection_count, votes, axis, ni, nj, layers);
+        CUDA_CHECK(cudaGetLastError());
+    }
+    dim3 block(16, 16);
+    dim3 grid((nj + 15) / 16, (layers + 15) / 16);
+    vote_crossings_kernel<<<grid, block, 0, stream>>>(votes, intersection_count, ni, nj, layers);
+    CUDA_CHECK(cudaGetLastError());
+}
+
+// ============================================================================
+// Kernel 5: Diagnostics Reductions
+// ============================================================================
+
+/**
+ * @brief Device-side reduction of near-band statistics
+ *
+ * Grid-stride loop with a shared-memory tree reduction per block and one set of atomics per
+ * block. Unsigned distances order like their IEEE bit patterns, so the float min/max use
+ * integer atomicMin/atomicMax on the bits.
+ *
+ * @param dist_tri Distance-triangle pairs after the near-band kernel
+ * @param intersection_count Ray intersection counts
+ * @param num_cells Number of grid cells
+ * @param result Accumulators, initialized by the host
+ */
+__global__ void near_band_stats_kernel(const DistTriPair* dist_tri, const int* intersection_count,
+                                       size_t num_cells, NearBandStats* result) {
+    __shared__ unsigned long long s_cells[256];
+    __shared__ unsigned long long s_crossings[256];
+    __shared__ unsigned int s_min[256];
+    __shared__ unsigned int s_max[256];
+
+    unsigned long long cells = 0, crossings = 0;
+    unsigned int min_bits = 0x7f800000u; // +inf
+    unsigned int max_bits = 0u;
+    for (size_t idx = blockIdx.x * (size_t)blockDim.x + threadIdx.x; idx < num_cells;
+         idx += (size_t)gridDim.x * blockDim.x) {
+        crossings += intersection_count[idx];
+        DistTriPair dt = dist_tri[idx];
+        if (dt.tri_idx >= 0) {
+            unsigned int bits = __float_as_uint(dt.dist);
+            min_bits = min(min_bits, bits);
+            max_bits = max(max_bits, bits);
+            ++cells;
+        }
+    }
+
+    int t = threadIdx.x;
+    s_cells[t] = cells;
+    s_crossings[t] = crossings;
+    s_min[t] = min_bits;
+    s_max[t] = max_bits;
+    __syncthreads();
+    for (int stride = blockDim.x / 2; stride > 0; stride >>= 1) {
+        if (t < stride) {
+            s_cells[t] += s_cells[t + stride];
+            s_crossings[t] += s_crossings[t + stride];
+            s_min[t] = min(s_min[t], s_min[t + stride]);
+            s_max[t] = max(s_max[t], s_max[t + stride]);
+        }
+        __syncthreads();
+    }
+
+    if (t == 0) {
+        atomicAdd(&result->cells, s_cells[0]);
+        atomicAdd(&result->crossings, s_crossings[0]);
+        atomicMin(&result->min_bits, s_min[0]);
+        atomicMax(&result->max_bits, s_max[0]);
+    }
+}
+
+/**
+ * @brief Run near_band_stats_kernel and copy its accumulators into stats
+ */
+static void gather_near_band_stats(const DistTriPair* d_dist_tri, const int* d_intersection_count,
+                                   size_t num_cells, GenerationStats& stats) {
+    NearBandStats init;
+    init.cells = 0;
+    init.crossings = 0;
+    init.min_bits = 0x7f800000u;
+    init.max_bits = 0u;
+    NearBandStats* d_result;
+    CUDA_CHECK(cudaMalloc(&d_result, sizeof(NearBandStats)));
+    CUDA_CHECK(cudaMemcpy(d_result, &init, sizeof(NearBandStats), cudaMemcpyHostToDevice));
+
+    int block = 256;
+    int grid = (int)std::min<size_t>((num_cells + block - 1) / block, 1024);
+    near_band_stats_kernel<<<std::max(grid, 1), block>>>(d_dist_tri, d_intersection_count, num_cells, d_result);
+    CUDA_CHECK(cudaGetLastError());
+
+    NearBandStats result;
+    CUDA_CHECK(cudaMemcpy(&result, d_result, sizeof(NearBandStats), cudaMemcpyDeviceToHost));
+    CUDA_CHECK(cudaFree(d_result));
+
+    stats.near_band_cells = (long long)result.cells;
+    stats.intersections = (long long)result.crossings;
+    stats.near_band_min = 0.0f;
+    stats.near_band_max = 0.0f;
+    if (result.cells > 0) {
+        std::memcpy(&stats.near_band_min, &result.min_bits, sizeof(float));
+        std::memcpy(&stats.near_band_max, &result.max_bits, sizeof(float));
+    }
+    stats.diagnostics_valid = true;
+}
+
+/**
+ * @brief Fold the near-band statistics of one part of the grid into a running total
+ *
+ * total must start default-constructed; min/max are only taken from parts that have cells.
+ */
+static void merge_near_band_stats(GenerationStats& total, const GenerationStats& part) {
+    total.intersections += part.intersections;
+    if (part.near_band_cells > 0) {
+        bool first = total.near_band_cells == 0;
+        total.near_band_min = first ? part.near_band_min : std::min(total.near_band_min, part.near_band_min);
+        total.near_band_max = first ? part.near_band_max : std::max(total.near_band_max, part.near_band_max);
+        total.near_band_cells += part.near_band_cells;
+    }
+    total.diagnostics_valid = true;
+}
+
+// ============================================================================
+// Kernel 6: Streamed Slabs
+// ============================================================================
+
+/**
+ * @brief Inside/outside flags of a slab from its intersection counts
+ *
+ * Same even-odd rule as sign_correction_kernel, recorded as one byte per cell so the sign can
+ * be applied on the host after the far field has been swept slab by slab.
+ *
+ * @param intersection_count Ray intersection counts of the slab
+ * @param inside Receives 1 for inside cells, 0 otherwise
+ * @param ni Grid dimension in X
+ * @param nj Grid dimension in Y
+ * @param layers Planes in the slab
+ */
+__global__ void inside_flags_kernel(const int* intersection_count, unsigned char* inside,
+                                    int ni, int nj, int layers) {
+    int j = blockIdx.x * blockDim.x + threadIdx.x;
+    int k = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (j >= nj || k >= layers) return;
+
+    int total_count = 0;
+    for (int i = 0; i < ni; ++i) {
+        int idx = grid_index(i, j, k, ni, nj);
+        total_count += intersection_count[idx];
+        inside[idx] = total_count % 2 == 1;
+    }
+}
+
+/**
+ * @brief Jacobi update of a slab's interior planes with fixed halo planes
+ *
+ * The buffers hold layers + 2 planes: plane 0 and plane layers + 1 are copies of the
+ * neighbouring slabs (FLT_MAX outside the grid, which acts as a missing neighbour exactly
+ * like the bounds checks in fast_sweep_eikonal_kernel) and are never written.
+ *
+ * @param phi_read Input distance values including halos
+ * @param phi_write Output distance values including halos
+ * @param dx Grid cell spacing
+ * @param ni Grid dimension in X
+ * @param nj Grid dimension in Y
+ * @param layers Interior planes
+ * @param changed changed[0] and changed[1] are set to 1 if any cell decreased by more than tolerance
+ * @param tolerance Convergence tolerance in world units
+ */
+__global__ void slab_sweep_kernel(const float* phi_read, float* phi_write,
+                                  float dx, int ni, int nj, int layers, int* changed, float tolerance)
+{
+    int i = blockIdx.x * blockDim.x + threadIdx.x;
+    int j = blockIdx.y * blockDim.y + threadIdx.y;
+    int k = blockIdx.z * blockDim.z + threadIdx.z + 1;
+
+    if (i >= ni || j >= nj || k > layers) return;
+
+    int idx = grid_index(i, j, k, ni, nj);
+    float current_phi = phi_read[idx];
+
+    float min_x = FLT_MAX;
+    if (i > 0)      min_x = fminf(min_x, phi_read[idx - 1]);
+    if (i < ni - 1) min_x = fminf(min_x, phi_read[idx + 1]);
+
+    float min_y = FLT_MAX;
+    if (j > 0)      min_y = fminf(min_y, phi_read[idx - ni]);
+    if (j < nj - 1) min_y = fminf(min_y, phi_read[idx + ni]);
+
+    float min_z = fminf(phi_read[idx - ni*nj], phi_read[idx + ni*nj]);
+
+    float new_phi = eikonal_update(current_phi, min_x, min_y, min_z, dx);
+    phi_write[idx] = new_phi;
+
+    if (current_phi - new_phi > tolerance) {
+        changed[0] = 1;
+        changed[1] = 1;
+    }
+}
+
+// ============================================================================
+// Kernel 7: Batched Grids
+// ============================================================================
+
+/**
+ * @brief One grid of a batch: its geometry and where its cells, rows and triangles start
+ *
+ * Grids are packed back to back in one set of device arrays, so a whole batch of small parts
+ * is generated with one launch per phase instead of one per part.
+ */
+struct BatchGrid {
+    Vec3f origin;
+    float dx;
+    int ni, nj, nk;
+    float max_dist;           ///< Initial distance, (ni + nj + nk) * dx as in the single-grid path
+    int max_iterations;       ///< Jacobi cap of the single-grid path, 2 * max(ni, nj, nk)
+    size_t cell_offset;       ///< First cell in the packed grid arrays
+};
+
+/**
+ * @brief Index b with offsets[b] <= value < offsets[b + 1] (offsets has count + 1 entries)
+ */
+__device__ int batch_find(const size_t* offsets, int count, size_t value) {
+    int lo = 0, hi = count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (offsets[mid] <= value) lo = mid; else hi = mid - 1;
+    }
+    return lo;
+}
+
+/**
+ * @brief initialize_grids_kernel over every cell of a batch
+ */
+__global__ void batch_initialize_kernel(DistTriPair* dist_tri, int* intersection_count,
+                                        const BatchGrid* grids, const size_t* cell_offsets,
+                                        int num_grids, size_t total_cells) {
+    size_t idx = (size_t)blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= total_cells) return;
+
+    const BatchGrid& grid = grids[batch_find(cell_offsets, num_grids, idx)];
+    dist_tri[idx].dist = grid.max_dist;
+    dist_tri[idx].tri_idx = -1;
+    intersection_count[idx] = 0;
+}
+
+/**
+ * @brief near_band_distance_kernel over the packed triangles of a batch
+ *
+ * Vertex indices in tri are already offset into the packed vertex array; each triangle writes
+ * into its own grid's cells.
+ */
+__global__ void batch_near_band_kernel(const Vec3ui* tri, const Vec3f* x,
+                                       DistTriPair* dist_tri, int* intersection_count,
+                                       const BatchGrid* grids, const size_t* tri_offsets,
+                                       int num_grids, int num_triangles, int exact_band) {
+    int t_idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (t_idx >= num_triangles) return;
+
+    const BatchGrid& grid = grids[batch_find(tri_offsets, num_grids, t_idx)];
+    Vec3ui pqr = tri[t_idx];
+    Vec3f p = x[pqr.v[0]];
+    Vec3f q = x[pqr.v[1]];
+    Vec3f r = x[pqr.v[2]];
+    near_band_triangle(p, q, r, nullptr, t_idx, dist_tri + grid.cell_offset, intersection_count + grid.cell_offset,
+                       grid.origin, grid.dx, grid.ni, grid.nj, grid.nk, exact_band, 0, grid.nk, nullptr);
+}
+
+/**
+ * @brief fast_sweep_eikonal_kernel over every cell of a batch
+ *
+ * A grid past its own iteration cap only copies its values, so each grid ends up exactly
+ * where the single-grid path would have stopped it.
+ *
+ * @param iteration Index of this iteration (0-based) across the batch
+ */
+__global__ void batch_sweep_kernel(const float* phi_read, float* phi_write,
+                                   const BatchGrid* grids, const size_t* cell_offsets, int num_grids,
+                                   size_t total_cells, int iteration, int* changed, float tolerance) {
+    size_t idx = (size_t)blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= total_cells) return;
+
+    const BatchGrid& grid = grids[batch_find(cell_offsets, num_grids, idx)];
+    float current_phi = phi_read[idx];
+    if (iteration >= grid.max_iterations) {
+        phi_write[idx] = current_phi;
+        return;
+    }
+
+    size_t local = idx - grid.cell_offset;
+    size_t plane = (size_t)grid.ni * grid.nj;
+    int k = (int)(local / plane);
+    int j = (int)((local - k * plane) / grid.ni);
+    int i = (int)(local - k * plane - (size_t)j * grid.ni);
+    float new_phi = jacobi_cell_update(phi_read, idx, i, j, k, grid.ni, grid.nj, grid.nk, grid.dx);
+    phi_write[idx] = new_phi;
+
+    if (changed && current_phi - new_phi > tolerance) {
+        *changed = 1;
+    }
+}
+
+/**
+ * @brief sign_correction_kernel over every (j, k) row of a batch
+ */
+__global__ void batch_sign_kernel(float* phi, const int* intersection_count,
+                                  const BatchGrid* grids, const size_t* row_offsets, int num_grids,
+                                  size_t total_rows) {
+    size_t row = (size_t)blockIdx.x * blockDim.x + threadIdx.x;
+    if (row >= total_rows) return;
+
+    int b = batch_find(row_offsets, num_grids, row);
+    const BatchGrid& grid = grids[b];
+    size_t first = grid.cell_offset + (row - row_offsets[b]) * grid.ni;
+
+    int total_count = 0;
+    for (int i = 0; i < grid.ni; ++i) {
+        total_count += intersection_count[first + i];
+        if (total_count % 2 == 1) {  // Inside mesh
+            phi[first + i] = -phi[first + i];
+        }
+    }
+}
+
+// ============================================================================
+// Kernel 8: Point Queries
+// ============================================================================
+
+/**
+ * @brief point_segment_distance() that also returns the segment parameter of the nearest point
+ * @param s12 Output: the nearest point is s12*x1+(1-s12)*x2
+ */
+__device__ float point_segment_closest(const Vec3f& x0, const Vec3f& x1, const Vec3f& x2, float& s12) {
+    float dx0 = x2.v[0] - x1.v[0];
+    float dx1 = x2.v[1] - x1.v[1];
+    float dx2 = x2.v[2] - x1.v[2];
+    double m2 = dx0*dx0 + dx1*dx1 + dx2*dx2;
+
+    if (m2 < 1e-30) {
+        s12 = 1.0f;
+        return dist(x0, x1);
+    }
+
+    float temp0 = x2.v[0] - x0.v[0];
+    float temp1 = x2.v[1] - x0.v[1];
+    float temp2 = x2.v[2] - x0.v[2];
+
+    s12 = (float)((temp0*dx0 + temp1*dx1 + temp2*dx2) / m2);
+    s12 = fmaxf(0.0f, fminf(1.0f, s12));
+
+    float d0 = x0.v[0] - (s12 * x1.v[0] + (1.0f - s12) * x2.v[0]);
+    float d1 = x0.v[1] - (s12 * x1.v[1] + (1.0f - s12) * x2.v[1]);
+    float d2 = x0.v[2] - (s12 * x1.v[2] + (1.0f - s12) * x2.v[2]);
+    return sqrtf(d0*d0 + d1*d1 + d2*d2);
+}
+
+/**
+ * @brief Barycentric weights of the point of triangle (x1, x2, x3) nearest to x0
+ *
+ * Same case split as point_triangle_distance(); on an edge the opposite corner gets 0 and
+ * ties between the two candidate edges keep the first, like the host version.
+ */
+__device__ void point_triangle_weights(const Vec3f& x0, const Vec3f& x1, const Vec3f& x2, const Vec3f& x3,
+                                       float* w) {
+    float x13_0 = x1.v[0] - x3.v[0], x13_1 = x1.v[1] - x3.v[1], x13_2 = x1.v[2] - x3.v[2];
+    float x23_0 = x2.v[0] - x3.v[0], x23_1 = x2.v[1] - x3.v[1], x23_2 = x2.v[2] - x3.v[2];
+    float x03_0 = x0.v[0] - x3.v[0], x03_1 = x0.v[1] - x3.v[1], x03_2 = x0.v[2] - x3.v[2];
+
+    float m13 = x13_0*x13_0 + x13_1*x13_1 + x13_2*x13_2;
+    float m23 = x23_0*x23_0 + x23_1*x23_1 + x23_2*x23_2;
+    float d = x13_0*x23_0 + x13_1*x23_1 + x13_2*x23_2;
+    float invdet = 1.0f / fmaxf(m13 * m23 - d * d, 1e-30f);
+    float a = x13_0*x03_0 + x13_1*x03_1 + x13_2*x03_2;
+    float b = x23_0*x03_0 + x23_1*x03_1 + x23_2*x03_2;
+
+    float w23 = invdet * (m23 * a - d * b);
+    float w31 = invdet * (m13 * b - d * a);
+    float w12 = 1.0f - w23 - w31;
+    if (w23 >= 0.0f && w31 >= 0.0f && w12 >= 0.0f) {
+        w[0] = w23; w[1] = w31; w[2] = w12;
+        return;
+    }
+
+    // candidate edges as corner pairs (p, q)
+    int p0, q0, p1, q1;
+    if (w23 > 0.0f) { p0 = 0; q0 = 1; p1 = 0; q1 = 2; }
+    else if (w31 > 0.0f) { p0 = 0; q0 = 1; p1 = 1; q1 = 2; }
+    else { p0 = 0; q0 = 2; p1 = 1; q1 = 2; }
+    const Vec3f* corner[3] = {&x1, &x2, &x3};
+    float s0, s1;
+    float d0 = point_segment_closest(x0, *corner[p0], *corner[q0], s0);
+    float d1 = point_segment_closest(x0, *corner[p1], *corner[q1], s1);
+    w[0] = w[1] = w[2] = 0.0f;
+    if (d1 < d0) {
+        w[p1] = s1; w[q1] = 1.0f - s1;
+    } else {
+        w[p0] = s0; w[q0] = 1.0f - s0;
+    }
+}
+
+/**
+ * @brief Squared distance from p to a BVH node's box (TriangleBVH::box_dist2())
+ */
+__device__ float bvh_box_dist2(const Vec3f& p, const BVHNode& node) {
+    float d2 = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        float below = node.bmin.v[axis] - p.v[axis], above = p.v[axis] - node.bmax.v[axis];
+        if (below > 0.0f) d2 += below * below;
+        else if (above > 0.0f) d2 += above * above;
+    }
+    return d2;
+}
+
+/** @brief TriangleBVH::pruned() */
+__device__ bool bvh_pruned(float box_d2, float best_dist) {
+    return box_d2 > best_dist * best_dist * (1.0f + 1e-5f) + 1e-30f;
+}
+
+/**
+ * @brief Crossings of the line through p along axis at or below p (TriangleBVH::crossings_below())
+ */
+__device__ int bvh_crossings_below(const BVHNode* nodes, const Vec3f* corners, const Vec3f& p, int axis) {
+    const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+    int count = 0;
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BVHNode& node = nodes[stack[--top]];
+        if (node.bmin.v[axis] > p.v[axis] || node.bmin.v[u] > p.v[u] || node.bmax.v[u] < p.v[u] ||
+            node.bmin.v[v] > p.v[v] || node.bmax.v[v] < p.v[v]) {
+            continue;
+        }
+        if (node.count == 0) {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+            continue;
+        }
+        for (int n = node.first; n < node.first + node.count; ++n) {
+            const Vec3f& a = corners[3*n];
+            const Vec3f& b = corners[3*n + 1];
+            const Vec3f& c = corners[3*n + 2];
+            double wa, wb, wc;
+            if (point_in_triangle_2d(p.v[u], p.v[v], a.v[u], a.v[v], b.v[u], b.v[v], c.v[u], c.v[v], wa, wb, wc) &&
+                wa * a.v[axis] + wb * b.v[axis] + wc * c.v[axis] <= p.v[axis]) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief One thread per point: nearest triangle through the BVH, then the sign
+ *
+ * Same traversal and tie rule as TriangleBVH::nearest() (nearer child first, lowest
+ * triangle index among equal distances) and the same sign rules as cpu::query_points().
+ *
+ * @param nodes BVH nodes (empty mesh: num_nodes == 0)
+ * @param corners Triangle corners in BVH slot order
+ * @param order Original triangle index of each slot
+ * @param winding Winding-number tree nodes, read with SignMode::WindingNumber only
+ * @param closest_tri Optional output (null to skip)
+ * @param barycentric Optional output, 3 floats per point (null to skip)
+ */
+__global__ void point_query_kernel(const Vec3f* points, int count,
+                                   const BVHNode* nodes, int num_nodes, const Vec3f* corners, const int* order,
+                                   const WindingNode* winding, int num_winding, const Vec3f* winding_corners,
+                                   SignMode sign_mode, float* distance, int* closest_tri, float* barycentric) {
+    int n = blockIdx.x * blockDim.x + threadIdx.x;
+    if (n >= count) return;
+
+    const Vec3f p = points[n];
+    float best = INFINITY;
+    int best_slot = -1;
+    if (num_nodes > 0) {
+        struct Entry { int node; float d2; };
+        Entry stack[64];
+        int top = 0;
+        stack[top++] = Entry{0, bvh_box_dist2(p, nodes[0])};
+        while (top > 0) {
+            Entry e = stack[--top];
+            if (bvh_pruned(e.d2, best)) continue;
+            const BVHNode& node = nodes[e.node];
+            if (node.count > 0) {
+                for (int s = node.first; s < node.first + node.count; ++s) {
+                    float d = gpu::point_triangle_distance(p, corners[3*s], corners[3*s + 1], corners[3*s + 2]);
+                    if (d < best || (d == best && best_slot >= 0 && order[s] < order[best_slot])) {
+                        best = d;
+                        best_slot = s;
+                    }
+                }
+                continue;
+            }
+            float d_left = bvh_box_dist2(p, nodes[node.first]), d_right = bvh_box_dist2(p, nodes[node.first + 1]);
+            if (d_left <= d_right) {
+                if (!bvh_pruned(d_right, best)) stack[top++] = Entry{node.first + 1, d_right};
+                if (!bvh_pruned(d_left, best)) stack[top++] = Entry{node.first, d_left};
+            } else {
+                if (!bvh_pruned(d_left, best)) stack[top++] = Entry{node.first, d_left};
+                if (!bvh_pruned(d_right, best)) stack[top++] = Entry{node.first + 1, d_right};
+            }
+        }
+    }
+
+    bool inside = false;
+    if (num_nodes > 0) {
+        if (sign_mode == SignMode::WindingNumber) {
+            inside = winding_number(winding, num_winding, winding_corners, p.v[0], p.v[1], p.v[2]) >= 0.5f;
+        } else if (sign_mode == SignMode::RayVote) {
+            inside = (bvh_crossings_below(nodes, corners, p, 0) % 2) + (bvh_crossings_below(nodes, corners, p, 1) % 2) +
+                     (bvh_crossings_below(nodes, corners, p, 2) % 2) >= 2;
+        } else {
+            inside = bvh_crossings_below(nodes, corners, p, 0) % 2 == 1;
+        }
+    }
+    distance[n] = inside ? -best : best;
+    if (closest_tri) closest_tri[n] = best_slot >= 0 ? order[best_slot] : -1;
+    if (barycentric) {
+        float w[3] = {0.0f, 0.0f, 0.0f};
+        if (best_slot >= 0) {
+            point_triangle_weights(p, corners[3*best_slot], corners[3*best_slot + 1], corners[3*best_slot + 2], w);
+        }
+        for (int a = 0; a < 3; ++a) barycentric[3*n + a] = w[a];
+    }
+}
+
+// ============================================================================
+// Persistent Device Context
+// ============================================================================
+
+/**
+ * @brief One pooled device allocation; grows on demand, never shrinks until release()
+ */
+struct DeviceBuffer {
+    void* ptr = nullptr;
+    size_t bytes = 0;
+
+    template <class T>
+    T* reserve(size_t count) {
+        size_t needed = count * sizeof(T);
+        if (needed > bytes) {
+            if (ptr) CUDA_CHECK(cudaFree(ptr));
+            ptr = nullptr;
+            CUDA_CHECK(cudaMalloc(&ptr, needed));
+            bytes = needed;
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    // Unchecked: contexts may be destroyed during process teardown, after the CUDA runtime
+    void free() {
+        if (ptr) cudaFree(ptr);
+        ptr = nullptr;
+        bytes = 0;
+    }
+};
+
+struct GpuContext::Impl {
+    DeviceBuffer tri, x, geom;
+    DeviceBuffer dist_tri, intersection_count, phi_read, phi_write;
+    DeviceBuffer bvh_nodes, bvh_corners, bvh_order, winding_nodes, winding_corners;
+    DeviceBuffer query_points, query_distance, query_tri, query_weights;
+    bool mesh_resident = false;     ///< tri/x hold the caller's mesh
+    bool geom_resident = false;     ///< geom holds the triangle table of that mesh
+    bool bvh_resident = false;      ///< bvh_* hold the point-query BVH of that mesh
+    bool winding_resident = false;  ///< winding_* hold its winding-number tree
+
+    DeviceBuffer* buffers[16] = {&tri, &x, &geom, &dist_tri, &intersection_count, &phi_read, &phi_write,
+                                 &bvh_nodes, &bvh_corners, &bvh_order, &winding_nodes, &winding_corners,
+                                 &query_points, &query_distance, &query_tri, &query_weights};
+};
+
+GpuContext::GpuContext() : impl_(new Impl) {}
+
+GpuContext::~GpuContext() { release(); }
+
+void GpuContext::invalidate_mesh() {
+    impl_->mesh_resident = false;
+    impl_->geom_resident = false;
+    impl_->bvh_resident = false;
+    impl_->winding_resident = false;
+}
+
+bool GpuContext::mesh_resident() const { return impl_->mesh_resident; }
+
+void GpuContext::release() {
+    for (DeviceBuffer* b : impl_->buffers) b->free();
+    invalidate_mesh();
+}
+
+size_t GpuContext::device_bytes() const {
+    size_t total = 0;
+    for (const DeviceBuffer* b : impl_->buffers) total += b->bytes;
+    return total;
+}
+
+// ============================================================================
+// Host Orchestrator
+// ============================================================================
+
+/**
+ * @brief Near band through brick binning (GpuNearBandMode::Binned)
+ *
+ * Bins triangles into NEAR_BRICK^3 bricks (count, scan on the host, scatter), runs
+ * brick_near_band_kernel on the occupied bricks and counts ray crossings per triangle.
+ *
+ * @return False, with nothing written, when the binned lists would not fit 32-bit offsets;
+ *         the caller then uses the per-triangle kernel
+ */
+static bool binned_near_band(const Vec3ui* d_tri, const Vec3f* d_x, const float* d_geom,
+                             DistTriPair* d_dist_tri, int* d_intersection_count, int num_triangles,
+                             Vec3f origin, float dx, int ni, int nj, int nk, int exact_band)
+{
+    const int bricks_x = (ni + NEAR_BRICK - 1) / NEAR_BRICK;
+    const int bricks_y = (nj + NEAR_BRICK - 1) / NEAR_BRICK;
+    const int bricks_z = (nk + NEAR_BRICK - 1) / NEAR_BRICK;
+    const int num_bricks = bricks_x * bricks_y * bricks_z;
+
+    int* d_brick_counts;
+    CUDA_CHECK(cudaMalloc(&d_brick_counts, num_bricks * sizeof(int)));
+    CUDA_CHECK(cudaMemset(d_brick_counts, 0, num_bricks * sizeof(int)));
+
+    int blockTri = 256;
+    int gridTri = (num_triangles + blockTri - 1) / blockTri;
+    bin_triangles_kernel<<<gridTri, blockTri>>>(d_tri, d_x, num_triangles, origin, dx, ni, nj, nk, exact_band,
+                                                bricks_x, bricks_y, d_brick_counts, nullptr, nullptr);
+    CUDA_CHECK(cudaGetLastError());
+
+    std::vector<int> counts(num_bricks);
+    CUDA_CHECK(cudaMemcpy(counts.data(), d_brick_counts, num_bricks * sizeof(int), cudaMemcpyDeviceToHost));
+
+    long long total = 0;
+    for (int b = 0; b < num_bricks; ++b) total += counts[b];
+    if (total > INT_MAX) {
+        CUDA_CHECK(cudaFree(d_brick_counts));
+        return false;
+    }
+
+    std::vector<int> offsets(num_bricks + 1);
+    std::vector<int> occupied;
+    offsets[0] = 0;
+    for (int b = 0; b < num_bricks; ++b) {
+        offsets[b + 1] = offsets[b] + counts[b];
+        if (counts[b] > 0) occupied.push_back(b);
+    }
+
+    if (!occupied.empty()) {
+        int* d_brick_offsets;
+        int* d_brick_tris;
+        int* d_occupied;
+        CUDA_CHECK(cudaMalloc(&d_brick_offsets, offsets.size() * sizeof(int)));
+        CUDA_CHECK(cudaMalloc(&d_brick_tris, total * sizeof(int)));
+        CUDA_CHECK(cudaMalloc(&d_occupied, occupied.size() * sizeof(int)));
+        CUDA_CHECK(cudaMemcpy(d_brick_offsets, offsets.data(), offsets.size() * sizeof(int), cudaMemcpyHostToDevice));
+        CUDA_CHECK(cudaMemcpy(d_occupied, occupied.data(), occupied.size() * sizeof(int), cudaMemcpyHostToDevice));
+
+        // Second pass reuses the counters as per-brick cursors
+        CUDA_CHECK(cudaMemset(d_brick_counts, 0, num_bricks * sizeof(int)));
+        bin_triangles_kernel<<<gridTri, blockTri>>>(d_tri, d_x, num_triangles, origin, dx, ni, nj, nk, exact_band,
+                                                    bricks_x, bricks_y, d_brick_counts, d_brick_offsets, d_brick_tris);
+        CUDA_CHECK(cudaGetLastError());
+
+        dim3 blockBrick(NEAR_BRICK, NEAR_BRICK, NEAR_BRICK);
+        brick_near_band_kernel<<<(int)occupied.size(), blockBrick>>>(
+            d_tri, d_x, d_geom, d_dist_tri, d_occupied, d_brick_offsets, d_brick_tris,
+            num_triangles, origin, dx, ni, nj, nk, exact_band, bricks_x, bricks_y);
+        CUDA_CHECK(cudaGetLastError());
+        CUDA_CHECK(cudaStreamSynchronize(cudaStreamPerThread));
+
+        CUDA_CHECK(cudaFree(d_brick_offsets));
+        CUDA_CHECK(cudaFree(d_brick_tris));
+        CUDA_CHECK(cudaFree(d_occupied));
+    }
+    CUDA_CHECK(cudaFree(d_brick_counts));
+
+    triangle_crossings_kernel<<<gridTri, blockTri>>>(d_tri, d_x, d_intersection_count,
+                                                     num_triangles, origin, dx, ni, nj, nk);
+    CUDA_CHECK(cudaGetLastError());
+    CUDA_CHECK(cudaStreamSynchronize(cudaStreamPerThread));
+    return true;
+}
+
+/**
+ * @brief Device and pinned host buffers of one in-flight slab
+ *
+ * work holds the slab's DistTriPair array (layers + 2 planes) during the near band and the
+ * two float phi buffers with halos during the sweeps.
  */
-__global__ void sign_correction_kernel(float* phi, const int* intersection_count,
-                                      int ni, int nj, int nk) {
-    int j = blockIdx.x * blockDim.x + threadIdx.x;
-    int k = blockIdx.y * blockDim.y + threadIdx.y;
+struct SlabSlot {
+    cudaStream_t stream = nullptr;
+    void* work = nullptr;
+    int* intersection_count = nullptr;
+    unsigned char* inside = nullptr;
+    int* changed = nullptr;
+    float* staging = nullptr;           ///< Pinned: layers + 2 planes of phi
+    unsigned char* inside_staging = nullptr; ///< Pinned: layers planes of flags
+    int* changed_host = nullptr;        ///< Pinned: the two change flags
+    int pending = -1;                   ///< Slab whose download into staging is in flight
+    const float* final_phi = nullptr;   ///< Device result of the last slab swept in this slot
+};
 
-    if (j >= nj || k >= nk) return;
+/** @brief Device bytes per grid plane and slab layer used by the streamed mode (both slots) */
+static size_t streamed_bytes_per_layer(int ni, int nj) {
+    return 2 * (size_t)ni * nj * (sizeof(DistTriPair) + sizeof(int) + sizeof(unsigned char));
+}
 
-    int total_count = 0;
-    for (int i = 0; i < ni; ++i) {
-        int idx = grid_index(i, j, k, ni, nj);
-        total_count += intersection_count[idx];
+/**
+ * @brief Generate the field in z-slabs for grids that do not fit in device memory
+ *
+ * Phase 1 runs the near band and the inside/outside parity slab by slab on two streams, so
+ * one slab's download overlaps the next slab's kernels; the unsigned distances and the
+ * inside flags are assembled on the host. Phase 2 is a block Gauss-Seidel over slabs: each
+ * dirty slab is uploaded with one halo plane per side, Jacobi-iterated to convergence with
+ * the halos fixed, and downloaded while the next one runs. A slab that changed marks its two
+ * neighbours dirty; a halo taken from the slab just swept is copied device to device so the
+ * pipeline does not wait for the download. Iteration stops when no slab is dirty, which is a
+ * fixed point of the same update as the in-core sweep. Phase 3 applies the signs on the host.
+ *
+ * @param layers Planes per slab, from the device memory budget
+ * @param winding Uploaded tree for SignMode::WindingNumber, or null for the crossing parity
+ */
+static void streamed_level_set3(const Vec3ui* d_tri, const Vec3f* d_x, const float* d_geom,
+                                size_t num_triangles, const Vec3f& origin, float dx,
+                                int ni, int nj, int nk, int layers, const DeviceWindingTree* winding,
+                                Array3f& phi, const GenerationOptions& options, GenerationStats* stats)
+{
+    const size_t plane = (size_t)ni * nj;
+    const int num_slabs = (nk + layers - 1) / layers;
+    const float max_dist = (ni + nj + nk) * dx;
 
-        if (total_count % 2 == 1) {  // Inside mesh
-            phi[idx] = -phi[idx];
+    phi.resize(ni, nj, nk);
+    std::vector<unsigned char> inside((size_t)ni * nj * nk);
+
+    SlabSlot slots[2];
+    for (SlabSlot& slot : slots) {
+        CUDA_CHECK(cudaStreamCreate(&slot.stream));
+        CUDA_CHECK(cudaMalloc(&slot.work, (layers + 2) * plane * sizeof(DistTriPair)));
+        CUDA_CHECK(cudaMalloc(&slot.intersection_count, layers * plane * sizeof(int)));
+        CUDA_CHECK(cudaMalloc(&slot.inside, layers * plane));
+        CUDA_CHECK(cudaMalloc(&slot.changed, 2 * sizeof(int)));
+        CUDA_CHECK(cudaMallocHost(&slot.staging, (layers + 2) * plane * sizeof(float)));
+        CUDA_CHECK(cudaMallocHost(&slot.inside_staging, layers * plane));
+        CUDA_CHECK(cudaMallocHost(&slot.changed_host, 2 * sizeof(int)));
+    }
+
+    auto slab_begin = [&](int slab) { return slab * layers; };
+    auto slab_layers = [&](int slab) { return std::min(layers, nk - slab * layers); };
+
+    // --- Phase 1: near band and inside flags ---
+    GenerationStats band_stats;
+    auto finish_near_band = [&](SlabSlot& slot) {
+        if (slot.pending < 0) return;
+        CUDA_CHECK(cudaStreamSynchronize(slot.stream));
+        size_t offset = slab_begin(slot.pending) * plane;
+        size_t cells = slab_layers(slot.pending) * plane;
+        std::memcpy(&phi.a[offset], slot.staging, cells * sizeof(float));
+        std::memcpy(&inside[offset], slot.inside_staging, cells);
+        slot.pending = -1;
+    };
+
+    for (int slab = 0; slab < num_slabs && !generation_cancelled(options); ++slab) {
+        SlabSlot& slot = slots[slab % 2];
+        finish_near_band(slot);
+        const int k0 = slab_begin(slab), count = slab_layers(slab);
+        const size_t cells = count * plane;
+        DistTriPair* d_dist_tri = static_cast<DistTriPair*>(slot.work);
+
+        dim3 blockInit(8, 8, 8);
+        dim3 gridInit((ni + 7) / 8, (nj + 7) / 8, (count + 7) / 8);
+        initialize_grids_kernel<<<gridInit, blockInit, 0, slot.stream>>>(
+            d_dist_tri, slot.intersection_count, ni, nj, count, max_dist);
+        CUDA_CHECK(cudaGetLastError());
+        if (num_triangles > 0) {
+            int gridNear = (int)((num_triangles + 255) / 256);
+            near_band_distance_kernel<<<gridNear, 256, 0, slot.stream>>>(
+                d_tri, d_x, d_geom, d_dist_tri, slot.intersection_count, (int)num_triangles,
+                origin, dx, ni, nj, nk, options.exact_band, k0, count, nullptr);
+            CUDA_CHECK(cudaGetLastError());
+        }
+        // Diagnostics are reduced per slab and merged (synchronous, only when requested)
+        if (stats && options.diagnostics) {
+            CUDA_CHECK(cudaStreamSynchronize(slot.stream));
+            GenerationStats slab_stats;
+            gather_near_band_stats(d_dist_tri, slot.intersection_count, cells, slab_stats);
+            merge_near_band_stats(band_stats, slab_stats);
+        }
+
+        if (winding) {
+            winding->crossings(d_dist_tri, slot.intersection_count, origin, dx, ni, nj, count, k0, slot.stream);
+        }
+        if (options.sign_mode == SignMode::RayVote) {
+            // slot.inside is rewritten from the toggles right after, so it holds the votes meanwhile
+            ray_vote_crossings(d_tri, d_x, (int)num_triangles, slot.intersection_count, slot.inside, origin, dx,
+                               ni, nj, nk, count, k0, slot.stream);
+        }
+        dim3 blockSign(16, 16);
+        dim3 gridSign((nj + 15) / 16, (count + 15) / 16);
+        inside_flags_kernel<<<gridSign, blockSign, 0, slot.stream>>>(slot.intersection_count, slot.inside, ni, nj, count);
+        CUDA_CHECK(cudaGetLastError());
+
+        // Distances straight out of the pairs into pinned memory
+        CUDA_CHECK(cudaMemcpy2DAsync(slot.staging, sizeof(float), d_dist_tri, sizeof(DistTriPair),
+                                     sizeof(float), cells, cudaMemcpyDeviceToHost, slot.stream));
+        CUDA_CHECK(cudaMemcpyAsync(slot.inside_staging, slot.inside, cells, cudaMemcpyDeviceToHost, slot.stream));
+        slot.pending = slab;
+    }
+    for (SlabSlot& slot : slots) finish_near_band(slot);
+
+    if (stats && options.diagnostics) {
+        stats->near_band_cells = band_stats.near_band_cells;
+        stats->near_band_min = band_stats.near_band_min;
+        stats->near_band_max = band_stats.near_band_max;
+        stats->intersections = band_stats.intersections;
+        stats->diagnostics_valid = true;
+    }
+
+    // --- Phase 2: slab Gauss-Seidel over the far field ---
+    auto finish_sweep = [&](SlabSlot& slot) {
+        if (slot.pending < 0) return;
+        CUDA_CHECK(cudaStreamSynchronize(slot.stream));
+        std::memcpy(&phi.a[slab_begin(slot.pending) * plane], slot.staging,
+                    slab_layers(slot.pending) * plane * sizeof(float));
+        slot.pending = -1;
+    };
+
+    const int check_interval = options.sweep_check_interval > 0 ? options.sweep_check_interval : 16;
+    const int max_passes = std::max(ni, std::max(nj, nk)) * 2;
+    std::vector<char> dirty(num_slabs, 1);
+    int iterations = 0;
+    int passes = 0;
+    int previous_slab = -1;
+    SlabSlot* previous_slot = nullptr;
+    int next_slot = 0;
+    bool any_dirty = true;
+
+    while (any_dirty && passes < max_passes && !generation_cancelled(options)) {
+        const bool upward = passes % 2 == 0;
+        for (int n = 0; n < num_slabs && !generation_cancelled(options); ++n) {
+            const int slab = upward ? n : num_slabs - 1 - n;
+            if (!dirty[slab]) continue;
+            dirty[slab] = 0;
+
+            SlabSlot& slot = slots[next_slot];
+            next_slot = 1 - next_slot;
+            finish_sweep(slot);
+
+            const int k0 = slab_begin(slab), count = slab_layers(slab);
+            float* d_read = static_cast<float*>(slot.work);
+            float* d_write = d_read + (layers + 2) * plane;
+
+            // Stage halo + interior + halo from the host field
+            if (k0 > 0) {
+                std::memcpy(slot.staging, &phi.a[(k0 - 1) * plane], plane * sizeof(float));
+            } else {
+                std::fill(slot.staging, slot.staging + plane, FLT_MAX);
+            }
+            std::memcpy(slot.staging + plane, &phi.a[k0 * plane], count * plane * sizeof(float));
+            if (k0 + count < nk) {
+                std::memcpy(slot.staging + (count + 1) * plane, &phi.a[(k0 + count) * plane], plane * sizeof(float));
+            } else {
+                std::fill(slot.staging + (count + 1) * plane, slot.staging + (count + 2) * plane, FLT_MAX);
+            }
+            const size_t buffer_bytes = (count + 2) * plane * sizeof(float);
+            CUDA_CHECK(cudaMemcpyAsync(d_read, slot.staging, buffer_bytes, cudaMemcpyHostToDevice, slot.stream));
+
+            // The slab just swept may still be downloading; take its boundary plane on the device
+            if (previous_slot && previous_slab == slab - 1) {
+                int prev_count = slab_layers(previous_slab);
+                CUDA_CHECK(cudaMemcpyAsync(d_read, previous_slot->final_phi + prev_count * plane,
+                                           plane * sizeof(float), cudaMemcpyDeviceToDevice, slot.stream));
+            } else if (previous_slot && previous_slab == slab + 1) {
+                CUDA_CHECK(cudaMemcpyAsync(d_read + (count + 1) * plane, previous_slot->final_phi + plane,
+                                           plane * sizeof(float), cudaMemcpyDeviceToDevice, slot.stream));
+            }
+            CUDA_CHECK(cudaMemcpyAsync(d_write, d_read, buffer_bytes, cudaMemcpyDeviceToDevice, slot.stream));
+            CUDA_CHECK(cudaMemsetAsync(slot.changed, 0, 2 * sizeof(int), slot.stream));
+
+            dim3 blockSweep(8, 8, 8);
+            dim3 gridSweep((ni + 7) / 8, (nj + 7) / 8, (count + 7) / 8);
+            const int max_iterations = std::max(ni, std::max(nj, count)) * 2;
+            bool converged = false;
+            for (int iter = 1; iter <= max_iterations; ++iter) {
+                slab_sweep_kernel<<<gridSweep, blockSweep, 0, slot.stream>>>(
+                    d_read, d_write, dx, ni, nj, count, slot.changed, options.sweep_tolerance);
+                CUDA_CHECK(cudaGetLastError());
+                std::swap(d_read, d_write);
+                ++iterations;
+
+                if (iter % check_interval == 0 || iter == max_iterations) {
+                    CUDA_CHECK(cudaMemcpyAsync(slot.changed_host, slot.changed, 2 * sizeof(int),
+                                               cudaMemcpyDeviceToHost, slot.stream));
+                    CUDA_CHECK(cudaStreamSynchronize(slot.stream));
+                    if (!slot.changed_host[1]) {
+                        converged = true;
+                        break;
+                    }
+                    CUDA_CHECK(cudaMemsetAsync(slot.changed + 1, 0, sizeof(int), slot.stream));
+                }
+            }
+
+            // Changed boundary values must reach the neighbours; an unconverged slab retries itself
+            if (slot.changed_host[0]) {
+                if (slab > 0) dirty[slab - 1] = 1;
+                if (slab < num_slabs - 1) dirty[slab + 1] = 1;
+            }
+            if (!converged) dirty[slab] = 1;
+
+            CUDA_CHECK(cudaMemcpyAsync(slot.staging, d_read + plane, count * plane * sizeof(float),
+                                       cudaMemcpyDeviceToHost, slot.stream));
+            slot.final_phi = d_read;
+            slot.pending = slab;
+            previous_slot = &slot;
+            previous_slab = slab;
         }
+        ++passes;
+        any_dirty = std::find(dirty.begin(), dirty.end(), 1) != dirty.end();
+    }
+    for (SlabSlot& slot : slots) finish_sweep(slot);
+
+    if (stats) {
+        stats->sweep_iterations = iterations;
+        stats->sweep_converged = !any_dirty;
+        stats->gpu_slabs = num_slabs;
+    }
+
+    // --- Phase 3: signs ---
+    for (size_t n = 0; n < inside.size(); ++n) {
+        if (inside[n]) phi.a[n] = -phi.a[n];
+    }
+
+    for (SlabSlot& slot : slots) {
+        CUDA_CHECK(cudaStreamDestroy(slot.stream));
+        CUDA_CHECK(cudaFree(slot.work));
+        CUDA_CHECK(cudaFree(slot.intersection_count));
+        CUDA_CHECK(cudaFree(slot.inside));
+        CUDA_CHECK(cudaFree(slot.changed));
+        CUDA_CHECK(cudaFreeHost(slot.staging));
+        CUDA_CHECK(cudaFreeHost(slot.inside_staging));
+        CUDA_CHECK(cudaFreeHost(slot.changed_host));
     }
 }
 
-// ============================================================================
-// Host Orchestrator
-// ============================================================================
+/**
+ * @brief One device's share of a multi-GPU generation: planes k0..k0+count-1 plus halos
+ */
+struct DeviceShare {
+    int device = 0;
+    int k0 = 0, count = 0;
+    cudaStream_t stream = nullptr;
+    std::vector<Vec3ui> tri;            ///< Triangles whose near band reaches the share
+    Vec3ui* d_tri = nullptr;
+    Vec3f* d_x = nullptr;
+    float* d_geom = nullptr;
+    DistTriPair* dist_tri = nullptr;    ///< count planes
+    int* intersection_count = nullptr;  ///< count planes
+    float* phi[2] = {nullptr, nullptr}; ///< count + 2 planes each; phi[current] is the latest
+    int current = 0;
+    int* changed = nullptr;
+    int* changed_host = nullptr;        ///< Pinned
+};
+
+/** @brief Make device the current one for a scope, restoring the previous device afterwards */
+struct ScopedDevice {
+    int previous = 0;
+    explicit ScopedDevice(int device) {
+        CUDA_CHECK(cudaGetDevice(&previous));
+        CUDA_CHECK(cudaSetDevice(device));
+    }
+    ~ScopedDevice() { cudaSetDevice(previous); }
+};
+
+/**
+ * @brief Generate the field with the grid split along z across several devices
+ *
+ * Each device owns a contiguous range of planes and receives only the triangles whose near-band
+ * box reaches it (one plane of margin), so the near band and the ray crossings of every share
+ * are complete without communication; the crossings of a row never leave the share because
+ * rows run along x. The far field is a block Jacobi iteration: every round each device runs
+ * sweep_check_interval slab_sweep_kernel iterations with its halo planes fixed, then the
+ * boundary planes are exchanged with cudaMemcpyPeerAsync (direct when peer access could be
+ * enabled, staged through the host by the runtime otherwise). Iteration stops after a round in
+ * which no device changed a cell, which is a fixed point of the same update as the in-core
+ * sweep. Each share then applies its signs and is copied into phi.
+ *
+ * @param devices CUDA device ordinals, one share each (only the first nk are used)
+ * @throws std::runtime_error if a device ordinal is invalid or a share does not fit its device
+ */
+static void multi_device_level_set3(const std::vector<Vec3ui>& tri, const std::vector<Vec3f>& x,
+                                    const Vec3f& origin, float dx, int ni, int nj, int nk,
+                                    const std::vector<int>& devices, Array3f& phi,
+                                    const GenerationOptions& options, GenerationStats* stats)
+{
+    int device_count = 0;
+    CUDA_CHECK(cudaGetDeviceCount(&device_count));
+    for (int device : devices) {
+        if (device < 0 || device >= device_count) {
+            throw std::runtime_error("Invalid CUDA device " + std::to_string(device));
+        }
+    }
+
+    const size_t plane = (size_t)ni * nj;
+    const int num_shares = std::min((int)devices.size(), nk);
+    const int exact_band = options.exact_band;
+    const float max_dist = (ni + nj + nk) * dx;
+    const std::vector<float> far_plane(plane, FLT_MAX);
+
+    // Even split of the planes; the first nk % num_shares shares take one extra
+    std::vector<DeviceShare> shares(num_shares);
+    for (int s = 0, k0 = 0; s < num_shares; ++s) {
+        DeviceShare& share = shares[s];
+        share.device = devices[s];
+        share.k0 = k0;
+        share.count = nk / num_shares + (s < nk % num_shares ? 1 : 0);
+        k0 += share.count;
+    }
+
+    // Triangles per share, culled with the near_band_box() formula widened by one plane. Ray
+    // votes keep every triangle: z rays reach a share through the planes below it.
+    const bool all_triangles = options.sign_mode == SignMode::RayVote;
+    for (const Vec3ui& t : tri) {
+        double f[3];
+        for (int c = 0; c < 3; ++c) f[c] = ((double)x[t[c]][2] - origin[2]) / dx;
+        int k_lo = (int)std::min(f[0], std::min(f[1], f[2])) - exact_band - 1;
+        int k_hi = (int)std::max(f[0], std::max(f[1], f[2])) + exact_band + 2;
+        for (DeviceShare& share : shares) {
+            if (all_triangles || (k_hi >= share.k0 && k_lo < share.k0 + share.count)) share.tri.push_back(t);
+        }
+    }
+
+    // Peer access between neighbouring shares where the topology allows it
+    for (int s = 0; s + 1 < num_shares; ++s) {
+        for (int pair = 0; pair < 2; ++pair) {
+            int device = shares[s + pair].device, peer = shares[s + 1 - pair].device;
+            if (device == peer) continue;
+            int can_access = 0;
+            CUDA_CHECK(cudaDeviceCanAccessPeer(&can_access, device, peer));
+            if (!can_access) continue;
+            ScopedDevice scope(device);
+            cudaError_t err = cudaDeviceEnablePeerAccess(peer, 0);
+            if (err == cudaErrorPeerAccessAlreadyEnabled) {
+                cudaGetLastError(); // clear the sticky "already enabled" status
+            } else {
+                CUDA_CHECK(err);
+            }
+        }
+    }
+
+    // Every share must fit before anything is allocated
+    for (const DeviceShare& share : shares) {
+        ScopedDevice scope(share.device);
+        const size_t share_bytes = share.tri.size() * sizeof(Vec3ui) + x.size() * sizeof(Vec3f) +
+                                   (options.triangle_table ? GEOMETRY_FIELDS * share.tri.size() * sizeof(float) : 0) +
+                                   share.count * plane * (sizeof(DistTriPair) + sizeof(int)) +
+                                   2 * (share.count + 2) * plane * sizeof(float);
+        size_t free_bytes = 0, total_bytes = 0;
+        CUDA_CHECK(cudaMemGetInfo(&free_bytes, &total_bytes));
+        size_t budget = options.gpu_memory_limit > 0 ? std::min(free_bytes, options.gpu_memory_limit) : free_bytes;
+        if (share_bytes > budget / 10 * 9) {
+            throw std::runtime_error("Grid share too large for CUDA device " + std::to_string(share.device));
+        }
+    }
+
+    // --- Allocation, upload and near band, launched on all devices before waiting on any ---
+    for (DeviceShare& share : shares) {
+        ScopedDevice scope(share.device);
+        const size_t cells = share.count * plane;
+        CUDA_CHECK(cudaStreamCreate(&share.stream));
+        CUDA_CHECK(cudaMalloc(&share.d_tri, std::max<size_t>(share.tri.size(), 1) * sizeof(Vec3ui)));
+        CUDA_CHECK(cudaMalloc(&share.d_x, std::max<size_t>(x.size(), 1) * sizeof(Vec3f)));
+        CUDA_CHECK(cudaMalloc(&share.dist_tri, cells * sizeof(DistTriPair)));
+        CUDA_CHECK(cudaMalloc(&share.intersection_count, cells * sizeof(int)));
+        for (float*& buffer : share.phi) CUDA_CHECK(cudaMalloc(&buffer, (share.count + 2) * plane * sizeof(float)));
+        CUDA_CHECK(cudaMalloc(&share.changed, 2 * sizeof(int)));
+        CUDA_CHECK(cudaMallocHost(&share.changed_host, 2 * sizeof(int)));
+
+        const int num_triangles = (int)share.tri.size();
+        CUDA_CHECK(cudaMemcpy(share.d_tri, share.tri.data(), num_triangles * sizeof(Vec3ui), cudaMemcpyHostToDevice));
+        CUDA_CHECK(cudaMemcpy(share.d_x, x.data(), x.size() * sizeof(Vec3f), cudaMemcpyHostToDevice));
+        if (options.triangle_table && num_triangles > 0) {
+            TriangleTable table(share.tri, x);
+            std::vector<float> rows(GEOMETRY_FIELDS * (size_t)num_triangles);
+            for (int t = 0; t < num_triangles; ++t) {
+                const float* record = reinterpret_cast<const float*>(&table[t]);
+                for (int c = 0; c < GEOMETRY_FIELDS; ++c) rows[(size_t)c * num_triangles + t] = record[c];
+            }
+            CUDA_CHECK(cudaMalloc(&share.d_geom, rows.size() * sizeof(float)));
+            CUDA_CHECK(cudaMemcpy(share.d_geom, rows.data(), rows.size() * sizeof(float), cudaMemcpyHostToDevice));
+        }
+
+        dim3 blockInit(8, 8, 8);
+        dim3 gridInit((ni + 7) / 8, (nj + 7) / 8, (share.count + 7) / 8);
+        initialize_grids_kernel<<<gridInit, blockInit, 0, share.stream>>>(
+            share.dist_tri, share.intersection_count, ni, nj, share.count, max_dist);
+        CUDA_CHECK(cudaGetLastError());
+        if (num_triangles > 0) {
+            int gridNear = (num_triangles + 255) / 256;
+            near_band_distance_kernel<<<gridNear, 256, 0, share.stream>>>(
+                share.d_tri, share.d_x, share.d_geom, share.dist_tri, share.intersection_count, num_triangles,
+                origin, dx, ni, nj, nk, exact_band, share.k0, share.count, nullptr);
+            CUDA_CHECK(cudaGetLastError());
+        }
+
+        // Interior from the pairs; halos outside the grid act as missing neighbours
+        for (float* buffer : share.phi) {
+            CUDA_CHECK(cudaMemcpy2DAsync(buffer + plane, sizeof(float), share.dist_tri, sizeof(DistTriPair),
+                                         sizeof(float), cells, cudaMemcpyDeviceToDevice, share.stream));
+            if (share.k0 == 0) {
+                CUDA_CHECK(cudaMemcpyAsync(buffer, far_plane.data(), plane * sizeof(float),
+                                           cudaMemcpyHostToDevice, share.stream));
+            }
+            if (share.k0 + share.count == nk) {
+                CUDA_CHECK(cudaMemcpyAsync(buffer + (share.count + 1) * plane, far_plane.data(),
+                                           plane * sizeof(float), cudaMemcpyHostToDevice, share.stream));
+            }
+        }
+    }
+
+    GenerationStats band_stats;
+    for (DeviceShare& share : shares) {
+        ScopedDevice scope(share.device);
+        CUDA_CHECK(cudaStreamSynchronize(share.stream));
+        if (stats && options.diagnostics) {
+            GenerationStats share_stats;
+            gather_near_band_stats(share.dist_tri, share.intersection_count, share.count * plane, share_stats);
+            merge_near_band_stats(band_stats, share_stats);
+        }
+    }
+    if (stats && options.diagnostics) {
+        stats->near_band_cells = band_stats.near_band_cells;
+        stats->near_band_min = band_stats.near_band_min;
+        stats->near_band_max = band_stats.near_band_max;
+        stats->intersections = band_stats.intersections;
+        stats->diagnostics_valid = true;
+    }
+
+    // --- Far field: block Jacobi rounds with halo exchange ---
+    const int check_interval = options.sweep_check_interval > 0 ? options.sweep_check_interval : 16;
+    const int max_iterations = std::max(ni, std::max(nj, nk)) * 2 + num_shares * check_interval;
+    int iterations = 0;
+    bool converged = false;
+
+    while (iterations < max_iterations && !generation_cancelled(options)) {
+        // Halos from the neighbours' latest interior planes, into both buffers
+        for (int s = 0; s < num_shares; ++s) {
+            DeviceShare& share = shares[s];
+            ScopedDevice scope(share.device);
+            for (float* buffer : share.phi) {
+                if (s > 0) {
+                    const DeviceShare& below = shares[s - 1];
+                    CUDA_CHECK(cudaMemcpyPeerAsync(buffer, share.device,
+                                                   below.phi[below.current] + below.count * plane, below.device,
+                                                   plane * sizeof(float), share.stream));
+                }
+                if (s + 1 < num_shares) {
+                    const DeviceShare& above = shares[s + 1];
+                    CUDA_CHECK(cudaMemcpyPeerAsync(buffer + (share.count + 1) * plane, share.device,
+                                                   above.phi[above.current] + plane, above.device,
+                                                   plane * sizeof(float), share.stream));
+                }
+            }
+        }
+        // No share may overwrite an interior plane before its neighbours have read it
+        for (DeviceShare& share : shares) {
+            ScopedDevice scope(share.device);
+            CUDA_CHECK(cudaStreamSynchronize(share.stream));
+        }
+
+        const int round = std::min(check_interval, max_iterations - iterations);
+        for (DeviceShare& share : shares) {
+            ScopedDevice scope(share.device);
+            CUDA_CHECK(cudaMemsetAsync(share.changed, 0, 2 * sizeof(int), share.stream));
+            dim3 blockSweep(8, 8, 8);
+            dim3 gridSweep((ni + 7) / 8, (nj + 7) / 8, (share.count + 7) / 8);
+            for (int iter = 0; iter < round; ++iter) {
+                slab_sweep_kernel<<<gridSweep, blockSweep, 0, share.stream>>>(
+                    share.phi[share.current], share.phi[1 - share.current], dx, ni, nj, share.count,
+                    share.changed, options.sweep_tolerance);
+                CUDA_CHECK(cudaGetLastError());
+                share.current = 1 - share.current;
+            }
+            CUDA_CHECK(cudaMemcpyAsync(share.changed_host, share.changed, 2 * sizeof(int),
+                                       cudaMemcpyDeviceToHost, share.stream));
+        }
+        iterations += round;
+
+        bool changed = false;
+        for (DeviceShare& share : shares) {
+            ScopedDevice scope(share.device);
+            CUDA_CHECK(cudaStreamSynchronize(share.stream));
+            changed |= share.changed_host[0] != 0;
+        }
+        if (!changed) {
+            converged = true;
+            break;
+        }
+    }
+
+    if (stats) {
+        stats->sweep_iterations = iterations;
+        stats->sweep_converged = converged;
+        stats->gpu_devices = num_shares;
+    }
+
+    // --- Signs and download ---
+    // Winding-number signs: every share evaluates its own rows against a copy of the tree
+    std::vector<std::unique_ptr<DeviceWindingTree>> winding(shares.size());
+    if (options.sign_mode == SignMode::WindingNumber) {
+        WindingNumberTree tree(tri, x);
+        for (size_t s = 0; s < shares.size(); ++s) {
+            DeviceShare& share = shares[s];
+            ScopedDevice scope(share.device);
+            winding[s].reset(new DeviceWindingTree);
+            winding[s]->upload(tree);
+            winding[s]->crossings(share.dist_tri, share.intersection_count, origin, dx, ni, nj, share.count,
+                                  share.k0, share.stream);
+        }
+    }
+    // Ray votes: the idle phi buffer holds the vote bytes
+    if (options.sign_mode == SignMode::RayVote) {
+        for (DeviceShare& share : shares) {
+            ScopedDevice scope(share.device);
+            ray_vote_crossings(share.d_tri, share.d_x, (int)share.tri.size(), share.intersection_count,
+                               reinterpret_cast<unsigned char*>(share.phi[1 - share.current]), origin, dx,
+                               ni, nj, nk, share.count, share.k0, share.stream);
+        }
+    }
+    phi.resize(ni, nj, nk);
+    for (DeviceShare& share : shares) {
+        ScopedDevice scope(share.device);
+        float* interior = share.phi[share.current] + plane;
+        dim3 blockSign(16, 16);
+        dim3 gridSign((nj + 15) / 16, (share.count + 15) / 16);
+        sign_correction_kernel<<<gridSign, blockSign, 0, share.stream>>>(interior, share.intersection_count,
+                                                                        ni, nj, share.count);
+        CUDA_CHECK(cudaGetLastError());
+        CUDA_CHECK(cudaMemcpyAsync(&phi.a[share.k0 * plane], interior, share.count * plane * sizeof(float),
+                                   cudaMemcpyDeviceToHost, share.stream));
+    }
+    for (DeviceShare& share : shares) {
+        ScopedDevice scope(share.device);
+        CUDA_CHECK(cudaStreamSynchronize(share.stream));
+        CUDA_CHECK(cudaStreamDestroy(share.stream));
+        CUDA_CHECK(cudaFree(share.d_tri));
+        CUDA_CHECK(cudaFree(share.d_x));
+        if (share.d_geom) CUDA_CHECK(cudaFree(share.d_geom));
+        CUDA_CHECK(cudaFree(share.dist_tri));
+        CUDA_CHECK(cudaFree(share.intersection_count));
+        for (float* buffer : share.phi) CUDA_CHECK(cudaFree(buffer));
+        CUDA_CHECK(cudaFree(share.changed));
+        CUDA_CHECK(cudaFreeHost(share.changed_host));
+    }
+    for (size_t s = 0; s < shares.size(); ++s) {
+        if (!winding[s]) continue;
+        ScopedDevice scope(shares[s].device);
+        if (stats) stats->winding_evaluations += winding[s]->evaluations();
+        winding[s].reset();
+    }
+}
 
 void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
                      const Vec3f &origin, float dx, int ni, int nj, int nk,
                      Array3f &phi, const int exact_band)
 {
-    // Get device info
+    GenerationOptions options;
+    options.exact_band = exact_band;
+    make_level_set3(tri, x, origin, dx, ni, nj, nk, phi, options);
+}
+
+/**
+ * @brief Isosurface wanted by make_level_set3_mesh(), extracted before the field leaves the device
+ */
+struct IsosurfaceRequest {
+    float isolevel;
+    std::vector<Vec3f>* vertices;
+    std::vector<Vec3ui>* triangles;
+    bool copy_phi;  ///< Also copy the field to the host
+};
+
+/**
+ * @brief Extract a requested isosurface from a field the streamed or multi-device path left on the host
+ */
+static void extract_from_host(const IsosurfaceRequest* surface, const Array3f& phi, const Vec3f& origin, float dx,
+                              const GenerationOptions& options) {
+    if (!surface || generation_cancelled(options)) return;
+    marching_cubes(phi, origin, Vec3f(dx, dx, dx), surface->isolevel, *surface->vertices, *surface->triangles);
+}
+
+/**
+ * @brief make_level_set3() with an optional isosurface taken from the device-resident field
+ */
+static void level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                       const Vec3f &origin, float dx, int ni, int nj, int nk,
+                       Array3f &phi, const GenerationOptions &options, GenerationStats *stats,
+                       GpuContext *context, const IsosurfaceRequest *surface)
+{
+    // Morton-sorted copy of the mesh: neighbouring near-band threads then write nearby cells.
+    // Only phi leaves this function, so the triangle numbering does not show in the result.
+    if (options.spatial_reorder && tri.size() > 1) {
+        SpatialOrder order;
+        spatial_reorder(tri, x, origin, dx, ni, nj, nk, order, options.num_threads);
+        GenerationOptions sorted_options = options;
+        sorted_options.spatial_reorder = false;
+        level_set3(order.tri, order.x, origin, dx, ni, nj, nk, phi, sorted_options, stats, context, surface);
+        return;
+    }
+
+    const int exact_band = options.exact_band;
+
+    if (options.gpu_devices.size() > 1) {
+        multi_device_level_set3(tri, x, origin, dx, ni, nj, nk, options.gpu_devices, phi, options, stats);
+        extract_from_host(surface, phi, origin, dx, options);
+        return;
+    }
+
+    // A single listed device replaces the current one for this call
     int device;
     CUDA_CHECK(cudaGetDevice(&device));
+    if (!options.gpu_devices.empty()) {
+        int device_count = 0;
+        CUDA_CHECK(cudaGetDeviceCount(&device_count));
+        device = options.gpu_devices[0];
+        if (device < 0 || device >= device_count) {
+            throw std::runtime_error("Invalid CUDA device " + std::to_string(device));
+        }
+    }
+    ScopedDevice scope(device);
     cudaDeviceProp props;
     CUDA_CHECK(cudaGetDeviceProperties(&props, device));
-    // std::cout << "GPU: " << props.name << " (Compute " << props.major << "." << props.minor << ")" << std::endl;
+    if (stats) stats->gpu_devices = 1;
+    // Phases end on a device sync only when someone is watching
+    const bool timed = stats || options.phase_hook;
+    PhaseTimer timer(options, stats);
+    timer.begin(GenerationPhase::Setup);
+
+    // Without a caller context a local one gives the old allocate-per-call behaviour
+    GpuContext local_context;
+    GpuContext::Impl& cache = (context ? *context : local_context).impl();
 
     const size_t num_grid_cells = (size_t)ni * nj * nk;
     const size_t num_triangles = tri.size();
     const size_t num_vertices = x.size();
 
-    // std::cout << "Grid: " << ni << "x" << nj << "x" << nk << " = " << num_grid_cells << " cells" << std::endl;
-    // std::cout << "Mesh: " << num_vertices << " vertices, " << num_triangles << " triangles" << std::endl;
+    // Device memory from the context pool (reallocated only when a buffer must grow)
+    Vec3ui* d_tri = cache.tri.reserve<Vec3ui>(num_triangles);
+    Vec3f* d_x = cache.x.reserve<Vec3f>(num_vertices);
+
+    // Host to device copy, skipped while the context holds this mesh
+    size_t uploaded = 0;
+    if (!cache.mesh_resident) {
+        CUDA_CHECK(cudaMemcpy(d_tri, tri.data(), num_triangles * sizeof(Vec3ui), cudaMemcpyHostToDevice));
+        CUDA_CHECK(cudaMemcpy(d_x, x.data(), num_vertices * sizeof(Vec3f), cudaMemcpyHostToDevice));
+        uploaded += num_triangles * sizeof(Vec3ui) + num_vertices * sizeof(Vec3f);
+        cache.mesh_resident = true;
+        cache.geom_resident = false;
+    }
 
-    // Allocate device memory
-    Vec3ui* d_tri;
-    Vec3f* d_x;
-    DistTriPair* d_dist_tri;
-    int* d_intersection_count;
-    float* d_phi_read;
-    float* d_phi_write;
-    int* d_closest_tri_read;
-    int* d_closest_tri_write;
-
-    CUDA_CHECK(cudaMalloc(&d_tri, num_triangles * sizeof(Vec3ui)));
-    CUDA_CHECK(cudaMalloc(&d_x, num_vertices * sizeof(Vec3f)));
-    CUDA_CHECK(cudaMalloc(&d_dist_tri, num_grid_cells * sizeof(DistTriPair)));
-    CUDA_CHECK(cudaMalloc(&d_intersection_count, num_grid_cells * sizeof(int)));
-    CUDA_CHECK(cudaMalloc(&d_phi_read, num_grid_cells * sizeof(float)));
-    CUDA_CHECK(cudaMalloc(&d_phi_write, num_grid_cells * sizeof(float)));
-    CUDA_CHECK(cudaMalloc(&d_closest_tri_read, num_grid_cells * sizeof(int)));
-    CUDA_CHECK(cudaMalloc(&d_closest_tri_write, num_grid_cells * sizeof(int)));
-
-    // Host to device copy
-    CUDA_CHECK(cudaMemcpy(d_tri, tri.data(), num_triangles * sizeof(Vec3ui), cudaMemcpyHostToDevice));
-    CUDA_CHECK(cudaMemcpy(d_x, x.data(), num_vertices * sizeof(Vec3f), cudaMemcpyHostToDevice));
+    // Optional precomputed triangle geometry, transposed to one row per field
+    float* d_geom = nullptr;
+    if (options.triangle_table && num_triangles > 0) {
+        d_geom = cache.geom.reserve<float>(GEOMETRY_FIELDS * num_triangles);
+        if (!cache.geom_resident) {
+            TriangleTable table(tri, x);
+            std::vector<float> rows(GEOMETRY_FIELDS * num_triangles);
+            for (size_t t = 0; t < num_triangles; ++t) {
+                const float* record = reinterpret_cast<const float*>(&table[t]);
+                for (int c = 0; c < GEOMETRY_FIELDS; ++c) rows[c * num_triangles + t] = record[c];
+            }
+            CUDA_CHECK(cudaMemcpy(d_geom, rows.data(), rows.size() * sizeof(float), cudaMemcpyHostToDevice));
+            uploaded += rows.size() * sizeof(float);
+            cache.geom_resident = true;
+        }
+    }
+
+    // In-core or streamed: the in-core grid needs DistTriPair, intersection count and two phi
+    // buffers per cell. Pooled grid buffers count as available since they would be reused.
+    const size_t cell_bytes = sizeof(DistTriPair) + sizeof(int) + 2 * sizeof(float);
+    const size_t pooled_grid_bytes = cache.dist_tri.bytes + cache.intersection_count.bytes +
+                                     cache.phi_read.bytes + cache.phi_write.bytes;
+    size_t free_bytes = 0, total_bytes = 0;
+    CUDA_CHECK(cudaMemGetInfo(&free_bytes, &total_bytes));
+    size_t budget = free_bytes + pooled_grid_bytes;
+    if (options.gpu_memory_limit > 0) {
+        size_t mesh_bytes = cache.tri.bytes + cache.x.bytes + cache.geom.bytes;
+        budget = std::min(budget, options.gpu_memory_limit > mesh_bytes ? options.gpu_memory_limit - mesh_bytes : 0);
+    }
+    budget = budget / 10 * 9; // headroom for kernels' scratch and the runtime
+
+    bool streamed = options.gpu_memory == GpuMemoryMode::Streamed ||
+                    (options.gpu_memory == GpuMemoryMode::Auto && num_grid_cells * cell_bytes > budget);
+
+    // Winding-number signs: the tree is built on the host and replaces the crossing counts
+    // right after the near band
+    DeviceWindingTree winding;
+    if (options.sign_mode == SignMode::WindingNumber) {
+        winding.upload(WindingNumberTree(tri, x));
+    }
+
+    if (streamed) {
+        // Two planes of halo per slot on top of the slab layers
+        const size_t per_layer = streamed_bytes_per_layer(ni, nj);
+        long long layers = (long long)(budget / per_layer) - 2;
+        if (layers < 1) {
+            throw std::runtime_error("Grid plane too large for GPU memory even in streamed mode");
+        }
+        layers = std::min<long long>(layers, nk);
+
+        // Release pooled grid buffers so the slabs can use that memory
+        cache.dist_tri.free();
+        cache.intersection_count.free();
+        cache.phi_read.free();
+        cache.phi_write.free();
+
+        streamed_level_set3(d_tri, d_x, d_geom, num_triangles, origin, dx, ni, nj, nk, (int)layers,
+                            winding.valid() ? &winding : nullptr, phi, options, stats);
+        if (stats && winding.valid()) stats->winding_evaluations = winding.evaluations();
+        extract_from_host(surface, phi, origin, dx, options);
+        return;
+    }
+
+    DistTriPair* d_dist_tri = cache.dist_tri.reserve<DistTriPair>(num_grid_cells);
+    int* d_intersection_count = cache.intersection_count.reserve<int>(num_grid_cells);
+    float* d_phi_read = cache.phi_read.reserve<float>(num_grid_cells);
+    float* d_phi_write = cache.phi_write.reserve<float>(num_grid_cells);
+    if (stats) {
+        stats->device_bytes = cache.tri.bytes + cache.x.bytes + cache.geom.bytes + cache.dist_tri.bytes +
+                              cache.intersection_count.bytes + cache.phi_read.bytes + cache.phi_write.bytes;
+        stats->bytes_to_device = uploaded;
+    }
+
+    // Diagnostics count the per-triangle kernel's distances and lost compare-and-swaps
+    unsigned long long* d_counters = nullptr;
+    if (stats && options.diagnostics) {
+        CUDA_CHECK(cudaMalloc(&d_counters, 2 * sizeof(unsigned long long)));
+        CUDA_CHECK(cudaMemset(d_counters, 0, 2 * sizeof(unsigned long long)));
+    }
 
     // Kernel 1: Initialize
     dim3 blockInit(8, 8, 8);
     dim3 gridInit((ni + 7) / 8, (nj + 7) / 8, (nk + 7) / 8);
     initialize_grids_kernel<<<gridInit, blockInit>>>(d_dist_tri, d_intersection_count, ni, nj, nk, (ni+nj+nk)*dx);
     CUDA_CHECK(cudaGetLastError());
-    CUDA_CHECK(cudaDeviceSynchronize());
+    CUDA_CHECK(cudaStreamSynchronize(cudaStreamPerThread));
+    timer.begin(GenerationPhase::NearBand);
 
     // Kernel 2: Near-band distances
-    int blockNear = 256;
-    int gridNear = (num_triangles + 255) / 256;
-    near_band_distance_kernel<<<gridNear, blockNear>>>(d_tri, d_x, d_dist_tri, d_intersection_count,
-                                                       num_triangles, origin, dx, ni, nj, nk, exact_band);
-    CUDA_CHECK(cudaGetLastError());
-    CUDA_CHECK(cudaDeviceSynchronize());
+    bool binned = options.gpu_near_band == GpuNearBandMode::Binned && num_triangles > 0 &&
+                  binned_near_band(d_tri, d_x, d_geom, d_dist_tri, d_intersection_count, (int)num_triangles,
+                                   origin, dx, ni, nj, nk, exact_band);
+    if (!binned) {
+        int blockNear = 256;
+        int gridNear = (num_triangles + 255) / 256;
+        near_band_distance_kernel<<<gridNear, blockNear>>>(d_tri, d_x, d_geom, d_dist_tri, d_intersection_count,
+                                                           num_triangles, origin, dx, ni, nj, nk, exact_band, 0, nk,
+                                                           d_counters);
+        CUDA_CHECK(cudaGetLastError());
+        CUDA_CHECK(cudaStreamSynchronize(cudaStreamPerThread));
+    }
+    if (d_counters) {
+        unsigned long long counters[2];
+        CUDA_CHECK(cudaMemcpy(counters, d_counters, sizeof(counters), cudaMemcpyDeviceToHost));
+        CUDA_CHECK(cudaFree(d_counters));
+        stats->distance_evaluations = (long long)counters[0];
+        stats->gpu_cas_retries = (long long)counters[1];
+    }
 
-    // Extract phi and triangle indices from DistTriPair
+    // Extract phi from DistTriPair (the triangle indices are only needed by the diagnostics
+    // and the active-tile seeding, which read d_dist_tri directly)
     CUDA_CHECK(cudaMemcpy2D(d_phi_read, sizeof(float), d_dist_tri, sizeof(DistTriPair),
                            sizeof(float), num_grid_cells, cudaMemcpyDeviceToDevice));
-    CUDA_CHECK(cudaMemcpy2D(d_closest_tri_read, sizeof(int),
-                           (char*)d_dist_tri + offsetof(DistTriPair, tri_idx), sizeof(DistTriPair),
-                           sizeof(int), num_grid_cells, cudaMemcpyDeviceToDevice));
-
-    // DEBUG: Check near-band distances
-    std::vector<float> debug_phi(num_grid_cells);
-    CUDA_CHECK(cudaMemcpy(debug_phi.data(), d_phi_read, num_grid_cells * sizeof(float), cudaMemcpyDeviceToHost));
-    float min_near = *std::min_element(debug_phi.begin(), debug_phi.end());
-    float max_near = *std::max_element(debug_phi.begin(), debug_phi.end());
-    // Debug output commented out for production use
-    // float init_max = (ni+nj+nk)*dx;
-    // int unchanged = 0, updated = 0;
-    // for (float v : debug_phi) {
-    //     if (fabsf(v - init_max) < 1e-6f) unchanged++;
-    //     else updated++;
-    // }
-    // std::cout << "After near-band: min=" << min_near << ", max=" << max_near << std::endl;
-    // std::cout << "  Cells: " << updated << " updated by near-band, " << unchanged << " still at init value" << std::endl;
-
-    // Check a few specific sample values right after near-band
-    // std::cout << "  Sample near-band values: ";
-    // int sample_indices[] = {0, 100, 1000, (int)(num_grid_cells/2)};
-    // for (int i = 0; i < 4; i++) {
-    //     int idx = sample_indices[i];
-    //     if (idx < num_grid_cells) std::cout << "[" << idx << "]=" << debug_phi[idx] << " ";
-    // }
-    // std::cout << std::endl;
 
-    // Kernel 3: Fast sweeping
-    dim3 blockSweep(8, 8, 8);
-    dim3 gridSweep = gridInit;
+    // Optional diagnostics: reduced on the device, only four scalars cross PCIe
+    if (stats && options.diagnostics) {
+        gather_near_band_stats(d_dist_tri, d_intersection_count, num_grid_cells, *stats);
+    }
+
+    if (winding.valid()) {
+        winding.crossings(d_dist_tri, d_intersection_count, origin, dx, ni, nj, nk, 0, cudaStreamPerThread);
+    }
+    // Ray votes: phi_write is not read before the sweep initializes it, so it holds the vote bytes
+    if (options.sign_mode == SignMode::RayVote) {
+        ray_vote_crossings(d_tri, d_x, (int)num_triangles, d_intersection_count,
+                           reinterpret_cast<unsigned char*>(d_phi_write), origin, dx, ni, nj, nk, nk, 0,
+                           cudaStreamPerThread);
+    }
+    if (timed) CUDA_CHECK(cudaStreamSynchronize(cudaStreamPerThread));
+    timer.begin(GenerationPhase::Sweep);
 
+    if (generation_cancelled(options)) return;
+
+    // Kernel 3: Fast sweeping
     // Jacobi iterations need more passes than Gauss-Seidel sweeps for same convergence
     // CPU uses 2 passes × 8 directional Gauss-Seidel sweeps = 16 effective sweeps
     // GPU Jacobi method: Match CPU's effective sweep count but iterate more
-    // to allow information to propagate across the entire gridf
-    const int sweep_iterations = std::max(ni, std::max(nj, nk)) * 2;
+    // to allow information to propagate across the entire grid
+    const int max_iterations = std::max(ni, std::max(nj, nk)) * 2;
+    int iterations = 0;
+    bool converged = false;
+
+    if (options.gpu_sweep_mode == GpuSweepMode::ActiveTiles) {
+        // Block fast iterative method: only tiles on the front are visited. Each outer
+        // iteration moves the front at least one tile, so the same cap applies.
+        const int tiles_x = gridInit.x, tiles_y = gridInit.y, tiles_z = gridInit.z;
+        const int num_tiles = tiles_x * tiles_y * tiles_z;
+        unsigned char* d_tile_flags;
+        int* d_active_tiles;
+        int* d_active_count;
+        CUDA_CHECK(cudaMalloc(&d_tile_flags, num_tiles));
+        CUDA_CHECK(cudaMalloc(&d_active_tiles, num_tiles * sizeof(int)));
+        CUDA_CHECK(cudaMalloc(&d_active_count, sizeof(int)));
+        CUDA_CHECK(cudaMemset(d_tile_flags, 0, num_tiles));
+
+        // phi_write must match phi_read outside the tiles that get committed
+        CUDA_CHECK(cudaMemcpy(d_phi_write, d_phi_read, num_grid_cells * sizeof(float), cudaMemcpyDeviceToDevice));
+        seed_active_tiles_kernel<<<gridInit, blockInit>>>(d_dist_tri, d_tile_flags, ni, nj, nk);
+        CUDA_CHECK(cudaGetLastError());
 
-    // std::cout << "Fast sweeping: " << sweep_iterations << " Jacobi iterations" << std::endl;
+        int blockCompact = 256;
+        int gridCompact = (num_tiles + blockCompact - 1) / blockCompact;
+        while (iterations < max_iterations && !generation_cancelled(options)) {
+            CUDA_CHECK(cudaMemsetAsync(d_active_count, 0, sizeof(int)));
+            compact_active_tiles_kernel<<<gridCompact, blockCompact>>>(d_tile_flags, num_tiles,
+                                                                       d_active_tiles, d_active_count);
+            CUDA_CHECK(cudaGetLastError());
+            int active = 0;
+            CUDA_CHECK(cudaMemcpy(&active, d_active_count, sizeof(int), cudaMemcpyDeviceToHost));
+            if (active == 0) {
+                converged = true;
+                break;
+            }
 
-    for (int iter = 0; iter < sweep_iterations; ++iter) {
-        fast_sweep_eikonal_kernel<<<gridSweep, blockSweep>>>(
-            d_phi_read, d_phi_write, dx, ni, nj, nk);
-        CUDA_CHECK(cudaGetLastError());
-        std::swap(d_phi_read, d_phi_write);
+            active_tile_sweep_kernel<<<active, blockInit>>>(d_phi_read, d_phi_write, d_active_tiles, d_tile_flags,
+                                                            tiles_x, tiles_y, tiles_z, dx, ni, nj, nk,
+                                                            options.sweep_tolerance, FIM_TILE);
+            CUDA_CHECK(cudaGetLastError());
+            commit_active_tiles_kernel<<<active, blockInit>>>(d_phi_write, d_phi_read, d_active_tiles,
+                                                              tiles_x, tiles_y, ni, nj, nk);
+            CUDA_CHECK(cudaGetLastError());
+            ++iterations;
+        }
+        CUDA_CHECK(cudaStreamSynchronize(cudaStreamPerThread));
+
+        CUDA_CHECK(cudaFree(d_tile_flags));
+        CUDA_CHECK(cudaFree(d_active_tiles));
+        CUDA_CHECK(cudaFree(d_active_count));
+    } else {
+        dim3 blockSweep(8, 8, 8);
+        dim3 gridSweep = gridInit;
+
+        // Convergence check: every check_interval-th iteration records whether any cell still
+        // moved. With tolerance 0 an unchanged iteration is a fixed point of the update, so
+        // stopping there gives the same field as running all max_iterations.
+        const int check_interval = options.sweep_check_interval;
+        int* d_changed = nullptr;
+        if (check_interval > 0) {
+            CUDA_CHECK(cudaMalloc(&d_changed, sizeof(int)));
+        }
+
+        while (iterations < max_iterations && !generation_cancelled(options)) {
+            bool check = check_interval > 0 && (iterations + 1) % check_interval == 0;
+            if (check) {
+                CUDA_CHECK(cudaMemsetAsync(d_changed, 0, sizeof(int)));
+            }
+            fast_sweep_eikonal_kernel<<<gridSweep, blockSweep>>>(
+                d_phi_read, d_phi_write, dx, ni, nj, nk, check ? d_changed : nullptr, options.sweep_tolerance);
+            CUDA_CHECK(cudaGetLastError());
+            std::swap(d_phi_read, d_phi_write);
+            ++iterations;
+
+            if (check) {
+                int changed = 0;
+                CUDA_CHECK(cudaMemcpy(&changed, d_changed, sizeof(int), cudaMemcpyDeviceToHost));
+                if (!changed) {
+                    converged = true;
+                    break;
+                }
+            }
+        }
+        CUDA_CHECK(cudaStreamSynchronize(cudaStreamPerThread));
+        if (d_changed) CUDA_CHECK(cudaFree(d_changed));
+    }
 
-        // DEBUG: Check convergence periodically (commented out for production)
-        // if (iter % (sweep_iterations / 4) == (sweep_iterations / 4 - 1) || iter == sweep_iterations - 1) {
-        //     CUDA_CHECK(cudaMemcpy(debug_phi.data(), d_phi_read, num_grid_cells * sizeof(float), cudaMemcpyDeviceToHost));
-        //     float min_val = *std::min_element(debug_phi.begin(), debug_phi.end());
-        //     float max_val = *std::max_element(debug_phi.begin(), debug_phi.end());
-        //     float avg_val = 0.0f;
-        //     for (float v : debug_phi) avg_val += v;
-        //     avg_val /= num_grid_cells;
-        //     std::cout << "  Iteration " << (iter+1) << ": min=" << min_val << ", max=" << max_val << ", avg=" << avg_val << std::endl;
-        // }
-    }
-    CUDA_CHECK(cudaDeviceSynchronize());
-
-    // DEBUG: Sample values at specific points for comparison (commented out for production)
-    // std::cout << "Sample distances before sign correction:" << std::endl;
-    // int final_samples[] = {0, 100, 1000, 5000, 10000};
-    // for (int s = 0; s < 5; s++) {
-    //     int sample_idx = final_samples[s];
-    //     if (sample_idx < num_grid_cells) {
-    //         int k = sample_idx / (ni * nj);
-    //         int j = (sample_idx - k * ni * nj) / ni;
-    //         int i = sample_idx - k * ni * nj - j * ni;
-    //         std::cout << "  [" << i << "," << j << "," << k << "]: " << debug_phi[sample_idx] << std::endl;
-    //     }
-    // }
-
-    // DEBUG: Check intersection counts before sign correction (commented out for production)
-    // std::vector<int> debug_intersections(num_grid_cells);
-    // CUDA_CHECK(cudaMemcpy(debug_intersections.data(), d_intersection_count, num_grid_cells * sizeof(int), cudaMemcpyDeviceToHost));
-    // int total_intersections = 0;
-    // for (int v : debug_intersections) total_intersections += v;
-    // std::cout << "Total intersections: " << total_intersections << std::endl;
-    // std::cout << "Sample intersection counts at y=3,z=3: ";
-    // for (int i = 0; i < 15 && i < ni; i++) {
-    //     int idx = grid_index(i, 3, 3, ni, nj);
-    //     std::cout << "[" << i << "]=" << debug_intersections[idx] << " ";
-    // }
-    // std::cout << std::endl;
+    if (stats) {
+        stats->sweep_iterations = iterations;
+        stats->sweep_converged = converged;
+    }
+    timer.begin(GenerationPhase::Sign);
+    if (generation_cancelled(options)) return;
 
     // Kernel 4: Sign correction
     dim3 blockSign(16, 16);
     dim3 gridSign((nj + 15) / 16, (nk + 15) / 16);
     sign_correction_kernel<<<gridSign, blockSign>>>(d_phi_read, d_intersection_count, ni, nj, nk);
     CUDA_CHECK(cudaGetLastError());
-    CUDA_CHECK(cudaDeviceSynchronize());
+    CUDA_CHECK(cudaStreamSynchronize(cudaStreamPerThread));
+    if (stats && winding.valid()) stats->winding_evaluations = winding.evaluations();
+    timer.end();
+
+    // Isosurface straight from the device field: only the mesh crosses PCIe
+    if (surface) {
+        marching_cubes_device(d_phi_read, ni, nj, nk, origin, Vec3f(dx, dx, dx), surface->isolevel,
+                              *surface->vertices, *surface->triangles);
+        if (!surface->copy_phi) return;
+    }
 
     // Device to host copy
+    timer.begin(GenerationPhase::Copy);
     phi.resize(ni, nj, nk);
     float* phi_data = &phi.a[0];
     CUDA_CHECK(cudaMemcpy(phi_data, d_phi_read, num_grid_cells * sizeof(float), cudaMemcpyDeviceToHost));
+    if (stats) {
+        stats->bytes_to_host = num_grid_cells * sizeof(float);
+        stats->host_bytes = num_grid_cells * sizeof(float);
+    }
+
+    // Device buffers stay in the pool; local_context frees them for context-less calls
+}
+
+void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                     const Vec3f &origin, float dx, int ni, int nj, int nk,
+                     Array3f &phi, const GenerationOptions &options, GenerationStats *stats,
+                     GpuContext *context)
+{
+    level_set3(tri, x, origin, dx, ni, nj, nk, phi, options, stats, context, nullptr);
+}
+
+void make_level_set3_mesh(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                          const Vec3f &origin, float dx, int nx, int ny, int nz, float isolevel,
+                          std::vector<Vec3f> &vertices, std::vector<Vec3ui> &triangles,
+                          const GenerationOptions &options, GenerationStats *stats,
+                          GpuContext *context, Array3f *phi)
+{
+    vertices.clear();
+    triangles.clear();
+    IsosurfaceRequest surface = {isolevel, &vertices, &triangles, phi != nullptr};
+    Array3f host_phi;
+    level_set3(tri, x, origin, dx, nx, ny, nz, phi ? *phi : host_phi, options, stats, context, &surface);
+}
+
+/**
+ * @brief Device bytes a batched grid needs: mesh plus pair, count and two phi buffers per cell
+ */
+static size_t batch_item_bytes(const BatchItem& item) {
+    size_t cells = (size_t)item.nx * item.ny * item.nz;
+    return cells * (sizeof(DistTriPair) + sizeof(int) + 2 * sizeof(float)) +
+           item.tri.size() * sizeof(Vec3ui) + item.x.size() * sizeof(Vec3f);
+}
+
+/**
+ * @brief Generate a group of batch items packed into one set of device arrays
+ *
+ * Same phases as the in-core path (per-triangle near band, Jacobi sweep with the convergence
+ * check, sign pass), each run as a single launch over the whole group. With a zero
+ * sweep_tolerance every grid is bit-identical to a single-grid call.
+ *
+ * @param members Indices into items of the grids in this group
+ */
+static void batch_level_set3(const std::vector<BatchItem>& items, const std::vector<size_t>& members,
+                             std::vector<Array3f>& phis, const GenerationOptions& options,
+                             std::vector<GenerationStats>* stats)
+{
+    const int num_grids = (int)members.size();
+    std::vector<BatchGrid> grids(num_grids);
+    std::vector<size_t> cell_offsets(num_grids + 1, 0), row_offsets(num_grids + 1, 0), tri_offsets(num_grids + 1, 0);
+    std::vector<Vec3ui> tri;
+    std::vector<Vec3f> x;
+    int max_iterations = 0;
+
+    for (int b = 0; b < num_grids; ++b) {
+        const BatchItem& item = items[members[b]];
+        BatchGrid& grid = grids[b];
+        grid.origin = item.origin;
+        grid.dx = item.dx;
+        grid.ni = item.nx;
+        grid.nj = item.ny;
+        grid.nk = item.nz;
+        grid.max_dist = (item.nx + item.ny + item.nz) * item.dx;
+        grid.max_iterations = std::max(item.nx, std::max(item.ny, item.nz)) * 2;
+        grid.cell_offset = cell_offsets[b];
+        max_iterations = std::max(max_iterations, grid.max_iterations);
+
+        cell_offsets[b + 1] = cell_offsets[b] + (size_t)item.nx * item.ny * item.nz;
+        row_offsets[b + 1] = row_offsets[b] + (size_t)item.ny * item.nz;
+        tri_offsets[b + 1] = tri_offsets[b] + item.tri.size();
+
+        const unsigned int vertex_offset = (unsigned int)x.size();
+        for (const Vec3ui& t : item.tri) {
+            tri.push_back(Vec3ui(t[0] + vertex_offset, t[1] + vertex_offset, t[2] + vertex_offset));
+        }
+        x.insert(x.end(), item.x.begin(), item.x.end());
+    }
+    const size_t total_cells = cell_offsets[num_grids];
+    const size_t total_rows = row_offsets[num_grids];
+    const int num_triangles = (int)tri.size();
+
+    Vec3ui* d_tri;
+    Vec3f* d_x;
+    BatchGrid* d_grids;
+    size_t *d_cell_offsets, *d_row_offsets, *d_tri_offsets;
+    DistTriPair* d_dist_tri;
+    int* d_intersection_count;
+    float *d_phi_read, *d_phi_write;
+    int* d_changed;
+    CUDA_CHECK(cudaMalloc(&d_tri, std::max<size_t>(tri.size(), 1) * sizeof(Vec3ui)));
+    CUDA_CHECK(cudaMalloc(&d_x, std::max<size_t>(x.size(), 1) * sizeof(Vec3f)));
+    CUDA_CHECK(cudaMalloc(&d_grids, num_grids * sizeof(BatchGrid)));
+    CUDA_CHECK(cudaMalloc(&d_cell_offsets, (num_grids + 1) * sizeof(size_t)));
+    CUDA_CHECK(cudaMalloc(&d_row_offsets, (num_grids + 1) * sizeof(size_t)));
+    CUDA_CHECK(cudaMalloc(&d_tri_offsets, (num_grids + 1) * sizeof(size_t)));
+    CUDA_CHECK(cudaMalloc(&d_dist_tri, total_cells * sizeof(DistTriPair)));
+    CUDA_CHECK(cudaMalloc(&d_intersection_count, total_cells * sizeof(int)));
+    CUDA_CHECK(cudaMalloc(&d_phi_read, total_cells * sizeof(float)));
+    CUDA_CHECK(cudaMalloc(&d_phi_write, total_cells * sizeof(float)));
+    CUDA_CHECK(cudaMalloc(&d_changed, sizeof(int)));
+
+    CUDA_CHECK(cudaMemcpy(d_tri, tri.data(), tri.size() * sizeof(Vec3ui), cudaMemcpyHostToDevice));
+    CUDA_CHECK(cudaMemcpy(d_x, x.data(), x.size() * sizeof(Vec3f), cudaMemcpyHostToDevice));
+    CUDA_CHECK(cudaMemcpy(d_grids, grids.data(), num_grids * sizeof(BatchGrid), cudaMemcpyHostToDevice));
+    CUDA_CHECK(cudaMemcpy(d_cell_offsets, cell_offsets.data(), (num_grids + 1) * sizeof(size_t), cudaMemcpyHostToDevice));
+    CUDA_CHECK(cudaMemcpy(d_row_offsets, row_offsets.data(), (num_grids + 1) * sizeof(size_t), cudaMemcpyHostToDevice));
+    CUDA_CHECK(cudaMemcpy(d_tri_offsets, tri_offsets.data(), (num_grids + 1) * sizeof(size_t), cudaMemcpyHostToDevice));
+
+    // Initialize and near band
+    const int block = 256;
+    const int gridCells = (int)((total_cells + block - 1) / block);
+    batch_initialize_kernel<<<gridCells, block>>>(d_dist_tri, d_intersection_count, d_grids, d_cell_offsets,
+                                                  num_grids, total_cells);
+    CUDA_CHECK(cudaGetLastError());
+    if (num_triangles > 0) {
+        batch_near_band_kernel<<<(num_triangles + block - 1) / block, block>>>(
+            d_tri, d_x, d_dist_tri, d_intersection_count, d_grids, d_tri_offsets,
+            num_grids, num_triangles, options.exact_band);
+        CUDA_CHECK(cudaGetLastError());
+    }
+    CUDA_CHECK(cudaMemcpy2D(d_phi_read, sizeof(float), d_dist_tri, sizeof(DistTriPair),
+                            sizeof(float), total_cells, cudaMemcpyDeviceToDevice));
+
+    if (stats && options.diagnostics) {
+        for (int b = 0; b < num_grids; ++b) {
+            gather_near_band_stats(d_dist_tri + cell_offsets[b], d_intersection_count + cell_offsets[b],
+                                   cell_offsets[b + 1] - cell_offsets[b], (*stats)[members[b]]);
+        }
+    }
+
+    // Jacobi sweep over all grids, stopping when none changes
+    const int check_interval = options.sweep_check_interval;
+    int iterations = 0;
+    bool converged = false;
+    while (iterations < max_iterations && !generation_cancelled(options)) {
+        bool check = check_interval > 0 && (iterations + 1) % check_interval == 0;
+        if (check) {
+            CUDA_CHECK(cudaMemsetAsync(d_changed, 0, sizeof(int)));
+        }
+        batch_sweep_kernel<<<gridCells, block>>>(d_phi_read, d_phi_write, d_grids, d_cell_offsets, num_grids,
+                                                 total_cells, iterations, check ? d_changed : nullptr,
+                                                 options.sweep_tolerance);
+        CUDA_CHECK(cudaGetLastError());
+        std::swap(d_phi_read, d_phi_write);
+        ++iterations;
+
+        if (check) {
+            int changed = 0;
+            CUDA_CHECK(cudaMemcpy(&changed, d_changed, sizeof(int), cudaMemcpyDeviceToHost));
+            if (!changed) {
+                converged = true;
+                break;
+            }
+        }
+    }
+
+    if (!generation_cancelled(options)) {
+        batch_sign_kernel<<<(int)((total_rows + block - 1) / block), block>>>(
+            d_phi_read, d_intersection_count, d_grids, d_row_offsets, num_grids, total_rows);
+        CUDA_CHECK(cudaGetLastError());
+
+        // One download for the whole group, then split into the output grids
+        std::vector<float> packed(total_cells);
+        CUDA_CHECK(cudaMemcpy(packed.data(), d_phi_read, total_cells * sizeof(float), cudaMemcpyDeviceToHost));
+        for (int b = 0; b < num_grids; ++b) {
+            Array3f& phi = phis[members[b]];
+            phi.resize(grids[b].ni, grids[b].nj, grids[b].nk);
+            std::memcpy(&phi.a[0], &packed[cell_offsets[b]], (cell_offsets[b + 1] - cell_offsets[b]) * sizeof(float));
+            if (stats) {
+                GenerationStats& item_stats = (*stats)[members[b]];
+                item_stats.sweep_iterations = std::min(iterations, grids[b].max_iterations);
+                item_stats.sweep_converged = converged && iterations <= grids[b].max_iterations;
+                item_stats.gpu_devices = 1;
+            }
+        }
+    }
 
-    // DEBUG: Verify data was copied correctly (commented out for production)
-    // std::cout << "GPU->CPU copy verification:" << std::endl;
-    // std::cout << "  Sample values after copy: ";
-    // for (int s = 0; s < 5 && s < num_grid_cells; s++) {
-    //     std::cout << "[" << s << "]=" << phi_data[s] << " ";
-    // }
-    // std::cout << std::endl;
-
-    // Verify using Array3f accessor
-    // std::cout << "  Via Array3f accessor: ";
-    // for (int i = 0; i < 5 && i < ni; i++) {
-    //     std::cout << "[" << i << ",0,0]=" << phi(i,0,0) << " ";
-    // }
-    // std::cout << std::endl;
-
-    // Cleanup
     CUDA_CHECK(cudaFree(d_tri));
     CUDA_CHECK(cudaFree(d_x));
+    CUDA_CHECK(cudaFree(d_grids));
+    CUDA_CHECK(cudaFree(d_cell_offsets));
+    CUDA_CHECK(cudaFree(d_row_offsets));
+    CUDA_CHECK(cudaFree(d_tri_offsets));
     CUDA_CHECK(cudaFree(d_dist_tri));
     CUDA_CHECK(cudaFree(d_intersection_count));
     CUDA_CHECK(cudaFree(d_phi_read));
     CUDA_CHECK(cudaFree(d_phi_write));
-    CUDA_CHECK(cudaFree(d_closest_tri_read));
-    CUDA_CHECK(cudaFree(d_closest_tri_write));
+    CUDA_CHECK(cudaFree(d_changed));
+}
+
+void make_level_set3_batch(const std::vector<BatchItem> &items, std::vector<Array3f> &phis,
+                           const GenerationOptions &options, std::vector<GenerationStats> *stats)
+{
+    phis.resize(items.size());
+
+    size_t free_bytes = 0, total_bytes = 0;
+    CUDA_CHECK(cudaMemGetInfo(&free_bytes, &total_bytes));
+    size_t budget = options.gpu_memory_limit > 0 ? std::min(free_bytes, options.gpu_memory_limit) : free_bytes;
+    budget = budget / 10 * 9;
+
+    // Greedy groups of consecutive items that fit the budget together; an item that does not
+    // fit on its own goes through the single-grid path (which can stream it in slabs), as does
+    // every item with winding-number or ray-vote signs (a tree or y/z crossings per mesh)
+    std::vector<size_t> group;
+    size_t group_bytes = 0, group_triangles = 0, group_vertices = 0;
+    auto flush = [&]() {
+        if (!group.empty()) batch_level_set3(items, group, phis, options, stats);
+        group.clear();
+        group_bytes = group_triangles = group_vertices = 0;
+    };
+    for (size_t n = 0; n < items.size() && !generation_cancelled(options); ++n) {
+        const BatchItem& item = items[n];
+        size_t bytes = batch_item_bytes(item);
+        if (bytes > budget || options.sign_mode != SignMode::Parity) {
+            flush();
+            make_level_set3(item.tri, item.x, item.origin, item.dx, item.nx, item.ny, item.nz, phis[n], options,
+                            stats ? &(*stats)[n] : nullptr);
+            continue;
+        }
+        if (group_bytes + bytes > budget || group_triangles + item.tri.size() > (size_t)INT_MAX ||
+            group_vertices + item.x.size() > (size_t)UINT_MAX) {
+            flush();
+        }
+        group.push_back(n);
+        group_bytes += bytes;
+        group_triangles += item.tri.size();
+        group_vertices += item.x.size();
+    }
+    flush();
+}
+
+void query_points(const TriangleBVH &bvh, const WindingNumberTree *winding, const Vec3f *points, size_t count,
+                  float *distance, int *closest_tri, Vec3f *barycentric, const GenerationOptions &options,
+                  GenerationStats *stats, GpuContext &context)
+{
+    GpuContext::Impl& ctx = context.impl();
+    size_t to_device = 0, to_host = 0;
+
+    // Trees: uploaded once per mesh, kept until invalidate_mesh()
+    const int num_nodes = (int)bvh.nodes().size();
+    if (!ctx.bvh_resident) {
+        BVHNode* d_nodes = ctx.bvh_nodes.reserve<BVHNode>(std::max(num_nodes, 1));
+        Vec3f* d_corners = ctx.bvh_corners.reserve<Vec3f>(std::max<size_t>(bvh.corners().size(), 1));
+        int* d_order = ctx.bvh_order.reserve<int>(std::max<size_t>(bvh.triangle_order().size(), 1));
+        CUDA_CHECK(cudaMemcpy(d_nodes, bvh.nodes().data(), num_nodes * sizeof(BVHNode), cudaMemcpyHostToDevice));
+        CUDA_CHECK(cudaMemcpy(d_corners, bvh.corners().data(), bvh.corners().size() * sizeof(Vec3f),
+                              cudaMemcpyHostToDevice));
+        CUDA_CHECK(cudaMemcpy(d_order, bvh.triangle_order().data(), bvh.triangle_order().size() * sizeof(int),
+                              cudaMemcpyHostToDevice));
+        to_device += num_nodes * sizeof(BVHNode) + bvh.corners().size() * sizeof(Vec3f) +
+                     bvh.triangle_order().size() * sizeof(int);
+        ctx.bvh_resident = true;
+    }
+    const bool use_winding = options.sign_mode == SignMode::WindingNumber;
+    int num_winding = 0;
+    if (use_winding) {
+        num_winding = (int)winding->nodes().size();
+        if (!ctx.winding_resident) {
+            WindingNode* d_wnodes = ctx.winding_nodes.reserve<WindingNode>(std::max(num_winding, 1));
+            Vec3f* d_wcorners = ctx.winding_corners.reserve<Vec3f>(std::max<size_t>(winding->corners().size(), 1));
+            CUDA_CHECK(cudaMemcpy(d_wnodes, winding->nodes().data(), num_winding * sizeof(WindingNode),
+                                  cudaMemcpyHostToDevice));
+            CUDA_CHECK(cudaMemcpy(d_wcorners, winding->corners().data(), winding->corners().size() * sizeof(Vec3f),
+                                  cudaMemcpyHostToDevice));
+            to_device += num_winding * sizeof(WindingNode) + winding->corners().size() * sizeof(Vec3f);
+            ctx.winding_resident = true;
+        }
+    }
 
-    // std::cout << "GPU SDF computation complete." << std::endl;
+    // Points in batches, so device memory stays bounded for any count
+    const size_t batch = std::min<size_t>(count, (size_t)1 << 22);
+    Vec3f* d_points = ctx.query_points.reserve<Vec3f>(std::max<size_t>(batch, 1));
+    float* d_distance = ctx.query_distance.reserve<float>(std::max<size_t>(batch, 1));
+    int* d_tri = closest_tri ? ctx.query_tri.reserve<int>(std::max<size_t>(batch, 1)) : nullptr;
+    float* d_weights = barycentric ? ctx.query_weights.reserve<float>(3 * std::max<size_t>(batch, 1)) : nullptr;
+    for (size_t first = 0; first < count && !generation_cancelled(options); first += batch) {
+        int n = (int)std::min(batch, count - first);
+        CUDA_CHECK(cudaMemcpy(d_points, points + first, n * sizeof(Vec3f), cudaMemcpyHostToDevice));
+        int block = 128;
+        point_query_kernel<<<(n + block - 1) / block, block>>>(
+            d_points, n, static_cast<const BVHNode*>(ctx.bvh_nodes.ptr), num_nodes,
+            static_cast<const Vec3f*>(ctx.bvh_corners.ptr), static_cast<const int*>(ctx.bvh_order.ptr),
+            use_winding ? static_cast<const WindingNode*>(ctx.winding_nodes.ptr) : nullptr, num_winding,
+            use_winding ? static_cast<const Vec3f*>(ctx.winding_corners.ptr) : nullptr,
+            options.sign_mode, d_distance, d_tri, d_weights);
+        CUDA_CHECK(cudaGetLastError());
+        CUDA_CHECK(cudaMemcpy(distance + first, d_distance, n * sizeof(float), cudaMemcpyDeviceToHost));
+        if (closest_tri) CUDA_CHECK(cudaMemcpy(closest_tri + first, d_tri, n * sizeof(int), cudaMemcpyDeviceToHost));
+        if (barycentric) {
+            CUDA_CHECK(cudaMemcpy(barycentric + first, d_weights, n * sizeof(Vec3f), cudaMemcpyDeviceToHost));
+        }
+        to_device += n * sizeof(Vec3f);
+        to_host += n * (sizeof(float) + (closest_tri ? sizeof(int) : 0) + (barycentric ? sizeof(Vec3f) : 0));
+    }
+
+    if (stats) {
+        stats->winding_evaluations = use_winding ? (long long)count : 0;
+        stats->device_bytes = context.device_bytes();
+        stats->bytes_to_device = to_device;
+        stats->bytes_to_host = to_host;
+    }
+}
+
+PhaseHook nvtx_phase_hook()
+{
+#ifdef SDFGEN_NVTX
+    return [](GenerationPhase phase, bool begin) {
+        if (begin) nvtxRangePushA(phase_name(phase));
+        else nvtxRangePop();
+    };
+#else
+    return PhaseHook();
+#endif
 }
 
 } // namespace gpu
@@ -5,11 +5,59 @@
 #pragma once
 
 #include "array3.h"
+#include "sdfgen_options.h"
 #include "vec.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
 
 namespace sdfgen {
+
+class TriangleBVH;
+class WindingNumberTree;
+
 namespace gpu {
 
+/**
+ * @brief Device memory kept alive across make_level_set3() calls
+ *
+ * Holds a pool of device buffers (mesh, near-band pairs, intersection counts, both phi
+ * buffers, triangle geometry) that grow to the largest request and are reused by later
+ * calls, plus the uploaded mesh. Pass the same context to repeated calls to skip the
+ * per-call cudaMalloc/cudaFree and, while the mesh stays resident, the mesh upload and
+ * triangle-table build. Not thread-safe: use one context per host thread.
+ */
+class GpuContext {
+public:
+    GpuContext();
+    ~GpuContext();
+    GpuContext(const GpuContext &) = delete;
+    GpuContext &operator=(const GpuContext &) = delete;
+
+    /**
+     * @brief Forget the resident mesh; call whenever the tri/x arrays passed next differ
+     *
+     * The next call re-uploads into the pooled buffers (no reallocation unless it grew).
+     */
+    void invalidate_mesh();
+
+    /** @brief True when a mesh was uploaded and not invalidated since */
+    bool mesh_resident() const;
+
+    /** @brief Free all device memory; the context remains usable */
+    void release();
+
+    /** @brief Device bytes currently held by the pool */
+    size_t device_bytes() const;
+
+    /** @brief Implementation state, only meaningful inside the CUDA translation unit */
+    struct Impl;
+    Impl &impl() { return *impl_; }
+
+private:
+    std::unique_ptr<Impl> impl_;
+};
+
 /**
  * @brief Generate signed distance field using GPU-accelerated CUDA implementation
  *
@@ -41,5 +89,87 @@ void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x
                      const Vec3f &origin, float dx, int nx, int ny, int nz,
                      Array3f &phi, const int exact_band=1);
 
+/**
+ * @brief Generate signed distance field on the GPU with explicit options
+ *
+ * Uses options.exact_band and options.triangle_table; the CPU-only fields are ignored.
+ * With triangle_table set, the per-triangle geometry (TriangleGeometry fields, 116 bytes
+ * per triangle) is uploaded as a structure of arrays so neighbouring threads of the
+ * near-band kernel read it with coalesced loads instead of gathering through tri/x.
+ *
+ * @param tri Triangle vertex indices
+ * @param x Vertex positions in world coordinates
+ * @param origin Grid origin point (lower corner) in world space
+ * @param dx Grid cell spacing
+ * @param nx Number of grid cells in X dimension
+ * @param ny Number of grid cells in Y dimension
+ * @param nz Number of grid cells in Z dimension
+ * @param phi Output signed distance field array (will be resized to nx*ny*nz)
+ * @param options Generation options
+ * @param stats Optional output; with options.diagnostics the near-band statistics are reduced
+ *        on the device and only the scalar results are copied back
+ * @param context Optional persistent device memory; if it holds a resident mesh, tri and x
+ *        must be the arrays it was uploaded from (see GpuContext::invalidate_mesh()), and
+ *        options.spatial_reorder must not change while it stays resident (the sorted copy
+ *        is what gets uploaded). A context belongs to the device it was first used on,
+ *        and it is not used when options.gpu_devices lists more than one device.
+ *
+ * With more than one entry in options.gpu_devices the grid is split along z into one
+ * contiguous share per device, with halo planes exchanged peer to peer during the sweep.
+ * Each share must fit its device in-core.
+ */
+void make_level_set3(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                     const Vec3f &origin, float dx, int nx, int ny, int nz,
+                     Array3f &phi, const GenerationOptions &options, GenerationStats *stats=nullptr,
+                     GpuContext *context=nullptr);
+
+/**
+ * @brief Generate many small grids with one set of kernel launches per phase
+ *
+ * Items are packed into shared device arrays in groups that fit the device memory budget
+ * (options.gpu_memory_limit or the free memory); each group runs the per-triangle near band,
+ * the Jacobi sweep and the sign pass as one launch each. Items too large to share a group run
+ * through the single-grid path. The Binned, ActiveTiles, triangle-table and multi-device
+ * options apply only to those; grouped items use the default kernels.
+ *
+ * @param items Grids to generate
+ * @param phis Output grids, one per item (resized)
+ * @param options Generation options shared by all items
+ * @param stats Optional per-item statistics, same size as items
+ */
+void make_level_set3_batch(const std::vector<BatchItem> &items, std::vector<Array3f> &phis,
+                           const GenerationOptions &options, std::vector<GenerationStats> *stats=nullptr);
+
+/**
+ * @brief Signed distance at scattered points, one thread per point (GPU side of sdfgen::query_points())
+ *
+ * The BVH, and the winding-number tree with SignMode::WindingNumber, are uploaded into the
+ * context on first use and stay resident until GpuContext::invalidate_mesh(); points and
+ * results then pass through pooled buffers in batches of up to 4M points. Each thread walks
+ * the BVH like TriangleBVH::nearest() and signs its distance like cpu::query_points().
+ *
+ * @param bvh BVH over the mesh
+ * @param winding Winding-number tree of the mesh; only read with SignMode::WindingNumber
+ * @param points Query points
+ * @param count Number of points
+ * @param distance Output signed distances, count entries
+ * @param closest_tri Optional output: nearest triangle per point, or null
+ * @param barycentric Optional output: weights of the nearest point, or null
+ * @param options Uses sign_mode and cancel (checked between batches)
+ * @param stats Optional output: winding_evaluations, device_bytes and the transfer sizes
+ * @param context Device memory holding the resident trees
+ */
+void query_points(const TriangleBVH &bvh, const WindingNumberTree *winding, const Vec3f *points, size_t count,
+                  float *distance, int *closest_tri, Vec3f *barycentric, const GenerationOptions &options,
+                  GenerationStats *stats, GpuContext &context);
+
+/**
+ * @brief Phase hook that opens one NVTX range per generation phase
+ *
+ * The ranges show up in Nsight Systems next to the kernels. Empty when the CUDA toolkit
+ * has no NVTX 3 headers.
+ */
+PhaseHook nvtx_phase_hook();
+
 } // namespace gpu
 } // namespace sdfgen
@@ -0,0 +1,391 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#include "marching_cubes_gpu.h"
+#include "marching_cubes_tables.h"
+#include <cuda_runtime.h>
+#include <iostream>
+#include <cstddef>
+
+// CUDA error checking macro
+#define CUDA_CHECK(err) { \
+    if (err != cudaSuccess) { \
+        std::cerr << "CUDA Error: " << cudaGetErrorString(err) \
+                  << " in " << __FILE__ << " at line " << __LINE__ << std::endl; \
+        exit(EXIT_FAILURE); \
+    } \
+}
+
+namespace sdfgen {
+namespace gpu {
+
+// ============================================================================
+// Case Tables
+// ============================================================================
+
+/// Threads per block of every extraction kernel (a multiple of the warp size, at most 32 warps)
+const int MC_BLOCK = 256;
+
+__constant__ signed char c_tri_table[256][16];
+__constant__ unsigned char c_cell_edges[12][4];
+__constant__ unsigned char c_case_triangles[256];
+
+/**
+ * @brief Copy the shared case tables into constant memory of the current device
+ */
+static void upload_case_tables() {
+    signed char tri_table[256][16];
+    unsigned char cell_edges[12][4];
+    unsigned char case_triangles[256];
+    for (int c = 0; c < 256; ++c) {
+        case_triangles[c] = 0;
+        for (int e = 0; e < 16; ++e) {
+            tri_table[c][e] = (signed char)marching_cubes_tables::tri_table[c][e];
+            if (e % 3 == 0 && tri_table[c][e] != -1) ++case_triangles[c];
+        }
+    }
+    for (int e = 0; e < 12; ++e)
+        for (int c = 0; c < 4; ++c) cell_edges[e][c] = (unsigned char)marching_cubes_tables::cell_edges[e][c];
+
+    CUDA_CHECK(cudaMemcpyToSymbolAsync(c_tri_table, tri_table, sizeof(tri_table), 0,
+                                       cudaMemcpyHostToDevice, cudaStreamPerThread));
+    CUDA_CHECK(cudaMemcpyToSymbolAsync(c_cell_edges, cell_edges, sizeof(cell_edges), 0,
+                                       cudaMemcpyHostToDevice, cudaStreamPerThread));
+    CUDA_CHECK(cudaMemcpyToSymbolAsync(c_case_triangles, case_triangles, sizeof(case_triangles), 0,
+                                       cudaMemcpyHostToDevice, cudaStreamPerThread));
+    // The host arrays go out of scope: wait for the staged copies
+    CUDA_CHECK(cudaStreamSynchronize(cudaStreamPerThread));
+}
+
+// ============================================================================
+// Prefix Scan
+// ============================================================================
+
+/**
+ * @brief Exclusive prefix sum across one block of MC_BLOCK threads (warp shuffles)
+ *
+ * Every thread of the block must call it.
+ *
+ * @param value This thread's element
+ * @param total Receives the sum over the block
+ * @return Sum of the elements of the lower-numbered threads
+ */
+__device__ unsigned int block_exclusive_scan(unsigned int value, unsigned int* total) {
+    __shared__ unsigned int warp_sums[MC_BLOCK / 32];
+    const int lane = threadIdx.x & 31;
+    const int warp = threadIdx.x >> 5;
+
+    unsigned int inclusive = value;
+    for (int d = 1; d < 32; d <<= 1) {
+        unsigned int below = __shfl_up_sync(0xffffffffu, inclusive, d);
+        if (lane >= d) inclusive += below;
+    }
+    if (lane == 31) warp_sums[warp] = inclusive;
+    __syncthreads();
+
+    if (warp == 0) {
+        unsigned int sum = lane < MC_BLOCK / 32 ? warp_sums[lane] : 0;
+        for (int d = 1; d < MC_BLOCK / 32; d <<= 1) {
+            unsigned int below = __shfl_up_sync(0xffffffffu, sum, d);
+            if (lane >= d) sum += below;
+        }
+        if (lane < MC_BLOCK / 32) warp_sums[lane] = sum;
+    }
+    __syncthreads();
+
+    unsigned int result = inclusive - value + (warp > 0 ? warp_sums[warp - 1] : 0);
+    *total = warp_sums[MC_BLOCK / 32 - 1];
+    __syncthreads(); // warp_sums is reused by the next call
+    return result;
+}
+
+/**
+ * @brief First level of exclusive_scan(): scan each block in place, record the block sums
+ */
+__global__ void scan_blocks_kernel(unsigned int* data, size_t count, unsigned int* block_sums) {
+    size_t n = (size_t)blockIdx.x * MC_BLOCK + threadIdx.x;
+    unsigned int total;
+    unsigned int scanned = block_exclusive_scan(n < count ? data[n] : 0, &total);
+    if (n < count) data[n] = scanned;
+    if (threadIdx.x == 0) block_sums[blockIdx.x] = total;
+}
+
+/**
+ * @brief Last level of exclusive_scan(): add each block's scanned offset
+ */
+__global__ void add_block_offsets_kernel(unsigned int* data, size_t count, const unsigned int* block_offsets) {
+    size_t n = (size_t)blockIdx.x * MC_BLOCK + threadIdx.x;
+    if (n < count) data[n] += block_offsets[blockIdx.x];
+}
+
+/**
+ * @brief Exclusive prefix sum of a device array in place (recursive over the block sums)
+ * @return Sum of all elements
+ */
+static unsigned int exclusive_scan(unsigned int* d_data, size_t count) {
+    if (count == 0) return 0;
+    const size_t blocks = (count + MC_BLOCK - 1) / MC_BLOCK;
+    unsigned int* d_block_sums;
+    CUDA_CHECK(cudaMalloc(&d_block_sums, blocks * sizeof(unsigned int)));
+    scan_blocks_kernel<<<(unsigned int)blocks, MC_BLOCK>>>(d_data, count, d_block_sums);
+    CUDA_CHECK(cudaGetLastError());
+
+    unsigned int total = 0;
+    if (blocks == 1) {
+        CUDA_CHECK(cudaMemcpy(&total, d_block_sums, sizeof(unsigned int), cudaMemcpyDeviceToHost));
+    } else {
+        total = exclusive_scan(d_block_sums, blocks);
+        add_block_offsets_kernel<<<(unsigned int)blocks, MC_BLOCK>>>(d_data, count, d_block_sums);
+        CUDA_CHECK(cudaGetLastError());
+    }
+    CUDA_CHECK(cudaFree(d_block_sums));
+    return total;
+}
+
+// ============================================================================
+// Extraction Kernels
+// ============================================================================
+
+/**
+ * @brief Node code: cube index of the cell at the node in bits 0-7, crossed x/y/z edges
+ *        leaving the node in bits 8-10
+ */
+__device__ inline bool node_active(unsigned short code) {
+    unsigned int cube = code & 0xffu;
+    return (code >> 8) != 0 || c_case_triangles[cube] != 0;
+}
+
+/**
+ * @brief Classify every node and count the active nodes of each block
+ *
+ * A node is active when one of the three edges leaving it in +x, +y, +z is crossed (it owns
+ * those vertices) or the cell with the node as lower corner has triangles.
+ *
+ * @param codes Receives one code per node (see node_active())
+ * @param block_active Receives the number of active nodes per block
+ */
+__global__ void classify_nodes_kernel(const float* phi, int ni, int nj, int nk, float isolevel,
+                                      unsigned short* codes, unsigned int* block_active)
+{
+    const size_t num_nodes = (size_t)ni * nj * nk;
+    const size_t layer = (size_t)ni * nj;
+    size_t n = (size_t)blockIdx.x * MC_BLOCK + threadIdx.x;
+    unsigned short code = 0;
+
+    if (n < num_nodes) {
+        int i = (int)(n % ni);
+        int j = (int)((n / ni) % nj);
+        int k = (int)(n / layer);
+        bool in = phi[n] < isolevel;
+        unsigned int edges = 0;
+        if (i + 1 < ni && in != (phi[n + 1] < isolevel)) edges |= 1u;
+        if (j + 1 < nj && in != (phi[n + ni] < isolevel)) edges |= 2u;
+        if (k + 1 < nk && in != (phi[n + layer] < isolevel)) edges |= 4u;
+
+        unsigned int cube = 0;
+        if (i + 1 < ni && j + 1 < nj && k + 1 < nk) {
+            // Corner order of marching_cubes_tables: (0,0,0) (1,0,0) (1,0,1) (0,0,1) and the same at j+1
+            const float* b0 = phi + n;
+            const float* b1 = b0 + ni;
+            const float* t0 = b0 + layer;
+            const float* t1 = b1 + layer;
+            cube = (unsigned int)in | (b0[1] < isolevel) << 1 | (t0[1] < isolevel) << 2 |
+                   (t0[0] < isolevel) << 3 | (b1[0] < isolevel) << 4 | (b1[1] < isolevel) << 5 |
+                   (t1[1] < isolevel) << 6 | (t1[0] < isolevel) << 7;
+        }
+        code = (unsigned short)(cube | edges << 8);
+        codes[n] = code;
+    }
+
+    int active = __syncthreads_count(n < num_nodes && node_active(code));
+    if (threadIdx.x == 0) block_active[blockIdx.x] = (unsigned int)active;
+}
+
+/**
+ * @brief Stream compaction: write the index of every active node, in node order
+ * @param block_offsets Exclusive scan of the per-block active counts
+ */
+__global__ void compact_nodes_kernel(const unsigned short* codes, size_t num_nodes,
+                                     const unsigned int* block_offsets, size_t* active_nodes)
+{
+    size_t n = (size_t)blockIdx.x * MC_BLOCK + threadIdx.x;
+    bool active = n < num_nodes && node_active(codes[n]);
+    unsigned int total;
+    unsigned int rank = block_exclusive_scan(active ? 1u : 0u, &total);
+    if (active) active_nodes[block_offsets[blockIdx.x] + rank] = n;
+}
+
+/**
+ * @brief Vertex and triangle counts of each active node, scanned into output offsets
+ */
+__global__ void count_outputs_kernel(const unsigned short* codes, const size_t* active_nodes, unsigned int num_active,
+                                     unsigned int* vertex_offsets, unsigned int* triangle_offsets)
+{
+    unsigned int a = blockIdx.x * MC_BLOCK + threadIdx.x;
+    if (a >= num_active) return;
+    unsigned short code = codes[active_nodes[a]];
+    vertex_offsets[a] = __popc(code >> 8);
+    triangle_offsets[a] = c_case_triangles[code & 0xffu];
+}
+
+/**
+ * @brief Vertex on the edge from a (value va) to b (value vb), as sdfgen::marching_cubes()
+ *
+ * Built with --fmad=false, so the positions match the CPU extractor bit for bit.
+ */
+__device__ inline float interpolate(float a, float b, float va, float vb, float isolevel) {
+    if (fabsf(isolevel - va) < 1e-6f) return a;
+    if (fabsf(isolevel - vb) < 1e-6f) return b;
+    if (fabsf(va - vb) < 1e-6f) return a;
+    float t = (isolevel - va) / (vb - va);
+    return a + (b - a) * t;
+}
+
+/**
+ * @brief Emit the vertices owned by each active node and the triangles of its cell
+ *
+ * A cell edge belongs to the node at its lower end, which is active because the edge is
+ * crossed; its position in the compacted list is found by binary search (the list is sorted
+ * and that node is never below the cell's own node).
+ */
+__global__ void emit_mesh_kernel(const float* phi, int ni, int nj, Vec3f origin, Vec3f spacing, float isolevel,
+                                 const unsigned short* codes, const size_t* active_nodes, unsigned int num_active,
+                                 const unsigned int* vertex_offsets, const unsigned int* triangle_offsets,
+                                 Vec3f* vertices, Vec3ui* triangles)
+{
+    unsigned int a = blockIdx.x * MC_BLOCK + threadIdx.x;
+    if (a >= num_active) return;
+
+    const size_t layer = (size_t)ni * nj;
+    const size_t n = active_nodes[a];
+    const unsigned short code = codes[n];
+    const int node[3] = {(int)(n % ni), (int)((n / ni) % nj), (int)(n / layer)};
+    const size_t stride[3] = {1, (size_t)ni, layer};
+
+    unsigned int v = vertex_offsets[a];
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!(code >> 8 & 1u << axis)) continue;
+        float va = phi[n], vb = phi[n + stride[axis]];
+        float* p = vertices[v++].v;
+        for (int c = 0; c < 3; ++c) {
+            float lo = origin.v[c] + node[c] * spacing.v[c];
+            float hi = origin.v[c] + (node[c] + (c == axis)) * spacing.v[c];
+            p[c] = interpolate(lo, hi, va, vb, isolevel);
+        }
+    }
+
+    const signed char* row = c_tri_table[code & 0xffu];
+    unsigned int t = triangle_offsets[a];
+    for (int e = 0; row[e] != -1; e += 3, ++t) {
+        unsigned int* tri = triangles[t].v;
+        for (int c = 0; c < 3; ++c) {
+            const unsigned char* edge = c_cell_edges[row[e + c]];
+            size_t owner = n + edge[0] + edge[1] * stride[1] + edge[2] * stride[2];
+            unsigned int lo = a, hi = num_active;
+            while (lo < hi) {
+                unsigned int mid = lo + (hi - lo) / 2;
+                if (active_nodes[mid] < owner) lo = mid + 1;
+                else hi = mid;
+            }
+            unsigned int lower_axes = (codes[owner] >> 8) & ((1u << edge[3]) - 1);
+            tri[c] = vertex_offsets[lo] + __popc(lower_axes);
+        }
+    }
+}
+
+// ============================================================================
+// Host Interface
+// ============================================================================
+
+void marching_cubes_device(const float* d_phi, int ni, int nj, int nk, const Vec3f& origin,
+                           const Vec3f& spacing, float isolevel,
+                           std::vector<Vec3f>& vertices, std::vector<Vec3ui>& triangles)
+{
+    vertices.clear();
+    triangles.clear();
+    if (ni < 2 || nj < 2 || nk < 2) return;
+
+    upload_case_tables();
+
+    const size_t num_nodes = (size_t)ni * nj * nk;
+    const size_t node_blocks = (num_nodes + MC_BLOCK - 1) / MC_BLOCK;
+    unsigned short* d_codes;
+    unsigned int* d_block_offsets;
+    CUDA_CHECK(cudaMalloc(&d_codes, num_nodes * sizeof(unsigned short)));
+    CUDA_CHECK(cudaMalloc(&d_block_offsets, node_blocks * sizeof(unsigned int)));
+
+    // Classify, then compact the active nodes
+    classify_nodes_kernel<<<(unsigned int)node_blocks, MC_BLOCK>>>(d_phi, ni, nj, nk, isolevel,
+                                                                    d_codes, d_block_offsets);
+    CUDA_CHECK(cudaGetLastError());
+    const unsigned int num_active = exclusive_scan(d_block_offsets, node_blocks);
+    if (num_active == 0) {
+        CUDA_CHECK(cudaFree(d_codes));
+        CUDA_CHECK(cudaFree(d_block_offsets));
+        return;
+    }
+
+    size_t* d_active_nodes;
+    CUDA_CHECK(cudaMalloc(&d_active_nodes, num_active * sizeof(size_t)));
+    compact_nodes_kernel<<<(unsigned int)node_blocks, MC_BLOCK>>>(d_codes, num_nodes, d_block_offsets,
+                                                                   d_active_nodes);
+    CUDA_CHECK(cudaGetLastError());
+    CUDA_CHECK(cudaFree(d_block_offsets));
+
+    // Output offsets of the active nodes
+    const unsigned int active_blocks = (num_active + MC_BLOCK - 1) / MC_BLOCK;
+    unsigned int* d_vertex_offsets;
+    unsigned int* d_triangle_offsets;
+    CUDA_CHECK(cudaMalloc(&d_vertex_offsets, num_active * sizeof(unsigned int)));
+    CUDA_CHECK(cudaMalloc(&d_triangle_offsets, num_active * sizeof(unsigned int)));
+    count_outputs_kernel<<<active_blocks, MC_BLOCK>>>(d_codes, d_active_nodes, num_active,
+                                                      d_vertex_offsets, d_triangle_offsets);
+    CUDA_CHECK(cudaGetLastError());
+    const unsigned int num_vertices = exclusive_scan(d_vertex_offsets, num_active);
+    const unsigned int num_triangles = exclusive_scan(d_triangle_offsets, num_active);
+
+    Vec3f* d_vertices = nullptr;
+    Vec3ui* d_triangles = nullptr;
+    if (num_vertices > 0) CUDA_CHECK(cudaMalloc(&d_vertices, num_vertices * sizeof(Vec3f)));
+    if (num_triangles > 0) CUDA_CHECK(cudaMalloc(&d_triangles, num_triangles * sizeof(Vec3ui)));
+    emit_mesh_kernel<<<active_blocks, MC_BLOCK>>>(d_phi, ni, nj, origin, spacing, isolevel, d_codes,
+                                                  d_active_nodes, num_active, d_vertex_offsets,
+                                                  d_triangle_offsets, d_vertices, d_triangles);
+    CUDA_CHECK(cudaGetLastError());
+
+    // Only the mesh crosses PCIe
+    vertices.resize(num_vertices);
+    triangles.resize(num_triangles);
+    if (num_vertices > 0) {
+        CUDA_CHECK(cudaMemcpy(vertices.data(), d_vertices, num_vertices * sizeof(Vec3f), cudaMemcpyDeviceToHost));
+    }
+    if (num_triangles > 0) {
+        CUDA_CHECK(cudaMemcpy(triangles.data(), d_triangles, num_triangles * sizeof(Vec3ui), cudaMemcpyDeviceToHost));
+    }
+
+    CUDA_CHECK(cudaFree(d_codes));
+    CUDA_CHECK(cudaFree(d_active_nodes));
+    CUDA_CHECK(cudaFree(d_vertex_offsets));
+    CUDA_CHECK(cudaFree(d_triangle_offsets));
+    if (d_vertices) CUDA_CHECK(cudaFree(d_vertices));
+    if (d_triangles) CUDA_CHECK(cudaFree(d_triangles));
+}
+
+void marching_cubes(const Array3f& phi, const Vec3f& origin, const Vec3f& spacing, float isolevel,
+                    std::vector<Vec3f>& vertices, std::vector<Vec3ui>& triangles)
+{
+    vertices.clear();
+    triangles.clear();
+    if (phi.ni < 2 || phi.nj < 2 || phi.nk < 2) return;
+
+    const size_t bytes = phi.a.size() * sizeof(float);
+    float* d_phi;
+    CUDA_CHECK(cudaMalloc(&d_phi, bytes));
+    CUDA_CHECK(cudaMemcpy(d_phi, &phi.a[0], bytes, cudaMemcpyHostToDevice));
+    marching_cubes_device(d_phi, phi.ni, phi.nj, phi.nk, origin, spacing, isolevel, vertices, triangles);
+    CUDA_CHECK(cudaFree(d_phi));
+}
+
+} // namespace gpu
+} // namespace sdfgen
@@ -0,0 +1,68 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+#pragma once
+
+#include "array3.h"
+#include "makelevelset3_gpu.h"
+#include "sdfgen_options.h"
+#include "vec.h"
+#include <vector>
+
+namespace sdfgen {
+namespace gpu {
+
+/**
+ * @brief Extract the isosurface phi = isolevel on the GPU (marching cubes)
+ *
+ * Same surface as sdfgen::marching_cubes(): one vertex per crossed grid edge, shared by the
+ * cells around it, identical positions and the same triangles in the same (cell) order. Only
+ * the vertex numbering differs: vertices are ordered by the node that owns the edge, then by
+ * axis. The nodes are classified in one pass, the nodes owning a crossed edge or a non-empty
+ * cell are stream-compacted, and prefix scans over the compacted per-node counts give every
+ * node its output offsets, so the result does not depend on scheduling.
+ *
+ * @param phi Field sampled at the grid nodes (uploaded)
+ * @param origin Position of node (0, 0, 0)
+ * @param spacing Node spacing along x, y and z
+ * @param isolevel Value of the extracted surface
+ * @param vertices Output vertex positions (replaced)
+ * @param triangles Output triangles, indices into vertices (replaced)
+ */
+void marching_cubes(const Array3f& phi, const Vec3f& origin, const Vec3f& spacing, float isolevel,
+                    std::vector<Vec3f>& vertices, std::vector<Vec3ui>& triangles);
+
+/**
+ * @brief marching_cubes() on a field already in device memory of the current device
+ *
+ * Work is issued to the calling thread's default stream; d_phi must be ready on it.
+ *
+ * @param d_phi Device pointer to ni*nj*nk values, x fastest
+ */
+void marching_cubes_device(const float* d_phi, int ni, int nj, int nk, const Vec3f& origin,
+                           const Vec3f& spacing, float isolevel,
+                           std::vector<Vec3f>& vertices, std::vector<Vec3ui>& triangles);
+
+/**
+ * @brief Generate a signed distance field and extract its isosurface without a host round trip
+ *
+ * On the in-core path the surface is extracted from the device-resident field as soon as
+ * the sign pass finishes, and the field is copied to the host only when phi is given. The
+ * streamed and multi-device paths assemble the field on the host anyway; their surface is
+ * extracted from there with marching_cubes(). Arguments as make_level_set3(); nodes sit at
+ * origin + dx*(i, j, k).
+ *
+ * @param isolevel Value of the extracted surface
+ * @param vertices Output vertex positions (replaced; empty if the generation was cancelled)
+ * @param triangles Output triangles (replaced)
+ * @param phi Optional: also receives the field
+ */
+void make_level_set3_mesh(const std::vector<Vec3ui> &tri, const std::vector<Vec3f> &x,
+                          const Vec3f &origin, float dx, int nx, int ny, int nz, float isolevel,
+                          std::vector<Vec3f> &vertices, std::vector<Vec3ui> &triangles,
+                          const GenerationOptions &options, GenerationStats *stats=nullptr,
+                          GpuContext *context=nullptr, Array3f *phi=nullptr);
+
+} // namespace gpu
+} // namespace sdfgen
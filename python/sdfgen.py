@@ -33,6 +33,11 @@ try:
         save_sdf,
         load_sdf,
         is_gpu_available,
+        GenerationContext,
+        generate_sdf_batch,
+        MappedSDF,
+        GenerationStats,
+        set_logging,
     )
 except ImportError as e:
     raise ImportError(
@@ -273,6 +278,11 @@ __all__ = [
     "save_sdf",
     "load_sdf",
     "is_gpu_available",
+    "GenerationContext",
+    "generate_sdf_batch",
+    "MappedSDF",
+    "GenerationStats",
+    "set_logging",
     # High-level Python convenience functions
     "generate_from_mesh",
     "generate_from_file",
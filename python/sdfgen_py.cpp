@@ -11,99 +11,135 @@
 #include "../common/sdfgen_unified.h"
 #include "../common/mesh_io.h"
 #include "../common/sdf_io.h"
+#include "../common/mapped_sdf.h"
+#include "../common/compressed_sdf.h"
+#include "../common/log.h"
 #include "../common/array3.h"
 #include "../common/vec.h"
 
+#include <cstring>
+
 namespace nb = nanobind;
 using namespace nb::literals;
 
+static_assert(sizeof(Vec3f) == 3 * sizeof(float), "Vec3f must be three packed floats");
+static_assert(sizeof(Vec3ui) == 3 * sizeof(uint32_t), "Vec3ui must be three packed uint32s");
+
 /**
  * @brief Convert NumPy array of float32 vertices to C++ vector
  *
  * Converts Nx3 NumPy array (contiguous, float32) to std::vector<Vec3f> for passing
- * vertex data from Python to C++ SDF generation functions.
+ * vertex data from Python to C++ SDF generation functions. Vec3f is three packed floats,
+ * so this is a single block copy.
  *
  * @param arr NumPy ndarray with shape (N, 3) and dtype float32, C-contiguous
  * @return std::vector containing N Vec3f vertex positions
  */
 std::vector<Vec3f> numpy_to_vec3f(nb::ndarray<float, nb::shape<-1, 3>, nb::c_contig> arr) {
-    size_t n = arr.shape(0);
-    std::vector<Vec3f> result(n);
-
-    auto data = arr.data();
-    for (size_t i = 0; i < n; ++i) {
-        result[i] = Vec3f(data[i * 3 + 0], data[i * 3 + 1], data[i * 3 + 2]);
-    }
-
-    return result;
+    const Vec3f* data = reinterpret_cast<const Vec3f*>(arr.data());
+    return std::vector<Vec3f>(data, data + arr.shape(0));
 }
 
 /**
  * @brief Convert NumPy array of uint32 triangle indices to C++ vector
  *
  * Converts Mx3 NumPy array (contiguous, uint32) to std::vector<Vec3ui> for passing
- * triangle index data from Python to C++ SDF generation functions.
+ * triangle index data from Python to C++ SDF generation functions (a single block copy).
  *
  * @param arr NumPy ndarray with shape (M, 3) and dtype uint32, C-contiguous
  * @return std::vector containing M Vec3ui triangle index triples
  */
 std::vector<Vec3ui> numpy_to_vec3ui(nb::ndarray<uint32_t, nb::shape<-1, 3>, nb::c_contig> arr) {
-    size_t n = arr.shape(0);
-    std::vector<Vec3ui> result(n);
-
-    auto data = arr.data();
-    for (size_t i = 0; i < n; ++i) {
-        result[i] = Vec3ui(data[i * 3 + 0], data[i * 3 + 1], data[i * 3 + 2]);
-    }
-
-    return result;
+    const Vec3ui* data = reinterpret_cast<const Vec3ui*>(arr.data());
+    return std::vector<Vec3ui>(data, data + arr.shape(0));
 }
 
 /**
- * @brief Convert C++ Array3f SDF grid to NumPy array
+ * @brief Hand an Array3f SDF grid to NumPy without copying
  *
- * Copies 3D SDF grid data from internal Array3f format to NumPy ndarray with shape
- * (ni, nj, nk) and dtype float32. Returns ownership to Python for memory management.
+ * The grid's storage is moved into a heap Array1f owned by the returned array, which
+ * frees it when Python releases the last reference; arr is left empty. Array3f keeps i
+ * fastest, so the result has shape (ni, nj, nk) with Fortran-order strides and indexes
+ * as sdf[i, j, k] like the grid.
  *
- * @param arr Input Array3f signed distance field with dimensions ni x nj x nk
- * @return NumPy ndarray with shape (ni, nj, nk), dtype float32, C-contiguous
+ * @param arr Input Array3f signed distance field with dimensions ni x nj x nk (emptied)
+ * @return NumPy ndarray with shape (ni, nj, nk), dtype float32, Fortran-contiguous
  */
-nb::ndarray<nb::numpy, float> array3f_to_numpy(const Array3f& arr) {
+nb::ndarray<nb::numpy, float> array3f_to_numpy(Array3f& arr) {
     size_t ni = arr.ni;
     size_t nj = arr.nj;
     size_t nk = arr.nk;
 
-    // Create numpy array with shape (ni, nj, nk)
-    float* data = new float[ni * nj * nk];
-
-    // Copy data from Array3f (i, j, k indexing)
-    for (size_t i = 0; i < ni; ++i) {
-        for (size_t j = 0; j < nj; ++j) {
-            for (size_t k = 0; k < nk; ++k) {
-                data[i * nj * nk + j * nk + k] = arr(i, j, k);
-            }
-        }
-    }
+    Array1f* storage = new Array1f();
+    storage->swap(arr.a);
+    arr.ni = arr.nj = arr.nk = 0;
 
     // Create capsule for memory management
-    nb::capsule owner(data, [](void* p) noexcept {
-        delete[] static_cast<float*>(p);
+    nb::capsule owner(storage, [](void* p) noexcept {
+        delete static_cast<Array1f*>(p);
     });
 
-    size_t shape[3] = {ni, nj, nk};
-
     return nb::ndarray<nb::numpy, float>(
-        data, {ni, nj, nk}, owner
+        storage->data, {ni, nj, nk}, owner,
+        {(int64_t)1, (int64_t)ni, (int64_t)(ni * nj)}
     );
 }
 
+/// Output array accepted by generate_sdf(out=...): written in place, so never converted
+using OutputArray = nb::ndarray<float, nb::ndim<3>, nb::f_contig, nb::device::cpu>;
+
+/**
+ * @brief An Array3f that computes straight into a caller's NumPy buffer
+ *
+ * The generators size phi with resize(), which keeps storage that is already large
+ * enough, so the grid is filled in place. The buffer is detached again before Array1's
+ * destructor would free it.
+ */
+struct BorrowedGrid {
+    Array3f phi;
+    float* buffer;
+
+    BorrowedGrid(OutputArray& out) : buffer(out.data()) {
+        phi.ni = (int)out.shape(0);
+        phi.nj = (int)out.shape(1);
+        phi.nk = (int)out.shape(2);
+        phi.a.data = buffer;
+        phi.a.n = phi.a.max_n = (unsigned long)out.size();
+    }
+
+    ~BorrowedGrid() {
+        phi.a.data = nullptr;
+        phi.a.n = phi.a.max_n = 0;
+    }
+
+    BorrowedGrid(const BorrowedGrid&) = delete;
+    BorrowedGrid& operator=(const BorrowedGrid&) = delete;
+};
+
+/**
+ * @brief Check a caller-provided output array against the grid dimensions
+ *
+ * Must be float32, writable, Fortran-ordered (i fastest, as np.empty((nx, ny, nz),
+ * dtype=np.float32, order="F") gives) and exactly (nx, ny, nz).
+ */
+OutputArray output_array(nb::handle out, int nx, int ny, int nz) {
+    OutputArray arr;
+    if (!nb::try_cast(out, arr, false)) {
+        throw std::invalid_argument("out must be a writable float32 array in Fortran order (order='F')");
+    }
+    if (arr.shape(0) != (size_t)nx || arr.shape(1) != (size_t)ny || arr.shape(2) != (size_t)nz) {
+        throw std::invalid_argument("out must have shape (nx, ny, nz)");
+    }
+    return arr;
+}
+
 // Load mesh from file
-nb::tuple load_mesh(const std::string& filename) {
+nb::tuple load_mesh(const std::string& filename, bool dedup) {
     std::vector<Vec3f> vertices;
     std::vector<Vec3ui> triangles;
     Vec3f min_box, max_box;
 
-    bool success = meshio::load_mesh(filename.c_str(), vertices, triangles, min_box, max_box);
+    bool success = meshio::load_mesh(filename.c_str(), vertices, triangles, min_box, max_box, dedup);
 
     if (!success) {
         throw std::runtime_error("Failed to load mesh: " + filename);
@@ -156,8 +192,49 @@ nb::tuple load_mesh(const std::string& filename) {
     return nb::make_tuple(vert_array, tri_array, bounds);
 }
 
-// Generate SDF from numpy arrays
-nb::ndarray<nb::numpy, float> generate_sdf(
+/**
+ * @brief Parse a backend name ("auto", "cpu" or "gpu")
+ */
+sdfgen::HardwareBackend parse_backend(const std::string& backend) {
+    if (backend == "cpu") {
+        return sdfgen::HardwareBackend::CPU;
+    } else if (backend == "gpu") {
+        return sdfgen::HardwareBackend::GPU;
+    } else if (backend != "auto") {
+        throw std::invalid_argument("Invalid backend: " + backend + " (must be 'auto', 'cpu', or 'gpu')");
+    }
+    return sdfgen::HardwareBackend::Auto;
+}
+
+/**
+ * @brief Parse a sign rule name ("parity", "ray_vote" or "winding")
+ */
+sdfgen::SignMode parse_sign(const std::string& sign) {
+    if (sign == "ray_vote") {
+        return sdfgen::SignMode::RayVote;
+    } else if (sign == "winding") {
+        return sdfgen::SignMode::WindingNumber;
+    } else if (sign != "parity") {
+        throw std::invalid_argument("Invalid sign: " + sign + " (must be 'parity', 'ray_vote', or 'winding')");
+    }
+    return sdfgen::SignMode::Parity;
+}
+
+/**
+ * @brief Reject non-positive grid dimensions and cell sizes
+ */
+void validate_grid(int nx, int ny, int nz, float dx) {
+    if (nx <= 0 || ny <= 0 || nz <= 0) {
+        throw std::invalid_argument("Grid dimensions must be positive (nx, ny, nz > 0)");
+    }
+
+    if (dx <= 0.0f) {
+        throw std::invalid_argument("Cell spacing dx must be positive");
+    }
+}
+
+// Generate SDF from numpy arrays (into out when given)
+nb::object generate_sdf(
     nb::ndarray<float, nb::shape<-1, 3>, nb::c_contig> vertices,
     nb::ndarray<uint32_t, nb::shape<-1, 3>, nb::c_contig> triangles,
     nb::tuple origin,
@@ -165,7 +242,10 @@ nb::ndarray<nb::numpy, float> generate_sdf(
     int nx, int ny, int nz,
     int exact_band = 1,
     const std::string& backend = "auto",
-    int num_threads = 0
+    int num_threads = 0,
+    nb::object out = nb::none(),
+    sdfgen::GenerationStats* stats = nullptr,
+    bool diagnostics = false
 ) {
     // Validate mesh is not empty
     if (vertices.shape(0) == 0 || triangles.shape(0) == 0) {
@@ -173,13 +253,7 @@ nb::ndarray<nb::numpy, float> generate_sdf(
     }
 
     // Validate grid parameters
-    if (nx <= 0 || ny <= 0 || nz <= 0) {
-        throw std::invalid_argument("Grid dimensions must be positive (nx, ny, nz > 0)");
-    }
-
-    if (dx <= 0.0f) {
-        throw std::invalid_argument("Cell spacing dx must be positive");
-    }
+    validate_grid(nx, ny, nz, dx);
 
     // Convert inputs
     auto verts = numpy_to_vec3f(vertices);
@@ -191,38 +265,191 @@ nb::ndarray<nb::numpy, float> generate_sdf(
         nb::cast<float>(origin[2])
     );
 
-    // Parse backend
-    sdfgen::HardwareBackend hw_backend = sdfgen::HardwareBackend::Auto;
-    if (backend == "cpu") {
-        hw_backend = sdfgen::HardwareBackend::CPU;
-    } else if (backend == "gpu") {
-        hw_backend = sdfgen::HardwareBackend::GPU;
-    } else if (backend != "auto") {
-        throw std::invalid_argument("Invalid backend: " + backend + " (must be 'auto', 'cpu', or 'gpu')");
+    sdfgen::GenerationOptions options;
+    options.backend = parse_backend(backend);
+    options.exact_band = exact_band;
+    options.num_threads = num_threads;
+    options.diagnostics = diagnostics;
+
+    // Generate SDF (other Python threads run meanwhile)
+    if (!out.is_none()) {
+        OutputArray out_array = output_array(out, nx, ny, nz);
+        BorrowedGrid grid(out_array);
+        nb::gil_scoped_release release;
+        sdfgen::make_level_set3(tris, verts, origin_vec, dx, nx, ny, nz, grid.phi, options, stats);
+        return out;
     }
 
-    // Generate SDF
     Array3f phi;
-    sdfgen::make_level_set3(
-        tris, verts,
-        origin_vec, dx,
-        nx, ny, nz,
-        phi,
-        exact_band,
-        hw_backend,
-        num_threads
+    {
+        nb::gil_scoped_release release;
+        sdfgen::make_level_set3(tris, verts, origin_vec, dx, nx, ny, nz, phi, options, stats);
+    }
+
+    // Hand the grid to numpy
+    return nb::cast(array3f_to_numpy(phi));
+}
+
+// Generate SDFs for a list of (vertices, triangles, origin, dx, nx, ny, nz) jobs in one call
+nb::list generate_sdf_batch(
+    nb::list jobs,
+    int exact_band = 1,
+    const std::string& backend = "auto",
+    int num_threads = 0
+) {
+    std::vector<sdfgen::BatchItem> items(jobs.size());
+    for (size_t n = 0; n < items.size(); ++n) {
+        nb::tuple job = nb::cast<nb::tuple>(jobs[n]);
+        if (job.size() != 7) {
+            throw std::invalid_argument("Each batch job must be (vertices, triangles, origin, dx, nx, ny, nz)");
+        }
+        auto vertices = nb::cast<nb::ndarray<float, nb::shape<-1, 3>, nb::c_contig>>(job[0]);
+        auto triangles = nb::cast<nb::ndarray<uint32_t, nb::shape<-1, 3>, nb::c_contig>>(job[1]);
+        if (vertices.shape(0) == 0 || triangles.shape(0) == 0) {
+            throw std::invalid_argument("Cannot generate SDF from empty mesh (vertices or triangles are empty)");
+        }
+
+        sdfgen::BatchItem& item = items[n];
+        nb::tuple origin = nb::cast<nb::tuple>(job[2]);
+        item.dx = nb::cast<float>(job[3]);
+        item.nx = nb::cast<int>(job[4]);
+        item.ny = nb::cast<int>(job[5]);
+        item.nz = nb::cast<int>(job[6]);
+        validate_grid(item.nx, item.ny, item.nz, item.dx);
+
+        item.x = numpy_to_vec3f(vertices);
+        item.tri = numpy_to_vec3ui(triangles);
+        item.origin = Vec3f(
+            nb::cast<float>(origin[0]),
+            nb::cast<float>(origin[1]),
+            nb::cast<float>(origin[2])
+        );
+    }
+
+    sdfgen::GenerationOptions options;
+    options.backend = parse_backend(backend);
+    options.exact_band = exact_band;
+    options.num_threads = num_threads;
+
+    std::vector<Array3f> phis;
+    {
+        nb::gil_scoped_release release;
+        sdfgen::make_level_set3_batch(items, phis, options);
+    }
+
+    nb::list result;
+    for (Array3f& phi : phis) {
+        result.append(array3f_to_numpy(phi));
+    }
+    return result;
+}
+
+// Store a mesh in a generation context (validated like generate_sdf)
+void context_set_mesh(
+    sdfgen::GenerationContext& context,
+    nb::ndarray<float, nb::shape<-1, 3>, nb::c_contig> vertices,
+    nb::ndarray<uint32_t, nb::shape<-1, 3>, nb::c_contig> triangles
+) {
+    if (vertices.shape(0) == 0 || triangles.shape(0) == 0) {
+        throw std::invalid_argument("Cannot generate SDF from empty mesh (vertices or triangles are empty)");
+    }
+    context.set_mesh(numpy_to_vec3ui(triangles), numpy_to_vec3f(vertices));
+}
+
+// Generate SDF from the mesh held by a context (device buffers and mesh upload are reused)
+nb::object context_generate_sdf(
+    sdfgen::GenerationContext& context,
+    nb::tuple origin,
+    float dx,
+    int nx, int ny, int nz,
+    int exact_band = 1,
+    const std::string& backend = "auto",
+    int num_threads = 0,
+    nb::object out = nb::none()
+) {
+    validate_grid(nx, ny, nz, dx);
+
+    Vec3f origin_vec(
+        nb::cast<float>(origin[0]),
+        nb::cast<float>(origin[1]),
+        nb::cast<float>(origin[2])
     );
 
-    // Convert to numpy
-    return array3f_to_numpy(phi);
+    sdfgen::GenerationOptions options;
+    options.backend = parse_backend(backend);
+    options.exact_band = exact_band;
+    options.num_threads = num_threads;
+
+    if (!out.is_none()) {
+        OutputArray out_array = output_array(out, nx, ny, nz);
+        BorrowedGrid grid(out_array);
+        nb::gil_scoped_release release;
+        sdfgen::make_level_set3(context, origin_vec, dx, nx, ny, nz, grid.phi, options);
+        return out;
+    }
+
+    Array3f phi;
+    {
+        nb::gil_scoped_release release;
+        sdfgen::make_level_set3(context, origin_vec, dx, nx, ny, nz, phi, options);
+    }
+    return nb::cast(array3f_to_numpy(phi));
+}
+
+// Signed distance at scattered points; results are written straight into NumPy-owned buffers
+nb::object context_query(
+    sdfgen::GenerationContext& context,
+    nb::ndarray<float, nb::shape<-1, 3>, nb::c_contig> points,
+    const std::string& sign = "parity",
+    bool closest = false,
+    const std::string& backend = "auto",
+    int num_threads = 0
+) {
+    sdfgen::GenerationOptions options;
+    options.backend = parse_backend(backend);
+    options.sign_mode = parse_sign(sign);
+    options.num_threads = num_threads;
+
+    size_t count = points.shape(0);
+    size_t slots = count > 0 ? count : 1;
+    float* distance = new float[slots];
+    nb::capsule distance_owner(distance, [](void* p) noexcept { delete[] static_cast<float*>(p); });
+    if (!closest) {
+        {
+            nb::gil_scoped_release release;
+            sdfgen::query_points(context, reinterpret_cast<const Vec3f*>(points.data()), count, distance, options);
+        }
+        return nb::cast(nb::ndarray<nb::numpy, float>(distance, {count}, distance_owner));
+    }
+
+    int* tri = new int[slots];
+    nb::capsule tri_owner(tri, [](void* p) noexcept { delete[] static_cast<int*>(p); });
+    Vec3f* weights = new Vec3f[slots];
+    nb::capsule weight_owner(weights, [](void* p) noexcept { delete[] static_cast<Vec3f*>(p); });
+    {
+        nb::gil_scoped_release release;
+        sdfgen::query_points(context, reinterpret_cast<const Vec3f*>(points.data()), count, distance, options,
+                             nullptr, tri, weights);
+    }
+    nb::ndarray<nb::numpy, float> distance_array(distance, {count}, distance_owner);
+    nb::ndarray<nb::numpy, int32_t> tri_array(tri, {count}, tri_owner);
+    nb::ndarray<nb::numpy, float> weight_array(reinterpret_cast<float*>(weights), {count, (size_t)3}, weight_owner);
+    return nb::make_tuple(distance_array, tri_array, weight_array);
+}
+
+// True for the chunked compressed format (.csdf); everything else is the dense .sdf format
+static bool has_csdf_extension(const std::string& filename) {
+    return filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".csdf") == 0;
 }
 
 // Save SDF to binary file
 void save_sdf(
     const std::string& filename,
-    nb::ndarray<float, nb::shape<-1, -1, -1>, nb::c_contig> sdf_array,
+    nb::ndarray<float, nb::ndim<3>, nb::device::cpu> sdf_array,
     nb::tuple origin,
-    float dx
+    float dx,
+    int quantize_bits,
+    float band
 ) {
     // Validate array dimensions
     if (sdf_array.ndim() != 3) {
@@ -238,14 +465,20 @@ void save_sdf(
         throw std::invalid_argument("SDF array dimensions cannot be zero");
     }
 
-    // Convert numpy array to Array3f
+    // Convert numpy array to Array3f: one block copy for arrays returned by generate_sdf()
+    // (Fortran order), a strided gather for any other layout
     Array3f phi(nx, ny, nz);
-    auto data = sdf_array.data();
-
-    for (size_t i = 0; i < nx; ++i) {
-        for (size_t j = 0; j < ny; ++j) {
-            for (size_t k = 0; k < nz; ++k) {
-                phi(i, j, k) = data[i * ny * nz + j * nz + k];
+    const float* data = sdf_array.data();
+    int64_t si = sdf_array.stride(0), sj = sdf_array.stride(1), sk = sdf_array.stride(2);
+
+    if (si == 1 && sj == (int64_t)nx && sk == (int64_t)(nx * ny)) {
+        std::memcpy(phi.a.data, data, nx * ny * nz * sizeof(float));
+    } else {
+        for (size_t k = 0; k < nz; ++k) {
+            for (size_t j = 0; j < ny; ++j) {
+                for (size_t i = 0; i < nx; ++i) {
+                    phi(i, j, k) = data[i * si + j * sj + k * sk];
+                }
             }
         }
     }
@@ -263,14 +496,32 @@ void save_sdf(
         origin_vec[2] + dx * nz
     );
 
-    // Compute dx from the metadata
-    // Save using existing I/O function
-    bool success = write_sdf_binary(
-        filename,
-        phi,
-        origin_vec,
-        dx
-    );
+    bool compressed = has_csdf_extension(filename);
+    if (!compressed && (quantize_bits != 0 || band != 0.0f)) {
+        throw std::invalid_argument("quantize_bits and band apply to .csdf files only");
+    }
+    if (quantize_bits != 0 && quantize_bits != 8 && quantize_bits != 16) {
+        throw std::invalid_argument("quantize_bits must be 0, 8 or 16");
+    }
+
+    bool success;
+    {
+        nb::gil_scoped_release release;
+        if (compressed) {
+            sdfgen::SdfCompression options;
+            options.quantize_bits = quantize_bits;
+            options.band = band;
+            success = write_compressed_sdf(filename, phi, origin_vec, dx, options);
+        } else {
+            // Save using existing I/O function
+            success = write_sdf_binary(
+                filename,
+                phi,
+                origin_vec,
+                dx
+            );
+        }
+    }
 
     if (!success) {
         throw std::runtime_error("Failed to write SDF file: " + filename);
@@ -282,20 +533,27 @@ nb::tuple load_sdf(const std::string& filename) {
     Array3f phi;
     Vec3f min_box, max_box;
 
-    bool success = read_sdf_binary(
-        filename,
-        phi,
-        min_box,
-        max_box
-    );
+    bool success;
+    {
+        nb::gil_scoped_release release;
+        if (has_csdf_extension(filename)) {
+            float spacing;
+            success = read_compressed_sdf(filename, phi, min_box, spacing);
+            max_box = min_box + spacing * Vec3f((float)phi.ni, (float)phi.nj, (float)phi.nk);
+        } else {
+            success = read_sdf_binary(
+                filename,
+                phi,
+                min_box,
+                max_box
+            );
+        }
+    }
 
     if (!success) {
         throw std::runtime_error("Failed to read SDF file: " + filename);
     }
 
-    // Convert to numpy
-    auto sdf_array = array3f_to_numpy(phi);
-
     // Compute metadata
     float dx = (max_box[0] - min_box[0]) / phi.ni;
     auto origin = nb::make_tuple(min_box[0], min_box[1], min_box[2]);
@@ -304,9 +562,67 @@ nb::tuple load_sdf(const std::string& filename) {
         nb::make_tuple(max_box[0], max_box[1], max_box[2])
     );
 
+    // Convert to numpy (takes the grid's storage)
+    auto sdf_array = array3f_to_numpy(phi);
+
     return nb::make_tuple(sdf_array, origin, dx, bounds);
 }
 
+// Open a memory-mapped SDF file
+void mapped_sdf_init(sdfgen::MappedSDF* self, const std::string& filename) {
+    new (self) sdfgen::MappedSDF();
+    if (!self->open(filename)) {
+        self->~MappedSDF();
+        throw std::runtime_error("Failed to map SDF file: " + filename);
+    }
+}
+
+// Read-only (nx, ny, nz) view of the mapped values; the MappedSDF object owns the memory
+nb::ndarray<nb::numpy, const float> mapped_sdf_array(nb::handle_t<sdfgen::MappedSDF> self) {
+    const sdfgen::MappedSDF& sdf = nb::cast<const sdfgen::MappedSDF&>(self);
+    size_t ni = sdf.ni(), nj = sdf.nj(), nk = sdf.nk();
+    bool native = sdf.layout() == sdfgen::SdfLayout::Native;
+    int64_t strides[3] = {
+        native ? 1 : (int64_t)(nj * nk),
+        native ? (int64_t)ni : (int64_t)nk,
+        native ? (int64_t)(ni * nj) : 1
+    };
+    size_t shape[3] = {ni, nj, nk};
+    return nb::ndarray<nb::numpy, const float>(sdf.data(), 3, shape, self, strides);
+}
+
+// Interpolated distance (or gradient) at each of N points
+nb::ndarray<nb::numpy, float> mapped_sdf_query(const sdfgen::MappedSDF& sdf,
+                                               nb::ndarray<float, nb::shape<-1, 3>, nb::c_contig> points,
+                                               bool gradient) {
+    if (!sdf.is_open()) {
+        throw std::runtime_error("MappedSDF is closed");
+    }
+    size_t n = points.shape(0);
+    size_t width = gradient ? 3 : 1;
+    float* data = new float[n * width];
+    const float* p = points.data();
+    for (size_t t = 0; t < n; ++t) {
+        Vec3f point(p[t * 3 + 0], p[t * 3 + 1], p[t * 3 + 2]);
+        if (gradient) {
+            Vec3f g = sdf.gradient(point);
+            data[t * 3 + 0] = g[0];
+            data[t * 3 + 1] = g[1];
+            data[t * 3 + 2] = g[2];
+        } else {
+            data[t] = sdf.sample(point);
+        }
+    }
+
+    nb::capsule owner(data, [](void* ptr) noexcept {
+        delete[] static_cast<float*>(ptr);
+    });
+    if (gradient) {
+        return nb::ndarray<nb::numpy, float>(data, {n, 3}, owner);
+    }
+    return nb::ndarray<nb::numpy, float>(data, {n}, owner);
+}
+
 // Query GPU availability
 bool is_gpu_available() {
     return sdfgen::is_gpu_available();
@@ -318,12 +634,15 @@ NB_MODULE(sdfgen_ext, m) {
 
     // Core functions
     m.def("load_mesh", &load_mesh,
-        "filename"_a,
+        "filename"_a, "dedup"_a = false,
         "Load a triangle mesh from file (OBJ or STL)\n\n"
         "Parameters\n"
         "----------\n"
         "filename : str\n"
-        "    Path to mesh file (.obj or .stl)\n\n"
+        "    Path to mesh file (.obj or .stl)\n"
+        "dedup : bool, optional\n"
+        "    Merge vertices with identical coordinates into an indexed mesh\n"
+        "    (STL stores 3 vertices per triangle). Default: False\n\n"
         "Returns\n"
         "-------\n"
         "vertices : ndarray, shape (N, 3), dtype float32\n"
@@ -341,7 +660,11 @@ NB_MODULE(sdfgen_ext, m) {
         "exact_band"_a = 1,
         "backend"_a = "auto",
         "num_threads"_a = 0,
+        "out"_a = nb::none(),
+        "stats"_a.none() = nb::none(),
+        "diagnostics"_a = false,
         "Generate a signed distance field from a triangle mesh\n\n"
+        "The GIL is released while the field is computed, so other Python threads run.\n\n"
         "Parameters\n"
         "----------\n"
         "vertices : ndarray, shape (N, 3), dtype float32\n"
@@ -359,26 +682,172 @@ NB_MODULE(sdfgen_ext, m) {
         "backend : str, optional\n"
         "    Hardware backend: 'auto', 'cpu', or 'gpu' (default: 'auto')\n"
         "num_threads : int, optional\n"
-        "    Number of CPU threads, 0 for auto-detect (default: 0)\n\n"
+        "    Number of CPU threads, 0 for auto-detect (default: 0)\n"
+        "out : ndarray, shape (nx, ny, nz), dtype float32, order 'F', optional\n"
+        "    Array to write the field into (no allocation); returned as the result\n"
+        "stats : GenerationStats, optional\n"
+        "    Filled with the backend used, phase times, work counters and memory\n"
+        "diagnostics : bool, optional\n"
+        "    Also compute the near-band statistics and the GPU counters (default: False)\n\n"
         "Returns\n"
         "-------\n"
         "sdf : ndarray, shape (nx, ny, nz), dtype float32\n"
-        "    Signed distance field (negative inside, positive outside, zero on surface)"
+        "    Signed distance field (negative inside, positive outside, zero on surface).\n"
+        "    Fortran-ordered: the generator's buffer, handed over without a copy"
     );
 
+    nb::class_<sdfgen::GenerationStats>(m, "GenerationStats",
+        "What a generate_sdf(..., stats=...) call did\n\n"
+        "Phase times are wall-clock milliseconds of dense generation (streamed and multi-GPU\n"
+        "runs leave them at 0). The near_band_* fields and intersections need\n"
+        "diagnostics=True; so do distance_evaluations and gpu_cas_retries on the GPU.")
+        .def(nb::init<>())
+        .def_prop_ro("backend_used", [](const sdfgen::GenerationStats& stats) {
+                return stats.backend_used == sdfgen::HardwareBackend::GPU ? "gpu"
+                     : stats.backend_used == sdfgen::HardwareBackend::CPU ? "cpu" : "auto";
+            }, "Backend that ran: 'cpu' or 'gpu' ('auto' before any call)")
+        .def_ro("backend_auto", &sdfgen::GenerationStats::backend_auto,
+                "backend='auto' chose by the cost model")
+        .def_ro("estimated_cpu_ms", &sdfgen::GenerationStats::estimated_cpu_ms, "Auto: predicted CPU time")
+        .def_ro("estimated_gpu_ms", &sdfgen::GenerationStats::estimated_gpu_ms,
+                "Auto: predicted GPU time, 0 when the GPU could not run the call")
+        .def_ro("setup_ms", &sdfgen::GenerationStats::setup_ms, "Grid allocation and initialization")
+        .def_ro("near_band_ms", &sdfgen::GenerationStats::near_band_ms, "Exact near-band distances and crossings")
+        .def_ro("sweep_ms", &sdfgen::GenerationStats::sweep_ms, "Far field (sweeps, or the exact BVH pass)")
+        .def_ro("sign_ms", &sdfgen::GenerationStats::sign_ms, "Inside/outside signs")
+        .def_ro("copy_ms", &sdfgen::GenerationStats::copy_ms, "GPU: device to host copy")
+        .def_ro("distance_evaluations", &sdfgen::GenerationStats::distance_evaluations,
+            "Point-triangle distances computed")
+        .def_ro("gpu_cas_retries", &sdfgen::GenerationStats::gpu_cas_retries,
+            "GPU: near-band compare-and-swap attempts lost to another thread")
+        .def_ro("sweep_iterations", &sdfgen::GenerationStats::sweep_iterations, "Far-field iterations run")
+        .def_ro("sweep_converged", &sdfgen::GenerationStats::sweep_converged, "GPU: stopped on convergence")
+        .def_ro("winding_evaluations", &sdfgen::GenerationStats::winding_evaluations,
+            "Winding-number queries of the sign pass")
+        .def_ro("host_bytes", &sdfgen::GenerationStats::host_bytes, "Peak host memory for grids and scratch")
+        .def_ro("device_bytes", &sdfgen::GenerationStats::device_bytes, "GPU: device memory held")
+        .def_ro("bytes_to_device", &sdfgen::GenerationStats::bytes_to_device, "GPU: host to device transfers")
+        .def_ro("bytes_to_host", &sdfgen::GenerationStats::bytes_to_host, "GPU: device to host transfers")
+        .def_ro("diagnostics_valid", &sdfgen::GenerationStats::diagnostics_valid,
+            "True when the near-band statistics were computed")
+        .def_ro("near_band_cells", &sdfgen::GenerationStats::near_band_cells, "Cells given an exact distance")
+        .def_ro("near_band_min", &sdfgen::GenerationStats::near_band_min, "Smallest near-band distance")
+        .def_ro("near_band_max", &sdfgen::GenerationStats::near_band_max, "Largest near-band distance")
+        .def_ro("intersections", &sdfgen::GenerationStats::intersections, "Ray/triangle crossings");
+
+    m.def("generate_sdf_batch", &generate_sdf_batch,
+        "jobs"_a,
+        "exact_band"_a = 1,
+        "backend"_a = "auto",
+        "num_threads"_a = 0,
+        "Generate signed distance fields for many meshes in one call\n\n"
+        "On the GPU, jobs that fit in device memory together are uploaded and processed\n"
+        "with one kernel launch per phase instead of one generation per mesh; on the CPU\n"
+        "the jobs are spread over the thread pool. Worth it for many small meshes.\n\n"
+        "Parameters\n"
+        "----------\n"
+        "jobs : list of tuple\n"
+        "    (vertices, triangles, origin, dx, nx, ny, nz) per mesh, with the same\n"
+        "    types as the matching generate_sdf() arguments\n"
+        "exact_band : int, optional\n"
+        "    Distance band for exact computation (default: 1)\n"
+        "backend : str, optional\n"
+        "    Hardware backend: 'auto', 'cpu', or 'gpu' (default: 'auto')\n"
+        "num_threads : int, optional\n"
+        "    Number of CPU threads, 0 for auto-detect (default: 0)\n\n"
+        "Returns\n"
+        "-------\n"
+        "sdfs : list of ndarray\n"
+        "    One (nx, ny, nz) float32 field per job, in job order"
+    );
+
+    nb::class_<sdfgen::GenerationContext>(m, "GenerationContext",
+        "Generation session that keeps a mesh and GPU device memory between calls\n\n"
+        "Repeated generate_sdf() calls on the same context skip the mesh conversion and,\n"
+        "on the GPU, the device allocations and mesh upload. Use set_mesh() to push\n"
+        "further meshes through the same buffers.")
+        .def("__init__",
+            [](sdfgen::GenerationContext* self,
+               nb::ndarray<float, nb::shape<-1, 3>, nb::c_contig> vertices,
+               nb::ndarray<uint32_t, nb::shape<-1, 3>, nb::c_contig> triangles) {
+                new (self) sdfgen::GenerationContext();
+                context_set_mesh(*self, vertices, triangles);
+            },
+            "vertices"_a, "triangles"_a,
+            "Create a context holding a mesh\n\n"
+            "Parameters\n"
+            "----------\n"
+            "vertices : ndarray, shape (N, 3), dtype float32\n"
+            "    Vertex positions\n"
+            "triangles : ndarray, shape (M, 3), dtype uint32\n"
+            "    Triangle indices (zero-based)")
+        .def("set_mesh", &context_set_mesh,
+            "vertices"_a, "triangles"_a,
+            "Replace the mesh; cached device buffers are reused")
+        .def("generate_sdf", &context_generate_sdf,
+            "origin"_a, "dx"_a,
+            "nx"_a, "ny"_a, "nz"_a,
+            "exact_band"_a = 1,
+            "backend"_a = "auto",
+            "num_threads"_a = 0,
+            "out"_a = nb::none(),
+            "Generate a signed distance field for the context's mesh\n\n"
+            "Same parameters and result as sdfgen.generate_sdf() without the mesh arrays.\n"
+            "The GIL is released while computing; use one context per thread.")
+        .def("query", &context_query,
+            "points"_a,
+            "sign"_a = "parity",
+            "closest"_a = false,
+            "backend"_a = "auto",
+            "num_threads"_a = 0,
+            "Signed distance from the context's mesh at scattered points, without a grid\n\n"
+            "The search tree (and the winding-number tree for sign='winding') is built on the\n"
+            "first call and reused by later ones.\n\n"
+            "Parameters\n"
+            "----------\n"
+            "points : ndarray, shape (N, 3), dtype float32\n"
+            "    Query points\n"
+            "sign : str, optional\n"
+            "    Inside/outside rule: 'parity', 'ray_vote' or 'winding' (default: 'parity')\n"
+            "closest : bool, optional\n"
+            "    Also return the nearest triangle and the barycentric weights of the nearest\n"
+            "    point on it (default: False)\n"
+            "backend : str, optional\n"
+            "    Hardware backend: 'auto', 'cpu', or 'gpu' (default: 'auto')\n"
+            "num_threads : int, optional\n"
+            "    Number of CPU threads, 0 for auto-detect (default: 0)\n\n"
+            "Returns\n"
+            "-------\n"
+            "distance : ndarray, shape (N,), dtype float32\n"
+            "    Signed distances, negative inside\n"
+            "triangle : ndarray, shape (N,), dtype int32\n"
+            "    Only with closest=True: index of the nearest triangle\n"
+            "barycentric : ndarray, shape (N, 3), dtype float32\n"
+            "    Only with closest=True: weights of the nearest point on that triangle's corners")
+        .def("release", &sdfgen::GenerationContext::release,
+            "Free cached device memory (the mesh is kept)")
+        .def_prop_ro("device_bytes", &sdfgen::GenerationContext::device_bytes,
+            "Device memory currently cached, in bytes");
+
     m.def("save_sdf", &save_sdf,
-        "filename"_a, "sdf_array"_a, "origin"_a, "dx"_a,
+        "filename"_a, "sdf_array"_a, "origin"_a, "dx"_a, "quantize_bits"_a = 0, "band"_a = 0.0f,
         "Save SDF to binary file\n\n"
         "Parameters\n"
         "----------\n"
         "filename : str\n"
-        "    Output file path (.sdf)\n"
+        "    Output file path (.sdf, or .csdf for compressed 32^3 chunks)\n"
         "sdf_array : ndarray, shape (nx, ny, nz), dtype float32\n"
         "    Signed distance field\n"
         "origin : tuple of float\n"
         "    Grid origin (x, y, z)\n"
         "dx : float\n"
-        "    Grid cell spacing"
+        "    Grid cell spacing\n"
+        "quantize_bits : int, optional\n"
+        "    .csdf only: 0 stores float32 (lossless), 8 or 16 stores fixed point over\n"
+        "    [-band, band] with error at most band / (2**bits - 1); signs are kept\n"
+        "band : float, optional\n"
+        "    .csdf only: clamp |sdf| to this distance first (0 = no clamp; quantization\n"
+        "    then uses max |sdf|)"
     );
 
     m.def("load_sdf", &load_sdf,
@@ -387,7 +856,7 @@ NB_MODULE(sdfgen_ext, m) {
         "Parameters\n"
         "----------\n"
         "filename : str\n"
-        "    Input file path (.sdf)\n\n"
+        "    Input file path (.sdf or .csdf)\n\n"
         "Returns\n"
         "-------\n"
         "sdf : ndarray, shape (nx, ny, nz), dtype float32\n"
@@ -400,7 +869,69 @@ NB_MODULE(sdfgen_ext, m) {
         "    ((min_x, min_y, min_z), (max_x, max_y, max_z))"
     );
 
+    nb::class_<sdfgen::MappedSDF>(m, "MappedSDF",
+        "Memory-mapped view of a binary SDF file\n\n"
+        "Opening only maps the file; values are paged in as they are touched, so a few\n"
+        "queries into a multi-gigabyte field read only the pages around them. Node\n"
+        "(i, j, k) sits at origin + dx * (i, j, k).")
+        .def("__init__", &mapped_sdf_init,
+            "filename"_a,
+            "Map an SDF file written by save_sdf() or the SDFGen CLI (either layout)")
+        .def_prop_ro("shape",
+            [](const sdfgen::MappedSDF& sdf) { return nb::make_tuple(sdf.ni(), sdf.nj(), sdf.nk()); },
+            "Grid dimensions (nx, ny, nz)")
+        .def_prop_ro("origin",
+            [](const sdfgen::MappedSDF& sdf) {
+                return nb::make_tuple(sdf.min_box()[0], sdf.min_box()[1], sdf.min_box()[2]);
+            },
+            "Grid origin (x, y, z)")
+        .def_prop_ro("dx", &sdfgen::MappedSDF::dx,
+            "Grid cell spacing")
+        .def_prop_ro("array", &mapped_sdf_array,
+            "Read-only ndarray of shape (nx, ny, nz) backed by the mapped file (no copy)")
+        .def("value",
+            [](const sdfgen::MappedSDF& sdf, int i, int j, int k) {
+                if (i < 0 || i >= sdf.ni() || j < 0 || j >= sdf.nj() || k < 0 || k >= sdf.nk()) {
+                    throw nb::index_error("Node index outside the grid");
+                }
+                return sdf.value(i, j, k);
+            },
+            "i"_a, "j"_a, "k"_a,
+            "Distance stored at node (i, j, k)")
+        .def("sample",
+            [](const sdfgen::MappedSDF& sdf, nb::ndarray<float, nb::shape<-1, 3>, nb::c_contig> points) {
+                return mapped_sdf_query(sdf, points, false);
+            },
+            "points"_a,
+            "Trilinearly interpolated distances\n\n"
+            "Parameters\n"
+            "----------\n"
+            "points : ndarray, shape (N, 3), dtype float32\n"
+            "    World-space query points (clamped onto the grid)\n\n"
+            "Returns\n"
+            "-------\n"
+            "ndarray, shape (N,), dtype float32")
+        .def("gradient",
+            [](const sdfgen::MappedSDF& sdf, nb::ndarray<float, nb::shape<-1, 3>, nb::c_contig> points) {
+                return mapped_sdf_query(sdf, points, true);
+            },
+            "points"_a,
+            "Gradients of the trilinear interpolant (not normalized)\n\n"
+            "Parameters\n"
+            "----------\n"
+            "points : ndarray, shape (N, 3), dtype float32\n"
+            "    World-space query points (clamped onto the grid)\n\n"
+            "Returns\n"
+            "-------\n"
+            "ndarray, shape (N, 3), dtype float32")
+        .def("close", &sdfgen::MappedSDF::close,
+            "Unmap the file (arrays obtained from .array must no longer be used)");
+
     // Utility functions
+    m.def("set_logging", &sdfgen::set_log_enabled,
+        "enabled"_a,
+        "Turn the progress messages of load_mesh() on or off (errors are always printed)");
+
     m.def("is_gpu_available", &is_gpu_available,
         "Check if GPU acceleration (CUDA) is available\n\n"
         "Returns\n"
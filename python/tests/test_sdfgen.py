@@ -145,6 +145,28 @@ class TestBasicFunctionality:
         assert len(min_box) == 3
         assert len(max_box) == 3
 
+    def test_load_mesh_dedup(self, simple_cube):
+        """Test that dedup turns an STL triangle soup into an indexed mesh."""
+        vertices, triangles = simple_cube
+        with tempfile.NamedTemporaryFile(suffix=".stl", delete=False) as f:
+            f.write(b"\0" * 80)
+            f.write(np.uint32(len(triangles)).tobytes())
+            for tri in triangles:
+                f.write(np.zeros(3, dtype=np.float32).tobytes())
+                f.write(vertices[tri].astype(np.float32).tobytes())
+                f.write(b"\0\0")
+            temp_path = f.name
+        try:
+            soup_vertices, soup_triangles, _ = sdfgen.load_mesh(temp_path)
+            indexed_vertices, indexed_triangles, _ = sdfgen.load_mesh(temp_path, dedup=True)
+            assert len(soup_vertices) == 3 * len(triangles)
+            assert len(indexed_vertices) == len(vertices)
+            np.testing.assert_array_equal(
+                indexed_vertices[indexed_triangles], soup_vertices[soup_triangles]
+            )
+        finally:
+            os.unlink(temp_path)
+
     def test_generate_from_file(self, temp_obj_file):
         """Test high-level API: generate_from_file."""
         sdf, metadata = sdfgen.generate_from_file(temp_obj_file, nx=32, padding=2)
@@ -205,6 +227,345 @@ class TestBasicFunctionality:
         assert np.allclose(loaded_sdf, sdf)
         assert loaded_dx == pytest.approx(0.1)
 
+    def test_save_and_load_compressed_sdf(self, tmp_path):
+        """Test the .csdf format: lossless float32, and quantization within half a step."""
+        rng = np.random.default_rng(7)
+        sdf = rng.uniform(-1.0, 1.0, size=(40, 35, 33)).astype(np.float32)
+        path = str(tmp_path / "field.csdf")
+
+        sdfgen.save_sdf(path, sdf, origin=(1.0, 2.0, 3.0), dx=0.05)
+        loaded_sdf, loaded_origin, loaded_dx, _ = sdfgen.load_sdf(path)
+        assert np.array_equal(loaded_sdf, sdf)
+        assert loaded_origin == pytest.approx((1.0, 2.0, 3.0))
+        assert loaded_dx == pytest.approx(0.05)
+
+        sdfgen.save_sdf(path, sdf, origin=(1.0, 2.0, 3.0), dx=0.05, quantize_bits=8, band=0.5)
+        loaded_sdf, _, _, _ = sdfgen.load_sdf(path)
+        clamped = np.clip(sdf, -0.5, 0.5)
+        assert np.max(np.abs(loaded_sdf - clamped)) <= 0.5 / 255 * 1.001
+        assert np.array_equal(loaded_sdf < 0, sdf < 0)
+
+    def test_compression_options_need_csdf(self, temp_sdf_file):
+        """Test that quantization is rejected for the dense .sdf format."""
+        sdf = np.zeros((4, 4, 4), dtype=np.float32)
+        with pytest.raises(ValueError):
+            sdfgen.save_sdf(temp_sdf_file, sdf, origin=(0, 0, 0), dx=1.0, quantize_bits=8)
+
+
+# Memory-mapped SDF tests
+class TestMappedSDF:
+    """
+    Test MappedSDF random access into SDF files.
+
+    Validates that the mapped array matches load_sdf() without copying, that sampling
+    reproduces node values, and that the gradient of a linear field is its slope.
+    """
+
+    def test_array_matches_load_sdf(self, simple_cube, temp_sdf_file):
+        """Test that the mapped array equals the loaded field."""
+        vertices, triangles = simple_cube
+        sdf = sdfgen.generate_sdf(
+            vertices, triangles, origin=(-0.5, -0.5, -0.5), dx=0.1, nx=20, ny=18, nz=16
+        )
+        sdfgen.save_sdf(temp_sdf_file, sdf, origin=(-0.5, -0.5, -0.5), dx=0.1)
+
+        mapped = sdfgen.MappedSDF(temp_sdf_file)
+        assert mapped.shape == (20, 18, 16)
+        assert mapped.dx == pytest.approx(0.1)
+        assert np.array_equal(mapped.array, sdf)
+        assert not mapped.array.flags.writeable
+        assert mapped.value(3, 4, 5) == sdf[3, 4, 5]
+        with pytest.raises(IndexError):
+            mapped.value(20, 0, 0)
+
+        # Sampling at nodes returns the stored values
+        nodes = np.array([[3, 4, 5], [0, 0, 0], [19, 17, 15]], dtype=np.float32)
+        points = (np.array(mapped.origin, dtype=np.float32) + 0.1 * nodes).astype(np.float32)
+        expected = [sdf[3, 4, 5], sdf[0, 0, 0], sdf[19, 17, 15]]
+        assert np.allclose(mapped.sample(points), expected, atol=1e-5)
+        mapped.close()
+
+    def test_gradient_of_linear_field(self, temp_sdf_file):
+        """Test sample() and gradient() on a field that trilinear interpolation reproduces."""
+        i, j, k = np.meshgrid(np.arange(8), np.arange(9), np.arange(10), indexing="ij")
+        field = (0.5 * i - 0.25 * j + 2.0 * k).astype(np.float32) * 0.25
+        sdfgen.save_sdf(temp_sdf_file, field, origin=(1.0, 2.0, 3.0), dx=0.25)
+
+        mapped = sdfgen.MappedSDF(temp_sdf_file)
+        points = np.array([[1.3, 2.6, 3.9], [2.1, 3.0, 4.4]], dtype=np.float32)
+        grid = (points - np.array([1.0, 2.0, 3.0], dtype=np.float32)) / 0.25
+        expected = (0.5 * grid[:, 0] - 0.25 * grid[:, 1] + 2.0 * grid[:, 2]) * 0.25
+        assert np.allclose(mapped.sample(points), expected, atol=1e-4)
+        assert np.allclose(mapped.gradient(points), [[0.5, -0.25, 2.0]] * 2, atol=1e-4)
+
+    def test_rejects_truncated_file(self, temp_sdf_file):
+        """Test that a file shorter than its header says is rejected."""
+        sdfgen.save_sdf(temp_sdf_file, np.zeros((4, 4, 4), dtype=np.float32), origin=(0, 0, 0), dx=1.0)
+        with open(temp_sdf_file, "r+b") as f:
+            f.truncate(36 + 4 * 63)
+        with pytest.raises(RuntimeError):
+            sdfgen.MappedSDF(temp_sdf_file)
+
+
+# Zero-copy result and output array tests
+class TestZeroCopy:
+    """
+    Test that grids cross the binding without copies.
+
+    Tests cover:
+    - generate_sdf() returns the generator's buffer (Fortran order, owns its data)
+    - out= fills a caller's array in place and rejects layouts it would have to convert
+    - Concurrent calls from Python threads (GIL released) give the serial result
+    """
+    def test_result_is_fortran_ordered(self, simple_cube):
+        """Test the layout of a generated field."""
+        vertices, triangles = simple_cube
+        sdf = sdfgen.generate_sdf(vertices, triangles, origin=(-1.0, -1.0, -1.0), dx=0.1,
+                                  nx=20, ny=16, nz=12, backend="cpu")
+        assert sdf.shape == (20, 16, 12)
+        assert sdf.flags.f_contiguous
+        assert sdf.flags.writeable
+        assert sdf[0, 0, 0] > 0
+
+    def test_out_array(self, simple_cube, temp_sdf_file):
+        """Test that out= is written in place and returned."""
+        vertices, triangles = simple_cube
+        expected = sdfgen.generate_sdf(vertices, triangles, origin=(-1.0, -1.0, -1.0), dx=0.1,
+                                       nx=20, ny=16, nz=12, backend="cpu")
+        out = np.empty((20, 16, 12), dtype=np.float32, order="F")
+        result = sdfgen.generate_sdf(vertices, triangles, origin=(-1.0, -1.0, -1.0), dx=0.1,
+                                     nx=20, ny=16, nz=12, backend="cpu", out=out)
+        assert result is out
+        assert np.array_equal(out, expected)
+
+        # Both layouts save to the same file contents
+        sdfgen.save_sdf(temp_sdf_file, np.ascontiguousarray(out), origin=(0, 0, 0), dx=0.1)
+        c_order, _, _, _ = sdfgen.load_sdf(temp_sdf_file)
+        sdfgen.save_sdf(temp_sdf_file, out, origin=(0, 0, 0), dx=0.1)
+        f_order, _, _, _ = sdfgen.load_sdf(temp_sdf_file)
+        assert np.array_equal(c_order, f_order)
+
+        context = sdfgen.GenerationContext(vertices, triangles)
+        out[:] = 0
+        context.generate_sdf(origin=(-1.0, -1.0, -1.0), dx=0.1, nx=20, ny=16, nz=12,
+                             backend="cpu", out=out)
+        assert np.array_equal(out, expected)
+
+    def test_out_array_rejected(self, simple_cube):
+        """Test that out= must not need a conversion."""
+        vertices, triangles = simple_cube
+        for out in (np.empty((10, 10, 10), dtype=np.float32),               # C order
+                    np.empty((10, 10, 10), dtype=np.float64, order="F"),   # dtype
+                    np.empty((10, 10, 9), dtype=np.float32, order="F")):   # shape
+            with pytest.raises(ValueError):
+                sdfgen.generate_sdf(vertices, triangles, origin=(-1.0, -1.0, -1.0), dx=0.2,
+                                    nx=10, ny=10, nz=10, backend="cpu", out=out)
+
+    def test_threads(self, simple_cube):
+        """Test concurrent generation from Python threads."""
+        from concurrent.futures import ThreadPoolExecutor
+
+        vertices, triangles = simple_cube
+        def run(n):
+            return sdfgen.generate_sdf(vertices, triangles, origin=(-1.0, -1.0, -1.0),
+                                       dx=2.0 / n, nx=n, ny=n, nz=n, backend="cpu", num_threads=1)
+        sizes = [16, 20, 24, 28]
+        with ThreadPoolExecutor(max_workers=4) as pool:
+            results = list(pool.map(run, sizes))
+        for n, sdf in zip(sizes, results):
+            assert np.array_equal(sdf, run(n))
+
+
+# Generation context tests
+class TestGenerationContext:
+    """
+    Test GenerationContext sessions.
+
+    Tests cover:
+    - Context results match generate_sdf() across repeated calls and resolutions
+    - set_mesh() replaces the mesh
+    - release() frees cached device memory
+    """
+    @pytest.mark.parametrize(
+        "backend",
+        ["cpu", pytest.param("gpu", marks=pytest.mark.skipif(
+            not sdfgen.is_gpu_available(), reason="GPU not available"))],
+    )
+    def test_context_matches_generate_sdf(self, simple_cube, backend):
+        """Test repeated context calls at several resolutions."""
+        vertices, triangles = simple_cube
+        context = sdfgen.GenerationContext(vertices, triangles)
+
+        for n in (10, 20, 16):
+            dx = 1.5 / n
+            origin = (-0.75, -0.75, -0.75)
+            expected = sdfgen.generate_sdf(vertices, triangles, origin=origin, dx=dx,
+                                           nx=n, ny=n, nz=n, backend=backend)
+            sdf = context.generate_sdf(origin=origin, dx=dx, nx=n, ny=n, nz=n, backend=backend)
+            assert np.array_equal(sdf, expected)
+
+    def test_context_set_mesh(self, simple_cube):
+        """Test that set_mesh() replaces the stored mesh."""
+        vertices, triangles = simple_cube
+        context = sdfgen.GenerationContext(vertices, triangles)
+        shifted = vertices + np.float32(0.1)
+        context.set_mesh(shifted, triangles)
+
+        expected = sdfgen.generate_sdf(shifted, triangles, origin=(-1.0, -1.0, -1.0), dx=0.1,
+                                       nx=20, ny=20, nz=20, backend="cpu")
+        sdf = context.generate_sdf(origin=(-1.0, -1.0, -1.0), dx=0.1, nx=20, ny=20, nz=20,
+                                   backend="cpu")
+        assert np.array_equal(sdf, expected)
+
+    def test_context_release(self, simple_cube):
+        """Test that release() leaves no cached device memory."""
+        vertices, triangles = simple_cube
+        context = sdfgen.GenerationContext(vertices, triangles)
+        context.generate_sdf(origin=(-1.0, -1.0, -1.0), dx=0.2, nx=10, ny=10, nz=10)
+        context.release()
+        assert context.device_bytes == 0
+
+
+class TestPointQuery:
+    """
+    Test GenerationContext.query() at scattered points.
+
+    Tests cover:
+    - Distances and signs at known points of the cube, for every sign rule
+    - Nearest triangles and barycentric weights reconstruct the nearest point
+    - Invalid sign names are rejected
+    """
+    @pytest.mark.parametrize("sign", ["parity", "ray_vote", "winding"])
+    def test_query_cube(self, simple_cube, sign):
+        """Test distances at the centre, outside a face and past a corner."""
+        vertices, triangles = simple_cube
+        context = sdfgen.GenerationContext(vertices, triangles)
+        points = np.array([[0.0, 0.0, 0.0], [0.0, 0.0, 1.0], [1.0, 1.0, 1.0]], dtype=np.float32)
+        distance = context.query(points, sign=sign, backend="cpu")
+
+        assert distance.shape == (3,)
+        assert distance.dtype == np.float32
+        np.testing.assert_allclose(distance, [-0.5, 0.5, np.sqrt(0.75)], rtol=1e-5)
+
+    def test_query_closest(self, simple_cube):
+        """Test that the nearest triangle and weights give a point at the returned distance."""
+        vertices, triangles = simple_cube
+        context = sdfgen.GenerationContext(vertices, triangles)
+        rng = np.random.default_rng(7)
+        points = rng.uniform(-1.0, 1.0, size=(500, 3)).astype(np.float32)
+        distance, tri, weights = context.query(points, closest=True, backend="cpu")
+
+        assert tri.shape == (500,) and tri.dtype == np.int32
+        assert weights.shape == (500, 3) and weights.dtype == np.float32
+        assert np.all(weights >= 0)
+        np.testing.assert_allclose(weights.sum(axis=1), 1.0, atol=1e-5)
+        corners = vertices[triangles[tri]]
+        nearest = np.einsum("nk,nkd->nd", weights, corners)
+        np.testing.assert_allclose(np.linalg.norm(points - nearest, axis=1), np.abs(distance), atol=1e-5)
+        assert np.array_equal(distance, context.query(points, backend="cpu"))
+
+    def test_query_invalid_sign(self, simple_cube):
+        """Test that an unknown sign rule raises."""
+        vertices, triangles = simple_cube
+        context = sdfgen.GenerationContext(vertices, triangles)
+        with pytest.raises(ValueError):
+            context.query(np.zeros((1, 3), dtype=np.float32), sign="majority")
+
+
+class TestBatchGeneration:
+    """
+    Test generate_sdf_batch().
+
+    Tests cover:
+    - Each batch result matches generate_sdf() for its job
+    - Invalid jobs are rejected
+    """
+    def test_batch_matches_generate_sdf(self, simple_cube):
+        """Test a batch of shifted cubes at different resolutions."""
+        vertices, triangles = simple_cube
+        jobs = []
+        for n, shift in ((10, 0.0), (16, 0.1), (12, -0.2)):
+            shifted = vertices + np.float32(shift)
+            jobs.append((shifted, triangles, (-1.0, -1.0, -1.0), 2.0 / n, n, n, n))
+
+        sdfs = sdfgen.generate_sdf_batch(jobs, backend="cpu")
+        assert len(sdfs) == len(jobs)
+        for sdf, (v, t, origin, dx, nx, ny, nz) in zip(sdfs, jobs):
+            expected = sdfgen.generate_sdf(v, t, origin=origin, dx=dx, nx=nx, ny=ny, nz=nz,
+                                           backend="cpu")
+            assert np.array_equal(sdf, expected)
+
+    def test_batch_rejects_invalid_job(self, simple_cube):
+        """Test that a malformed or empty job raises."""
+        vertices, triangles = simple_cube
+        with pytest.raises((ValueError, TypeError)):
+            sdfgen.generate_sdf_batch([(vertices, triangles, (0.0, 0.0, 0.0), 0.1, 10, 10)])
+        with pytest.raises(ValueError):
+            sdfgen.generate_sdf_batch([(vertices, triangles, (0.0, 0.0, 0.0), 0.1, 0, 10, 10)])
+
+
+class TestGenerationStats:
+    """
+    Test GenerationStats and set_logging().
+
+    Tests cover:
+    - Stats report the backend, phase times and work counters without changing the field
+    - Near-band statistics only with diagnostics=True
+    - backend='auto' records the cost-model estimates it chose by
+    - set_logging(False) silences load_mesh()
+    """
+    def test_stats_filled(self, simple_cube):
+        """Test that a stats object receives backend, phase times and counters."""
+        vertices, triangles = simple_cube
+        stats = sdfgen.GenerationStats()
+        assert stats.backend_used == "auto"
+        args = dict(origin=(-1.0, -1.0, -1.0), dx=0.1, nx=20, ny=20, nz=20, backend="cpu")
+        expected = sdfgen.generate_sdf(vertices, triangles, **args)
+        sdf = sdfgen.generate_sdf(vertices, triangles, stats=stats, **args)
+
+        assert np.array_equal(sdf, expected)
+        assert stats.backend_used == "cpu"
+        assert stats.near_band_ms > 0 and stats.sweep_ms > 0
+        assert stats.distance_evaluations > 20 ** 3
+        assert stats.host_bytes >= 20 ** 3 * 12
+        assert not stats.diagnostics_valid
+
+    def test_stats_diagnostics(self, simple_cube):
+        """Test that diagnostics=True adds the near-band statistics."""
+        vertices, triangles = simple_cube
+        stats = sdfgen.GenerationStats()
+        sdfgen.generate_sdf(vertices, triangles, origin=(-1.0, -1.0, -1.0), dx=0.1,
+                            nx=20, ny=20, nz=20, backend="cpu", stats=stats, diagnostics=True)
+        assert stats.diagnostics_valid
+        assert 0 < stats.near_band_cells < 20 ** 3
+        assert stats.intersections > 0
+
+    def test_stats_auto_choice(self, simple_cube):
+        """Test that backend='auto' reports its choice and explicit backends do not."""
+        vertices, triangles = simple_cube
+        args = dict(origin=(-1.0, -1.0, -1.0), dx=0.1, nx=20, ny=20, nz=20)
+        stats = sdfgen.GenerationStats()
+        sdfgen.generate_sdf(vertices, triangles, backend="auto", stats=stats, **args)
+        assert stats.backend_auto
+        assert stats.estimated_cpu_ms > 0
+        if not sdfgen.is_gpu_available():
+            assert stats.backend_used == "cpu" and stats.estimated_gpu_ms == 0
+
+        sdfgen.generate_sdf(vertices, triangles, backend="cpu", stats=stats, **args)
+        assert not stats.backend_auto
+        assert stats.estimated_cpu_ms == 0
+
+    def test_set_logging(self, temp_obj_file, capfd):
+        """Test that set_logging(False) silences the loader messages."""
+        sdfgen.set_logging(False)
+        try:
+            sdfgen.load_mesh(temp_obj_file)
+            assert capfd.readouterr().out == ""
+        finally:
+            sdfgen.set_logging(True)
+        sdfgen.load_mesh(temp_obj_file)
+        assert "Reading OBJ file" in capfd.readouterr().out
+
 
 # Backend tests
 class TestBackends:
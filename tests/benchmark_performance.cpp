@@ -2,289 +2,826 @@
 // Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
 // Licensed under the MIT License - see LICENSE file
 
-// Performance Benchmark: CPU (multi-threaded) vs GPU
-// Generates data to back up README performance claims
+// Performance Benchmark: phase-level CPU / GPU timings over a mesh corpus
+// Every case (mesh x grid size x backend x thread count) is run untimed for the warmup and
+// then timed repeatedly; each run loads the mesh, generates the field and writes it. Reports
+// the median and p95 of every phase (load, setup, near band, sweep, sign, copy, write), the
+// grid size from which the GPU beats the CPU for each mesh, and optionally JSON and CSV for
+// tracking regressions across versions. --calibrate fits the HardwareBackend::Auto cost model
+// to the measured phases and saves it. A last section times query_points() on random points.
 
 #include "test_utils.h"
 #include "sdfgen_unified.h"
+#include "backend_cost.h"
 #include "mesh_io.h"
-#include <iostream>
+#include "distance_simd.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iomanip>
-#include <vector>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
 #include <thread>
-#include <chrono>
+#include <utility>
+#include <vector>
 
-// Test configuration
-struct BenchmarkConfig {
-    int grid_size;
-    int padding;
-    std::string description;
+static const char* SDF_FILE = "benchmark_performance.sdf";
+
+// Phases in report order; "generate" is the whole make_level_set3() call, "total" the run
+static const char* const PHASES[] = {"load", "setup", "near_band", "sweep", "sign", "copy", "write",
+                                     "generate", "total"};
+static const int PHASE_COUNT = sizeof(PHASES) / sizeof(PHASES[0]);
+enum { LOAD, SETUP, NEAR_BAND, SWEEP, SIGN, COPY, WRITE, GENERATE, TOTAL };
+
+struct BenchmarkSettings {
+    std::vector<int> sizes = {64, 128, 256};
+    std::vector<int> threads = {1, 0};
+    bool run_cpu = true;
+    bool run_gpu = true;
+    int warmup = 1;
+    int repeats = 5;
+    bool builtin_corpus = true;
+    std::vector<std::pair<std::string, std::string>> meshes;  ///< (name, path) from --mesh
+    std::string json_file;
+    std::string csv_file;
+    std::string label;
+    std::string cost_model_file;  ///< --calibrate output
+    int queries = 1000000;        ///< Points per query_points() run, 0 = skip
 };
 
-// Result storage
-struct BenchmarkResult {
-    std::string config_name;
-    int grid_size;
-    int total_cells;
-    double cpu_1thread_ms;
-    double cpu_10thread_ms;
-    double cpu_20thread_ms;
-    double cpu_max_thread_ms;
-    double gpu_time_ms;
-    bool gpu_available;
-    int max_threads;
+struct CorpusMesh {
+    std::string name;         ///< Category, e.g. "scan"
+    std::string path;         ///< File loaded by every run
+    bool temporary = false;   ///< Written by the benchmark, deleted at the end
+    size_t triangles = 0;
+    Vec3f min_box, max_box;
 };
 
-void print_header() {
-    std::cout << "\n";
-    std::cout << "========================================\n";
-    std::cout << "SDFGen Performance Benchmark\n";
-    std::cout << "========================================\n";
-    std::cout << "\n";
+struct PhaseSummary {
+    double median_ms = 0.0;
+    double p95_ms = 0.0;
+    double min_ms = 0.0;
+};
+
+struct CaseResult {
+    std::string mesh;
+    size_t triangles = 0;
+    int nx = 0, ny = 0, nz = 0;
+    std::string backend;
+    int threads = 0;          ///< Requested (0 = auto)
+    int threads_used = 0;     ///< Resolved
+    bool ok = true;
+    PhaseSummary phases[PHASE_COUNT];
+
+    long long cells() const { return (long long)nx * ny * nz; }
+};
+
+// ============================================================================
+// Synthetic corpus
+// ============================================================================
+
+/**
+ * @brief Unit icosphere with `levels` midpoint subdivisions (20 * 4^levels triangles)
+ */
+static void make_icosphere(int levels, std::vector<Vec3f>& verts, std::vector<Vec3ui>& faces) {
+    const float t = (1.0f + std::sqrt(5.0f)) / 2.0f;
+    verts = {Vec3f(-1, t, 0), Vec3f(1, t, 0), Vec3f(-1, -t, 0), Vec3f(1, -t, 0),
+             Vec3f(0, -1, t), Vec3f(0, 1, t), Vec3f(0, -1, -t), Vec3f(0, 1, -t),
+             Vec3f(t, 0, -1), Vec3f(t, 0, 1), Vec3f(-t, 0, -1), Vec3f(-t, 0, 1)};
+    faces = {Vec3ui(0, 11, 5), Vec3ui(0, 5, 1), Vec3ui(0, 1, 7), Vec3ui(0, 7, 10), Vec3ui(0, 10, 11),
+             Vec3ui(1, 5, 9), Vec3ui(5, 11, 4), Vec3ui(11, 10, 2), Vec3ui(10, 7, 6), Vec3ui(7, 1, 8),
+             Vec3ui(3, 9, 4), Vec3ui(3, 4, 2), Vec3ui(3, 2, 6), Vec3ui(3, 6, 8), Vec3ui(3, 8, 9),
+             Vec3ui(4, 9, 5), Vec3ui(2, 4, 11), Vec3ui(6, 2, 10), Vec3ui(8, 6, 7), Vec3ui(9, 8, 1)};
+    for (Vec3f& v : verts) v /= mag(v);
+
+    for (int level = 0; level < levels; ++level) {
+        std::map<std::pair<unsigned int, unsigned int>, unsigned int> midpoints;
+        auto midpoint = [&](unsigned int a, unsigned int b) {
+            std::pair<unsigned int, unsigned int> key(std::min(a, b), std::max(a, b));
+            auto found = midpoints.find(key);
+            if (found != midpoints.end()) return found->second;
+            Vec3f m = verts[a] + verts[b];
+            verts.push_back(m / mag(m));
+            midpoints[key] = (unsigned int)verts.size() - 1;
+            return (unsigned int)verts.size() - 1;
+        };
+        std::vector<Vec3ui> finer;
+        finer.reserve(faces.size() * 4);
+        for (const Vec3ui& f : faces) {
+            unsigned int ab = midpoint(f[0], f[1]), bc = midpoint(f[1], f[2]), ca = midpoint(f[2], f[0]);
+            finer.push_back(Vec3ui(f[0], ab, ca));
+            finer.push_back(Vec3ui(f[1], bc, ab));
+            finer.push_back(Vec3ui(f[2], ca, bc));
+            finer.push_back(Vec3ui(ab, bc, ca));
+        }
+        faces.swap(finer);
+    }
 }
 
-void print_result_table(const std::vector<BenchmarkResult>& results) {
-    std::cout << "\n";
-    std::cout << "========================================\n";
-    std::cout << "Benchmark Results\n";
-    std::cout << "========================================\n";
-    std::cout << "\n";
+/**
+ * @brief Write the built-in meshes next to the benchmark and add them to the corpus
+ *
+ * cad: the 3x4x5 box from the test resources (few large triangles)
+ * thin_shell: a closed spherical shell 3% of the radius thick (walls thinner than a cell on
+ *             coarse grids)
+ * scan: a 20480-triangle sphere with a bumpy surface, indexed OBJ
+ * soup: the scan triangles unwelded and in random order, binary STL
+ */
+static bool build_builtin_corpus(std::vector<CorpusMesh>& corpus) {
+    CorpusMesh cad;
+    cad.name = "cad";
+    cad.path = "resources/test_x3y4z5_bin.stl";
+    corpus.push_back(cad);
+
+    std::vector<Vec3f> sphere_verts;
+    std::vector<Vec3ui> sphere_faces;
+    make_icosphere(4, sphere_verts, sphere_faces);
+    std::vector<Vec3f> shell_verts = sphere_verts;
+    std::vector<Vec3ui> shell_faces = sphere_faces;
+    const unsigned int inner = (unsigned int)sphere_verts.size();
+    for (const Vec3f& v : sphere_verts) shell_verts.push_back(v * 0.97f);
+    for (const Vec3ui& f : sphere_faces) shell_faces.push_back(Vec3ui(f[0] + inner, f[2] + inner, f[1] + inner));
+
+    std::vector<Vec3f> scan_verts;
+    std::vector<Vec3ui> scan_faces;
+    make_icosphere(5, scan_verts, scan_faces);
+    for (Vec3f& v : scan_verts) {
+        float bump = 0.02f * std::sin(7.0f * v[0]) * std::sin(5.0f * v[1]) * std::sin(3.0f * v[2]);
+        v *= 1.0f + bump;
+    }
 
-    // Table header
-    std::cout << std::left;
-    std::cout << std::setw(12) << "Grid Size";
-    std::cout << std::setw(15) << "Total Cells";
-    std::cout << std::setw(15) << "CPU (1)";
-    std::cout << std::setw(15) << "CPU (10)";
-    std::cout << std::setw(15) << "CPU (20)";
-    std::cout << std::setw(15) << ("CPU (" + std::to_string(results[0].max_threads) + ")");
-    std::cout << std::setw(15) << "GPU";
-    std::cout << "\n";
-    std::cout << std::string(102, '-') << "\n";
+    std::vector<Vec3f> soup_verts;
+    std::vector<Vec3ui> soup_faces(scan_faces);
+    std::mt19937 rng(20250101u);
+    std::shuffle(soup_faces.begin(), soup_faces.end(), rng);
+    soup_verts.reserve(soup_faces.size() * 3);
+    for (Vec3ui& f : soup_faces) {
+        for (int c = 0; c < 3; ++c) {
+            soup_verts.push_back(scan_verts[f[c]]);
+            f[c] = (unsigned int)soup_verts.size() - 1;
+        }
+    }
 
-    for (const auto& result : results) {
-        std::cout << std::setw(12) << result.config_name;
-        std::cout << std::setw(15) << result.total_cells;
+    struct Generated {
+        const char* name;
+        const char* path;
+        const std::vector<Vec3f>* verts;
+        const std::vector<Vec3ui>* faces;
+    };
+    const Generated generated[] = {{"thin_shell", "benchmark_thin_shell.obj", &shell_verts, &shell_faces},
+                                   {"scan", "benchmark_scan.obj", &scan_verts, &scan_faces},
+                                   {"soup", "benchmark_soup.stl", &soup_verts, &soup_faces}};
+    for (const Generated& g : generated) {
+        if (!meshio::save_mesh(g.path, *g.verts, *g.faces)) return false;
+        CorpusMesh mesh;
+        mesh.name = g.name;
+        mesh.path = g.path;
+        mesh.temporary = true;
+        corpus.push_back(mesh);
+    }
+    return true;
+}
 
-        // CPU timings
-        std::cout << std::setw(15) << (std::to_string(static_cast<int>(result.cpu_1thread_ms)) + " ms");
-        std::cout << std::setw(15) << (std::to_string(static_cast<int>(result.cpu_10thread_ms)) + " ms");
-        std::cout << std::setw(15) << (std::to_string(static_cast<int>(result.cpu_20thread_ms)) + " ms");
-        std::cout << std::setw(15) << (std::to_string(static_cast<int>(result.cpu_max_thread_ms)) + " ms");
+// ============================================================================
+// Statistics and output
+// ============================================================================
+
+static PhaseSummary summarize(std::vector<double> samples) {
+    PhaseSummary summary;
+    if (samples.empty()) return summary;
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    summary.median_ms = n % 2 ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+    summary.p95_ms = samples[(size_t)std::ceil(0.95 * n) - 1];  // nearest rank
+    summary.min_ms = samples[0];
+    return summary;
+}
 
-        // GPU timing
-        if (result.gpu_available && result.gpu_time_ms > 0) {
-            std::cout << std::setw(15) << (std::to_string(static_cast<int>(result.gpu_time_ms)) + " ms");
-        } else {
-            std::cout << std::setw(15) << "N/A";
-        }
+static std::string format_ms(double ms) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(ms < 10.0 ? 2 : (ms < 1000.0 ? 1 : 0)) << ms;
+    return out.str();
+}
 
-        std::cout << "\n";
+static std::string json_string(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
     }
+    return out + "\"";
+}
 
-    std::cout << "\n";
+static std::string grid_name(const CaseResult& result) {
+    return std::to_string(result.nx) + "x" + std::to_string(result.ny) + "x" + std::to_string(result.nz);
 }
 
-void print_analysis(const std::vector<BenchmarkResult>& results) {
-    std::cout << "========================================\n";
-    std::cout << "Performance Analysis\n";
+static void print_result_table(const std::vector<CaseResult>& results) {
     std::cout << "========================================\n";
+    std::cout << "Benchmark Results (median ms, total p95)\n";
+    std::cout << "========================================\n\n";
+
+    std::cout << std::left << std::setw(12) << "Mesh" << std::setw(13) << "Grid" << std::setw(9) << "Backend"
+              << std::setw(9) << "Threads" << std::right;
+    const int shown[] = {LOAD, SETUP, NEAR_BAND, SWEEP, SIGN, COPY, WRITE, TOTAL};
+    for (int p : shown) std::cout << std::setw(11) << PHASES[p];
+    std::cout << std::setw(11) << "p95" << "\n";
+    std::cout << std::string(43 + 11 * 9, '-') << "\n";
+
+    for (const CaseResult& result : results) {
+        std::cout << std::left << std::setw(12) << result.mesh << std::setw(13) << grid_name(result)
+                  << std::setw(9) << result.backend << std::setw(9) << result.threads_used << std::right;
+        if (!result.ok) {
+            std::cout << "  FAILED\n";
+            continue;
+        }
+        for (int p : shown) std::cout << std::setw(11) << format_ms(result.phases[p].median_ms);
+        std::cout << std::setw(11) << format_ms(result.phases[TOTAL].p95_ms) << "\n";
+    }
     std::cout << "\n";
+}
 
-    bool has_gpu = results[0].gpu_available;
-
-    std::cout << "Multi-threading Speedup (vs 1 thread):\n";
-    for (const auto& result : results) {
-        std::cout << "  " << result.config_name << ":\n";
+/**
+ * @brief Smallest grid from which the GPU's median generation time beats this CPU setting
+ * at every larger measured size; empty if it never does
+ */
+struct Crossover {
+    std::string mesh;
+    int cpu_threads = 0;
+    const CaseResult* from = nullptr;
+};
 
-        double speedup_10 = result.cpu_1thread_ms / result.cpu_10thread_ms;
-        double efficiency_10 = (speedup_10 / 10.0) * 100.0;
-        std::cout << "    10 threads: " << std::fixed << std::setprecision(1)
-                  << speedup_10 << "x (" << efficiency_10 << "% efficiency)\n";
+static std::vector<Crossover> find_crossovers(const std::vector<CaseResult>& results,
+                                              const std::vector<CorpusMesh>& corpus,
+                                              const BenchmarkSettings& settings) {
+    std::vector<Crossover> crossovers;
+    for (const CorpusMesh& mesh : corpus) {
+        for (int threads : settings.threads) {
+            Crossover crossover;
+            crossover.mesh = mesh.name;
+            bool found_pair = false;
+            for (int size : settings.sizes) {
+                const CaseResult* cpu = nullptr;
+                const CaseResult* gpu = nullptr;
+                for (const CaseResult& r : results) {
+                    if (r.mesh != mesh.name || r.nx != size || !r.ok) continue;
+                    if (r.backend == "cpu" && r.threads == threads) cpu = &r;
+                    if (r.backend == "gpu") gpu = &r;
+                }
+                if (!cpu || !gpu) continue;
+                found_pair = true;
+                crossover.cpu_threads = cpu->threads_used;
+                if (gpu->phases[GENERATE].median_ms < cpu->phases[GENERATE].median_ms) {
+                    if (!crossover.from) crossover.from = gpu;
+                } else {
+                    crossover.from = nullptr;
+                }
+            }
+            if (found_pair) crossovers.push_back(crossover);
+        }
+    }
+    return crossovers;
+}
 
-        double speedup_20 = result.cpu_1thread_ms / result.cpu_20thread_ms;
-        double efficiency_20 = (speedup_20 / 20.0) * 100.0;
-        std::cout << "    20 threads: " << std::fixed << std::setprecision(1)
-                  << speedup_20 << "x (" << efficiency_20 << "% efficiency)\n";
+static void print_crossovers(const std::vector<Crossover>& crossovers) {
+    std::cout << "========================================\n";
+    std::cout << "CPU / GPU Crossover (generation median)\n";
+    std::cout << "========================================\n\n";
+    for (const Crossover& c : crossovers) {
+        std::cout << "  " << std::left << std::setw(12) << c.mesh << "vs CPU (" << c.cpu_threads << " threads): ";
+        if (c.from) {
+            std::cout << "GPU faster from " << grid_name(*c.from) << " (" << c.from->cells() << " cells)\n";
+        } else {
+            std::cout << "CPU faster or equal up to the largest grid\n";
+        }
+    }
+    std::cout << std::right << "\n";
+}
 
-        double speedup_max = result.cpu_1thread_ms / result.cpu_max_thread_ms;
-        double efficiency_max = (speedup_max / result.max_threads) * 100.0;
-        std::cout << "    " << result.max_threads << " threads: " << std::fixed << std::setprecision(1)
-                  << speedup_max << "x (" << efficiency_max << "% efficiency)\n";
+static bool write_json(const std::string& filename, const std::vector<CaseResult>& results,
+                       const std::vector<Crossover>& crossovers, const BenchmarkSettings& settings,
+                       unsigned int cpu_threads, int gpu_devices) {
+    std::ofstream out(filename.c_str());
+    if (!out) return false;
+    out << std::setprecision(6);
+    out << "{\n  \"benchmark\": \"sdfgen_phases\",\n  \"format_version\": 1,\n";
+    out << "  \"label\": " << json_string(settings.label) << ",\n";
+    out << "  \"system\": {\"cpu_threads\": " << cpu_threads << ", \"gpu_devices\": " << gpu_devices
+        << ", \"simd\": " << json_string(sdfgen::cpu::simd_level_name(sdfgen::cpu::active_simd_level())) << "},\n";
+    out << "  \"warmup\": " << settings.warmup << ",\n  \"repeats\": " << settings.repeats << ",\n";
+    out << "  \"cases\": [\n";
+    for (size_t n = 0; n < results.size(); ++n) {
+        const CaseResult& r = results[n];
+        out << "    {\"mesh\": " << json_string(r.mesh) << ", \"triangles\": " << r.triangles
+            << ", \"grid\": [" << r.nx << ", " << r.ny << ", " << r.nz << "], \"cells\": " << r.cells()
+            << ", \"backend\": " << json_string(r.backend) << ", \"threads\": " << r.threads
+            << ", \"threads_used\": " << r.threads_used << ", \"ok\": " << (r.ok ? "true" : "false")
+            << ",\n     \"phases\": {";
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            out << (p ? ", " : "") << "\"" << PHASES[p] << "\": {\"median_ms\": " << r.phases[p].median_ms
+                << ", \"p95_ms\": " << r.phases[p].p95_ms << ", \"min_ms\": " << r.phases[p].min_ms << "}";
+        }
+        out << "}}" << (n + 1 < results.size() ? "," : "") << "\n";
     }
-    std::cout << "\n";
+    out << "  ],\n  \"crossover\": [\n";
+    for (size_t n = 0; n < crossovers.size(); ++n) {
+        const Crossover& c = crossovers[n];
+        out << "    {\"mesh\": " << json_string(c.mesh) << ", \"cpu_threads\": " << c.cpu_threads
+            << ", \"gpu_faster_from_cells\": " << (c.from ? std::to_string(c.from->cells()) : "null") << "}"
+            << (n + 1 < crossovers.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return out.good();
+}
 
-    if (has_gpu) {
-        std::cout << "GPU Speedup:\n";
-        for (const auto& result : results) {
-            if (result.gpu_time_ms > 0) {
-                std::cout << "  " << result.config_name << ":\n";
+// One row per case and phase, so runs of different versions can be joined on the key columns
+static bool write_csv(const std::string& filename, const std::vector<CaseResult>& results,
+                      const BenchmarkSettings& settings) {
+    std::ofstream out(filename.c_str());
+    if (!out) return false;
+    out << std::setprecision(6);
+    out << "label,mesh,triangles,nx,ny,nz,backend,threads,threads_used,phase,median_ms,p95_ms,min_ms,repeats\n";
+    for (const CaseResult& r : results) {
+        if (!r.ok) continue;
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            out << settings.label << "," << r.mesh << "," << r.triangles << "," << r.nx << "," << r.ny << ","
+                << r.nz << "," << r.backend << "," << r.threads << "," << r.threads_used << "," << PHASES[p] << ","
+                << r.phases[p].median_ms << "," << r.phases[p].p95_ms << "," << r.phases[p].min_ms << ","
+                << settings.repeats << "\n";
+        }
+    }
+    return out.good();
+}
 
-                double speedup_vs_1 = result.cpu_1thread_ms / result.gpu_time_ms;
-                std::cout << "    vs 1 thread: " << std::fixed << std::setprecision(1)
-                          << speedup_vs_1 << "x\n";
+// ============================================================================
+// Runs
+// ============================================================================
 
-                double speedup_vs_10 = result.cpu_10thread_ms / result.gpu_time_ms;
-                std::cout << "    vs 10 threads: " << std::fixed << std::setprecision(1)
-                          << speedup_vs_10 << "x\n";
+/**
+ * @brief One timed load / generate / write run; false if any step failed
+ */
+static bool run_once(const CorpusMesh& mesh, int size, int padding, sdfgen::HardwareBackend backend, int threads,
+                     double phase_ms[PHASE_COUNT]) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
 
-                double speedup_vs_20 = result.cpu_20thread_ms / result.gpu_time_ms;
-                std::cout << "    vs 20 threads: " << std::fixed << std::setprecision(1)
-                          << speedup_vs_20 << "x\n";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_mesh(mesh.path.c_str(), verts, faces, min_box, max_box)) return false;
+    Clock::time_point loaded = Clock::now();
+
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, size, padding, dx, ny, nz, origin);
+    sdfgen::GenerationOptions options;
+    options.backend = backend;
+    options.num_threads = threads;
+    sdfgen::GenerationStats stats;
+    Array3f phi;
+    sdfgen::make_level_set3(faces, verts, origin, dx, size, ny, nz, phi, options, &stats);
+    Clock::time_point generated = Clock::now();
+
+    if (!write_sdf_binary(SDF_FILE, phi, origin, dx, nullptr, sdfgen::SdfLayout::COrder, threads)) return false;
+    Clock::time_point written = Clock::now();
+
+    phase_ms[LOAD] = std::chrono::duration<double, std::milli>(loaded - start).count();
+    phase_ms[SETUP] = stats.setup_ms;
+    phase_ms[NEAR_BAND] = stats.near_band_ms;
+    phase_ms[SWEEP] = stats.sweep_ms;
+    phase_ms[SIGN] = stats.sign_ms;
+    phase_ms[COPY] = stats.copy_ms;
+    phase_ms[WRITE] = std::chrono::duration<double, std::milli>(written - generated).count();
+    phase_ms[GENERATE] = std::chrono::duration<double, std::milli>(generated - loaded).count();
+    phase_ms[TOTAL] = std::chrono::duration<double, std::milli>(written - start).count();
+    return stats.backend_used == backend;
+}
 
-                double speedup_vs_max = result.cpu_max_thread_ms / result.gpu_time_ms;
-                std::cout << "    vs " << result.max_threads << " threads: "
-                          << std::fixed << std::setprecision(1) << speedup_vs_max << "x\n";
-            }
+static CaseResult run_case(const CorpusMesh& mesh, int size, sdfgen::HardwareBackend backend, int threads,
+                           const BenchmarkSettings& settings) {
+    const int padding = 2;
+    CaseResult result;
+    result.mesh = mesh.name;
+    result.triangles = mesh.triangles;
+    result.backend = backend == sdfgen::HardwareBackend::GPU ? "gpu" : "cpu";
+    result.threads = threads;
+    result.threads_used = (int)sdfgen::resolve_thread_count(threads);
+    float dx;
+    Vec3f origin;
+    result.nx = size;
+    test_utils::calculate_grid_parameters(mesh.min_box, mesh.max_box, size, padding, dx, result.ny, result.nz,
+                                          origin);
+
+    std::cout << "  " << std::left << std::setw(12) << mesh.name << std::setw(13) << grid_name(result)
+              << result.backend << " (" << result.threads_used << " threads)... " << std::right << std::flush;
+
+    std::vector<double> samples[PHASE_COUNT];
+    double phase_ms[PHASE_COUNT];
+    try {
+        for (int run = 0; run < settings.warmup + settings.repeats && result.ok; ++run) {
+            result.ok = run_once(mesh, size, padding, backend, threads, phase_ms);
+            if (run < settings.warmup) continue;
+            for (int p = 0; p < PHASE_COUNT; ++p) samples[p].push_back(phase_ms[p]);
         }
+    } catch (const std::exception& e) {
+        std::cout << e.what() << " ";
+        result.ok = false;
+    }
+    for (int p = 0; p < PHASE_COUNT; ++p) result.phases[p] = summarize(samples[p]);
+
+    if (result.ok) {
+        std::cout << format_ms(result.phases[TOTAL].median_ms) << " ms\n";
     } else {
-        std::cout << "GPU not available - CPU-only results\n";
+        std::cout << "FAILED\n";
     }
+    return result;
+}
+
+// Multi-GPU scaling on one grid: efficiency = t(1) / (N * t(N))
+static void print_multi_gpu_scaling(const CorpusMesh& mesh, int size, int device_count) {
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_mesh(mesh.path.c_str(), verts, faces, min_box, max_box)) return;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, size, 2, dx, ny, nz, origin);
 
+    std::cout << "========================================\n";
+    std::cout << "Multi-GPU Scaling (" << mesh.name << ", " << size << "x" << ny << "x" << nz << ")\n";
+    std::cout << "========================================\n";
+    std::cout << "\n";
+    std::cout << std::setw(12) << "Devices" << std::setw(15) << "Time" << std::setw(15) << "Speedup"
+              << "Efficiency\n";
+    std::cout << std::string(57, '-') << "\n";
+
+    sdfgen::GenerationOptions options;
+    options.backend = sdfgen::HardwareBackend::GPU;
+    double single_ms = 0;
+    for (int n = 1; n <= device_count; ++n) {
+        options.gpu_devices.push_back(n - 1);
+        Array3f phi_multi;
+        auto start = std::chrono::high_resolution_clock::now();
+        sdfgen::make_level_set3(faces, verts, origin, dx, size, ny, nz, phi_multi, options);
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (n == 1) single_ms = ms;
+
+        double speedup = single_ms / ms;
+        std::cout << std::setw(12) << n;
+        std::cout << std::setw(15) << (std::to_string(static_cast<int>(ms)) + " ms");
+        std::cout << std::fixed << std::setprecision(1) << speedup << "x" << std::string(11, ' ');
+        std::cout << (speedup / n) * 100.0 << "%\n";
+    }
     std::cout << "\n";
 }
 
-int main(int argc, char* argv[]) {
-    print_header();
+// Point queries: random points over the padded mesh bounds, CPU and GPU
+static void print_point_queries(const std::vector<CorpusMesh>& corpus, const BenchmarkSettings& settings,
+                                bool gpu_available) {
+    // Load first so the loaders' messages stay out of the table
+    std::vector<std::vector<Vec3f>> verts(corpus.size());
+    std::vector<std::vector<Vec3ui>> faces(corpus.size());
+    std::vector<Vec3f> min_box(corpus.size()), max_box(corpus.size());
+    for (size_t m = 0; m < corpus.size(); ++m) {
+        meshio::load_mesh(corpus[m].path.c_str(), verts[m], faces[m], min_box[m], max_box[m]);
+    }
+
+    std::cout << "========================================\n";
+    std::cout << "Point Queries (" << settings.queries << " random points)\n";
+    std::cout << "========================================\n";
+    std::cout << "\n";
+    std::cout << std::left << std::setw(12) << "Mesh" << std::setw(10) << "Backend" << std::right << std::setw(12)
+              << "Build" << std::setw(12) << "Query" << std::setw(16) << "Mqueries/s\n";
+    std::cout << std::string(62, '-') << "\n";
+
+    std::mt19937 rng(1234);
+    for (size_t m = 0; m < corpus.size(); ++m) {
+        if (faces[m].empty()) continue;
+        Vec3f pad = 0.1f * (max_box[m] - min_box[m]);
+        std::vector<Vec3f> points(settings.queries);
+        for (Vec3f& p : points) {
+            for (int axis = 0; axis < 3; ++axis) {
+                std::uniform_real_distribution<float> coord(min_box[m][axis] - pad[axis],
+                                                            max_box[m][axis] + pad[axis]);
+                p[axis] = coord(rng);
+            }
+        }
+        std::vector<float> distance(points.size());
+
+        for (int b = 0; b < 2; ++b) {
+            if (b == 0 && !settings.run_cpu) continue;
+            if (b == 1 && !(settings.run_gpu && gpu_available)) continue;
+            sdfgen::GenerationOptions options;
+            options.backend = b == 0 ? sdfgen::HardwareBackend::CPU : sdfgen::HardwareBackend::GPU;
+            sdfgen::GenerationContext context(faces[m], verts[m]);
+            // the first call builds (and on the GPU uploads) the tree; later calls only query
+            auto start = std::chrono::steady_clock::now();
+            sdfgen::query_points(context, points.data(), 1, distance.data(), options);
+            double build_ms =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::vector<double> samples;
+            for (int r = 0; r < settings.repeats; ++r) {
+                start = std::chrono::steady_clock::now();
+                sdfgen::query_points(context, points.data(), points.size(), distance.data(), options);
+                samples.push_back(
+                    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+            double query_ms = summarize(samples).median_ms;
+            std::cout << std::left << std::setw(12) << corpus[m].name << std::setw(10) << (b == 0 ? "CPU" : "GPU")
+                      << std::right << std::setw(12) << (format_ms(build_ms) + " ms") << std::setw(12)
+                      << (format_ms(query_ms) + " ms") << std::setw(15) << std::fixed << std::setprecision(2)
+                      << points.size() / (query_ms * 1e3) << "\n";
+            std::cout.unsetf(std::ios::floatfield);
+        }
+    }
+    std::cout << "\n";
+}
 
-    // Load test mesh
-    const char* mesh_file = "resources/test_x3y4z5_bin.stl";
-    std::cout << "Loading test mesh: " << mesh_file << "\n\n";
+// ============================================================================
+// Cost model calibration
+// ============================================================================
 
+static double median_of(std::vector<double> values, double fallback) {
+    return values.empty() ? fallback : summarize(values).median_ms;
+}
+
+/**
+ * @brief Wall-clock time of the first GPU call of the process (context creation included)
+ */
+static double time_first_gpu_call(const CorpusMesh& mesh) {
     std::vector<Vec3f> verts;
     std::vector<Vec3ui> faces;
     Vec3f min_box, max_box;
+    if (!meshio::load_mesh(mesh.path.c_str(), verts, faces, min_box, max_box)) return 0.0;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, 16, 2, dx, ny, nz, origin);
+    sdfgen::GenerationOptions options;
+    options.backend = sdfgen::HardwareBackend::GPU;
+    Array3f phi;
+    auto start = std::chrono::steady_clock::now();
+    sdfgen::make_level_set3(faces, verts, origin, dx, 16, ny, nz, phi, options);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Fit the cost model to the phase medians: each coefficient is the median of its
+ * per-case ratios (CPU figures scaled to one thread); coefficients no case measures keep
+ * the values of the current model
+ */
+static sdfgen::BackendCostModel calibrate(const std::vector<CaseResult>& results, double first_gpu_call_ms) {
+    sdfgen::BackendCostModel model = sdfgen::backend_cost_model();
+    std::vector<double> cpu_cell, cpu_distance, gpu_call, gpu_cell, gpu_distance, gpu_transfer;
+    for (const CaseResult& r : results) {
+        if (!r.ok) continue;
+        const double cells = (double)r.cells();
+        const double distances = sdfgen::near_band_work(r.triangles, r.nx, r.ny, r.nz, 1);
+        const PhaseSummary* phases = r.phases;
+        if (r.backend == "cpu") {
+            const double threads = r.threads_used;
+            cpu_cell.push_back((phases[SETUP].median_ms + phases[SWEEP].median_ms + phases[SIGN].median_ms) *
+                               threads * 1e6 / cells);
+            cpu_distance.push_back(phases[NEAR_BAND].median_ms * threads * 1e6 / distances);
+        } else {
+            const double iterations = 2.0 * std::max(r.nx, std::max(r.ny, r.nz));
+            gpu_call.push_back(phases[GENERATE].median_ms - phases[NEAR_BAND].median_ms -
+                               phases[SWEEP].median_ms - phases[SIGN].median_ms - phases[COPY].median_ms);
+            gpu_cell.push_back((phases[SWEEP].median_ms + phases[SIGN].median_ms) * 1e6 / (cells * iterations));
+            gpu_distance.push_back(phases[NEAR_BAND].median_ms * 1e6 / distances);
+            if (phases[COPY].median_ms > 0.0) {
+                gpu_transfer.push_back(cells * sizeof(float) / (phases[COPY].median_ms * 1e6));
+            }
+        }
+    }
+    model.cpu_ns_per_cell = median_of(cpu_cell, model.cpu_ns_per_cell);
+    model.cpu_ns_per_distance = median_of(cpu_distance, model.cpu_ns_per_distance);
+    model.gpu_call_ms = std::max(0.0, median_of(gpu_call, model.gpu_call_ms));
+    model.gpu_ns_per_cell_iteration = median_of(gpu_cell, model.gpu_ns_per_cell_iteration);
+    model.gpu_ns_per_distance = median_of(gpu_distance, model.gpu_ns_per_distance);
+    model.gpu_transfer_gb_s = median_of(gpu_transfer, model.gpu_transfer_gb_s);
+    if (first_gpu_call_ms > 0.0) model.gpu_init_ms = std::max(0.0, first_gpu_call_ms - model.gpu_call_ms);
+    return model;
+}
+
+// ============================================================================
+// Command line
+// ============================================================================
+
+static void print_usage() {
+    std::cout << "Usage: benchmark_performance [options]\n"
+              << "  --sizes 64,128,256     Grid X sizes (Y and Z follow the mesh proportions)\n"
+              << "  --threads 1,0          CPU thread counts, 0 = all hardware threads\n"
+              << "  --backends cpu,gpu     Backends to run (gpu is skipped without a device)\n"
+              << "  --warmup N             Untimed runs per case (default 1)\n"
+              << "  --repeats N            Timed runs per case (default 5)\n"
+              << "  --mesh NAME=PATH       Add a mesh to the corpus (repeatable)\n"
+              << "  --no-builtin           Only the --mesh corpus\n"
+              << "  --json FILE            Write results as JSON\n"
+              << "  --csv FILE             Write results as CSV, one row per case and phase\n"
+              << "  --label TEXT           Tag stored in JSON and CSV (e.g. a version)\n"
+              << "  --calibrate FILE       Fit the Auto backend cost model to the results and save it\n"
+              << "  --queries N            Random points per point-query run (default 1000000, 0 = skip)\n"
+              << "  --quick                Small grids and 2 repeats, for smoke runs\n";
+}
+
+static bool parse_int_list(const std::string& text, std::vector<int>& values) {
+    values.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        char* end = nullptr;
+        long value = std::strtol(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || value < 0) return false;
+        values.push_back((int)value);
+    }
+    return !values.empty();
+}
 
-    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
-        std::cerr << "ERROR: Failed to load test mesh\n";
+static bool parse_arguments(int argc, char* argv[], BenchmarkSettings& settings) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        std::string value = has_value ? argv[i + 1] : "";
+        if (arg == "--quick") {
+            settings.sizes = {32, 48};
+            settings.warmup = 0;
+            settings.repeats = 2;
+            settings.queries = 100000;
+            continue;
+        }
+        if (arg == "--no-builtin") {
+            settings.builtin_corpus = false;
+            continue;
+        }
+        if (!has_value) return false;
+        ++i;
+        if (arg == "--sizes") {
+            if (!parse_int_list(value, settings.sizes)) return false;
+        } else if (arg == "--threads") {
+            if (!parse_int_list(value, settings.threads)) return false;
+        } else if (arg == "--backends") {
+            settings.run_cpu = value.find("cpu") != std::string::npos;
+            settings.run_gpu = value.find("gpu") != std::string::npos;
+        } else if (arg == "--warmup") {
+            settings.warmup = std::max(0, std::atoi(value.c_str()));
+        } else if (arg == "--repeats") {
+            settings.repeats = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--mesh") {
+            size_t eq = value.find('=');
+            if (eq == std::string::npos || eq == 0) return false;
+            settings.meshes.push_back(std::make_pair(value.substr(0, eq), value.substr(eq + 1)));
+        } else if (arg == "--json") {
+            settings.json_file = value;
+        } else if (arg == "--csv") {
+            settings.csv_file = value;
+        } else if (arg == "--label") {
+            settings.label = value;
+        } else if (arg == "--calibrate") {
+            settings.cost_model_file = value;
+        } else if (arg == "--queries") {
+            settings.queries = std::max(0, std::atoi(value.c_str()));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkSettings settings;
+    if (!parse_arguments(argc, argv, settings)) {
+        print_usage();
         return 1;
     }
 
-    test_utils::print_mesh_info(verts, faces, min_box, max_box);
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "SDFGen Performance Benchmark\n";
+    std::cout << "========================================\n";
+    std::cout << "\n";
+
+    // Corpus: built-in meshes, then --mesh entries
+    std::vector<CorpusMesh> corpus;
+    if (settings.builtin_corpus && !build_builtin_corpus(corpus)) {
+        std::cerr << "ERROR: Failed to write the built-in benchmark meshes\n";
+        return 1;
+    }
+    for (const auto& entry : settings.meshes) {
+        CorpusMesh mesh;
+        mesh.name = entry.first;
+        mesh.path = entry.second;
+        corpus.push_back(mesh);
+    }
+    for (CorpusMesh& mesh : corpus) {
+        std::vector<Vec3f> verts;
+        std::vector<Vec3ui> faces;
+        if (!meshio::load_mesh(mesh.path.c_str(), verts, faces, mesh.min_box, mesh.max_box)) {
+            std::cerr << "ERROR: Failed to load benchmark mesh " << mesh.path << "\n";
+            return 1;
+        }
+        mesh.triangles = faces.size();
+    }
 
     // Check hardware
     bool gpu_available = sdfgen::is_gpu_available();
-    unsigned int cpu_threads = std::thread::hardware_concurrency();
-    if(cpu_threads == 0) cpu_threads = 4; // fallback
+    int device_count = gpu_available ? sdfgen::gpu_device_count() : 0;
+    unsigned int cpu_threads = sdfgen::resolve_thread_count(0);
 
     std::cout << "Hardware Detection:\n";
-    std::cout << "  CPU Threads: " << cpu_threads << "\n";
-    std::cout << "  GPU Available: " << (gpu_available ? "YES" : "NO") << "\n";
-    if (gpu_available) {
-        std::cout << "  Running CPU (" << cpu_threads << " threads) vs GPU benchmark\n";
-    } else {
-        std::cout << "  Running CPU-only benchmark (" << cpu_threads << " threads)\n";
+    std::cout << "  CPU Threads: " << cpu_threads << " ("
+              << sdfgen::cpu::simd_level_name(sdfgen::cpu::active_simd_level()) << ")\n";
+    std::cout << "  GPU Available: " << (gpu_available ? "YES" : "NO") << "\n\n";
+
+    std::cout << "Corpus:\n";
+    for (const CorpusMesh& mesh : corpus) {
+        std::cout << "  " << std::left << std::setw(12) << mesh.name << std::right << std::setw(9) << mesh.triangles
+                  << " triangles  " << mesh.path << "\n";
     }
-    std::cout << "\n";
+    std::cout << "\nWarmup " << settings.warmup << ", " << settings.repeats << " timed runs per case\n\n";
 
-    // Benchmark configurations
-    std::vector<BenchmarkConfig> configs = {
-        {64,  2, "64³"},
-        {128, 2, "128³"},
-        {256, 2, "256³"}
-    };
+    // Context creation is only visible on the first GPU call of the process
+    double first_gpu_call_ms = 0.0;
+    if (!settings.cost_model_file.empty() && settings.run_gpu && gpu_available && !corpus.empty()) {
+        first_gpu_call_ms = time_first_gpu_call(corpus.front());
+    }
 
-    std::vector<BenchmarkResult> results;
-
-    for (const auto& config : configs) {
-        std::cout << "Benchmarking " << config.description << " grid...\n";
-
-        BenchmarkResult result;
-        result.config_name = config.description;
-        result.grid_size = config.grid_size;
-        result.gpu_available = gpu_available;
-        result.max_threads = cpu_threads;
-
-        // Calculate grid parameters
-        float dx;
-        int ny, nz;
-        Vec3f origin;
-        test_utils::calculate_grid_parameters(min_box, max_box, config.grid_size,
-                                              config.padding, dx, ny, nz, origin);
-
-        result.total_cells = config.grid_size * ny * nz;
-
-        // CPU 1-thread benchmark
-        std::cout << "  CPU (1 thread)... " << std::flush;
-        Array3f phi_cpu1;
-        double time_1thread;
-        {
-            auto start = std::chrono::high_resolution_clock::now();
-            sdfgen::make_level_set3(faces, verts, origin, dx, config.grid_size, ny, nz,
-                                   phi_cpu1, 1, sdfgen::HardwareBackend::CPU, 1);  // Force 1 thread
-            auto end = std::chrono::high_resolution_clock::now();
-            time_1thread = std::chrono::duration<double, std::milli>(end - start).count();
-        }
-        result.cpu_1thread_ms = time_1thread;
-        std::cout << result.cpu_1thread_ms << " ms\n";
-
-        // CPU 10-thread benchmark
-        std::cout << "  CPU (10 threads)... " << std::flush;
-        Array3f phi_cpu_10;
-        double time_10thread;
-        {
-            auto start = std::chrono::high_resolution_clock::now();
-            sdfgen::make_level_set3(faces, verts, origin, dx, config.grid_size, ny, nz,
-                                   phi_cpu_10, 1, sdfgen::HardwareBackend::CPU, 10);
-            auto end = std::chrono::high_resolution_clock::now();
-            time_10thread = std::chrono::duration<double, std::milli>(end - start).count();
-        }
-        result.cpu_10thread_ms = time_10thread;
-        std::cout << result.cpu_10thread_ms << " ms\n";
-
-        // CPU 20-thread benchmark
-        std::cout << "  CPU (20 threads)... " << std::flush;
-        Array3f phi_cpu_20;
-        double time_20thread;
-        {
-            auto start = std::chrono::high_resolution_clock::now();
-            sdfgen::make_level_set3(faces, verts, origin, dx, config.grid_size, ny, nz,
-                                   phi_cpu_20, 1, sdfgen::HardwareBackend::CPU, 20);
-            auto end = std::chrono::high_resolution_clock::now();
-            time_20thread = std::chrono::duration<double, std::milli>(end - start).count();
-        }
-        result.cpu_20thread_ms = time_20thread;
-        std::cout << result.cpu_20thread_ms << " ms\n";
-
-        // CPU multi-threaded benchmark (max threads)
-        std::cout << "  CPU (" << cpu_threads << " threads)... " << std::flush;
-        Array3f phi_cpu_mt;
-        double time_max_thread;
-        {
-            auto start = std::chrono::high_resolution_clock::now();
-            sdfgen::make_level_set3(faces, verts, origin, dx, config.grid_size, ny, nz,
-                                   phi_cpu_mt, 1, sdfgen::HardwareBackend::CPU, 0);  // Auto-detect threads
-            auto end = std::chrono::high_resolution_clock::now();
-            time_max_thread = std::chrono::duration<double, std::milli>(end - start).count();
-        }
-        result.cpu_max_thread_ms = time_max_thread;
-        std::cout << result.cpu_max_thread_ms << " ms\n";
-
-        // GPU benchmark
-        if (gpu_available) {
-            std::cout << "  GPU... " << std::flush;
-            Array3f phi_gpu;
-            test_utils::generate_sdf_with_timing(faces, verts, origin, dx,
-                                                 config.grid_size, ny, nz,
-                                                 phi_gpu, sdfgen::HardwareBackend::GPU,
-                                                 result.gpu_time_ms);
-            std::cout << result.gpu_time_ms << " ms\n";
-        } else {
-            result.gpu_time_ms = 0;
+    std::vector<CaseResult> results;
+    for (const CorpusMesh& mesh : corpus) {
+        for (int size : settings.sizes) {
+            if (settings.run_cpu) {
+                for (int threads : settings.threads) {
+                    results.push_back(run_case(mesh, size, sdfgen::HardwareBackend::CPU, threads, settings));
+                }
+            }
+            if (settings.run_gpu && gpu_available) {
+                results.push_back(run_case(mesh, size, sdfgen::HardwareBackend::GPU, 0, settings));
+            }
         }
-
-        results.push_back(result);
-        std::cout << "\n";
     }
+    std::cout << "\n";
 
-    // Print results
     print_result_table(results);
-    print_analysis(results);
+    std::vector<Crossover> crossovers = find_crossovers(results, corpus, settings);
+    if (!crossovers.empty()) {
+        print_crossovers(crossovers);
+    } else {
+        std::cout << "GPU not available - CPU-only results\n\n";
+    }
+
+    if (device_count > 1 && !corpus.empty()) {
+        print_multi_gpu_scaling(corpus.front(), settings.sizes.back(), device_count);
+    }
+    if (settings.queries > 0 && !corpus.empty()) {
+        print_point_queries(corpus, settings, gpu_available);
+    }
+
+    bool all_ok = true;
+    for (const CaseResult& result : results) all_ok &= result.ok;
+    if (!settings.json_file.empty()) {
+        bool written = write_json(settings.json_file, results, crossovers, settings, cpu_threads, device_count);
+        std::cout << (written ? "JSON written: " : "ERROR: Failed to write JSON: ") << settings.json_file << "\n";
+        all_ok &= written;
+    }
+    if (!settings.csv_file.empty()) {
+        bool written = write_csv(settings.csv_file, results, settings);
+        std::cout << (written ? "CSV written: " : "ERROR: Failed to write CSV: ") << settings.csv_file << "\n";
+        all_ok &= written;
+    }
+    if (!settings.cost_model_file.empty()) {
+        sdfgen::BackendCostModel model = calibrate(results, first_gpu_call_ms);
+        bool written = sdfgen::save_cost_model(settings.cost_model_file, model);
+        if (written) {
+            std::cout << "Cost model written: " << settings.cost_model_file << " (CPU " << model.cpu_ns_per_cell
+                      << " ns/cell, " << model.cpu_ns_per_distance << " ns/distance";
+            if (gpu_available) {
+                std::cout << "; GPU " << model.gpu_call_ms << " ms/call, " << model.gpu_init_ms << " ms init, "
+                          << model.gpu_ns_per_cell_iteration << " ns/cell-iteration";
+            }
+            std::cout << ")\n";
+        }
+        all_ok &= written;
+    }
+
+    std::remove(SDF_FILE);
+    for (const CorpusMesh& mesh : corpus) {
+        if (mesh.temporary) std::remove(mesh.path.c_str());
+    }
 
     std::cout << "========================================\n";
     std::cout << "Benchmark Complete\n";
     std::cout << "========================================\n";
     std::cout << "\n";
 
-    return 0;
+    return all_ok ? 0 : 1;
 }
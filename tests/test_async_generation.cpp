@@ -0,0 +1,153 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for asynchronous generation through the unified API
+// Validates that background jobs (single, concurrent and context-based) give the same field as
+// the blocking call, and that cancellation stops a job with GenerationCancelled, both through
+// GenerationJob::cancel() and through GenerationOptions::cancel on the blocking call.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "mesh_io.h"
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Asynchronous Generation Tests\n";
+    std::cout << "========================================\n\n";
+
+    const char* mesh_file = "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 32;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    std::cout << "\n";
+
+    bool all_passed = true;
+
+    sdfgen::GenerationOptions options;
+    options.backend = sdfgen::HardwareBackend::CPU;
+    Array3f reference;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, reference, options);
+
+    // One job
+    sdfgen::GenerationJob job = sdfgen::make_level_set3_async(faces, verts, origin, dx, grid_size, ny, nz, options);
+    bool ok = job.valid();
+    Array3f phi;
+    sdfgen::GenerationStats stats;
+    job.get(phi, &stats);
+    ok = ok && !job.valid() && test_utils::bitwise_equal(phi, reference) &&
+         stats.backend_used == sdfgen::HardwareBackend::CPU;
+    std::cout << (ok ? "✓" : "✗") << " Async job matches the blocking call\n";
+    all_passed &= ok;
+
+    // Several jobs in flight at once
+    std::vector<sdfgen::GenerationJob> jobs;
+    for (int n = 0; n < 3; ++n) {
+        jobs.push_back(sdfgen::make_level_set3_async(faces, verts, origin, dx, grid_size, ny, nz, options));
+    }
+    ok = true;
+    for (sdfgen::GenerationJob& j : jobs) {
+        j.wait();
+        ok = ok && j.ready();
+        Array3f result;
+        j.get(result);
+        ok = ok && test_utils::bitwise_equal(result, reference);
+    }
+    std::cout << (ok ? "✓" : "✗") << " Concurrent jobs all match the blocking call\n";
+    all_passed &= ok;
+
+    // Context-based job
+    sdfgen::GenerationContext context(faces, verts);
+    sdfgen::GenerationJob context_job = sdfgen::make_level_set3_async(context, origin, dx, grid_size, ny, nz, options);
+    Array3f context_phi;
+    context_job.get(context_phi);
+    ok = test_utils::bitwise_equal(context_phi, reference);
+    std::cout << (ok ? "✓" : "✗") << " Context job matches the blocking call\n";
+    all_passed &= ok;
+
+    // Cancelling a job that has just started
+    sdfgen::GenerationJob cancelled = sdfgen::make_level_set3_async(faces, verts, origin, dx, 96, 96, 96, options);
+    cancelled.cancel();
+    ok = false;
+    try {
+        Array3f unused;
+        cancelled.get(unused);
+    } catch (const sdfgen::GenerationCancelled&) {
+        ok = true;
+    }
+    std::cout << (ok ? "✓" : "✗") << " cancel() makes get() throw GenerationCancelled\n";
+    all_passed &= ok;
+
+    // Abandoning a job cancels it and waits in the destructor
+    {
+        sdfgen::GenerationJob abandoned = sdfgen::make_level_set3_async(faces, verts, origin, dx, 96, 96, 96, options);
+    }
+    std::cout << "✓ Abandoned job stopped on destruction\n";
+
+    // Blocking call with a raised cancel flag
+    std::atomic<bool> stop(true);
+    sdfgen::GenerationOptions stopped = options;
+    stopped.cancel = &stop;
+    ok = false;
+    try {
+        Array3f unused;
+        sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, unused, stopped);
+    } catch (const sdfgen::GenerationCancelled&) {
+        ok = true;
+    }
+    std::cout << (ok ? "✓" : "✗") << " GenerationOptions::cancel stops the blocking call\n";
+    all_passed &= ok;
+
+    // get() on an empty handle is a usage error
+    ok = false;
+    try {
+        sdfgen::GenerationJob empty;
+        Array3f unused;
+        empty.get(unused);
+    } catch (const std::logic_error&) {
+        ok = true;
+    }
+    std::cout << (ok ? "✓" : "✗") << " get() on an invalid job throws\n";
+    all_passed &= ok;
+
+    // GPU jobs run on their own thread and stream
+    if (sdfgen::is_gpu_available()) {
+        sdfgen::GenerationOptions gpu_options;
+        gpu_options.backend = sdfgen::HardwareBackend::GPU;
+        Array3f gpu_reference;
+        sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, gpu_reference, gpu_options);
+        sdfgen::GenerationJob first = sdfgen::make_level_set3_async(faces, verts, origin, dx, grid_size, ny, nz, gpu_options);
+        sdfgen::GenerationJob second = sdfgen::make_level_set3_async(faces, verts, origin, dx, grid_size, ny, nz, gpu_options);
+        Array3f a, b;
+        first.get(a);
+        second.get(b);
+        ok = test_utils::bitwise_equal(a, gpu_reference) && test_utils::bitwise_equal(b, gpu_reference);
+        std::cout << (ok ? "✓" : "✗") << " Concurrent GPU jobs match the blocking call\n";
+        all_passed &= ok;
+    } else {
+        std::cout << "- GPU not available, skipping GPU job checks\n";
+    }
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL ASYNC GENERATION TESTS PASSED\n";
+    } else {
+        std::cout << "✗ ASYNC GENERATION TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the cost model behind HardwareBackend::Auto
+// Validates that estimate_backend_cost() keeps small grids on the CPU, sends large ones to
+// the GPU, switches to the streamed mode or the CPU as free device memory shrinks, honours
+// the distance and memory modes, that cost models survive a save/load round trip (and bad
+// files are rejected), and that Auto calls report their choice in GenerationStats.
+
+#include "test_utils.h"
+#include "backend_cost.h"
+#include "sdfgen_unified.h"
+#include "mesh_io.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Backend Cost Model Tests\n";
+    std::cout << "========================================\n\n";
+
+    const size_t GB = size_t(1) << 30;
+    sdfgen::BackendCostModel model;
+    sdfgen::GenerationOptions options;
+    options.num_threads = 1;
+    sdfgen::GpuCostInputs gpu;
+    gpu.available = true;
+    gpu.initialized = false;
+    gpu.free_bytes = 8 * GB;
+
+    bool all_passed = true;
+
+    // Without a GPU there is nothing to choose
+    sdfgen::GpuCostInputs no_gpu;
+    sdfgen::BackendEstimate estimate = sdfgen::estimate_backend_cost(model, options, 512, 512, 512, 100000, no_gpu);
+    bool ok = estimate.backend == sdfgen::HardwareBackend::CPU && estimate.cpu_ms > 0.0 && estimate.gpu_ms == 0.0;
+    std::cout << (ok ? "✓" : "✗") << " No GPU: CPU\n";
+    all_passed &= ok;
+
+    // Tiny grid: context creation alone outweighs the CPU run
+    estimate = sdfgen::estimate_backend_cost(model, options, 16, 16, 16, 12, gpu);
+    ok = estimate.backend == sdfgen::HardwareBackend::CPU && estimate.gpu_ms > estimate.cpu_ms;
+    std::cout << (ok ? "✓" : "✗") << " 16^3 grid: CPU (" << estimate.cpu_ms << " ms vs GPU " << estimate.gpu_ms
+              << " ms)\n";
+    all_passed &= ok;
+
+    // Large grid that fits: in-core GPU
+    gpu.initialized = true;
+    sdfgen::BackendEstimate in_core = sdfgen::estimate_backend_cost(model, options, 512, 512, 512, 100000, gpu);
+    ok = in_core.backend == sdfgen::HardwareBackend::GPU && !in_core.gpu_streamed && in_core.gpu_ms < in_core.cpu_ms;
+    std::cout << (ok ? "✓" : "✗") << " 512^3 grid, 8 GB free: in-core GPU (" << in_core.gpu_ms << " ms vs CPU "
+              << in_core.cpu_ms << " ms)\n";
+    all_passed &= ok;
+
+    // Less free memory than the grid: streamed, and slower than in-core
+    gpu.free_bytes = GB / 2;
+    estimate = sdfgen::estimate_backend_cost(model, options, 512, 512, 512, 100000, gpu);
+    ok = estimate.gpu_streamed && estimate.gpu_ms > in_core.gpu_ms;
+    options.gpu_memory_limit = GB / 2;
+    gpu.free_bytes = 8 * GB;
+    sdfgen::BackendEstimate limited = sdfgen::estimate_backend_cost(model, options, 512, 512, 512, 100000, gpu);
+    ok &= limited.gpu_streamed && limited.gpu_ms == estimate.gpu_ms;
+    std::cout << (ok ? "✓" : "✗") << " 512^3 grid, 0.5 GB free or gpu_memory_limit: streamed GPU\n";
+    all_passed &= ok;
+
+    // In-core forced with too little memory, or not even a few planes free: CPU
+    options.gpu_memory = sdfgen::GpuMemoryMode::InCore;
+    estimate = sdfgen::estimate_backend_cost(model, options, 512, 512, 512, 100000, gpu);
+    ok = estimate.backend == sdfgen::HardwareBackend::CPU && estimate.gpu_ms == 0.0;
+    options.gpu_memory = sdfgen::GpuMemoryMode::Auto;
+    options.gpu_memory_limit = 0;
+    gpu.free_bytes = size_t(1) << 20;
+    estimate = sdfgen::estimate_backend_cost(model, options, 512, 512, 512, 100000, gpu);
+    ok &= estimate.backend == sdfgen::HardwareBackend::CPU && estimate.gpu_ms == 0.0;
+    gpu.free_bytes = 8 * GB;
+    std::cout << (ok ? "✓" : "✗") << " GpuMemoryMode::InCore without room, or 1 MB free: CPU\n";
+    all_passed &= ok;
+
+    // Exact distances are CPU-only; more threads shorten the CPU estimate
+    options.distance_mode = sdfgen::DistanceMode::Exact;
+    estimate = sdfgen::estimate_backend_cost(model, options, 512, 512, 512, 100000, gpu);
+    ok = estimate.backend == sdfgen::HardwareBackend::CPU && estimate.gpu_ms == 0.0;
+    options.distance_mode = sdfgen::DistanceMode::Sweep;
+    options.num_threads = 8;
+    estimate = sdfgen::estimate_backend_cost(model, options, 512, 512, 512, 100000, gpu);
+    ok &= estimate.cpu_ms * 7.9 < in_core.cpu_ms && estimate.cpu_ms * 8.1 > in_core.cpu_ms;
+    options.num_threads = 1;
+    std::cout << (ok ? "✓" : "✗") << " DistanceMode::Exact: CPU; CPU estimate scales with num_threads\n";
+    all_passed &= ok;
+
+    // Save/load round trip; partial files keep the other fields
+    sdfgen::BackendCostModel calibrated;
+    calibrated.cpu_ns_per_cell = 1234.5;
+    calibrated.gpu_init_ms = 42.0;
+    calibrated.gpu_streamed_factor = 2.5;
+    sdfgen::BackendCostModel loaded;
+    ok = sdfgen::save_cost_model("test_backend_cost.txt", calibrated) &&
+         sdfgen::load_cost_model("test_backend_cost.txt", loaded) &&
+         loaded.cpu_ns_per_cell == calibrated.cpu_ns_per_cell && loaded.gpu_init_ms == calibrated.gpu_init_ms &&
+         loaded.gpu_streamed_factor == calibrated.gpu_streamed_factor &&
+         loaded.gpu_ns_per_distance == calibrated.gpu_ns_per_distance;
+    {
+        std::ofstream file("test_backend_cost.txt");
+        file << "# partial\ngpu_call_ms 5  # comment\n\n";
+    }
+    loaded = sdfgen::BackendCostModel();
+    ok &= sdfgen::load_cost_model("test_backend_cost.txt", loaded) && loaded.gpu_call_ms == 5.0 &&
+          loaded.cpu_ns_per_cell == sdfgen::BackendCostModel().cpu_ns_per_cell;
+    std::cout << (ok ? "✓" : "✗") << " Cost model save/load round trip\n";
+    all_passed &= ok;
+
+    std::cout << "  (expected errors follow)\n";
+    {
+        std::ofstream file("test_backend_cost.txt");
+        file << "gpu_call_ms 5\ngpu_warp_speed 9\n";
+    }
+    loaded = sdfgen::BackendCostModel();
+    ok = !sdfgen::load_cost_model("test_backend_cost.txt", loaded) && loaded.gpu_call_ms == 2.0 &&
+         !sdfgen::load_cost_model("test_backend_cost_missing.txt", loaded);
+    std::remove("test_backend_cost.txt");
+    std::cout << (ok ? "✓" : "✗") << " Unknown fields and missing files rejected, model unchanged\n";
+    all_passed &= ok;
+
+    // Through the unified API: Auto reports its choice, explicit backends do not
+    const char* mesh_file = "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 16;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+
+    sdfgen::set_backend_cost_model(calibrated);
+    sdfgen::GenerationOptions auto_options;
+    Array3f phi;
+    sdfgen::GenerationStats stats;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, auto_options, &stats);
+    sdfgen::BackendEstimate expected = sdfgen::estimate_backend(auto_options, grid_size, ny, nz, faces.size());
+    ok = sdfgen::backend_cost_model().cpu_ns_per_cell == calibrated.cpu_ns_per_cell && stats.backend_auto &&
+         stats.backend_used == expected.backend && stats.estimated_cpu_ms == expected.cpu_ms &&
+         (sdfgen::is_gpu_available() || stats.estimated_gpu_ms == 0.0);
+    auto_options.backend = sdfgen::HardwareBackend::CPU;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, auto_options, &stats);
+    ok &= !stats.backend_auto && stats.estimated_cpu_ms == 0.0;
+    std::cout << (ok ? "✓" : "✗") << " Auto records its choice in GenerationStats, explicit CPU does not\n";
+    all_passed &= ok;
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL BACKEND COST TESTS PASSED\n";
+    } else {
+        std::cout << "✗ BACKEND COST TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the block-buffered binary STL loader
+// Validates that a file spanning several read blocks is parsed record for record into the
+// preallocated vertex and face lists with exact bounds, that the optional dedup yields an
+// indexed mesh with the same triangles, and that truncated files still report the first
+// missing triangle.
+
+#include "mesh_io.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Vertex c of triangle t in the synthetic file
+static Vec3f synthetic_vertex(uint32_t t, int c) {
+    return Vec3f((float)(t % 997) + 0.25f * c, (float)(t / 997) - 0.5f * c, (float)(t % 13) * 0.125f + c);
+}
+
+static bool write_synthetic_stl(const char* filename, uint32_t num_triangles, uint32_t claimed) {
+    std::ofstream file(filename, std::ios::binary);
+    char header[80] = "synthetic binary STL";
+    file.write(header, sizeof(header));
+    file.write(reinterpret_cast<const char*>(&claimed), sizeof(claimed));
+    for (uint32_t t = 0; t < num_triangles; ++t) {
+        char record[50] = {};
+        for (int c = 0; c < 3; ++c) {
+            Vec3f v = synthetic_vertex(t, c);
+            std::memcpy(record + 12 + 12 * c, &v[0], 12);
+        }
+        file.write(record, sizeof(record));
+    }
+    return (bool)file;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Binary STL Loader Tests\n";
+    std::cout << "========================================\n\n";
+
+    bool all_passed = true;
+    const char* stl_file = "test_binary_stl_blocks.stl";
+
+    // More triangles than one read block holds
+    const uint32_t num_triangles = 600000;
+    if (!write_synthetic_stl(stl_file, num_triangles, num_triangles)) {
+        std::cerr << "ERROR: Failed to write test file\n";
+        return 1;
+    }
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    bool ok = meshio::load_stl(stl_file, verts, faces, min_box, max_box) &&
+              verts.size() == 3 * (size_t)num_triangles && faces.size() == num_triangles;
+    Vec3f expected_min = synthetic_vertex(0, 0), expected_max = expected_min;
+    int mismatches = 0;
+    for (uint32_t t = 0; ok && t < num_triangles; ++t) {
+        if (faces[t] != Vec3ui(3 * t, 3 * t + 1, 3 * t + 2)) ++mismatches;
+        for (int c = 0; c < 3; ++c) {
+            Vec3f v = synthetic_vertex(t, c);
+            if (verts[3 * t + c] != v) ++mismatches;
+            for (int a = 0; a < 3; ++a) {
+                expected_min[a] = std::min(expected_min[a], v[a]);
+                expected_max[a] = std::max(expected_max[a], v[a]);
+            }
+        }
+    }
+    ok = ok && mismatches == 0;
+    std::cout << (ok ? "✓" : "✗") << " " << num_triangles << " records parsed in order (" << mismatches
+              << " mismatches)\n";
+    all_passed &= ok;
+    ok = min_box == expected_min && max_box == expected_max;
+    std::cout << (ok ? "✓" : "✗") << " Bounds (" << min_box << ") to (" << max_box << ")\n";
+    all_passed &= ok;
+
+    // Dedup without duplicates: all vertices kept in place
+    std::vector<Vec3f> dedup_verts;
+    std::vector<Vec3ui> dedup_faces;
+    ok = meshio::load_stl(stl_file, dedup_verts, dedup_faces, min_box, max_box, true) &&
+         dedup_verts == verts && dedup_faces == faces;
+    std::cout << (ok ? "✓" : "✗") << " Dedup keeps a mesh without repeated positions unchanged\n";
+    all_passed &= ok;
+
+    // Dedup of the unwelded resource meshes: same triangles, each position stored once
+    const char* resource_files[] = {"resources/test_x3y4z5_bin.stl", "resources/test_x3y4z5_ascii.stl"};
+    for (const char* resource : resource_files) {
+        std::vector<Vec3f> soup_verts;
+        std::vector<Vec3ui> soup_faces;
+        ok = meshio::load_stl(resource, soup_verts, soup_faces, min_box, max_box) &&
+             meshio::load_stl(resource, dedup_verts, dedup_faces, min_box, max_box, true) &&
+             soup_faces.size() == dedup_faces.size();
+        for (size_t f = 0; ok && f < soup_faces.size(); ++f) {
+            for (int c = 0; c < 3; ++c) ok &= dedup_verts[dedup_faces[f][c]] == soup_verts[soup_faces[f][c]];
+        }
+        for (size_t a = 0; ok && a < dedup_verts.size(); ++a) {
+            for (size_t b = a + 1; b < dedup_verts.size(); ++b) ok &= dedup_verts[a] != dedup_verts[b];
+        }
+        std::cout << (ok ? "✓" : "✗") << " Dedup of " << resource << ": " << soup_verts.size() << " -> "
+                  << dedup_verts.size() << " vertices, same triangles\n";
+        all_passed &= ok;
+    }
+
+    // Truncated data: the count claims more records than the file holds
+    write_synthetic_stl(stl_file, 1000, 1200);
+    ok = !meshio::load_stl(stl_file, verts, faces, min_box, max_box);
+    std::cout << (ok ? "✓" : "✗") << " Truncated file is rejected\n";
+    all_passed &= ok;
+
+    // Empty mesh
+    write_synthetic_stl(stl_file, 0, 0);
+    ok = meshio::load_stl(stl_file, verts, faces, min_box, max_box) && verts.empty() && faces.empty();
+    std::cout << (ok ? "✓" : "✗") << " Empty mesh loads with no triangles\n";
+    all_passed &= ok;
+    std::remove(stl_file);
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL BINARY STL LOADER TESTS PASSED\n";
+    } else {
+        std::cout << "✗ BINARY STL LOADER TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// CLI Integration Test: Batch Pipeline (--batch)
+// Runs a list of meshes through the overlapped load / compute / write pipeline and
+// verifies that every field is byte-identical to a single-file run, that a missing mesh
+// fails only itself, that a tiny memory budget still finishes, and that sparse and
+// octree output are rejected.
+
+#include "cli_test_utils.h"
+#include "test_utils.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cli_test;
+
+static const char* LIST_FILE = "test_cli_batch_list.txt";
+
+static void write_list(const std::vector<std::string>& lines) {
+    std::ofstream list(LIST_FILE);
+    list << "# meshes for test_cli_batch\n\n";
+    for (const std::string& line : lines) list << line << "\n";
+}
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "CLI Batch Pipeline Tests\n";
+    std::cout << "========================================\n\n";
+
+    TestConfig config = get_default_test_config();
+    const std::string dir = config.test_resources_dir;
+    const std::string bin_stl = dir + "test_x3y4z5_bin.stl";
+    const std::string ascii_stl = dir + "test_x3y4z5_ascii.stl";
+    const std::string bin_sdf = dir + "test_x3y4z5_bin_sdf_32x42x52.sdf";
+    const std::string ascii_sdf = dir + "test_x3y4z5_ascii_sdf_32x42x52.sdf";
+
+    bool all_passed = true;
+
+    // Reference: one single-file run
+    delete_file_if_exists(bin_sdf);
+    CommandResult single = run_sdfgen({bin_stl, "32", "--cpu"}, config);
+    const std::vector<char> reference = test_utils::read_file_bytes(bin_sdf);
+    if (single.exit_code != 0 || reference.empty()) {
+        std::cerr << "✗ Single-file reference run failed\n";
+        return 1;
+    }
+
+    // Two meshes and a missing one: the missing mesh fails, the others are written
+    delete_file_if_exists(bin_sdf);
+    write_list({bin_stl, "  " + ascii_stl + "  ", dir + "no_such_mesh.stl"});
+    CommandResult batch = run_sdfgen({"--batch", LIST_FILE, "32", "--cpu"}, config);
+    bool ok = batch.exit_code == 1 &&
+              string_contains(batch.stdout_output, "Written: 2 / 3") &&
+              test_utils::read_file_bytes(bin_sdf) == reference &&
+              test_utils::read_file_bytes(ascii_sdf) == reference;
+    std::cout << "  " << (ok ? "✓" : "✗") << " Batch fields byte-identical to the single-file run; missing mesh fails alone\n";
+    if (!ok) std::cerr << batch.stdout_output << "\n";
+    all_passed &= ok;
+
+    // Budget smaller than one mesh, default backend: meshes run one at a time and still finish
+    delete_file_if_exists(bin_sdf);
+    delete_file_if_exists(ascii_sdf);
+    write_list({bin_stl, ascii_stl, bin_stl});
+    batch = run_sdfgen({"--batch", LIST_FILE, "32", "--batch-memory", "1", "--batch-gpu-cells", "0"}, config);
+    SDFFileInfo bin_info = read_sdf_header(bin_sdf);
+    SDFFileInfo ascii_info = read_sdf_header(ascii_sdf);
+    ok = batch.exit_code == 0 && string_contains(batch.stdout_output, "Written: 3 / 3") &&
+         bin_info.valid && bin_info.nx == 32 && bin_info.ny == 42 && bin_info.nz == 52 &&
+         ascii_info.valid && ascii_info.nx == 32 && ascii_info.ny == 42 && ascii_info.nz == 52;
+    std::cout << "  " << (ok ? "✓" : "✗") << " 1 MB budget and every grid offered to the GPU: all meshes written\n";
+    if (!ok) std::cerr << batch.stdout_output << "\n";
+    all_passed &= ok;
+
+    // Only dense fields are pipelined
+    batch = run_sdfgen({"--batch", LIST_FILE, "32", "--sparse", "2"}, config);
+    ok = batch.exit_code != 0 && string_contains(batch.stdout_output, "--batch writes dense fields");
+    std::cout << "  " << (ok ? "✓" : "✗") << " --batch with --sparse rejected\n";
+    all_passed &= ok;
+
+    delete_file_if_exists(bin_sdf);
+    delete_file_if_exists(ascii_sdf);
+    delete_file_if_exists(LIST_FILE);
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL BATCH PIPELINE TESTS PASSED\n";
+    } else {
+        std::cout << "✗ BATCH PIPELINE TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
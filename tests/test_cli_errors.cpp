@@ -335,6 +335,48 @@ bool test_malformed_obj() {
     return passed;
 }
 
+// Test: Sign modes the chosen output layout cannot honour
+bool test_sign_mode_layout_conflicts() {
+    std::cout << "\n========================================\n";
+    std::cout << "Testing Error: Sign Mode With a Parity-Only Layout\n";
+    std::cout << "========================================\n";
+
+    TestConfig config = get_default_test_config();
+    const std::string mesh = config.test_resources_dir + "test_x3y4z5_bin.stl";
+
+    // Sparse, octree and 16-bit output sign by crossing parity only
+    const std::vector<std::vector<std::string>> conflicts = {
+        {"--winding", "--sparse", "2"},
+        {"--winding", "--octree", "2"},
+        {"--ray-vote", "--sparse", "2"},
+        {"--ray-vote", "--octree", "2"},
+        {"--winding", "--fp16", "2"},
+        {"--ray-vote", "--int16", "2"},
+    };
+    bool passed = true;
+    for (const std::vector<std::string>& flags : conflicts) {
+        std::vector<std::string> args = flags;
+        args.push_back(mesh);
+        args.push_back("24");
+        CommandResult result = run_sdfgen(args, config);
+        bool rejected = result.exit_code != 0;
+        std::string label = flags[0] + " " + flags[1];
+        if (rejected) {
+            std::cout << "  ✓ " << label << " rejected\n";
+        } else {
+            std::cerr << "  ✗ " << label << " should be rejected\n";
+        }
+        passed &= rejected;
+    }
+
+    if (passed) {
+        std::cout << "✓ Sign Mode Layout Conflicts PASSED\n";
+    } else {
+        std::cerr << "✗ Sign Mode Layout Conflicts FAILED\n";
+    }
+    return passed;
+}
+
 int main() {
     std::cout << "========================================\n";
     std::cout << "CLI Error Handling Integration Test\n";
@@ -353,12 +395,13 @@ int main() {
     if (!test_invalid_argument_type()) failures++;
     if (!test_malformed_stl()) failures++;
     if (!test_malformed_obj()) failures++;
+    if (!test_sign_mode_layout_conflicts()) failures++;
 
     // Summary
     std::cout << "\n========================================\n";
     std::cout << "CLI Error Handling Test Summary\n";
     std::cout << "========================================\n";
-    std::cout << "Tests run: 10\n";
+    std::cout << "Tests run: 11\n";
     std::cout << "Failures: " << failures << "\n";
 
     if (failures == 0) {
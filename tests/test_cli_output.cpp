@@ -3,7 +3,8 @@
 // Licensed under the MIT License - see LICENSE file
 
 // CLI Integration Test: Output File Generation
-// Tests binary .sdf output, filename generation, and VTK output (if available)
+// Tests binary .sdf output, filename generation, VTK output (if available), and the
+// --stats, --trace and --quiet reports
 
 #include "cli_test_utils.h"
 #include <iostream>
@@ -240,6 +241,67 @@ bool test_vtk_output() {
 #endif
 }
 
+// Test --stats, --trace and --quiet
+bool test_stats_and_trace() {
+    std::cout << "\n========================================\n";
+    std::cout << "Testing --stats, --trace and --quiet\n";
+    std::cout << "========================================\n";
+
+    TestConfig config = get_default_test_config();
+    config.verbose = true;
+
+    std::string sdf_file = config.test_resources_dir + "test_x3y4z5_bin_sdf_24x31x39.sdf";
+    std::string vtk_file = config.test_resources_dir + "test_x3y4z5_bin_sdf_24x31x39.vti";
+    std::string trace_file = config.test_resources_dir + "test_cli_output_trace.json";
+    delete_file_if_exists(trace_file);
+
+    std::vector<std::string> args = {
+        config.test_resources_dir + "test_x3y4z5_bin.stl",
+        "24",
+        "--cpu",
+        "--stats",
+        "--quiet",
+        "--trace",
+        trace_file
+    };
+
+    CommandResult result = run_sdfgen(args, config);
+    bool ok = false;
+
+    try {
+        assert_exit_code(result, 0, "Stats and trace");
+
+        assert_file_exists(trace_file, "Phase trace");
+
+        // Stats block printed, loader progress suppressed
+        if (!string_contains(result.stdout_output, "Generation stats (CPU):") ||
+            !string_contains(result.stdout_output, "Distance evaluations: ") ||
+            !string_contains(result.stdout_output, "Near band: ") ||
+            string_contains(result.stdout_output, "Reading binary STL")) {
+            std::cerr << "✗ Stats FAILED: stats block missing or loader messages not suppressed\n";
+        } else {
+            std::ifstream trace(trace_file);
+            std::string first_line;
+            std::getline(trace, first_line);
+            ok = string_starts_with(first_line, "{\"traceEvents\":");
+            if (!ok) std::cerr << "✗ Trace FAILED: not a trace-event JSON file\n";
+        }
+
+        if (ok) {
+            std::cout << "✓ Stats and Trace PASSED\n";
+            std::cout << "  Stats block printed, loader messages suppressed\n";
+            std::cout << "  Trace: test_cli_output_trace.json\n";
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << "\n";
+    }
+    delete_file_if_exists(sdf_file);
+    delete_file_if_exists(vtk_file);
+    delete_file_if_exists(trace_file);
+    return ok;
+}
+
 int main() {
     std::cout << "========================================\n";
     std::cout << "CLI Output File Generation Test\n";
@@ -252,12 +314,13 @@ int main() {
     if (!test_filename_with_dimensions()) failures++;
     if (!test_file_overwrite()) failures++;
     if (!test_vtk_output()) failures++;
+    if (!test_stats_and_trace()) failures++;
 
     // Summary
     std::cout << "\n========================================\n";
     std::cout << "CLI Output Test Summary\n";
     std::cout << "========================================\n";
-    std::cout << "Tests run: 4\n";
+    std::cout << "Tests run: 5\n";
     std::cout << "Failures: " << failures << "\n";
 
     if (failures == 0) {
@@ -0,0 +1,98 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// CLI Integration Test: Thread Count Independence
+// Runs the CPU backend with different -t values and verifies that the
+// written .sdf files are byte-identical.
+
+#include "cli_test_utils.h"
+#include "test_utils.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cli_test;
+
+// Run one input at several thread counts and compare every output to the 1-thread run
+static bool check_thread_independence(const TestConfig& config,
+                                      const std::vector<std::string>& base_args,
+                                      const std::string& output_file,
+                                      const std::string& test_name) {
+    std::cout << "\n========================================\n";
+    std::cout << "Testing " << test_name << "\n";
+    std::cout << "========================================\n";
+
+    const char* thread_counts[] = {"1", "2", "3", "8", "0"};
+    std::vector<char> reference;
+
+    for (const char* threads : thread_counts) {
+        delete_file_if_exists(output_file);
+
+        std::vector<std::string> args = base_args;
+        args.push_back("--cpu");
+        args.push_back("-t");
+        args.push_back(threads);
+
+        CommandResult result = run_sdfgen(args, config);
+        if (result.exit_code != 0) {
+            std::cerr << "✗ " << test_name << " FAILED: exit code " << result.exit_code
+                      << " with -t " << threads << "\n";
+            return false;
+        }
+
+        std::vector<char> bytes = test_utils::read_file_bytes(output_file);
+        if (bytes.empty()) {
+            std::cerr << "✗ " << test_name << " FAILED: could not read " << output_file << "\n";
+            return false;
+        }
+
+        if (reference.empty()) {
+            reference.swap(bytes);
+            std::cout << "  Reference (-t 1): " << reference.size() << " bytes\n";
+        } else if (bytes != reference) {
+            std::cerr << "✗ " << test_name << " FAILED: -t " << threads
+                      << " output differs from -t 1\n";
+            delete_file_if_exists(output_file);
+            return false;
+        } else {
+            std::cout << "  ✓ -t " << threads << " identical to -t 1\n";
+        }
+    }
+
+    delete_file_if_exists(output_file);
+    std::cout << "✓ " << test_name << " PASSED\n";
+    return true;
+}
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "CLI Thread Independence Tests\n";
+    std::cout << "========================================\n";
+
+    TestConfig config = get_default_test_config();
+
+    bool all_passed = true;
+
+    all_passed &= check_thread_independence(
+        config,
+        {config.test_resources_dir + "test_x3y4z5_bin.stl", "32"},
+        config.test_resources_dir + "test_x3y4z5_bin_sdf_32x42x52.sdf",
+        "STL grid mode");
+
+    all_passed &= check_thread_independence(
+        config,
+        {config.test_resources_dir + "test_x3y4z5_quads.obj", "0.1", "2"},
+        config.test_resources_dir + "test_x3y4z5_quads.sdf",
+        "OBJ cell size mode");
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL THREAD INDEPENDENCE TESTS PASSED\n";
+    } else {
+        std::cout << "✗ THREAD INDEPENDENCE TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
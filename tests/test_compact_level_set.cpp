@@ -0,0 +1,156 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Library Test: 16-bit compact level sets
+// Validates the fp16 conversion on every half value, that make_compact_level_set3() stores
+// exactly encode() of the dense field for both encodings and any thread count, that it
+// holds a fraction of the dense memory, that .qsdf files round-trip, and that sign modes
+// other than parity are rejected.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "sdf_io.h"
+#include "mesh_io.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Every node equals encode() of the dense value; returns the largest decoded error
+static bool matches_dense(const sdfgen::CompactLevelSet& compact, const Array3f& dense, float& max_error) {
+    bool ok = compact.ni == dense.ni && compact.nj == dense.nj && compact.nk == dense.nk;
+    max_error = 0.0f;
+    for (int k = 0; ok && k < dense.nk; ++k) {
+        for (int j = 0; j < dense.nj; ++j) {
+            for (int i = 0; i < dense.ni; ++i) {
+                float clamped = std::max(-compact.band, std::min(compact.band, dense(i, j, k)));
+                ok &= compact.raw(i, j, k) == compact.encode(dense(i, j, k));
+                max_error = std::max(max_error, std::fabs(compact(i, j, k) - clamped));
+            }
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Compact Level Set Tests\n";
+    std::cout << "========================================\n\n";
+
+    bool all_passed = true;
+
+    // fp16 conversion: every finite half survives float and back, rounding goes to nearest even
+    bool ok = true;
+    for (uint32_t h = 0; h < 0x10000u; ++h) {
+        if ((h & 0x7c00u) == 0x7c00u) continue;
+        ok &= sdfgen::float_to_half(sdfgen::half_to_float((uint16_t)h)) == h;
+    }
+    ok &= sdfgen::float_to_half(1.0f + 1.0f / 2048.0f) == 0x3c00u &&        // halfway, stays even
+          sdfgen::float_to_half(1.0f + 3.0f / 2048.0f) == 0x3c02u &&        // halfway, rounds up to even
+          sdfgen::float_to_half(65520.0f) == 0x7c00u && sdfgen::float_to_half(-1e-9f) == 0x8000u;
+    std::cout << (ok ? "✓" : "✗") << " fp16: all finite halves round-trip, ties to even, overflow and underflow\n";
+    all_passed &= ok;
+
+    const char* mesh_file = argc > 1 ? argv[1] : "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 48;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    std::cout << "  Grid: " << grid_size << "x" << ny << "x" << nz << "\n\n";
+
+    sdfgen::GenerationOptions options;
+    options.backend = sdfgen::HardwareBackend::CPU;
+    options.exact_band = 3;
+    options.num_threads = 1;
+    Array3f dense;
+    sdfgen::GenerationStats dense_stats;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, dense, options, &dense_stats);
+
+    // Both encodings, 1 and 4 threads: exactly the dense field clamped and rounded once
+    const sdfgen::CompactFormat formats[2] = {sdfgen::CompactFormat::Half, sdfgen::CompactFormat::Int16};
+    const char* names[2] = {"fp16", "int16"};
+    sdfgen::CompactLevelSet compact;
+    sdfgen::GenerationStats stats;
+    for (int f = 0; f < 2; ++f) {
+        options.num_threads = 1;
+        sdfgen::make_compact_level_set3(faces, verts, origin, dx, grid_size, ny, nz, formats[f], compact, options,
+                                        &stats);
+        float max_error = 0.0f;
+        ok = compact.band == 3 * dx && matches_dense(compact, dense, max_error) && stats.sweep_iterations == 0;
+        // fp16 error is relative (2^-11 at |phi| = band), int16 error uniform (half a step)
+        ok &= max_error <= (f == 0 ? compact.band / 2048.0f : 0.5f * compact.band / 32767.0f) * 1.001f;
+        options.num_threads = 4;
+        sdfgen::CompactLevelSet threaded;
+        sdfgen::make_compact_level_set3(faces, verts, origin, dx, grid_size, ny, nz, formats[f], threaded, options);
+        ok &= threaded.words() == compact.words();
+        std::cout << (ok ? "✓" : "✗") << " " << names[f] << ": raw words == encode(dense) at exact_band 3, "
+                  << "1 and 4 threads identical (max error " << max_error / dx << " dx)\n";
+        all_passed &= ok;
+    }
+
+    // Memory: 16-bit words plus a parity bit, against phi, closest_tri and intersection_count
+    ok = stats.host_bytes > 0 && stats.host_bytes * 4 < dense_stats.host_bytes &&
+         stats.host_bytes <= compact.memory_bytes() + (size_t)(grid_size / 8 + 1) * ny * nz;
+    std::cout << (ok ? "✓" : "✗") << " Peak memory " << stats.host_bytes << " bytes vs dense "
+              << dense_stats.host_bytes << "\n";
+    all_passed &= ok;
+
+    // .qsdf round trip keeps geometry, encoding and every word
+    sdfgen::CompactLevelSet loaded;
+    ok = write_compact_sdf("test_compact_level_set.qsdf", compact) &&
+         read_compact_sdf("test_compact_level_set.qsdf", loaded) && loaded.ni == compact.ni &&
+         loaded.nj == compact.nj && loaded.nk == compact.nk && loaded.dx == compact.dx &&
+         loaded.band == compact.band && loaded.format == compact.format && loaded.origin == compact.origin &&
+         loaded.words() == compact.words();
+    Array3f expanded;
+    loaded.to_dense(expanded);
+    ok &= expanded(grid_size / 2, ny / 2, nz / 2) == compact(grid_size / 2, ny / 2, nz / 2);
+    std::cout << (ok ? "✓" : "✗") << " .qsdf write/read round trip\n";
+    all_passed &= ok;
+
+    // The packed sign bits come from crossing parity only, so other sign modes must throw
+    sdfgen::GenerationOptions voted = options;
+    ok = true;
+    for (sdfgen::SignMode mode : {sdfgen::SignMode::WindingNumber, sdfgen::SignMode::RayVote}) {
+        voted.sign_mode = mode;
+        ok &= test_utils::throws_runtime_error([&] {
+            sdfgen::make_compact_level_set3(faces, verts, origin, dx, grid_size, ny, nz, sdfgen::CompactFormat::Half,
+                                            loaded, voted);
+        });
+    }
+    std::cout << (ok ? "✓" : "✗") << " Winding-number and ray-vote signs rejected\n";
+    all_passed &= ok;
+
+    std::cout << "  (expected errors follow)\n";
+    {
+        std::ofstream file("test_compact_level_set.qsdf", std::ios::binary);
+        file.write("SDFS", 4);
+    }
+    ok = !read_compact_sdf("test_compact_level_set.qsdf", loaded) &&
+         !read_compact_sdf("test_compact_level_set_missing.qsdf", loaded);
+    std::remove("test_compact_level_set.qsdf");
+    std::cout << (ok ? "✓" : "✗") << " Wrong magic and missing files rejected\n";
+    all_passed &= ok;
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL COMPACT LEVEL SET TESTS PASSED\n";
+    } else {
+        std::cout << "✗ COMPACT LEVEL SET TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
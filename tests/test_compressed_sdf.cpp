@@ -0,0 +1,182 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the chunked compressed SDF format (.csdf)
+// Validates that float32 chunks round-trip bit for bit (after the optional band clamp),
+// that 8- and 16-bit quantization stays within half a step and keeps every sign, that
+// random access through CompressedSDF matches the full read, that the file does not depend
+// on the thread count, and that truncated or corrupt files are rejected.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "compressed_sdf.h"
+#include "mesh_io.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static bool check_mode(const char* label, const Array3f& phi, const Vec3f& origin, float dx,
+                       const sdfgen::SdfCompression& options) {
+    const char* filename = "test_compressed.csdf";
+    if (!write_compressed_sdf(filename, phi, origin, dx, options)) {
+        std::cout << "  ✗ " << label << ": write failed\n";
+        return false;
+    }
+    size_t bytes = test_utils::read_file_bytes(filename).size();
+
+    Array3f back;
+    Vec3f back_origin;
+    float back_dx = 0;
+    bool ok = read_compressed_sdf(filename, back, back_origin, back_dx) &&
+              back.ni == phi.ni && back.nj == phi.nj && back.nk == phi.nk &&
+              back_origin == origin && back_dx == dx;
+
+    // Expected error: none for float32, half a quantization step (plus float rounding) otherwise
+    float band = options.band;
+    if (options.quantize_bits != 0 && band == 0.0f) {
+        for (size_t n = 0; n < phi.a.size(); ++n) band = std::max(band, std::fabs(phi.a[n]));
+    }
+    float tolerance = options.quantize_bits == 0 ? 0.0f
+                    : band / (float)((1 << options.quantize_bits) - 1) + 1e-6f * band;
+    float max_error = 0.0f;
+    bool signs = true;
+    for (size_t n = 0; ok && n < phi.a.size(); ++n) {
+        float expected = band > 0.0f ? std::max(-band, std::min(band, phi.a[n])) : phi.a[n];
+        max_error = std::max(max_error, std::fabs(back.a[n] - expected));
+        signs &= (back.a[n] < 0.0f) == (phi.a[n] < 0.0f);
+    }
+    ok &= max_error <= tolerance && signs;
+
+    // Random access agrees with the full read
+    sdfgen::CompressedSDF reader;
+    ok &= reader.open(filename);
+    for (int n = 0; ok && n < 200; ++n) {
+        int i = (n * 37) % phi.ni, j = (n * 53) % phi.nj, k = (n * 71) % phi.nk;
+        ok &= reader.value(i, j, k) == back(i, j, k);
+    }
+
+    std::cout << "  " << (ok ? "✓ " : "✗ ") << label << ": " << bytes / 1024 << " KB ("
+              << (100.0 * bytes / (phi.a.size() * sizeof(float))) << "% of dense), max error "
+              << max_error << "\n";
+    std::remove(filename);
+    return ok;
+}
+
+static bool check_thread_independence(const Array3f& phi, const Vec3f& origin, float dx) {
+    sdfgen::SdfCompression options;
+    options.quantize_bits = 16;
+    options.num_threads = 1;
+    write_compressed_sdf("test_compressed_1.csdf", phi, origin, dx, options);
+    options.num_threads = 4;
+    write_compressed_sdf("test_compressed_4.csdf", phi, origin, dx, options);
+    bool same = test_utils::read_file_bytes("test_compressed_1.csdf") == test_utils::read_file_bytes("test_compressed_4.csdf");
+    std::cout << "  " << (same ? "✓" : "✗") << " 1 and 4 threads write identical files\n";
+    std::remove("test_compressed_1.csdf");
+    std::remove("test_compressed_4.csdf");
+    return same;
+}
+
+static bool check_rejected(const Array3f& phi, const Vec3f& origin, float dx) {
+    const char* filename = "test_compressed_bad.csdf";
+    write_compressed_sdf(filename, phi, origin, dx);
+    std::vector<char> bytes = test_utils::read_file_bytes(filename);
+    Array3f back;
+    Vec3f back_origin;
+    float back_dx;
+    std::cout << "  (expected errors follow)\n";
+
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file.write(bytes.data(), bytes.size() - 1);
+    }
+    bool ok = !read_compressed_sdf(filename, back, back_origin, back_dx);
+
+    // Flip a run-length control byte in the last chunk
+    std::vector<char> corrupt = bytes;
+    corrupt[corrupt.size() - 40] ^= 0x7f;
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file.write(corrupt.data(), corrupt.size());
+    }
+    Array3f reread;
+    bool read = read_compressed_sdf(filename, reread, back_origin, back_dx);
+    ok &= !read || std::memcmp(reread.a.data, phi.a.data, phi.a.size() * sizeof(float)) != 0;
+
+    std::ofstream(filename, std::ios::binary).write("SDFS", 4);
+    ok &= !read_compressed_sdf(filename, back, back_origin, back_dx);
+
+    std::cout << "  " << (ok ? "✓" : "✗") << " Truncated, corrupt and foreign files rejected\n";
+    std::remove(filename);
+    return ok;
+}
+
+// Noise exercises the literal runs of the coder
+static bool check_noise_chunk() {
+    std::vector<float> values(sdfgen::CompressedSDF::chunk_cells), back(values.size());
+    test_utils::RandomFloats random(13579u);
+    for (float& v : values) v = random.next() - 0.5f;
+    std::vector<unsigned char> encoded;
+    sdfgen::encode_sdf_chunk(values.data(), 0, 0.0f, encoded);
+    bool ok = sdfgen::decode_sdf_chunk(encoded.data(), encoded.size(), 0, 0.0f, back.data()) &&
+              std::memcmp(values.data(), back.data(), values.size() * sizeof(float)) == 0 &&
+              !sdfgen::decode_sdf_chunk(encoded.data(), encoded.size() - 1, 0, 0.0f, back.data());
+    std::cout << "  " << (ok ? "✓" : "✗") << " Noise chunk round-trips; truncated chunk rejected\n";
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Compressed SDF Format Tests\n";
+    std::cout << "========================================\n\n";
+
+    const char* mesh_file = "resources/test_x3y4z5_quads.obj";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_obj(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+
+    // 70 nodes along x: chunks at the far edge are partial
+    int grid_size = 70;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    sdfgen::GenerationOptions gen_options;
+    gen_options.backend = sdfgen::HardwareBackend::CPU;
+    Array3f phi;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, gen_options);
+    std::cout << "Grid " << phi.ni << "x" << phi.nj << "x" << phi.nk << "\n";
+
+    bool all_passed = true;
+    sdfgen::SdfCompression options;
+    all_passed &= check_mode("float32, lossless", phi, origin, dx, options);
+    options.band = 4 * dx;
+    all_passed &= check_mode("float32, band 4dx", phi, origin, dx, options);
+    options.quantize_bits = 16;
+    all_passed &= check_mode("16-bit, band 4dx", phi, origin, dx, options);
+    options.quantize_bits = 8;
+    all_passed &= check_mode("8-bit, band 4dx", phi, origin, dx, options);
+    options.band = 0.0f;
+    all_passed &= check_mode("8-bit, full range", phi, origin, dx, options);
+    all_passed &= check_thread_independence(phi, origin, dx);
+    all_passed &= check_noise_chunk();
+    all_passed &= check_rejected(phi, origin, dx);
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL COMPRESSED SDF TESTS PASSED\n";
+    } else {
+        std::cout << "✗ COMPRESSED SDF TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for DistanceMode::Exact (BVH nearest-triangle query per cell)
+// Validates that the exact mode matches a brute-force exact band covering the
+// whole grid bit for bit, that it never reports a larger distance than the
+// swept field, and reports its speed relative to brute force.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "mesh_io.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+static double run_ms(const std::vector<Vec3ui>& faces, const std::vector<Vec3f>& verts,
+                     const Vec3f& origin, float dx, int nx, int ny, int nz,
+                     Array3f& phi, const sdfgen::GenerationOptions& options) {
+    auto start = std::chrono::high_resolution_clock::now();
+    sdfgen::make_level_set3(faces, verts, origin, dx, nx, ny, nz, phi, options);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static bool check_exact(const char* label,
+                        const std::vector<Vec3ui>& faces, const std::vector<Vec3f>& verts,
+                        const Vec3f& origin, float dx, int nx, int ny, int nz) {
+    std::cout << label << " (" << faces.size() << " triangles, "
+              << nx << "x" << ny << "x" << nz << ")\n";
+
+    sdfgen::GenerationOptions brute;
+    brute.backend = sdfgen::HardwareBackend::CPU;
+    brute.exact_band = nx + ny + nz;
+    Array3f reference;
+    double brute_ms = run_ms(faces, verts, origin, dx, nx, ny, nz, reference, brute);
+
+    sdfgen::GenerationOptions swept;
+    swept.backend = sdfgen::HardwareBackend::CPU;
+    Array3f phi_swept;
+    sdfgen::make_level_set3(faces, verts, origin, dx, nx, ny, nz, phi_swept, swept);
+
+    bool ok = true;
+    const int thread_counts[] = {1, 4};
+    for (int threads : thread_counts) {
+        sdfgen::GenerationOptions exact;
+        exact.backend = sdfgen::HardwareBackend::CPU;
+        exact.distance_mode = sdfgen::DistanceMode::Exact;
+        exact.num_threads = threads;
+        Array3f phi;
+        double exact_ms = run_ms(faces, verts, origin, dx, nx, ny, nz, phi, exact);
+
+        if (test_utils::bitwise_equal(reference, phi)) {
+            std::cout << "  ✓ " << threads << " thread(s): matches brute force ("
+                      << (int)exact_ms << " ms vs " << (int)brute_ms << " ms)\n";
+        } else {
+            std::cout << "  ✗ " << threads << " thread(s): differs from brute force\n";
+            ok = false;
+        }
+    }
+
+    // The swept far field is an upper bound on the exact distance
+    bool bounded = true;
+    for (unsigned long n = 0; n < reference.a.size(); ++n) {
+        if (std::fabs(reference.a[n]) > std::fabs(phi_swept.a[n])) bounded = false;
+    }
+    if (bounded) {
+        std::cout << "  ✓ Exact distances never exceed swept distances\n";
+    } else {
+        std::cout << "  ✗ Exact distance larger than swept distance\n";
+        ok = false;
+    }
+    std::cout << "\n";
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Exact Distance Mode Tests\n";
+    std::cout << "========================================\n\n";
+
+    bool all_passed = true;
+
+    {
+        const char* mesh_file = "resources/test_x3y4z5_bin.stl";
+        std::vector<Vec3f> verts;
+        std::vector<Vec3ui> faces;
+        Vec3f min_box, max_box;
+        if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+            std::cerr << "ERROR: Failed to load test mesh\n";
+            return 1;
+        }
+
+        int grid_size = 32;
+        float dx;
+        int ny, nz;
+        Vec3f origin;
+        test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+        all_passed &= check_exact("Closed box mesh", faces, verts, origin, dx, grid_size, ny, nz);
+    }
+
+    {
+        std::vector<Vec3f> verts;
+        std::vector<Vec3ui> faces;
+        test_utils::make_triangle_soup(2000, Vec3f(1.0f, 1.0f, 1.0f), Vec3f(7.0f, 7.0f, 7.0f), 0.5f, 24680u,
+                                       verts, faces);
+        all_passed &= check_exact("Triangle soup", faces, verts,
+                                  Vec3f(0.0f, 0.0f, 0.0f), 0.25f, 32, 32, 32);
+    }
+
+    {
+        // Empty mesh: nothing to query, field stays at the upper bound
+        std::vector<Vec3f> verts;
+        std::vector<Vec3ui> faces;
+        sdfgen::GenerationOptions exact;
+        exact.backend = sdfgen::HardwareBackend::CPU;
+        exact.distance_mode = sdfgen::DistanceMode::Exact;
+        Array3f phi;
+        sdfgen::make_level_set3(faces, verts, Vec3f(0.0f, 0.0f, 0.0f), 1.0f, 4, 4, 4, phi, exact);
+        bool ok = (phi.a.size() == 64 && phi(0, 0, 0) == 12.0f);
+        std::cout << (ok ? "✓" : "✗") << " Empty mesh handled\n\n";
+        all_passed &= ok;
+    }
+
+    std::cout << "========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL EXACT DISTANCE TESTS PASSED\n";
+    } else {
+        std::cout << "✗ EXACT DISTANCE TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
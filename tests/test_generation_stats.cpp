@@ -0,0 +1,167 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for GenerationStats reporting through the unified API
+// Validates that the backend actually used is reported, that diagnostics are only computed
+// on request and leave the field untouched, that the near-band statistics agree with values
+// recomputed from the output grid, that the phase times fit within the call, that the work
+// and memory counters are filled, and that the phase hook and PhaseTrace see every phase.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "mesh_io.h"
+#include "phase_trace.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Generation Stats Tests\n";
+    std::cout << "========================================\n\n";
+
+    const char* mesh_file = "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 24;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    std::cout << "\n";
+
+    bool all_passed = true;
+
+    // Default call: backend reported, no diagnostics
+    sdfgen::GenerationOptions options;
+    options.backend = sdfgen::HardwareBackend::CPU;
+    Array3f reference;
+    sdfgen::GenerationStats stats;
+    stats.diagnostics_valid = true; // must be reset by the call
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, reference, options, &stats);
+    bool ok = stats.backend_used == sdfgen::HardwareBackend::CPU && !stats.diagnostics_valid &&
+              stats.sweep_iterations == 16 && !stats.sweep_converged;
+    std::cout << (ok ? "✓" : "✗") << " Backend and sweep count reported, diagnostics off by default\n";
+    all_passed &= ok;
+
+    // Diagnostics must not change the result
+    options.diagnostics = true;
+    Array3f phi;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, options, &stats);
+    ok = stats.diagnostics_valid &&
+         std::memcmp(phi.a.data, reference.a.data, phi.a.size() * sizeof(float)) == 0;
+    std::cout << (ok ? "✓" : "✗") << " Diagnostics leave the field bit-identical\n";
+    all_passed &= ok;
+
+    ok = stats.near_band_cells > 0 && stats.near_band_cells < (long long)phi.a.size() &&
+         stats.near_band_min >= 0.0f && stats.near_band_min <= stats.near_band_max &&
+         stats.intersections > 0 && stats.intersections % 2 == 0;
+    std::cout << (ok ? "✓" : "✗") << " Near band: " << stats.near_band_cells << " cells, distances ["
+              << stats.near_band_min << ", " << stats.near_band_max << "], "
+              << stats.intersections << " crossings\n";
+    all_passed &= ok;
+
+    // With a band covering the whole grid the statistics describe the final field
+    options.exact_band = grid_size + ny + nz;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, options, &stats);
+    float lo = std::fabs(phi.a[0]), hi = lo;
+    for (unsigned long n = 0; n < phi.a.size(); ++n) {
+        lo = std::min(lo, std::fabs(phi.a[n]));
+        hi = std::max(hi, std::fabs(phi.a[n]));
+    }
+    ok = stats.near_band_cells == (long long)phi.a.size() &&
+         stats.near_band_min == lo && stats.near_band_max == hi;
+    std::cout << (ok ? "✓" : "✗") << " Full band: statistics match the output grid\n";
+    all_passed &= ok;
+
+    // Thread count must not affect the statistics
+    sdfgen::GenerationStats single;
+    options.num_threads = 1;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, options, &single);
+    ok = single.near_band_cells == stats.near_band_cells && single.intersections == stats.intersections &&
+         single.near_band_min == stats.near_band_min && single.near_band_max == stats.near_band_max;
+    std::cout << (ok ? "✓" : "✗") << " Statistics independent of thread count\n";
+    all_passed &= ok;
+
+    // Phase times: filled on every call, and together no longer than the call itself
+    options = sdfgen::GenerationOptions();
+    options.backend = sdfgen::HardwareBackend::CPU;
+    auto start = std::chrono::steady_clock::now();
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, options, &stats);
+    double call_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    double phase_sum = stats.setup_ms + stats.near_band_ms + stats.sweep_ms + stats.sign_ms + stats.copy_ms;
+    ok = stats.setup_ms >= 0.0 && stats.near_band_ms > 0.0 && stats.sweep_ms > 0.0 && stats.sign_ms >= 0.0 &&
+         stats.copy_ms == 0.0 && phase_sum <= call_ms;
+    std::cout << (ok ? "✓" : "✗") << " Phase times: near band " << stats.near_band_ms << " ms, sweep "
+              << stats.sweep_ms << " ms, sign " << stats.sign_ms << " ms (call " << call_ms << " ms)\n";
+    all_passed &= ok;
+
+    // Work and memory: every cell is at least evaluated once by the sweeps, and the count
+    // does not depend on how the work was split
+    const size_t cells = phi.a.size();
+    options.num_threads = 1;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, options, &single);
+    options.num_threads = 4;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, options, &stats);
+    ok = stats.distance_evaluations > (long long)cells &&
+         stats.distance_evaluations == single.distance_evaluations &&
+         stats.host_bytes >= cells * (sizeof(float) + 2 * sizeof(int)) && stats.gpu_cas_retries == 0 &&
+         stats.device_bytes == 0 && stats.bytes_to_device == 0 && stats.bytes_to_host == 0;
+    options.distance_mode = sdfgen::DistanceMode::Exact;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, options, &single);
+    ok &= single.distance_evaluations > 0 && single.host_bytes > stats.host_bytes;
+    std::cout << (ok ? "✓" : "✗") << " Work: " << stats.distance_evaluations << " distances (exact: "
+              << single.distance_evaluations << "), " << stats.host_bytes << " host bytes\n";
+    all_passed &= ok;
+
+    // Phase hook: begin/end pairs in phase order, also without stats
+    std::vector<std::pair<sdfgen::GenerationPhase, bool>> events;
+    options = sdfgen::GenerationOptions();
+    options.backend = sdfgen::HardwareBackend::CPU;
+    options.phase_hook = [&](sdfgen::GenerationPhase phase, bool begin) {
+        events.push_back(std::make_pair(phase, begin));
+    };
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, options);
+    const sdfgen::GenerationPhase order[] = {sdfgen::GenerationPhase::Setup, sdfgen::GenerationPhase::NearBand,
+                                             sdfgen::GenerationPhase::Sweep, sdfgen::GenerationPhase::Sign};
+    ok = events.size() == 8;
+    for (size_t n = 0; ok && n < events.size(); ++n) {
+        ok = events[n].first == order[n / 2] && events[n].second == (n % 2 == 0);
+    }
+    std::cout << (ok ? "✓" : "✗") << " Phase hook: " << events.size() << " events, begin/end pairs in order\n";
+    all_passed &= ok;
+
+    // PhaseTrace: one begin and one end event per phase, written as trace-event JSON
+    sdfgen::PhaseTrace trace;
+    options.phase_hook = trace.hook();
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, options);
+    ok = trace.size() == 8 && trace.write_json("test_generation_stats_trace.json");
+    std::vector<char> bytes = test_utils::read_file_bytes("test_generation_stats_trace.json");
+    std::string json(bytes.begin(), bytes.end());
+    ok &= json.compare(0, 15, "{\"traceEvents\":") == 0 && json.find("\"name\": \"near_band\"") != std::string::npos &&
+          json.find("\"ph\": \"E\"") != std::string::npos;
+    std::remove("test_generation_stats_trace.json");
+    std::cout << (ok ? "✓" : "✗") << " PhaseTrace: " << trace.size() << " events written as trace-event JSON\n";
+    all_passed &= ok;
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL GENERATION STATS TESTS PASSED\n";
+    } else {
+        std::cout << "✗ GENERATION STATS TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for incremental updates of a retained field
+// Validates that update_level_set3() after moving, removing and re-adding triangles gives the
+// same near band and signs as regenerating the edited mesh from scratch, stays close to it in
+// the far field, and rewrites fewer nodes than the grid holds.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "mesh_io.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+// Compare an updated field with a full regeneration of the same mesh
+static bool matches_regeneration(const sdfgen::LevelSetState& state, const Array3f& full, int band, float dx,
+                                 float far_tolerance) {
+    int band_errors = 0, sign_errors = 0;
+    float far_error = 0;
+    for (int k = 0; k < full.nk; ++k) {
+        for (int j = 0; j < full.nj; ++j) {
+            for (int i = 0; i < full.ni; ++i) {
+                float expected = full(i, j, k), value = state.phi(i, j, k);
+                if ((value < 0) != (expected < 0)) ++sign_errors;
+                if (std::fabs(expected) < band * dx) {
+                    if (value != expected) ++band_errors;
+                } else {
+                    far_error = std::max(far_error, std::fabs(value - expected));
+                }
+            }
+        }
+    }
+    std::cout << "  band mismatches " << band_errors << ", sign mismatches " << sign_errors
+              << ", far-field max error " << far_error / dx << " dx\n";
+    return band_errors == 0 && sign_errors == 0 && far_error <= far_tolerance * dx;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Incremental Update Tests\n";
+    std::cout << "========================================\n\n";
+
+    const char* mesh_file = "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 40;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    std::cout << "\n";
+
+    bool all_passed = true;
+
+    const int band = 2;
+    sdfgen::GenerationOptions options;
+    options.backend = sdfgen::HardwareBackend::CPU;
+    options.exact_band = band;
+
+    // The retained generation is the plain field
+    sdfgen::LevelSetState state;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, state, options);
+    Array3f full;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, full, options);
+    bool ok = state.phi.a.size() == full.a.size() &&
+              std::memcmp(state.phi.a.data, full.a.data, full.a.size() * sizeof(float)) == 0 &&
+              state.closest_tri.ni == grid_size && state.tri.size() == faces.size();
+    std::cout << (ok ? "✓" : "✗") << " Retained state holds the same field as make_level_set3\n";
+    all_passed &= ok;
+    const size_t cells = full.a.size();
+
+    // Push the two triangles of the +x face outward
+    std::vector<Vec3ui> moved_faces = faces;
+    std::vector<Vec3f> moved_verts = verts;
+    std::vector<unsigned int> changed;
+    for (unsigned int t = 0; t < faces.size(); ++t) {
+        bool on_face = true;
+        for (int c = 0; c < 3; ++c) on_face &= verts[faces[t][c]][0] == max_box[0];
+        if (!on_face) continue;
+        changed.push_back(t);
+        for (int c = 0; c < 3; ++c) moved_verts[faces[t][c]][0] += 3.5f * dx;
+    }
+    sdfgen::GenerationStats stats;
+    sdfgen::update_level_set3(moved_faces, moved_verts, changed, state, options, &stats);
+    sdfgen::make_level_set3(moved_faces, moved_verts, origin, dx, grid_size, ny, nz, full, options);
+    ok = changed.size() == 2 && matches_regeneration(state, full, band, dx, 0.5f) &&
+         stats.cells_updated > 0 && (size_t)stats.cells_updated < cells;
+    std::cout << (ok ? "✓" : "✗") << " Moved face matches a full regeneration (" << stats.cells_updated
+              << " node writes for " << cells << " nodes)\n";
+    all_passed &= ok;
+
+    // Remove the last two triangles
+    std::vector<Vec3ui> open_faces(moved_faces.begin(), moved_faces.end() - 2);
+    std::vector<unsigned int> removed = {(unsigned int)faces.size() - 2, (unsigned int)faces.size() - 1};
+    sdfgen::update_level_set3(open_faces, moved_verts, removed, state, options, &stats);
+    sdfgen::make_level_set3(open_faces, moved_verts, origin, dx, grid_size, ny, nz, full, options);
+    ok = state.tri.size() == open_faces.size() && matches_regeneration(state, full, band, dx, 0.5f);
+    std::cout << (ok ? "✓" : "✗") << " Removed triangles match a full regeneration\n";
+    all_passed &= ok;
+
+    // Add them back and undo the move: the original field returns
+    std::vector<unsigned int> restored = changed;
+    restored.insert(restored.end(), removed.begin(), removed.end());
+    sdfgen::update_level_set3(faces, verts, restored, state, options, &stats);
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, full, options);
+    ok = state.tri.size() == faces.size() && matches_regeneration(state, full, band, dx, 0.5f);
+    std::cout << (ok ? "✓" : "✗") << " Added triangles and undone move match the original field\n";
+    all_passed &= ok;
+
+    // An empty edit writes nothing
+    Array3f before = state.phi;
+    sdfgen::update_level_set3(faces, verts, std::vector<unsigned int>(), state, options, &stats);
+    ok = stats.cells_updated == 0 &&
+         std::memcmp(before.a.data, state.phi.a.data, before.a.size() * sizeof(float)) == 0;
+    std::cout << (ok ? "✓" : "✗") << " Empty edit leaves the field untouched\n";
+    all_passed &= ok;
+
+    // GPU is not an update backend, and a state must come from make_level_set3
+    int rejected = 0;
+    try {
+        sdfgen::GenerationOptions gpu_options;
+        gpu_options.backend = sdfgen::HardwareBackend::GPU;
+        sdfgen::update_level_set3(faces, verts, changed, state, gpu_options);
+    } catch (const std::runtime_error&) {
+        ++rejected;
+    }
+    try {
+        sdfgen::LevelSetState empty;
+        sdfgen::update_level_set3(faces, verts, changed, empty, options);
+    } catch (const std::runtime_error&) {
+        ++rejected;
+    }
+    ok = rejected == 2;
+    std::cout << (ok ? "✓" : "✗") << " Explicit GPU backend and empty state are rejected\n";
+    all_passed &= ok;
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL INCREMENTAL UPDATE TESTS PASSED\n";
+    } else {
+        std::cout << "✗ INCREMENTAL UPDATE TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
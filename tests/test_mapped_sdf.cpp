@@ -0,0 +1,130 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the memory-mapped SDF reader
+// Validates that MappedSDF exposes the values written by write_sdf_binary() in either
+// layout without reading the file, that sample() reproduces node values and linear fields,
+// that gradient() returns the slope of the trilinear interpolant, and that malformed files
+// are rejected.
+
+#include "mapped_sdf.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+static float linear_field(const Vec3f& p) {
+    return 0.5f * p[0] - 0.25f * p[1] + 2.0f * p[2] + 1.0f;
+}
+
+static bool check_layout(sdfgen::SdfLayout layout, const char* name) {
+    std::cout << name << " layout\n";
+    const char* filename = "test_mapped_sdf.sdf";
+    const Vec3f origin(-1.0f, 0.5f, 2.0f);
+    const float dx = 0.25f;
+    const int ni = 13, nj = 9, nk = 11;
+    bool ok = true;
+
+    Array3f phi(ni, nj, nk);
+    for (int k = 0; k < nk; ++k)
+        for (int j = 0; j < nj; ++j)
+            for (int i = 0; i < ni; ++i)
+                phi(i, j, k) = linear_field(origin + dx * Vec3f((float)i, (float)j, (float)k));
+    write_sdf_binary(filename, phi, origin, dx, nullptr, layout);
+
+    sdfgen::MappedSDF opened;
+    if (!opened.open(filename)) {
+        std::cout << "  ✗ Failed to map the file\n";
+        std::remove(filename);
+        return false;
+    }
+    sdfgen::MappedSDF sdf(std::move(opened));
+    bool header = !opened.is_open() && sdf.is_open() && sdf.layout() == layout &&
+                  sdf.ni() == ni && sdf.nj() == nj && sdf.nk() == nk &&
+                  sdf.min_box() == origin && std::fabs(sdf.dx() - dx) < 1e-6f;
+    std::cout << "  " << (header ? "✓" : "✗") << " Header and layout recognized\n";
+    ok &= header;
+
+    bool values = true;
+    for (int k = 0; k < nk; ++k)
+        for (int j = 0; j < nj; ++j)
+            for (int i = 0; i < ni; ++i) values &= sdf.value(i, j, k) == phi(i, j, k);
+    std::cout << "  " << (values ? "✓" : "✗") << " value(i,j,k) matches the written grid\n";
+    ok &= values;
+
+    // Trilinear interpolation reproduces a linear field exactly (up to rounding), and its
+    // gradient is the field's slope; points outside clamp onto the box
+    const Vec3f points[] = {origin + Vec3f(0.3f, 0.7f, 1.1f), origin + Vec3f(2.9f, 1.95f, 2.45f),
+                            origin + Vec3f(1.0f, 1.0f, 1.0f)};
+    bool samples = true;
+    for (const Vec3f& p : points) {
+        samples &= std::fabs(sdf.sample(p) - linear_field(p)) < 1e-4f;
+        Vec3f g = sdf.gradient(p);
+        samples &= std::fabs(g[0] - 0.5f) < 1e-4f && std::fabs(g[1] + 0.25f) < 1e-4f && std::fabs(g[2] - 2.0f) < 1e-4f;
+    }
+    samples &= sdf.sample(origin - Vec3f(5.0f, 5.0f, 5.0f)) == phi(0, 0, 0);
+    samples &= sdf.sample(origin + Vec3f(50.0f, 50.0f, 50.0f)) == phi(ni - 1, nj - 1, nk - 1);
+    std::cout << "  " << (samples ? "✓" : "✗") << " sample() and gradient() on a linear field\n\n";
+    ok &= samples;
+
+    sdf.close();
+    std::remove(filename);
+    return ok;
+}
+
+static bool check_rejected() {
+    const char* filename = "test_mapped_sdf_bad.sdf";
+    bool ok = true;
+
+    Array3f phi(4, 4, 4, 1.0f);
+    write_sdf_binary(filename, phi, Vec3f(0, 0, 0), 1.0f);
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::app);
+        file.write("x", 1);
+    }
+    sdfgen::MappedSDF sdf;
+    std::cout << "  (expected errors follow)\n";
+    ok &= !sdf.open(filename) && !sdf.is_open();
+
+    {
+        std::ofstream file(filename, std::ios::binary);
+        int dims[3] = {0, 4, 4};
+        file.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+        float bounds[6] = {};
+        file.write(reinterpret_cast<const char*>(bounds), sizeof(bounds));
+    }
+    ok &= !sdf.open(filename);
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file.write("short", 5);
+    }
+    ok &= !sdf.open(filename);
+    ok &= !sdf.open("no_such_file.sdf");
+
+    std::cout << (ok ? "✓" : "✗") << " Wrong size, bad dimensions, short and missing files rejected\n\n";
+    std::remove(filename);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Memory-Mapped SDF Tests\n";
+    std::cout << "========================================\n\n";
+
+    bool all_passed = true;
+    all_passed &= check_layout(sdfgen::SdfLayout::COrder, "C-order");
+    all_passed &= check_layout(sdfgen::SdfLayout::Native, "Native");
+    all_passed &= check_rejected();
+
+    std::cout << "========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL MAPPED SDF TESTS PASSED\n";
+    } else {
+        std::cout << "✗ MAPPED SDF TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the parallel marching cubes extractor
+// Validates that every crossed grid edge yields exactly one vertex (the mesh is welded
+// across slab boundaries), that a sphere comes out closed and on the surface, that the
+// output does not depend on the thread count, and that degenerate grids give no triangles.
+// The GPU extractor must give the same surface (positions bit for bit, triangles in the same
+// order), also when run on the device-resident field of make_level_set3_mesh().
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "marching_cubes.h"
+#include "mesh_io.h"
+#include "mesh_repair.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+static const Vec3f centre(1.03f, 0.97f, 1.21f);
+static const float radius = 0.8f;
+
+static Array3f sphere_field(int ni, int nj, int nk, const Vec3f& origin, float dx) {
+    Array3f phi(ni, nj, nk);
+    for (int k = 0; k < nk; ++k)
+        for (int j = 0; j < nj; ++j)
+            for (int i = 0; i < ni; ++i)
+                phi(i, j, k) = dist(origin + dx * Vec3f((float)i, (float)j, (float)k), centre) - radius;
+    return phi;
+}
+
+// Number of grid edges whose end nodes are on opposite sides of the isolevel
+static size_t crossed_edges(const Array3f& phi, float isolevel) {
+    size_t count = 0;
+    for (int k = 0; k < phi.nk; ++k)
+        for (int j = 0; j < phi.nj; ++j)
+            for (int i = 0; i < phi.ni; ++i) {
+                bool in = phi(i, j, k) < isolevel;
+                if (i + 1 < phi.ni && in != (phi(i + 1, j, k) < isolevel)) ++count;
+                if (j + 1 < phi.nj && in != (phi(i, j + 1, k) < isolevel)) ++count;
+                if (k + 1 < phi.nk && in != (phi(i, j, k + 1) < isolevel)) ++count;
+            }
+    return count;
+}
+
+static bool check_sphere(int ni, int nj, int nk) {
+    const Vec3f origin(0.0f, 0.0f, 0.0f);
+    const float dx = 2.2f / (ni - 1);
+    Array3f phi = sphere_field(ni, nj, nk, origin, dx);
+    Vec3f spacing(dx, dx, dx);
+
+    std::vector<Vec3f> vertices;
+    std::vector<Vec3ui> triangles;
+    sdfgen::marching_cubes(phi, origin, spacing, 0.0f, vertices, triangles, 4);
+
+    bool welded = vertices.size() == crossed_edges(phi, 0.0f);
+    bool indices = true;
+    for (const Vec3ui& t : triangles)
+        indices &= t[0] < vertices.size() && t[1] < vertices.size() && t[2] < vertices.size();
+    meshio::MeshAnalysis analysis = meshio::analyze_mesh(vertices, triangles);
+
+    // Vertices interpolate a distance field, so they lie within a fraction of a cell of the sphere
+    float max_error = 0.0f;
+    for (const Vec3f& v : vertices) max_error = std::max(max_error, std::fabs(dist(v, centre) - radius));
+
+    // Same mesh for any thread count
+    std::vector<Vec3f> serial_vertices;
+    std::vector<Vec3ui> serial_triangles;
+    sdfgen::marching_cubes(phi, origin, spacing, 0.0f, serial_vertices, serial_triangles, 1);
+    bool same = serial_vertices == vertices && serial_triangles == triangles;
+
+    bool ok = welded && indices && analysis.is_watertight && max_error < 0.1f * dx && same && !triangles.empty();
+    std::cout << "  " << (ok ? "✓" : "✗") << " Sphere " << ni << "x" << nj << "x" << nk << ": "
+              << vertices.size() << " vertices, " << triangles.size() << " triangles"
+              << (welded ? "" : " [vertex count != crossed edges]")
+              << (analysis.is_watertight ? "" : " [not watertight]")
+              << (same ? "" : " [depends on thread count]")
+              << ", max error " << max_error / dx << " dx\n";
+    return ok;
+}
+
+static bool check_degenerate() {
+    std::vector<Vec3f> vertices;
+    std::vector<Vec3ui> triangles;
+    const Vec3f origin(0.0f, 0.0f, 0.0f), spacing(1.0f, 1.0f, 1.0f);
+
+    Array3f flat(8, 8, 1, -1.0f);
+    sdfgen::marching_cubes(flat, origin, spacing, 0.0f, vertices, triangles);
+    bool ok = vertices.empty() && triangles.empty();
+
+    Array3f outside(9, 9, 9, 1.0f);
+    sdfgen::marching_cubes(outside, origin, spacing, 0.0f, vertices, triangles);
+    ok &= vertices.empty() && triangles.empty();
+
+    // One cell layer: a plane between two node layers
+    Array3f layer(6, 5, 2);
+    for (int j = 0; j < 5; ++j)
+        for (int i = 0; i < 6; ++i) {
+            layer(i, j, 0) = -0.5f;
+            layer(i, j, 1) = 0.5f;
+        }
+    sdfgen::marching_cubes(layer, origin, spacing, 0.0f, vertices, triangles);
+    ok &= vertices.size() == 30 && triangles.size() == 2 * 5 * 4;
+    for (const Vec3f& v : vertices) ok &= std::fabs(v[2] - 0.5f) < 1e-6f;
+
+    std::cout << "  " << (ok ? "✓" : "✗") << " Flat, empty and single-layer grids\n";
+    return ok;
+}
+
+// Same triangles in the same order with bit-identical corner positions; vertex numbering may differ
+static bool same_surface(const std::vector<Vec3f>& va, const std::vector<Vec3ui>& ta,
+                         const std::vector<Vec3f>& vb, const std::vector<Vec3ui>& tb) {
+    if (va.size() != vb.size() || ta.size() != tb.size()) return false;
+    for (size_t t = 0; t < ta.size(); ++t)
+        for (int c = 0; c < 3; ++c)
+            if (std::memcmp(va[ta[t][c]].v, vb[tb[t][c]].v, sizeof(Vec3f)) != 0) return false;
+    return true;
+}
+
+static bool check_round_trip(sdfgen::HardwareBackend backend) {
+    const char* label = backend == sdfgen::HardwareBackend::GPU ? "GPU" : "CPU";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_obj("resources/test_x3y4z5_quads.obj", verts, faces, min_box, max_box)) {
+        std::cout << "  ✗ Failed to load test mesh\n";
+        return false;
+    }
+    int nx = 48, ny, nz;
+    float dx;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, nx, 2, dx, ny, nz, origin);
+    sdfgen::GenerationOptions options;
+    options.backend = backend;
+
+    // Generate + extract without the field, then with it
+    std::vector<Vec3f> vertices, kept_vertices;
+    std::vector<Vec3ui> triangles, kept_triangles;
+    Array3f phi;
+    sdfgen::make_level_set3_mesh(faces, verts, origin, dx, nx, ny, nz, 0.0f, vertices, triangles, options);
+    sdfgen::make_level_set3_mesh(faces, verts, origin, dx, nx, ny, nz, 0.0f, kept_vertices, kept_triangles,
+                                 options, &phi);
+    bool ok = vertices == kept_vertices && triangles == kept_triangles && phi.ni == nx;
+
+    // Extracting the returned field on either backend gives the same surface
+    const Vec3f spacing(dx, dx, dx);
+    std::vector<Vec3f> cpu_vertices, gpu_vertices;
+    std::vector<Vec3ui> cpu_triangles, gpu_triangles;
+    sdfgen::extract_isosurface(phi, origin, spacing, 0.0f, cpu_vertices, cpu_triangles, sdfgen::HardwareBackend::CPU);
+    sdfgen::extract_isosurface(phi, origin, spacing, 0.0f, gpu_vertices, gpu_triangles, backend);
+    ok &= same_surface(vertices, triangles, cpu_vertices, cpu_triangles) &&
+          same_surface(gpu_vertices, gpu_triangles, cpu_vertices, cpu_triangles);
+    ok &= vertices.size() == crossed_edges(phi, 0.0f) && meshio::analyze_mesh(vertices, triangles).is_watertight;
+
+    std::cout << "  " << (ok ? "✓ " : "✗ ") << label << " generate + extract: " << vertices.size() << " vertices, "
+              << triangles.size() << " triangles, matches the CPU extractor\n";
+    return ok;
+}
+
+static bool check_gpu_grids() {
+    // Partial last blocks and more than one level of block sums in the scans
+    bool ok = true;
+    const int sizes[3][3] = {{24, 23, 24}, {64, 61, 70}, {130, 127, 129}};
+    for (const int* n : sizes) {
+        const float dx = 2.2f / (n[0] - 1);
+        Array3f phi = sphere_field(n[0], n[1], n[2], Vec3f(0.0f, 0.0f, 0.0f), dx);
+        std::vector<Vec3f> cpu_vertices, gpu_vertices;
+        std::vector<Vec3ui> cpu_triangles, gpu_triangles;
+        const Vec3f spacing(dx, dx, dx);
+        sdfgen::extract_isosurface(phi, Vec3f(0.0f, 0.0f, 0.0f), spacing, 0.0f, cpu_vertices, cpu_triangles,
+                                   sdfgen::HardwareBackend::CPU);
+        sdfgen::extract_isosurface(phi, Vec3f(0.0f, 0.0f, 0.0f), spacing, 0.0f, gpu_vertices, gpu_triangles,
+                                   sdfgen::HardwareBackend::GPU);
+        ok &= same_surface(gpu_vertices, gpu_triangles, cpu_vertices, cpu_triangles);
+    }
+    Array3f outside(9, 9, 9, 1.0f);
+    std::vector<Vec3f> vertices;
+    std::vector<Vec3ui> triangles;
+    sdfgen::extract_isosurface(outside, Vec3f(0.0f, 0.0f, 0.0f), Vec3f(1.0f, 1.0f, 1.0f), 0.0f, vertices, triangles,
+                               sdfgen::HardwareBackend::GPU);
+    ok &= vertices.empty() && triangles.empty();
+    std::cout << "  " << (ok ? "✓" : "✗") << " GPU extraction matches the CPU on spheres up to 130^3\n";
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Marching Cubes Tests\n";
+    std::cout << "========================================\n\n";
+
+    bool all_passed = true;
+    // Three to nine slabs, with partial last slabs
+    all_passed &= check_sphere(24, 23, 24);
+    all_passed &= check_sphere(40, 37, 45);
+    all_passed &= check_sphere(64, 61, 70);
+    all_passed &= check_degenerate();
+    all_passed &= check_round_trip(sdfgen::HardwareBackend::CPU);
+
+    if (sdfgen::is_gpu_available()) {
+        all_passed &= check_gpu_grids();
+        all_passed &= check_round_trip(sdfgen::HardwareBackend::GPU);
+    } else {
+        std::cout << "  - GPU not available, skipping GPU extraction checks\n";
+    }
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL MARCHING CUBES TESTS PASSED\n";
+    } else {
+        std::cout << "✗ MARCHING CUBES TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the mesh writers (OBJ text, binary PLY, binary STL)
+// Validates that OBJ coordinates read back bit for bit through load_obj() and that the file
+// does not depend on the thread count, that the PLY header and binary payload hold the
+// mesh exactly, that binary STL corners read back through load_stl() with unit normals,
+// and that unsupported extensions and bad indices are rejected.
+
+#include "test_utils.h"
+#include "mesh_io.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Enough lines for more than one OBJ block, with coordinates of every magnitude and sign
+static void make_mesh(std::vector<Vec3f>& vertices, std::vector<Vec3ui>& triangles) {
+    test_utils::RandomFloats random(24680u);
+    auto next = [&random]() { return random.next_bits(); };
+    vertices.resize(300000);
+    for (Vec3f& v : vertices) {
+        for (int c = 0; c < 3; ++c) {
+            float mantissa = (float)(next() >> 8) * (1.0f / 16777216.0f) - 0.5f;
+            v[c] = std::ldexp(mantissa, (int)(next() % 40) - 20);
+        }
+    }
+    vertices[0] = Vec3f(0.0f, -0.0f, 1.0f);
+    vertices[1] = Vec3f(1e-38f, -3.4e38f, 0.1f);
+    triangles.resize(320000);
+    for (Vec3ui& t : triangles) {
+        t = Vec3ui(next() % vertices.size(), next() % vertices.size(), next() % vertices.size());
+    }
+}
+
+static bool check_obj(const std::vector<Vec3f>& vertices, const std::vector<Vec3ui>& triangles) {
+    bool ok = meshio::save_obj("test_output_1.obj", vertices, triangles, "line one\nline two", 1) &&
+              meshio::save_obj("test_output_4.obj", vertices, triangles, "line one\nline two", 4);
+    ok &= test_utils::read_file_bytes("test_output_1.obj") == test_utils::read_file_bytes("test_output_4.obj");
+
+    std::vector<Vec3f> back_vertices;
+    std::vector<Vec3ui> back_triangles;
+    Vec3f min_box, max_box;
+    ok &= meshio::load_obj("test_output_4.obj", back_vertices, back_triangles, min_box, max_box);
+    ok &= back_vertices.size() == vertices.size() && back_triangles == triangles &&
+          std::memcmp(back_vertices.data(), vertices.data(), vertices.size() * sizeof(Vec3f)) == 0;
+
+    std::cout << "  " << (ok ? "✓" : "✗") << " OBJ: bit-exact round trip, identical for 1 and 4 threads\n";
+    std::remove("test_output_1.obj");
+    std::remove("test_output_4.obj");
+    return ok;
+}
+
+static bool check_ply(const std::vector<Vec3f>& vertices, const std::vector<Vec3ui>& triangles) {
+    bool ok = meshio::save_ply("test_output.ply", vertices, triangles, "written by test_mesh_output");
+    std::vector<char> bytes = test_utils::read_file_bytes("test_output.ply");
+    std::string text(bytes.begin(), bytes.end());
+    size_t end = text.find("end_header\n");
+    ok &= text.compare(0, 36, "ply\nformat binary_little_endian 1.0\n") == 0 && end != std::string::npos;
+
+    std::istringstream header(text.substr(0, end));
+    std::string line;
+    size_t num_vertices = 0, num_faces = 0;
+    while (std::getline(header, line)) {
+        std::sscanf(line.c_str(), "element vertex %zu", &num_vertices);
+        std::sscanf(line.c_str(), "element face %zu", &num_faces);
+    }
+    ok &= num_vertices == vertices.size() && num_faces == triangles.size();
+
+    const char* payload = bytes.data() + end + 11;
+    ok &= bytes.size() == end + 11 + vertices.size() * 12 + triangles.size() * 13;
+    ok &= ok && std::memcmp(payload, vertices.data(), vertices.size() * 12) == 0;
+    payload += vertices.size() * 12;
+    for (size_t t = 0; ok && t < triangles.size(); ++t, payload += 13) {
+        ok &= payload[0] == 3 && std::memcmp(payload + 1, &triangles[t][0], 12) == 0;
+    }
+
+    std::cout << "  " << (ok ? "✓" : "✗") << " PLY: header and binary payload hold the mesh exactly\n";
+    std::remove("test_output.ply");
+    return ok;
+}
+
+static bool check_stl(const std::vector<Vec3f>& vertices, const std::vector<Vec3ui>& triangles) {
+    // A header starting with "solid" would make readers guess ASCII
+    bool ok = meshio::save_mesh("test_output.STL", vertices, triangles, "solid looking comment", 4);
+    std::vector<char> bytes = test_utils::read_file_bytes("test_output.STL");
+    ok &= bytes.size() == 84 + 50 * triangles.size() && std::strncmp(bytes.data(), "solid", 5) != 0;
+
+    std::vector<Vec3f> back_vertices;
+    std::vector<Vec3ui> back_triangles;
+    Vec3f min_box, max_box;
+    ok &= meshio::load_stl("test_output.STL", back_vertices, back_triangles, min_box, max_box);
+    ok &= back_triangles.size() == triangles.size();
+    for (size_t t = 0; ok && t < triangles.size(); ++t)
+        for (int c = 0; c < 3; ++c)
+            ok &= back_vertices[back_triangles[t][c]] == vertices[triangles[t][c]];
+
+    // Normals: unit length, or zero for degenerate triangles
+    for (size_t t = 0; ok && t < 1000; ++t) {
+        Vec3f normal;
+        std::memcpy(&normal[0], bytes.data() + 84 + 50 * t, sizeof(Vec3f));
+        float length = mag(normal);
+        ok &= std::fabs(length - 1.0f) < 1e-5f || length == 0.0f;
+    }
+
+    std::cout << "  " << (ok ? "✓" : "✗") << " STL: corners read back through load_stl(), unit normals\n";
+    std::remove("test_output.STL");
+    return ok;
+}
+
+static bool check_rejected(const std::vector<Vec3f>& vertices) {
+    std::cout << "  (expected errors follow)\n";
+    std::vector<Vec3ui> bad(1, Vec3ui(0, 1, (unsigned int)vertices.size()));
+    bool ok = !meshio::save_mesh("test_output.off", vertices, bad) &&
+              !meshio::save_stl("test_output_bad.stl", vertices, bad) &&
+              !meshio::save_obj("no_such_directory/test_output.obj", vertices, bad);
+    std::cout << "  " << (ok ? "✓" : "✗") << " Unsupported extension, bad index and unwritable path rejected\n";
+    std::remove("test_output_bad.stl");
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Mesh Output Tests\n";
+    std::cout << "========================================\n\n";
+
+    std::vector<Vec3f> vertices;
+    std::vector<Vec3ui> triangles;
+    make_mesh(vertices, triangles);
+
+    bool all_passed = true;
+    all_passed &= check_obj(vertices, triangles);
+    all_passed &= check_ply(vertices, triangles);
+    all_passed &= check_stl(vertices, triangles);
+    all_passed &= check_rejected(vertices);
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL MESH OUTPUT TESTS PASSED\n";
+    } else {
+        std::cout << "✗ MESH OUTPUT TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
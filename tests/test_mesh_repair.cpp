@@ -203,6 +203,54 @@ int main() {
         FAIL("welded mesh should be watertight")
     }
 
+    TEST("near duplicates join the first kept vertex within tolerance")
+    vertices = {Vec3f(0.5f, 0.5f, 0.5f), Vec3f(0.5f + 0.6e-5f, 0.5f, 0.5f), Vec3f(0.5f + 1.2e-5f, 0.5f, 0.5f),
+                Vec3f(0.5f + 1.2e-5f, 0.5f, 0.5f), Vec3f(0.5f, 0.5f - 0.7e-5f, 0.5f), Vec3f(0.5f, 0.6f, 0.5f)};
+    faces = {Vec3ui(0, 2, 5), Vec3ui(1, 3, 5), Vec3ui(0, 1, 4)};
+    welded = meshio::weld_vertices(vertices, faces, 1e-5f);
+    if (welded == 3 && vertices.size() == 3 && vertices[0] == Vec3f(0.5f, 0.5f, 0.5f) &&
+        vertices[1] == Vec3f(0.5f + 1.2e-5f, 0.5f, 0.5f) && faces.size() == 2 &&
+        faces[0] == Vec3ui(0, 1, 2) && faces[1] == Vec3ui(0, 1, 2)) {
+        PASS()
+    } else {
+        FAIL("expected 3 kept vertices and 2 faces, got " + std::to_string(vertices.size()) + " / " +
+             std::to_string(faces.size()))
+    }
+
+    TEST("large jittered STL-style grid welds identically on 1 and 4 threads")
+    {
+        const int n = 300;
+        std::vector<Vec3f> grid_vertices;
+        std::vector<Vec3ui> grid_faces;
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < n; ++i) {
+                const int corners[2][3][2] = {{{0, 0}, {1, 0}, {1, 1}}, {{0, 0}, {1, 1}, {0, 1}}};
+                for (int t = 0; t < 2; ++t) {
+                    unsigned int base = (unsigned int)grid_vertices.size();
+                    for (int c = 0; c < 3; ++c) {
+                        // Copies of a grid point differ by up to a quarter of the tolerance
+                        float jitter = (float)((i + j + 3 * t + c) % 5) * 0.5e-6f;
+                        grid_vertices.push_back(Vec3f((i + corners[t][c][0]) * 1e-3f + jitter,
+                                                      (j + corners[t][c][1]) * 1e-3f,
+                                                      jitter));
+                    }
+                    grid_faces.push_back(Vec3ui(base, base + 1, base + 2));
+                }
+            }
+        }
+        std::vector<Vec3f> v1 = grid_vertices, v4 = grid_vertices;
+        std::vector<Vec3ui> f1 = grid_faces, f4 = grid_faces;
+        int w1 = meshio::weld_vertices(v1, f1, 1e-5f, 1);
+        int w4 = meshio::weld_vertices(v4, f4, 1e-5f, 4);
+        if (v1.size() == (size_t)(n + 1) * (n + 1) && f1.size() == grid_faces.size() && w1 == w4 &&
+            v1 == v4 && f1 == f4) {
+            PASS()
+        } else {
+            FAIL("expected " + std::to_string((n + 1) * (n + 1)) + " vertices, got " + std::to_string(v1.size()) +
+                 " / " + std::to_string(v4.size()))
+        }
+    }
+
     // =========================================================================
     // Test 4: Mesh repair
     // =========================================================================
@@ -235,9 +283,61 @@ int main() {
     }
 
     // =========================================================================
-    // Test 5: Edge cases
+    // Test 5: Shared topology
+    // =========================================================================
+    std::cout << "\nTest Group 5: Shared Topology\n";
+
+    TEST("topology of a holed grid with doubled triangles")
+    {
+        // 200x200 quad grid without 10 separated quads, plus a corner triangle listed twice:
+        // that closes one outer boundary edge and makes its two other edges non-manifold
+        const int n = 200;
+        vertices.clear();
+        faces.clear();
+        for (int j = 0; j <= n; ++j) {
+            for (int i = 0; i <= n; ++i) vertices.push_back(Vec3f((float)i, (float)j, 0.0f));
+        }
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < n; ++i) {
+                if (j == 100 && i % 20 == 10) continue;
+                unsigned int a = j * (n + 1) + i;
+                faces.push_back(Vec3ui(a, a + 1, a + n + 2));
+                faces.push_back(Vec3ui(a, a + n + 2, a + n + 1));
+            }
+        }
+        faces.push_back(faces[0]);
+        meshio::MeshTopology topology = meshio::analyze_mesh_topology(vertices, faces, 1);
+        meshio::MeshTopology threaded = meshio::analyze_mesh_topology(vertices, faces, 4);
+        const int expected_edges = 2 * n * (n + 1) + n * n - 10;
+        if (topology.summary.total_edges == expected_edges && topology.summary.boundary_edges == 4 * n + 39 &&
+            topology.summary.non_manifold_edges == 2 && topology.summary.num_holes == 11 &&
+            threaded.boundary_loops == topology.boundary_loops &&
+            threaded.summary.boundary_edges == topology.summary.boundary_edges) {
+            PASS()
+        } else {
+            FAIL("got " + std::to_string(topology.summary.total_edges) + " edges, " +
+                 std::to_string(topology.summary.boundary_edges) + " boundary, " +
+                 std::to_string(topology.summary.num_holes) + " holes")
+        }
+    }
+
+    TEST("repair reuses a precomputed topology")
+    create_cube_with_hole(vertices, faces);
+    {
+        meshio::MeshTopology topology = meshio::analyze_mesh_topology(vertices, faces);
+        holes_filled = meshio::repair_mesh(vertices, faces, topology);
+        analysis = meshio::analyze_mesh(vertices, faces);
+        if (holes_filled == 1 && analysis.is_watertight) {
+            PASS()
+        } else {
+            FAIL("expected 1 hole filled and a watertight result")
+        }
+    }
+
+    // =========================================================================
+    // Test 6: Edge cases
     // =========================================================================
-    std::cout << "\nTest Group 5: Edge Cases\n";
+    std::cout << "\nTest Group 6: Edge Cases\n";
 
     TEST("empty mesh analysis")
     vertices.clear();
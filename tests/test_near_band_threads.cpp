@@ -0,0 +1,92 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the multi-threaded near-band pass
+// Validates that the exact-distance and intersection-count phase produces
+// bit-identical output for any thread count. The exact band is made wide
+// enough to cover the whole grid, so the sweeps cannot change any value and
+// the comparison isolates the near-band pass.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "mesh_io.h"
+#include <iostream>
+#include <vector>
+
+static bool check_thread_counts(const char* label,
+                                const std::vector<Vec3ui>& faces, const std::vector<Vec3f>& verts,
+                                const Vec3f& origin, float dx, int nx, int ny, int nz) {
+    std::cout << label << " (" << faces.size() << " triangles, "
+              << nx << "x" << ny << "x" << nz << ")\n";
+
+    int band = nx + ny + nz; // whole grid is inside the exact band
+    Array3f reference;
+    sdfgen::make_level_set3(faces, verts, origin, dx, nx, ny, nz,
+                           reference, band, sdfgen::HardwareBackend::CPU, 1);
+
+    const int thread_counts[] = {2, 3, 4, 8, 16, 100};
+    bool ok = true;
+    for (int threads : thread_counts) {
+        Array3f phi;
+        sdfgen::make_level_set3(faces, verts, origin, dx, nx, ny, nz,
+                               phi, band, sdfgen::HardwareBackend::CPU, threads);
+        if (test_utils::bitwise_equal(reference, phi)) {
+            std::cout << "  ✓ " << threads << " threads: bit-identical to 1 thread\n";
+        } else {
+            std::cout << "  ✗ " << threads << " threads: differs from 1 thread\n";
+            ok = false;
+        }
+    }
+    std::cout << "\n";
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Near-Band Thread Determinism Tests\n";
+    std::cout << "========================================\n\n";
+
+    bool all_passed = true;
+
+    // Closed test mesh
+    {
+        const char* mesh_file = "resources/test_x3y4z5_quads.obj";
+        std::vector<Vec3f> verts;
+        std::vector<Vec3ui> faces;
+        Vec3f min_box, max_box;
+        if (!meshio::load_obj(mesh_file, verts, faces, min_box, max_box)) {
+            std::cerr << "ERROR: Failed to load test mesh\n";
+            return 1;
+        }
+
+        int grid_size = 24;
+        float dx;
+        int ny, nz;
+        Vec3f origin;
+        test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+        all_passed &= check_thread_counts("Closed box mesh", faces, verts, origin, dx, grid_size, ny, nz);
+    }
+
+    // Triangle soup with many overlapping triangles, partly outside the grid
+    {
+        std::vector<Vec3f> verts;
+        std::vector<Vec3ui> faces;
+        // Deterministic triangle soup spread through the grid so that many triangles
+        // straddle tile boundaries
+        test_utils::make_triangle_soup(400, Vec3f(-1.0f, -1.0f, -1.0f), Vec3f(9.0f, 9.0f, 9.0f), 2.0f, 12345u,
+                                       verts, faces);
+        all_passed &= check_thread_counts("Triangle soup", faces, verts,
+                                          Vec3f(0.0f, 0.0f, 0.0f), 0.25f, 32, 32, 32);
+    }
+
+    std::cout << "========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL NEAR-BAND THREAD TESTS PASSED\n";
+    } else {
+        std::cout << "✗ NEAR-BAND THREAD TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the chunked OBJ parser
+// Validates that a file spanning several parse chunks gives the same vertices (correctly
+// rounded, like strtof), faces and bounds as a sequential reading, that negative indices
+// resolve across chunk boundaries, and that faces referencing missing vertices are rejected.
+
+#include "mesh_io.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Coordinate a of vertex v in the synthetic file, as written
+static std::string synthetic_coordinate(int v, int a) {
+    static const char* formats[] = {"%.7g", "%.3f", "%.4e", "%d"};
+    double value = (((int64_t)v * 7919 + a * 104729) % 200003 - 100001) * 0.0137;
+    char text[32];
+    int format = (v + a) % 4;
+    if (format == 3) std::snprintf(text, sizeof(text), formats[3], (int)value);
+    else std::snprintf(text, sizeof(text), formats[format], value);
+    return text;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "OBJ Parser Tests\n";
+    std::cout << "========================================\n\n";
+
+    bool all_passed = true;
+    const char* obj_file = "test_obj_parser_chunks.obj";
+
+    // Several MB of quads written after every fourth vertex with relative indices and mixed
+    // corner forms, CRLF line endings, comments and attribute lines the loader ignores
+    const int num_quads = 120000;
+    {
+        std::ofstream file(obj_file, std::ios::binary);
+        file << "# synthetic OBJ\r\nmtllib none.mtl\nvt 0.5 0.5\nvn 0 0 1\n";
+        for (int q = 0; q < num_quads; ++q) {
+            for (int c = 0; c < 4; ++c) {
+                int v = 4 * q + c;
+                file << "v " << synthetic_coordinate(v, 0) << ' ' << synthetic_coordinate(v, 1) << '\t'
+                     << synthetic_coordinate(v, 2) << (v % 3 ? "\n" : "\r\n");
+            }
+            if (q % 2) file << "f -4/1 -3/1/1 -2//1 -1\n";
+            else file << "f " << 4 * q + 1 << ' ' << 4 * q + 2 << ' ' << 4 * q + 3 << ' ' << 4 * q + 4 << "\r\n";
+            if (q % 1000 == 0) file << "# group " << q << "\ng part" << q << "\n";
+        }
+    }
+
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    bool ok = meshio::load_obj(obj_file, verts, faces, min_box, max_box) &&
+              verts.size() == 4 * (size_t)num_quads && faces.size() == 2 * (size_t)num_quads;
+    int mismatches = 0;
+    Vec3f expected_min(0, 0, 0), expected_max(0, 0, 0);
+    for (int v = 0; ok && v < 4 * num_quads; ++v) {
+        for (int a = 0; a < 3; ++a) {
+            float expected = std::strtof(synthetic_coordinate(v, a).c_str(), nullptr);
+            if (verts[v][a] != expected) ++mismatches;
+            expected_min[a] = v ? std::min(expected_min[a], expected) : expected;
+            expected_max[a] = v ? std::max(expected_max[a], expected) : expected;
+        }
+    }
+    ok = ok && mismatches == 0;
+    std::cout << (ok ? "✓" : "✗") << " " << verts.size() << " vertices match strtof (" << mismatches
+              << " mismatches)\n";
+    all_passed &= ok;
+
+    mismatches = 0;
+    for (int q = 0; q < num_quads && faces.size() == 2 * (size_t)num_quads; ++q) {
+        unsigned int b = 4 * q;
+        if (faces[2 * q] != Vec3ui(b, b + 1, b + 2) || faces[2 * q + 1] != Vec3ui(b, b + 2, b + 3)) ++mismatches;
+    }
+    ok = faces.size() == 2 * (size_t)num_quads && mismatches == 0;
+    std::cout << (ok ? "✓" : "✗") << " " << faces.size() << " fan-triangulated faces, relative indices resolved ("
+              << mismatches << " mismatches)\n";
+    all_passed &= ok;
+
+    ok = min_box == expected_min && max_box == expected_max;
+    std::cout << (ok ? "✓" : "✗") << " Bounds (" << min_box << ") to (" << max_box << ")\n";
+    all_passed &= ok;
+
+    // Indices past the vertices defined, absolute or relative, fail the load
+    {
+        std::ofstream file(obj_file, std::ios::binary);
+        file << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\nf 1 2 4\n";
+    }
+    ok = !meshio::load_obj(obj_file, verts, faces, min_box, max_box);
+    {
+        std::ofstream file(obj_file, std::ios::binary);
+        file << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -1 -2 -4\n";
+    }
+    ok = ok && !meshio::load_obj(obj_file, verts, faces, min_box, max_box);
+    std::cout << (ok ? "✓" : "✗") << " Out-of-range absolute and relative indices rejected\n";
+    all_passed &= ok;
+
+    // The repository quad mesh triangulates to the same faces as its triangulated export
+    std::vector<Vec3f> quad_verts, tri_verts;
+    std::vector<Vec3ui> quad_faces, tri_faces;
+    ok = meshio::load_obj("resources/test_x3y4z5_quads.obj", quad_verts, quad_faces, min_box, max_box) &&
+         meshio::load_obj("resources/test_x3y4z5_triangulated.obj", tri_verts, tri_faces, min_box, max_box) &&
+         quad_verts == tri_verts && quad_faces.size() == tri_faces.size();
+    std::cout << (ok ? "✓" : "✗") << " Quad and triangulated resource meshes: " << quad_faces.size() << " / "
+              << tri_faces.size() << " faces\n";
+    all_passed &= ok;
+
+    std::remove(obj_file);
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL OBJ PARSER TESTS PASSED\n";
+    } else {
+        std::cout << "✗ OBJ PARSER TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for adaptive octree generation
+// Validates that make_octree_level_set3() reproduces the exact dense field inside the band,
+// gets the inside/outside sign right everywhere, grows its leaf count with the surface rather
+// than the volume, and survives a write_octree_sdf()/read_octree_sdf() round trip.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "sdf_io.h"
+#include "mesh_io.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Adaptive Octree Tests\n";
+    std::cout << "========================================\n\n";
+
+    const char* mesh_file = "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 48;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    std::cout << "\n";
+
+    bool all_passed = true;
+
+    const int band = 2;
+    sdfgen::GenerationOptions options;
+    options.backend = sdfgen::HardwareBackend::CPU;
+    options.exact_band = band;
+    sdfgen::OctreeLevelSet tree;
+    sdfgen::make_octree_level_set3(faces, verts, origin, dx, grid_size, ny, nz, tree, options);
+
+    sdfgen::GenerationOptions exact_options = options;
+    exact_options.distance_mode = sdfgen::DistanceMode::Exact;
+    Array3f exact;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, exact, exact_options);
+
+    // Inside the band the leaves are at dx and their corners are the exact grid values
+    int band_nodes = 0, band_errors = 0, sign_errors = 0;
+    for (int k = 0; k < nz; ++k) {
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < grid_size; ++i) {
+                float expected = exact(i, j, k);
+                float value = tree.sample(Vec3f(i * dx + origin[0], j * dx + origin[1], k * dx + origin[2]));
+                if (std::fabs(expected) < band * dx) {
+                    ++band_nodes;
+                    if (std::fabs(value - expected) > 1e-5f * dx * grid_size) ++band_errors;
+                }
+                if (std::fabs(expected) > 1e-4f * dx && (value < 0) != (expected < 0)) ++sign_errors;
+            }
+        }
+    }
+    bool ok = band_nodes > 0 && band_errors == 0;
+    std::cout << (ok ? "✓" : "✗") << " " << band_nodes << " band nodes match the exact dense field ("
+              << band_errors << " mismatches)\n";
+    all_passed &= ok;
+    ok = sign_errors == 0;
+    std::cout << (ok ? "✓" : "✗") << " Signs match the dense field at every node (" << sign_errors << " mismatches)\n";
+    all_passed &= ok;
+
+    // Coarse far field: leaves follow the surface, so doubling the resolution roughly
+    // quadruples them (a dense grid grows 8x), and the finest level is only reached near it
+    size_t leaves[2];
+    size_t cells = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        int fine_nx = pass == 0 ? 96 : 192, fine_ny, fine_nz;
+        float fine_dx;
+        Vec3f fine_origin;
+        test_utils::calculate_grid_parameters(min_box, max_box, fine_nx, 2, fine_dx, fine_ny, fine_nz, fine_origin);
+        sdfgen::GenerationOptions fine_options = options;
+        fine_options.exact_band = 1;
+        sdfgen::OctreeLevelSet fine;
+        sdfgen::make_octree_level_set3(faces, verts, fine_origin, fine_dx, fine_nx, fine_ny, fine_nz, fine, fine_options);
+        leaves[pass] = fine.leaf_count();
+        cells = (size_t)fine_nx * fine_ny * fine_nz;
+        ok = fine.depth() == fine.levels && leaves[pass] < cells / 4;
+        std::cout << (ok ? "✓" : "✗") << " " << fine_nx << "x" << fine_ny << "x" << fine_nz << ": "
+                  << fine.nodes.size() << " nodes, " << leaves[pass] << " leaves (levels " << fine.levels << ")\n";
+        all_passed &= ok;
+    }
+    ok = leaves[1] < 5 * leaves[0];
+    std::cout << (ok ? "✓" : "✗") << " Leaves grow " << (float)leaves[1] / leaves[0]
+              << "x when the resolution doubles (dense: 8x)\n";
+    all_passed &= ok;
+
+    // Level of detail: the root alone interpolates its corners; full depth equals the leaves
+    Vec3f probe = (min_box + max_box) * 0.5f;
+    ok = tree.sample(probe, tree.levels) == tree.sample(probe) && std::isfinite(tree.sample(probe, 0)) &&
+         tree.sample(probe) < 0;
+    std::cout << (ok ? "✓" : "✗") << " Level-of-detail queries\n";
+    all_passed &= ok;
+
+    // Resampling onto a regular grid
+    Array3f resampled;
+    tree.resample(resampled, origin, dx, grid_size, ny, nz);
+    ok = resampled.ni == grid_size && resampled.nj == ny && resampled.nk == nz &&
+         resampled(grid_size / 2, ny / 2, nz / 2) == tree.sample(origin + dx * Vec3f((float)(grid_size / 2), (float)(ny / 2), (float)(nz / 2)));
+    std::cout << (ok ? "✓" : "✗") << " resample() exports a regular grid\n";
+    all_passed &= ok;
+
+    // File round trip
+    const char* octree_file = "test_octree_roundtrip.osdf";
+    sdfgen::OctreeLevelSet loaded;
+    ok = write_octree_sdf(octree_file, tree) && read_octree_sdf(octree_file, loaded) &&
+         loaded.nodes.size() == tree.nodes.size() && loaded.levels == tree.levels &&
+         loaded.origin == tree.origin && loaded.dx == tree.dx &&
+         std::memcmp(loaded.nodes.data(), tree.nodes.data(), tree.memory_bytes()) == 0;
+    std::remove(octree_file);
+    std::cout << (ok ? "✓" : "✗") << " write_octree_sdf/read_octree_sdf round trip\n";
+    all_passed &= ok;
+
+    // GPU is not an octree backend
+    ok = false;
+    try {
+        sdfgen::GenerationOptions gpu_options;
+        gpu_options.backend = sdfgen::HardwareBackend::GPU;
+        sdfgen::OctreeLevelSet unused;
+        sdfgen::make_octree_level_set3(faces, verts, origin, dx, grid_size, ny, nz, unused, gpu_options);
+    } catch (const std::runtime_error&) {
+        ok = true;
+    }
+    std::cout << (ok ? "✓" : "✗") << " Explicit GPU backend is rejected\n";
+    all_passed &= ok;
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL ADAPTIVE OCTREE TESTS PASSED\n";
+    } else {
+        std::cout << "✗ ADAPTIVE OCTREE TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Library Test: Point queries without a grid
+// Validates that query_points() reproduces DistanceMode::Exact grids at the grid nodes (signs
+// off the surface) for every sign mode, that scattered points get the brute-force nearest
+// distance and triangle with barycentric weights of the nearest point, that thread counts and
+// repeated batches on one context agree, and that the GPU kernel matches the CPU. Reports
+// queries per second.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "triangle_distance.h"
+#include "mesh_io.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+static test_utils::RandomFloats g_random(97531u);
+
+// Points spread over the mesh bounds plus a margin, with every fourth one on a triangle
+static std::vector<Vec3f> scattered_points(const std::vector<Vec3ui>& faces, const std::vector<Vec3f>& verts,
+                                           const Vec3f& lo, const Vec3f& hi, size_t count) {
+    std::vector<Vec3f> points(count);
+    for (size_t n = 0; n < count; ++n) {
+        if (n % 4 == 3) {
+            const Vec3ui& t = faces[n % faces.size()];
+            float a = g_random.next(), b = g_random.next() * (1.0f - a);
+            points[n] = a * verts[t[0]] + b * verts[t[1]] + (1.0f - a - b) * verts[t[2]];
+        } else {
+            for (int axis = 0; axis < 3; ++axis) {
+                points[n][axis] = lo[axis] - 0.5f + g_random.next() * (hi[axis] - lo[axis] + 1.0f);
+            }
+        }
+    }
+    return points;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Point Query Tests\n";
+    std::cout << "========================================\n\n";
+
+    const char* mesh_file = argc > 1 ? argv[1] : "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 29;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    std::cout << "  Grid: " << grid_size << "x" << ny << "x" << nz << "\n\n";
+
+    bool all_passed = true;
+    sdfgen::GenerationContext context(faces, verts);
+    sdfgen::GenerationOptions options;
+    options.backend = sdfgen::HardwareBackend::CPU;
+    options.num_threads = 4;
+
+    // Grid nodes as points: the exact-distance grid node for node, in every sign mode. Nodes on
+    // the surface (|phi| of a rounding error) may take either sign.
+    std::vector<Vec3f> nodes;
+    for (int k = 0; k < nz; ++k)
+        for (int j = 0; j < ny; ++j)
+            for (int i = 0; i < grid_size; ++i)
+                nodes.push_back(Vec3f(i * dx + origin[0], j * dx + origin[1], k * dx + origin[2]));
+    const sdfgen::SignMode modes[3] = {sdfgen::SignMode::Parity, sdfgen::SignMode::RayVote,
+                                       sdfgen::SignMode::WindingNumber};
+    const char* mode_names[3] = {"parity", "ray vote", "winding number"};
+    for (int m = 0; m < 3; ++m) {
+        options.sign_mode = modes[m];
+        options.distance_mode = sdfgen::DistanceMode::Exact;
+        Array3f exact;
+        sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, exact, options);
+        options.distance_mode = sdfgen::DistanceMode::Sweep;
+        std::vector<float> distance(nodes.size());
+        sdfgen::GenerationStats stats;
+        sdfgen::query_points(context, nodes.data(), nodes.size(), distance.data(), options, &stats);
+        bool ok = true;
+        int on_surface = 0;
+        for (size_t n = 0; n < nodes.size(); ++n) {
+            ok &= std::fabs(distance[n]) == std::fabs(exact.a[n]);
+            if (std::fabs(exact.a[n]) > 1e-5f) {
+                ok &= distance[n] == exact.a[n];
+            } else {
+                ++on_surface;
+            }
+        }
+        // the BVH prunes: far fewer distance evaluations than points x triangles
+        ok &= on_surface < (int)nodes.size() / 10 && stats.backend_used == sdfgen::HardwareBackend::CPU &&
+              stats.distance_evaluations > 0 &&
+              stats.distance_evaluations < (long long)(nodes.size() * faces.size() / 2) && stats.host_bytes > 0;
+        std::cout << (ok ? "✓" : "✗") << " Grid nodes, " << mode_names[m]
+                  << " signs: distances bit-identical to the exact-distance grid, signs off the surface ("
+                  << on_surface << " surface nodes)\n";
+        all_passed &= ok;
+    }
+    options.sign_mode = sdfgen::SignMode::Parity;
+
+    // Scattered points against a brute-force minimum over every triangle
+    const size_t count = 5000;
+    std::vector<Vec3f> points = scattered_points(faces, verts, min_box, max_box, count);
+    std::vector<float> distance(count);
+    std::vector<int> closest(count);
+    std::vector<Vec3f> weights(count);
+    sdfgen::query_points(context, points.data(), count, distance.data(), options, nullptr, closest.data(),
+                         weights.data());
+    bool ok = true;
+    float max_gap = 0.0f;
+    for (size_t n = 0; n < count; ++n) {
+        float best = std::numeric_limits<float>::infinity();
+        int best_tri = -1;
+        for (size_t t = 0; t < faces.size(); ++t) {
+            float d = point_triangle_distance(points[n], verts[faces[t][0]], verts[faces[t][1]], verts[faces[t][2]]);
+            if (d < best) {
+                best = d;
+                best_tri = (int)t;
+            }
+        }
+        ok &= std::fabs(distance[n]) == best && closest[n] == best_tri;
+        // the weights name the nearest point: non-negative, summing to one, at the distance found
+        const Vec3f& w = weights[n];
+        const Vec3ui& t = faces[best_tri];
+        Vec3f nearest = w[0] * verts[t[0]] + w[1] * verts[t[1]] + w[2] * verts[t[2]];
+        ok &= w[0] >= 0 && w[1] >= 0 && w[2] >= 0 && std::fabs(w[0] + w[1] + w[2] - 1.0f) < 1e-5f;
+        max_gap = std::max(max_gap, std::fabs(dist(points[n], nearest) - best));
+    }
+    ok &= max_gap < 1e-5f;
+    std::cout << (ok ? "✓" : "✗") << " " << count << " scattered points: brute-force distances and triangles, "
+              << "barycentric nearest points within " << max_gap << "\n";
+    all_passed &= ok;
+
+    // One thread and 4 threads, and a second batch on the same context
+    sdfgen::GenerationOptions single = options;
+    single.num_threads = 1;
+    std::vector<float> single_distance(count);
+    std::vector<int> single_closest(count);
+    sdfgen::query_points(context, points.data(), count, single_distance.data(), single, nullptr,
+                         single_closest.data());
+    ok = single_distance == distance && single_closest == closest;
+    std::cout << (ok ? "✓" : "✗") << " 1 and 4 threads identical\n";
+    all_passed &= ok;
+
+    // Without a mesh every point is infinitely far and has no triangle
+    sdfgen::GenerationContext empty;
+    sdfgen::query_points(empty, points.data(), 3, distance.data(), options, nullptr, closest.data());
+    ok = std::isinf(distance[0]) && distance[0] > 0 && closest[2] == -1;
+    std::cout << (ok ? "✓" : "✗") << " Empty mesh: +infinity, no triangle\n";
+    all_passed &= ok;
+
+    // Throughput on a larger batch
+    const size_t big = 200000;
+    points = scattered_points(faces, verts, min_box, max_box, big);
+    distance.assign(big, 0.0f);
+    options.num_threads = 0;
+    auto start = std::chrono::steady_clock::now();
+    sdfgen::query_points(context, points.data(), big, distance.data(), options);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  CPU: " << big / seconds * 1e-6 << " million queries/s\n";
+
+    if (sdfgen::is_gpu_available()) {
+        sdfgen::GenerationOptions gpu_options = options;
+        gpu_options.backend = sdfgen::HardwareBackend::GPU;
+        for (int m = 0; m < 3; ++m) {
+            options.sign_mode = gpu_options.sign_mode = modes[m];
+            std::vector<float> cpu_distance(big), gpu_distance(big);
+            std::vector<Vec3f> cpu_weights(big), gpu_weights(big);
+            sdfgen::query_points(context, points.data(), big, cpu_distance.data(), options, nullptr, nullptr,
+                                 cpu_weights.data());
+            sdfgen::GenerationStats stats;
+            start = std::chrono::steady_clock::now();
+            sdfgen::query_points(context, points.data(), big, gpu_distance.data(), gpu_options, &stats, nullptr,
+                                 gpu_weights.data());
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            ok = stats.backend_used == sdfgen::HardwareBackend::GPU;
+            int sign_errors = 0;
+            for (size_t n = 0; n < big; ++n) {
+                float a = cpu_distance[n], b = gpu_distance[n];
+                ok &= std::fabs(std::fabs(a) - std::fabs(b)) <= 1e-5f * (1.0f + std::fabs(a));
+                if (std::fabs(a) > 1e-4f && (a < 0) != (b < 0)) ++sign_errors;
+            }
+            ok &= sign_errors == 0;
+            std::cout << (ok ? "✓" : "✗") << " GPU, " << mode_names[m] << " signs: matches the CPU ("
+                      << big / seconds * 1e-6 << " million queries/s)\n";
+            all_passed &= ok;
+        }
+    } else {
+        std::cout << "- GPU not available, skipping GPU point-query checks\n";
+    }
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL POINT QUERY TESTS PASSED\n";
+    } else {
+        std::cout << "✗ POINT QUERY TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
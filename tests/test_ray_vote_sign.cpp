@@ -0,0 +1,153 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for ray-vote signs
+// Validates that SignMode::RayVote reproduces the parity field on a clean mesh, outvotes a
+// defect that only corrupts the +x rays (a duplicated face, as CAD exports sometimes emit),
+// and gives the same field for any thread count. Sparse, octree and incremental generation
+// sign by parity alone and must reject ray-vote signs.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "mesh_io.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Nodes off the surface whose sign differs from the reference
+static int sign_errors(const Array3f& phi, const Array3f& reference, float dx) {
+    int errors = 0;
+    for (size_t n = 0; n < reference.a.size(); ++n) {
+        if (std::fabs(reference.a[n]) > 0.5f * dx && (phi.a[n] < 0) != (reference.a[n] < 0)) ++errors;
+    }
+    return errors;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Ray-Vote Sign Tests\n";
+    std::cout << "========================================\n\n";
+
+    const char* mesh_file = "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 40;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    std::cout << "\n";
+
+    bool all_passed = true;
+
+    sdfgen::GenerationOptions parity;
+    parity.backend = sdfgen::HardwareBackend::CPU;
+    sdfgen::GenerationOptions vote = parity;
+    vote.sign_mode = sdfgen::SignMode::RayVote;
+
+    // Clean mesh: all three axes agree, so the field is the parity field bit for bit
+    Array3f reference, phi;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, reference, parity);
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, vote);
+    bool ok = test_utils::bitwise_equal(phi, reference);
+    std::cout << (ok ? "✓" : "✗") << " Clean mesh: identical to the parity field\n";
+    all_passed &= ok;
+
+    // Duplicate a triangle of the +x face: every +x ray through it counts one crossing too
+    // many, while y and z rays run parallel to it and are unaffected
+    std::vector<Vec3ui> defect_faces = faces;
+    for (const Vec3ui& face : faces) {
+        bool on_face = true;
+        for (int c = 0; c < 3; ++c) on_face &= verts[face[c]][0] == max_box[0];
+        if (on_face) {
+            defect_faces.push_back(face);
+            break;
+        }
+    }
+    Array3f defect_parity, defect_vote;
+    sdfgen::make_level_set3(defect_faces, verts, origin, dx, grid_size, ny, nz, defect_parity, parity);
+    sdfgen::make_level_set3(defect_faces, verts, origin, dx, grid_size, ny, nz, defect_vote, vote);
+    int parity_errors = sign_errors(defect_parity, reference, dx);
+    int vote_errors = sign_errors(defect_vote, reference, dx);
+    ok = defect_faces.size() == faces.size() + 1 && parity_errors > 0 && vote_errors == 0;
+    std::cout << (ok ? "✓" : "✗") << " Duplicated face: " << vote_errors << " sign errors (parity: "
+              << parity_errors << ")\n";
+    all_passed &= ok;
+
+    // The column passes are independent, so the thread count cannot change the result
+    bool same = true;
+    for (int threads : {1, 2, 5}) {
+        sdfgen::GenerationOptions threaded = vote;
+        threaded.num_threads = threads;
+        Array3f threaded_phi;
+        sdfgen::make_level_set3(defect_faces, verts, origin, dx, grid_size, ny, nz, threaded_phi, threaded);
+        same &= test_utils::bitwise_equal(threaded_phi, defect_vote);
+    }
+    std::cout << (same ? "✓" : "✗") << " Identical for 1, 2 and 5 threads\n";
+    all_passed &= same;
+
+    // Exact distance mode uses the same sign pass
+    sdfgen::GenerationOptions exact = vote;
+    exact.distance_mode = sdfgen::DistanceMode::Exact;
+    Array3f exact_phi;
+    sdfgen::make_level_set3(defect_faces, verts, origin, dx, grid_size, ny, nz, exact_phi, exact);
+    int errors = sign_errors(exact_phi, reference, dx);
+    ok = errors == 0;
+    std::cout << (ok ? "✓" : "✗") << " Exact distance mode: " << errors << " sign errors\n";
+    all_passed &= ok;
+
+    // Paths that only compute parity signs refuse the vote instead of dropping it
+    sdfgen::SparseLevelSet sparse;
+    sdfgen::OctreeLevelSet octree;
+    ok = test_utils::throws_runtime_error([&] {
+        sdfgen::make_sparse_level_set3(faces, verts, origin, dx, grid_size, ny, nz, sparse, vote);
+    });
+    ok &= test_utils::throws_runtime_error([&] {
+        sdfgen::make_octree_level_set3(faces, verts, origin, dx, grid_size, ny, nz, octree, vote);
+    });
+    sdfgen::LevelSetState state;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, state, vote);
+    const std::vector<unsigned int> changed(1, 0);
+    ok &= test_utils::throws_runtime_error([&] { sdfgen::update_level_set3(faces, verts, changed, state, parity); });
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, state, parity);
+    ok &= test_utils::throws_runtime_error([&] { sdfgen::update_level_set3(faces, verts, changed, state, vote); });
+    std::cout << (ok ? "✓" : "✗") << " Sparse, octree and incremental updates reject ray-vote signs\n";
+    all_passed &= ok;
+
+    if (sdfgen::is_gpu_available()) {
+        sdfgen::GenerationOptions gpu_options = vote;
+        gpu_options.backend = sdfgen::HardwareBackend::GPU;
+        Array3f gpu_phi;
+        sdfgen::make_level_set3(defect_faces, verts, origin, dx, grid_size, ny, nz, gpu_phi, gpu_options);
+        errors = sign_errors(gpu_phi, reference, dx);
+        ok = errors == 0;
+        std::cout << (ok ? "✓" : "✗") << " GPU duplicated face: " << errors << " sign errors\n";
+        all_passed &= ok;
+
+        gpu_options.gpu_memory = sdfgen::GpuMemoryMode::Streamed;
+        gpu_options.gpu_memory_limit = (size_t)grid_size * ny * 26 * 10; // a few planes per slab
+        sdfgen::make_level_set3(defect_faces, verts, origin, dx, grid_size, ny, nz, gpu_phi, gpu_options);
+        errors = sign_errors(gpu_phi, reference, dx);
+        ok = errors == 0;
+        std::cout << (ok ? "✓" : "✗") << " GPU streamed slabs: " << errors << " sign errors\n";
+        all_passed &= ok;
+    } else {
+        std::cout << "- GPU not available, skipping GPU ray-vote checks\n";
+    }
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL RAY-VOTE SIGN TESTS PASSED\n";
+    } else {
+        std::cout << "✗ RAY-VOTE SIGN TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
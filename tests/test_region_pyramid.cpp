@@ -0,0 +1,187 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Library Test: Region-of-interest and pyramid generation
+// Validates that make_roi_level_set3() culls triangles yet reproduces make_level_set3() on
+// the whole mesh over the same grid bit for bit in the near band and in every sign (parity
+// and ray-vote signs), that it agrees with the matching part of a full-domain grid, and that
+// make_level_set_pyramid3() gives the expected level grids, an exact coarsest level and a
+// finest level matching a full generation in the band and in its signs.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "mesh_io.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Same value where |reference| < band, same sign everywhere
+static bool band_and_signs_equal(const Array3f& a, const Array3f& reference, float band) {
+    bool ok = a.ni == reference.ni && a.nj == reference.nj && a.nk == reference.nk;
+    for (size_t n = 0; ok && n < a.a.size(); ++n) {
+        ok &= (a.a[n] < 0) == (reference.a[n] < 0);
+        if (std::fabs(reference.a[n]) < band) ok &= a.a[n] == reference.a[n];
+    }
+    return ok;
+}
+
+// Compares fine against full sampled every `step` nodes from (i0,j0,k0): near-band values
+// within tol, signs wherever the full field is clearly off the surface
+static bool matches_full(const Array3f& fine, const Array3f& full, int i0, int j0, int k0, int step, float band,
+                         float tol, float& max_error) {
+    bool ok = true;
+    max_error = 0.0f;
+    for (int k = 0; k < fine.nk; ++k) {
+        for (int j = 0; j < fine.nj; ++j) {
+            for (int i = 0; i < fine.ni; ++i) {
+                float a = fine(i, j, k), b = full(i0 + i * step, j0 + j * step, k0 + k * step);
+                if (std::fabs(b) < band) {
+                    max_error = std::max(max_error, std::fabs(a - b));
+                    ok &= std::fabs(a - b) <= tol;
+                }
+                if (std::fabs(b) > tol) ok &= (a < 0) == (b < 0);
+            }
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Region and Pyramid Tests\n";
+    std::cout << "========================================\n\n";
+
+    const char* mesh_file = argc > 1 ? argv[1] : "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 49;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    std::cout << "  Grid: " << grid_size << "x" << ny << "x" << nz << "\n\n";
+
+    bool all_passed = true;
+    sdfgen::GenerationOptions options;
+    options.backend = sdfgen::HardwareBackend::CPU;
+    options.num_threads = 4;
+    Array3f full;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, full, options);
+
+    // The top of the stack of cubes, cut in x: most of the mesh lies outside the region
+    sdfgen::GenerationContext context(faces, verts);
+    Vec3f roi_min(0.2f, min_box[1] - 0.05f, 2.0f), roi_max = max_box + Vec3f(0.05f, 0.05f, 0.05f);
+    Vec3f roi_origin;
+    int rx, ry, rz;
+    sdfgen::roi_grid(origin, dx, roi_min, roi_max, roi_origin, rx, ry, rz);
+    int i0 = (int)std::lround((roi_origin[0] - origin[0]) / dx);
+    int j0 = (int)std::lround((roi_origin[1] - origin[1]) / dx);
+    int k0 = (int)std::lround((roi_origin[2] - origin[2]) / dx);
+    bool ok = roi_origin[0] <= roi_min[0] && roi_origin[0] + (rx - 1) * dx >= roi_max[0] &&
+              roi_origin[2] <= roi_min[2] && roi_origin[2] + (rz - 1) * dx >= roi_max[2] &&
+              std::fabs(roi_origin[1] - (origin[1] + j0 * dx)) < 1e-5f && i0 + rx <= grid_size && j0 + ry <= ny &&
+              k0 + rz <= nz;
+    std::cout << (ok ? "✓" : "✗") << " roi_grid: " << rx << "x" << ry << "x" << rz << " at node (" << i0 << ","
+              << j0 << "," << k0 << ") of the full grid\n";
+    all_passed &= ok;
+
+    // Ray votes also keep what lies below the region in y and z, here the rest of the stack
+    const sdfgen::SignMode signs[2] = {sdfgen::SignMode::Parity, sdfgen::SignMode::RayVote};
+    const char* sign_names[2] = {"parity", "ray vote"};
+    size_t parity_kept = 0;
+    for (int m = 0; m < 2; ++m) {
+        options.sign_mode = signs[m];
+        Array3f roi, reference;
+        size_t kept = 0;
+        sdfgen::make_roi_level_set3(context, roi_origin, dx, rx, ry, rz, roi, options, nullptr, &kept);
+        sdfgen::make_level_set3(faces, verts, roi_origin, dx, rx, ry, rz, reference, options);
+        ok = kept > 0 && (m == 0 ? kept < faces.size() : kept > parity_kept) &&
+             band_and_signs_equal(roi, reference, options.exact_band * dx);
+        if (m == 0) parity_kept = kept;
+        std::cout << (ok ? "✓" : "✗") << " ROI, " << sign_names[m] << " signs: " << kept << " of " << faces.size()
+                  << " triangles, near band and signs bit-identical to the whole mesh\n";
+        all_passed &= ok;
+    }
+    options.sign_mode = sdfgen::SignMode::Parity;
+
+    // Against the full-domain grid: same near band up to node rounding, same signs
+    Array3f roi;
+    sdfgen::make_roi_level_set3(context, roi_origin, dx, rx, ry, rz, roi, options);
+    float max_error = 0.0f;
+    ok = matches_full(roi, full, i0, j0, k0, 1, options.exact_band * dx, 1e-4f, max_error);
+    std::cout << (ok ? "✓" : "✗") << " ROI matches the full grid in the band (max error " << max_error / dx
+              << " dx) and in every sign\n";
+    all_passed &= ok;
+
+    // Winding-number signs need the whole mesh
+    options.sign_mode = sdfgen::SignMode::WindingNumber;
+    size_t kept = 0;
+    Array3f winding;
+    sdfgen::make_roi_level_set3(context, roi_origin, dx, rx, ry, rz, winding, options, nullptr, &kept);
+    ok = kept == faces.size();
+    std::cout << (ok ? "✓" : "✗") << " ROI with winding-number signs keeps every triangle\n";
+    all_passed &= ok;
+    options.sign_mode = sdfgen::SignMode::Parity;
+
+    // Pyramid: 49 nodes along x gives 49, 25, 13 at spacings dx, 2dx, 4dx
+    std::vector<Array3f> pyramid;
+    sdfgen::GenerationStats stats;
+    sdfgen::make_level_set_pyramid3(context, origin, dx, grid_size, ny, nz, 3, pyramid, options, &stats);
+    ok = pyramid.size() == 3;
+    for (int s = 0; ok && s < 3; ++s) {
+        ok &= pyramid[s].ni == ((grid_size - 1) >> s) + 1 && pyramid[s].nj == ((ny - 1) >> s) + 1 &&
+              pyramid[s].nk == ((nz - 1) >> s) + 1;
+    }
+    std::cout << (ok ? "✓" : "✗") << " Pyramid level grids " << pyramid[0].ni << ", " << pyramid[1].ni << ", "
+              << pyramid[2].ni << "\n";
+    all_passed &= ok;
+
+    Array3f coarse;
+    sdfgen::make_level_set3(faces, verts, origin, 4 * dx, pyramid[2].ni, pyramid[2].nj, pyramid[2].nk, coarse,
+                            options);
+    ok = test_utils::bitwise_equal(pyramid[2], coarse);
+    std::cout << (ok ? "✓" : "✗") << " Coarsest level equals make_level_set3() at spacing 4dx\n";
+    all_passed &= ok;
+
+    // Finest level: the near band is the same computation, the far field within a cell
+    ok = matches_full(pyramid[0], full, 0, 0, 0, 1, options.exact_band * dx, 1e-6f, max_error);
+    float far_error = 0.0f;
+    for (size_t n = 0; n < full.a.size(); ++n) {
+        far_error = std::max(far_error, std::fabs(pyramid[0].a[n] - full.a[n]));
+    }
+    ok &= far_error <= dx;
+    std::cout << (ok ? "✓" : "✗") << " Finest level: near band and signs match a full run, far field within "
+              << far_error / dx << " dx\n";
+    all_passed &= ok;
+
+    // Middle level against a full run at 2dx
+    Array3f middle;
+    sdfgen::make_level_set3(faces, verts, origin, 2 * dx, pyramid[1].ni, pyramid[1].nj, pyramid[1].nk, middle,
+                            options);
+    ok = matches_full(pyramid[1], middle, 0, 0, 0, 1, options.exact_band * 2 * dx, 1e-6f, max_error);
+    std::cout << (ok ? "✓" : "✗") << " Middle level matches a full run at 2dx in the band and in its signs\n";
+    all_passed &= ok;
+
+    // Levels are reduced until the coarsest grid still has two nodes per axis
+    sdfgen::make_level_set_pyramid3(context, origin, dx, grid_size, ny, nz, 20, pyramid, options);
+    ok = pyramid.size() == 6 && pyramid.back().ni >= 2 && pyramid.back().nj >= 2 && pyramid.back().nk >= 2;
+    std::cout << (ok ? "✓" : "✗") << " 20 levels requested, " << pyramid.size() << " generated\n";
+    all_passed &= ok;
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL REGION AND PYRAMID TESTS PASSED\n";
+    } else {
+        std::cout << "✗ REGION AND PYRAMID TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
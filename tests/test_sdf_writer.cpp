@@ -0,0 +1,132 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the buffered dense SDF writer
+// Validates that the tiled, block-buffered C-order writer produces the same bytes as the
+// original value-by-value loop (including grids whose planes span several write blocks),
+// that native-layout files carry the negated Nx flag and the grid's raw memory, that
+// read_sdf_binary() restores both layouts, and that the background writer matches.
+
+#include "test_utils.h"
+#include "sdf_io.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// The file the original writer produced: header, then one value at a time, k fastest
+static std::vector<char> reference_bytes(const Array3f& phi, const Vec3f& min_box, float dx) {
+    std::vector<char> bytes;
+    auto append = [&bytes](const void* p, size_t n) {
+        bytes.insert(bytes.end(), (const char*)p, (const char*)p + n);
+    };
+    int dims[3] = {phi.ni, phi.nj, phi.nk};
+    float bounds[6] = {min_box[0], min_box[1], min_box[2],
+                       min_box[0] + phi.ni * dx, min_box[1] + phi.nj * dx, min_box[2] + phi.nk * dx};
+    append(dims, sizeof(dims));
+    append(bounds, sizeof(bounds));
+    for (int i = 0; i < phi.ni; ++i)
+        for (int j = 0; j < phi.nj; ++j)
+            for (int k = 0; k < phi.nk; ++k) append(&phi(i, j, k), sizeof(float));
+    return bytes;
+}
+
+static void fill_grid(Array3f& phi, int ni, int nj, int nk) {
+    phi.resize(ni, nj, nk);
+    for (size_t n = 0; n < phi.a.size(); ++n) {
+        phi.a[n] = (float)((n * 2654435761u) % 20011) * 0.01f - 37.0f;
+    }
+}
+
+static bool same_grid(const Array3f& a, const Array3f& b) {
+    return a.ni == b.ni && a.nj == b.nj && a.nk == b.nk &&
+           std::memcmp(a.a.data, b.a.data, a.a.size() * sizeof(float)) == 0;
+}
+
+static bool check_grid(int ni, int nj, int nk) {
+    std::cout << "Grid " << ni << "x" << nj << "x" << nk << "\n";
+    const char* filename = "test_sdf_writer.sdf";
+    const Vec3f min_box(-1.5f, 0.25f, 2.0f);
+    const float dx = 0.125f;
+    bool ok = true;
+
+    Array3f phi;
+    fill_grid(phi, ni, nj, nk);
+    std::vector<char> expected = reference_bytes(phi, min_box, dx);
+    int expected_inside = 0;
+    for (size_t n = 0; n < phi.a.size(); ++n) expected_inside += phi.a[n] < 0.0f;
+
+    // C-order: byte-identical to the original writer for any thread count
+    const int thread_counts[] = {1, 3};
+    for (int threads : thread_counts) {
+        int inside = -1;
+        bool written = write_sdf_binary(filename, phi, min_box, dx, &inside, sdfgen::SdfLayout::COrder, threads);
+        bool same = written && test_utils::read_file_bytes(filename) == expected && inside == expected_inside;
+        std::cout << "  " << (same ? "✓" : "✗") << " C-order, " << threads << " threads: "
+                  << (same ? "identical to value-by-value output\n" : "differs from value-by-value output\n");
+        ok &= same;
+    }
+    Array3f back;
+    Vec3f back_min, back_max;
+    bool read = read_sdf_binary(filename, back, back_min, back_max);
+    bool same = read && same_grid(phi, back) && back_min == min_box;
+    std::cout << "  " << (same ? "✓" : "✗") << " C-order file reads back\n";
+    ok &= same;
+
+    // Native: flagged header, then the grid's memory
+    write_sdf_binary(filename, phi, min_box, dx, nullptr, sdfgen::SdfLayout::Native);
+    std::vector<char> native = test_utils::read_file_bytes(filename);
+    int flag = 0;
+    if (native.size() >= sizeof(int)) std::memcpy(&flag, native.data(), sizeof(int));
+    same = native.size() == expected.size() && flag == -ni &&
+           std::memcmp(native.data() + sizeof(int), expected.data() + sizeof(int), 32) == 0 &&
+           std::memcmp(native.data() + 36, phi.a.data, phi.a.size() * sizeof(float)) == 0;
+    read = read_sdf_binary(filename, back, back_min, back_max);
+    same &= read && same_grid(phi, back);
+    std::cout << "  " << (same ? "✓" : "✗") << " Native layout: flagged header, raw grid, reads back\n";
+    ok &= same;
+
+    // Background writer takes the grid and matches the blocking call
+    Array3f moved = phi;
+    std::future<bool> job = write_sdf_binary_async(filename, moved, min_box, dx);
+    bool taken = moved.a.size() == 0;
+    same = job.get() && taken && test_utils::read_file_bytes(filename) == expected;
+    std::cout << "  " << (same ? "✓" : "✗") << " Async writer takes the grid and writes the same file\n";
+    ok &= same;
+
+    // Truncated files are rejected
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file.write(expected.data(), expected.size() - sizeof(float));
+    }
+    read = read_sdf_binary(filename, back, back_min, back_max);
+    std::cout << "  " << (!read ? "✓" : "✗") << " Truncated file rejected\n\n";
+    ok &= !read;
+
+    std::remove(filename);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Dense SDF Writer Tests\n";
+    std::cout << "========================================\n\n";
+
+    bool all_passed = true;
+    all_passed &= check_grid(37, 29, 41);
+    all_passed &= check_grid(1, 1, 1);
+    // Planes of ~4 MB: the C-order writer needs two blocks
+    all_passed &= check_grid(5, 1031, 1029);
+
+    std::cout << "========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL SDF WRITER TESTS PASSED\n";
+    } else {
+        std::cout << "✗ SDF WRITER TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
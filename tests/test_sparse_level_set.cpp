@@ -0,0 +1,173 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for sparse narrow-band generation and the sparse file format
+// Validates that make_sparse_level_set3() reproduces the dense field clamped to the band
+// (bit-identical inside it), is independent of the thread count, only activates tiles near
+// the surface, and survives a write_sparse_sdf()/read_sparse_sdf() round trip.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "sdf_io.h"
+#include "mesh_io.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+// Every node of the sparse field equals the dense value clamped to +/-background
+static bool matches_clamped(const sdfgen::SparseLevelSet& sparse, const Array3f& dense) {
+    Array3f expanded;
+    sparse.to_dense(expanded);
+    for (int k = 0; k < dense.nk; ++k) {
+        for (int j = 0; j < dense.nj; ++j) {
+            for (int i = 0; i < dense.ni; ++i) {
+                float d = dense(i, j, k);
+                float expected = std::min(std::fabs(d), sparse.background);
+                if (d < 0) expected = -expected;
+                if (sparse(i, j, k) != expected || expanded(i, j, k) != expected) {
+                    std::cout << "  Mismatch at (" << i << "," << j << "," << k << "): sparse "
+                              << sparse(i, j, k) << ", dense " << d << "\n";
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool same_sparse(const sdfgen::SparseLevelSet& a, const sdfgen::SparseLevelSet& b) {
+    if (a.ni != b.ni || a.nj != b.nj || a.nk != b.nk || a.dx != b.dx ||
+        a.background != b.background || a.brick_count() != b.brick_count()) {
+        return false;
+    }
+    for (size_t n = 0; n < a.brick_count(); ++n) {
+        if (a.brick_coord(n) != b.brick_coord(n) ||
+            std::memcmp(a.brick_data(n), b.brick_data(n), sdfgen::SparseLevelSet::brick_cells * sizeof(float)) != 0) {
+            return false;
+        }
+    }
+    for (int tk = 0; tk < a.tiles_k(); ++tk) {
+        for (int tj = 0; tj < a.tiles_j(); ++tj) {
+            for (int ti = 0; ti < a.tiles_i(); ++ti) {
+                if (a.tile_inside(ti, tj, tk) != b.tile_inside(ti, tj, tk)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Sparse Narrow-Band Tests\n";
+    std::cout << "========================================\n\n";
+
+    const char* mesh_file = "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 40;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    std::cout << "\n";
+
+    bool all_passed = true;
+
+    // Dense reference and sparse field for several band widths
+    for (int band : {1, 3}) {
+        sdfgen::GenerationOptions options;
+        options.backend = sdfgen::HardwareBackend::CPU;
+        options.exact_band = band;
+        Array3f dense;
+        sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, dense, options);
+        sdfgen::SparseLevelSet sparse;
+        sdfgen::make_sparse_level_set3(faces, verts, origin, dx, grid_size, ny, nz, sparse, options);
+        bool ok = sparse.background == band * dx && matches_clamped(sparse, dense);
+        std::cout << (ok ? "✓" : "✗") << " Band " << band << ": matches the dense field clamped to the band ("
+                  << sparse.brick_count() << " bricks)\n";
+        all_passed &= ok;
+    }
+
+    // Thread count does not change the result
+    sdfgen::GenerationOptions one_thread;
+    one_thread.backend = sdfgen::HardwareBackend::CPU;
+    one_thread.exact_band = 2;
+    one_thread.num_threads = 1;
+    sdfgen::GenerationOptions four_threads = one_thread;
+    four_threads.num_threads = 4;
+    sdfgen::SparseLevelSet a, b;
+    sdfgen::make_sparse_level_set3(faces, verts, origin, dx, grid_size, ny, nz, a, one_thread);
+    sdfgen::make_sparse_level_set3(faces, verts, origin, dx, grid_size, ny, nz, b, four_threads);
+    bool ok = same_sparse(a, b);
+    std::cout << (ok ? "✓" : "✗") << " 1 and 4 threads give identical bricks\n";
+    all_passed &= ok;
+
+    // Active bricks follow the surface, not the volume
+    sdfgen::GenerationOptions fine_options = one_thread;
+    fine_options.num_threads = 0;
+    int fine_nx = 160, fine_ny, fine_nz;
+    float fine_dx;
+    Vec3f fine_origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, fine_nx, 2, fine_dx, fine_ny, fine_nz, fine_origin);
+    sdfgen::SparseLevelSet fine;
+    sdfgen::make_sparse_level_set3(faces, verts, fine_origin, fine_dx, fine_nx, fine_ny, fine_nz, fine, fine_options);
+    size_t tiles = (size_t)fine.tiles_i() * fine.tiles_j() * fine.tiles_k();
+    size_t dense_bytes = (size_t)fine_nx * fine_ny * fine_nz * sizeof(float);
+    ok = fine.brick_count() < tiles / 2 && fine.memory_bytes() < dense_bytes / 2;
+    std::cout << (ok ? "✓" : "✗") << " " << fine_nx << "x" << fine_ny << "x" << fine_nz << ": "
+              << fine.brick_count() << " of " << tiles << " tiles active, "
+              << fine.memory_bytes() / 1024 << " KB vs " << dense_bytes / 1024 << " KB dense\n";
+    all_passed &= ok;
+
+    // File round trip
+    const char* sparse_file = "test_sparse_roundtrip.ssdf";
+    sdfgen::SparseLevelSet loaded;
+    ok = write_sparse_sdf(sparse_file, a) && read_sparse_sdf(sparse_file, loaded) &&
+         same_sparse(a, loaded) && loaded.origin == a.origin;
+    std::remove(sparse_file);
+    std::cout << (ok ? "✓" : "✗") << " write_sparse_sdf/read_sparse_sdf round trip\n";
+    all_passed &= ok;
+
+    // A dense file is rejected by the sparse reader
+    const char* dense_file = "test_sparse_dense.sdf";
+    Array3f small(4, 4, 4, 1.0f);
+    ok = write_sdf_binary(dense_file, small, origin, dx);
+    std::cout << "  (expected error follows)\n";
+    ok = ok && !read_sparse_sdf(dense_file, loaded);
+    std::remove(dense_file);
+    std::cout << (ok ? "✓" : "✗") << " Dense file rejected by the sparse reader\n";
+    all_passed &= ok;
+
+    // GPU is not a sparse backend
+    ok = false;
+    try {
+        sdfgen::GenerationOptions gpu_options;
+        gpu_options.backend = sdfgen::HardwareBackend::GPU;
+        sdfgen::SparseLevelSet unused;
+        sdfgen::make_sparse_level_set3(faces, verts, origin, dx, grid_size, ny, nz, unused, gpu_options);
+    } catch (const std::runtime_error&) {
+        ok = true;
+    }
+    std::cout << (ok ? "✓" : "✗") << " Explicit GPU backend is rejected\n";
+    all_passed &= ok;
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL SPARSE NARROW-BAND TESTS PASSED\n";
+    } else {
+        std::cout << "✗ SPARSE NARROW-BAND TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
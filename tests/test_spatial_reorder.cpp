@@ -0,0 +1,153 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the Morton triangle reordering (GenerationOptions::spatial_reorder)
+// Validates that the reordered copy is a permutation of the input with the same corner
+// positions, and that grids and nearest-triangle indices generated with the reordering
+// are bit-identical to those generated from the mesh in file order, including meshes
+// with duplicated triangles where the index tie-break decides the nearest triangle.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "level_set_state.h"
+#include "mesh_reorder.h"
+#include "mesh_io.h"
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Triangle soup in random order; every fifth triangle is an exact copy of an earlier one
+static void make_soup_with_copies(int count, std::vector<Vec3f>& verts, std::vector<Vec3ui>& faces) {
+    test_utils::make_triangle_soup(count, Vec3f(0.0f, 0.0f, 0.0f), Vec3f(8.0f, 8.0f, 8.0f), 1.0f, 24680u,
+                                   verts, faces);
+    test_utils::RandomFloats random(13579u);
+    for (int t = 4; t < count; t += 5) {
+        const Vec3ui copy = faces[(size_t)(random.next() * t)];
+        for (int v = 0; v < 3; ++v) verts[faces[t][v]] = verts[copy[v]];
+    }
+}
+
+static bool check_order(const std::vector<Vec3ui>& faces, const std::vector<Vec3f>& verts,
+                        const Vec3f& origin, float dx, int nx, int ny, int nz) {
+    sdfgen::SpatialOrder order;
+    sdfgen::spatial_reorder(faces, verts, origin, dx, nx, ny, nz, order, 4);
+
+    bool ok = order.tri.size() == faces.size() && order.original.size() == faces.size();
+    std::vector<char> seen(faces.size(), 0);
+    bool moved = false;
+    for (size_t n = 0; ok && n < order.tri.size(); ++n) {
+        unsigned int t = order.original[n];
+        if (t >= faces.size() || seen[t]) { ok = false; break; }
+        seen[t] = 1;
+        moved |= (t != n);
+        for (int c = 0; c < 3; ++c) {
+            ok &= order.tri[n][c] < order.x.size();
+            ok &= ok && std::memcmp(&order.x[order.tri[n][c]], &verts[faces[t][c]], sizeof(Vec3f)) == 0;
+        }
+    }
+    if (ok && moved) {
+        std::cout << "  ✓ Reordered mesh is a permutation with the same corners\n";
+    } else {
+        std::cout << "  ✗ Reordered mesh is not a valid permutation\n";
+    }
+
+    sdfgen::SpatialOrder again;
+    sdfgen::spatial_reorder(faces, verts, origin, dx, nx, ny, nz, again, 1);
+    bool same = again.original == order.original;
+    std::cout << "  " << (same ? "✓" : "✗") << " Order is independent of the thread count\n";
+    return ok && moved && same;
+}
+
+static bool check_grids(const char* label, const std::vector<Vec3ui>& faces, const std::vector<Vec3f>& verts,
+                        const Vec3f& origin, float dx, int nx, int ny, int nz) {
+    std::cout << label << " (" << faces.size() << " triangles, "
+              << nx << "x" << ny << "x" << nz << ")\n";
+    bool ok = check_order(faces, verts, origin, dx, nx, ny, nz);
+
+    struct Variant {
+        const char* name;
+        int exact_band;
+        sdfgen::DistanceMode distance;
+        sdfgen::SignMode sign;
+    };
+    const Variant variants[] = {
+        {"sweep, parity", 1, sdfgen::DistanceMode::Sweep, sdfgen::SignMode::Parity},
+        {"band 3, ray vote", 3, sdfgen::DistanceMode::Sweep, sdfgen::SignMode::RayVote},
+        {"exact, winding", 1, sdfgen::DistanceMode::Exact, sdfgen::SignMode::WindingNumber},
+    };
+    const int thread_counts[] = {1, 4};
+    for (const Variant& variant : variants) {
+        for (int threads : thread_counts) {
+            sdfgen::GenerationOptions options;
+            options.backend = sdfgen::HardwareBackend::CPU;
+            options.exact_band = variant.exact_band;
+            options.distance_mode = variant.distance;
+            options.sign_mode = variant.sign;
+            options.num_threads = threads;
+
+            sdfgen::LevelSetState reference;
+            sdfgen::make_level_set3(faces, verts, origin, dx, nx, ny, nz, reference, options);
+            options.spatial_reorder = true;
+            sdfgen::LevelSetState sorted;
+            sdfgen::make_level_set3(faces, verts, origin, dx, nx, ny, nz, sorted, options);
+            Array3f phi;
+            sdfgen::make_level_set3(faces, verts, origin, dx, nx, ny, nz, phi, options);
+
+            bool same = test_utils::bitwise_equal(reference.phi, sorted.phi) && test_utils::bitwise_equal(reference.phi, phi) &&
+                        reference.closest_tri.a == sorted.closest_tri.a &&
+                        reference.intersection_count.a == sorted.intersection_count.a;
+            std::cout << "  " << (same ? "✓ " : "✗ ") << variant.name << ", " << threads
+                      << (same ? " threads: bit-identical with reordering\n" : " threads: differs with reordering\n");
+            ok &= same;
+        }
+    }
+    std::cout << "\n";
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Spatial Reordering Tests\n";
+    std::cout << "========================================\n\n";
+
+    bool all_passed = true;
+
+    // Closed test mesh
+    {
+        const char* mesh_file = "resources/test_x3y4z5_quads.obj";
+        std::vector<Vec3f> verts;
+        std::vector<Vec3ui> faces;
+        Vec3f min_box, max_box;
+        if (!meshio::load_obj(mesh_file, verts, faces, min_box, max_box)) {
+            std::cerr << "ERROR: Failed to load test mesh\n";
+            return 1;
+        }
+
+        int grid_size = 24;
+        float dx;
+        int ny, nz;
+        Vec3f origin;
+        test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+        all_passed &= check_grids("Closed box mesh", faces, verts, origin, dx, grid_size, ny, nz);
+    }
+
+    // Shuffled soup with duplicated triangles, partly outside the grid
+    {
+        std::vector<Vec3f> verts;
+        std::vector<Vec3ui> faces;
+        make_soup_with_copies(500, verts, faces);
+        all_passed &= check_grids("Triangle soup with duplicates", faces, verts,
+                                  Vec3f(0.5f, 0.5f, 0.5f), 0.25f, 28, 30, 32);
+    }
+
+    std::cout << "========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL SPATIAL REORDERING TESTS PASSED\n";
+    } else {
+        std::cout << "✗ SPATIAL REORDERING TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for the wavefront fast-sweeping mode
+// Validates that SweepMode::Wavefront reproduces the single-threaded
+// Gauss-Seidel sweep bit for bit, for any thread count, including grids
+// where threads outnumber rows and thin grids with few k-slices.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "mesh_io.h"
+#include <iostream>
+#include <vector>
+
+static bool check_wavefront(const char* label,
+                            const std::vector<Vec3ui>& faces, const std::vector<Vec3f>& verts,
+                            const Vec3f& origin, float dx, int nx, int ny, int nz) {
+    std::cout << label << " (" << faces.size() << " triangles, "
+              << nx << "x" << ny << "x" << nz << ")\n";
+
+    sdfgen::GenerationOptions options;
+    options.backend = sdfgen::HardwareBackend::CPU;
+
+    // Reference: the legacy slab code with one thread is the plain sequential sweep
+    Array3f reference;
+    options.sweep_mode = sdfgen::SweepMode::Slab;
+    options.num_threads = 1;
+    sdfgen::make_level_set3(faces, verts, origin, dx, nx, ny, nz, reference, options);
+
+    options.sweep_mode = sdfgen::SweepMode::Wavefront;
+    const int thread_counts[] = {1, 2, 3, 4, 8, 32};
+    bool ok = true;
+    for (int threads : thread_counts) {
+        options.num_threads = threads;
+        Array3f phi;
+        sdfgen::make_level_set3(faces, verts, origin, dx, nx, ny, nz, phi, options);
+        if (test_utils::bitwise_equal(reference, phi)) {
+            std::cout << "  ✓ " << threads << " threads: matches sequential sweep\n";
+        } else {
+            std::cout << "  ✗ " << threads << " threads: differs from sequential sweep\n";
+            ok = false;
+        }
+    }
+    std::cout << "\n";
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Wavefront Sweep Determinism Tests\n";
+    std::cout << "========================================\n\n";
+
+    bool all_passed = true;
+
+    {
+        const char* mesh_file = "resources/test_x3y4z5_quads.obj";
+        std::vector<Vec3f> verts;
+        std::vector<Vec3ui> faces;
+        Vec3f min_box, max_box;
+        if (!meshio::load_obj(mesh_file, verts, faces, min_box, max_box)) {
+            std::cerr << "ERROR: Failed to load test mesh\n";
+            return 1;
+        }
+
+        int grid_size = 32;
+        float dx;
+        int ny, nz;
+        Vec3f origin;
+        test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+        all_passed &= check_wavefront("Closed box mesh", faces, verts, origin, dx, grid_size, ny, nz);
+    }
+
+    {
+        std::vector<Vec3f> verts;
+        std::vector<Vec3ui> faces;
+        // Deterministic triangle soup; far-field values depend on the sweep order,
+        // which makes any ordering difference visible
+        test_utils::make_triangle_soup(60, Vec3f(1.0f, 1.0f, 1.0f), Vec3f(7.0f, 7.0f, 7.0f), 1.0f, 987654321u,
+                                       verts, faces);
+        all_passed &= check_wavefront("Triangle soup", faces, verts,
+                                      Vec3f(0.0f, 0.0f, 0.0f), 0.2f, 40, 40, 40);
+        all_passed &= check_wavefront("Triangle soup, thin grid", faces, verts,
+                                      Vec3f(0.0f, 0.0f, 3.0f), 0.2f, 40, 37, 4);
+        all_passed &= check_wavefront("Triangle soup, tiny grid", faces, verts,
+                                      Vec3f(2.0f, 2.0f, 2.0f), 1.0f, 5, 5, 5);
+    }
+
+    std::cout << "========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL WAVEFRONT SWEEP TESTS PASSED\n";
+    } else {
+        std::cout << "✗ WAVEFRONT SWEEP TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}
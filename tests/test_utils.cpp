@@ -10,6 +10,10 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
 
 namespace test_utils {
 
@@ -304,4 +308,45 @@ void calculate_grid_parameters(
     std::cout << "  Origin:     (" << origin << ")\n\n";
 }
 
+bool same_bits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+bool bitwise_equal(const Array3f& a, const Array3f& b) {
+    if (a.ni != b.ni || a.nj != b.nj || a.nk != b.nk) return false;
+    return std::memcmp(a.a.data, b.a.data, a.a.size() * sizeof(float)) == 0;
+}
+
+void make_triangle_soup(int count, const Vec3f& lo, const Vec3f& hi, float size, unsigned int seed,
+                        std::vector<Vec3f>& verts, std::vector<Vec3ui>& faces) {
+    RandomFloats random(seed);
+    auto next = [&random]() { return random.next(); };
+    verts.clear();
+    faces.clear();
+    for (int t = 0; t < count; ++t) {
+        Vec3f c(lo[0] + next() * (hi[0] - lo[0]),
+                lo[1] + next() * (hi[1] - lo[1]),
+                lo[2] + next() * (hi[2] - lo[2]));
+        unsigned int base = (unsigned int)verts.size();
+        for (int v = 0; v < 3; ++v) {
+            verts.push_back(c + Vec3f(next() - 0.5f, next() - 0.5f, next() - 0.5f) * size);
+        }
+        faces.push_back(Vec3ui(base, base + 1, base + 2));
+    }
+}
+
+std::vector<char> read_file_bytes(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+bool throws_runtime_error(const std::function<void()>& call) {
+    try {
+        call();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
 } // namespace test_utils
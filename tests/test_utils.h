@@ -6,8 +6,10 @@
 
 #include "sdfgen_unified.h"
 #include "sdf_io.h"
-#include <string>
 #include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
 
 /**
  * @brief Test utilities for SDFGen test suite
@@ -219,4 +221,73 @@ void calculate_grid_parameters(
     Vec3f& origin
 );
 
+/**
+ * @brief Seeded linear congruential generator for reproducible test inputs
+ *
+ * The same seed always gives the same sequence on every platform.
+ */
+class RandomFloats {
+public:
+    explicit RandomFloats(unsigned int seed) : state_(seed) {}
+
+    /// Next raw 32-bit state; the low bits are weak, so prefer the high ones
+    unsigned int next_bits() {
+        state_ = state_ * 1664525u + 1013904223u;
+        return state_;
+    }
+
+    /// Next value, uniform in [0, 1) with 24 random bits
+    float next() { return (next_bits() >> 8) * (1.0f / 16777216.0f); }
+
+private:
+    unsigned int state_;
+};
+
+/**
+ * @brief Check that two floats have the same bit pattern
+ *
+ * Unlike ==, tells -0 from +0 and accepts identical NaNs.
+ */
+bool same_bits(float a, float b);
+
+/**
+ * @brief Check that two grids are identical bit for bit
+ *
+ * @return true if the dimensions match and every value has the same bit pattern
+ */
+bool bitwise_equal(const Array3f& a, const Array3f& b);
+
+/**
+ * @brief Generate a deterministic soup of unconnected triangles
+ *
+ * Triangle centres are uniform in the box [lo, hi]; each vertex lies within size/2 of its
+ * centre along every axis. The same seed always gives the same mesh.
+ *
+ * @param count Number of triangles
+ * @param lo Lower corner of the box holding the centres
+ * @param hi Upper corner of the box holding the centres
+ * @param size Edge of the cube around each centre that holds its vertices
+ * @param seed Seed of the linear congruential generator
+ * @param verts Output vertices, three per triangle
+ * @param faces Output triangles
+ */
+void make_triangle_soup(int count, const Vec3f& lo, const Vec3f& hi, float size, unsigned int seed,
+                        std::vector<Vec3f>& verts, std::vector<Vec3ui>& faces);
+
+/**
+ * @brief Read a whole file
+ *
+ * @param filename Path of the file
+ * @return The file's bytes, empty if it could not be opened
+ */
+std::vector<char> read_file_bytes(const std::string& filename);
+
+/**
+ * @brief Check that a call is rejected
+ *
+ * @param call Library call expected to fail argument validation
+ * @return true if call threw std::runtime_error
+ */
+bool throws_runtime_error(const std::function<void()>& call);
+
 } // namespace test_utils
@@ -0,0 +1,165 @@
+// SDFGen - Signed Distance Field Generator
+// Copyright (c) 2015 Christopher Batty, 2025 Brad Chamberlain
+// Licensed under the MIT License - see LICENSE file
+
+// Test for winding-number signs
+// Validates that SignMode::WindingNumber leaves all distances unchanged, agrees with the ray
+// parity on a closed mesh, keeps the correct signs when triangles are missing (where the
+// parity flips whole rays), and only evaluates a fraction of the nodes. Sparse, octree and
+// incremental generation sign by parity alone and must reject winding-number signs.
+
+#include "test_utils.h"
+#include "sdfgen_unified.h"
+#include "winding_number.h"
+#include "mesh_io.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Nodes off the surface whose sign differs from the reference
+static int sign_errors(const Array3f& phi, const Array3f& reference, float dx) {
+    int errors = 0;
+    for (size_t n = 0; n < reference.a.size(); ++n) {
+        if (std::fabs(reference.a[n]) > 0.5f * dx && (phi.a[n] < 0) != (reference.a[n] < 0)) ++errors;
+    }
+    return errors;
+}
+
+static bool same_magnitudes(const Array3f& a, const Array3f& b) {
+    if (a.a.size() != b.a.size()) return false;
+    for (size_t n = 0; n < a.a.size(); ++n) {
+        if (std::fabs(a.a[n]) != std::fabs(b.a[n])) return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================\n";
+    std::cout << "Winding-Number Sign Tests\n";
+    std::cout << "========================================\n\n";
+
+    const char* mesh_file = "resources/test_x3y4z5_bin.stl";
+    std::vector<Vec3f> verts;
+    std::vector<Vec3ui> faces;
+    Vec3f min_box, max_box;
+    if (!meshio::load_stl(mesh_file, verts, faces, min_box, max_box)) {
+        std::cerr << "ERROR: Failed to load test mesh\n";
+        return 1;
+    }
+    int grid_size = 40;
+    float dx;
+    int ny, nz;
+    Vec3f origin;
+    test_utils::calculate_grid_parameters(min_box, max_box, grid_size, 2, dx, ny, nz, origin);
+    std::cout << "\n";
+
+    bool all_passed = true;
+
+    // The tree itself: 0 far outside, 1 just behind a triangle and 0 just in front of it
+    sdfgen::WindingNumberTree tree(faces, verts);
+    const Vec3f &a = verts[faces[0][0]], &b = verts[faces[0][1]], &c = verts[faces[0][2]];
+    Vec3f centroid = (a + b + c) / 3.f, normal = normalized(cross(b - a, c - a));
+    float outside = tree.winding_number(max_box + Vec3f(1, 1, 1));
+    float behind = tree.winding_number(centroid - 0.01f * dx * normal);
+    float in_front = tree.winding_number(centroid + 0.01f * dx * normal);
+    bool ok = std::fabs(outside) < 0.01f && std::fabs(behind - 1) < 0.01f && std::fabs(in_front) < 0.01f;
+    std::cout << (ok ? "✓" : "✗") << " Winding number " << outside << " outside, " << behind << " / "
+              << in_front << " either side of a triangle\n";
+    all_passed &= ok;
+
+    sdfgen::GenerationOptions parity;
+    parity.backend = sdfgen::HardwareBackend::CPU;
+    sdfgen::GenerationOptions winding = parity;
+    winding.sign_mode = sdfgen::SignMode::WindingNumber;
+
+    // Closed mesh: same distances, same signs as the parity
+    Array3f reference, phi;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, reference, parity);
+    sdfgen::GenerationStats stats;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, phi, winding, &stats);
+    int errors = sign_errors(phi, reference, dx);
+    ok = same_magnitudes(phi, reference) && errors == 0;
+    std::cout << (ok ? "✓" : "✗") << " Closed mesh: distances unchanged, " << errors << " sign mismatches\n";
+    all_passed &= ok;
+
+    // Only nodes next to the surface and the ends of far-field runs are evaluated
+    size_t cells = reference.a.size();
+    ok = stats.winding_evaluations > 0 && (size_t)stats.winding_evaluations < cells / 2;
+    std::cout << (ok ? "✓" : "✗") << " " << stats.winding_evaluations << " winding-number queries for "
+              << cells << " nodes\n";
+    all_passed &= ok;
+
+    // A missing triangle on the +x face: parity flips the rows through the hole, the winding
+    // number does not
+    std::vector<Vec3ui> open_faces;
+    bool removed = false;
+    for (const Vec3ui& face : faces) {
+        bool on_face = true;
+        for (int c = 0; c < 3; ++c) on_face &= verts[face[c]][0] == max_box[0];
+        if (on_face && !removed) removed = true;
+        else open_faces.push_back(face);
+    }
+    Array3f open_parity, open_winding;
+    sdfgen::make_level_set3(open_faces, verts, origin, dx, grid_size, ny, nz, open_parity, parity);
+    sdfgen::make_level_set3(open_faces, verts, origin, dx, grid_size, ny, nz, open_winding, winding);
+    int parity_errors = sign_errors(open_parity, reference, dx);
+    int winding_errors = sign_errors(open_winding, reference, dx);
+    ok = parity_errors > 0 && winding_errors == 0;
+    std::cout << (ok ? "✓" : "✗") << " Mesh with a hole: " << winding_errors << " sign errors (parity: "
+              << parity_errors << ")\n";
+    all_passed &= ok;
+
+    // Exact distance mode and thread counts use the same sign pass
+    sdfgen::GenerationOptions exact = winding;
+    exact.distance_mode = sdfgen::DistanceMode::Exact;
+    exact.num_threads = 3;
+    Array3f exact_phi;
+    sdfgen::make_level_set3(open_faces, verts, origin, dx, grid_size, ny, nz, exact_phi, exact);
+    errors = sign_errors(exact_phi, reference, dx);
+    ok = errors == 0;
+    std::cout << (ok ? "✓" : "✗") << " Exact distance mode with 3 threads: " << errors << " sign errors\n";
+    all_passed &= ok;
+
+    // Paths that only compute parity signs refuse the winding number instead of dropping it
+    sdfgen::SparseLevelSet sparse;
+    sdfgen::OctreeLevelSet octree;
+    ok = test_utils::throws_runtime_error([&] {
+        sdfgen::make_sparse_level_set3(faces, verts, origin, dx, grid_size, ny, nz, sparse, winding);
+    });
+    ok &= test_utils::throws_runtime_error([&] {
+        sdfgen::make_octree_level_set3(faces, verts, origin, dx, grid_size, ny, nz, octree, winding);
+    });
+    // a winding-signed state is fine to generate, but an update would re-sign rows by parity
+    sdfgen::LevelSetState state;
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, state, winding);
+    const std::vector<unsigned int> changed(1, 0);
+    ok &= test_utils::throws_runtime_error([&] { sdfgen::update_level_set3(faces, verts, changed, state, parity); });
+    sdfgen::make_level_set3(faces, verts, origin, dx, grid_size, ny, nz, state, parity);
+    ok &= test_utils::throws_runtime_error([&] { sdfgen::update_level_set3(faces, verts, changed, state, winding); });
+    ok &= !test_utils::throws_runtime_error([&] { sdfgen::update_level_set3(faces, verts, changed, state, parity); });
+    std::cout << (ok ? "✓" : "✗") << " Sparse, octree and incremental updates reject winding-number signs\n";
+    all_passed &= ok;
+
+    if (sdfgen::is_gpu_available()) {
+        sdfgen::GenerationOptions gpu_options = winding;
+        gpu_options.backend = sdfgen::HardwareBackend::GPU;
+        Array3f gpu_phi;
+        sdfgen::make_level_set3(open_faces, verts, origin, dx, grid_size, ny, nz, gpu_phi, gpu_options);
+        errors = sign_errors(gpu_phi, reference, dx);
+        ok = errors == 0;
+        std::cout << (ok ? "✓" : "✗") << " GPU mesh with a hole: " << errors << " sign errors\n";
+        all_passed &= ok;
+    } else {
+        std::cout << "- GPU not available, skipping GPU winding-number checks\n";
+    }
+
+    std::cout << "\n========================================\n";
+    if (all_passed) {
+        std::cout << "✓ ALL WINDING-NUMBER SIGN TESTS PASSED\n";
+    } else {
+        std::cout << "✗ WINDING-NUMBER SIGN TESTS FAILED\n";
+    }
+    std::cout << "========================================\n";
+
+    return all_passed ? 0 : 1;
+}